@@ -723,6 +723,26 @@ Object doCall20Handle(
   return x;
 }
 
+typedef NativeCallbackInt64 = Int64 Function(Int64);
+typedef NativeFunction1CallbackInt64 = Int64 Function(
+    Pointer<NativeFunction<NativeCallbackInt64>>, Int64);
+typedef Function1CallbackInt64 = int Function(
+    Pointer<NativeFunction<NativeCallbackInt64>>, int);
+final function1CallbackInt64 = ffiTestFunctions.lookupFunction<
+    NativeFunction1CallbackInt64,
+    Function1CallbackInt64>('Function1CallbackInt64');
+
+int callbackInt64(int x) => x + 42;
+
+final callbackInt64Pointer =
+    Pointer.fromFunction<NativeCallbackInt64>(callbackInt64, 0);
+
+// Calls back into Dart [length] times from a single native call, measuring
+// the round-trip cost of a native-to-Dart callback.
+int doCallbackInt64(int length) {
+  return function1CallbackInt64(callbackInt64Pointer, length);
+}
+
 //
 // Benchmark fixtures.
 //
@@ -1382,6 +1402,18 @@ class Handlex20 extends BenchmarkBase {
   }
 }
 
+class Callbackx01 extends BenchmarkBase {
+  Callbackx01() : super('FfiCall.Callbackx01');
+
+  @override
+  void run() {
+    final int x = doCallbackInt64(N);
+    if (x != N * (N - 1) ~/ 2 + N * 42) {
+      throw Exception('$name: Unexpected result: $x');
+    }
+  }
+}
+
 //
 // Main driver.
 //
@@ -1425,6 +1457,7 @@ void main() {
     () => Handlex04(),
     () => Handlex10(),
     () => Handlex20(),
+    () => Callbackx01(),
   ];
   for (final benchmark in benchmarks) {
     benchmark().report();
@@ -178,3 +178,11 @@ void* Function20Handle(void* a,
                        void* t) {
   return a;
 }
+
+int64_t Function1CallbackInt64(int64_t (*callback)(int64_t), int64_t length) {
+  int64_t sum = 0;
+  for (int64_t i = 0; i < length; i++) {
+    sum += callback(i);
+  }
+  return sum;
+}
@@ -8,8 +8,11 @@ import 'package:front_end/src/api_unstable/vm.dart'
     show
         messageFfiExceptionalReturnNull,
         messageFfiExpectedConstant,
+        messageFfiLeafCallMustNotReturnHandle,
+        messageFfiLeafCallMustNotTakeHandle,
         templateFfiDartTypeMismatch,
         templateFfiEmptyStruct,
+        templateFfiExpectedConstantArg,
         templateFfiExpectedExceptionalReturn,
         templateFfiExpectedNoExceptionalReturn,
         templateFfiExtendsOrImplementsSealedClass,
@@ -175,25 +178,37 @@ class _FfiUseSiteTransformer extends FfiTransformer {
             nativeFunctionClass, Nullability.legacy, [node.arguments.types[0]]);
         final DartType dartType = node.arguments.types[1];
 
+        final bool isLeaf = _isLeafArgument(node);
         _ensureNativeTypeValid(nativeType, node);
-        _ensureNativeTypeToDartType(nativeType, dartType, node);
+        _ensureNativeTypeToDartType(nativeType,
+            isLeaf ? _typedDataAsPointers(nativeType, dartType) : dartType,
+            node);
         _ensureNoEmptyStructs(dartType, node);
-        return _replaceLookupFunction(node);
+        if (isLeaf) {
+          _ensureLeafCallDoesNotUseHandles(nativeType, node);
+        }
+        return _replaceLookupFunction(node, isLeaf);
       } else if (target == asFunctionMethod) {
         final DartType dartType = node.arguments.types[1];
         final DartType nativeType = InterfaceType(
             nativeFunctionClass, Nullability.legacy, [node.arguments.types[0]]);
 
+        final bool isLeaf = _isLeafArgument(node);
         _ensureNativeTypeValid(nativeType, node);
-        _ensureNativeTypeToDartType(nativeType, dartType, node);
+        _ensureNativeTypeToDartType(nativeType,
+            isLeaf ? _typedDataAsPointers(nativeType, dartType) : dartType,
+            node);
         _ensureNoEmptyStructs(dartType, node);
+        if (isLeaf) {
+          _ensureLeafCallDoesNotUseHandles(nativeType, node);
+        }
 
         final DartType nativeSignature =
             (nativeType as InterfaceType).typeArguments[0];
         // Inline function body to make all type arguments instatiated.
         return StaticInvocation(
             asFunctionInternal,
-            Arguments([node.arguments.positional[0]],
+            Arguments([node.arguments.positional[0], BoolLiteral(isLeaf)],
                 types: [dartType, nativeSignature]));
       } else if (target == fromFunctionMethod) {
         final DartType nativeType = InterfaceType(
@@ -294,10 +309,11 @@ class _FfiUseSiteTransformer extends FfiTransformer {
   // Above, in 'visitStaticInvocation', we ensure that the type arguments to
   // 'lookupFunction' are constants, so by inlining the call to 'asFunction' at
   // the call-site, we ensure that there are no generic calls to 'asFunction'.
-  Expression _replaceLookupFunction(StaticInvocation node) {
+  Expression _replaceLookupFunction(StaticInvocation node, bool isLeaf) {
     // The generated code looks like:
     //
-    // _asFunctionInternal<DS, NS>(lookup<NativeFunction<NS>>(symbolName))
+    // _asFunctionInternal<DS, NS>(lookup<NativeFunction<NS>>(symbolName),
+    //     isLeaf)
 
     final DartType nativeSignature = node.arguments.types[0];
     final DartType dartSignature = node.arguments.types[1];
@@ -314,8 +330,10 @@ class _FfiUseSiteTransformer extends FfiTransformer {
         args,
         libraryLookupMethod);
 
-    return StaticInvocation(asFunctionInternal,
-        Arguments([lookupResult], types: [dartSignature, nativeSignature]));
+    return StaticInvocation(
+        asFunctionInternal,
+        Arguments([lookupResult, BoolLiteral(isLeaf)],
+            types: [dartSignature, nativeSignature]));
   }
 
   // We need to rewrite calls to 'fromFunction' into two calls, representing the
@@ -463,6 +481,105 @@ class _FfiUseSiteTransformer extends FfiTransformer {
         null;
   }
 
+  /// Returns the value of the optional `isLeaf` argument of `asFunction` and
+  /// `lookupFunction`, which must be a constant so that the VM can pick the
+  /// calling sequence when it compiles the trampoline.
+  bool _isLeafArgument(StaticInvocation node) {
+    final NamedExpression isLeafArgument = node.arguments.named
+        .firstWhere((n) => n.name == 'isLeaf', orElse: () => null);
+    if (isLeafArgument == null) return false;
+    final Expression value = isLeafArgument.value;
+    if (value is BoolLiteral) return value.value;
+    if (value is ConstantExpression && value.constant is BoolConstant) {
+      return (value.constant as BoolConstant).value;
+    }
+    diagnosticReporter.report(
+        templateFfiExpectedConstantArg.withArguments('isLeaf'),
+        value.fileOffset,
+        1,
+        node.location.file);
+    throw _FfiStaticTypeError();
+  }
+
+  /// The typed data classes that leaf calls accept in place of a pointer to
+  /// their element type.
+  Map<NativeType, Class> _typedDataClasses;
+
+  Map<NativeType, Class> get typedDataClasses {
+    if (_typedDataClasses != null) return _typedDataClasses;
+    Class typedDataClass(String name) =>
+        coreTypes.index.getClass('dart:typed_data', name);
+    return _typedDataClasses = {
+      NativeType.kInt8: typedDataClass('Int8List'),
+      NativeType.kInt16: typedDataClass('Int16List'),
+      NativeType.kInt32: typedDataClass('Int32List'),
+      NativeType.kInt64: typedDataClass('Int64List'),
+      NativeType.kUint8: typedDataClass('Uint8List'),
+      NativeType.kUint16: typedDataClass('Uint16List'),
+      NativeType.kUint32: typedDataClass('Uint32List'),
+      NativeType.kUnit64: typedDataClass('Uint64List'),
+      NativeType.kFloat: typedDataClass('Float32List'),
+      NativeType.kDouble: typedDataClass('Float64List'),
+    };
+  }
+
+  /// Leaf calls can pass typed data where the native signature takes a
+  /// `Pointer` to the matching element type: no GC can happen during a leaf
+  /// call, so the VM passes the address of the typed data payload directly.
+  ///
+  /// Returns [dartType] with such parameters replaced by the `Pointer` type,
+  /// so that it can be checked against [nativeType] as usual.
+  DartType _typedDataAsPointers(DartType nativeType, DartType dartType) {
+    if (dartType is! FunctionType) return dartType;
+    final FunctionType dartSignature = dartType;
+    final DartType nativeSignature =
+        (nativeType as InterfaceType).typeArguments[0];
+    if (nativeSignature is! FunctionType) return dartType;
+    final List<DartType> nativeParameters =
+        (nativeSignature as FunctionType).positionalParameters;
+    if (nativeParameters.length != dartSignature.positionalParameters.length) {
+      return dartType;
+    }
+    final List<DartType> parameters = <DartType>[];
+    for (int i = 0; i < nativeParameters.length; i++) {
+      final DartType nativeParameter = nativeParameters[i];
+      final DartType dartParameter = dartSignature.positionalParameters[i];
+      if (nativeParameter is InterfaceType &&
+          nativeParameter.classNode == pointerClass &&
+          nativeParameter.typeArguments[0] is InterfaceType &&
+          dartParameter is InterfaceType &&
+          dartParameter.classNode ==
+              typedDataClasses[getType(
+                  (nativeParameter.typeArguments[0] as InterfaceType)
+                      .classNode)]) {
+        parameters.add(nativeParameter);
+      } else {
+        parameters.add(dartParameter);
+      }
+    }
+    return FunctionType(parameters, dartSignature.returnType,
+        dartSignature.declaredNullability);
+  }
+
+  /// Leaf calls do not enter the Dart API scope, so they cannot pass or
+  /// return handles.
+  void _ensureLeafCallDoesNotUseHandles(DartType nativeType, Expression node) {
+    final FunctionType signature =
+        (nativeType as InterfaceType).typeArguments[0];
+    bool isHandle(DartType type) =>
+        type is InterfaceType && getType(type.classNode) == NativeType.kHandle;
+    if (isHandle(signature.returnType)) {
+      diagnosticReporter.report(messageFfiLeafCallMustNotReturnHandle,
+          node.fileOffset, 1, node.location.file);
+      throw _FfiStaticTypeError();
+    }
+    if (signature.positionalParameters.any(isHandle)) {
+      diagnosticReporter.report(messageFfiLeafCallMustNotTakeHandle,
+          node.fileOffset, 1, node.location.file);
+      throw _FfiStaticTypeError();
+    }
+  }
+
   void _ensureIsStaticFunction(Expression node) {
     if ((node is StaticGet && node.target is Procedure) ||
         (node is ConstantExpression && node.constant is TearOffConstant)) {
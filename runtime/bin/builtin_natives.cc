@@ -91,6 +91,8 @@ void FUNCTION_NAME(Builtin_PrintString)(Dart_NativeArguments args) {
     Dart_PropagateError(result);
   }
 
+  // Keep print output in order with buffered stdio writes.
+  StdioBuffer::Flush();
   // Uses fwrite to support printing NUL bytes.
   intptr_t res = fwrite(chars, 1, length, stdout);
   ASSERT(res == length);
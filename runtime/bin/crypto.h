@@ -13,6 +13,9 @@ namespace bin {
 
 class Crypto {
  public:
+  static void Init();
+  static void Cleanup();
+
   static bool GetRandomBytes(intptr_t count, uint8_t* buffer);
 
  private:
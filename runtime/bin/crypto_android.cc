@@ -15,6 +15,10 @@
 namespace dart {
 namespace bin {
 
+void Crypto::Init() {}
+
+void Crypto::Cleanup() {}
+
 bool Crypto::GetRandomBytes(intptr_t count, uint8_t* buffer) {
   ThreadSignalBlocker signal_blocker(SIGPROF);
   intptr_t fd = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
@@ -12,6 +12,10 @@
 namespace dart {
 namespace bin {
 
+void Crypto::Init() {}
+
+void Crypto::Cleanup() {}
+
 bool Crypto::GetRandomBytes(intptr_t count, uint8_t* buffer) {
   zx_cprng_draw(buffer, count);
   return true;
@@ -5,17 +5,22 @@
 #include "platform/globals.h"
 #if defined(HOST_OS_LINUX)
 
-#include <errno.h>  // NOLINT
-#include <fcntl.h>  // NOLINT
+#include <errno.h>        // NOLINT
+#include <fcntl.h>        // NOLINT
+#include <sys/mman.h>     // NOLINT
+#include <sys/syscall.h>  // NOLINT
+#include <unistd.h>       // NOLINT
 
 #include "bin/crypto.h"
 #include "bin/fdutils.h"
+#include "bin/lockers.h"
+#include "bin/thread.h"
 #include "platform/signal_blocker.h"
 
 namespace dart {
 namespace bin {
 
-bool Crypto::GetRandomBytes(intptr_t count, uint8_t* buffer) {
+static bool ReadURandom(intptr_t count, uint8_t* buffer) {
   ThreadSignalBlocker signal_blocker(SIGPROF);
   intptr_t fd = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
       open("/dev/urandom", O_RDONLY | O_CLOEXEC));
@@ -38,6 +43,102 @@ bool Crypto::GetRandomBytes(intptr_t count, uint8_t* buffer) {
   return true;
 }
 
+// Reads from the kernel, preferring getrandom which needs no file
+// descriptor.
+static bool ReadKernelRandom(intptr_t count, uint8_t* buffer) {
+#if defined(__NR_getrandom)
+  intptr_t bytes_read = 0;
+  while (bytes_read < count) {
+    long res = syscall(__NR_getrandom, buffer + bytes_read,  // NOLINT
+                       count - bytes_read, 0);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == ENOSYS) {
+        break;
+      }
+      return false;
+    }
+    bytes_read += res;
+  }
+  if (bytes_read == count) {
+    return true;
+  }
+#endif  // defined(__NR_getrandom)
+  return ReadURandom(count, buffer);
+}
+
+// Random.secure() asks for a few bytes at a time. Rather than going to the
+// kernel for each request, small requests are served from a page of kernel
+// randomness that is refilled when it runs out. The page is mapped with
+// MADV_WIPEONFORK, so a forked child sees an empty pool and never hands out
+// bytes the parent has used or will use.
+struct RandomPool {
+  intptr_t available;
+  uint8_t bytes[1];
+};
+
+static const intptr_t kRandomPoolSize = 4 * KB;
+static const intptr_t kRandomPoolBytes =
+    kRandomPoolSize - offsetof(RandomPool, bytes);
+// Larger requests go straight to the kernel.
+static const intptr_t kMaxPooledRequest = 256;
+
+static Mutex* pool_mutex = nullptr;
+static RandomPool* pool = nullptr;
+
+void Crypto::Init() {
+  ASSERT(pool_mutex == nullptr);
+  void* memory = mmap(NULL, kRandomPoolSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    return;
+  }
+#if defined(MADV_WIPEONFORK)
+  if (madvise(memory, kRandomPoolSize, MADV_WIPEONFORK) == 0) {
+    pool = reinterpret_cast<RandomPool*>(memory);
+    pool->available = 0;
+    pool_mutex = new Mutex();
+    return;
+  }
+#endif  // defined(MADV_WIPEONFORK)
+  // Without wipe-on-fork a child could repeat the parent's bytes, so don't
+  // pool at all.
+  munmap(memory, kRandomPoolSize);
+}
+
+void Crypto::Cleanup() {
+  if (pool_mutex == nullptr) {
+    return;
+  }
+  memset(pool, 0, kRandomPoolSize);
+  munmap(pool, kRandomPoolSize);
+  pool = nullptr;
+  delete pool_mutex;
+  pool_mutex = nullptr;
+}
+
+bool Crypto::GetRandomBytes(intptr_t count, uint8_t* buffer) {
+  if ((pool_mutex == nullptr) || (count > kMaxPooledRequest)) {
+    return ReadKernelRandom(count, buffer);
+  }
+  MutexLocker locker(pool_mutex);
+  if (pool->available < count) {
+    if (!ReadKernelRandom(kRandomPoolBytes, pool->bytes)) {
+      return false;
+    }
+    pool->available = kRandomPoolBytes;
+  }
+  // Hand out bytes from the end and clear them, so that no byte is used
+  // twice or kept in memory after use.
+  uint8_t* source = pool->bytes + pool->available - count;
+  memmove(buffer, source, count);
+  memset(source, 0, count);
+  pool->available -= count;
+  return true;
+}
+
 }  // namespace bin
 }  // namespace dart
 
@@ -15,6 +15,10 @@
 namespace dart {
 namespace bin {
 
+void Crypto::Init() {}
+
+void Crypto::Cleanup() {}
+
 bool Crypto::GetRandomBytes(intptr_t count, uint8_t* buffer) {
   intptr_t fd = TEMP_FAILURE_RETRY(open("/dev/urandom", O_RDONLY | O_CLOEXEC));
   if (fd < 0) {
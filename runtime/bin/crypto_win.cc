@@ -14,6 +14,10 @@
 namespace dart {
 namespace bin {
 
+void Crypto::Init() {}
+
+void Crypto::Cleanup() {}
+
 bool Crypto::GetRandomBytes(intptr_t count, uint8_t* buffer) {
   uint32_t num;
   intptr_t read = 0;
@@ -4,8 +4,11 @@
 
 #include "include/dart_embedder_api.h"
 
+#include "bin/crypto.h"
 #include "bin/dartutils.h"
 #include "bin/eventhandler.h"
+#include "bin/file.h"
+#include "bin/filter.h"
 #include "bin/isolate_data.h"
 #include "bin/process.h"
 #include "bin/secure_socket_filter.h"
@@ -40,6 +43,9 @@ bool InitOnce(char** error) {
   }
   bin::TimerUtils::InitOnce();
   bin::Process::Init();
+  bin::Crypto::Init();
+  bin::ZLibStreamCache::Init();
+  bin::StdioBuffer::Init();
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   bin::SSLFilter::Init();
 #endif
@@ -54,6 +60,9 @@ void Cleanup() {
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   bin::SSLFilter::Cleanup();
 #endif
+  bin::StdioBuffer::Cleanup();
+  bin::ZLibStreamCache::Cleanup();
+  bin::Crypto::Cleanup();
   bin::Process::Cleanup();
 }
 
@@ -7,6 +7,8 @@
 #include "bin/crypto.h"
 #include "bin/directory.h"
 #include "bin/eventhandler.h"
+#include "bin/file.h"
+#include "bin/filter.h"
 #include "bin/io_natives.h"
 #include "bin/platform.h"
 #include "bin/process.h"
@@ -23,6 +25,9 @@ void BootstrapDartIo() {
   // Bootstrap 'dart:io' event handler.
   TimerUtils::InitOnce();
   Process::Init();
+  Crypto::Init();
+  ZLibStreamCache::Init();
+  StdioBuffer::Init();
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   SSLFilter::Init();
 #endif
@@ -34,6 +39,9 @@ void CleanupDartIo() {
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   SSLFilter::Cleanup();
 #endif
+  StdioBuffer::Cleanup();
+  ZLibStreamCache::Cleanup();
+  Crypto::Cleanup();
   Process::Cleanup();
 }
 
@@ -9,6 +9,7 @@
 #include "bin/extensions.h"
 #include "bin/file.h"
 #include "bin/io_buffer.h"
+#include "bin/lockers.h"
 #include "bin/namespace.h"
 #include "bin/platform.h"
 #include "bin/utils.h"
@@ -302,6 +303,70 @@ void DartUtils::ReadFile(uint8_t** data, intptr_t* len, void* stream) {
   }
 }
 
+// The mappings created by MapFile, so that FreeFileData can tell them apart
+// from malloc'd data.
+struct MappedFileData {
+  MappedMemory* mapping;
+  MappedFileData* next;
+};
+
+static MappedFileData* mapped_files = nullptr;
+
+static Mutex* MappedFilesMutex() {
+  static Mutex* mutex = new Mutex();
+  return mutex;
+}
+
+void DartUtils::MapFile(uint8_t** data, intptr_t* len, void* stream) {
+  ASSERT(data != NULL);
+  ASSERT(len != NULL);
+  ASSERT(stream != NULL);
+  File* file_stream = reinterpret_cast<File*>(stream);
+  int64_t file_len = file_stream->Length();
+  if ((file_len <= 0) || (file_len > kIntptrMax)) {
+    ReadFile(data, len, stream);
+    return;
+  }
+  MappedMemory* mapping = file_stream->Map(File::kReadOnly, 0, file_len);
+  if (mapping == nullptr) {
+    ReadFile(data, len, stream);
+    return;
+  }
+  MappedFileData* entry = new MappedFileData();
+  entry->mapping = mapping;
+  {
+    MutexLocker ml(MappedFilesMutex());
+    entry->next = mapped_files;
+    mapped_files = entry;
+  }
+  *data = reinterpret_cast<uint8_t*>(mapping->address());
+  *len = static_cast<intptr_t>(file_len);
+}
+
+void DartUtils::FreeFileData(uint8_t* data) {
+  if (data == nullptr) {
+    return;
+  }
+  MappedFileData* entry = nullptr;
+  {
+    MutexLocker ml(MappedFilesMutex());
+    for (MappedFileData** link = &mapped_files; *link != nullptr;
+         link = &(*link)->next) {
+      if ((*link)->mapping->address() == data) {
+        entry = *link;
+        *link = entry->next;
+        break;
+      }
+    }
+  }
+  if (entry == nullptr) {
+    free(data);
+    return;
+  }
+  delete entry->mapping;
+  delete entry;
+}
+
 void DartUtils::WriteFile(const void* buffer,
                           intptr_t num_bytes,
                           void* stream) {
@@ -158,6 +158,12 @@ class DartUtils {
   static void* OpenFile(const char* name, bool write);
   static void* OpenFileUri(const char* uri, bool write);
   static void ReadFile(uint8_t** data, intptr_t* file_len, void* stream);
+  // Like ReadFile, but maps the file read-only instead of copying it when the
+  // file can be mapped. Processes reading the same file then share its pages.
+  // The data must be released with FreeFileData.
+  static void MapFile(uint8_t** data, intptr_t* file_len, void* stream);
+  // Releases data returned by MapFile, or malloc'd data.
+  static void FreeFileData(uint8_t* data);
   static void WriteFile(const void* buffer, intptr_t num_bytes, void* stream);
   static void CloseFile(void* stream);
   static bool EntropySource(uint8_t* buffer, intptr_t length);
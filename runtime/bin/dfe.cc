@@ -74,7 +74,7 @@ DFE::~DFE() {
   }
   frontend_filename_ = nullptr;
 
-  free(application_kernel_buffer_);
+  DartUtils::FreeFileData(application_kernel_buffer_);
   application_kernel_buffer_ = nullptr;
   application_kernel_buffer_size_ = 0;
 }
@@ -234,7 +234,7 @@ void DFE::ReadScript(const char* script_uri,
     return;
   }
   if (!Dart_IsKernel(*kernel_buffer, *kernel_buffer_size)) {
-    free(*kernel_buffer);
+    DartUtils::FreeFileData(*kernel_buffer);
     *kernel_buffer = nullptr;
     *kernel_buffer_size = -1;
   }
@@ -261,7 +261,7 @@ static bool TryReadSimpleKernelBuffer(uint8_t* buffer,
     *p_kernel_ir = buffer;
     return true;
   }
-  free(buffer);
+  DartUtils::FreeFileData(buffer);
   *p_kernel_ir = nullptr;
   *p_kernel_ir_size = -1;
   return false;
@@ -269,15 +269,17 @@ static bool TryReadSimpleKernelBuffer(uint8_t* buffer,
 
 /// Reads [script_uri] file, returns [true] if successful, [false] otherwise.
 ///
-/// If successful, newly allocated buffer with file contents is returned in
-/// [buffer], file contents byte count - in [size].
+/// If successful, a read-only buffer with file contents is returned in
+/// [buffer], file contents byte count - in [size]. The buffer is a mapping of
+/// the file where possible and must be released with
+/// [DartUtils::FreeFileData].
 static bool TryReadFile(const char* script_uri, uint8_t** buffer,
                         intptr_t* size) {
   void* script_file = DartUtils::OpenFileUri(script_uri, false);
   if (script_file == nullptr) {
     return false;
   }
-  DartUtils::ReadFile(buffer, size, script_file);
+  DartUtils::MapFile(buffer, size, script_file);
   DartUtils::CloseFile(script_file);
   if (buffer == nullptr) {
     return false;
@@ -291,7 +293,7 @@ class KernelIRNode {
       : kernel_ir_(kernel_ir), kernel_size_(kernel_size) {}
 
   ~KernelIRNode() {
-    free(kernel_ir_);
+    DartUtils::FreeFileData(kernel_ir_);
   }
 
   static void Add(KernelIRNode** p_head, KernelIRNode** p_tail,
@@ -380,14 +382,16 @@ static bool TryReadKernelListBuffer(const char* script_uri,
   intptr_t filename_size = buffer_size - kernel_list_magic_number.length;
   char* tail = reinterpret_cast<char*>(memchr(filename, '\n', filename_size));
   while (tail != nullptr) {
-    *tail = '\0';
     intptr_t this_kernel_size;
     uint8_t* this_buffer;
 
+    // The buffer may be a read-only mapping of the list file, so the file
+    // name is copied rather than terminated in place.
+    StringPointer name(Utils::StrNDup(filename, tail - filename));
     StringPointer resolved_filename(
-        File::IsAbsolutePath(filename)
-            ? Utils::StrDup(filename)
-            : Utils::SCreate("%s%s", kernel_list_dirname, filename));
+        File::IsAbsolutePath(name.c_str())
+            ? Utils::StrDup(name.c_str())
+            : Utils::SCreate("%s%s", kernel_list_dirname, name.c_str()));
     if (!TryReadFile(resolved_filename.c_str(), &this_buffer,
                      &this_kernel_size)) {
       return false;
@@ -408,7 +412,7 @@ static bool TryReadKernelListBuffer(const char* script_uri,
     filename = tail + 1;
     tail = reinterpret_cast<char*>(memchr(filename, '\n', filename_size));
   }
-  free(buffer);
+  DartUtils::FreeFileData(buffer);
 
   KernelIRNode::Merge(kernel_ir_head, kernel_ir, kernel_ir_size);
   KernelIRNode::Delete(kernel_ir_head);
@@ -67,6 +67,7 @@ class DFE {
   // If the compilation is successful, returns a valid in memory kernel
   // representation of the script, NULL otherwise
   // 'error' and 'exit_code' have the error values in case of errors.
+  // The kernel buffer must be released with DartUtils::FreeFileData.
   void CompileAndReadScript(const char* script_uri,
                             uint8_t** kernel_buffer,
                             intptr_t* kernel_buffer_size,
@@ -77,6 +78,8 @@ class DFE {
   // Reads the script kernel file if specified 'script_uri' is a kernel file.
   // Returns an in memory kernel representation of the specified script is a
   // valid kernel file, false otherwise.
+  // The kernel file is mapped read-only where possible, and the buffer must be
+  // released with DartUtils::FreeFileData.
   void ReadScript(const char* script_uri,
                   uint8_t** kernel_buffer,
                   intptr_t* kernel_buffer_size) const;
@@ -86,8 +89,8 @@ class DFE {
   // Tries to read [script_uri] as a Kernel IR file.
   // Returns `true` if successful and sets [kernel_file] and [kernel_length]
   // to be the kernel IR contents.
-  // The caller is responsible for free()ing [kernel_file] if `true`
-  // was returned.
+  // The caller is responsible for releasing [kernel_file] with
+  // DartUtils::FreeFileData if `true` was returned.
   static bool TryReadKernelFile(const char* script_uri,
                                 uint8_t** kernel_buffer,
                                 intptr_t* kernel_buffer_size);
@@ -396,9 +396,9 @@ CObject* Directory::ListNextRequest(const CObjectArray& request) {
   if (dir_listing->IsEmpty()) {
     return new CObjectArray(CObject::NewArray(0));
   }
-  const int kArraySize = 128;
-  CObjectArray* response = new CObjectArray(CObject::NewArray(kArraySize));
-  dir_listing->SetArray(response, kArraySize);
+  const intptr_t array_size = dir_listing->NextBatchSize();
+  CObjectArray* response = new CObjectArray(CObject::NewArray(array_size));
+  dir_listing->SetArray(response, array_size);
   Directory::List(dir_listing);
   // In case the listing ended before it hit the buffer length, we need to
   // override the array length.
@@ -448,14 +448,13 @@ bool AsyncDirectoryListing::AddFileSystemEntityToResponse(Response type,
                                                           const char* arg) {
   array_->SetAt(index_++, new CObjectInt32(CObject::NewInt32(type)));
   if (arg != NULL) {
+    // Paths are short, so copy them into the response instead of handing out
+    // an external buffer per entry: that would cost a malloc here and a
+    // finalizer in the receiving isolate for every file in the listing.
     size_t len = strlen(arg);
-    Dart_CObject* io_buffer = CObject::NewIOBuffer(len);
-    uint8_t* data = io_buffer->value.as_external_typed_data.data;
-    memmove(reinterpret_cast<char*>(data), arg, len);
-
-    CObjectExternalUint8Array* external_array =
-        new CObjectExternalUint8Array(io_buffer);
-    array_->SetAt(index_++, external_array);
+    Dart_CObject* bytes = CObject::NewUint8Array(len);
+    memmove(bytes->value.as_typed_data.values, arg, len);
+    array_->SetAt(index_++, new CObjectUint8Array(bytes));
   } else {
     array_->SetAt(index_++, CObject::Null());
   }
@@ -172,7 +172,8 @@ class AsyncDirectoryListing : public ReferenceCounted<AsyncDirectoryListing>,
         DirectoryListing(namespc, dir_name, recursive, follow_links),
         array_(NULL),
         index_(0),
-        length_(0) {}
+        length_(0),
+        batch_size_(kMinBatchSize) {}
 
   virtual bool HandleDirectory(const char* dir_name);
   virtual bool HandleFile(const char* file_name);
@@ -189,12 +190,28 @@ class AsyncDirectoryListing : public ReferenceCounted<AsyncDirectoryListing>,
 
   intptr_t index() const { return index_; }
 
+  // Returns the array length to use for the next ListNext response. Short
+  // listings get a small first response, and long ones grow towards
+  // kMaxBatchSize so that large trees need fewer round trips.
+  intptr_t NextBatchSize() {
+    intptr_t size = batch_size_;
+    if (batch_size_ < kMaxBatchSize) {
+      batch_size_ *= 2;
+    }
+    return size;
+  }
+
  private:
+  // Each entry takes two slots: the response type and the path.
+  static const intptr_t kMinBatchSize = 128;
+  static const intptr_t kMaxBatchSize = 4096;
+
   virtual ~AsyncDirectoryListing() {}
   bool AddFileSystemEntityToResponse(Response response, const char* arg);
   CObjectArray* array_;
   intptr_t index_;
   intptr_t length_;
+  intptr_t batch_size_;
 
   friend class ReferenceCounted<AsyncDirectoryListing>;
   DISALLOW_IMPLICIT_CONSTRUCTORS(AsyncDirectoryListing);
@@ -10,7 +10,8 @@
 #include <vm/cpu.h>
 #include <vm/virtual_memory.h>
 
-#if defined(HOST_OS_FUCHSIA)
+#if defined(HOST_OS_FUCHSIA) || defined(HOST_OS_LINUX) ||                    \
+    defined(HOST_OS_ANDROID)
 #include <sys/mman.h>
 #endif
 
@@ -450,6 +451,16 @@ bool LoadedElf::LoadSegments() {
     CHECK_ERROR(memory != nullptr, "Could not map segment.");
     CHECK_ERROR(memory->address() == memory_start,
                 "Mapping not at requested address.");
+
+#if (defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)) &&                   \
+    defined(MADV_WILLNEED)
+    // Start reading the instructions in now, so the first calls into
+    // compiled code do not each fault in a page from disk. This only fills
+    // the page cache, which is shared by every process mapping the snapshot.
+    if (map_type == File::kReadExecute) {
+      madvise(memory_start, length, MADV_WILLNEED);
+    }
+#endif
   }
 
   return true;
@@ -16,51 +16,96 @@ namespace dart {
 namespace bin {
 
 void TimeoutQueue::UpdateTimeout(Dart_Port port, int64_t timeout) {
-  // Find port if present.
-  Timeout* last = NULL;
-  Timeout* current = timeouts_;
-  while (current != NULL) {
-    if (current->port() == port) {
-      // Found.
-      if (timeout < 0) {
-        // Remove from list and delete existing.
-        if (last != NULL) {
-          last->set_next(current->next());
-        } else {
-          timeouts_ = current->next();
-        }
-        delete current;
-      } else {
-        // Update timeout.
-        current->set_timeout(timeout);
-      }
-      break;
+  SimpleHashMap::Entry* entry = positions_.Lookup(
+      GetHashmapKeyFromPort(port), GetHashmapHashFromPort(port), false);
+  if (entry == NULL) {
+    if (timeout < 0) {
+      return;
     }
-    last = current;
-    current = current->next();
+    entry = positions_.Lookup(GetHashmapKeyFromPort(port),
+                              GetHashmapHashFromPort(port), true);
+    ASSERT(entry != NULL);
+    Timeout added = {port, timeout};
+    heap_.Add(added);
+    Place(heap_.length() - 1, added);
+    SiftUp(heap_.length() - 1);
+    return;
+  }
+  const intptr_t index = reinterpret_cast<intptr_t>(entry->value);
+  ASSERT(heap_[index].port == port);
+  if (timeout < 0) {
+    positions_.Remove(GetHashmapKeyFromPort(port),
+                      GetHashmapHashFromPort(port));
+    Timeout last = heap_.RemoveLast();
+    if (index < heap_.length()) {
+      // Move the last element into the hole and restore the heap order.
+      Place(index, last);
+      SiftUp(index);
+      SiftDown(index);
+    }
+    return;
   }
-  if (current == NULL && timeout >= 0) {
-    // Not found, create a new.
-    timeouts_ = new Timeout(port, timeout, timeouts_);
+  const int64_t old_timeout = heap_[index].timeout;
+  heap_[index].timeout = timeout;
+  if (timeout < old_timeout) {
+    SiftUp(index);
+  } else {
+    SiftDown(index);
+  }
+}
+
+void TimeoutQueue::Place(intptr_t index, const Timeout& timeout) {
+  heap_[index] = timeout;
+  SimpleHashMap::Entry* entry =
+      positions_.Lookup(GetHashmapKeyFromPort(timeout.port),
+                        GetHashmapHashFromPort(timeout.port), false);
+  ASSERT(entry != NULL);
+  entry->value = reinterpret_cast<void*>(index);
+}
+
+void TimeoutQueue::SiftUp(intptr_t index) {
+  Timeout timeout = heap_[index];
+  while (index > 0) {
+    const intptr_t parent = (index - 1) / 2;
+    if (heap_[parent].timeout <= timeout.timeout) {
+      break;
+    }
+    Place(index, heap_[parent]);
+    index = parent;
   }
-  // Clear and find next timeout.
-  next_timeout_ = NULL;
-  current = timeouts_;
-  while (current != NULL) {
-    if ((next_timeout_ == NULL) ||
-        (current->timeout() < next_timeout_->timeout())) {
-      next_timeout_ = current;
+  Place(index, timeout);
+}
+
+void TimeoutQueue::SiftDown(intptr_t index) {
+  Timeout timeout = heap_[index];
+  const intptr_t length = heap_.length();
+  while (true) {
+    intptr_t child = 2 * index + 1;
+    if (child >= length) {
+      break;
+    }
+    if ((child + 1 < length) &&
+        (heap_[child + 1].timeout < heap_[child].timeout)) {
+      child++;
     }
-    current = current->next();
+    if (timeout.timeout <= heap_[child].timeout) {
+      break;
+    }
+    Place(index, heap_[child]);
+    index = child;
   }
+  Place(index, timeout);
 }
 
+intptr_t EventHandler::thread_count_ = 1;
+
 static EventHandler* event_handler = NULL;
 static Monitor* shutdown_monitor = NULL;
 
 void EventHandler::Start() {
   // Initialize global socket registry.
   ListeningSocketRegistry::Initialize();
+  HostLookupCache::Initialize();
 
   ASSERT(event_handler == NULL);
   shutdown_monitor = new Monitor();
@@ -99,6 +144,7 @@ void EventHandler::Stop() {
 
   // Destroy the global socket registry.
   ListeningSocketRegistry::Cleanup();
+  HostLookupCache::Cleanup();
 }
 
 EventHandlerImplementation* EventHandler::delegate() {
@@ -9,6 +9,7 @@
 #include "bin/dartutils.h"
 #include "bin/isolate_data.h"
 
+#include "platform/growable_array.h"
 #include "platform/hashmap.h"
 
 namespace dart {
@@ -56,57 +57,55 @@ enum MessageFlags {
 #define TOKEN_COUNT(data) (data & ((1 << kCloseCommand) - 1))
 // clang-format on
 
+// The wakeup times requested by isolates, one per port, kept in a binary
+// min-heap. A map from port to heap position makes updating or cancelling
+// a port's timeout O(log n), and the next timeout is always at the root.
 class TimeoutQueue {
  private:
-  class Timeout {
-   public:
-    Timeout(Dart_Port port, int64_t timeout, Timeout* next)
-        : port_(port), timeout_(timeout), next_(next) {}
-
-    Dart_Port port() const { return port_; }
-
-    int64_t timeout() const { return timeout_; }
-    void set_timeout(int64_t timeout) {
-      ASSERT(timeout >= 0);
-      timeout_ = timeout;
-    }
-
-    Timeout* next() const { return next_; }
-    void set_next(Timeout* next) { next_ = next; }
-
-   private:
-    Dart_Port port_;
-    int64_t timeout_;
-    Timeout* next_;
+  struct Timeout {
+    Dart_Port port;
+    int64_t timeout;
   };
 
  public:
-  TimeoutQueue() : next_timeout_(NULL), timeouts_(NULL) {}
-
-  ~TimeoutQueue() {
-    while (HasTimeout())
-      RemoveCurrent();
-  }
+  TimeoutQueue()
+      : positions_(&SimpleHashMap::SamePointerValue, kInitialCapacity) {}
 
-  bool HasTimeout() const { return next_timeout_ != NULL; }
+  bool HasTimeout() const { return heap_.length() > 0; }
 
   int64_t CurrentTimeout() const {
-    ASSERT(next_timeout_ != NULL);
-    return next_timeout_->timeout();
+    ASSERT(HasTimeout());
+    return heap_[0].timeout;
   }
 
   Dart_Port CurrentPort() const {
-    ASSERT(next_timeout_ != NULL);
-    return next_timeout_->port();
+    ASSERT(HasTimeout());
+    return heap_[0].port;
   }
 
   void RemoveCurrent() { UpdateTimeout(CurrentPort(), -1); }
 
+  // Sets the timeout of `port`, or removes it if `timeout` is negative.
   void UpdateTimeout(Dart_Port port, int64_t timeout);
 
  private:
-  Timeout* next_timeout_;
-  Timeout* timeouts_;
+  static const int kInitialCapacity = 8;
+
+  static uint32_t GetHashmapHashFromPort(Dart_Port port) {
+    return static_cast<uint32_t>(port & 0xFFFFFFFF);
+  }
+
+  static void* GetHashmapKeyFromPort(Dart_Port port) {
+    return reinterpret_cast<void*>(port);
+  }
+
+  // Stores `timeout` at `index` and records its new position.
+  void Place(intptr_t index, const Timeout& timeout);
+  void SiftUp(intptr_t index);
+  void SiftDown(intptr_t index);
+
+  MallocGrowableArray<Timeout> heap_;
+  SimpleHashMap positions_;
 
   DISALLOW_COPY_AND_ASSIGN(TimeoutQueue);
 };
@@ -372,11 +371,6 @@ class DescriptorInfoMultipleMixin : public DI {
  private:
   static const int kTokenCount = 4;
 
-  static bool SamePortValue(void* key1, void* key2) {
-    return reinterpret_cast<Dart_Port>(key1) ==
-           reinterpret_cast<Dart_Port>(key2);
-  }
-
   static uint32_t GetHashmapHashFromPort(Dart_Port port) {
     return static_cast<uint32_t>(port & 0xFFFFFFFF);
   }
@@ -405,7 +399,7 @@ class DescriptorInfoMultipleMixin : public DI {
  public:
   DescriptorInfoMultipleMixin(intptr_t fd, bool disable_tokens)
       : DI(fd),
-        tokens_map_(&SamePortValue, kTokenCount),
+        tokens_map_(&SimpleHashMap::SamePointerValue, kTokenCount),
         disable_tokens_(disable_tokens) {}
 
   virtual ~DescriptorInfoMultipleMixin() { RemoveAllPorts(); }
@@ -643,10 +637,22 @@ class EventHandler {
 
   static void SendFromNative(intptr_t id, Dart_Port port, int64_t data);
 
+  /**
+   * Number of poll threads used by the event-handler. Must be set before
+   * Start. Only the Linux implementation uses more than one thread.
+   */
+  static intptr_t thread_count() { return thread_count_; }
+  static void set_thread_count(intptr_t thread_count) {
+    ASSERT(thread_count >= 1);
+    thread_count_ = thread_count;
+  }
+
  private:
   friend class EventHandlerImplementation;
   EventHandlerImplementation delegate_;
 
+  static intptr_t thread_count_;
+
   DISALLOW_COPY_AND_ASSIGN(EventHandler);
 };
 
@@ -14,6 +14,7 @@
 #include <stdio.h>        // NOLINT
 #include <string.h>       // NOLINT
 #include <sys/epoll.h>    // NOLINT
+#include <sys/eventfd.h>  // NOLINT
 #include <sys/stat.h>     // NOLINT
 #include <sys/timerfd.h>  // NOLINT
 #include <unistd.h>       // NOLINT
@@ -68,23 +69,14 @@ static void AddToEpollInstance(intptr_t epoll_fd_, DescriptorInfo* di) {
   }
 }
 
-EventHandlerImplementation::EventHandlerImplementation()
-    : socket_map_(&SimpleHashMap::SamePointerValue, 16) {
-  intptr_t result;
-  result = NO_RETRY_EXPECTED(pipe(interrupt_fds_));
-  if (result != 0) {
-    FATAL("Pipe creation failed");
-  }
-  if (!FDUtils::SetNonBlocking(interrupt_fds_[0])) {
-    FATAL("Failed to set pipe fd non blocking\n");
+EventHandlerShard::EventHandlerShard(EventHandlerImplementation* owner)
+    : owner_(owner),
+      socket_map_(&SimpleHashMap::SamePointerValue, 16),
+      shutdown_(false) {
+  interrupt_fd_ = NO_RETRY_EXPECTED(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+  if (interrupt_fd_ == -1) {
+    FATAL1("Failed creating interrupt eventfd: %i", errno);
   }
-  if (!FDUtils::SetCloseOnExec(interrupt_fds_[0])) {
-    FATAL("Failed to set pipe fd close on exec\n");
-  }
-  if (!FDUtils::SetCloseOnExec(interrupt_fds_[1])) {
-    FATAL("Failed to set pipe fd close on exec\n");
-  }
-  shutdown_ = false;
   // The initial size passed to epoll_create is ignore on newer (>=
   // 2.6.8) Linux versions
   static const int kEpollInitialSize = 64;
@@ -100,7 +92,7 @@ EventHandlerImplementation::EventHandlerImplementation()
   event.events = EPOLLIN;
   event.data.ptr = NULL;
   int status = NO_RETRY_EXPECTED(
-      epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, interrupt_fds_[0], &event));
+      epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, interrupt_fd_, &event));
   if (status == -1) {
     FATAL("Failed adding interrupt fd to epoll instance");
   }
@@ -125,16 +117,15 @@ static void DeleteDescriptorInfo(void* info) {
   delete di;
 }
 
-EventHandlerImplementation::~EventHandlerImplementation() {
+EventHandlerShard::~EventHandlerShard() {
   socket_map_.Clear(DeleteDescriptorInfo);
   close(epoll_fd_);
   close(timer_fd_);
-  close(interrupt_fds_[0]);
-  close(interrupt_fds_[1]);
+  close(interrupt_fd_);
 }
 
-void EventHandlerImplementation::UpdateEpollInstance(intptr_t old_mask,
-                                                     DescriptorInfo* di) {
+void EventHandlerShard::UpdateEpollInstance(intptr_t old_mask,
+                                            DescriptorInfo* di) {
   intptr_t new_mask = di->Mask();
   if ((old_mask != 0) && (new_mask == 0)) {
     RemoveFromEpollInstance(epoll_fd_, di);
@@ -147,9 +138,8 @@ void EventHandlerImplementation::UpdateEpollInstance(intptr_t old_mask,
   }
 }
 
-DescriptorInfo* EventHandlerImplementation::GetDescriptorInfo(
-    intptr_t fd,
-    bool is_listening) {
+DescriptorInfo* EventHandlerShard::GetDescriptorInfo(intptr_t fd,
+                                                    bool is_listening) {
   ASSERT(fd >= 0);
   SimpleHashMap::Entry* entry = socket_map_.Lookup(
       GetHashmapKeyFromFd(fd), GetHashmapHashFromFd(fd), true);
@@ -169,120 +159,147 @@ DescriptorInfo* EventHandlerImplementation::GetDescriptorInfo(
   return di;
 }
 
-void EventHandlerImplementation::WakeupHandler(intptr_t id,
-                                               Dart_Port dart_port,
-                                               int64_t data) {
+void EventHandlerShard::SendData(intptr_t id,
+                                 Dart_Port dart_port,
+                                 int64_t data) {
   InterruptMessage msg;
   msg.id = id;
   msg.dart_port = dart_port;
   msg.data = data;
-  // WriteToBlocking will write up to 512 bytes atomically, and since our msg
-  // is smaller than 512, we don't need a thread lock.
-  // See: http://linux.die.net/man/7/pipe, section 'Pipe_buf'.
-  ASSERT(kInterruptMessageSize < PIPE_BUF);
-  intptr_t result =
-      FDUtils::WriteToBlocking(interrupt_fds_[1], &msg, kInterruptMessageSize);
-  if (result != kInterruptMessageSize) {
-    if (result == -1) {
-      perror("Interrupt message failure:");
+  bool was_empty;
+  {
+    MutexLocker ml(&messages_mutex_);
+    was_empty = messages_.is_empty();
+    messages_.Add(msg);
+  }
+  if (was_empty) {
+    // The poll thread drains every queued message per wakeup, so only the
+    // first message after a drain has to signal it.
+    const uint64_t value = 1;
+    intptr_t result =
+        TEMP_FAILURE_RETRY(write(interrupt_fd_, &value, sizeof(value)));
+    if (result != sizeof(value)) {
+      if (result == -1) {
+        perror("Interrupt message failure:");
+      }
+      FATAL1("Interrupt message failure. Wrote %" Pd " bytes.", result);
     }
-    FATAL1("Interrupt message failure. Wrote %" Pd " bytes.", result);
   }
 }
 
-void EventHandlerImplementation::HandleInterruptFd() {
-  const intptr_t MAX_MESSAGES = kInterruptMessageSize;
-  InterruptMessage msg[MAX_MESSAGES];
-  ssize_t bytes = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
-      read(interrupt_fds_[0], msg, MAX_MESSAGES * kInterruptMessageSize));
-  for (ssize_t i = 0; i < bytes / kInterruptMessageSize; i++) {
-    if (msg[i].id == kTimerId) {
-      timeout_queue_.UpdateTimeout(msg[i].dart_port, msg[i].data);
-      UpdateTimerFd();
-    } else if (msg[i].id == kShutdownId) {
-      shutdown_ = true;
-    } else {
-      ASSERT((msg[i].data & COMMAND_MASK) != 0);
-      Socket* socket = reinterpret_cast<Socket*>(msg[i].id);
-      RefCntReleaseScope<Socket> rs(socket);
-      if (socket->fd() == -1) {
-        continue;
+void EventHandlerShard::HandleInterruptFd() {
+  // Reset the eventfd before draining the queue: a message added after the
+  // drain finds the queue empty again and signals a new wakeup.
+  uint64_t value;
+  VOID_TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
+      read(interrupt_fd_, &value, sizeof(value)));
+  {
+    MutexLocker ml(&messages_mutex_);
+    for (intptr_t i = 0; i < messages_.length(); i++) {
+      pending_.Add(messages_[i]);
+    }
+    messages_.Clear();
+  }
+  for (intptr_t i = 0; i < pending_.length(); i++) {
+    HandleInterruptMessage(pending_[i]);
+  }
+  pending_.Clear();
+}
+
+void EventHandlerShard::HandleInterruptMessage(const InterruptMessage& msg) {
+  if (msg.id == kTimerId) {
+    timeout_queue_.UpdateTimeout(msg.dart_port, msg.data);
+    UpdateTimerFd();
+  } else if (msg.id == kShutdownId) {
+    shutdown_ = true;
+  } else {
+    ASSERT((msg.data & COMMAND_MASK) != 0);
+    Socket* socket = reinterpret_cast<Socket*>(msg.id);
+    RefCntReleaseScope<Socket> rs(socket);
+    if (socket->fd() == -1) {
+      return;
+    }
+    DescriptorInfo* di =
+        GetDescriptorInfo(socket->fd(), IS_LISTENING_SOCKET(msg.data));
+    if (IS_COMMAND(msg.data, kShutdownReadCommand)) {
+      ASSERT(!di->IsListeningSocket());
+      // Close the socket for reading.
+      VOID_NO_RETRY_EXPECTED(shutdown(di->fd(), SHUT_RD));
+    } else if (IS_COMMAND(msg.data, kShutdownWriteCommand)) {
+      ASSERT(!di->IsListeningSocket());
+      // Close the socket for writing.
+      VOID_NO_RETRY_EXPECTED(shutdown(di->fd(), SHUT_WR));
+    } else if (IS_COMMAND(msg.data, kCloseCommand)) {
+      // Close the socket and free system resources and move on to next
+      // message.
+      intptr_t old_mask = di->Mask();
+      Dart_Port port = msg.dart_port;
+      if (port != ILLEGAL_PORT) {
+        di->RemovePort(port);
       }
-      DescriptorInfo* di =
-          GetDescriptorInfo(socket->fd(), IS_LISTENING_SOCKET(msg[i].data));
-      if (IS_COMMAND(msg[i].data, kShutdownReadCommand)) {
-        ASSERT(!di->IsListeningSocket());
-        // Close the socket for reading.
-        VOID_NO_RETRY_EXPECTED(shutdown(di->fd(), SHUT_RD));
-      } else if (IS_COMMAND(msg[i].data, kShutdownWriteCommand)) {
-        ASSERT(!di->IsListeningSocket());
-        // Close the socket for writing.
-        VOID_NO_RETRY_EXPECTED(shutdown(di->fd(), SHUT_WR));
-      } else if (IS_COMMAND(msg[i].data, kCloseCommand)) {
-        // Close the socket and free system resources and move on to next
-        // message.
-        intptr_t old_mask = di->Mask();
-        Dart_Port port = msg[i].dart_port;
-        if (port != ILLEGAL_PORT) {
-          di->RemovePort(port);
-        }
-        intptr_t new_mask = di->Mask();
-        UpdateEpollInstance(old_mask, di);
+      intptr_t new_mask = di->Mask();
+      UpdateEpollInstance(old_mask, di);
 
-        intptr_t fd = di->fd();
-        ASSERT(fd == socket->fd());
-        if (di->IsListeningSocket()) {
-          // We only close the socket file descriptor from the operating
-          // system if there are no other dart socket objects which
-          // are listening on the same (address, port) combination.
-          ListeningSocketRegistry* registry =
-              ListeningSocketRegistry::Instance();
-
-          MutexLocker locker(registry->mutex());
-
-          if (registry->CloseSafe(socket)) {
-            ASSERT(new_mask == 0);
-            socket_map_.Remove(GetHashmapKeyFromFd(fd),
-                               GetHashmapHashFromFd(fd));
-            di->Close();
-            delete di;
-          }
-          socket->CloseFd();
-        } else {
+      intptr_t fd = di->fd();
+      ASSERT(fd == socket->fd());
+      if (di->IsListeningSocket()) {
+        // We only close the socket file descriptor from the operating
+        // system if there are no other dart socket objects which
+        // are listening on the same (address, port) combination.
+        ListeningSocketRegistry* registry =
+            ListeningSocketRegistry::Instance();
+
+        MutexLocker locker(registry->mutex());
+
+        if (registry->CloseSafe(socket)) {
           ASSERT(new_mask == 0);
-          socket_map_.Remove(GetHashmapKeyFromFd(fd), GetHashmapHashFromFd(fd));
+          socket_map_.Remove(GetHashmapKeyFromFd(fd),
+                             GetHashmapHashFromFd(fd));
           di->Close();
           delete di;
-          socket->CloseFd();
         }
-        DartUtils::PostInt32(port, 1 << kDestroyedEvent);
-      } else if (IS_COMMAND(msg[i].data, kReturnTokenCommand)) {
-        int count = TOKEN_COUNT(msg[i].data);
-        intptr_t old_mask = di->Mask();
-        di->ReturnTokens(msg[i].dart_port, count);
-        UpdateEpollInstance(old_mask, di);
-      } else if (IS_COMMAND(msg[i].data, kSetEventMaskCommand)) {
-        // `events` can only have kInEvent/kOutEvent flags set.
-        intptr_t events = msg[i].data & EVENT_MASK;
-        ASSERT(0 == (events & ~(1 << kInEvent | 1 << kOutEvent)));
-
-        intptr_t old_mask = di->Mask();
-        di->SetPortAndMask(msg[i].dart_port, msg[i].data & EVENT_MASK);
-        UpdateEpollInstance(old_mask, di);
+        socket->CloseFd();
       } else {
-        UNREACHABLE();
+        ASSERT(new_mask == 0);
+        socket_map_.Remove(GetHashmapKeyFromFd(fd), GetHashmapHashFromFd(fd));
+        di->Close();
+        delete di;
+        socket->CloseFd();
       }
+      DartUtils::PostInt32(port, 1 << kDestroyedEvent);
+    } else if (IS_COMMAND(msg.data, kReturnTokenCommand)) {
+      int count = TOKEN_COUNT(msg.data);
+      intptr_t old_mask = di->Mask();
+      di->ReturnTokens(msg.dart_port, count);
+      UpdateEpollInstance(old_mask, di);
+    } else if (IS_COMMAND(msg.data, kSetEventMaskCommand)) {
+      // `events` can only have kInEvent/kOutEvent flags set.
+      intptr_t events = msg.data & EVENT_MASK;
+      ASSERT(0 == (events & ~(1 << kInEvent | 1 << kOutEvent)));
+
+      intptr_t old_mask = di->Mask();
+      di->SetPortAndMask(msg.dart_port, msg.data & EVENT_MASK);
+      UpdateEpollInstance(old_mask, di);
+    } else {
+      UNREACHABLE();
     }
   }
 }
 
-void EventHandlerImplementation::UpdateTimerFd() {
+void EventHandlerShard::UpdateTimerFd() {
+  const int64_t deadline = timeout_queue_.HasTimeout()
+                               ? timeout_queue_.CurrentTimeout()
+                               : kNoTimeout;
+  // Most updates leave the earliest deadline unchanged.
+  if (deadline == timer_deadline_) {
+    return;
+  }
+  timer_deadline_ = deadline;
   struct itimerspec it;
   memset(&it, 0, sizeof(it));
-  if (timeout_queue_.HasTimeout()) {
-    int64_t millis = timeout_queue_.CurrentTimeout();
-    it.it_value.tv_sec = millis / 1000;
-    it.it_value.tv_nsec = (millis % 1000) * 1000000;
+  if (deadline != kNoTimeout) {
+    it.it_value.tv_sec = deadline / 1000;
+    it.it_value.tv_nsec = (deadline % 1000) * 1000000;
   }
   VOID_NO_RETRY_EXPECTED(
       timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &it, NULL));
@@ -320,8 +337,8 @@ static void PrintEventMask(intptr_t fd, intptr_t events) {
 }
 #endif
 
-intptr_t EventHandlerImplementation::GetPollEvents(intptr_t events,
-                                                   DescriptorInfo* di) {
+intptr_t EventHandlerShard::GetPollEvents(intptr_t events,
+                                          DescriptorInfo* di) {
 #ifdef DEBUG_POLL
   PrintEventMask(di->fd(), events);
 #endif
@@ -342,8 +359,8 @@ intptr_t EventHandlerImplementation::GetPollEvents(intptr_t events,
   return event_mask;
 }
 
-void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
-                                              int size) {
+void EventHandlerShard::HandleEvents(struct epoll_event* events,
+                                     int size) {
   bool interrupt_seen = false;
   for (int i = 0; i < size; i++) {
     if (events[i].data.ptr == NULL) {
@@ -352,6 +369,8 @@ void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
       int64_t val;
       VOID_TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
           read(timer_fd_, &val, sizeof(val)));
+      // The timer is disarmed once it has expired.
+      timer_deadline_ = kNoTimeout;
       if (timeout_queue_.HasTimeout()) {
         DartUtils::PostNull(timeout_queue_.CurrentPort());
         timeout_queue_.RemoveCurrent();
@@ -380,55 +399,112 @@ void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
   }
 }
 
-void EventHandlerImplementation::Poll(uword args) {
+void EventHandlerShard::Poll(uword args) {
   ThreadSignalBlocker signal_blocker(SIGPROF);
   static const intptr_t kMaxEvents = 16;
   struct epoll_event events[kMaxEvents];
-  EventHandler* handler = reinterpret_cast<EventHandler*>(args);
-  EventHandlerImplementation* handler_impl = &handler->delegate_;
-  ASSERT(handler_impl != NULL);
+  EventHandlerShard* shard = reinterpret_cast<EventHandlerShard*>(args);
+  ASSERT(shard != NULL);
 
-  while (!handler_impl->shutdown_) {
+  while (!shard->shutdown_) {
     intptr_t result = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
-        epoll_wait(handler_impl->epoll_fd_, events, kMaxEvents, -1));
+        epoll_wait(shard->epoll_fd_, events, kMaxEvents, -1));
     ASSERT(EAGAIN == EWOULDBLOCK);
     if (result <= 0) {
       if (errno != EWOULDBLOCK) {
         perror("Poll failed");
       }
     } else {
-      handler_impl->HandleEvents(events, result);
+      shard->HandleEvents(events, result);
     }
   }
-  DEBUG_ASSERT(ReferenceCounted<Socket>::instances() == 0);
-  handler->NotifyShutdownDone();
+  shard->owner_->ShardDone();
 }
 
-void EventHandlerImplementation::Start(EventHandler* handler) {
-  int result =
-      Thread::Start("dart:io EventHandler", &EventHandlerImplementation::Poll,
-                    reinterpret_cast<uword>(handler));
+void EventHandlerShard::Start(intptr_t index) {
+  int result = Thread::Start("dart:io EventHandler", &EventHandlerShard::Poll,
+                             reinterpret_cast<uword>(this));
   if (result != 0) {
-    FATAL1("Failed to start event handler thread %d", result);
+    FATAL2("Failed to start event handler thread %" Pd ": %d", index, result);
+  }
+}
+
+EventHandlerImplementation::EventHandlerImplementation()
+    : handler_(NULL),
+      shard_count_(EventHandler::thread_count()),
+      shards_(NULL),
+      running_shards_(0) {
+  ASSERT(shard_count_ >= 1);
+  shards_ = new EventHandlerShard*[shard_count_];
+  for (intptr_t i = 0; i < shard_count_; i++) {
+    shards_[i] = new EventHandlerShard(this);
+  }
+}
+
+EventHandlerImplementation::~EventHandlerImplementation() {
+  for (intptr_t i = 0; i < shard_count_; i++) {
+    delete shards_[i];
+  }
+  delete[] shards_;
+}
+
+EventHandlerShard* EventHandlerImplementation::ShardFor(
+    intptr_t id,
+    Dart_Port dart_port) const {
+  if (shard_count_ == 1) {
+    return shards_[0];
+  }
+  ASSERT(id != kShutdownId);
+  if (id == kTimerId) {
+    return shards_[static_cast<uint64_t>(dart_port) % shard_count_];
+  }
+  // A socket whose descriptor is already closed only needs its reference
+  // released; any shard will do.
+  intptr_t fd = reinterpret_cast<Socket*>(id)->fd();
+  return shards_[(fd < 0) ? 0 : (fd % shard_count_)];
+}
+
+void EventHandlerImplementation::ShardDone() {
+  bool last;
+  {
+    MutexLocker ml(&running_mutex_);
+    ASSERT(running_shards_ > 0);
+    last = (--running_shards_ == 0);
+  }
+  // The event handler may be deleted as soon as the last shard has notified,
+  // so nothing can be touched after that.
+  if (last) {
+    DEBUG_ASSERT(ReferenceCounted<Socket>::instances() == 0);
+    handler_->NotifyShutdownDone();
+  }
+}
+
+void EventHandlerImplementation::Start(EventHandler* handler) {
+  handler_ = handler;
+  running_shards_ = shard_count_;
+  for (intptr_t i = 0; i < shard_count_; i++) {
+    shards_[i]->Start(i);
   }
 }
 
 void EventHandlerImplementation::Shutdown() {
-  SendData(kShutdownId, 0, 0);
+  for (intptr_t i = 0; i < shard_count_; i++) {
+    shards_[i]->SendData(kShutdownId, 0, 0);
+  }
 }
 
 void EventHandlerImplementation::SendData(intptr_t id,
                                           Dart_Port dart_port,
                                           int64_t data) {
-  WakeupHandler(id, dart_port, data);
+  ShardFor(id, dart_port)->SendData(id, dart_port, data);
 }
 
-void* EventHandlerImplementation::GetHashmapKeyFromFd(intptr_t fd) {
+void* EventHandlerShard::GetHashmapKeyFromFd(intptr_t fd) {
   // The hashmap does not support keys with value 0.
   return reinterpret_cast<void*>(fd + 1);
 }
 
-uint32_t EventHandlerImplementation::GetHashmapHashFromFd(intptr_t fd) {
+uint32_t EventHandlerShard::GetHashmapHashFromFd(intptr_t fd) {
   // The hashmap does not support keys with value 0.
   return dart::Utils::WordHash(fd + 1);
 }
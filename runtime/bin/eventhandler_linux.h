@@ -14,6 +14,8 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include "bin/thread.h"
+#include "platform/growable_array.h"
 #include "platform/hashmap.h"
 #include "platform/signal_blocker.h"
 
@@ -58,10 +60,15 @@ class DescriptorInfoMultiple
   DISALLOW_COPY_AND_ASSIGN(DescriptorInfoMultiple);
 };
 
-class EventHandlerImplementation {
+class EventHandlerImplementation;
+
+// One poll thread of the event handler. Each shard owns its own epoll
+// instance, timerfd and timeout queue, and the descriptors and timer ports
+// routed to it by EventHandlerImplementation.
+class EventHandlerShard {
  public:
-  EventHandlerImplementation();
-  ~EventHandlerImplementation();
+  explicit EventHandlerShard(EventHandlerImplementation* owner);
+  ~EventHandlerShard();
 
   void UpdateEpollInstance(intptr_t old_mask, DescriptorInfo* di);
 
@@ -69,26 +76,68 @@ class EventHandlerImplementation {
   // descriptor. Creates a new one if one is not found.
   DescriptorInfo* GetDescriptorInfo(intptr_t fd, bool is_listening);
   void SendData(intptr_t id, Dart_Port dart_port, int64_t data);
-  void Start(EventHandler* handler);
-  void Shutdown();
+  void Start(intptr_t index);
 
  private:
   void HandleEvents(struct epoll_event* events, int size);
   static void Poll(uword args);
-  void WakeupHandler(intptr_t id, Dart_Port dart_port, int64_t data);
   void HandleInterruptFd();
+  void HandleInterruptMessage(const InterruptMessage& msg);
   void UpdateTimerFd();
-  void SetPort(intptr_t fd, Dart_Port dart_port, intptr_t mask);
   intptr_t GetPollEvents(intptr_t events, DescriptorInfo* di);
   static void* GetHashmapKeyFromFd(intptr_t fd);
   static uint32_t GetHashmapHashFromFd(intptr_t fd);
 
+  EventHandlerImplementation* owner_;
   SimpleHashMap socket_map_;
   TimeoutQueue timeout_queue_;
   bool shutdown_;
-  int interrupt_fds_[2];
+
+  // Messages sent with SendData and not yet handled by the poll thread.
+  // [interrupt_fd_] is an eventfd that is signalled only when [messages_]
+  // goes from empty to non-empty, so a burst of messages costs one wakeup.
+  Mutex messages_mutex_;
+  MallocGrowableArray<InterruptMessage> messages_;
+  // Only touched by the poll thread; reused across wakeups.
+  MallocGrowableArray<InterruptMessage> pending_;
+  int interrupt_fd_;
   int epoll_fd_;
   int timer_fd_;
+  // The deadline [timer_fd_] is armed for, or kNoTimeout if disarmed.
+  int64_t timer_deadline_ = kNoTimeout;
+
+  static const int64_t kNoTimeout = -1;
+
+  DISALLOW_COPY_AND_ASSIGN(EventHandlerShard);
+};
+
+class EventHandlerImplementation {
+ public:
+  EventHandlerImplementation();
+  ~EventHandlerImplementation();
+
+  void SendData(intptr_t id, Dart_Port dart_port, int64_t data);
+  void Start(EventHandler* handler);
+  void Shutdown();
+
+ private:
+  friend class EventHandlerShard;
+
+  // Commands for a socket always go to the shard owning its file
+  // descriptor, so listening sockets shared between isolates and a
+  // descriptor reused after close stay on a single poll thread. Timer
+  // updates are routed by port so that every update of a timer reaches the
+  // same timeout queue.
+  EventHandlerShard* ShardFor(intptr_t id, Dart_Port dart_port) const;
+
+  // Called by each shard's poll thread once it has shut down.
+  void ShardDone();
+
+  EventHandler* handler_;
+  intptr_t shard_count_;
+  EventHandlerShard** shards_;
+  Mutex running_mutex_;
+  intptr_t running_shards_;
 
   DISALLOW_COPY_AND_ASSIGN(EventHandlerImplementation);
 };
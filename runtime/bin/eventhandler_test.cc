@@ -79,5 +79,40 @@ VM_UNIT_TEST_CASE(CircularLinkedList) {
   list.Remove(4242);
 }
 
+VM_UNIT_TEST_CASE(TimeoutQueue) {
+  TimeoutQueue queue;
+  EXPECT(!queue.HasTimeout());
+
+  // Test: The earliest timeout is current, regardless of insertion order.
+  for (intptr_t i = 1; i <= 100; i++) {
+    queue.UpdateTimeout(i, 1000 + ((i * 37) % 100));
+  }
+  EXPECT(queue.HasTimeout());
+  EXPECT_EQ(1000, queue.CurrentTimeout());
+  EXPECT_EQ(100, queue.CurrentPort());
+
+  // Test: Moving a timeout earlier or later reorders the queue.
+  queue.UpdateTimeout(50, 10);
+  EXPECT_EQ(50, queue.CurrentPort());
+  queue.UpdateTimeout(50, 5000);
+  EXPECT_EQ(100, queue.CurrentPort());
+
+  // Test: Removing an unknown port leaves the queue unchanged.
+  queue.UpdateTimeout(4242, -1);
+  EXPECT_EQ(100, queue.CurrentPort());
+
+  // Test: Removing current timeouts yields them in increasing order.
+  int64_t last = -1;
+  intptr_t count = 0;
+  while (queue.HasTimeout()) {
+    EXPECT(queue.CurrentTimeout() >= last);
+    last = queue.CurrentTimeout();
+    queue.RemoveCurrent();
+    count++;
+  }
+  EXPECT_EQ(100, count);
+  EXPECT_EQ(5000, last);
+}
+
 }  // namespace bin
 }  // namespace dart
@@ -22,6 +22,17 @@ namespace bin {
 
 static const int kFileNativeFieldIndex = 0;
 
+// Reads this large are typically whole-file reads, e.g. from
+// File.readAsBytes, which benefit from a larger readahead window.
+static const int64_t kSequentialReadThreshold = 1 * MB;
+
+static void AdviseIfLargeRead(File* file, int64_t length) {
+  if (length >= kSequentialReadThreshold) {
+    // The hint is best effort; the read proceeds either way.
+    file->AdviseSequential();
+  }
+}
+
 #if !defined(PRODUCT)
 static bool IsFile(Dart_Handle file_obj) {
   Dart_Handle file_type = ThrowIfError(
@@ -145,6 +156,9 @@ void FUNCTION_NAME(File_Close)(Dart_NativeArguments args) {
     Dart_SetIntegerReturnValue(args, -1);
     return;
   }
+  if (StdioBuffer::IsBuffered(file)) {
+    StdioBuffer::Flush();
+  }
   file->Close();
   file->DeleteFinalizableHandle(Dart_CurrentIsolate(), dart_this);
   file->Release();
@@ -202,6 +216,7 @@ void FUNCTION_NAME(File_Read)(Dart_NativeArguments args) {
     Dart_SetReturnValue(args, DartUtils::NewDartOSError());
     return;
   }
+  AdviseIfLargeRead(file, length);
   int64_t bytes_read = file->Read(reinterpret_cast<void*>(buffer), length);
   if (bytes_read < 0) {
     Dart_SetReturnValue(args, DartUtils::NewDartOSError());
@@ -284,7 +299,9 @@ void FUNCTION_NAME(File_WriteFrom)(Dart_NativeArguments args) {
 
   // Write all the data out into the file.
   char* byte_buffer = reinterpret_cast<char*>(buffer);
-  bool success = file->WriteFully(byte_buffer + start, length);
+  bool success = StdioBuffer::IsBuffered(file)
+                     ? StdioBuffer::Write(file, byte_buffer + start, length)
+                     : file->WriteFully(byte_buffer + start, length);
 
   // Release the direct pointer acquired above.
   ThrowIfError(Dart_TypedDataReleaseData(buffer_obj));
@@ -1241,6 +1258,7 @@ CObject* File::ReadRequest(const CObjectArray& request) {
     return CObject::NewOSError();
   }
   uint8_t* data = io_buffer->value.as_external_typed_data.data;
+  AdviseIfLargeRead(file, length);
   const int64_t bytes_read = file->Read(data, length);
   if (bytes_read < 0) {
     CObject::FreeIOBufferData(io_buffer);
@@ -20,8 +20,9 @@
 namespace dart {
 namespace bin {
 
-// Forward declaration.
+// Forward declarations.
 class FileHandle;
+class Monitor;
 
 class MappedMemory {
  public:
@@ -141,6 +142,11 @@ class File : public ReferenceCounted<File> {
   int64_t Read(void* buffer, int64_t num_bytes);
   int64_t Write(const void* buffer, int64_t num_bytes);
 
+  // Hints that the file is about to be read sequentially, so the OS can use
+  // a larger readahead window. Best effort: returns false if the hint was
+  // rejected, and true where hints are not supported.
+  bool AdviseSequential();
+
   // ReadFully and WriteFully do attempt to transfer num_bytes to/from
   // the buffer. In the event of short accesses they will loop internally until
   // the whole buffer has been transferred or an error occurs. If an error
@@ -341,6 +347,51 @@ class File : public ReferenceCounted<File> {
   DISALLOW_COPY_AND_ASSIGN(File);
 };
 
+// Coalesces writes to stdout and stderr made from Dart, which otherwise
+// cost one write call each. This is off unless the embedder enables it.
+// Buffered data is written out when the buffer fills, before writing to a
+// different stdio handle (so stdout and stderr output stays in order), at
+// each newline when the handle is a terminal, before printing or reading
+// stdin, when the handle is closed, kFlushIntervalMillis after it was
+// buffered, and on exit.
+class StdioBuffer {
+ public:
+  static void Init();
+  static void Cleanup();
+
+  static bool enabled() { return enabled_; }
+  static void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  // Whether writes to file should go through Write.
+  static bool IsBuffered(File* file);
+
+  // Buffers the data, or writes it out with File::WriteFully. Returns false
+  // if writing out failed. Errors of the periodic flush are dropped.
+  static bool Write(File* file, const void* buffer, int64_t num_bytes);
+
+  // Writes out all buffered data.
+  static bool Flush();
+
+ private:
+  static const intptr_t kBufferSize = 64 * KB;
+  static const int64_t kFlushIntervalMillis = 20;
+
+  static bool FlushLocked();
+  static void FlusherEntry(uword param);
+
+  static bool enabled_;
+  static Monitor* monitor_;
+  static File* file_;
+  static bool line_buffered_;
+  static uint8_t buffer_[kBufferSize];
+  static intptr_t length_;
+  static bool flusher_running_;
+  static bool shutdown_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(StdioBuffer);
+};
+
 class UriDecoder {
  public:
   explicit UriDecoder(const char* uri);
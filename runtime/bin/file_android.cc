@@ -119,6 +119,12 @@ int64_t File::Write(const void* buffer, int64_t num_bytes) {
   return TEMP_FAILURE_RETRY(write(handle_->fd(), buffer, num_bytes));
 }
 
+bool File::AdviseSequential() {
+  ASSERT(handle_->fd() >= 0);
+  // posix_fadvise returns the error rather than setting errno.
+  return posix_fadvise(handle_->fd(), 0, 0, POSIX_FADV_SEQUENTIAL) == 0;
+}
+
 bool File::VPrint(const char* format, va_list args) {
   // Measure.
   va_list measure_args;
@@ -121,6 +121,11 @@ int64_t File::Write(const void* buffer, int64_t num_bytes) {
   return NO_RETRY_EXPECTED(write(handle_->fd(), buffer, num_bytes));
 }
 
+bool File::AdviseSequential() {
+  ASSERT(handle_->fd() >= 0);
+  return true;
+}
+
 bool File::VPrint(const char* format, va_list args) {
   // Measure.
   va_list measure_args;
@@ -166,6 +166,11 @@ int64_t File::Write(const void* buffer, int64_t num_bytes) {
   return TEMP_FAILURE_RETRY(write(handle_->fd(), buffer, num_bytes));
 }
 
+bool File::AdviseSequential() {
+  ASSERT(handle_->fd() >= 0);
+  return NO_RETRY_EXPECTED(fcntl(handle_->fd(), F_RDAHEAD, 1)) != -1;
+}
+
 bool File::VPrint(const char* format, va_list args) {
   // Measure.
   va_list measure_args;
@@ -7,6 +7,8 @@
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
 #include "bin/io_buffer.h"
+#include "bin/lockers.h"
+#include "bin/thread.h"
 #include "bin/utils.h"
 
 #include "include/bin/dart_io_api.h"
@@ -84,6 +86,126 @@ bool File::WriteFully(const void* buffer, int64_t num_bytes) {
   return true;
 }
 
+bool StdioBuffer::enabled_ = false;
+Monitor* StdioBuffer::monitor_ = nullptr;
+File* StdioBuffer::file_ = NULL;
+bool StdioBuffer::line_buffered_ = false;
+uint8_t StdioBuffer::buffer_[StdioBuffer::kBufferSize];
+intptr_t StdioBuffer::length_ = 0;
+bool StdioBuffer::flusher_running_ = false;
+bool StdioBuffer::shutdown_ = false;
+
+void StdioBuffer::Init() {
+  ASSERT(monitor_ == nullptr);
+  monitor_ = new Monitor();
+  shutdown_ = false;
+}
+
+void StdioBuffer::Cleanup() {
+  ASSERT(monitor_ != nullptr);
+  {
+    MonitorLocker ml(monitor_);
+    FlushLocked();
+    shutdown_ = true;
+    ml.NotifyAll();
+    while (flusher_running_) {
+      ml.Wait(Monitor::kNoTimeout);
+    }
+    if (file_ != NULL) {
+      file_->Release();
+      file_ = NULL;
+    }
+  }
+  delete monitor_;
+  monitor_ = nullptr;
+}
+
+bool StdioBuffer::IsBuffered(File* file) {
+  if (!enabled_ || (monitor_ == nullptr)) {
+    return false;
+  }
+  // Service events for captured output must be sent from the isolate.
+  if (capture_stdout || capture_stderr) {
+    return false;
+  }
+  const intptr_t fd = file->GetFD();
+  return (fd == STDOUT_FILENO) || (fd == STDERR_FILENO);
+}
+
+bool StdioBuffer::Write(File* file, const void* buffer, int64_t num_bytes) {
+  MonitorLocker ml(monitor_);
+  if (file != file_) {
+    if (!FlushLocked()) {
+      return false;
+    }
+    if (file_ != NULL) {
+      file_->Release();
+    }
+    file->Retain();
+    file_ = file;
+    line_buffered_ = File::GetStdioHandleType(static_cast<int>(
+                         file->GetFD())) == File::kTerminal;
+  }
+  if (length_ + num_bytes > kBufferSize) {
+    if (!FlushLocked()) {
+      return false;
+    }
+    if (num_bytes >= kBufferSize) {
+      return file_->WriteFully(buffer, num_bytes);
+    }
+  }
+  const bool was_empty = (length_ == 0);
+  memmove(buffer_ + length_, buffer, num_bytes);
+  length_ += num_bytes;
+  if (line_buffered_ &&
+      (memchr(buffer, '\n', static_cast<size_t>(num_bytes)) != NULL)) {
+    return FlushLocked();
+  }
+  if (was_empty) {
+    if (!flusher_running_) {
+      if (Thread::Start("dart:io StdioBuffer", FlusherEntry, 0) != 0) {
+        // Without the flusher nothing would write out idle output.
+        return FlushLocked();
+      }
+      flusher_running_ = true;
+    }
+    ml.NotifyAll();
+  }
+  return true;
+}
+
+bool StdioBuffer::Flush() {
+  if (monitor_ == nullptr) {
+    return true;
+  }
+  MonitorLocker ml(monitor_);
+  return FlushLocked();
+}
+
+bool StdioBuffer::FlushLocked() {
+  if (length_ == 0) {
+    return true;
+  }
+  ASSERT(file_ != NULL);
+  const intptr_t length = length_;
+  length_ = 0;
+  return file_->WriteFully(buffer_, length);
+}
+
+void StdioBuffer::FlusherEntry(uword param) {
+  MonitorLocker ml(monitor_);
+  while (!shutdown_) {
+    if (length_ == 0) {
+      ml.Wait(Monitor::kNoTimeout);
+      continue;
+    }
+    ml.Wait(kFlushIntervalMillis);
+    FlushLocked();
+  }
+  flusher_running_ = false;
+  ml.NotifyAll();
+}
+
 File::FileOpenMode File::DartModeToFileMode(DartFileOpenMode mode) {
   ASSERT((mode == File::kDartRead) || (mode == File::kDartWrite) ||
          (mode == File::kDartAppend) || (mode == File::kDartWriteOnly) ||
@@ -100,11 +100,34 @@ static int InotifyEventToMask(struct inotify_event* e) {
   return mask;
 }
 
+// Whether e only repeats the previous event for the same file. Writing a
+// file produces a run of IN_MODIFY events followed by IN_CLOSE_WRITE, which
+// the kernel does not merge but which all map to the same Dart event.
+static bool IsRepeatedEvent(struct inotify_event* e,
+                            int mask,
+                            struct inotify_event* previous,
+                            int previous_mask) {
+  const int kRepeatableMask = FileSystemWatcher::kModifyContent |
+                              FileSystemWatcher::kModifyAttribute |
+                              FileSystemWatcher::kIsDir;
+  if ((previous == NULL) || (mask != previous_mask) ||
+      ((mask & ~kRepeatableMask) != 0) || (e->cookie != 0) ||
+      (e->wd != previous->wd)) {
+    return false;
+  }
+  if ((e->len == 0) || (previous->len == 0)) {
+    return e->len == previous->len;
+  }
+  return strcmp(e->name, previous->name) == 0;
+}
+
 Dart_Handle FileSystemWatcher::ReadEvents(intptr_t id, intptr_t path_id) {
   USE(path_id);
   const intptr_t kEventSize = sizeof(struct inotify_event);
-  const intptr_t kBufferSize = kEventSize + NAME_MAX + 1;
-  uint8_t buffer[kBufferSize];
+  // Room for many events, so that a burst of changes such as a checkout is
+  // read with few calls.
+  const intptr_t kBufferSize = 64 * (kEventSize + NAME_MAX + 1);
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(Dart_ScopeAllocate(kBufferSize));
   intptr_t bytes =
       SocketBase::Read(id, buffer, kBufferSize, SocketBase::kAsync);
   if (bytes < 0) {
@@ -114,30 +137,38 @@ Dart_Handle FileSystemWatcher::ReadEvents(intptr_t id, intptr_t path_id) {
   Dart_Handle events = Dart_NewList(kMaxCount);
   intptr_t offset = 0;
   intptr_t i = 0;
+  struct inotify_event* previous = NULL;
+  int previous_mask = 0;
   while (offset < bytes) {
     struct inotify_event* e =
         reinterpret_cast<struct inotify_event*>(buffer + offset);
-    if ((e->mask & IN_IGNORED) == 0) {
-      Dart_Handle event = Dart_NewList(5);
-      int mask = InotifyEventToMask(e);
-      Dart_ListSetAt(event, 0, Dart_NewInteger(mask));
-      Dart_ListSetAt(event, 1, Dart_NewInteger(e->cookie));
-      if (e->len > 0) {
-        Dart_Handle name = Dart_NewStringFromUTF8(
-            reinterpret_cast<uint8_t*>(e->name), strlen(e->name));
-        if (Dart_IsError(name)) {
-          return name;
-        }
-        Dart_ListSetAt(event, 2, name);
-      } else {
-        Dart_ListSetAt(event, 2, Dart_Null());
+    offset += kEventSize + e->len;
+    if ((e->mask & IN_IGNORED) != 0) {
+      continue;
+    }
+    int mask = InotifyEventToMask(e);
+    if (IsRepeatedEvent(e, mask, previous, previous_mask)) {
+      continue;
+    }
+    previous = e;
+    previous_mask = mask;
+    Dart_Handle event = Dart_NewList(5);
+    Dart_ListSetAt(event, 0, Dart_NewInteger(mask));
+    Dart_ListSetAt(event, 1, Dart_NewInteger(e->cookie));
+    if (e->len > 0) {
+      Dart_Handle name = Dart_NewStringFromUTF8(
+          reinterpret_cast<uint8_t*>(e->name), strlen(e->name));
+      if (Dart_IsError(name)) {
+        return name;
       }
-      Dart_ListSetAt(event, 3, Dart_NewBoolean((e->mask & IN_MOVED_TO) != 0u));
-      Dart_ListSetAt(event, 4, Dart_NewInteger(e->wd));
-      Dart_ListSetAt(events, i, event);
-      i++;
+      Dart_ListSetAt(event, 2, name);
+    } else {
+      Dart_ListSetAt(event, 2, Dart_Null());
     }
-    offset += kEventSize + e->len;
+    Dart_ListSetAt(event, 3, Dart_NewBoolean((e->mask & IN_MOVED_TO) != 0u));
+    Dart_ListSetAt(event, 4, Dart_NewInteger(e->wd));
+    Dart_ListSetAt(events, i, event);
+    i++;
   }
   ASSERT(offset == bytes);
   return events;
@@ -35,6 +35,26 @@ TEST_CASE(Read) {
   file->Release();
 }
 
+TEST_CASE(MapFile) {
+  const char* kFilename = GetFileName("runtime/bin/file_test.cc");
+  void* file = bin::DartUtils::OpenFile(kFilename, false);
+  EXPECT(file != NULL);
+  uint8_t* mapped = nullptr;
+  intptr_t mapped_length = -1;
+  bin::DartUtils::MapFile(&mapped, &mapped_length, file);
+  uint8_t* read = nullptr;
+  intptr_t read_length = -1;
+  bin::DartUtils::ReadFile(&read, &read_length, file);
+  bin::DartUtils::CloseFile(file);
+  EXPECT(mapped != NULL);
+  EXPECT(read != NULL);
+  EXPECT_EQ(read_length, mapped_length);
+  EXPECT_EQ(0, memcmp(read, mapped, read_length));
+  // Both mapped and malloc'd data are released with FreeFileData.
+  bin::DartUtils::FreeFileData(mapped);
+  bin::DartUtils::FreeFileData(read);
+}
+
 TEST_CASE(OpenUri_RelativeFilename) {
   const char* kFilename = GetFileName("runtime/bin/file_test.cc");
   char* encoded = reinterpret_cast<char*>(bin::DartUtils::ScopedCString(
@@ -183,6 +183,11 @@ int64_t File::Write(const void* buffer, int64_t num_bytes) {
   return bytes_written;
 }
 
+bool File::AdviseSequential() {
+  ASSERT(handle_->fd() >= 0);
+  return true;
+}
+
 bool File::VPrint(const char* format, va_list args) {
   // Measure.
   va_list measure_args;
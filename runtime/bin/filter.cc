@@ -6,6 +6,7 @@
 
 #include "bin/dartutils.h"
 #include "bin/io_buffer.h"
+#include "bin/lockers.h"
 
 #include "include/dart_api.h"
 
@@ -237,22 +238,30 @@ void FUNCTION_NAME(Filter_Processed)(Dart_NativeArguments args) {
     Dart_PropagateError(err);
   }
 
-  intptr_t read = filter->Processed(
-      filter->processed_buffer(), filter->processed_buffer_size(), flush, end);
+  // Let the filter write straight into the storage of the result, and
+  // shrink it to the number of bytes produced.
+  uint8_t* buffer = IOBuffer::Allocate(Filter::kFilterBufferSize);
+  if (buffer == NULL) {
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+    return;
+  }
+  intptr_t read =
+      filter->Processed(buffer, Filter::kFilterBufferSize, flush, end);
   if (read < 0) {
+    IOBuffer::Free(buffer);
     Dart_ThrowException(
         DartUtils::NewDartFormatException("Filter error, bad data"));
   } else if (read == 0) {
+    IOBuffer::Free(buffer);
     Dart_SetReturnValue(args, Dart_Null());
   } else {
-    uint8_t* io_buffer;
-    Dart_Handle result = IOBuffer::Allocate(read, &io_buffer);
-    if (Dart_IsNull(result)) {
-      Dart_SetReturnValue(args, DartUtils::NewDartOSError());
-      return;
+    if (read < Filter::kFilterBufferSize) {
+      uint8_t* new_buffer = IOBuffer::Reallocate(buffer, read);
+      if (new_buffer != NULL) {
+        buffer = new_buffer;
+      }
     }
-    memmove(io_buffer, filter->processed_buffer(), read);
-    Dart_SetReturnValue(args, result);
+    Dart_SetReturnValue(args, IOBuffer::Wrap(buffer, read));
   }
 }
 
@@ -282,11 +291,116 @@ Dart_Handle Filter::GetFilterNativeField(Dart_Handle filter,
       reinterpret_cast<intptr_t*>(filter_pointer));
 }
 
+ZLibStreamCache::Entry ZLibStreamCache::entries_[kMaxEntries];
+intptr_t ZLibStreamCache::length_ = 0;
+Mutex* ZLibStreamCache::mutex_ = nullptr;
+
+void ZLibStreamCache::Init() {
+  ASSERT(mutex_ == nullptr);
+  mutex_ = new Mutex();
+}
+
+void ZLibStreamCache::Cleanup() {
+  ASSERT(mutex_ != nullptr);
+  // Filters are finalized by Dart_Cleanup, before this runs.
+  for (intptr_t i = 0; i < length_; i++) {
+    if (entries_[i].is_deflate) {
+      deflateEnd(entries_[i].stream);
+    } else {
+      inflateEnd(entries_[i].stream);
+    }
+    delete entries_[i].stream;
+  }
+  length_ = 0;
+  delete mutex_;
+  mutex_ = nullptr;
+}
+
+z_stream* ZLibStreamCache::TakeDeflate(int32_t level,
+                                       int32_t window_bits,
+                                       int32_t mem_level,
+                                       int32_t strategy) {
+  return Take(true, level, window_bits, mem_level, strategy);
+}
+
+z_stream* ZLibStreamCache::TakeInflate(int32_t window_bits) {
+  return Take(false, 0, window_bits, 0, 0);
+}
+
+void ZLibStreamCache::ReturnDeflate(z_stream* stream,
+                                    int32_t level,
+                                    int32_t window_bits,
+                                    int32_t mem_level,
+                                    int32_t strategy) {
+  if ((deflateReset(stream) != Z_OK) ||
+      !Put(stream, true, level, window_bits, mem_level, strategy)) {
+    deflateEnd(stream);
+    delete stream;
+  }
+}
+
+void ZLibStreamCache::ReturnInflate(z_stream* stream, int32_t window_bits) {
+  if ((inflateReset(stream) != Z_OK) ||
+      !Put(stream, false, 0, window_bits, 0, 0)) {
+    inflateEnd(stream);
+    delete stream;
+  }
+}
+
+z_stream* ZLibStreamCache::Take(bool is_deflate,
+                                int32_t level,
+                                int32_t window_bits,
+                                int32_t mem_level,
+                                int32_t strategy) {
+  if (mutex_ == nullptr) {
+    // Embedders that do not bootstrap dart:io run without the cache.
+    return NULL;
+  }
+  MutexLocker ml(mutex_);
+  for (intptr_t i = length_ - 1; i >= 0; i--) {
+    const Entry& entry = entries_[i];
+    if ((entry.is_deflate == is_deflate) && (entry.level == level) &&
+        (entry.window_bits == window_bits) &&
+        (entry.mem_level == mem_level) && (entry.strategy == strategy)) {
+      z_stream* stream = entry.stream;
+      entries_[i] = entries_[--length_];
+      return stream;
+    }
+  }
+  return NULL;
+}
+
+bool ZLibStreamCache::Put(z_stream* stream,
+                          bool is_deflate,
+                          int32_t level,
+                          int32_t window_bits,
+                          int32_t mem_level,
+                          int32_t strategy) {
+  if (mutex_ == nullptr) {
+    return false;
+  }
+  MutexLocker ml(mutex_);
+  if (length_ == kMaxEntries) {
+    return false;
+  }
+  Entry* entry = &entries_[length_++];
+  entry->stream = stream;
+  entry->is_deflate = is_deflate;
+  entry->level = level;
+  entry->window_bits = window_bits;
+  entry->mem_level = mem_level;
+  entry->strategy = strategy;
+  return true;
+}
+
 ZLibDeflateFilter::~ZLibDeflateFilter() {
   delete[] dictionary_;
   delete[] current_buffer_;
   if (initialized()) {
-    deflateEnd(&stream_);
+    ZLibStreamCache::ReturnDeflate(stream_, level_, stream_window_bits_,
+                                   mem_level_, strategy_);
+  } else {
+    delete stream_;
   }
 }
 
@@ -307,24 +421,30 @@ bool ZLibDeflateFilter::Init() {
   } else if (gzip_) {
     window_bits += kZLibFlagUseGZipHeader;
   }
-  stream_.next_in = Z_NULL;
-  stream_.zalloc = Z_NULL;
-  stream_.zfree = Z_NULL;
-  stream_.opaque = Z_NULL;
-  int result = deflateInit2(&stream_, level_, Z_DEFLATED, window_bits,
-                            mem_level_, strategy_);
-  if (result != Z_OK) {
-    return false;
+  stream_window_bits_ = window_bits;
+  stream_ = ZLibStreamCache::TakeDeflate(level_, window_bits, mem_level_,
+                                         strategy_);
+  if (stream_ == NULL) {
+    stream_ = new z_stream();
+    stream_->next_in = Z_NULL;
+    stream_->zalloc = Z_NULL;
+    stream_->zfree = Z_NULL;
+    stream_->opaque = Z_NULL;
+    int result = deflateInit2(stream_, level_, Z_DEFLATED, window_bits,
+                              mem_level_, strategy_);
+    if (result != Z_OK) {
+      return false;
+    }
   }
+  set_initialized(true);
   if ((dictionary_ != NULL) && !gzip_ && !raw_) {
-    result = deflateSetDictionary(&stream_, dictionary_, dictionary_length_);
+    int result = deflateSetDictionary(stream_, dictionary_, dictionary_length_);
     delete[] dictionary_;
     dictionary_ = NULL;
     if (result != Z_OK) {
       return false;
     }
   }
-  set_initialized(true);
   return true;
 }
 
@@ -332,8 +452,8 @@ bool ZLibDeflateFilter::Process(uint8_t* data, intptr_t length) {
   if (current_buffer_ != NULL) {
     return false;
   }
-  stream_.avail_in = length;
-  stream_.next_in = current_buffer_ = data;
+  stream_->avail_in = length;
+  stream_->next_in = current_buffer_ = data;
   return true;
 }
 
@@ -341,15 +461,15 @@ intptr_t ZLibDeflateFilter::Processed(uint8_t* buffer,
                                       intptr_t length,
                                       bool flush,
                                       bool end) {
-  stream_.avail_out = length;
-  stream_.next_out = buffer;
+  stream_->avail_out = length;
+  stream_->next_out = buffer;
   bool error = false;
   switch (
-      deflate(&stream_, end ? Z_FINISH : flush ? Z_SYNC_FLUSH : Z_NO_FLUSH)) {
+      deflate(stream_, end ? Z_FINISH : flush ? Z_SYNC_FLUSH : Z_NO_FLUSH)) {
     case Z_STREAM_END:
     case Z_BUF_ERROR:
     case Z_OK: {
-      intptr_t processed = length - stream_.avail_out;
+      intptr_t processed = length - stream_->avail_out;
       if (processed == 0) {
         break;
       }
@@ -371,7 +491,9 @@ ZLibInflateFilter::~ZLibInflateFilter() {
   delete[] dictionary_;
   delete[] current_buffer_;
   if (initialized()) {
-    inflateEnd(&stream_);
+    ZLibStreamCache::ReturnInflate(stream_, stream_window_bits_);
+  } else {
+    delete stream_;
   }
 }
 
@@ -379,14 +501,19 @@ bool ZLibInflateFilter::Init() {
   int window_bits =
       raw_ ? -window_bits_ : window_bits_ | kZLibFlagAcceptAnyHeader;
 
-  stream_.next_in = Z_NULL;
-  stream_.avail_in = 0;
-  stream_.zalloc = Z_NULL;
-  stream_.zfree = Z_NULL;
-  stream_.opaque = Z_NULL;
-  int result = inflateInit2(&stream_, window_bits);
-  if (result != Z_OK) {
-    return false;
+  stream_window_bits_ = window_bits;
+  stream_ = ZLibStreamCache::TakeInflate(window_bits);
+  if (stream_ == NULL) {
+    stream_ = new z_stream();
+    stream_->next_in = Z_NULL;
+    stream_->avail_in = 0;
+    stream_->zalloc = Z_NULL;
+    stream_->zfree = Z_NULL;
+    stream_->opaque = Z_NULL;
+    int result = inflateInit2(stream_, window_bits);
+    if (result != Z_OK) {
+      return false;
+    }
   }
   set_initialized(true);
   return true;
@@ -396,8 +523,8 @@ bool ZLibInflateFilter::Process(uint8_t* data, intptr_t length) {
   if (current_buffer_ != NULL) {
     return false;
   }
-  stream_.avail_in = length;
-  stream_.next_in = current_buffer_ = data;
+  stream_->avail_in = length;
+  stream_->next_in = current_buffer_ = data;
   return true;
 }
 
@@ -405,16 +532,16 @@ intptr_t ZLibInflateFilter::Processed(uint8_t* buffer,
                                       intptr_t length,
                                       bool flush,
                                       bool end) {
-  stream_.avail_out = length;
-  stream_.next_out = buffer;
+  stream_->avail_out = length;
+  stream_->next_out = buffer;
   bool error = false;
   int v;
-  switch (v = inflate(&stream_,
+  switch (v = inflate(stream_,
                       end ? Z_FINISH : flush ? Z_SYNC_FLUSH : Z_NO_FLUSH)) {
     case Z_STREAM_END:
     case Z_BUF_ERROR:
     case Z_OK: {
-      intptr_t processed = length - stream_.avail_out;
+      intptr_t processed = length - stream_->avail_out;
       if (processed == 0) {
         break;
       }
@@ -426,7 +553,7 @@ intptr_t ZLibInflateFilter::Processed(uint8_t* buffer,
         error = true;
       } else {
         int result =
-            inflateSetDictionary(&stream_, dictionary_, dictionary_length_);
+            inflateSetDictionary(stream_, dictionary_, dictionary_length_);
         delete[] dictionary_;
         dictionary_ = NULL;
         error = result != Z_OK;
@@ -6,6 +6,7 @@
 #define RUNTIME_BIN_FILTER_H_
 
 #include "bin/builtin.h"
+#include "bin/thread.h"
 #include "bin/utils.h"
 
 #include "zlib/zlib.h"
@@ -38,20 +39,77 @@ class Filter {
 
   bool initialized() const { return initialized_; }
   void set_initialized(bool value) { initialized_ = value; }
-  uint8_t* processed_buffer() { return processed_buffer_; }
-  intptr_t processed_buffer_size() const { return kFilterBufferSize; }
+
+  // Size of the buffer the output of each call to Processed is written to.
+  static const intptr_t kFilterBufferSize = 64 * KB;
 
  protected:
   Filter() : initialized_(false) {}
 
  private:
-  static const intptr_t kFilterBufferSize = 64 * KB;
-  uint8_t processed_buffer_[kFilterBufferSize];
   bool initialized_;
 
   DISALLOW_COPY_AND_ASSIGN(Filter);
 };
 
+// A small process-wide cache of initialized zlib streams. Setting up a
+// stream allocates and clears the window and hash tables, which dominates
+// the cost of compressing or decompressing short inputs such as HTTP
+// responses. Streams of finished filters are reset and kept here instead,
+// keyed by the parameters they were initialized with.
+class ZLibStreamCache {
+ public:
+  static void Init();
+  static void Cleanup();
+
+  // Return a stream initialized with the given parameters and in its
+  // initial state, or NULL if none is cached.
+  static z_stream* TakeDeflate(int32_t level,
+                               int32_t window_bits,
+                               int32_t mem_level,
+                               int32_t strategy);
+  static z_stream* TakeInflate(int32_t window_bits);
+
+  // Reset the stream and cache it, or end and free it if it cannot be reset
+  // or the cache is full.
+  static void ReturnDeflate(z_stream* stream,
+                            int32_t level,
+                            int32_t window_bits,
+                            int32_t mem_level,
+                            int32_t strategy);
+  static void ReturnInflate(z_stream* stream, int32_t window_bits);
+
+ private:
+  struct Entry {
+    z_stream* stream;
+    bool is_deflate;
+    int32_t level;
+    int32_t window_bits;
+    int32_t mem_level;
+    int32_t strategy;
+  };
+
+  static z_stream* Take(bool is_deflate,
+                        int32_t level,
+                        int32_t window_bits,
+                        int32_t mem_level,
+                        int32_t strategy);
+  static bool Put(z_stream* stream,
+                  bool is_deflate,
+                  int32_t level,
+                  int32_t window_bits,
+                  int32_t mem_level,
+                  int32_t strategy);
+
+  static const intptr_t kMaxEntries = 8;
+  static Entry entries_[kMaxEntries];
+  static intptr_t length_;
+  static Mutex* mutex_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(ZLibStreamCache);
+};
+
 class ZLibDeflateFilter : public Filter {
  public:
   ZLibDeflateFilter(bool gzip,
@@ -70,7 +128,9 @@ class ZLibDeflateFilter : public Filter {
         dictionary_(dictionary),
         dictionary_length_(dictionary_length),
         raw_(raw),
-        current_buffer_(NULL) {}
+        current_buffer_(NULL),
+        stream_(NULL),
+        stream_window_bits_(0) {}
   virtual ~ZLibDeflateFilter();
 
   virtual bool Init();
@@ -90,7 +150,11 @@ class ZLibDeflateFilter : public Filter {
   const intptr_t dictionary_length_;
   const bool raw_;
   uint8_t* current_buffer_;
-  z_stream stream_;
+  // Heap allocated so it can outlive the filter in ZLibStreamCache; zlib's
+  // internal state points back at the z_stream, so it cannot be copied.
+  z_stream* stream_;
+  // Window bits as passed to deflateInit2.
+  int32_t stream_window_bits_;
 
   DISALLOW_COPY_AND_ASSIGN(ZLibDeflateFilter);
 };
@@ -105,7 +169,9 @@ class ZLibInflateFilter : public Filter {
         dictionary_(dictionary),
         dictionary_length_(dictionary_length),
         raw_(raw),
-        current_buffer_(NULL) {}
+        current_buffer_(NULL),
+        stream_(NULL),
+        stream_window_bits_(0) {}
   virtual ~ZLibInflateFilter();
 
   virtual bool Init();
@@ -121,7 +187,9 @@ class ZLibInflateFilter : public Filter {
   const intptr_t dictionary_length_;
   const bool raw_;
   uint8_t* current_buffer_;
-  z_stream stream_;
+  z_stream* stream_;
+  // Window bits as passed to inflateInit2.
+  int32_t stream_window_bits_;
 
   DISALLOW_COPY_AND_ASSIGN(ZLibInflateFilter);
 };
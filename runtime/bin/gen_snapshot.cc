@@ -409,8 +409,10 @@ static void MaybeLoadCode() {
     CHECK_RESULT(result);
   }
 
+  // AOT snapshots use the usage counts in the feedback to guide inlining.
   if ((load_type_feedback_filename != NULL) &&
-      ((snapshot_kind == kCoreJIT) || (snapshot_kind == kAppJIT))) {
+      ((snapshot_kind == kCoreJIT) || (snapshot_kind == kAppJIT) ||
+       IsSnapshottingForPrecompilation())) {
     uint8_t* buffer = NULL;
     intptr_t size = 0;
     ReadFile(load_type_feedback_filename, &buffer, &size);
@@ -594,7 +596,12 @@ static void WriteLoadingUnitManifest(File* manifest_file,
   if (id != 1) {
     line.AddString(",\n");
   }
-  line.Printf("{ \"id\": %" Pd ", \"path\": \"", id);
+  Dart_Handle parent = Dart_LoadingUnitParent(id);
+  CHECK_RESULT(parent);
+  int64_t parent_id;
+  CHECK_RESULT(Dart_IntegerToInt64(parent, &parent_id));
+  line.Printf("{ \"id\": %" Pd ", \"parent\": %" Pd64 ", \"path\": \"",
+              id, parent_id);
   line.AddEscapedString(path);
   line.AddString("\", \"libraries\": [\n");
   Dart_Handle uris = Dart_LoadingUnitLibraryUris(id);
@@ -0,0 +1,444 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Benchmarks of the native layer of dart:io. They call the socket, file,
+// directory and zlib primitives directly, so they measure the cost of the
+// system calls and of the runtime code around them, without an isolate
+// sending requests through ports.
+
+#include "bin/directory.h"
+#include "bin/file.h"
+#include "bin/filter.h"
+#include "bin/socket.h"
+#include "platform/assert.h"
+#include "platform/globals.h"
+#include "platform/utils.h"
+#include "vm/benchmark_test.h"
+#include "vm/metrics.h"
+#include "vm/os.h"
+#include "vm/os_thread.h"
+
+using dart::bin::Directory;
+using dart::bin::DirectoryListing;
+using dart::bin::File;
+using dart::bin::Filter;
+using dart::bin::RawAddr;
+using dart::bin::ServerSocket;
+using dart::bin::Socket;
+using dart::bin::SocketAddress;
+using dart::bin::SocketBase;
+using dart::bin::ZLibDeflateFilter;
+using dart::bin::ZLibInflateFilter;
+
+namespace dart {
+
+static RawAddr LoopbackAddress(intptr_t port) {
+  RawAddr addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.in.sin_family = AF_INET;
+  addr.in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  SocketAddress::SetAddrPort(&addr, port);
+  return addr;
+}
+
+// Returns the listening socket, and its port in port.
+static intptr_t ListenLoopback(intptr_t backlog, intptr_t* port) {
+  const intptr_t fd =
+      ServerSocket::CreateBindListen(LoopbackAddress(0), backlog);
+  EXPECT(fd >= 0);
+  *port = SocketBase::GetPort(fd);
+  return fd;
+}
+
+// Accepts the next connection on the non-blocking listening socket.
+static intptr_t AcceptLoopback(intptr_t listen_fd) {
+  intptr_t fd;
+  do {
+    fd = ServerSocket::Accept(listen_fd);
+  } while (fd == ServerSocket::kTemporaryFailure);
+  EXPECT(fd >= 0);
+  return fd;
+}
+
+struct SocketWriterInfo {
+  intptr_t fd;
+  intptr_t buffer_size;
+  intptr_t bytes;
+  ThreadJoinId join_id;
+};
+
+static void WriteSocket(uword param) {
+  SocketWriterInfo* info = reinterpret_cast<SocketWriterInfo*>(param);
+  info->join_id = OSThread::GetCurrentThreadJoinId(OSThread::Current());
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(info->buffer_size));
+  memset(buffer, 0x5a, info->buffer_size);
+  intptr_t written = 0;
+  while (written < info->bytes) {
+    const intptr_t result = SocketBase::Write(
+        info->fd, buffer,
+        Utils::Minimum(info->buffer_size, info->bytes - written),
+        SocketBase::kAsync);
+    if (result < 0) {
+      break;
+    }
+    written += result;
+  }
+  free(buffer);
+}
+
+// Sends a fixed amount of data over each of the given number of loopback
+// connections, each written by its own thread and all read by this one,
+// with reads and writes of buffer_size bytes. The sockets are non-blocking
+// and polled, as the event handler would after a readiness notification.
+static void BenchmarkSocketThroughput(Benchmark* benchmark,
+                                      intptr_t connections,
+                                      intptr_t buffer_size) {
+  const intptr_t kBytesPerConnection = 64 * MB;
+  intptr_t port;
+  const intptr_t listen_fd = ListenLoopback(connections, &port);
+  intptr_t* client_fds = new intptr_t[connections];
+  intptr_t* server_fds = new intptr_t[connections];
+  intptr_t* received = new intptr_t[connections];
+  for (intptr_t i = 0; i < connections; i++) {
+    client_fds[i] = Socket::CreateConnect(LoopbackAddress(port));
+    EXPECT(client_fds[i] >= 0);
+    server_fds[i] = AcceptLoopback(listen_fd);
+    received[i] = 0;
+  }
+
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(buffer_size));
+  SocketWriterInfo* writers = new SocketWriterInfo[connections];
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  for (intptr_t i = 0; i < connections; i++) {
+    writers[i].fd = client_fds[i];
+    writers[i].buffer_size = buffer_size;
+    writers[i].bytes = kBytesPerConnection;
+    writers[i].join_id = OSThread::kInvalidThreadJoinId;
+    OSThread::Start("SocketWriter", WriteSocket,
+                    reinterpret_cast<uword>(&writers[i]));
+  }
+  intptr_t done = 0;
+  while (done < connections) {
+    for (intptr_t i = 0; i < connections; i++) {
+      if (received[i] == kBytesPerConnection) {
+        continue;
+      }
+      const intptr_t result = SocketBase::Read(
+          server_fds[i], buffer,
+          Utils::Minimum(buffer_size, kBytesPerConnection - received[i]),
+          SocketBase::kAsync);
+      if (result < 0) {
+        FATAL("Read from loopback socket failed");
+      }
+      received[i] += result;
+      if (received[i] == kBytesPerConnection) {
+        done++;
+      }
+    }
+  }
+  const int64_t elapsed = OS::GetCurrentMonotonicMicros() - start;
+  benchmark->set_score(elapsed);
+  // Bytes per microsecond are megabytes per second.
+  benchmark->PrintResult(
+      "megabytesPerSecond", "Throughput",
+      elapsed > 0 ? (kBytesPerConnection * connections) / elapsed : 0);
+
+  for (intptr_t i = 0; i < connections; i++) {
+    // The writer has set its join id before writing its first byte.
+    ASSERT(writers[i].join_id != OSThread::kInvalidThreadJoinId);
+    OSThread::Join(writers[i].join_id);
+    SocketBase::Close(client_fds[i]);
+    SocketBase::Close(server_fds[i]);
+  }
+  SocketBase::Close(listen_fd);
+  delete[] writers;
+  free(buffer);
+  delete[] received;
+  delete[] server_fds;
+  delete[] client_fds;
+}
+
+BENCHMARK(SocketThroughput1Connection4KB) {
+  BenchmarkSocketThroughput(benchmark, 1, 4 * KB);
+}
+
+BENCHMARK(SocketThroughput1Connection64KB) {
+  BenchmarkSocketThroughput(benchmark, 1, 64 * KB);
+}
+
+BENCHMARK(SocketThroughput8Connections4KB) {
+  BenchmarkSocketThroughput(benchmark, 8, 4 * KB);
+}
+
+BENCHMARK(SocketThroughput8Connections64KB) {
+  BenchmarkSocketThroughput(benchmark, 8, 64 * KB);
+}
+
+// Opens, accepts and closes a fixed number of loopback connections, with
+// the given number of them connecting before they are accepted.
+static void BenchmarkSocketAccept(Benchmark* benchmark, intptr_t pending) {
+  const intptr_t kConnections = 4096;
+  intptr_t port;
+  const intptr_t listen_fd = ListenLoopback(pending, &port);
+  intptr_t* client_fds = new intptr_t[pending];
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  for (intptr_t i = 0; i < kConnections; i += pending) {
+    for (intptr_t j = 0; j < pending; j++) {
+      client_fds[j] = Socket::CreateConnect(LoopbackAddress(port));
+      EXPECT(client_fds[j] >= 0);
+    }
+    for (intptr_t j = 0; j < pending; j++) {
+      SocketBase::Close(AcceptLoopback(listen_fd));
+      SocketBase::Close(client_fds[j]);
+    }
+  }
+  const int64_t elapsed = OS::GetCurrentMonotonicMicros() - start;
+  benchmark->set_score(elapsed);
+  benchmark->PrintResult(
+      "connectionsPerSecond", "Throughput",
+      elapsed > 0 ? (kConnections * kMicrosecondsPerSecond) / elapsed : 0);
+  SocketBase::Close(listen_fd);
+  delete[] client_fds;
+}
+
+BENCHMARK(SocketAccept1Pending) {
+  BenchmarkSocketAccept(benchmark, 1);
+}
+
+BENCHMARK(SocketAccept64Pending) {
+  BenchmarkSocketAccept(benchmark, 64);
+}
+
+// Creates a directory for the benchmark in the system temporary directory.
+static const char* CreateBenchmarkDirectory() {
+  char* prefix = Utils::SCreate("%s%sdart_io_benchmark",
+                                Directory::SystemTemp(NULL),
+                                File::PathSeparator());
+  const char* path = Directory::CreateTemp(NULL, prefix);
+  free(prefix);
+  EXPECT_NOTNULL(path);
+  return path;
+}
+
+static void WriteBenchmarkFile(const char* path, intptr_t size) {
+  File* file = File::Open(NULL, path, File::kWriteTruncate);
+  EXPECT(file != NULL);
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(size));
+  memset(buffer, 0x5a, size);
+  EXPECT(file->WriteFully(buffer, size));
+  free(buffer);
+  file->Release();
+}
+
+// Opens, reads and closes a file of the given size, as File.readAsBytes
+// does through the IO service, and reports the latency of each read.
+static void BenchmarkFileRead(Benchmark* benchmark, intptr_t size) {
+  const intptr_t kReads = 10000;
+  const char* directory = CreateBenchmarkDirectory();
+  char* path = Utils::SCreate("%s%sfile", directory, File::PathSeparator());
+  WriteBenchmarkFile(path, size);
+
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(size));
+  Histogram latencies;
+  for (intptr_t i = 0; i < kReads; i++) {
+    const int64_t start = OS::GetCurrentMonotonicMicros();
+    File* file = File::Open(NULL, path, File::kRead);
+    const bool read = (file != NULL) && file->ReadFully(buffer, size);
+    if (file != NULL) {
+      file->Release();
+    }
+    latencies.Add(OS::GetCurrentMonotonicMicros() - start);
+    if (!read) {
+      FATAL1("Reading %s failed", path);
+    }
+  }
+  benchmark->set_score(latencies.total());
+  benchmark->PrintPercentiles(latencies);
+
+  free(buffer);
+  free(path);
+  EXPECT(Directory::Delete(NULL, directory, true));
+}
+
+BENCHMARK(FileRead4KB) {
+  BenchmarkFileRead(benchmark, 4 * KB);
+}
+
+BENCHMARK(FileRead64KB) {
+  BenchmarkFileRead(benchmark, 64 * KB);
+}
+
+// Counts the entries of a directory listing.
+class CountingDirectoryListing : public DirectoryListing {
+ public:
+  explicit CountingDirectoryListing(const char* path)
+      : DirectoryListing(NULL, path, false, false), entries_(0) {}
+
+  virtual bool HandleDirectory(const char* dir_name) {
+    entries_++;
+    return true;
+  }
+  virtual bool HandleFile(const char* file_name) {
+    entries_++;
+    return true;
+  }
+  virtual bool HandleLink(const char* link_name) {
+    entries_++;
+    return true;
+  }
+  virtual bool HandleError() { return false; }
+
+  intptr_t entries() const { return entries_; }
+
+ private:
+  intptr_t entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingDirectoryListing);
+};
+
+// Lists a directory of the given number of files repeatedly.
+static void BenchmarkDirectoryList(Benchmark* benchmark, intptr_t files) {
+  const intptr_t kListings = 100;
+  const char* directory = CreateBenchmarkDirectory();
+  for (intptr_t i = 0; i < files; i++) {
+    char* path = Utils::SCreate("%s%sfile%" Pd "", directory,
+                                File::PathSeparator(), i);
+    WriteBenchmarkFile(path, 0);
+    free(path);
+  }
+
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  for (intptr_t i = 0; i < kListings; i++) {
+    // The listing returns paths allocated in the API scope.
+    Dart_EnterScope();
+    CountingDirectoryListing listing(directory);
+    Directory::List(&listing);
+    if (listing.entries() != files) {
+      FATAL1("Listing %s failed", directory);
+    }
+    Dart_ExitScope();
+  }
+  const int64_t elapsed = OS::GetCurrentMonotonicMicros() - start;
+  benchmark->set_score(elapsed);
+  benchmark->PrintResult(
+      "entriesPerSecond", "Throughput",
+      elapsed > 0 ? (files * kListings * kMicrosecondsPerSecond) / elapsed
+                  : 0);
+
+  EXPECT(Directory::Delete(NULL, directory, true));
+}
+
+BENCHMARK(DirectoryList100) {
+  BenchmarkDirectoryList(benchmark, 100);
+}
+
+BENCHMARK(DirectoryList1000) {
+  BenchmarkDirectoryList(benchmark, 1000);
+}
+
+// Passes the input through the filter in chunks of buffer_size bytes, and
+// returns the size of the output. The output is appended to output if it is
+// not NULL.
+static intptr_t RunFilter(Filter* filter,
+                          const uint8_t* input,
+                          intptr_t length,
+                          intptr_t buffer_size,
+                          MallocGrowableArray<uint8_t>* output) {
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(buffer_size));
+  intptr_t output_length = 0;
+  for (intptr_t offset = 0; offset < length; offset += buffer_size) {
+    const intptr_t chunk_length = Utils::Minimum(buffer_size, length - offset);
+    // Process takes ownership of the chunk.
+    uint8_t* chunk = new uint8_t[chunk_length];
+    memmove(chunk, input + offset, chunk_length);
+    EXPECT(filter->Process(chunk, chunk_length));
+    const bool end = (offset + chunk_length) == length;
+    intptr_t processed;
+    while ((processed = filter->Processed(buffer, buffer_size, false, end)) >
+           0) {
+      output_length += processed;
+      if (output != NULL) {
+        for (intptr_t i = 0; i < processed; i++) {
+          output->Add(buffer[i]);
+        }
+      }
+    }
+    EXPECT(processed == 0);
+  }
+  free(buffer);
+  return output_length;
+}
+
+// Returns text-like input that compresses to about a third of its size.
+static uint8_t* ZLibBenchmarkInput(intptr_t length) {
+  uint8_t* input = reinterpret_cast<uint8_t*>(malloc(length));
+  uint32_t random = 1;
+  for (intptr_t i = 0; i < length; i++) {
+    random = random * 1103515245 + 12345;
+    input[i] = 'a' + ((random >> 16) % 16);
+  }
+  return input;
+}
+
+static const intptr_t kZLibBenchmarkLength = 16 * MB;
+static const int32_t kZLibLevel = 6;
+static const int32_t kZLibWindowBits = 15;
+static const int32_t kZLibMemLevel = 8;
+static const int32_t kZLibStrategy = 0;
+
+static void BenchmarkZLibDeflate(Benchmark* benchmark, intptr_t buffer_size) {
+  uint8_t* input = ZLibBenchmarkInput(kZLibBenchmarkLength);
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  ZLibDeflateFilter filter(false, kZLibLevel, kZLibWindowBits, kZLibMemLevel,
+                           kZLibStrategy, NULL, 0, false);
+  EXPECT(filter.Init());
+  RunFilter(&filter, input, kZLibBenchmarkLength, buffer_size, NULL);
+  const int64_t elapsed = OS::GetCurrentMonotonicMicros() - start;
+  benchmark->set_score(elapsed);
+  benchmark->PrintResult("megabytesPerSecond", "Throughput",
+                         elapsed > 0 ? kZLibBenchmarkLength / elapsed : 0);
+  free(input);
+}
+
+// The throughput is reported for the decompressed bytes.
+static void BenchmarkZLibInflate(Benchmark* benchmark, intptr_t buffer_size) {
+  uint8_t* input = ZLibBenchmarkInput(kZLibBenchmarkLength);
+  MallocGrowableArray<uint8_t> compressed;
+  {
+    ZLibDeflateFilter filter(false, kZLibLevel, kZLibWindowBits,
+                             kZLibMemLevel, kZLibStrategy, NULL, 0, false);
+    EXPECT(filter.Init());
+    RunFilter(&filter, input, kZLibBenchmarkLength, 64 * KB, &compressed);
+  }
+  free(input);
+
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  ZLibInflateFilter filter(kZLibWindowBits, NULL, 0, false);
+  EXPECT(filter.Init());
+  const intptr_t length = RunFilter(&filter, compressed.data(),
+                                    compressed.length(), buffer_size, NULL);
+  const int64_t elapsed = OS::GetCurrentMonotonicMicros() - start;
+  EXPECT_EQ(kZLibBenchmarkLength, length);
+  benchmark->set_score(elapsed);
+  benchmark->PrintResult("megabytesPerSecond", "Throughput",
+                         elapsed > 0 ? kZLibBenchmarkLength / elapsed : 0);
+}
+
+BENCHMARK(ZLibDeflate4KB) {
+  BenchmarkZLibDeflate(benchmark, 4 * KB);
+}
+
+BENCHMARK(ZLibDeflate64KB) {
+  BenchmarkZLibDeflate(benchmark, 64 * KB);
+}
+
+BENCHMARK(ZLibInflate4KB) {
+  BenchmarkZLibInflate(benchmark, 4 * KB);
+}
+
+BENCHMARK(ZLibInflate64KB) {
+  BenchmarkZLibInflate(benchmark, 64 * KB);
+}
+
+}  // namespace dart
@@ -20,6 +20,14 @@ class IOBuffer {
   // Allocate IO buffer storage.
   static uint8_t* Allocate(intptr_t size);
 
+  // Shrink or grow IO buffer storage, returning the new storage or NULL if
+  // it cannot be resized. Shrinking is usually done in place.
+  static uint8_t* Reallocate(uint8_t* buffer, intptr_t new_size);
+
+  // Create an IO buffer dart object (of type Uint8List) taking ownership of
+  // storage previously returned by Allocate or Reallocate.
+  static Dart_Handle Wrap(uint8_t* buffer, intptr_t size);
+
   // Function for disposing of IO buffer storage. All backing storage
   // for IO buffers must be freed using this function.
   static void Free(void* buffer) { free(buffer); }
@@ -3,6 +3,7 @@
 // BSD-style license that can be found in the LICENSE file.
 
 #include "bin/isolate_data.h"
+#include "bin/dartutils.h"
 #include "bin/snapshot_utils.h"
 #include "platform/growable_array.h"
 
@@ -38,6 +39,13 @@ IsolateGroupData::~IsolateGroupData() {
   kernel_buffer_size_ = 0;
 }
 
+void IsolateGroupData::SetKernelBufferNewlyOwned(uint8_t* buffer,
+                                                 intptr_t size) {
+  ASSERT(kernel_buffer_.get() == NULL);
+  kernel_buffer_ = std::shared_ptr<uint8_t>(buffer, DartUtils::FreeFileData);
+  kernel_buffer_size_ = size;
+}
+
 IsolateData::IsolateData(IsolateGroupData* isolate_group_data)
     : isolate_group_data_(isolate_group_data),
       loader_(nullptr),
@@ -59,12 +59,8 @@ class IsolateGroupData {
 
   // Associate the given kernel buffer with this IsolateGroupData and give it
   // ownership of the buffer. This IsolateGroupData is the first one to own the
-  // buffer.
-  void SetKernelBufferNewlyOwned(uint8_t* buffer, intptr_t size) {
-    ASSERT(kernel_buffer_.get() == NULL);
-    kernel_buffer_ = std::shared_ptr<uint8_t>(buffer, free);
-    kernel_buffer_size_ = size;
-  }
+  // buffer, which is released with DartUtils::FreeFileData.
+  void SetKernelBufferNewlyOwned(uint8_t* buffer, intptr_t size);
 
   // Associate the given kernel buffer with this IsolateGroupData and give it
   // ownership of the buffer. The buffer is already owned by another
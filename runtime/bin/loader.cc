@@ -139,8 +139,8 @@ Dart_Handle Loader::ReloadNativeExtensions() {
 }
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
-static void MallocFinalizer(void* isolate_callback_data, void* peer) {
-  free(peer);
+static void FileDataFinalizer(void* isolate_callback_data, void* peer) {
+  DartUtils::FreeFileData(reinterpret_cast<uint8_t*>(peer));
 }
 #endif
 
@@ -180,7 +180,7 @@ Dart_Handle Loader::LibraryTagHandler(Dart_LibraryTag tag,
     result = Dart_NewExternalTypedData(Dart_TypedData_kUint8, kernel_buffer,
                                        kernel_buffer_size);
     Dart_NewFinalizableHandle(result, kernel_buffer, kernel_buffer_size,
-                              MallocFinalizer);
+                              FileDataFinalizer);
     return result;
   }
   if (tag == Dart_kImportExtensionTag) {
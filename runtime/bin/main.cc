@@ -1043,6 +1043,53 @@ void RunMainIsolate(const char* script_name,
 
 #undef CHECK_RESULT
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+// Returns the path of the app-jit snapshot for the kernel file [script_name]
+// in the directory [cache_dir]. The name is derived from the contents of the
+// kernel file and the VM version, so stale entries are never picked up after
+// either of them changes. The caller owns the returned string.
+static char* JitCodeCachePath(const char* cache_dir, const char* script_name) {
+  uint8_t* buffer = nullptr;
+  intptr_t size = 0;
+  ReadFile(script_name, &buffer, &size);
+  // 64-bit FNV-1a.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (intptr_t i = 0; i < size; i++) {
+    hash = (hash ^ buffer[i]) * 0x100000001b3ULL;
+  }
+  free(buffer);
+  const char* version = Dart_VersionString();
+  for (const char* p = version; *p != '\0'; p++) {
+    hash = (hash ^ static_cast<uint8_t>(*p)) * 0x100000001b3ULL;
+  }
+  return Utils::SCreate("%s%s%016" Px64 ".jit", cache_dir,
+                        File::PathSeparator(), hash);
+}
+
+// Looks up the app-jit snapshot of a kernel script in the JIT code cache.
+// On a hit the snapshot is run instead of the script, on a miss the run is
+// turned into an app-jit training run that populates the cache on exit.
+static void TryUseJitCodeCache(const char* script_name,
+                               AppSnapshot** app_snapshot) {
+  if ((Options::jit_code_cache() == nullptr) ||
+      (Options::gen_snapshot_kind() != kNone) || vm_run_app_snapshot ||
+      (DartUtils::SniffForMagicNumber(script_name) !=
+       DartUtils::kKernelMagicNumber)) {
+    return;
+  }
+  char* path = JitCodeCachePath(Options::jit_code_cache(), script_name);
+  if (File::Exists(nullptr, path)) {
+    *app_snapshot = Snapshot::TryReadAppSnapshot(path);
+  }
+  if (*app_snapshot == nullptr) {
+    // Leaked: the snapshot is written from the exit hook.
+    Options::UseJitCodeCache(path);
+  } else {
+    free(path);
+  }
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 static bool CheckForInvalidPath(const char* path) {
   // TODO(zichangguo): "\\?\" is a prefix for paths on Windows.
   // Arguments passed are parsed as an URI. "\\?\" causes problems as a part
@@ -1202,6 +1249,9 @@ void main(int argc, char** argv) {
     if (!CheckForInvalidPath(script_name)) {
       Platform::Exit(0);
     }
+#if !defined(DART_PRECOMPILED_RUNTIME)
+    TryUseJitCodeCache(script_name, &app_snapshot);
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
     try_load_snapshots_lambda();
   }
 
@@ -1237,7 +1287,7 @@ void main(int argc, char** argv) {
 #if !defined(DART_PRECOMPILED_RUNTIME)
   // Load vm_platform_strong.dill for dart:* source support.
   dfe.Init();
-  if (script_name != nullptr) {
+  if ((script_name != nullptr) && !vm_run_app_snapshot) {
     uint8_t* application_kernel_buffer = NULL;
     intptr_t application_kernel_buffer_size = 0;
     dfe.ReadScript(script_name, &application_kernel_buffer,
@@ -10,6 +10,8 @@
 
 #include "bin/dartdev_isolate.h"
 #include "bin/error_exit.h"
+#include "bin/eventhandler.h"
+#include "bin/file.h"
 #include "bin/options.h"
 #include "bin/platform.h"
 #include "bin/utils.h"
@@ -210,6 +212,19 @@ void Options::PrintUsage() {
 "--root-certs-cache=<path>\n"
 "  The path to a cache directory containing the trusted root certificates to\n"
 "  use for secure socket connections.\n"
+"--jit-code-cache=<path>\n"
+"  The path to a directory used to cache app-jit snapshots of kernel (.dill)\n"
+"  scripts. If a snapshot for this script and VM version is found it is run,\n"
+"  otherwise one is written to the directory when the script exits.\n"
+"--buffer-stdio\n"
+"  Collect small writes to stdout and stderr into fewer, larger writes.\n"
+"  Output to a terminal is written at each newline; other output may be\n"
+"  delayed by a few milliseconds.\n"
+#if defined(HOST_OS_LINUX)
+"--eventhandler-threads=<count>\n"
+"  The number of threads polling sockets for dart:io (default 1). Sockets\n"
+"  and timers are spread over the threads.\n"
+#endif  // defined(HOST_OS_LINUX)
 #if defined(HOST_OS_LINUX) || \
     defined(HOST_OS_ANDROID) || \
     defined(HOST_OS_FUCHSIA)
@@ -353,6 +368,24 @@ bool Options::ProcessObserveOption(const char* arg,
   return true;
 }
 
+bool Options::ProcessEventHandlerThreadsOption(const char* arg,
+                                               CommandLineOptions* vm_options) {
+  const char* value =
+      OptionProcessor::ProcessOption(arg, "--eventhandler-threads=");
+  if (value == NULL) {
+    return false;
+  }
+  int threads = atoi(value);
+  if (threads < 1) {
+    Syslog::PrintErr(
+        "unrecognized --eventhandler-threads option syntax. "
+        "Use --eventhandler-threads=<count>\n");
+    return false;
+  }
+  EventHandler::set_thread_count(threads);
+  return true;
+}
+
 // Explicitly handle VM flags that can be parsed by DartDev's run command.
 bool Options::ProcessVMDebuggingOptions(const char* arg,
                                         CommandLineOptions* vm_options) {
@@ -453,6 +486,7 @@ bool Options::ParseArguments(int argc,
 
   Socket::set_short_socket_read(Options::short_socket_read());
   Socket::set_short_socket_write(Options::short_socket_write());
+  StdioBuffer::set_enabled(Options::buffer_stdio());
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   SSLCertContext::set_root_certs_file(Options::root_certs_file());
   SSLCertContext::set_root_certs_cache(Options::root_certs_cache());
@@ -624,6 +658,11 @@ bool Options::ParseArguments(int argc,
     return false;
   }
 
+  if ((jit_code_cache_ != NULL) && (strlen(jit_code_cache_) == 0)) {
+    Syslog::PrintErr("Empty JIT code cache directory specified.\n");
+    return false;
+  }
+
   // If --snapshot is given without --snapshot-kind, default to script snapshot.
   if ((snapshot_filename_ != NULL) && (gen_snapshot_kind_ == kNone)) {
     gen_snapshot_kind_ = kKernel;
@@ -632,5 +671,11 @@ bool Options::ParseArguments(int argc,
   return true;
 }
 
+void Options::UseJitCodeCache(const char* filename) {
+  ASSERT(gen_snapshot_kind_ == kNone);
+  gen_snapshot_kind_ = kAppJIT;
+  snapshot_filename_ = filename;
+}
+
 }  // namespace bin
 }  // namespace dart
@@ -27,6 +27,7 @@ namespace bin {
   V(load_compilation_trace, load_compilation_trace_filename)                   \
   V(save_type_feedback, save_type_feedback_filename)                           \
   V(load_type_feedback, load_type_feedback_filename)                           \
+  V(jit_code_cache, jit_code_cache)                                            \
   V(root_certs_file, root_certs_file)                                          \
   V(root_certs_cache, root_certs_cache)                                        \
   V(namespace, namespc)                                                        \
@@ -48,7 +49,8 @@ namespace bin {
   V(suppress_core_dump, suppress_core_dump)                                    \
   V(enable_service_port_fallback, enable_service_port_fallback)                \
   V(disable_dart_dev, disable_dart_dev)                                        \
-  V(long_ssl_cert_evaluation, long_ssl_cert_evaluation)
+  V(long_ssl_cert_evaluation, long_ssl_cert_evaluation)                        \
+  V(buffer_stdio, buffer_stdio)
 
 // Boolean flags that have a short form.
 #define SHORT_BOOL_OPTIONS_LIST(V)                                             \
@@ -70,6 +72,7 @@ namespace bin {
   V(ProcessEnvironmentOption)                                                  \
   V(ProcessEnableVmServiceOption)                                              \
   V(ProcessObserveOption)                                                      \
+  V(ProcessEventHandlerThreadsOption)                                          \
   V(ProcessVMDebuggingOptions)
 
 // This enum must match the strings in kSnapshotKindNames in main_options.cc.
@@ -136,6 +139,10 @@ class Options {
   static void set_dfe(DFE* dfe) { dfe_ = dfe; }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
+  // Switches to generating an app-jit snapshot into [filename] on exit.
+  // Used to populate the JIT code cache (--jit-code-cache) on a miss.
+  static void UseJitCodeCache(const char* filename);
+
   static void PrintUsage();
   static void PrintVersion();
 
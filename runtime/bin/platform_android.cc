@@ -160,6 +160,7 @@ intptr_t Platform::ResolveExecutablePathInto(char* result, size_t result_size) {
 }
 
 void Platform::Exit(int exit_code) {
+  StdioBuffer::Flush();
   Console::RestoreConfig();
   Dart_PrepareToAbort();
   exit(exit_code);
@@ -304,6 +304,7 @@ intptr_t Platform::ResolveExecutablePathInto(char* result, size_t result_size) {
 }
 
 void Platform::Exit(int exit_code) {
+  StdioBuffer::Flush();
   // Restore the console's output code page
   Console::RestoreConfig();
   // On Windows we use ExitProcess so that threads can't clobber the exit_code.
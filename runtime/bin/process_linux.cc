@@ -13,7 +13,9 @@
 #include <stdio.h>         // NOLINT
 #include <stdlib.h>        // NOLINT
 #include <string.h>        // NOLINT
+#include <signal.h>        // NOLINT
 #include <sys/resource.h>  // NOLINT
+#include <sys/stat.h>      // NOLINT
 #include <sys/wait.h>      // NOLINT
 #include <unistd.h>        // NOLINT
 
@@ -73,6 +75,16 @@ class ProcessInfoList {
 
   static void AddProcess(pid_t pid, intptr_t fd) {
     MutexLocker locker(mutex_);
+    AddProcessLocked(pid, fd);
+  }
+
+  // Lock and Unlock allow a process to be started and added to the list
+  // atomically with respect to the exit code handler: a child that exits
+  // before it is added cannot have its exit code looked up and dropped.
+  static void Lock() { mutex_->Lock(); }
+  static void Unlock() { mutex_->Unlock(); }
+
+  static void AddProcessLocked(pid_t pid, intptr_t fd) {
     ProcessInfo* info = new ProcessInfo(pid, fd);
     info->set_next(active_processes_);
     active_processes_ = info;
@@ -312,37 +324,46 @@ class ProcessStarter {
       return err;
     }
 
-    // Fork to create the new process.
-    pid_t pid = TEMP_FAILURE_RETRY(fork());
-    if (pid < 0) {
-      // Failed to fork.
-      return CleanupAndReturnError();
-    } else if (pid == 0) {
-      // This runs in the new process.
-      NewProcess();
-    }
-
-    // This runs in the original process.
-
-    // If the child process is not started in detached mode, be sure to
-    // listen for exit-codes, now that we have a non detached child process
-    // and also Register this child process.
-    if (Process::ModeIsAttached(mode_)) {
-      ExitCodeHandler::ProcessStarted();
-      err = RegisterProcess(pid);
+    pid_t pid;
+    char executable[PATH_MAX];
+    if (CanUseVFork(executable, PATH_MAX)) {
+      err = StartWithVFork(executable, &pid);
       if (err != 0) {
         return err;
       }
-    }
+    } else {
+      // Fork to create the new process.
+      pid = TEMP_FAILURE_RETRY(fork());
+      if (pid < 0) {
+        // Failed to fork.
+        return CleanupAndReturnError();
+      } else if (pid == 0) {
+        // This runs in the new process.
+        NewProcess();
+      }
 
-    // Notify child process to start. This is done to delay the call to exec
-    // until the process is registered above, and we are ready to receive the
-    // exit code.
-    char msg = '1';
-    int bytes_written =
-        FDUtils::WriteToBlocking(read_in_[1], &msg, sizeof(msg));
-    if (bytes_written != sizeof(msg)) {
-      return CleanupAndReturnError();
+      // This runs in the original process.
+
+      // If the child process is not started in detached mode, be sure to
+      // listen for exit-codes, now that we have a non detached child process
+      // and also Register this child process.
+      if (Process::ModeIsAttached(mode_)) {
+        ExitCodeHandler::ProcessStarted();
+        err = RegisterProcess(pid);
+        if (err != 0) {
+          return err;
+        }
+      }
+
+      // Notify child process to start. This is done to delay the call to exec
+      // until the process is registered above, and we are ready to receive the
+      // exit code.
+      char msg = '1';
+      int bytes_written =
+          FDUtils::WriteToBlocking(read_in_[1], &msg, sizeof(msg));
+      if (bytes_written != sizeof(msg)) {
+        return CleanupAndReturnError();
+      }
     }
 
     // Read the result of executing the child process.
@@ -477,7 +498,163 @@ class ProcessStarter {
     return true;
   }
 
-  void ExecProcess() {
+  // Forking copies the page tables of the whole process, which gets slow
+  // once the Dart heap is large. An attached process can instead be started
+  // with vfork, where the child borrows the parent's memory until it calls
+  // exec. The child must then not touch any state shared with the parent,
+  // so this is only done when nothing but the child's own stack, fd table
+  // and cwd is modified on the way to exec:
+  //  * the default namespace is used, since a custom namespace keeps its
+  //    cwd in memory,
+  //  * the environment is passed to execve rather than installed in
+  //    environ, which means a PATH search has to be done here using the
+  //    child's PATH. If that is not possible, fork and execvp are used.
+  // On success executable holds the program to exec, or is empty if path_
+  // should be resolved by FindPathInNamespace in the child.
+  bool CanUseVFork(char* executable, intptr_t executable_size) {
+    if (!Process::ModeIsAttached(mode_) || !Namespace::IsDefault(namespc_)) {
+      return false;
+    }
+    executable[0] = '\0';
+    if (strchr(path_, '/') != NULL) {
+      return true;
+    }
+    const char* search_path = NULL;
+    if (program_environment_ != NULL) {
+      for (char** entry = program_environment_; *entry != NULL; entry++) {
+        if (strncmp(*entry, "PATH=", 5) == 0) {
+          search_path = *entry + 5;
+          break;
+        }
+      }
+    } else {
+      search_path = getenv("PATH");
+    }
+    if (search_path == NULL) {
+      return false;
+    }
+    const char* dir = search_path;
+    while (true) {
+      const char* end = strchr(dir, ':');
+      const intptr_t dir_length =
+          (end == NULL) ? strlen(dir) : static_cast<intptr_t>(end - dir);
+      // Relative entries would be resolved against the child's working
+      // directory, so leave those searches to execvp.
+      if ((dir_length == 0) || (dir[0] != '/')) {
+        return false;
+      }
+      const int length = snprintf(executable, executable_size, "%.*s/%s",
+                                  static_cast<int>(dir_length), dir, path_);
+      if (length < executable_size) {
+        struct stat64 st;
+        if ((TEMP_FAILURE_RETRY(stat64(executable, &st)) == 0) &&
+            S_ISREG(st.st_mode) &&
+            (TEMP_FAILURE_RETRY(access(executable, X_OK)) == 0)) {
+          return true;
+        }
+      }
+      if (end == NULL) {
+        // Not found. Let execvp report the error.
+        return false;
+      }
+      dir = end + 1;
+    }
+  }
+
+  int StartWithVFork(const char* executable, pid_t* pid) {
+    // Set up everything that allocates before the child is started.
+    int event_fds[2];
+    if (TEMP_FAILURE_RETRY(pipe2(event_fds, O_CLOEXEC)) < 0) {
+      return CleanupAndReturnError();
+    }
+    // Arguments for running the program as a shell script if exec fails
+    // with ENOEXEC, as execvp does. Slot 1 is filled in by the child.
+    intptr_t arguments_length = 0;
+    while (program_arguments_[arguments_length] != NULL) {
+      arguments_length++;
+    }
+    char** shell_arguments = reinterpret_cast<char**>(
+        Dart_ScopeAllocate((arguments_length + 2) * sizeof(*shell_arguments)));
+    shell_arguments[0] = const_cast<char*>("/bin/sh");
+    shell_arguments[1] = NULL;
+    for (intptr_t i = 1; i <= arguments_length; i++) {
+      shell_arguments[i + 1] = program_arguments_[i];
+    }
+    ExitCodeHandler::ProcessStarted();
+
+    // Signal handlers must not run in the child while it shares memory with
+    // the parent. Block everything here; the child resets the handlers to
+    // their defaults before restoring the mask.
+    sigset_t all_signals;
+    sigset_t old_signals;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_SETMASK, &all_signals, &old_signals);
+    // The exit code handler may reap the child as soon as it exists. Hold
+    // the process list lock until the child is in it.
+    ProcessInfoList::Lock();
+    const pid_t result = vfork();
+    if (result == 0) {
+      ExecVForkedProcess(executable, shell_arguments, &old_signals);
+    }
+    int vfork_errno = errno;
+    if (result > 0) {
+      ProcessInfoList::AddProcessLocked(result, event_fds[1]);
+    }
+    ProcessInfoList::Unlock();
+    pthread_sigmask(SIG_SETMASK, &old_signals, NULL);
+
+    if (result < 0) {
+      close(event_fds[0]);
+      close(event_fds[1]);
+      errno = vfork_errno;
+      return CleanupAndReturnError();
+    }
+    *exit_event_ = event_fds[0];
+    FDUtils::SetNonBlocking(event_fds[0]);
+    *pid = result;
+    return 0;
+  }
+
+  // Runs in the vfork child. Only the child's own stack may be written.
+  DART_NORETURN void ExecVForkedProcess(const char* executable,
+                                        char** shell_arguments,
+                                        const sigset_t* signals) {
+    for (int sig = 1; sig < NSIG; sig++) {
+      struct sigaction act;
+      if ((sigaction(sig, NULL, &act) == 0) && (act.sa_handler != SIG_DFL) &&
+          (act.sa_handler != SIG_IGN)) {
+        act = {};
+        act.sa_handler = SIG_DFL;
+        sigaction(sig, &act, NULL);
+      }
+    }
+    pthread_sigmask(SIG_SETMASK, signals, NULL);
+
+    ConnectStdio();
+    if (working_directory_ != NULL &&
+        !Directory::SetCurrent(namespc_, working_directory_)) {
+      ReportChildError();
+    }
+    char realpath[PATH_MAX];
+    if (executable[0] == '\0') {
+      if (!FindPathInNamespace(realpath, PATH_MAX)) {
+        ReportChildError();
+      }
+      executable = realpath;
+    }
+    char** environment =
+        (program_environment_ != NULL) ? program_environment_ : environ;
+    execve(executable, program_arguments_, environment);
+    if (errno == ENOEXEC) {
+      // The parent has no further use for shell_arguments.
+      shell_arguments[1] = const_cast<char*>(executable);
+      execve(shell_arguments[0], shell_arguments, environment);
+    }
+    ReportChildError();
+    _exit(1);
+  }
+
+  void ConnectStdio() {
     if (mode_ == kNormal) {
       if (TEMP_FAILURE_RETRY(dup2(write_out_[0], STDIN_FILENO)) == -1) {
         ReportChildError();
@@ -493,6 +670,10 @@ class ProcessStarter {
     } else {
       ASSERT(mode_ == kInheritStdio);
     }
+  }
+
+  void ExecProcess() {
+    ConnectStdio();
 
     if (working_directory_ != NULL &&
         !Directory::SetCurrent(namespc_, working_directory_)) {
@@ -7,6 +7,8 @@
 #include "bin/secure_socket_filter.h"
 
 #include <openssl/bio.h>
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
 #include <openssl/ssl.h>
 #include <openssl/x509.h>
 
@@ -31,6 +33,7 @@ namespace bin {
 bool SSLFilter::library_initialized_ = false;
 // To protect library initialization.
 Mutex* SSLFilter::mutex_ = nullptr;
+Dart_Port SSLFilter::private_key_port_ = ILLEGAL_PORT;
 int SSLFilter::filter_ssl_index;
 int SSLFilter::ssl_cert_context_index;
 
@@ -43,9 +46,183 @@ void SSLFilter::Cleanup() {
   ASSERT(SSLFilter::mutex_ != nullptr);
   delete SSLFilter::mutex_;
   SSLFilter::mutex_ = nullptr;
+  // The port itself goes away with the VM.
+  SSLFilter::private_key_port_ = ILLEGAL_PORT;
 }
 
-const intptr_t SSLFilter::kInternalBIOSize = 10 * KB;
+// A signature or RSA decryption with the server's private key, performed on
+// the thread pool instead of in SSL_do_handshake on the isolate's thread.
+// Shared between the filter, which polls it from the private key method's
+// complete callback, and the worker that runs it.
+class PrivateKeyOperation : public ReferenceCounted<PrivateKeyOperation> {
+ public:
+  PrivateKeyOperation(EVP_PKEY* key,
+                      uint16_t algorithm,
+                      bool is_decrypt,
+                      const uint8_t* in,
+                      size_t in_length,
+                      size_t max_out)
+      : key_(key),
+        algorithm_(algorithm),
+        is_decrypt_(is_decrypt),
+        in_(reinterpret_cast<uint8_t*>(malloc(in_length))),
+        in_length_(in_length),
+        out_(reinterpret_cast<uint8_t*>(malloc(max_out))),
+        out_length_(0),
+        max_out_(max_out) {
+    EVP_PKEY_up_ref(key_);
+    memmove(in_, in, in_length);
+  }
+
+  ~PrivateKeyOperation() {
+    EVP_PKEY_free(key_);
+    free(in_);
+    free(out_);
+  }
+
+  void set_reply_port(Dart_Port reply_port) {
+    MutexLocker locker(&mutex_);
+    reply_port_ = reply_port;
+  }
+
+  // Called on the thread pool. Tells the Dart side of the filter to retry
+  // the handshake once the result is available.
+  void Run() {
+    bool success = is_decrypt_ ? Decrypt() : Sign();
+    Dart_Port reply_port;
+    {
+      MutexLocker locker(&mutex_);
+      success_ = success;
+      done_ = true;
+      reply_port = reply_port_;
+    }
+    if (reply_port != ILLEGAL_PORT) {
+      Dart_CObject message;
+      message.type = Dart_CObject_kNull;
+      Dart_PostCObject(reply_port, &message);
+    }
+  }
+
+  // Returns false if the operation is still running.
+  bool Finish(uint8_t* out,
+              size_t* out_length,
+              size_t max_out,
+              ssl_private_key_result_t* result) {
+    MutexLocker locker(&mutex_);
+    if (!done_) {
+      return false;
+    }
+    if (!success_ || out_length_ > max_out) {
+      *result = ssl_private_key_failure;
+      return true;
+    }
+    memmove(out, out_, out_length_);
+    *out_length = out_length_;
+    *result = ssl_private_key_success;
+    return true;
+  }
+
+ private:
+  bool Sign() {
+    if (EVP_PKEY_id(key_) != SSL_get_signature_algorithm_key_type(algorithm_)) {
+      return false;
+    }
+    const EVP_MD* digest = SSL_get_signature_algorithm_digest(algorithm_);
+    EVP_MD_CTX context;
+    EVP_MD_CTX_init(&context);
+    EVP_PKEY_CTX* pkey_context;
+    size_t length = max_out_;
+    bool success =
+        EVP_DigestSignInit(&context, &pkey_context, digest, NULL, key_) &&
+        (!SSL_is_signature_algorithm_rsa_pss(algorithm_) ||
+         (EVP_PKEY_CTX_set_rsa_padding(pkey_context, RSA_PKCS1_PSS_PADDING) &&
+          EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_context, -1))) &&
+        EVP_DigestSign(&context, out_, &length, in_, in_length_);
+    EVP_MD_CTX_cleanup(&context);
+    out_length_ = success ? length : 0;
+    return success;
+  }
+
+  bool Decrypt() {
+    // BoringSSL removes the padding itself.
+    RSA* rsa = EVP_PKEY_get0_RSA(key_);
+    size_t length = 0;
+    bool success = rsa != NULL && RSA_decrypt(rsa, &length, out_, max_out_, in_,
+                                              in_length_, RSA_NO_PADDING);
+    out_length_ = success ? length : 0;
+    return success;
+  }
+
+  EVP_PKEY* key_;
+  const uint16_t algorithm_;
+  const bool is_decrypt_;
+  uint8_t* in_;
+  const size_t in_length_;
+  uint8_t* out_;
+  size_t out_length_;
+  const size_t max_out_;
+
+  Mutex mutex_;
+  Dart_Port reply_port_ = ILLEGAL_PORT;
+  bool done_ = false;
+  bool success_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(PrivateKeyOperation);
+};
+
+static void PrivateKeyOperationHandler(Dart_Port dest_port_id,
+                                       Dart_CObject* message) {
+  ASSERT(message->type == Dart_CObject_kInt64);
+  PrivateKeyOperation* operation =
+      reinterpret_cast<PrivateKeyOperation*>(message->value.as_int64);
+  operation->Run();
+  operation->Release();
+}
+
+static SSLFilter* GetFilterFromSSL(SSL* ssl) {
+  return static_cast<SSLFilter*>(
+      SSL_get_ex_data(ssl, SSLFilter::filter_ssl_index));
+}
+
+static ssl_private_key_result_t PrivateKeySign(SSL* ssl,
+                                               uint8_t* out,
+                                               size_t* out_length,
+                                               size_t max_out,
+                                               uint16_t algorithm,
+                                               const uint8_t* in,
+                                               size_t in_length) {
+  return GetFilterFromSSL(ssl)->StartPrivateKeyOperation(
+      algorithm, /*is_decrypt=*/false, in, in_length, max_out);
+}
+
+static ssl_private_key_result_t PrivateKeyDecrypt(SSL* ssl,
+                                                  uint8_t* out,
+                                                  size_t* out_length,
+                                                  size_t max_out,
+                                                  const uint8_t* in,
+                                                  size_t in_length) {
+  return GetFilterFromSSL(ssl)->StartPrivateKeyOperation(
+      0, /*is_decrypt=*/true, in, in_length, max_out);
+}
+
+static ssl_private_key_result_t PrivateKeyComplete(SSL* ssl,
+                                                   uint8_t* out,
+                                                   size_t* out_length,
+                                                   size_t max_out) {
+  return GetFilterFromSSL(ssl)->CompletePrivateKeyOperation(out, out_length,
+                                                            max_out);
+}
+
+static const SSL_PRIVATE_KEY_METHOD kAsyncPrivateKeyMethod = {
+    PrivateKeySign,
+    PrivateKeyDecrypt,
+    PrivateKeyComplete,
+};
+
+// Large enough for one full TLS record: 16 KB of plaintext plus the record
+// header, MAC/tag and padding, so a record never has to be split across
+// several passes through the BIO pair.
+const intptr_t SSLFilter::kInternalBIOSize = 17 * KB;
 const intptr_t SSLFilter::kApproximateSize =
     sizeof(SSLFilter) + (2 * SSLFilter::kInternalBIOSize);
 
@@ -509,6 +686,19 @@ void SSLFilter::Connect(const char* hostname,
         /*handle_concurrently=*/false);
   }
   if (is_server_) {
+    if (SSL_CTX_get0_privatekey(context->context()) != NULL) {
+      {
+        MutexLocker locker(mutex_);
+        if (private_key_port_ == ILLEGAL_PORT) {
+          private_key_port_ = Dart_NewNativePort(
+              "SSLFilterPrivateKey", PrivateKeyOperationHandler,
+              /*handle_concurrently=*/true);
+        }
+      }
+      if (private_key_port_ != ILLEGAL_PORT) {
+        SSL_set_private_key_method(ssl_, &kAsyncPrivateKeyMethod);
+      }
+    }
     int certificate_mode =
         request_client_certificate ? SSL_VERIFY_PEER : SSL_VERIFY_NONE;
     if (require_client_certificate) {
@@ -583,12 +773,18 @@ int SSLFilter::Handshake(Dart_Port reply_port) {
   // invoked by SSL_do_handshake: this is where results of
   // certificate evaluation will be communicated to.
   reply_port_ = reply_port;
+  // A private key operation started by an earlier call reports to the
+  // current port, whichever call started it.
+  if (private_key_operation_ != nullptr) {
+    private_key_operation_->set_reply_port(reply_port);
+  }
 
   // Try and push handshake along.
   int status = SSL_do_handshake(ssl_);
   int error = SSL_get_error(ssl_, status);
-  if (error == SSL_ERROR_WANT_CERTIFICATE_VERIFY) {
-    return SSL_ERROR_WANT_CERTIFICATE_VERIFY;
+  if (error == SSL_ERROR_WANT_CERTIFICATE_VERIFY ||
+      error == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION) {
+    return error;
   }
   if (callback_error != NULL) {
     // The SSL_do_handshake will try performing a handshake and might call
@@ -630,6 +826,50 @@ int SSLFilter::Handshake(Dart_Port reply_port) {
   return error;
 }
 
+ssl_private_key_result_t SSLFilter::StartPrivateKeyOperation(
+    uint16_t algorithm,
+    bool is_decrypt,
+    const uint8_t* in,
+    size_t in_length,
+    size_t max_out) {
+  ASSERT(private_key_operation_ == nullptr);
+  EVP_PKEY* key = SSL_CTX_get0_privatekey(SSL_get_SSL_CTX(ssl_));
+  if (key == NULL) {
+    return ssl_private_key_failure;
+  }
+  PrivateKeyOperation* operation = new PrivateKeyOperation(
+      key, algorithm, is_decrypt, in, in_length, max_out);
+  operation->set_reply_port(reply_port_);
+  // One reference for the filter, one for the worker.
+  operation->Retain();
+  Dart_CObject message;
+  message.type = Dart_CObject_kInt64;
+  message.value.as_int64 = reinterpret_cast<intptr_t>(operation);
+  if (!Dart_PostCObject(private_key_port_, &message)) {
+    operation->Release();
+    operation->Release();
+    return ssl_private_key_failure;
+  }
+  private_key_operation_ = operation;
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t SSLFilter::CompletePrivateKeyOperation(
+    uint8_t* out,
+    size_t* out_length,
+    size_t max_out) {
+  if (private_key_operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  ssl_private_key_result_t result;
+  if (!private_key_operation_->Finish(out, out_length, max_out, &result)) {
+    return ssl_private_key_retry;
+  }
+  private_key_operation_->Release();
+  private_key_operation_ = nullptr;
+  return result;
+}
+
 void SSLFilter::GetSelectedProtocol(Dart_NativeArguments args) {
   const uint8_t* protocol;
   unsigned length;
@@ -653,6 +893,12 @@ void SSLFilter::Renegotiate(bool use_session_cache,
 }
 
 void SSLFilter::FreeResources() {
+  if (private_key_operation_ != nullptr) {
+    // The worker keeps its own reference until it is done.
+    private_key_operation_->set_reply_port(ILLEGAL_PORT);
+    private_key_operation_->Release();
+    private_key_operation_ = nullptr;
+  }
   if (ssl_ != NULL) {
     SSL_free(ssl_);
     ssl_ = NULL;
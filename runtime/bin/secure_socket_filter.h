@@ -38,6 +38,8 @@ class X509TrustState {
   DISALLOW_COPY_AND_ASSIGN(X509TrustState);
 };
 
+class PrivateKeyOperation;
+
 class SSLFilter : public ReferenceCounted<SSLFilter> {
  public:
   static void Init();
@@ -120,10 +122,23 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
     return trust_evaluate_reply_port_;
   }
 
+  // Used by the private key method installed on server connections to run
+  // handshake signatures and decryptions on the thread pool.
+  ssl_private_key_result_t StartPrivateKeyOperation(uint16_t algorithm,
+                                                    bool is_decrypt,
+                                                    const uint8_t* in,
+                                                    size_t in_length,
+                                                    size_t max_out);
+  ssl_private_key_result_t CompletePrivateKeyOperation(uint8_t* out,
+                                                       size_t* out_length,
+                                                       size_t max_out);
+
  private:
   static const intptr_t kInternalBIOSize;
   static bool library_initialized_;
   static Mutex* mutex_;  // To protect library initialization.
+  // Native port, handled concurrently, on which private key operations run.
+  static Dart_Port private_key_port_;
 
   SSL* ssl_;
   BIO* socket_side_;
@@ -145,6 +160,7 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
 
   Dart_Port reply_port_ = ILLEGAL_PORT;
   Dart_Port trust_evaluate_reply_port_ = ILLEGAL_PORT;
+  PrivateKeyOperation* private_key_operation_ = nullptr;
 
   static bool IsBufferEncrypted(int i) {
     return static_cast<BufferIndex>(i) >= kFirstEncrypted;
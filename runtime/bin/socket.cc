@@ -25,6 +25,7 @@ namespace bin {
 static const int kSocketIdNativeField = 0;
 
 ListeningSocketRegistry* globalTcpListeningSocketRegistry = nullptr;
+HostLookupCache* globalHostLookupCache = nullptr;
 
 bool Socket::short_socket_read_ = false;
 bool Socket::short_socket_write_ = false;
@@ -43,6 +44,88 @@ void ListeningSocketRegistry::Cleanup() {
   globalTcpListeningSocketRegistry = nullptr;
 }
 
+void HostLookupCache::Initialize() {
+  ASSERT(globalHostLookupCache == nullptr);
+  globalHostLookupCache = new HostLookupCache();
+}
+
+HostLookupCache* HostLookupCache::Instance() {
+  return globalHostLookupCache;
+}
+
+void HostLookupCache::Cleanup() {
+  delete globalHostLookupCache;
+  globalHostLookupCache = nullptr;
+}
+
+HostLookupCache::~HostLookupCache() {
+  while (entries_.length() > 0) {
+    RemoveAt(entries_.length() - 1);
+  }
+}
+
+AddressList<SocketAddress>* HostLookupCache::Lookup(const char* host,
+                                                    int type) {
+  MutexLocker ml(&mutex_);
+  const int64_t now = TimerUtils::GetCurrentMonotonicMillis();
+  for (intptr_t i = 0; i < entries_.length(); i++) {
+    const Entry& entry = entries_[i];
+    if ((entry.type != type) || (strcmp(entry.host, host) != 0)) {
+      continue;
+    }
+    if (entry.expiry <= now) {
+      RemoveAt(i);
+      return nullptr;
+    }
+    AddressList<SocketAddress>* addresses =
+        new AddressList<SocketAddress>(entry.count);
+    for (intptr_t j = 0; j < entry.count; j++) {
+      addresses->SetAt(j, new SocketAddress(&entry.addresses[j].addr));
+    }
+    return addresses;
+  }
+  return nullptr;
+}
+
+void HostLookupCache::Add(const char* host,
+                          int type,
+                          const AddressList<SocketAddress>& addresses) {
+  MutexLocker ml(&mutex_);
+  const int64_t now = TimerUtils::GetCurrentMonotonicMillis();
+  // Drop expired entries and any older result for the same query. Entries
+  // are appended, so the first one is the oldest.
+  for (intptr_t i = entries_.length() - 1; i >= 0; i--) {
+    const Entry& entry = entries_[i];
+    if ((entry.expiry <= now) ||
+        ((entry.type == type) && (strcmp(entry.host, host) == 0))) {
+      RemoveAt(i);
+    }
+  }
+  if (entries_.length() == kMaxEntries) {
+    RemoveAt(0);
+  }
+  Entry entry;
+  entry.host = Utils::StrDup(host);
+  entry.type = type;
+  entry.expiry = now + kLifetimeMillis;
+  entry.count = addresses.count();
+  entry.addresses =
+      reinterpret_cast<RawAddr*>(malloc(entry.count * sizeof(RawAddr)));
+  for (intptr_t i = 0; i < entry.count; i++) {
+    entry.addresses[i] = addresses.GetAt(i)->addr();
+  }
+  entries_.Add(entry);
+}
+
+void HostLookupCache::RemoveAt(intptr_t index) {
+  free(entries_[index].host);
+  free(entries_[index].addresses);
+  for (intptr_t i = index + 1; i < entries_.length(); i++) {
+    entries_[i - 1] = entries_[i];
+  }
+  entries_.RemoveLast();
+}
+
 ListeningSocketRegistry::OSSocket* ListeningSocketRegistry::LookupByPort(
     intptr_t port) {
   SimpleHashMap::Entry* entry = sockets_by_port_.Lookup(
@@ -527,38 +610,33 @@ void FUNCTION_NAME(Socket_Read)(Dart_NativeArguments args) {
     if (Socket::short_socket_read()) {
       length = (length + 1) / 2;
     }
-    uint8_t* buffer = nullptr;
-    Dart_Handle result = IOBuffer::Allocate(length, &buffer);
-    if (Dart_IsNull(result)) {
+    // Read into raw storage and only create the Dart object once the number
+    // of bytes read is known. A short read then shrinks the storage in place
+    // rather than allocating and copying into a second buffer.
+    uint8_t* buffer = IOBuffer::Allocate(length);
+    if (buffer == nullptr) {
       Dart_ThrowException(DartUtils::NewDartOSError());
     }
-    if (Dart_IsError(result)) {
-      Dart_PropagateError(result);
-    }
-    ASSERT(buffer != nullptr);
     intptr_t bytes_read =
         SocketBase::Read(socket->fd(), buffer, length, SocketBase::kAsync);
-    if (bytes_read == length) {
-      Dart_SetReturnValue(args, result);
-    } else if (bytes_read > 0) {
-      uint8_t* new_buffer = nullptr;
-      Dart_Handle new_result = IOBuffer::Allocate(bytes_read, &new_buffer);
-      if (Dart_IsNull(new_result)) {
-        Dart_ThrowException(DartUtils::NewDartOSError());
-      }
-      if (Dart_IsError(new_result)) {
-        Dart_PropagateError(new_result);
+    if (bytes_read > 0) {
+      if (bytes_read < length) {
+        uint8_t* new_buffer = IOBuffer::Reallocate(buffer, bytes_read);
+        if (new_buffer != nullptr) {
+          buffer = new_buffer;
+        }
       }
-      ASSERT(new_buffer != nullptr);
-      memmove(new_buffer, buffer, bytes_read);
-      Dart_SetReturnValue(args, new_result);
+      Dart_SetReturnValue(args, IOBuffer::Wrap(buffer, bytes_read));
     } else if (bytes_read == 0) {
+      IOBuffer::Free(buffer);
       // On MacOS when reading from a tty Ctrl-D will result in reading one
       // less byte then reported as available.
       Dart_SetReturnValue(args, Dart_Null());
     } else {
       ASSERT(bytes_read == -1);
-      Dart_ThrowException(DartUtils::NewDartOSError());
+      Dart_Handle error = DartUtils::NewDartOSError();
+      IOBuffer::Free(buffer);
+      Dart_ThrowException(error);
     }
   } else {
     OSError os_error(-1, "Invalid argument", OSError::kUnknown);
@@ -566,33 +644,73 @@ void FUNCTION_NAME(Socket_Read)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(Socket_ReadInto)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  Dart_Handle buffer_obj = Dart_GetNativeArgument(args, 1);
+  intptr_t offset = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 2));
+  intptr_t length = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 3));
+  if (Socket::short_socket_read()) {
+    length = (length + 1) / 2;
+  }
+  Dart_TypedData_Type type;
+  uint8_t* buffer = nullptr;
+  intptr_t len;
+  Dart_Handle result = Dart_TypedDataAcquireData(
+      buffer_obj, &type, reinterpret_cast<void**>(&buffer), &len);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  ASSERT((offset >= 0) && (length >= 0) && ((offset + length) <= len));
+  intptr_t bytes_read = SocketBase::Read(socket->fd(), buffer + offset, length,
+                                         SocketBase::kAsync);
+  if (bytes_read >= 0) {
+    Dart_TypedDataReleaseData(buffer_obj);
+    Dart_SetIntegerReturnValue(args, bytes_read);
+  } else {
+    // Extract OSError before we release data, as it may override the error.
+    Dart_Handle error;
+    {
+      OSError os_error;
+      Dart_TypedDataReleaseData(buffer_obj);
+      error = DartUtils::NewDartOSError(&os_error);
+    }
+    Dart_ThrowException(error);
+  }
+}
+
 void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
-  // TODO(sgjesse): Use a MTU value here. Only the loopback adapter can
-  // handle 64k datagrams.
-  const int kReceiveBufferLen = 65536;
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
 
-  // Ensure that a receive buffer for the UDP socket exists.
+  // Ensure that a receive batch for the UDP socket exists.
   ASSERT(socket != nullptr);
-  uint8_t* recv_buffer = socket->udp_receive_buffer();
-  if (recv_buffer == nullptr) {
-    recv_buffer = reinterpret_cast<uint8_t*>(malloc(kReceiveBufferLen));
-    socket->set_udp_receive_buffer(recv_buffer);
+  UdpReceiveBatch* batch = socket->udp_receive_batch();
+  if (batch == nullptr) {
+    batch = new UdpReceiveBatch();
+    socket->set_udp_receive_batch(batch);
   }
 
-  // Read data into the buffer.
+  // Hand out datagrams left over from the last batched receive before
+  // reading more.
+  if (batch->IsEmpty()) {
+    const intptr_t received = batch->Receive(socket->fd());
+    if (received == 0) {
+      Dart_SetReturnValue(args, Dart_Null());
+      return;
+    }
+    if (received < 0) {
+      ASSERT(received == -1);
+      Dart_ThrowException(DartUtils::NewDartOSError());
+    }
+  }
+  intptr_t bytes_read;
   RawAddr addr;
-  const intptr_t bytes_read = SocketBase::RecvFrom(
-      socket->fd(), recv_buffer, kReceiveBufferLen, &addr, SocketBase::kAsync);
+  const uint8_t* recv_buffer = batch->Next(&bytes_read, &addr);
   if (bytes_read == 0) {
     Dart_SetReturnValue(args, Dart_Null());
     return;
   }
-  if (bytes_read < 0) {
-    ASSERT(bytes_read == -1);
-    Dart_ThrowException(DartUtils::NewDartOSError());
-  }
 
   // Datagram data read. Copy into buffer of the exact size,
   ASSERT(bytes_read >= 0);
@@ -701,6 +819,123 @@ void FUNCTION_NAME(Socket_WriteList)(Dart_NativeArguments args) {
   }
 }
 
+static void ReleaseAcquiredBuffers(const Dart_Handle* buffers,
+                                   const intptr_t* first_use,
+                                   intptr_t count) {
+  for (intptr_t i = 0; i < count; i++) {
+    if (first_use[i] == i) {
+      Dart_TypedDataReleaseData(buffers[i]);
+    }
+  }
+}
+
+void FUNCTION_NAME(Socket_WriteVector)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  Dart_Handle buffers_obj = Dart_GetNativeArgument(args, 1);
+  Dart_Handle starts_obj = Dart_GetNativeArgument(args, 2);
+  Dart_Handle ends_obj = Dart_GetNativeArgument(args, 3);
+  intptr_t count = 0;
+  Dart_Handle result = Dart_ListLength(buffers_obj, &count);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  ASSERT((count > 0) && (count <= SocketBase::kMaxWriteChunks));
+
+  // Fetch all arguments before acquiring any data, as nothing may be
+  // allocated while typed data is acquired. The same buffer may appear more
+  // than once; it is only acquired for its first occurrence.
+  Dart_Handle buffers[SocketBase::kMaxWriteChunks];
+  intptr_t starts[SocketBase::kMaxWriteChunks];
+  intptr_t ends[SocketBase::kMaxWriteChunks];
+  intptr_t first_use[SocketBase::kMaxWriteChunks];
+  for (intptr_t i = 0; i < count; i++) {
+    buffers[i] = ThrowIfError(Dart_ListGetAt(buffers_obj, i));
+    starts[i] = DartUtils::GetIntptrValue(Dart_ListGetAt(starts_obj, i));
+    ends[i] = DartUtils::GetIntptrValue(Dart_ListGetAt(ends_obj, i));
+    first_use[i] = i;
+    for (intptr_t j = 0; j < i; j++) {
+      if (Dart_IdentityEquals(buffers[i], buffers[j])) {
+        first_use[i] = first_use[j];
+        break;
+      }
+    }
+  }
+
+  uint8_t* data[SocketBase::kMaxWriteChunks];
+  SocketBase::WriteChunk chunks[SocketBase::kMaxWriteChunks];
+  for (intptr_t i = 0; i < count; i++) {
+    if (first_use[i] == i) {
+      Dart_TypedData_Type type;
+      intptr_t len;
+      result = Dart_TypedDataAcquireData(
+          buffers[i], &type, reinterpret_cast<void**>(&data[i]), &len);
+      if (Dart_IsError(result)) {
+        ReleaseAcquiredBuffers(buffers, first_use, i);
+        Dart_PropagateError(result);
+      }
+      ASSERT(ends[i] <= len);
+    } else {
+      data[i] = data[first_use[i]];
+    }
+    ASSERT((0 <= starts[i]) && (starts[i] <= ends[i]));
+    chunks[i].buffer = data[i] + starts[i];
+    chunks[i].length = ends[i] - starts[i];
+  }
+
+  bool short_write = false;
+  intptr_t write_count = count;
+  if (Socket::short_socket_write()) {
+    // Only write half of the first chunk.
+    if (chunks[0].length > 1) {
+      short_write = true;
+    }
+    chunks[0].length = (chunks[0].length + 1) / 2;
+    write_count = 1;
+  }
+  intptr_t bytes_written = SocketBase::WriteVector(
+      socket->fd(), chunks, write_count, SocketBase::kAsync);
+  if (bytes_written >= 0) {
+    ReleaseAcquiredBuffers(buffers, first_use, count);
+    // A forced short write is reported as a negative number of bytes, as
+    // for Socket_WriteList.
+    Dart_SetIntegerReturnValue(args,
+                               short_write ? -bytes_written : bytes_written);
+  } else {
+    // Extract OSError before we release data, as it may override the error.
+    Dart_Handle error;
+    {
+      OSError os_error;
+      ReleaseAcquiredBuffers(buffers, first_use, count);
+      error = DartUtils::NewDartOSError(&os_error);
+    }
+    Dart_ThrowException(error);
+  }
+}
+
+void FUNCTION_NAME(Socket_SendFile)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  File* file = reinterpret_cast<File*>(
+      DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 1)));
+  int64_t offset = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 2), 0, kMaxInt64);
+  intptr_t length = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 3));
+  ASSERT(file != nullptr);
+  // The pointer was retained when it was passed from Dart.
+  RefCntReleaseScope<File> rs(file);
+  if (file->IsClosed()) {
+    OSError os_error(-1, "File closed", OSError::kUnknown);
+    Dart_ThrowException(DartUtils::NewDartOSError(&os_error));
+  }
+  intptr_t bytes_written = SocketBase::SendFile(
+      socket->fd(), file->GetFD(), offset, length, SocketBase::kAsync);
+  if (bytes_written < 0) {
+    Dart_ThrowException(DartUtils::NewDartOSError());
+  }
+  Dart_SetIntegerReturnValue(args, bytes_written);
+}
+
 void FUNCTION_NAME(Socket_SendTo)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
@@ -879,17 +1114,29 @@ void FUNCTION_NAME(ServerSocket_CreateUnixDomainBindListen)(
 #endif  // defined(HOST_OS_WINDOWS)
 }
 
-void FUNCTION_NAME(ServerSocket_Accept)(Dart_NativeArguments args) {
+void FUNCTION_NAME(ServerSocket_AcceptBatch)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
-  intptr_t new_socket = ServerSocket::Accept(socket->fd());
-  if (new_socket >= 0) {
-    Socket::SetSocketIdNativeField(Dart_GetNativeArgument(args, 1), new_socket,
-                                   Socket::kFinalizerNormal);
-    Dart_SetReturnValue(args, Dart_True());
-  } else {
-    Dart_SetReturnValue(args, Dart_False());
+  Dart_Handle fds = Dart_GetNativeArgument(args, 1);
+  intptr_t length = 0;
+  ThrowIfError(Dart_ListLength(fds, &length));
+  // Drain pending connections until the backlog is empty or the list is
+  // full, so that a burst costs one call instead of one per connection.
+  intptr_t count = 0;
+  while (count < length) {
+    intptr_t new_socket = ServerSocket::Accept(socket->fd());
+    if (new_socket < 0) {
+      break;
+    }
+    Dart_Handle result =
+        Dart_ListSetAt(fds, count, Dart_NewInteger(new_socket));
+    if (Dart_IsError(result)) {
+      SocketBase::Close(new_socket);
+      Dart_PropagateError(result);
+    }
+    count++;
   }
+  Dart_SetIntegerReturnValue(args, count);
 }
 
 CObject* Socket::LookupRequest(const CObjectArray& request) {
@@ -899,8 +1146,16 @@ CObject* Socket::LookupRequest(const CObjectArray& request) {
     CObjectInt32 type(request[1]);
     CObject* result = nullptr;
     OSError* os_error = nullptr;
+    HostLookupCache* cache = HostLookupCache::Instance();
     AddressList<SocketAddress>* addresses =
-        SocketBase::LookupAddress(host.CString(), type.Value(), &os_error);
+        cache->Lookup(host.CString(), type.Value());
+    if (addresses == nullptr) {
+      addresses =
+          SocketBase::LookupAddress(host.CString(), type.Value(), &os_error);
+      if (addresses != nullptr) {
+        cache->Add(host.CString(), type.Value(), *addresses);
+      }
+    }
     if (addresses != nullptr) {
       CObjectArray* array =
           new CObjectArray(CObject::NewArray(addresses->count() + 1));
@@ -1250,6 +1505,12 @@ void FUNCTION_NAME(Socket_AvailableDatagram)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
   ASSERT(socket != nullptr);
+  UdpReceiveBatch* batch = socket->udp_receive_batch();
+  if ((batch != nullptr) && !batch->IsEmpty()) {
+    // Datagrams from the last batched receive are still pending.
+    Dart_SetBooleanReturnValue(args, true);
+    return;
+  }
   // Ensure that a receive buffer for peeking the UDP socket exists.
   uint8_t recv_buffer[kReceiveBufferLen];
   bool available = SocketBase::AvailableDatagram(socket->fd(), recv_buffer,
@@ -12,11 +12,60 @@
 #include "bin/socket_base.h"
 #include "bin/thread.h"
 #include "bin/utils.h"
+#include "platform/growable_array.h"
 #include "platform/hashmap.h"
 
 namespace dart {
 namespace bin {
 
+// Datagrams received by one SocketBase::RecvFromBatch call on a UDP socket
+// and handed to Dart one at a time by Socket_RecvFrom.
+class UdpReceiveBatch {
+ public:
+  // TODO(sgjesse): Use a MTU value here. Only the loopback adapter can
+  // handle 64k datagrams.
+  static const intptr_t kMaxDatagramSize = 65536;
+
+  UdpReceiveBatch()
+      : buffer_(reinterpret_cast<uint8_t*>(
+            malloc(SocketBase::kMaxReceiveBatch * kMaxDatagramSize))),
+        count_(0),
+        next_(0) {}
+  ~UdpReceiveBatch() { free(buffer_); }
+
+  bool IsEmpty() const { return next_ == count_; }
+
+  // Refills the batch from [fd]. Returns the result of RecvFromBatch.
+  intptr_t Receive(intptr_t fd) {
+    ASSERT(IsEmpty());
+    const intptr_t received = SocketBase::RecvFromBatch(
+        fd, buffer_, kMaxDatagramSize, SocketBase::kMaxReceiveBatch,
+        lengths_, addrs_, SocketBase::kAsync);
+    count_ = (received > 0) ? received : 0;
+    next_ = 0;
+    return received;
+  }
+
+  // Takes the next datagram of the batch. The data stays valid until the
+  // next call to Receive.
+  const uint8_t* Next(intptr_t* length, RawAddr* addr) {
+    ASSERT(!IsEmpty());
+    const intptr_t i = next_++;
+    *length = lengths_[i];
+    *addr = addrs_[i];
+    return buffer_ + i * kMaxDatagramSize;
+  }
+
+ private:
+  uint8_t* buffer_;
+  intptr_t count_;
+  intptr_t next_;
+  intptr_t lengths_[SocketBase::kMaxReceiveBatch];
+  RawAddr addrs_[SocketBase::kMaxReceiveBatch];
+
+  DISALLOW_COPY_AND_ASSIGN(UdpReceiveBatch);
+};
+
 // TODO(bkonyi): Socket should also inherit from SocketBase once it is
 // refactored to use instance methods when possible.
 
@@ -63,8 +112,10 @@ class Socket : public ReferenceCounted<Socket> {
   Dart_Port port() const { return port_; }
   void set_port(Dart_Port port) { port_ = port; }
 
-  uint8_t* udp_receive_buffer() const { return udp_receive_buffer_; }
-  void set_udp_receive_buffer(uint8_t* buffer) { udp_receive_buffer_ = buffer; }
+  UdpReceiveBatch* udp_receive_batch() const { return udp_receive_batch_; }
+  void set_udp_receive_batch(UdpReceiveBatch* batch) {
+    udp_receive_batch_ = batch;
+  }
 
   static bool Initialize();
 
@@ -115,8 +166,8 @@ class Socket : public ReferenceCounted<Socket> {
  private:
   ~Socket() {
     ASSERT(fd_ == kClosedFd);
-    free(udp_receive_buffer_);
-    udp_receive_buffer_ = NULL;
+    delete udp_receive_batch_;
+    udp_receive_batch_ = NULL;
   }
 
   static const int kClosedFd = -1;
@@ -127,7 +178,7 @@ class Socket : public ReferenceCounted<Socket> {
   intptr_t fd_;
   Dart_Port isolate_port_;
   Dart_Port port_;
-  uint8_t* udp_receive_buffer_;
+  UdpReceiveBatch* udp_receive_batch_;
 
   friend class ReferenceCounted<Socket>;
   DISALLOW_COPY_AND_ASSIGN(Socket);
@@ -162,11 +213,55 @@ class ServerSocket {
   DISALLOW_IMPLICIT_CONSTRUCTORS(ServerSocket);
 };
 
+// A short-lived, process-wide cache of successful host lookups, so that
+// clients resolving the same host over and over do not each block an IO
+// service thread in getaddrinfo. getaddrinfo does not report record TTLs,
+// so entries expire after a fixed lifetime that is short enough for DNS
+// changes to take effect without noticeable delay.
+class HostLookupCache {
+ public:
+  static const int64_t kLifetimeMillis = 1000;
+  static const intptr_t kMaxEntries = 64;
+
+  HostLookupCache() : entries_(), mutex_() {}
+  ~HostLookupCache();
+
+  static void Initialize();
+  static HostLookupCache* Instance();
+  static void Cleanup();
+
+  // Returns a new copy of the addresses cached for `host` and `type`, or
+  // nullptr if there are none or they have expired.
+  AddressList<SocketAddress>* Lookup(const char* host, int type);
+
+  // Caches a copy of `addresses` as the result for `host` and `type`.
+  void Add(const char* host,
+           int type,
+           const AddressList<SocketAddress>& addresses);
+
+ private:
+  struct Entry {
+    char* host;
+    int type;
+    int64_t expiry;
+    intptr_t count;
+    RawAddr* addresses;
+  };
+
+  void RemoveAt(intptr_t index);
+
+  MallocGrowableArray<Entry> entries_;
+  Mutex mutex_;
+
+  DISALLOW_COPY_AND_ASSIGN(HostLookupCache);
+};
+
 class ListeningSocketRegistry {
  public:
   ListeningSocketRegistry()
-      : sockets_by_port_(SameIntptrValue, kInitialSocketsCount),
-        sockets_by_fd_(SameIntptrValue, kInitialSocketsCount),
+      : sockets_by_port_(&SimpleHashMap::SamePointerValue,
+                         kInitialSocketsCount),
+        sockets_by_fd_(&SimpleHashMap::SamePointerValue, kInitialSocketsCount),
         unix_domain_sockets_(nullptr),
         mutex_() {}
 
@@ -286,10 +381,6 @@ class ListeningSocketRegistry {
     return NULL;
   }
 
-  static bool SameIntptrValue(void* key1, void* key2) {
-    return reinterpret_cast<intptr_t>(key1) == reinterpret_cast<intptr_t>(key2);
-  }
-
   static uint32_t GetHashmapHashFromIntptr(intptr_t i) {
     return static_cast<uint32_t>((i + 1) & 0xFFFFFFFF);
   }
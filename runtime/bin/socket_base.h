@@ -161,6 +161,22 @@ class SocketBase : public AllStatic {
     kAsync,
   };
 
+  // A contiguous piece of data passed to WriteVector.
+  struct WriteChunk {
+    const void* buffer;
+    intptr_t length;
+  };
+
+  // The maximum number of chunks passed to a single WriteVector call.
+  static const intptr_t kMaxWriteChunks = 16;
+
+  // The maximum number of datagrams received by a single RecvFromBatch call.
+#if defined(HOST_OS_LINUX)
+  static const intptr_t kMaxReceiveBatch = 8;
+#else
+  static const intptr_t kMaxReceiveBatch = 1;
+#endif
+
   // TODO(dart:io): Convert these to instance methods where possible.
   static bool Initialize();
   static intptr_t Available(intptr_t fd);
@@ -172,6 +188,22 @@ class SocketBase : public AllStatic {
                         const void* buffer,
                         intptr_t num_bytes,
                         SocketOpKind sync);
+  // Sends up to [num_bytes] bytes of the file [file_fd], starting at
+  // [offset], to the socket [fd] without copying them through user space.
+  // Returns the number of bytes sent or -1 on error. Fails with a "not
+  // supported" error where the platform has no such primitive.
+  static intptr_t SendFile(intptr_t fd,
+                           intptr_t file_fd,
+                           int64_t offset,
+                           intptr_t num_bytes,
+                           SocketOpKind sync);
+  // Writes [count] chunks in order, using a single system call where the
+  // platform supports it. Returns the total number of bytes written, which
+  // may end in the middle of a chunk, or -1 on error.
+  static intptr_t WriteVector(intptr_t fd,
+                              const WriteChunk* chunks,
+                              intptr_t count,
+                              SocketOpKind sync);
   // Send data on a socket. The port to send to is specified in the port
   // component of the passed RawAddr structure. The RawAddr structure is only
   // used for datagram sockets.
@@ -185,6 +217,17 @@ class SocketBase : public AllStatic {
                            intptr_t num_bytes,
                            RawAddr* addr,
                            SocketOpKind sync);
+  // Receives up to [count] datagrams, using a single system call where the
+  // platform supports it. Datagram i is stored at [buffer] + i * [num_bytes],
+  // with its length in lengths[i] and its sender in addrs[i]. Returns the
+  // number of datagrams received, 0 if none are available, or -1 on error.
+  static intptr_t RecvFromBatch(intptr_t fd,
+                                void* buffer,
+                                intptr_t num_bytes,
+                                intptr_t count,
+                                intptr_t* lengths,
+                                RawAddr* addrs,
+                                SocketOpKind sync);
   static bool AvailableDatagram(intptr_t fd, void* buffer, intptr_t num_bytes);
   // Returns true if the given error-number is because the system was not able
   // to bind the socket to a specific IP.
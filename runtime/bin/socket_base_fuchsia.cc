@@ -124,6 +124,22 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return -1;
 }
 
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   void* buffer,
+                                   intptr_t num_bytes,
+                                   intptr_t count,
+                                   intptr_t* lengths,
+                                   RawAddr* addrs,
+                                   SocketOpKind sync) {
+  ASSERT((count > 0) && (count <= kMaxReceiveBatch));
+  const intptr_t read_bytes = RecvFrom(fd, buffer, num_bytes, &addrs[0], sync);
+  if (read_bytes <= 0) {
+    return read_bytes;
+  }
+  lengths[0] = read_bytes;
+  return 1;
+}
+
 bool SocketBase::AvailableDatagram(intptr_t fd,
                                    void* buffer,
                                    intptr_t num_bytes) {
@@ -154,6 +170,35 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              intptr_t num_bytes,
+                              SocketOpKind sync) {
+  errno = ENOSYS;
+  return -1;
+}
+
+intptr_t SocketBase::WriteVector(intptr_t fd,
+                                 const WriteChunk* chunks,
+                                 intptr_t count,
+                                 SocketOpKind sync) {
+  ASSERT((count > 0) && (count <= kMaxWriteChunks));
+  // No vectored write here; write chunk by chunk until one is short.
+  intptr_t total = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    intptr_t written = Write(fd, chunks[i].buffer, chunks[i].length, sync);
+    if (written < 0) {
+      return (total > 0) ? total : written;
+    }
+    total += written;
+    if (written < chunks[i].length) {
+      break;
+    }
+  }
+  return total;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
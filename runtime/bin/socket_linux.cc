@@ -22,7 +22,7 @@ Socket::Socket(intptr_t fd)
       fd_(fd),
       isolate_port_(Dart_GetMainPortId()),
       port_(ILLEGAL_PORT),
-      udp_receive_buffer_(NULL) {}
+      udp_receive_batch_(NULL) {}
 
 void Socket::CloseFd() {
   SetClosedFd();
@@ -252,7 +252,10 @@ intptr_t ServerSocket::Accept(intptr_t fd) {
   intptr_t socket;
   struct sockaddr clientaddr;
   socklen_t addrlen = sizeof(clientaddr);
-  socket = TEMP_FAILURE_RETRY(accept(fd, &clientaddr, &addrlen));
+  // accept4 sets the flags atomically, saving two fcntl calls per
+  // connection.
+  socket = TEMP_FAILURE_RETRY(
+      accept4(fd, &clientaddr, &addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC));
   if (socket == -1) {
     if (IsTemporaryAcceptError(errno)) {
       // We need to signal to the caller that this is actually not an
@@ -261,15 +264,6 @@ intptr_t ServerSocket::Accept(intptr_t fd) {
       ASSERT(kTemporaryFailure != -1);
       socket = kTemporaryFailure;
     }
-  } else {
-    if (!FDUtils::SetCloseOnExec(socket)) {
-      FDUtils::SaveErrorAndClose(socket);
-      return -1;
-    }
-    if (!FDUtils::SetNonBlocking(socket)) {
-      FDUtils::SaveErrorAndClose(socket);
-      return -1;
-    }
   }
   return socket;
 }
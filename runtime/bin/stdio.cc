@@ -6,6 +6,7 @@
 
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
+#include "bin/file.h"
 #include "bin/utils.h"
 
 #include "include/dart_api.h"
@@ -44,6 +45,8 @@ void FUNCTION_NAME(Stdin_ReadByte)(Dart_NativeArguments args) {
   if (!GetIntptrArgument(args, 0, &fd)) {
     return;
   }
+  // Show any buffered prompt before blocking on input.
+  StdioBuffer::Flush();
   int byte = -1;
   if (Stdin::ReadByte(fd, &byte)) {
     Dart_SetIntegerReturnValue(args, byte);
@@ -573,6 +573,35 @@ DART_EXPORT void Dart_UpdateFinalizableExternalSize(
     Dart_Handle strong_ref_to_object,
     intptr_t external_allocation_size);
 
+/**
+ * Requests that the callback of the given weak persistent [object] handle is
+ * run on a background thread after the garbage collection that found the
+ * object unreachable, instead of during that garbage collection.
+ *
+ * A deferred callback has no current isolate group and must not call into
+ * the VM with any Dart_* functions. The VM deletes the handle before the
+ * callback runs, so all references to the handle are invalid once the object
+ * has become unreachable, and the callback must not delete it.
+ *
+ * Embedders holding many handles for native resources can use this to keep
+ * the callbacks out of garbage collection pauses. Callbacks that are not
+ * deferred keep running one at a time during garbage collection.
+ *
+ * Requires there to be a current isolate group.
+ */
+DART_EXPORT void Dart_DeferWeakPersistentHandleFinalizer(
+    Dart_WeakPersistentHandle object);
+
+/**
+ * Like Dart_DeferWeakPersistentHandleFinalizer, for a finalizable handle.
+ *
+ * The caller has to provide the actual Dart object the handle was created from
+ * to prove the object (and therefore the finalizable handle) is still alive.
+ */
+DART_EXPORT void Dart_DeferFinalizableHandleFinalizer(
+    Dart_FinalizableHandle object,
+    Dart_Handle strong_ref_to_object);
+
 /*
  * ==========================
  * Initialization and Globals
@@ -602,7 +631,7 @@ typedef struct {
  * for each part.
  */
 
-#define DART_FLAGS_CURRENT_VERSION (0x0000000c)
+#define DART_FLAGS_CURRENT_VERSION (0x0000000d)
 
 typedef struct {
   int32_t version;
@@ -615,6 +644,7 @@ typedef struct {
   bool copy_parent_code;
   bool null_safety;
   bool is_system_isolate;
+  bool is_latency_sensitive;
 } Dart_IsolateFlags;
 
 /**
@@ -1127,6 +1157,30 @@ DART_EXPORT void* Dart_CurrentIsolateGroupData();
  */
 DART_EXPORT void* Dart_IsolateGroupData(Dart_Isolate isolate);
 
+/**
+ * Copies the object graph reachable from [object] into memory shared by all
+ * isolate groups and publishes the copy under [name].
+ *
+ * The graph may only contain null, booleans, numbers, strings and lists
+ * without type arguments. Lists are copied as unmodifiable lists. Shared
+ * objects are never collected and stay alive until the VM shuts down.
+ *
+ * Requires there to be a current isolate.
+ *
+ * \return The shared copy, or an error handle if the graph cannot be shared
+ *   or [name] is already published.
+ */
+DART_EXPORT Dart_Handle Dart_PublishSharedImmutable(const char* name,
+                                                    Dart_Handle object);
+
+/**
+ * Returns the object published under [name] by any isolate group with
+ * Dart_PublishSharedImmutable, or null if there is none.
+ *
+ * Requires there to be a current isolate.
+ */
+DART_EXPORT Dart_Handle Dart_LookupSharedImmutable(const char* name);
+
 /**
  * Returns the debugging name for the current isolate.
  *
@@ -1196,6 +1250,30 @@ DART_EXPORT void Dart_NotifyIdle(int64_t deadline);
  */
 DART_EXPORT void Dart_NotifyLowMemory();
 
+/**
+ * A callback reporting the memory used by the process and the limit it
+ * should stay below, e.g., one imposed by a container.
+ *
+ * The callback is invoked after old generation garbage collections, on the
+ * thread performing the collection, and must not call into the VM.
+ *
+ * \return false if no limit is currently known.
+ */
+typedef bool (*Dart_MemoryPressureCallback)(intptr_t* used_bytes,
+                                            intptr_t* limit_bytes);
+
+/**
+ * Installs a callback the VM samples to tighten its old generation growth
+ * limit as the process approaches an external memory limit, and to collect
+ * less often while there is plenty of headroom. Replaces reading the cgroup
+ * limits requested with --heap_cgroup_limits. Passing NULL removes the
+ * callback.
+ *
+ * Does not require a current isolate. Only valid after calling Dart_Initialize.
+ */
+DART_EXPORT void Dart_SetMemoryPressureCallback(
+    Dart_MemoryPressureCallback callback);
+
 /**
  * Starts the CPU sampling profiler.
  */
@@ -2152,6 +2230,38 @@ DART_EXPORT Dart_Handle Dart_StringToUTF8(Dart_Handle str,
                                           uint8_t** utf8_array,
                                           intptr_t* length);
 
+/**
+ * Gets the length of the UTF-8 encoded representation of a string.
+ *
+ * \param str A string.
+ * \param length Returns the number of bytes needed to hold the string
+ *   encoded as UTF-8, see Dart_CopyUTF8EncodingOfString.
+ *
+ * \return A valid handle if no error occurs during the operation.
+ */
+DART_EXPORT Dart_Handle Dart_StringUTF8Length(Dart_Handle str,
+                                              intptr_t* length);
+
+/**
+ * Copies the UTF-8 encoded representation of a string into a buffer
+ * allocated by the caller, without allocating in the current scope as
+ * Dart_StringToUTF8 does.
+ *
+ * Unpaired surrogates are converted as in Dart_StringToUTF8.
+ *
+ * \param str A string.
+ * \param utf8_array An array allocated by the caller, used to return the
+ *   UTF-8 code units of the string.
+ * \param length The length of utf8_array. It must be at least the length
+ *   returned by Dart_StringUTF8Length, otherwise an error is returned and
+ *   nothing is copied.
+ *
+ * \return A valid handle if no error occurs during the operation.
+ */
+DART_EXPORT Dart_Handle Dart_CopyUTF8EncodingOfString(Dart_Handle str,
+                                                      uint8_t* utf8_array,
+                                                      intptr_t length);
+
 /**
  * Gets the data corresponding to the string object. This function returns
  * the data only for Latin-1 (ISO-8859-1) string objects. For all other
@@ -2282,6 +2392,24 @@ DART_EXPORT Dart_Handle Dart_NewListOfTypeFilled(Dart_Handle element_type,
                                                  Dart_Handle fill_object,
                                                  intptr_t length);
 
+/**
+ * Returns a List<String> of the strings with the given UTF-8 encodings.
+ *
+ * This is equivalent to calling Dart_NewStringFromUTF8 for each string and
+ * storing the results in a new list, but enters the VM only once.
+ *
+ * \param utf8_arrays The UTF-8 encodings of the strings.
+ * \param lengths The lengths of the arrays in utf8_arrays.
+ * \param count The number of strings, which is the length of the list.
+ *
+ * \return The List object if no error occurs. Otherwise returns an error
+ *   handle, for instance if one of the arrays is not valid UTF-8.
+ */
+DART_EXPORT Dart_Handle
+Dart_NewListOfStringsFromUTF8(const uint8_t* const* utf8_arrays,
+                              const intptr_t* lengths,
+                              intptr_t count);
+
 /**
  * Gets the length of a List.
  *
@@ -2526,6 +2654,12 @@ DART_EXPORT Dart_Handle Dart_NewByteBuffer(Dart_Handle typed_data);
  *   not be acquired again before its release. This leads to undefined
  *   behavior.
  *
+ *   Until the release, garbage collection in the isolate group cannot
+ *   proceed unless the object is external typed data, or a view on external
+ *   typed data (see Dart_NewExternalTypedData), whose data never moves.
+ *   Native code that holds on to data for a long time should use external
+ *   typed data.
+ *
  * \return Success if the internal data address is acquired successfully.
  *   Otherwise, returns an error handle.
  */
@@ -3209,6 +3343,11 @@ Dart_SetDeferredLoadHandler(Dart_DeferredLoadHandler handler);
  * will eventually cause the corresponding `prefix.loadLibrary()` futures to
  * complete.
  *
+ * This may also be called before any `prefix.loadLibrary()` has requested the
+ * unit, so that an embedder can prefetch and load units it expects to be used
+ * soon, e.g. when idle, instead of on first use. The unit's parent (see
+ * Dart_LoadingUnitParent) must already be loaded.
+ *
  * Requires the current isolate to be the same current isolate during the
  * invocation of the Dart_DeferredLoadHandler.
  */
@@ -3226,6 +3365,8 @@ Dart_DeferredLoadComplete(intptr_t loading_unit_id,
  * trigger new load requests. If false, futures invocation will complete with
  * the same error.
  *
+ * Only a load requested through the Dart_DeferredLoadHandler can fail.
+ *
  * Requires the current isolate to be the same current isolate during the
  * invocation of the Dart_DeferredLoadHandler.
  */
@@ -3658,6 +3799,71 @@ DART_EXPORT bool Dart_IsServiceIsolate(Dart_Isolate isolate);
  */
 DART_EXPORT bool Dart_WriteProfileToTimeline(Dart_Port main_port, char** error);
 
+/**
+ * Aggregates the CPU samples of the current isolate into folded stacks: one
+ * "outer;...;inner count" line per distinct stack. This is the input format
+ * of flame graph and pprof conversion tools. Unlike the getCpuSamples
+ * service RPC, this does not need the VM service, so an embedder can collect
+ * profiles periodically, for example from a timer, with only the profiler
+ * enabled.
+ *
+ * Requires there to be a current isolate.
+ *
+ * \param time_origin_micros Only samples taken at or after this time are
+ *   included. Pass -1 to include all samples.
+ * \param time_extent_micros Only samples taken before time_origin_micros plus
+ *   this extent are included. Pass -1 to include all samples.
+ * \param profile Set to the folded stacks, which must be free()ed by caller.
+ * \param profile_length Set to the length of profile.
+ * \param error An optional error, must be free()ed by caller.
+ *
+ * \return Returns true if the profile was collected and false otherwise.
+ */
+DART_EXPORT bool Dart_GetProfileFoldedStacks(int64_t time_origin_micros,
+                                             int64_t time_extent_micros,
+                                             char** profile,
+                                             intptr_t* profile_length,
+                                             char** error);
+
+/**
+ * Collects garbage, then reports the live objects among the allocations
+ * sampled with --heap_sample_interval as folded stacks: one
+ * "outer;...;inner;Class bytes" line per allocation site and class, where
+ * bytes estimates the live memory allocated there. This finds what keeps
+ * growing without taking a full heap snapshot.
+ *
+ * Requires there to be a current isolate.
+ *
+ * \param profile Set to the folded stacks, which must be free()ed by caller.
+ * \param profile_length Set to the length of profile.
+ * \param error An optional error, must be free()ed by caller.
+ *
+ * \return Returns true if the profile was collected and false otherwise.
+ */
+DART_EXPORT bool Dart_GetHeapSampleFoldedStacks(char** profile,
+                                                intptr_t* profile_length,
+                                                char** error);
+
+/**
+ * Reports the basic blocks recorded with --code_coverage: one
+ * "uri:line:column hit" line per block, where hit is 1 if the block has run
+ * in any isolate of the current isolate group and 0 otherwise. Blocks are
+ * recorded by every tier of compiled code, including inlined code, so this
+ * finds dead code in production runs without the VM service. Functions that
+ * were never compiled, and so never ran, are not listed.
+ *
+ * Requires there to be a current isolate. Not supported in AOT.
+ *
+ * \param coverage Set to the report, which must be free()ed by caller.
+ * \param coverage_length Set to the length of coverage.
+ * \param error An optional error, must be free()ed by caller.
+ *
+ * \return Returns true if the report was collected and false otherwise.
+ */
+DART_EXPORT bool Dart_GetCodeCoverage(char** coverage,
+                                      intptr_t* coverage_length,
+                                      char** error);
+
 /*
  * ====================
  * Compilation Feedback
@@ -3704,6 +3910,10 @@ Dart_SaveTypeFeedback(uint8_t** buffer, intptr_t* buffer_length);
  * Compile functions using data from Dart_SaveTypeFeedback. The data must from a
  * VM with the same version and compiler flags.
  *
+ * When called before Dart_Precompile, no code is compiled. The function usage
+ * counts are recorded instead and guide inlining in the precompiler; only the
+ * version has to match.
+ *
  * \return Returns an error handle if a compilation error was encountered or a
  *   version mismatch is detected.
  */
@@ -3740,6 +3950,15 @@ typedef void (*Dart_StreamingCloseCallback)(void* callback_data);
 
 DART_EXPORT Dart_Handle Dart_LoadingUnitLibraryUris(intptr_t loading_unit_id);
 
+/**
+ * Returns the id of the loading unit whose objects the given loading unit's
+ * snapshot refers to, or 0 for the root unit. A unit can only be completed
+ * with Dart_DeferredLoadComplete once its parent has been loaded, so this is
+ * the dependency an embedder follows when prefetching units. gen_snapshot
+ * also records it in the loading unit manifest.
+ */
+DART_EXPORT Dart_Handle Dart_LoadingUnitParent(intptr_t loading_unit_id);
+
 // On Darwin systems, 'dlsym' adds an '_' to the beginning of the symbol name.
 // Use the '...CSymbol' definitions for resolving through 'dlsym'. The actual
 // symbol names in the objects are given by the '...AsmSymbol' definitions.
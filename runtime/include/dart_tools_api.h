@@ -331,6 +331,83 @@ typedef void (*Dart_GCEventCallback)(Dart_GCEvent* event);
  */
 DART_EXPORT void Dart_SetGCEventCallback(Dart_GCEventCallback callback);
 
+/**
+ * Cumulative garbage collection statistics of an isolate group, since it was
+ * created. All times are in microseconds and all sizes in bytes.
+ *
+ * The pause of a collection is the time all isolates of the group were
+ * stopped for it. Phase times of a parallel collection are summed over the
+ * threads that took part in it, so they may add up to more than the pauses.
+ *
+ * \param scavenge_count How many times new space was scavenged.
+ *
+ * \param scavenge_pause Total, maximum and percentile pauses of scavenges.
+ *   The percentiles are accurate to within 1/8 of their value.
+ *
+ * \param scavenge_roots Time spent visiting isolate and other roots.
+ *
+ * \param scavenge_store_buffers Time spent visiting the old objects
+ *   remembered in the store buffers.
+ *
+ * \param scavenge_copy Time spent copying and promoting live objects,
+ *   including the roots and store buffers.
+ *
+ * \param scavenge_weak Time spent processing weak handles and tables.
+ *
+ * \param scavenge_copied Bytes copied within new space.
+ *
+ * \param scavenge_promoted Bytes promoted to old space.
+ *
+ * \param old_count How many times old space was collected, including the
+ *   start of concurrent marking.
+ *
+ * \param old_pause Total, maximum and percentile pauses of old space
+ *   collections.
+ *
+ * \param old_mark Time spent marking, after any concurrent marking.
+ *
+ * \param old_sweep Time spent sweeping, or starting a concurrent sweep.
+ *
+ * \param old_compact Time spent compacting.
+ */
+typedef struct {
+  int64_t total;
+  int64_t max;
+  int64_t p50;
+  int64_t p90;
+  int64_t p99;
+} Dart_GCPauseStats;
+
+typedef struct {
+  int64_t scavenge_count;
+  Dart_GCPauseStats scavenge_pause;
+  int64_t scavenge_roots;
+  int64_t scavenge_store_buffers;
+  int64_t scavenge_copy;
+  int64_t scavenge_weak;
+  int64_t scavenge_copied;
+  int64_t scavenge_promoted;
+
+  int64_t old_count;
+  Dart_GCPauseStats old_pause;
+  int64_t old_mark;
+  int64_t old_sweep;
+  int64_t old_compact;
+} Dart_GCStatistics;
+
+/**
+ * Reads the garbage collection statistics of the isolate group of an isolate.
+ *
+ * Unlike the GC event callback and the GC service stream, this does not
+ * require any work from the VM until it is called, so monitoring agents can
+ * poll it at their own pace. It may be called from any thread.
+ *
+ * \param isolate An isolate of the group. Must not be NULL.
+ * \param stats Filled in with the statistics.
+ */
+DART_EXPORT void Dart_GetGCStatistics(Dart_Isolate isolate,
+                                      Dart_GCStatistics* stats);
+
 /*
  * ========
  * Reload support
@@ -467,6 +544,8 @@ DART_EXPORT void Dart_SetThreadName(const char* name);
 DART_EXPORT int64_t Dart_VMIsolateCountMetric();  // Counter
 DART_EXPORT int64_t Dart_VMCurrentRSSMetric();    // Byte
 DART_EXPORT int64_t Dart_VMPeakRSSMetric();       // Byte
+DART_EXPORT int64_t Dart_VMZoneSizeMetric();      // Byte
+DART_EXPORT int64_t Dart_VMZoneCachedMetric();    // Byte
 DART_EXPORT int64_t
 Dart_IsolateHeapOldUsedMetric(Dart_Isolate isolate);  // Byte
 DART_EXPORT int64_t
@@ -492,8 +571,42 @@ Dart_IsolateHeapGlobalUsedMetric(Dart_Isolate isolate);  // Byte
 DART_EXPORT int64_t
 Dart_IsolateHeapGlobalUsedMaxMetric(Dart_Isolate isolate);  // Byte
 DART_EXPORT int64_t
+Dart_IsolateSafepointCountMetric(Dart_Isolate isolate);  // Counter
+DART_EXPORT int64_t
+Dart_IsolateSafepointLatencyMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateSafepointLatencyMaxMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateGCScavengeCountMetric(Dart_Isolate isolate);  // Counter
+DART_EXPORT int64_t
+Dart_IsolateGCScavengeTimeMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateGCScavengeTimeMaxMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateGCScavengeTimeP99Metric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateGCScavengeCopiedMetric(Dart_Isolate isolate);  // Byte
+DART_EXPORT int64_t
+Dart_IsolateGCScavengePromotedMetric(Dart_Isolate isolate);  // Byte
+DART_EXPORT int64_t
+Dart_IsolateGCOldCountMetric(Dart_Isolate isolate);  // Counter
+DART_EXPORT int64_t
+Dart_IsolateGCOldTimeMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateGCOldTimeMaxMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateGCOldTimeP99Metric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateGCOldBarrierMarkedMetric(Dart_Isolate isolate);  // Counter
+DART_EXPORT int64_t
 Dart_IsolateRunnableLatencyMetric(Dart_Isolate isolate);  // Microsecond
 DART_EXPORT int64_t
 Dart_IsolateRunnableHeapSizeMetric(Dart_Isolate isolate);  // Byte
+DART_EXPORT int64_t
+Dart_IsolateMessageLatencyP99Metric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateMessageHandlingP99Metric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateMessageQueueDepthMaxMetric(Dart_Isolate isolate);  // Counter
 
 #endif  // RUNTIME_INCLUDE_DART_TOOLS_API_H_
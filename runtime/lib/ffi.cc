@@ -146,7 +146,7 @@ DEFINE_NATIVE_ENTRY(Ffi_sizeOf, 1, 0) {
 }
 
 // Static invocations to this method are translated directly in streaming FGB.
-DEFINE_NATIVE_ENTRY(Ffi_asFunctionInternal, 2, 1) {
+DEFINE_NATIVE_ENTRY(Ffi_asFunctionInternal, 2, 2) {
   UNREACHABLE();
 }
 
@@ -294,4 +294,176 @@ DEFINE_NATIVE_ENTRY(Mint_bitLength, 0, 1) {
   return Smi::New(result);
 }
 
+// Bigint natives.
+
+// Digits are 32 bits, least significant first, as in _BigIntImpl._digits.
+// Below this many digits, Karatsuba multiplication recurses no further.
+static const intptr_t kKaratsubaThreshold = 32;
+
+// result[0..x_used+y_used-1] = x[0..x_used-1] * y[0..y_used-1].
+static void SchoolbookMultiply(const uint32_t* x,
+                               intptr_t x_used,
+                               const uint32_t* y,
+                               intptr_t y_used,
+                               uint32_t* result) {
+  memset(result, 0, (x_used + y_used) * sizeof(uint32_t));
+  for (intptr_t i = 0; i < y_used; i++) {
+    const uint64_t digit = y[i];
+    uint64_t carry = 0;
+    for (intptr_t j = 0; j < x_used; j++) {
+      // At most (2^32-1)^2 + 2 * (2^32-1), which fits in 64 bits.
+      carry += digit * x[j] + result[i + j];
+      result[i + j] = static_cast<uint32_t>(carry);
+      carry >>= 32;
+    }
+    result[i + x_used] = static_cast<uint32_t>(carry);
+  }
+}
+
+// x[0..x_used-1] += y[0..y_used-1]. Returns the carry out of x.
+static uint32_t AddDigits(uint32_t* x,
+                          intptr_t x_used,
+                          const uint32_t* y,
+                          intptr_t y_used) {
+  ASSERT(x_used >= y_used);
+  uint64_t carry = 0;
+  intptr_t i = 0;
+  for (; i < y_used; i++) {
+    carry += static_cast<uint64_t>(x[i]) + y[i];
+    x[i] = static_cast<uint32_t>(carry);
+    carry >>= 32;
+  }
+  for (; (i < x_used) && (carry != 0); i++) {
+    carry += x[i];
+    x[i] = static_cast<uint32_t>(carry);
+    carry >>= 32;
+  }
+  return static_cast<uint32_t>(carry);
+}
+
+// x[0..x_used-1] -= y[0..y_used-1]. Returns the borrow out of x.
+static uint32_t SubtractDigits(uint32_t* x,
+                               intptr_t x_used,
+                               const uint32_t* y,
+                               intptr_t y_used) {
+  ASSERT(x_used >= y_used);
+  uint64_t borrow = 0;
+  intptr_t i = 0;
+  for (; i < y_used; i++) {
+    const uint64_t difference = static_cast<uint64_t>(x[i]) - y[i] - borrow;
+    x[i] = static_cast<uint32_t>(difference);
+    borrow = (difference >> 32) & 1;
+  }
+  for (; (i < x_used) && (borrow != 0); i++) {
+    const uint64_t difference = static_cast<uint64_t>(x[i]) - borrow;
+    x[i] = static_cast<uint32_t>(difference);
+    borrow = (difference >> 32) & 1;
+  }
+  return static_cast<uint32_t>(borrow);
+}
+
+// The number of scratch digits KaratsubaMultiply needs for n digits.
+static intptr_t KaratsubaScratchSize(intptr_t n) {
+  intptr_t size = 0;
+  while (n >= kKaratsubaThreshold) {
+    const intptr_t high = n - (n / 2);
+    size += 4 * (high + 1);
+    n = high + 1;
+  }
+  return size;
+}
+
+// result[0..2n-1] = x[0..n-1] * y[0..n-1], using scratch for the sums of
+// the halves and their product.
+static void KaratsubaMultiply(const uint32_t* x,
+                              const uint32_t* y,
+                              intptr_t n,
+                              uint32_t* result,
+                              uint32_t* scratch) {
+  if (n < kKaratsubaThreshold) {
+    SchoolbookMultiply(x, n, y, n, result);
+    return;
+  }
+  // x = x1 * B^low + x0 and y = y1 * B^low + y0, then
+  // x * y = x1y1 * B^2low + ((x0 + x1)(y0 + y1) - x0y0 - x1y1) * B^low + x0y0.
+  const intptr_t low = n / 2;
+  const intptr_t high = n - low;
+  KaratsubaMultiply(x, y, low, result, scratch);
+  KaratsubaMultiply(x + low, y + low, high, result + 2 * low, scratch);
+
+  uint32_t* x_sum = scratch;
+  uint32_t* y_sum = x_sum + high + 1;
+  uint32_t* middle = y_sum + high + 1;
+  uint32_t* rest = middle + 2 * (high + 1);
+  memmove(x_sum, x + low, high * sizeof(uint32_t));
+  x_sum[high] = AddDigits(x_sum, high, x, low);
+  memmove(y_sum, y + low, high * sizeof(uint32_t));
+  y_sum[high] = AddDigits(y_sum, high, y, low);
+  KaratsubaMultiply(x_sum, y_sum, high + 1, middle, rest);
+
+  const intptr_t middle_used = 2 * (high + 1);
+  uint32_t borrow = SubtractDigits(middle, middle_used, result, 2 * low);
+  borrow |= SubtractDigits(middle, middle_used, result + 2 * low, 2 * high);
+  ASSERT(borrow == 0);
+  const uint32_t carry =
+      AddDigits(result + low, 2 * n - low, middle, middle_used);
+  ASSERT(carry == 0);
+}
+
+// result[0..x_used+y_used-1] = x[0..x_used-1] * y[0..y_used-1]. The longer
+// operand is multiplied in slices as long as the shorter one.
+static void MultiplyDigits(const uint32_t* x,
+                           intptr_t x_used,
+                           const uint32_t* y,
+                           intptr_t y_used,
+                           uint32_t* result) {
+  if (x_used < y_used) {
+    MultiplyDigits(y, y_used, x, x_used, result);
+    return;
+  }
+  if (y_used < kKaratsubaThreshold) {
+    SchoolbookMultiply(x, x_used, y, y_used, result);
+    return;
+  }
+  uint32_t* product = reinterpret_cast<uint32_t*>(
+      malloc((2 * y_used + KaratsubaScratchSize(y_used)) * sizeof(uint32_t)));
+  uint32_t* scratch = product + 2 * y_used;
+  memset(result, 0, (x_used + y_used) * sizeof(uint32_t));
+  for (intptr_t offset = 0; offset < x_used; offset += y_used) {
+    const intptr_t slice = Utils::Minimum(y_used, x_used - offset);
+    if (slice == y_used) {
+      KaratsubaMultiply(x + offset, y, y_used, product, scratch);
+    } else {
+      MultiplyDigits(y, y_used, x + offset, slice, product);
+    }
+    const uint32_t carry = AddDigits(result + offset, x_used + y_used - offset,
+                                     product, y_used + slice);
+    ASSERT(carry == 0);
+  }
+  free(product);
+}
+
+DEFINE_NATIVE_ENTRY(Bigint_mulLarge, 0, 5) {
+  const TypedData& x_digits =
+      TypedData::CheckedHandle(zone, arguments->NativeArgAt(0));
+  const Smi& x_used = Smi::CheckedHandle(zone, arguments->NativeArgAt(1));
+  const TypedData& y_digits =
+      TypedData::CheckedHandle(zone, arguments->NativeArgAt(2));
+  const Smi& y_used = Smi::CheckedHandle(zone, arguments->NativeArgAt(3));
+  const TypedData& result_digits =
+      TypedData::CheckedHandle(zone, arguments->NativeArgAt(4));
+  ASSERT(x_digits.Length() >= x_used.Value());
+  ASSERT(y_digits.Length() >= y_used.Value());
+  ASSERT(result_digits.Length() >= x_used.Value() + y_used.Value());
+  ASSERT(result_digits.raw() != x_digits.raw());
+  ASSERT(result_digits.raw() != y_digits.raw());
+  NoSafepointScope no_safepoint;
+  MultiplyDigits(reinterpret_cast<const uint32_t*>(x_digits.DataAddr(0)),
+                 x_used.Value(),
+                 reinterpret_cast<const uint32_t*>(y_digits.DataAddr(0)),
+                 y_used.Value(),
+                 reinterpret_cast<uint32_t*>(result_digits.DataAddr(0)));
+  return Object::null();
+}
+
 }  // namespace dart
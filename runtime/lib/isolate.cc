@@ -20,15 +20,23 @@
 #include "vm/longjump.h"
 #include "vm/message_handler.h"
 #include "vm/object.h"
+#include "vm/object_graph_copy.h"
 #include "vm/object_store.h"
 #include "vm/port.h"
 #include "vm/resolver.h"
 #include "vm/service.h"
 #include "vm/snapshot.h"
 #include "vm/symbols.h"
+#include "vm/transferable_buffer_pool.h"
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            copy_isolate_group_messages,
+            true,
+            "Copy messages sent within an isolate group directly in the heap "
+            "instead of serializing them.");
+
 DEFINE_NATIVE_ENTRY(CapabilityImpl_factory, 0, 1) {
   ASSERT(
       TypeArguments::CheckedHandle(zone, arguments->NativeArgAt(0)).IsNull());
@@ -99,6 +107,28 @@ DEFINE_NATIVE_ENTRY(SendPortImpl_get_hashcode, 0, 1) {
   return Smi::New(hash);
 }
 
+// Posts a copy of [obj] that is made directly in the heap of the isolate
+// group, skipping the message snapshot. Returns false if the message has to
+// go through the snapshot instead.
+static bool CopyMessageWithinIsolateGroup(Thread* thread,
+                                          const Instance& obj,
+                                          Dart_Port destination_port_id) {
+  Object& copy = Object::Handle(thread->zone());
+  {
+    ObjectGraphCopier copier(thread);
+    if (!copier.Copy(obj, &copy)) {
+      return false;
+    }
+  }
+  PersistentHandle* handle =
+      thread->isolate_group()->api_state()->AllocatePersistentHandle();
+  handle->set_raw(copy);
+  PortMap::PostMessage(Message::New(
+      destination_port_id, new Bequest(handle, destination_port_id),
+      Message::kNormalPriority));
+  return true;
+}
+
 DEFINE_NATIVE_ENTRY(SendPortImpl_sendInternal_, 0, 2) {
   GET_NON_NULL_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(0));
   // TODO(iposva): Allow for arbitrary messages to be sent.
@@ -110,6 +140,11 @@ DEFINE_NATIVE_ENTRY(SendPortImpl_sendInternal_, 0, 2) {
   if (ApiObjectConverter::CanConvert(obj.raw())) {
     PortMap::PostMessage(
         Message::New(destination_port_id, obj.raw(), Message::kNormalPriority));
+  } else if (FLAG_copy_isolate_group_messages && can_send_any_object &&
+             PortMap::IsReceiverInThisIsolateGroup(destination_port_id,
+                                                   isolate->group()) &&
+             CopyMessageWithinIsolateGroup(thread, obj, destination_port_id)) {
+    // The receiver shares our heap, so the message was copied directly.
   } else {
     MessageWriter writer(can_send_any_object);
     // TODO(turnidge): Throw an exception when the return value is false?
@@ -1016,7 +1051,7 @@ DEFINE_NATIVE_ENTRY(Isolate_sendOOB, 0, 2) {
 
 static void ExternalTypedDataFinalizer(void* isolate_callback_data,
                                        void* peer) {
-  free(peer);
+  TransferableBufferPool::Free(reinterpret_cast<uint8_t*>(peer));
 }
 
 static intptr_t GetTypedDataSizeOrThrow(const Instance& instance) {
@@ -1069,7 +1104,7 @@ DEFINE_NATIVE_ENTRY(TransferableTypedData_factory, 0, 2) {
     }
   }
 
-  uint8_t* data = reinterpret_cast<uint8_t*>(::malloc(total_bytes));
+  uint8_t* data = TransferableBufferPool::Allocate(total_bytes);
   if (data == nullptr) {
     const Instance& exception =
         Instance::Handle(thread->isolate()->object_store()->out_of_memory());
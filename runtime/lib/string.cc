@@ -622,4 +622,49 @@ DEFINE_NATIVE_ENTRY(StringBuffer_createStringFromUint16Array, 0, 3) {
   return result.raw();
 }
 
+// Concatenates the parts of a StringBuffer and the code units still in its
+// buffer in a single copy, without first turning the buffer into a part.
+DEFINE_NATIVE_ENTRY(StringBuffer_concatPartsAndBuffer, 0, 4) {
+  GET_NON_NULL_NATIVE_ARGUMENT(GrowableObjectArray, parts,
+                               arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(TypedData, codeUnits, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, length, arguments->NativeArgAt(2));
+  GET_NON_NULL_NATIVE_ARGUMENT(Bool, isLatin1, arguments->NativeArgAt(3));
+  const intptr_t array_length = codeUnits.Length();
+  const intptr_t length_value = length.Value();
+  if (length_value < 0 || length_value > array_length) {
+    Exceptions::ThrowRangeError("length", length, 0, array_length);
+  }
+  const intptr_t num_parts = parts.Length();
+  String& part = String::Handle(zone);
+  bool is_one_byte_string = isLatin1.value();
+  intptr_t result_length = length_value;
+  for (intptr_t i = 0; i < num_parts; i++) {
+    part ^= parts.At(i);
+    const intptr_t part_length = part.Length();
+    if ((String::kMaxElements - result_length) < part_length) {
+      Exceptions::ThrowOOM();
+      UNREACHABLE();
+    }
+    result_length += part_length;
+    is_one_byte_string =
+        is_one_byte_string && (part.CharSize() == String::kOneByteChar);
+  }
+  const String& result =
+      is_one_byte_string
+          ? String::Handle(zone, OneByteString::New(result_length, Heap::kNew))
+          : String::Handle(zone, TwoByteString::New(result_length, Heap::kNew));
+  intptr_t position = 0;
+  for (intptr_t i = 0; i < num_parts; i++) {
+    part ^= parts.At(i);
+    const intptr_t part_length = part.Length();
+    String::Copy(result, position, part, 0, part_length);
+    position += part_length;
+  }
+  NoSafepointScope no_safepoint;
+  uint16_t* data_position = reinterpret_cast<uint16_t*>(codeUnits.DataAddr(0));
+  String::Copy(result, position, data_position, length_value);
+  return result.raw();
+}
+
 }  // namespace dart
@@ -276,6 +276,14 @@ typedef simd128_value_t fpu_register_t;
 #define UNLIKELY(cond) cond
 #endif
 
+// PREFETCH_FOR_WRITE hints that the cache line holding addr will soon be
+// read and written.
+#ifdef __GNUC__
+#define PREFETCH_FOR_WRITE(addr) __builtin_prefetch((addr), 1)
+#else
+#define PREFETCH_FOR_WRITE(addr)
+#endif
+
 // DART_UNUSED indicates to the compiler that a variable or typedef is expected
 // to be unused and disables the related warning.
 #ifdef __GNUC__
@@ -517,6 +525,22 @@ static_assert(kWordSize == sizeof(word), "Mismatched word size constant");
 constexpr int kBitsPerWordLog2 = kWordSizeLog2 + kBitsPerByteLog2;
 constexpr int kBitsPerWord = 1 << kBitsPerWordLog2;
 
+// Byte sizes for object pointers stored in heap objects, which are narrower
+// than native machine words when compressed pointers are enabled.
+#if defined(DART_COMPRESSED_POINTERS)
+#if defined(ARCH_IS_32_BIT)
+#error "Compressed pointers are only supported on 64-bit architectures."
+#endif
+constexpr int kCompressedWordSizeLog2 = kInt32SizeLog2;
+typedef uint32_t compressed_uword;
+#else
+constexpr int kCompressedWordSizeLog2 = kWordSizeLog2;
+typedef uword compressed_uword;
+#endif
+constexpr int kCompressedWordSize = 1 << kCompressedWordSizeLog2;
+static_assert(kCompressedWordSize == sizeof(compressed_uword),
+              "Mismatched compressed word size constant");
+
 // Integer constants for native machine words.
 constexpr word kWordMin = static_cast<uword>(1) << (kBitsPerWord - 1);
 constexpr word kWordMax = (static_cast<uword>(1) << (kBitsPerWord - 1)) - 1;
@@ -144,6 +144,17 @@ SimpleHashMap::Entry* SimpleHashMap::Probe(void* key, uint32_t hash) {
   ASSERT(map_ <= p && p < end);
 
   ASSERT(occupancy_ < capacity_);  // Guarantees loop termination.
+  if (match_ == SamePointerValue) {
+    // Most maps are keyed by pointer identity, which is compared inline
+    // rather than through match_. Equal keys have equal hashes.
+    while (p->key != NULL && p->key != key) {
+      p++;
+      if (p >= end) {
+        p = map_;
+      }
+    }
+    return p;
+  }
   while (p->key != NULL && (hash != p->hash || !match_(key, p->key))) {
     p++;
     if (p >= end) {
@@ -109,7 +109,7 @@ void BaseTextBuffer::EscapeAndAddUTF16CodeUnit(uint16_t codeunit) {
 }
 
 void BaseTextBuffer::AddString(const char* s) {
-  Printf("%s", s);
+  AddRaw(reinterpret_cast<const uint8_t*>(s), strlen(s));
 }
 
 void BaseTextBuffer::AddEscapedString(const char* s) {
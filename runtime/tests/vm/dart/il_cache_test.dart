@@ -0,0 +1,70 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Checks that optimized flow graphs stored with --il_cache_dir are loaded
+// again by the next run of the same program.
+
+import 'dart:io';
+
+import 'package:expect/expect.dart';
+import 'package:path/path.dart' as p;
+
+const String program = '''
+@pragma('vm:never-inline')
+int callee(int x) => x;
+
+@pragma('vm:never-inline')
+int hot(int x) => callee(x);
+
+void main() {
+  int sum = 0;
+  for (int i = 0; i < 100; i++) {
+    sum += hot(i);
+  }
+  if (sum != 4950) throw 'Unexpected sum: \$sum';
+  print('OK');
+}
+''';
+
+Future<Set<String>> run(String script, String cacheDir, String action) async {
+  final result = await Process.run(Platform.executable, [
+    ...Platform.executableArguments,
+    '--optimization-counter-threshold=10',
+    '--no-use-osr',
+    '--no-background-compilation',
+    '--il_cache_dir=$cacheDir',
+    '--trace_il_cache',
+    script,
+  ]);
+  if (result.exitCode != 0) {
+    print('''
+Subprocess output:
+${result.stdout}
+${result.stderr}
+''');
+  }
+  Expect.equals(0, result.exitCode);
+  final lines = (result.stdout as String).split('\n');
+  Expect.isTrue(lines.contains('OK'));
+  final prefix = '$action graph for ';
+  return lines
+      .where((line) => line.startsWith(prefix))
+      .map((line) => line.substring(prefix.length).split(' ').first)
+      .toSet();
+}
+
+void main() async {
+  final tmp = await Directory.systemTemp.createTemp('il_cache');
+  try {
+    final script = p.join(tmp.path, 'program.dart');
+    await File(script).writeAsString(program);
+    final cacheDir = Directory(p.join(tmp.path, 'cache'))..createSync();
+
+    final stored = await run(script, cacheDir.path, 'Stored');
+    final loaded = await run(script, cacheDir.path, 'Loaded cached');
+    Expect.setEquals(stored, loaded);
+  } finally {
+    await tmp.delete(recursive: true);
+  }
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Tests that linked hash maps and sets which compact (and shrink) after most
+// of their entries were removed keep their contents and iteration order.
+
+import 'dart:collection';
+
+import 'package:expect/expect.dart';
+
+const int kCount = 1000;
+
+void testMap(Map<int, String> map) {
+  for (int i = 0; i < kCount; i++) {
+    map[i] = '$i';
+  }
+  for (int i = 0; i < kCount; i++) {
+    if (i % 10 != 0) {
+      Expect.equals('$i', map.remove(i));
+    }
+  }
+  Expect.equals(kCount ~/ 10, map.length);
+  Expect.listEquals(
+      [for (int i = 0; i < kCount; i += 10) i], map.keys.toList());
+  Expect.listEquals(
+      [for (int i = 0; i < kCount; i += 10) '$i'], map.values.toList());
+  for (int i = 0; i < kCount; i++) {
+    Expect.equals(i % 10 == 0, map.containsKey(i));
+  }
+
+  // The map keeps working after shrinking.
+  for (int i = 0; i < kCount; i++) {
+    map[i] = 'x$i';
+  }
+  Expect.equals(kCount, map.length);
+  Expect.equals('x0', map[0]);
+  Expect.equals('x999', map[999]);
+
+  // Removing entries while iterating is still detected.
+  Expect.throws<ConcurrentModificationError>(() {
+    for (final key in map.keys) {
+      map.remove(key);
+    }
+  });
+
+  while (map.isNotEmpty) {
+    map.remove(map.keys.first);
+  }
+  Expect.isTrue(map.isEmpty);
+  map[42] = '42';
+  Expect.equals('42', map[42]);
+}
+
+void testSet(Set<int> set) {
+  for (int i = 0; i < kCount; i++) {
+    set.add(i);
+  }
+  for (int i = 0; i < kCount; i++) {
+    if (i % 10 != 0) {
+      Expect.isTrue(set.remove(i));
+    }
+  }
+  Expect.equals(kCount ~/ 10, set.length);
+  Expect.listEquals([for (int i = 0; i < kCount; i += 10) i], set.toList());
+  for (int i = 0; i < kCount; i++) {
+    Expect.equals(i % 10 == 0, set.contains(i));
+  }
+
+  for (int i = 0; i < kCount; i++) {
+    set.add(i);
+  }
+  Expect.equals(kCount, set.length);
+
+  Expect.throws<ConcurrentModificationError>(() {
+    for (final key in set) {
+      set.remove(key);
+    }
+  });
+
+  while (set.isNotEmpty) {
+    set.remove(set.first);
+  }
+  Expect.isTrue(set.isEmpty);
+  set.add(42);
+  Expect.isTrue(set.contains(42));
+}
+
+main() {
+  testMap(<int, String>{});
+  testMap(new LinkedHashMap<int, String>.identity());
+  testMap(new LinkedHashMap<int, String>(
+      equals: (a, b) => a == b, hashCode: (a) => a.hashCode));
+  testSet(<int>{});
+  testSet(new LinkedHashSet<int>.identity());
+  testSet(new LinkedHashSet<int>(
+      equals: (a, b) => a == b, hashCode: (a) => a.hashCode));
+}
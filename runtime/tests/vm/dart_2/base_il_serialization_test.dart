@@ -7,6 +7,7 @@
 // VMOptions=--serialize_flow_graphs_to=il_tmp.txt --no_serialize_flow_graph_types
 // VMOptions=--serialize_flow_graphs_to=il_tmp.txt --verbose_flow_graph_serialization
 // VMOptions=--serialize_flow_graphs_to=il_tmp.txt --no_serialize_flow_graph_types --verbose_flow_graph_serialization
+// VMOptions=--serialize_flow_graphs_to=il_tmp.txt --serialize_only_llvm_candidates
 
 // Just use the existing hello world test.
 import 'hello_world_test.dart' as test;
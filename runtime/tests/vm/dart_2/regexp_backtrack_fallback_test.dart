@@ -0,0 +1,82 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Checks that matches which exceed the backtrack budget of the bytecode
+// interpreter are finished by the linear-time NFA with the same results.
+
+// VMOptions=--interpret_irregexp --regexp_backtracks_before_fallback=1
+// VMOptions=--interpret_irregexp --regexp_backtracks_before_fallback=1000
+
+import "package:expect/expect.dart";
+
+void expectMatch(RegExp re, String subject, List<String> expected) {
+  final match = re.firstMatch(subject);
+  if (expected == null) {
+    Expect.isNull(match, "$re on '$subject'");
+    return;
+  }
+  Expect.isNotNull(match, "$re on '$subject'");
+  final groups = <String>[];
+  for (int i = 0; i <= match.groupCount; i++) {
+    groups.add(match.group(i));
+  }
+  Expect.listEquals(expected, groups, "$re on '$subject'");
+}
+
+void testCatastrophic() {
+  final subject = "a" * 40;
+  Expect.isFalse(RegExp(r"(a+)+b").hasMatch(subject));
+  Expect.isFalse(RegExp(r"(a|aa)*c").hasMatch(subject));
+  Expect.isTrue(RegExp(r"(a+)+$").hasMatch(subject));
+}
+
+void testSemantics() {
+  expectMatch(RegExp(r"(a|ab)(c|bcd)(d*)"), "abcd", ["abcd", "a", "bcd", ""]);
+  expectMatch(RegExp(r"a*?b"), "xaaab", ["aaab"]);
+  expectMatch(RegExp(r"(\w+)\s(\w+)"), "hello big world",
+      ["hello big", "hello", "big"]);
+  expectMatch(RegExp(r"(a)|b"), "b", ["b", null]);
+  expectMatch(RegExp(r"(?:(a)|b)+"), "ab", ["ab", null]);
+  expectMatch(RegExp(r"(a*)*b"), "aab", ["aab", "aa"]);
+  expectMatch(RegExp(r"x{2,3}"), "xxxx", ["xxx"]);
+  expectMatch(RegExp(r"x{2,3}?"), "xxxx", ["xx"]);
+  expectMatch(RegExp(r"x{2,}"), "xxxxx", ["xxxxx"]);
+  expectMatch(RegExp(r"[^a-c]+"), "abcdefabc", ["def"]);
+  expectMatch(RegExp(r"a.c"), "a\nc abc", ["abc"]);
+  expectMatch(RegExp(r"a.c", dotAll: true), "a\nc", ["a\nc"]);
+  expectMatch(RegExp(r"\bfoo\b"), "afoo foo.", ["foo"]);
+  expectMatch(RegExp(r"\Boo"), "oo foo", ["oo"]);
+  expectMatch(RegExp(r"^b$", multiLine: true), "a\nb\nc", ["b"]);
+  expectMatch(RegExp(r"^b"), "a\nb", null);
+  expectMatch(RegExp(r"[a-c]+", caseSensitive: false), "xABcy", ["ABc"]);
+  expectMatch(RegExp(r"hello", caseSensitive: false), "say HeLLo", ["HeLLo"]);
+  expectMatch(RegExp(r"é+"), "xééy", ["éé"]);
+  expectMatch(RegExp(r"ā+"), "xāāy", ["āā"]);
+  expectMatch(RegExp(r"[]"), "abc", null);
+  expectMatch(RegExp(r"[^]"), "abc", ["a"]);
+}
+
+void testGlobalAndSticky() {
+  Expect.listEquals(["1", "22", "333"],
+      RegExp(r"\d+").allMatches("a1b22c333").map((m) => m[0]).toList());
+  Expect.equals(4, RegExp(r"").allMatches("abc").length);
+  Expect.equals("bbb", RegExp(r"b+").matchAsPrefix("abbb", 1)[0]);
+  Expect.isNull(RegExp(r"b+").matchAsPrefix("abbb", 0));
+}
+
+void testUnsupportedPatterns() {
+  // Back references and lookarounds keep using the backtracking interpreter.
+  expectMatch(RegExp(r"(a+)\1"), "aaaa", ["aaaa", "aa"]);
+  expectMatch(RegExp(r"a(?=b)"), "aab", ["a"]);
+  expectMatch(RegExp(r"(?<=a)b+"), "bab", ["b"]);
+  expectMatch(RegExp(r"\u{1F600}+", unicode: true), "x\u{1F600}",
+      ["\u{1F600}"]);
+}
+
+void main() {
+  testCatastrophic();
+  testSemantics();
+  testGlobalAndSticky();
+  testUnsupportedPatterns();
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Exercises the Boyer-Moore skip loops that scan for the start of a match,
+// both in compiled regexps and in the bytecode interpreter.
+
+// VMOptions=
+// VMOptions=--interpret_irregexp
+
+import "package:expect/expect.dart";
+
+void testLiteral(String filler) {
+  final re = RegExp("xyz");
+  for (int length = 0; length < 40; length++) {
+    final prefix = filler * length;
+    Expect.equals(length * filler.length, (prefix + "xyz").indexOf(re));
+    Expect.equals(-1, (prefix + "xy").indexOf(re));
+    Expect.equals(-1, (prefix + "yz").indexOf(re));
+    Expect.equals(length * filler.length,
+        (prefix + "xyzxyz").indexOf(re, 0));
+    Expect.equals(length * filler.length + 3,
+        (prefix + "xyzxyz").indexOf(re, length * filler.length + 1));
+  }
+}
+
+void testCharacterClass(String filler) {
+  final re = RegExp(r"[0-9][a-c]q");
+  for (int length = 0; length < 40; length++) {
+    final prefix = filler * length;
+    final match = re.firstMatch(prefix + "7bq");
+    Expect.isNotNull(match);
+    Expect.equals(length * filler.length, match.start);
+    Expect.isNull(re.firstMatch(prefix + "7bz"));
+  }
+}
+
+main() {
+  for (final filler in ["a", "x", "xy", "\u{1234}", "x\u{1234}"]) {
+    testLiteral(filler);
+    testCharacterClass(filler);
+  }
+}
@@ -0,0 +1,37 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Exercises the word-at-a-time String equality intrinsics with strings of
+// every length around the word size and a difference at every position.
+
+// VMOptions=--optimization_counter_threshold=10 --no-background-compilation
+
+import "package:expect/expect.dart";
+
+bool equals(String a, String b) => a == b;
+
+void testStrings(String base, String replacement) {
+  for (int length = 0; length <= 40; length++) {
+    final a = base * length;
+    // Build a separate but identical string, so that the identity check in
+    // the intrinsic does not apply.
+    final b = (base * (length + 1)).substring(0, length * base.length);
+    Expect.isTrue(equals(a, b));
+    for (int i = 0; i < length; i++) {
+      final c = a.substring(0, i) + replacement + a.substring(i + 1);
+      Expect.isFalse(equals(a, c));
+      Expect.isFalse(equals(c, a));
+    }
+    Expect.isFalse(equals(a, a + base));
+  }
+}
+
+main() {
+  for (int i = 0; i < 20; i++) {
+    testStrings("a", "b");
+    testStrings("\u{1234}", "\u{1235}");
+    // Same low byte as "\u{1234}", different high byte.
+    testStrings("\u{1234}", "\u{1334}");
+  }
+}
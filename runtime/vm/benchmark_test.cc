@@ -13,11 +13,16 @@
 
 #include "platform/assert.h"
 #include "platform/globals.h"
+#include "platform/text_buffer.h"
 #include "platform/utils.h"
 
 #include "vm/clustered_snapshot.h"
 #include "vm/dart_api_impl.h"
 #include "vm/datastream.h"
+#include "vm/heap/heap.h"
+#include "vm/message_handler.h"
+#include "vm/metrics.h"
+#include "vm/port.h"
 #include "vm/stack_frame.h"
 #include "vm/timer.h"
 
@@ -29,6 +34,19 @@ Benchmark* Benchmark::first_ = NULL;
 Benchmark* Benchmark::tail_ = NULL;
 const char* Benchmark::executable_ = NULL;
 
+void Benchmark::PrintResult(const char* suffix,
+                            const char* kind,
+                            int64_t value) const {
+  OS::Print("%s.%s(%s): %" Pd64 "\n", name_, suffix, kind, value);
+}
+
+void Benchmark::PrintPercentiles(const Histogram& histogram) const {
+  PrintResult("p50", score_kind_, histogram.Percentile(50.0));
+  PrintResult("p90", score_kind_, histogram.Percentile(90.0));
+  PrintResult("p99", score_kind_, histogram.Percentile(99.0));
+  PrintResult("max", score_kind_, histogram.max());
+}
+
 void Benchmark::RunAll(const char* executable) {
   SetExecutable(executable);
   Benchmark* benchmark = first_;
@@ -201,6 +219,77 @@ BENCHMARK(UseDartApi) {
   benchmark->set_score(elapsed_time);
 }
 
+// The same work as UseDartApi, through the accessors that do not allocate
+// handles, in a native resolved without an API scope.
+static void UseDartApiNoScope(Dart_NativeArguments args) {
+  intptr_t receiver_value;
+  Dart_Handle result = Dart_GetNativeReceiver(args, &receiver_value);
+  EXPECT_VALID(result);
+  EXPECT_EQ(7, receiver_value);
+
+  int64_t value1;
+  result = Dart_GetNativeIntegerArgument(args, 1, &value1);
+  EXPECT_VALID(result);
+  EXPECT_LE(0, value1);
+  EXPECT_LE(value1, 1000000);
+
+  Dart_SetIntegerReturnValue(args, value1 * receiver_value);
+}
+
+static Dart_NativeFunction bm_uda_no_scope_lookup(Dart_Handle name,
+                                                  int argument_count,
+                                                  bool* auto_setup_scope) {
+  ASSERT(auto_setup_scope != NULL);
+  const char* cstr = NULL;
+  Dart_Handle result = Dart_StringToCString(name, &cstr);
+  EXPECT_VALID(result);
+  if (strcmp(cstr, "init") == 0) {
+    *auto_setup_scope = true;
+    return InitNativeFields;
+  } else {
+    *auto_setup_scope = false;
+    return UseDartApiNoScope;
+  }
+}
+
+BENCHMARK(UseDartApiNoScope) {
+  const int kNumIterations = 1000000;
+  const char* kScriptChars =
+      "import 'dart:nativewrappers';\n"
+      "class Class extends NativeFieldWrapperClass1 {\n"
+      "  void init() native 'init';\n"
+      "  int method(int param1, int param2) native 'method';\n"
+      "}\n"
+      "\n"
+      "void benchmark(int count) {\n"
+      "  Class c = Class();\n"
+      "  c.init();\n"
+      "  for (int i = 0; i < count; i++) {\n"
+      "    c.method(i,7);\n"
+      "  }\n"
+      "}\n";
+
+  Dart_Handle lib = TestCase::LoadTestScript(
+      kScriptChars, bm_uda_no_scope_lookup, RESOLVED_USER_TEST_URI, false);
+  Dart_Handle result = Dart_FinalizeLoading(false);
+  EXPECT_VALID(result);
+
+  Dart_Handle args[1];
+  args[0] = Dart_NewInteger(kNumIterations);
+
+  // Warmup first to avoid compilation jitters.
+  result = Dart_Invoke(lib, NewString("benchmark"), 1, args);
+  EXPECT_VALID(result);
+
+  Timer timer(true, "UseDartApiNoScope benchmark");
+  timer.Start();
+  result = Dart_Invoke(lib, NewString("benchmark"), 1, args);
+  EXPECT_VALID(result);
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
 static void NoopFinalizer(void* isolate_callback_data, void* peer) {}
 
 //
@@ -390,6 +479,33 @@ BENCHMARK(FrameLookup) {
   benchmark->set_score(elapsed_time);
 }
 
+//
+// Measure allocation of scoped and zone handles in short-lived zones, the
+// pattern of runtime entries allocating many Object::Handle()s.
+//
+BENCHMARK(HandleAllocation) {
+  TransitionNativeToVM transition(thread);
+  const intptr_t kNumIterations = 10000;
+  const intptr_t kNumHandles = 1000;
+  Timer timer(true, "HandleAllocation");
+  timer.Start();
+  for (intptr_t i = 0; i < kNumIterations; i++) {
+    StackZone zone(thread);
+    HANDLESCOPE(thread);
+    for (intptr_t j = 0; j < kNumHandles; j++) {
+      HANDLESCOPE(thread);
+      const Smi& smi = Smi::Handle(Smi::New(j));
+      const Smi& zone_smi = Smi::ZoneHandle(smi.raw());
+      ASSERT(smi.Value() == zone_smi.Value());
+    }
+    for (intptr_t j = 0; j < kNumHandles; j++) {
+      Smi::Handle(Smi::New(j));
+    }
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
 BENCHMARK_SIZE(CoreSnapshotSize) {
   const char* kScriptChars =
       "import 'dart:async';\n"
@@ -464,6 +580,87 @@ BENCHMARK_SIZE(StandaloneSnapshotSize) {
   benchmark->set_score(snapshot->length());
 }
 
+#if !defined(PRODUCT)
+// Generates a program whose snapshot grows with [num_classes]: every class
+// adds fields, functions, strings and canonical constants to the snapshot.
+static char* GenerateSnapshotLoadScript(intptr_t num_classes) {
+  TextBuffer buffer(KB);
+  for (intptr_t i = 0; i < num_classes; i++) {
+    buffer.Printf(
+        "class C%" Pd " {\n"
+        "  int f = %" Pd ";\n"
+        "  String s = 'C%" Pd "';\n"
+        "  static const values = const [%" Pd ", 'v%" Pd "', %" Pd ".5];\n"
+        "  int m1(int x) => x + f;\n"
+        "  String m2() => s * 2;\n"
+        "  List<int> m3() => <int>[f, f + 1];\n"
+        "}\n",
+        i, i, i, i, i, i);
+  }
+  buffer.Printf("main() {\n  var result = 0;\n");
+  for (intptr_t i = 0; i < num_classes; i++) {
+    buffer.Printf("  result += C%" Pd "().m1(%" Pd ");\n", i, i);
+  }
+  buffer.Printf("  return result;\n}\n");
+  return buffer.Steal();
+}
+
+// Measures loading a full snapshot of a program with [num_classes] classes
+// and reports the time spent in each phase and cluster of the load.
+static void BenchmarkSnapshotLoad(Benchmark* benchmark,
+                                  Thread* thread,
+                                  intptr_t num_classes) {
+  char* script = GenerateSnapshotLoadScript(num_classes);
+  TestCase::LoadTestScript(script, NULL);
+  free(script);
+
+  uint8_t* isolate_snapshot = nullptr;
+  {
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HANDLESCOPE(thread);
+
+    Api::CheckAndFinalizePendingClasses(thread);
+
+    MallocWriteStream isolate_snapshot_data(FullSnapshotWriter::kInitialSize);
+    FullSnapshotWriter writer(
+        Snapshot::kFull, /*vm_snapshot_data=*/nullptr, &isolate_snapshot_data,
+        /*vm_image_writer=*/nullptr, /*iso_image_writer=*/nullptr);
+    writer.WriteFullSnapshot();
+    intptr_t unused;
+    isolate_snapshot = isolate_snapshot_data.Steal(&unused);
+  }
+
+  const int kNumIterations = 10;
+  SnapshotLoadTimings timings;
+  Timer timer(true, benchmark->name());
+  Isolate* isolate = thread->isolate();
+  Dart_ExitIsolate();
+  for (int i = 0; i < kNumIterations; i++) {
+    timer.Start();
+    TestCase::CreateTestIsolateFromSnapshot(isolate_snapshot);
+    timer.Stop();
+    Dart_ShutdownIsolate();
+  }
+  benchmark->set_score(timer.TotalElapsedTime() / kNumIterations);
+  timings.Print(benchmark->name(), kNumIterations);
+  Dart_EnterIsolate(reinterpret_cast<Dart_Isolate>(isolate));
+  free(isolate_snapshot);
+}
+
+BENCHMARK(SnapshotLoadSmall) {
+  BenchmarkSnapshotLoad(benchmark, thread, 10);
+}
+
+BENCHMARK(SnapshotLoadMedium) {
+  BenchmarkSnapshotLoad(benchmark, thread, 200);
+}
+
+BENCHMARK(SnapshotLoadLarge) {
+  BenchmarkSnapshotLoad(benchmark, thread, 2000);
+}
+#endif  // !defined(PRODUCT)
+
 BENCHMARK(CreateMirrorSystem) {
   const char* kScriptChars =
       "import 'dart:mirrors';\n"
@@ -612,6 +809,444 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+// Runs one collection of the given type and records its pause.
+static void TimeCollection(Heap* heap,
+                           Heap::GCType type,
+                           Histogram* pauses) {
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  heap->CollectGarbage(type, Heap::kDebugging);
+  pauses->Add(OS::GetCurrentMonotonicMicros() - start);
+}
+
+// The score of the GC benchmarks is the total pause time of a fixed amount
+// of collection work, so lower is better.
+static void ReportPauses(Benchmark* benchmark, const Histogram& pauses) {
+  benchmark->set_score(pauses.total());
+  benchmark->PrintPercentiles(pauses);
+}
+
+// Scavenges new space full of small arrays, survival_percent of which are
+// still referenced from old space.
+static void BenchmarkScavenge(Benchmark* benchmark,
+                              Thread* thread,
+                              intptr_t survival_percent) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kRounds = 50;
+  const intptr_t kObjectsPerRound = 20000;
+  Heap* heap = thread->heap();
+  const Array& survivors =
+      Array::Handle(Array::New(kObjectsPerRound, Heap::kOld));
+  Array& object = Array::Handle();
+  Histogram pauses;
+  for (intptr_t round = 0; round < kRounds; round++) {
+    for (intptr_t i = 0; i < kObjectsPerRound; i++) {
+      object = Array::New(4);
+      if ((i % 100) < survival_percent) {
+        survivors.SetAt(i, object);
+      }
+    }
+    TimeCollection(heap, Heap::kScavenge, &pauses);
+  }
+  ReportPauses(benchmark, pauses);
+}
+
+BENCHMARK(GCScavengeSurvival10) {
+  BenchmarkScavenge(benchmark, thread, 10);
+}
+
+BENCHMARK(GCScavengeSurvival50) {
+  BenchmarkScavenge(benchmark, thread, 50);
+}
+
+// Marks a long linked list, which gives the marker no parallelism.
+BENCHMARK(GCMarkDeepList) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kRounds = 10;
+  const intptr_t kLength = 200000;
+  Heap* heap = thread->heap();
+  Array& head = Array::Handle(Array::New(1, Heap::kOld));
+  Array& next = Array::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    next = Array::New(1, Heap::kOld);
+    next.SetAt(0, head);
+    head = next.raw();
+  }
+  Histogram pauses;
+  for (intptr_t round = 0; round < kRounds; round++) {
+    TimeCollection(heap, Heap::kMarkSweep, &pauses);
+  }
+  ReportPauses(benchmark, pauses);
+}
+
+// Marks one array with many small elements.
+BENCHMARK(GCMarkWideArray) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kRounds = 10;
+  const intptr_t kLength = 200000;
+  Heap* heap = thread->heap();
+  const Array& array = Array::Handle(Array::New(kLength, Heap::kOld));
+  Double& element = Double::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    element = Double::New(static_cast<double>(i), Heap::kOld);
+    array.SetAt(i, element);
+  }
+  Histogram pauses;
+  for (intptr_t round = 0; round < kRounds; round++) {
+    TimeCollection(heap, Heap::kMarkSweep, &pauses);
+  }
+  ReportPauses(benchmark, pauses);
+}
+
+// Collects an old space in which every other object has just died. The
+// halves swap between rounds, so compaction cannot undo the fragmentation.
+static void BenchmarkFragmented(Benchmark* benchmark,
+                                Thread* thread,
+                                Heap::GCType type) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kRounds = 10;
+  const intptr_t kCount = 100000;
+  Heap* heap = thread->heap();
+  const Array& holder = Array::Handle(Array::New(kCount, Heap::kOld));
+  Array& object = Array::Handle();
+  for (intptr_t i = 0; i < kCount; i++) {
+    object = Array::New(8, Heap::kOld);
+    holder.SetAt(i, object);
+  }
+  Histogram pauses;
+  for (intptr_t round = 0; round < kRounds; round++) {
+    for (intptr_t i = 0; i < kCount; i++) {
+      if ((i % 2) == (round % 2)) {
+        holder.SetAt(i, Object::null_object());
+      } else if (holder.At(i) == Object::null()) {
+        object = Array::New(8, Heap::kOld);
+        holder.SetAt(i, object);
+      }
+    }
+    TimeCollection(heap, type, &pauses);
+  }
+  ReportPauses(benchmark, pauses);
+}
+
+BENCHMARK(GCSweepFragmented) {
+  BenchmarkFragmented(benchmark, thread, Heap::kMarkSweep);
+}
+
+BENCHMARK(GCCompactFragmented) {
+  BenchmarkFragmented(benchmark, thread, Heap::kMarkCompact);
+}
+
+// Scavenges objects that all have weak table entries, half of which die.
+BENCHMARK(GCWeakTables) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kRounds = 20;
+  const intptr_t kObjectsPerRound = 20000;
+  Heap* heap = thread->heap();
+  const Array& survivors =
+      Array::Handle(Array::New(kObjectsPerRound, Heap::kOld));
+  Array& object = Array::Handle();
+  Histogram pauses;
+  for (intptr_t round = 0; round < kRounds; round++) {
+    for (intptr_t i = 0; i < kObjectsPerRound; i++) {
+      object = Array::New(1);
+      heap->SetPeer(object.raw(), reinterpret_cast<void*>(i + 1));
+      survivors.SetAt(i, (i % 2) == 0 ? object : Object::null_object());
+    }
+    TimeCollection(heap, Heap::kScavenge, &pauses);
+  }
+  ReportPauses(benchmark, pauses);
+}
+
+// Scavenges after every one of many old objects was made to point to a new
+// object, so each of them is in the store buffer.
+BENCHMARK(GCStoreBuffer) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kRounds = 20;
+  const intptr_t kCount = 50000;
+  Heap* heap = thread->heap();
+  const Array& holder = Array::Handle(Array::New(kCount, Heap::kOld));
+  Array& old_object = Array::Handle();
+  for (intptr_t i = 0; i < kCount; i++) {
+    old_object = Array::New(1, Heap::kOld);
+    holder.SetAt(i, old_object);
+  }
+  Array& new_object = Array::Handle();
+  Histogram pauses;
+  for (intptr_t round = 0; round < kRounds; round++) {
+    for (intptr_t i = 0; i < kCount; i++) {
+      old_object ^= holder.At(i);
+      new_object = Array::New(0);
+      old_object.SetAt(0, new_object);
+    }
+    TimeCollection(heap, Heap::kScavenge, &pauses);
+  }
+  ReportPauses(benchmark, pauses);
+}
+
+// Counts the messages it handles and optionally answers each one with an
+// empty message to a reply port. Messages carry a Smi, so neither side needs
+// an isolate.
+class BenchmarkMessageHandler : public MessageHandler {
+ public:
+  BenchmarkMessageHandler() : reply_port_(ILLEGAL_PORT), count_(0) {}
+  ~BenchmarkMessageHandler() { PortMap::ClosePorts(this); }
+
+  const char* name() const { return "BenchmarkMessageHandler"; }
+
+  MessageStatus HandleMessage(std::unique_ptr<Message> message) {
+    if (reply_port_ != ILLEGAL_PORT) {
+      PortMap::PostMessage(
+          Message::New(reply_port_, Smi::New(0), Message::kNormalPriority));
+    }
+    MonitorLocker ml(&monitor_);
+    count_++;
+    ml.Notify();
+    return kOK;
+  }
+
+  // Creates a live port, which keeps the handler running on the pool.
+  Dart_Port CreateLivePort() {
+    const Dart_Port port = PortMap::CreatePort(this);
+    PortMap::SetPortState(port, PortMap::kLivePort);
+    return port;
+  }
+
+  void set_reply_port(Dart_Port port) { reply_port_ = port; }
+
+  void WaitForCount(intptr_t count) {
+    MonitorLocker ml(&monitor_);
+    while (count_ < count) {
+      ml.Wait();
+    }
+  }
+
+ private:
+  Dart_Port reply_port_;
+  Monitor monitor_;
+  intptr_t count_;
+};
+
+struct MessageSenderInfo {
+  Dart_Port port;
+  intptr_t count;
+  ThreadJoinId join_id;
+};
+
+static void SendBenchmarkMessages(uword param) {
+  MessageSenderInfo* info = reinterpret_cast<MessageSenderInfo*>(param);
+  info->join_id = OSThread::GetCurrentThreadJoinId(OSThread::Current());
+  for (intptr_t i = 0; i < info->count; i++) {
+    PortMap::PostMessage(
+        Message::New(info->port, Smi::New(i), Message::kNormalPriority));
+  }
+}
+
+// Measures how long the given number of threads take to post a fixed number
+// of messages to one port through PortMap::PostMessage, until the handler
+// has handled all of them.
+static void BenchmarkPostMessage(Benchmark* benchmark, intptr_t senders) {
+  const intptr_t kMessages = 640000;
+  BenchmarkMessageHandler handler;
+  ThreadPool pool;
+  const Dart_Port port = handler.CreateLivePort();
+  handler.Run(&pool, NULL, NULL, 0);
+
+  MessageSenderInfo* infos = new MessageSenderInfo[senders];
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  for (intptr_t i = 0; i < senders; i++) {
+    infos[i].port = port;
+    infos[i].count = kMessages / senders;
+    infos[i].join_id = OSThread::kInvalidThreadJoinId;
+    OSThread::Start("BenchmarkSender", SendBenchmarkMessages,
+                    reinterpret_cast<uword>(&infos[i]));
+  }
+  handler.WaitForCount(kMessages);
+  const int64_t elapsed = OS::GetCurrentMonotonicMicros() - start;
+  benchmark->set_score(elapsed);
+  benchmark->PrintResult(
+      "messagesPerSecond", "Throughput",
+      elapsed > 0 ? (kMessages * kMicrosecondsPerSecond) / elapsed : 0);
+
+  // Every sender has set its join id before posting its first message.
+  for (intptr_t i = 0; i < senders; i++) {
+    ASSERT(infos[i].join_id != OSThread::kInvalidThreadJoinId);
+    OSThread::Join(infos[i].join_id);
+  }
+  delete[] infos;
+}
+
+BENCHMARK(PostMessage1Sender) {
+  BenchmarkPostMessage(benchmark, 1);
+}
+
+BENCHMARK(PostMessage8Senders) {
+  BenchmarkPostMessage(benchmark, 8);
+}
+
+BENCHMARK(PostMessage64Senders) {
+  BenchmarkPostMessage(benchmark, 64);
+}
+
+// Measures round trips between two handlers on the thread pool, started
+// from and returning to a third thread.
+BENCHMARK(MessagePingPong) {
+  const intptr_t kRoundTrips = 20000;
+  BenchmarkMessageHandler pong;
+  BenchmarkMessageHandler ping;
+  ThreadPool pool;
+  const Dart_Port pong_port = pong.CreateLivePort();
+  pong.set_reply_port(ping.CreateLivePort());
+  ping.Run(&pool, NULL, NULL, 0);
+  pong.Run(&pool, NULL, NULL, 0);
+
+  Histogram round_trips;
+  for (intptr_t i = 0; i < kRoundTrips; i++) {
+    const int64_t start = OS::GetCurrentMonotonicMicros();
+    PortMap::PostMessage(
+        Message::New(pong_port, Smi::New(i), Message::kNormalPriority));
+    ping.WaitForCount(i + 1);
+    round_trips.Add(OS::GetCurrentMonotonicMicros() - start);
+  }
+  benchmark->set_score(round_trips.total());
+  benchmark->PrintPercentiles(round_trips);
+}
+
+// Serializes the object into a message and reads it back. The throughput is
+// reported for payload_bytes, the size of the Dart data in the object.
+static void BenchmarkMessageSerialization(Benchmark* benchmark,
+                                          Thread* thread,
+                                          const Object& object,
+                                          intptr_t payload_bytes) {
+  const intptr_t kLoopCount = 100;
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    StackZone zone(thread);
+    MessageWriter writer(true);
+    std::unique_ptr<Message> message =
+        writer.WriteMessage(object, ILLEGAL_PORT, Message::kNormalPriority);
+    MessageSnapshotReader reader(message.get(), thread);
+    reader.ReadObject();
+  }
+  const int64_t elapsed = OS::GetCurrentMonotonicMicros() - start;
+  benchmark->set_score(elapsed);
+  // Bytes per microsecond are megabytes per second.
+  benchmark->PrintResult(
+      "megabytesPerSecond", "Throughput",
+      elapsed > 0 ? (payload_bytes * kLoopCount) / elapsed : 0);
+}
+
+BENCHMARK(SerializeUint8List) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kLength = 4 * MB;
+  const TypedData& data =
+      TypedData::Handle(TypedData::New(kTypedDataUint8ArrayCid, kLength));
+  BenchmarkMessageSerialization(benchmark, thread, data, kLength);
+}
+
+BENCHMARK(SerializeSmiList) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kLength = 100000;
+  const Array& array = Array::Handle(Array::New(kLength));
+  Smi& element = Smi::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    element = Smi::New(i);
+    array.SetAt(i, element);
+  }
+  BenchmarkMessageSerialization(benchmark, thread, array, kLength * kWordSize);
+}
+
+BENCHMARK(SerializeDoubleList) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kLength = 100000;
+  const Array& array = Array::Handle(Array::New(kLength));
+  Double& element = Double::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    element = Double::New(static_cast<double>(i));
+    array.SetAt(i, element);
+  }
+  BenchmarkMessageSerialization(benchmark, thread, array,
+                                kLength * sizeof(double));
+}
+
+BENCHMARK(SerializeStringList) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kLength = 20000;
+  const Array& array = Array::Handle(Array::New(kLength));
+  String& element = String::Handle();
+  intptr_t payload_bytes = 0;
+  for (intptr_t i = 0; i < kLength; i++) {
+    element = String::NewFormatted("string %" Pd " of the message", i);
+    array.SetAt(i, element);
+    payload_bytes += element.Length();
+  }
+  BenchmarkMessageSerialization(benchmark, thread, array, payload_bytes);
+}
+
+BENCHMARK(SerializeNestedLists) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kLength = 20000;
+  const intptr_t kInnerLength = 4;
+  const Array& array = Array::Handle(Array::New(kLength));
+  Array& inner = Array::Handle();
+  Smi& element = Smi::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    inner = Array::New(kInnerLength);
+    for (intptr_t j = 0; j < kInnerLength; j++) {
+      element = Smi::New(j);
+      inner.SetAt(j, element);
+    }
+    array.SetAt(i, inner);
+  }
+  BenchmarkMessageSerialization(benchmark, thread, array,
+                                kLength * kInnerLength * kWordSize);
+}
+
+// Sends the same buffer back and forth as a TransferableTypedData, which
+// moves ownership of the buffer instead of copying it. Compare the score
+// with SerializeUint8List, which copies a buffer of the same size.
+BENCHMARK(TransferTypedData) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kLength = 4 * MB;
+  const intptr_t kLoopCount = 100;
+  uint8_t* data = reinterpret_cast<uint8_t*>(malloc(kLength));
+  memset(data, 0, kLength);
+  Object& transferable =
+      Object::Handle(TransferableTypedData::New(data, kLength));
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    MessageWriter writer(true);
+    std::unique_ptr<Message> message = writer.WriteMessage(
+        transferable, ILLEGAL_PORT, Message::kNormalPriority);
+    MessageSnapshotReader reader(message.get(), thread);
+    transferable = reader.ReadObject();
+  }
+  benchmark->set_score(OS::GetCurrentMonotonicMicros() - start);
+  EXPECT(transferable.IsTransferableTypedData());
+}
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
@@ -17,6 +17,8 @@
 
 namespace dart {
 
+class Histogram;
+
 DECLARE_FLAG(int, code_heap_size);
 DECLARE_FLAG(int, old_gen_growth_space_ratio);
 
@@ -83,6 +85,14 @@ class Benchmark {
   int64_t score() const { return score_; }
   Isolate* isolate() const { return reinterpret_cast<Isolate*>(isolate_); }
 
+  // Prints a result besides the score, as "name.suffix(kind): value", the
+  // format of the score lines.
+  void PrintResult(const char* suffix, const char* kind, int64_t value) const;
+
+  // Prints the p50, p90, p99 and max of the histogram as results of the
+  // score kind.
+  void PrintPercentiles(const Histogram& histogram) const;
+
   void Run() { (*run_)(this); }
   void RunBenchmark();
 
@@ -89,6 +89,7 @@ class SymbolTraits {
  public:
   static const char* Name() { return "SymbolTraits"; }
   static bool ReportStats() { return false; }
+  static const bool kCachesHashes = true;
 
   static bool IsMatch(const Object& a, const Object& b) {
     const String& a_str = String::Cast(a);
@@ -149,6 +150,7 @@ class CanonicalTypeTraits {
  public:
   static const char* Name() { return "CanonicalTypeTraits"; }
   static bool ReportStats() { return false; }
+  static const bool kCachesHashes = true;
 
   // Called when growing the table.
   static bool IsMatch(const Object& a, const Object& b) {
@@ -188,6 +190,7 @@ class CanonicalTypeParameterTraits {
  public:
   static const char* Name() { return "CanonicalTypeParameterTraits"; }
   static bool ReportStats() { return false; }
+  static const bool kCachesHashes = true;
 
   // Called when growing the table.
   static bool IsMatch(const Object& a, const Object& b) {
@@ -230,6 +233,7 @@ class CanonicalTypeArgumentsTraits {
  public:
   static const char* Name() { return "CanonicalTypeArgumentsTraits"; }
   static bool ReportStats() { return false; }
+  static const bool kCachesHashes = true;
 
   // Called when growing the table.
   static bool IsMatch(const Object& a, const Object& b) {
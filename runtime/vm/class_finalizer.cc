@@ -201,10 +201,16 @@ bool ClassFinalizer::ProcessPendingClasses() {
     }
 #endif
 
-    // Finalize types in all classes.
-    for (intptr_t i = 0; i < class_array.Length(); i++) {
-      cls ^= class_array.At(i);
-      FinalizeTypesInClass(cls);
+    // Finalize types in all classes. The program lock is taken once for the
+    // whole batch rather than by each FinalizeTypesInClass call, which only
+    // re-enters it.
+    {
+      SafepointWriteRwLocker ml(thread,
+                                thread->isolate_group()->program_lock());
+      for (intptr_t i = 0; i < class_array.Length(); i++) {
+        cls ^= class_array.At(i);
+        FinalizeTypesInClass(cls);
+      }
     }
 
     // Clear pending classes array.
@@ -7,6 +7,7 @@
 #include "vm/clustered_snapshot.h"
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "vm/bootstrap.h"
 #include "vm/bss_relocs.h"
 #include "vm/canonical_tables.h"
@@ -20,12 +21,17 @@
 #include "vm/growable_array.h"
 #include "vm/heap/heap.h"
 #include "vm/image_snapshot.h"
+#include "vm/lockers.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
+#include "vm/os.h"
 #include "vm/program_visitor.h"
+#include "vm/reverse_pc_lookup_cache.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/version.h"
 #include "vm/zone_text_buffer.h"
@@ -45,6 +51,12 @@ DEFINE_FLAG(bool,
             "Print information about clusters written to snapshot");
 #endif
 
+DEFINE_FLAG(int,
+            snapshot_fill_tasks,
+            2,
+            "The number of threads, including the main thread, filling the "
+            "objects of a snapshot.");
+
 #if defined(DART_PRECOMPILER)
 DEFINE_FLAG(charp,
             write_v8_snapshot_profile_to,
@@ -476,6 +488,8 @@ class TypeArgumentsDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TypeArgumentsPtr type_args = static_cast<TypeArgumentsPtr>(d->Ref(id));
@@ -498,6 +512,7 @@ class TypeArgumentsDeserializationCluster : public DeserializationCluster {
     if (is_canonical && (d->isolate() != Dart::vm_isolate())) {
       CanonicalTypeArgumentsSet table(
           d->zone(), d->isolate()->object_store()->canonical_type_arguments());
+      table.Reserve(stop_index_ - start_index_);
       TypeArguments& type_arg = TypeArguments::Handle(d->zone());
       for (intptr_t i = start_index_; i < stop_index_; i++) {
         type_arg ^= refs.At(i);
@@ -637,6 +652,17 @@ class FunctionSerializationCluster : public SerializationCluster {
 
       s->Write<uint32_t>(func->ptr()->packed_fields_);
       s->Write<uint32_t>(func->ptr()->kind_tag_);
+
+      if (kind == Snapshot::kFullJIT) {
+        // Keep the feedback of the training run: hot functions reach the
+        // optimization threshold again soon, and functions that deoptimized
+        // too often stay unoptimized. WasCompiled is per VM instantiation.
+        s->Write<int32_t>(func->ptr()->usage_counter_);
+        s->Write<int8_t>(func->ptr()->deoptimization_counter_);
+        s->Write<int8_t>(Function::WasCompiledBit::update(
+            false, func->ptr()->state_bits_));
+        s->Write<int8_t>(func->ptr()->inlining_depth_);
+      }
     }
   }
 
@@ -676,6 +702,8 @@ class FunctionDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     Snapshot::Kind kind = d->kind();
 
@@ -713,12 +741,19 @@ class FunctionDeserializationCluster : public DeserializationCluster {
         // Omit fields used to support de/reoptimization.
       } else {
 #if !defined(DART_PRECOMPILED_RUNTIME)
-        func->ptr()->usage_counter_ = 0;
         func->ptr()->optimized_instruction_count_ = 0;
         func->ptr()->optimized_call_site_count_ = 0;
-        func->ptr()->deoptimization_counter_ = 0;
-        func->ptr()->state_bits_ = 0;
-        func->ptr()->inlining_depth_ = 0;
+        if (kind == Snapshot::kFullJIT) {
+          func->ptr()->usage_counter_ = d->Read<int32_t>();
+          func->ptr()->deoptimization_counter_ = d->Read<int8_t>();
+          func->ptr()->state_bits_ = d->Read<int8_t>();
+          func->ptr()->inlining_depth_ = d->Read<int8_t>();
+        } else {
+          func->ptr()->usage_counter_ = 0;
+          func->ptr()->deoptimization_counter_ = 0;
+          func->ptr()->state_bits_ = 0;
+          func->ptr()->inlining_depth_ = 0;
+        }
 #endif
       }
     }
@@ -941,6 +976,7 @@ class FfiTrampolineDataSerializationCluster : public SerializationCluster {
       FfiTrampolineDataPtr const data = objects_[i];
       AutoTraceObject(data);
       WriteFromTo(data);
+      s->Write<bool>(data->ptr()->is_leaf_);
 
       if (s->kind() == Snapshot::kFullAOT) {
         s->WriteUnsigned(data->ptr()->callback_id_);
@@ -979,6 +1015,7 @@ class FfiTrampolineDataDeserializationCluster : public DeserializationCluster {
       Deserializer::InitializeHeader(data, kFfiTrampolineDataCid,
                                      FfiTrampolineData::InstanceSize());
       ReadFromTo(data);
+      data->ptr()->is_leaf_ = d->Read<bool>();
       data->ptr()->callback_id_ =
           d->kind() == Snapshot::kFullAOT ? d->ReadUnsigned() : 0;
     }
@@ -1431,17 +1468,9 @@ class KernelProgramInfoDeserializationCluster : public DeserializationCluster {
     }
   }
 
-  void PostLoad(Deserializer* d, const Array& refs, bool is_canonical) {
-    Array& array = Array::Handle(d->zone());
-    KernelProgramInfo& info = KernelProgramInfo::Handle(d->zone());
-    for (intptr_t id = start_index_; id < stop_index_; id++) {
-      info ^= refs.At(id);
-      array = HashTables::New<UnorderedHashMap<SmiTraits>>(16, Heap::kOld);
-      info.set_libraries_cache(array);
-      array = HashTables::New<UnorderedHashMap<SmiTraits>>(16, Heap::kOld);
-      info.set_classes_cache(array);
-    }
-  }
+  // The libraries and classes caches are not part of the snapshot. They are
+  // left null here and allocated on the first insertion, since most programs
+  // loaded from a snapshot never look up a kernel library or class again.
 };
 
 class CodeSerializationCluster : public SerializationCluster {
@@ -1544,11 +1573,32 @@ class CodeSerializationCluster : public SerializationCluster {
     order_list->Add(info);
   }
 
+  // With AOT feedback loaded, code of functions that never ran during the
+  // training run is placed after all other code, so hot code is packed
+  // together in the instructions image.
+  static bool IsColdCode(CodePtr code) {
+    if (!Isolate::Current()->has_aot_feedback()) {
+      return false;
+    }
+    ObjectPtr owner = code->ptr()->owner_;
+    if (!owner->IsHeapObject() || (owner->GetClassId() != kFunctionCid)) {
+      return false;
+    }
+    return !Function::Handle(Function::RawCast(owner)).WasExecuted();
+  }
+
   static void Sort(GrowableArray<CodePtr>* codes) {
     GrowableArray<CodeOrderInfo> order_list;
     IntMap<intptr_t> order_map;
     for (intptr_t i = 0; i < codes->length(); i++) {
-      Insert(&order_list, &order_map, (*codes)[i]);
+      if (!IsColdCode((*codes)[i])) {
+        Insert(&order_list, &order_map, (*codes)[i]);
+      }
+    }
+    for (intptr_t i = 0; i < codes->length(); i++) {
+      if (IsColdCode((*codes)[i])) {
+        Insert(&order_list, &order_map, (*codes)[i]);
+      }
     }
     order_list.Sort(CompareCodeOrderInfo);
     ASSERT(order_list.length() == codes->length());
@@ -1561,7 +1611,14 @@ class CodeSerializationCluster : public SerializationCluster {
     GrowableArray<CodeOrderInfo> order_list;
     IntMap<intptr_t> order_map;
     for (intptr_t i = 0; i < codes->length(); i++) {
-      Insert(&order_list, &order_map, (*codes)[i]->raw());
+      if (!IsColdCode((*codes)[i]->raw())) {
+        Insert(&order_list, &order_map, (*codes)[i]->raw());
+      }
+    }
+    for (intptr_t i = 0; i < codes->length(); i++) {
+      if (IsColdCode((*codes)[i]->raw())) {
+        Insert(&order_list, &order_map, (*codes)[i]->raw());
+      }
     }
     order_list.Sort(CompareCodeOrderInfo);
     ASSERT(order_list.length() == codes->length());
@@ -1974,6 +2031,8 @@ class ObjectPoolDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id += 1) {
       const intptr_t length = d->ReadUnsigned();
@@ -2211,6 +2270,8 @@ class PcDescriptorsDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id += 1) {
       const intptr_t length = d->ReadUnsigned();
@@ -2313,6 +2374,7 @@ class RODataDeserializationCluster : public DeserializationCluster {
         (d->isolate() != Dart::vm_isolate())) {
       CanonicalStringSet table(d->zone(),
                                d->isolate()->object_store()->symbol_table());
+      table.Reserve(stop_index_ - start_index_);
       String& str = String::Handle(d->zone());
       for (intptr_t i = start_index_; i < stop_index_; i++) {
         str ^= refs.At(i);
@@ -2397,6 +2459,8 @@ class ExceptionHandlersDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       ExceptionHandlersPtr handlers =
@@ -2485,6 +2549,8 @@ class ContextDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       ContextPtr context = static_cast<ContextPtr>(d->Ref(id));
@@ -3181,6 +3247,8 @@ class InstanceDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     intptr_t next_field_offset = next_field_offset_in_words_ << kWordSizeLog2;
     intptr_t instance_size =
@@ -3369,6 +3437,8 @@ class TypeDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TypePtr type = static_cast<TypePtr>(d->Ref(id));
@@ -3386,6 +3456,7 @@ class TypeDeserializationCluster : public DeserializationCluster {
     if (is_canonical && (d->isolate() != Dart::vm_isolate())) {
       CanonicalTypeSet table(d->zone(),
                              d->isolate()->object_store()->canonical_types());
+      table.Reserve(stop_index_ - start_index_);
       Type& type = Type::Handle(d->zone());
       for (intptr_t i = start_index_; i < stop_index_; i++) {
         type ^= refs.At(i);
@@ -3587,6 +3658,7 @@ class TypeParameterDeserializationCluster : public DeserializationCluster {
     if (is_canonical && (d->isolate() != Dart::vm_isolate())) {
       CanonicalTypeParameterSet table(
           d->zone(), d->isolate()->object_store()->canonical_type_parameters());
+      table.Reserve(stop_index_ - start_index_);
       TypeParameter& type_param = TypeParameter::Handle(d->zone());
       for (intptr_t i = start_index_; i < stop_index_; i++) {
         type_param ^= refs.At(i);
@@ -3818,6 +3890,8 @@ class DoubleDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       DoublePtr dbl = static_cast<DoublePtr>(d->Ref(id));
@@ -3958,6 +4032,8 @@ class TypedDataDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     intptr_t element_size = TypedData::ElementSizeInBytes(cid_);
 
@@ -4519,6 +4595,8 @@ class ArrayDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       ArrayPtr array = static_cast<ArrayPtr>(d->Ref(id));
@@ -4597,6 +4675,8 @@ class OneByteStringDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       OneByteStringPtr str = static_cast<OneByteStringPtr>(d->Ref(id));
@@ -4619,6 +4699,7 @@ class OneByteStringDeserializationCluster : public DeserializationCluster {
     if (is_canonical && (d->isolate() != Dart::vm_isolate())) {
       CanonicalStringSet table(d->zone(),
                                d->isolate()->object_store()->symbol_table());
+      table.Reserve(stop_index_ - start_index_);
       String& str = String::Handle(d->zone());
       for (intptr_t i = start_index_; i < stop_index_; i++) {
         str ^= refs.At(i);
@@ -4690,6 +4771,8 @@ class TwoByteStringDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanReadFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d, bool is_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TwoByteStringPtr str = static_cast<TwoByteStringPtr>(d->Ref(id));
@@ -4713,6 +4796,7 @@ class TwoByteStringDeserializationCluster : public DeserializationCluster {
     if (is_canonical && (d->isolate() != Dart::vm_isolate())) {
       CanonicalStringSet table(d->zone(),
                                d->isolate()->object_store()->symbol_table());
+      table.Reserve(stop_index_ - start_index_);
       String& str = String::Handle(d->zone());
       for (intptr_t i = start_index_; i < stop_index_; i++) {
         str ^= refs.At(i);
@@ -5423,7 +5507,7 @@ bool Serializer::CreateArtificalNodeIfNeeded(ObjectPtr obj) {
 }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
-const char* Serializer::ReadOnlyObjectType(intptr_t cid) {
+const char* Serializer::ReadOnlyObjectType(intptr_t cid, bool is_canonical) {
   switch (cid) {
     case kPcDescriptorsCid:
       return "PcDescriptors";
@@ -5439,12 +5523,20 @@ const char* Serializer::ReadOnlyObjectType(intptr_t cid) {
       return current_loading_unit_id_ <= LoadingUnit::kRootId
                  ? "TwoByteStringCid"
                  : nullptr;
+    case kDoubleCid:
+      // JIT code may update the value of a boxed double held in an unboxed
+      // field in place, so only AOT snapshots share canonical doubles.
+      return (kind_ == Snapshot::kFullAOT) && is_canonical &&
+                     (current_loading_unit_id_ <= LoadingUnit::kRootId)
+                 ? "Double"
+                 : nullptr;
     default:
       return nullptr;
   }
 }
 
-SerializationCluster* Serializer::NewClusterForClass(intptr_t cid) {
+SerializationCluster* Serializer::NewClusterForClass(intptr_t cid,
+                                                    bool is_canonical) {
 #if defined(DART_PRECOMPILED_RUNTIME)
   UNREACHABLE();
   return NULL;
@@ -5465,7 +5557,7 @@ SerializationCluster* Serializer::NewClusterForClass(intptr_t cid) {
   }
 
   if (Snapshot::IncludesCode(kind_)) {
-    if (auto const type = ReadOnlyObjectType(cid)) {
+    if (auto const type = ReadOnlyObjectType(cid, is_canonical)) {
       return new (Z) RODataSerializationCluster(Z, type, cid);
     }
   }
@@ -5712,7 +5804,7 @@ void Serializer::Trace(ObjectPtr object) {
   SerializationCluster** cluster_ref =
       is_canonical ? &canonical_clusters_by_cid_[cid] : &clusters_by_cid_[cid];
   if (*cluster_ref == nullptr) {
-    *cluster_ref = NewClusterForClass(cid);
+    *cluster_ref = NewClusterForClass(cid, is_canonical);
     if (*cluster_ref == nullptr) {
       UnexpectedObject(object, "No serialization cluster defined");
     }
@@ -5872,18 +5964,41 @@ ZoneGrowableArray<Object*>* Serializer::Serialize(SerializationRoots* roots) {
   }
 #endif
 
+  // Reserve a table for the offset of the fill of each cluster and of the end
+  // of the fill section, so the reader can fill independent clusters in
+  // parallel. The offsets are relative to the end of the table.
+  const intptr_t num_all_clusters =
+      canonical_clusters.length() + clusters.length();
+  const intptr_t fill_offsets_position = stream_->Position();
+  for (intptr_t i = 0; i <= num_all_clusters; i++) {
+    stream_->WriteFixed<uint32_t>(0);
+  }
+  const intptr_t fill_start = stream_->Position();
+  intptr_t fill_index = 0;
+  auto record_fill_offset = [&]() {
+    const uint32_t offset = stream_->Position() - fill_start;
+    memmove(stream_->buffer() + fill_offsets_position +
+                fill_index * sizeof(uint32_t),
+            &offset, sizeof(uint32_t));
+    fill_index++;
+  };
+
   for (SerializationCluster* cluster : canonical_clusters) {
+    record_fill_offset();
     cluster->WriteAndMeasureFill(this);
 #if defined(DEBUG)
     Write<int32_t>(kSectionMarker);
 #endif
   }
   for (SerializationCluster* cluster : clusters) {
+    record_fill_offset();
     cluster->WriteAndMeasureFill(this);
 #if defined(DEBUG)
     Write<int32_t>(kSectionMarker);
 #endif
   }
+  record_fill_offset();
+  ASSERT(fill_index == num_all_clusters + 1);
 
   roots->WriteRoots(this);
 
@@ -6133,12 +6248,33 @@ Deserializer::Deserializer(Thread* thread,
   stream_.SetPosition(offset);
 }
 
+Deserializer::Deserializer(const Deserializer* parent,
+                           const uint8_t* buffer,
+                           intptr_t size)
+    : ThreadStackResource(nullptr),
+      heap_(parent->heap_),
+      zone_(nullptr),
+      kind_(parent->kind_),
+      stream_(buffer, size),
+      image_reader_(nullptr),
+      num_base_objects_(parent->num_base_objects_),
+      num_objects_(parent->num_objects_),
+      num_canonical_clusters_(0),
+      num_clusters_(0),
+      refs_(parent->refs_),
+      next_ref_index_(parent->next_ref_index_),
+      previous_text_offset_(0),
+      canonical_clusters_(nullptr),
+      clusters_(nullptr),
+      initial_field_table_(parent->initial_field_table_),
+      is_non_root_unit_(parent->is_non_root_unit_) {}
+
 Deserializer::~Deserializer() {
   delete[] canonical_clusters_;
   delete[] clusters_;
 }
 
-DeserializationCluster* Deserializer::ReadCluster() {
+DeserializationCluster* Deserializer::ReadCluster(bool is_canonical) {
   intptr_t cid = ReadCid();
   Zone* Z = zone_;
   if (cid >= kNumPredefinedCids || cid == kInstanceCid) {
@@ -6166,6 +6302,12 @@ DeserializationCluster* Deserializer::ReadCluster() {
           return new (Z) RODataDeserializationCluster(cid);
         }
         break;
+      case kDoubleCid:
+        if ((kind_ == Snapshot::kFullAOT) && is_canonical &&
+            !is_non_root_unit_) {
+          return new (Z) RODataDeserializationCluster(cid);
+        }
+        break;
     }
   }
 
@@ -6515,7 +6657,8 @@ void Deserializer::EndInstructions(const Array& refs,
                                    intptr_t stop_index) {
 #if defined(DART_PRECOMPILED_RUNTIME)
   if (FLAG_use_bare_instructions) {
-    uword previous_end = image_reader_->GetBareInstructionsEnd();
+    const uword instructions_end = image_reader_->GetBareInstructionsEnd();
+    uword previous_end = instructions_end;
     for (intptr_t id = stop_index - 1; id >= start_index; id--) {
       CodePtr code = static_cast<CodePtr>(refs.At(id));
       uword start = Code::PayloadStartOf(code);
@@ -6537,10 +6680,19 @@ void Deserializer::EndInstructions(const Array& refs,
     ObjectStore* object_store = Isolate::Current()->object_store();
     GrowableObjectArray& order_tables =
         GrowableObjectArray::Handle(zone_, object_store->code_order_tables());
+    GrowableObjectArray& order_table_indices = GrowableObjectArray::Handle(
+        zone_, object_store->code_order_table_indices());
     if (order_tables.IsNull()) {
+      ASSERT(order_table_indices.IsNull());
       order_tables = GrowableObjectArray::New(Heap::kOld);
+      order_table_indices = GrowableObjectArray::New(Heap::kOld);
+      object_store->set_code_order_table_indices(order_table_indices);
       object_store->set_code_order_tables(order_tables);
     }
+    // ReversePc::Lookup expects an index for every table it can see.
+    const TypedData& index = TypedData::Handle(
+        zone_, ReversePc::BuildIndex(order_table, instructions_end));
+    order_table_indices.Add(index, Heap::kOld);
     order_tables.Add(order_table, Heap::kOld);
   }
 #endif
@@ -6565,6 +6717,255 @@ class HeapLocker : public StackResource {
   FreeList* freelist_;
 };
 
+static intptr_t FillOffsetAt(const uint8_t* fill_offsets, intptr_t index) {
+  uint32_t offset;
+  memmove(&offset, fill_offsets + index * sizeof(uint32_t), sizeof(uint32_t));
+  return offset;
+}
+
+#if !defined(PRODUCT)
+SnapshotLoadTimings* SnapshotLoadTimings::current_ = nullptr;
+
+SnapshotLoadTimings::SnapshotLoadTimings() : mutex_(), clusters_() {
+  for (intptr_t i = 0; i < kNumPhases; i++) {
+    totals_[i] = 0;
+  }
+  ASSERT(current_ == nullptr);
+  current_ = this;
+}
+
+SnapshotLoadTimings::~SnapshotLoadTimings() {
+  ASSERT(current_ == this);
+  current_ = nullptr;
+}
+
+void SnapshotLoadTimings::Add(Phase phase,
+                              const char* cluster,
+                              bool is_canonical,
+                              int64_t micros) {
+  MutexLocker ml(&mutex_);
+  if (cluster == nullptr) {
+    totals_[phase] += micros;
+    return;
+  }
+  for (intptr_t i = 0; i < clusters_.length(); i++) {
+    ClusterTimings& timings = clusters_[i];
+    if ((timings.is_canonical == is_canonical) &&
+        (strcmp(timings.name, cluster) == 0)) {
+      timings.micros[phase] += micros;
+      return;
+    }
+  }
+  ClusterTimings timings;
+  timings.name = cluster;
+  timings.is_canonical = is_canonical;
+  for (intptr_t i = 0; i < kNumPhases; i++) {
+    timings.micros[i] = 0;
+  }
+  timings.micros[phase] = micros;
+  clusters_.Add(timings);
+}
+
+const char* SnapshotLoadTimings::PhaseName(Phase phase) {
+  switch (phase) {
+    case kImage:
+      return "Image";
+    case kReadAlloc:
+      return "ReadAlloc";
+    case kReadFill:
+      return "ReadFill";
+    case kRoots:
+      return "Roots";
+    case kPostLoad:
+      return "PostLoad";
+    default:
+      UNREACHABLE();
+      return nullptr;
+  }
+}
+
+void SnapshotLoadTimings::Print(const char* prefix, intptr_t num_loads) const {
+  ASSERT(num_loads > 0);
+  for (intptr_t i = 0; i < kNumPhases; i++) {
+    const Phase phase = static_cast<Phase>(i);
+    OS::Print("%s.%s(RunTime): %" Pd64 "\n", prefix, PhaseName(phase),
+              totals_[i] / num_loads);
+    for (intptr_t j = 0; j < clusters_.length(); j++) {
+      const ClusterTimings& timings = clusters_[j];
+      if (timings.micros[i] == 0) continue;
+      OS::Print("%s.%s.%s%s(RunTime): %" Pd64 "\n", prefix, PhaseName(phase),
+                timings.is_canonical ? "Canonical" : "", timings.name,
+                timings.micros[i] / num_loads);
+    }
+  }
+}
+
+// Measures a phase of reading a snapshot, or the work for one cluster in it,
+// while timings are being collected.
+class SnapshotLoadTimer : public ValueObject {
+ public:
+  explicit SnapshotLoadTimer(SnapshotLoadTimings::Phase phase,
+                             const char* cluster = nullptr,
+                             bool is_canonical = false)
+      : timings_(SnapshotLoadTimings::Current()),
+        phase_(phase),
+        cluster_(cluster),
+        is_canonical_(is_canonical),
+        start_(timings_ == nullptr ? 0 : OS::GetCurrentMonotonicMicros()) {}
+
+  ~SnapshotLoadTimer() {
+    if (timings_ != nullptr) {
+      timings_->Add(phase_, cluster_, is_canonical_,
+                    OS::GetCurrentMonotonicMicros() - start_);
+    }
+  }
+
+ private:
+  SnapshotLoadTimings* const timings_;
+  const SnapshotLoadTimings::Phase phase_;
+  const char* const cluster_;
+  const bool is_canonical_;
+  const int64_t start_;
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotLoadTimer);
+};
+
+#define SNAPSHOT_LOAD_TIMER(...)                                               \
+  SnapshotLoadTimer snapshot_load_timer(__VA_ARGS__)
+#else
+#define SNAPSHOT_LOAD_TIMER(...)
+#endif  // !defined(PRODUCT)
+
+struct ConcurrentFill {
+  DeserializationCluster* cluster;
+  bool is_canonical;
+  intptr_t position;
+};
+
+// Reads the fill of clusters on a helper thread.
+class ConcurrentFillTask : public ThreadPool::Task {
+ public:
+  ConcurrentFillTask(const Deserializer* parent,
+                     const uint8_t* buffer,
+                     intptr_t size,
+                     GrowableArray<ConcurrentFill>* fills,
+                     RelaxedAtomic<intptr_t>* next_fill,
+                     ThreadBarrier* barrier)
+      : parent_(parent),
+        buffer_(buffer),
+        size_(size),
+        fills_(fills),
+        next_fill_(next_fill),
+        barrier_(barrier) {}
+
+  void Run() {
+    RunFills(parent_, buffer_, size_, fills_, next_fill_);
+    barrier_->Exit();
+  }
+
+  static void RunFills(const Deserializer* parent,
+                       const uint8_t* buffer,
+                       intptr_t size,
+                       GrowableArray<ConcurrentFill>* fills,
+                       RelaxedAtomic<intptr_t>* next_fill) {
+    Deserializer d(parent, buffer, size);
+    for (intptr_t i = next_fill->fetch_add(1); i < fills->length();
+         i = next_fill->fetch_add(1)) {
+      const ConcurrentFill& fill = (*fills)[i];
+      d.ReadClusterFill(fill.cluster, fill.is_canonical, fill.position);
+    }
+  }
+
+ private:
+  const Deserializer* parent_;
+  const uint8_t* buffer_;
+  intptr_t size_;
+  GrowableArray<ConcurrentFill>* fills_;
+  RelaxedAtomic<intptr_t>* next_fill_;
+  ThreadBarrier* barrier_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentFillTask);
+};
+
+void Deserializer::ReadClusterFill(DeserializationCluster* cluster,
+                                   bool is_canonical,
+                                   intptr_t position) {
+  SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kReadFill, cluster->name(),
+                      is_canonical);
+  stream_.SetPosition(position);
+  cluster->ReadFill(this, is_canonical);
+#if defined(DEBUG)
+  int32_t section_marker = Read<int32_t>();
+  ASSERT(section_marker == kSectionMarker);
+#endif
+}
+
+void Deserializer::ReadFills(const uint8_t* fill_offsets) {
+  const intptr_t fill_start = stream_.Position();
+  const intptr_t num_all_clusters = num_canonical_clusters_ + num_clusters_;
+  // Large clusters which can be filled concurrently are left to the helper
+  // threads, the main thread fills the others in order.
+  const intptr_t kMinConcurrentFillSize = 64 * KB;
+  GrowableArray<ConcurrentFill> concurrent_fills;
+  for (intptr_t i = 0; i < num_all_clusters; i++) {
+    const bool is_canonical = i < num_canonical_clusters_;
+    DeserializationCluster* cluster =
+        is_canonical ? canonical_clusters_[i]
+                     : clusters_[i - num_canonical_clusters_];
+    const intptr_t position = fill_start + FillOffsetAt(fill_offsets, i);
+    const intptr_t size = FillOffsetAt(fill_offsets, i + 1) -
+                          FillOffsetAt(fill_offsets, i);
+    if ((FLAG_snapshot_fill_tasks > 1) && cluster->CanReadFillConcurrently() &&
+        (size >= kMinConcurrentFillSize)) {
+      concurrent_fills.Add({cluster, is_canonical, position});
+    }
+  }
+
+  const uint8_t* buffer = CurrentBufferAddress() - fill_start;
+  const intptr_t buffer_size = fill_start + stream_.PendingBytes();
+  const intptr_t num_tasks =
+      concurrent_fills.is_empty()
+          ? 0
+          : Utils::Minimum<intptr_t>(FLAG_snapshot_fill_tasks - 1,
+                                     concurrent_fills.length());
+  {
+    Monitor monitor;
+    Monitor done_monitor;
+    ThreadBarrier barrier(num_tasks + 1, &monitor, &done_monitor);
+    RelaxedAtomic<intptr_t> next_fill = {0};
+    for (intptr_t i = 0; i < num_tasks; i++) {
+      if (!Dart::thread_pool()->Run<ConcurrentFillTask>(
+              this, buffer, buffer_size, &concurrent_fills, &next_fill,
+              &barrier)) {
+        barrier.Exit();
+      }
+    }
+
+    intptr_t next_concurrent = 0;
+    for (intptr_t i = 0; i < num_all_clusters; i++) {
+      const bool is_canonical = i < num_canonical_clusters_;
+      DeserializationCluster* cluster =
+          is_canonical ? canonical_clusters_[i]
+                       : clusters_[i - num_canonical_clusters_];
+      if ((next_concurrent < concurrent_fills.length()) &&
+          (concurrent_fills[next_concurrent].cluster == cluster)) {
+        next_concurrent++;
+        continue;
+      }
+      TIMELINE_DURATION(thread(), Isolate, cluster->name());
+      ReadClusterFill(cluster, is_canonical,
+                      fill_start + FillOffsetAt(fill_offsets, i));
+    }
+
+    // Help the helper threads with the remaining clusters.
+    ConcurrentFillTask::RunFills(this, buffer, buffer_size, &concurrent_fills,
+                                 &next_fill);
+    barrier.Exit();
+  }
+  stream_.SetPosition(fill_start +
+                      FillOffsetAt(fill_offsets, num_all_clusters));
+}
+
 void Deserializer::Deserialize(DeserializationRoots* roots) {
   Array& refs = Array::Handle(zone_);
   num_base_objects_ = ReadUnsigned();
@@ -6595,9 +6996,12 @@ void Deserializer::Deserialize(DeserializationRoots* roots) {
 
     {
       TIMELINE_DURATION(thread(), Isolate, "ReadAlloc");
+      SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kReadAlloc);
       for (intptr_t i = 0; i < num_canonical_clusters_; i++) {
-        canonical_clusters_[i] = ReadCluster();
+        canonical_clusters_[i] = ReadCluster(/*is_canonical*/ true);
         TIMELINE_DURATION(thread(), Isolate, canonical_clusters_[i]->name());
+        SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kReadAlloc,
+                            canonical_clusters_[i]->name(), true);
         canonical_clusters_[i]->ReadAlloc(this, /*is_canonical*/ true);
 #if defined(DEBUG)
         intptr_t serializers_next_ref_index_ = Read<int32_t>();
@@ -6605,8 +7009,10 @@ void Deserializer::Deserialize(DeserializationRoots* roots) {
 #endif
       }
       for (intptr_t i = 0; i < num_clusters_; i++) {
-        clusters_[i] = ReadCluster();
+        clusters_[i] = ReadCluster(/*is_canonical*/ false);
         TIMELINE_DURATION(thread(), Isolate, clusters_[i]->name());
+        SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kReadAlloc,
+                            clusters_[i]->name(), false);
         clusters_[i]->ReadAlloc(this, /*is_canonical*/ false);
 #if defined(DEBUG)
         intptr_t serializers_next_ref_index_ = Read<int32_t>();
@@ -6620,25 +7026,18 @@ void Deserializer::Deserialize(DeserializationRoots* roots) {
 
     {
       TIMELINE_DURATION(thread(), Isolate, "ReadFill");
-      for (intptr_t i = 0; i < num_canonical_clusters_; i++) {
-        TIMELINE_DURATION(thread(), Isolate, canonical_clusters_[i]->name());
-        canonical_clusters_[i]->ReadFill(this, /*is_canonical*/ true);
-#if defined(DEBUG)
-        int32_t section_marker = Read<int32_t>();
-        ASSERT(section_marker == kSectionMarker);
-#endif
-      }
-      for (intptr_t i = 0; i < num_clusters_; i++) {
-        TIMELINE_DURATION(thread(), Isolate, clusters_[i]->name());
-        clusters_[i]->ReadFill(this, /*is_canonical*/ false);
-#if defined(DEBUG)
-        int32_t section_marker = Read<int32_t>();
-        ASSERT(section_marker == kSectionMarker);
-#endif
-      }
+      SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kReadFill);
+      const uint8_t* fill_offsets = CurrentBufferAddress();
+      Advance((num_canonical_clusters_ + num_clusters_ + 1) *
+              sizeof(uint32_t));
+      ReadFills(fill_offsets);
     }
 
-    roots->ReadRoots(this);
+    {
+      TIMELINE_DURATION(thread(), Isolate, "ReadRoots");
+      SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kRoots);
+      roots->ReadRoots(this);
+    }
 
 #if defined(DEBUG)
     int32_t section_marker = Read<int32_t>();
@@ -6649,7 +7048,11 @@ void Deserializer::Deserialize(DeserializationRoots* roots) {
     refs_ = NULL;
   }
 
-  roots->PostLoad(this, refs);
+  {
+    TIMELINE_DURATION(thread(), Isolate, "PostLoadRoots");
+    SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kRoots);
+    roots->PostLoad(this, refs);
+  }
 
 #if defined(DEBUG)
   Isolate* isolate = thread()->isolate();
@@ -6665,12 +7068,17 @@ void Deserializer::Deserialize(DeserializationRoots* roots) {
   // the losers of any canonicalization races.
   {
     TIMELINE_DURATION(thread(), Isolate, "PostLoad");
+    SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kPostLoad);
     for (intptr_t i = 0; i < num_canonical_clusters_; i++) {
       TIMELINE_DURATION(thread(), Isolate, canonical_clusters_[i]->name());
+      SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kPostLoad,
+                          canonical_clusters_[i]->name(), true);
       canonical_clusters_[i]->PostLoad(this, refs, /*is_canonical*/ true);
     }
     for (intptr_t i = 0; i < num_clusters_; i++) {
       TIMELINE_DURATION(thread(), Isolate, clusters_[i]->name());
+      SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kPostLoad, clusters_[i]->name(),
+                          false);
       clusters_[i]->PostLoad(this, refs, /*is_canonical*/ false);
     }
   }
@@ -7043,6 +7451,7 @@ ApiErrorPtr FullSnapshotReader::ReadVMSnapshot() {
   }
 
   if (Snapshot::IncludesCode(kind_)) {
+    SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kImage);
     ASSERT(data_image_ != NULL);
     thread_->isolate()->SetupImagePage(data_image_,
                                        /* is_executable */ false);
@@ -7084,6 +7493,7 @@ ApiErrorPtr FullSnapshotReader::ReadProgramSnapshot() {
   }
 
   if (Snapshot::IncludesCode(kind_)) {
+    SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kImage);
     ASSERT(data_image_ != NULL);
     thread_->isolate()->SetupImagePage(data_image_,
                                        /* is_executable */ false);
@@ -7130,6 +7540,7 @@ ApiErrorPtr FullSnapshotReader::ReadUnitSnapshot(const LoadingUnit& unit) {
   }
 
   if (Snapshot::IncludesCode(kind_)) {
+    SNAPSHOT_LOAD_TIMER(SnapshotLoadTimings::kImage);
     ASSERT(data_image_ != NULL);
     thread_->isolate()->SetupImagePage(data_image_,
                                        /* is_executable */ false);
@@ -15,6 +15,7 @@
 #include "vm/heap/heap.h"
 #include "vm/image_snapshot.h"
 #include "vm/object.h"
+#include "vm/os_thread.h"
 #include "vm/raw_object_fields.h"
 #include "vm/snapshot.h"
 #include "vm/v8_snapshot_writer.h"
@@ -121,6 +122,12 @@ class DeserializationCluster : public ZoneAllocated {
   // Initialize the cluster's objects. Do not touch the memory of other objects.
   virtual void ReadFill(Deserializer* deserializer, bool is_canonical) = 0;
 
+  // Whether [ReadFill] can run on a helper thread, concurrently with the fill
+  // of other clusters. Such clusters only read from the stream and the ref
+  // array of the deserializer, and neither allocate nor use the thread, its
+  // zone or the isolate.
+  virtual bool CanReadFillConcurrently() const { return false; }
+
   // Complete any action that requires the full graph to be deserialized, such
   // as rehashing.
   virtual void PostLoad(Deserializer* deserializer,
@@ -202,7 +209,7 @@ class Serializer : public ThreadStackResource {
   ObjectPtr ParentOf(const Object& object);
 #endif
 
-  SerializationCluster* NewClusterForClass(intptr_t cid);
+  SerializationCluster* NewClusterForClass(intptr_t cid, bool is_canonical);
 
   void ReserveHeader() {
     // Make room for recording snapshot buffer size.
@@ -417,7 +424,7 @@ class Serializer : public ThreadStackResource {
   }
 
  private:
-  const char* ReadOnlyObjectType(intptr_t cid);
+  const char* ReadOnlyObjectType(intptr_t cid, bool is_canonical);
 
   Heap* heap_;
   Zone* zone_;
@@ -540,6 +547,60 @@ class SnapshotHeaderReader {
   ReadStream stream_;
 };
 
+#if !defined(PRODUCT)
+// Accumulates the time spent in the phases of reading snapshots, in total and
+// for each cluster, while it is alive. Only one collector can be alive at a
+// time. Used by the snapshot loading benchmarks.
+class SnapshotLoadTimings : public ValueObject {
+ public:
+  enum Phase {
+    kImage,      // Setting up the pages of the data and instructions images.
+    kReadAlloc,  // Allocating the objects of each cluster.
+    kReadFill,   // Filling the objects of each cluster.
+    kRoots,      // Reading the roots and their post-load fixups.
+    kPostLoad,   // Per-cluster post-load work, such as rebuilding canonical
+                 // tables for canonical clusters.
+    kNumPhases,
+  };
+
+  SnapshotLoadTimings();
+  ~SnapshotLoadTimings();
+
+  static SnapshotLoadTimings* Current() { return current_; }
+
+  // Adds [micros] to [cluster], or only to the total of [phase] if [cluster]
+  // is null. Thread safe.
+  void Add(Phase phase,
+           const char* cluster,
+           bool is_canonical,
+           int64_t micros);
+
+  int64_t Total(Phase phase) const { return totals_[phase]; }
+  intptr_t NumClusters() const { return clusters_.length(); }
+
+  // Prints the totals and the time of each cluster in each phase, averaged
+  // over [num_loads] snapshot loads, one line per measurement.
+  void Print(const char* prefix, intptr_t num_loads) const;
+
+  static const char* PhaseName(Phase phase);
+
+ private:
+  struct ClusterTimings {
+    const char* name;
+    bool is_canonical;
+    int64_t micros[kNumPhases];
+  };
+
+  static SnapshotLoadTimings* current_;
+
+  Mutex mutex_;
+  int64_t totals_[kNumPhases];
+  MallocGrowableArray<ClusterTimings> clusters_;
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotLoadTimings);
+};
+#endif  // !defined(PRODUCT)
+
 class Deserializer : public ThreadStackResource {
  public:
   Deserializer(Thread* thread,
@@ -552,6 +613,13 @@ class Deserializer : public ThreadStackResource {
                intptr_t offset = 0);
   ~Deserializer();
 
+  // A deserializer reading the fill of clusters of [parent] on a helper
+  // thread. It shares the completely allocated ref array of [parent] and
+  // reads from its own position in [buffer].
+  Deserializer(const Deserializer* parent,
+               const uint8_t* buffer,
+               intptr_t size);
+
   // Verifies the image alignment.
   //
   // Returns ApiError::null() on success and an ApiError with an an appropriate
@@ -632,7 +700,7 @@ class Deserializer : public ThreadStackResource {
 
   void Deserialize(DeserializationRoots* roots);
 
-  DeserializationCluster* ReadCluster();
+  DeserializationCluster* ReadCluster(bool is_canonical);
 
   void ReadDispatchTable() { ReadDispatchTable(&stream_); }
   void ReadDispatchTable(ReadStream* stream);
@@ -644,6 +712,18 @@ class Deserializer : public ThreadStackResource {
   FieldTable* initial_field_table() const { return initial_field_table_; }
 
  private:
+  friend class ConcurrentFillTask;
+
+  // Reads the fill of all clusters. [fill_offsets] holds the offset of the
+  // fill of each cluster, followed by the end of the fill section, from the
+  // current position.
+  void ReadFills(const uint8_t* fill_offsets);
+
+  // Reads the fill of [cluster] at [position] in the stream.
+  void ReadClusterFill(DeserializationCluster* cluster,
+                       bool is_canonical,
+                       intptr_t position);
+
   Heap* heap_;
   Zone* zone_;
   Snapshot::Kind kind_;
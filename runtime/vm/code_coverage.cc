@@ -0,0 +1,142 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/code_coverage.h"
+
+#include "platform/text_buffer.h"
+#include "vm/flags.h"
+#include "vm/hash_table.h"
+#include "vm/isolate.h"
+#include "vm/lockers.h"
+#include "vm/object.h"
+#include "vm/object_store.h"
+#include "vm/thread.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            code_coverage,
+            false,
+            "Record which basic blocks of Dart functions have run, in code of "
+            "all tiers, for Dart_GetCodeCoverage (JIT only).");
+
+class CodeCoverageTraits {
+ public:
+  static const char* Name() { return "CodeCoverageTraits"; }
+  static bool ReportStats() { return false; }
+  static bool IsMatch(const Object& a, const Object& b) {
+    return a.raw() == b.raw();
+  }
+  static uword Hash(const Object& key) { return Function::Cast(key).Hash(); }
+};
+typedef UnorderedHashMap<CodeCoverageTraits> CodeCoverageMap;
+
+static constexpr intptr_t kInitialCodeCoverageMapSize = 64;
+
+bool CodeCoverage::IsEnabled() {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  return false;
+#else
+  return FLAG_code_coverage && !FLAG_precompiled_mode;
+#endif
+}
+
+ArrayPtr CodeCoverage::ArrayFor(Thread* thread,
+                                const Function& function,
+                                const GrowableArray<TokenPosition>& positions) {
+  Zone* zone = thread->zone();
+  auto isolate_group = thread->isolate_group();
+  auto object_store = isolate_group->object_store();
+  SafepointMutexLocker ml(isolate_group->code_coverage_mutex());
+  if (object_store->code_coverage_map() == Array::null()) {
+    object_store->set_code_coverage_map(
+        Array::Handle(zone, HashTables::New<CodeCoverageMap>(
+                                kInitialCodeCoverageMapSize, Heap::kOld)));
+  }
+  CodeCoverageMap map(object_store->code_coverage_map());
+  auto& coverage = Array::Handle(zone);
+  coverage ^= map.GetOrNull(function);
+  if (coverage.IsNull()) {
+    coverage = Array::New(2 * positions.length(), Heap::kOld);
+    auto& value = Smi::Handle(zone);
+    const auto& not_hit = Smi::Handle(zone, Smi::New(0));
+    for (intptr_t i = 0; i < positions.length(); i++) {
+      ASSERT(positions[i].IsReal());
+      ASSERT((i == 0) || (positions[i - 1] < positions[i]));
+      value = Smi::New(positions[i].value());
+      coverage.SetAt(2 * i, value);
+      coverage.SetAt(2 * i + 1, not_hit);
+    }
+    map.UpdateOrInsert(function, coverage);
+  }
+  object_store->set_code_coverage_map(map.Release());
+  return coverage.raw();
+}
+
+intptr_t CodeCoverage::FlagIndexOf(const Array& coverage,
+                                   TokenPosition position) {
+  intptr_t lo = 0;
+  intptr_t hi = coverage.Length() / 2;
+  while (lo < hi) {
+    const intptr_t mid = lo + (hi - lo) / 2;
+    if (Smi::Value(Smi::RawCast(coverage.At(2 * mid))) < position.value()) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if ((lo < coverage.Length() / 2) &&
+      (Smi::Value(Smi::RawCast(coverage.At(2 * lo))) == position.value())) {
+    return 2 * lo + 1;
+  }
+  return -1;
+}
+
+void CodeCoverage::Print(Thread* thread, TextBuffer* buffer) {
+  Zone* zone = thread->zone();
+  auto isolate_group = thread->isolate_group();
+  GrowableArray<const Function*> functions(zone, 16);
+  GrowableArray<const Array*> arrays(zone, 16);
+  {
+    SafepointMutexLocker ml(isolate_group->code_coverage_mutex());
+    auto object_store = isolate_group->object_store();
+    if (object_store->code_coverage_map() == Array::null()) {
+      return;
+    }
+    CodeCoverageMap map(object_store->code_coverage_map());
+    CodeCoverageMap::Iterator it(&map);
+    while (it.MoveNext()) {
+      const intptr_t entry = it.Current();
+      functions.Add(
+          &Function::ZoneHandle(zone, Function::RawCast(map.GetKey(entry))));
+      arrays.Add(
+          &Array::ZoneHandle(zone, Array::RawCast(map.GetPayload(entry, 0))));
+    }
+    map.Release();
+  }
+
+  // Symbolizing positions may allocate, so it happens outside the lock taken
+  // by the compiler.
+  auto& script = Script::Handle(zone);
+  auto& uri = String::Handle(zone);
+  for (intptr_t i = 0; i < functions.length(); i++) {
+    script = functions[i]->script();
+    if (script.IsNull()) {
+      continue;
+    }
+    uri = script.url();
+    const char* uri_cstr = uri.ToCString();
+    const Array& coverage = *arrays[i];
+    for (intptr_t j = 0; j < coverage.Length(); j += 2) {
+      const TokenPosition position(Smi::Value(Smi::RawCast(coverage.At(j))));
+      intptr_t line = -1;
+      intptr_t column = -1;
+      script.GetTokenLocation(position, &line, &column);
+      buffer->Printf("%s:%" Pd ":%" Pd " %" Pd "\n", uri_cstr, line, column,
+                     Smi::Value(Smi::RawCast(coverage.At(j + 1))));
+    }
+  }
+}
+
+}  // namespace dart
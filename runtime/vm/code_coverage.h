@@ -0,0 +1,51 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_CODE_COVERAGE_H_
+#define RUNTIME_VM_CODE_COVERAGE_H_
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/tagged_pointer.h"
+#include "vm/token_position.h"
+
+namespace dart {
+
+class Array;
+class Function;
+class TextBuffer;
+class Thread;
+
+// Records which basic blocks of Dart functions have run, with --code_coverage.
+//
+// Unlike SourceReport, this does not depend on ICData or the VM service and
+// is not lost when code is optimized: the flow graph builder starts every
+// block with a source position with a store of Smi 1 into the hit flag of
+// that position in the coverage array of its function, so unoptimized,
+// optimized and inlined code all record hits. A coverage array holds
+// (position, hit) Smi pairs sorted by position. The coverage arrays are kept
+// in the isolate group's object store, which also keeps their functions.
+class CodeCoverage : public AllStatic {
+ public:
+  static bool IsEnabled();
+
+  // Returns the coverage array of function, first creating it for the
+  // sorted and distinct block positions if the function has none yet.
+  static ArrayPtr ArrayFor(Thread* thread,
+                           const Function& function,
+                           const GrowableArray<TokenPosition>& positions);
+
+  // Returns the index of the hit flag of position in coverage, or -1 if the
+  // array was created for a graph which had no block at position.
+  static intptr_t FlagIndexOf(const Array& coverage, TokenPosition position);
+
+  // Writes one "uri:line:column hit" line per recorded block, where hit is 1
+  // if the block has run and 0 otherwise. Functions which were never
+  // compiled, and so never ran, are not listed.
+  static void Print(Thread* thread, TextBuffer* buffer);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_CODE_COVERAGE_H_
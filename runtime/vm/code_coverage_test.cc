@@ -0,0 +1,55 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/code_coverage.h"
+#include "vm/flags.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+DECLARE_FLAG(bool, code_coverage);
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+// Returns the hit flag reported for the first block on line of test-lib.
+static char HitOnLine(const char* report, intptr_t line) {
+  char prefix[32];
+  Utils::SNPrint(prefix, sizeof(prefix), "test-lib:%" Pd ":", line);
+  const char* entry = strstr(report, prefix);
+  if (entry == NULL) return '?';
+  const char* space = strchr(entry, ' ');
+  return (space == NULL) ? '?' : space[1];
+}
+
+TEST_CASE(CodeCoverage_RecordsBlocks) {
+  SetFlagScope<bool> sfs(&FLAG_code_coverage, true);
+  const char* kScriptChars =
+      "int classify(int x) {\n"
+      "  if (x < 0) {\n"
+      "    return -1;\n"
+      "  }\n"
+      "  return 1;\n"
+      "}\n"
+      "main() {\n"
+      "  classify(1);\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+
+  char* coverage = NULL;
+  intptr_t coverage_length = 0;
+  char* error = NULL;
+  EXPECT(Dart_GetCodeCoverage(&coverage, &coverage_length, &error));
+  EXPECT(error == NULL);
+  EXPECT_EQ(static_cast<intptr_t>(strlen(coverage)), coverage_length);
+  EXPECT_EQ('0', HitOnLine(coverage, 3));
+  EXPECT_EQ('1', HitOnLine(coverage, 5));
+  free(coverage);
+}
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+}  // namespace dart
@@ -594,6 +594,59 @@ void CodeSourceMapReader::DumpInlineIntervals(uword start) {
   THR_Print("}\n");
 }
 
+void CodeSourceMapReader::GetInnermostPositions(
+    GrowableArray<int32_t>* pc_offsets,
+    GrowableArray<const Function*>* functions,
+    GrowableArray<TokenPosition>* token_positions) {
+  GrowableArray<const Function*> function_stack;
+  GrowableArray<TokenPosition> position_stack;
+  NoSafepointScope no_safepoint;
+  ReadStream stream(map_.Data(), map_.Length());
+
+  int32_t current_pc_offset = 0;
+  function_stack.Add(&root_);
+  position_stack.Add(CodeSourceMapBuilder::kInitialPosition);
+
+  while (stream.PendingBytes() > 0) {
+    uint8_t opcode = stream.Read<uint8_t>();
+    switch (opcode) {
+      case CodeSourceMapBuilder::kChangePosition: {
+        position_stack[position_stack.length() - 1] = ReadPosition(&stream);
+        break;
+      }
+      case CodeSourceMapBuilder::kAdvancePC: {
+        int32_t delta = stream.Read<int32_t>();
+        pc_offsets->Add(current_pc_offset);
+        functions->Add(function_stack.Last());
+        token_positions->Add(position_stack.Last());
+        current_pc_offset += delta;
+        break;
+      }
+      case CodeSourceMapBuilder::kPushFunction: {
+        int32_t func = stream.Read<int32_t>();
+        function_stack.Add(
+            &Function::Handle(Function::RawCast(functions_.At(func))));
+        position_stack.Add(CodeSourceMapBuilder::kInitialPosition);
+        break;
+      }
+      case CodeSourceMapBuilder::kPopFunction: {
+        // We never pop the root function.
+        ASSERT(function_stack.length() > 1);
+        ASSERT(position_stack.length() > 1);
+        function_stack.RemoveLast();
+        position_stack.RemoveLast();
+        break;
+      }
+      case CodeSourceMapBuilder::kNullCheck: {
+        stream.Read<int32_t>();
+        break;
+      }
+      default:
+        UNREACHABLE();
+    }
+  }
+}
+
 void CodeSourceMapReader::DumpSourcePositions(uword start) {
   GrowableArray<const Function*> function_stack;
   GrowableArray<TokenPosition> token_positions;
@@ -710,4 +763,87 @@ TokenPosition CodeSourceMapReader::ReadPosition(ReadStream* stream) {
   return TokenPosition(line);
 }
 
+#if !defined(PRODUCT)
+intptr_t CodeSourceMapPositions::Length() const {
+  ReadRuns();
+  return runs_.length();
+}
+
+intptr_t CodeSourceMapPositions::PCOffsetAt(intptr_t i) const {
+  ReadRuns();
+  return runs_[i].pc_offset;
+}
+
+const char* CodeSourceMapPositions::FileAt(intptr_t i) const {
+  ReadRuns();
+  return runs_[i].file;
+}
+
+intptr_t CodeSourceMapPositions::LineAt(intptr_t i) const {
+  ReadRuns();
+  return runs_[i].line;
+}
+
+intptr_t CodeSourceMapPositions::ColumnAt(intptr_t i) const {
+  ReadRuns();
+  return runs_[i].column;
+}
+
+void CodeSourceMapPositions::ReadRuns() const {
+  if (read_) {
+    return;
+  }
+  read_ = true;
+
+  Zone* zone = Thread::Current()->zone();
+  const CodeSourceMap& map =
+      CodeSourceMap::Handle(zone, code_.code_source_map());
+  const Function& root = Function::Handle(zone, code_.function());
+  if (map.IsNull() || root.IsNull()) {
+    return;  // Stub code.
+  }
+  const Array& id_map = Array::Handle(zone, code_.inlined_id_to_function());
+  CodeSourceMapReader reader(map, id_map, root);
+  GrowableArray<int32_t> pc_offsets;
+  GrowableArray<const Function*> functions;
+  GrowableArray<TokenPosition> token_positions;
+  reader.GetInnermostPositions(&pc_offsets, &functions, &token_positions);
+
+  Script& script = Script::Handle(zone);
+  ScriptPtr last_script = Script::null();
+  const char* file = nullptr;
+  for (intptr_t i = 0; i < pc_offsets.length(); i++) {
+    script = functions[i]->script();
+    if (script.IsNull()) {
+      continue;
+    }
+    if (script.raw() != last_script) {
+      last_script = script.raw();
+      file = String::Handle(zone, script.url()).ToCString();
+      // Tools look for the source at the path of a file URI.
+      if (strncmp(file, "file://", 7) == 0) {
+        file += 7;
+      }
+    }
+    intptr_t line = 0;
+    intptr_t column = 0;
+    const TokenPosition& position = token_positions[i];
+    if (position.IsSourcePosition()) {
+      script.GetTokenLocation(TokenPosition(position.Pos()), &line, &column);
+      if (line < 0) {
+        line = column = 0;
+      }
+    }
+    if (!runs_.is_empty()) {
+      const Run& last = runs_.Last();
+      if ((last.file == file) && (last.line == line) &&
+          (last.column == column)) {
+        continue;
+      }
+    }
+    runs_.Add({pc_offsets[i], file, line, column});
+  }
+}
+#endif  // !defined(PRODUCT)
+
 }  // namespace dart
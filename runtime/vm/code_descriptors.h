@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_CODE_DESCRIPTORS_H_
 #define RUNTIME_VM_CODE_DESCRIPTORS_H_
 
+#include "vm/code_observers.h"
 #include "vm/datastream.h"
 #include "vm/globals.h"
 #include "vm/growable_array.h"
@@ -285,6 +286,11 @@ class CodeSourceMapReader : public ValueObject {
   void GetInlinedFunctionsAt(int32_t pc_offset,
                              GrowableArray<const Function*>* function_stack,
                              GrowableArray<TokenPosition>* token_positions);
+  // Appends the start of each run of instructions together with the
+  // innermost function inlined there and its position, in PC order.
+  void GetInnermostPositions(GrowableArray<int32_t>* pc_offsets,
+                             GrowableArray<const Function*>* functions,
+                             GrowableArray<TokenPosition>* token_positions);
   NOT_IN_PRODUCT(void PrintJSONInlineIntervals(JSONObject* jsobj));
   void DumpInlineIntervals(uword start);
   void DumpSourcePositions(uword start);
@@ -303,6 +309,38 @@ class CodeSourceMapReader : public ValueObject {
   DISALLOW_COPY_AND_ASSIGN(CodeSourceMapReader);
 };
 
+#if !defined(PRODUCT)
+// The source positions of a code object, read from its CodeSourceMap the
+// first time they are asked for, so observers that do not use them do not pay
+// for them.
+class CodeSourceMapPositions final : public CodeSourcePositions {
+ public:
+  explicit CodeSourceMapPositions(const Code& code) : code_(code) {}
+
+  intptr_t Length() const override;
+  intptr_t PCOffsetAt(intptr_t i) const override;
+  const char* FileAt(intptr_t i) const override;
+  intptr_t LineAt(intptr_t i) const override;
+  intptr_t ColumnAt(intptr_t i) const override;
+
+ private:
+  struct Run {
+    intptr_t pc_offset;
+    const char* file;
+    intptr_t line;
+    intptr_t column;
+  };
+
+  void ReadRuns() const;
+
+  const Code& code_;
+  mutable bool read_ = false;
+  mutable GrowableArray<Run> runs_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodeSourceMapPositions);
+};
+#endif  // !defined(PRODUCT)
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_CODE_DESCRIPTORS_H_
@@ -167,4 +167,44 @@ ISOLATE_UNIT_TEST_CASE(DescriptorList_TokenPositions) {
   }
 }
 
+#if !defined(PRODUCT)
+TEST_CASE(CodeSourceMapPositions_Lines) {
+  const char* kScriptChars =
+      "int bar(int x) => x + 1;\n"
+      "int foo(int x) {\n"
+      "  var y = bar(x);\n"
+      "  return y * 2;\n"
+      "}\n";
+  Dart_Handle lib_handle = TestCase::LoadTestScript(kScriptChars, nullptr);
+  EXPECT_VALID(lib_handle);
+  TransitionNativeToVM transition(thread);
+
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(lib_handle)));
+  const Function& foo = Function::Handle(
+      lib.LookupLocalFunction(String::Handle(Symbols::New(thread, "foo"))));
+  EXPECT(!foo.IsNull());
+  EXPECT(CompilerTest::TestCompileFunction(foo));
+  const Code& code = Code::Handle(foo.unoptimized_code());
+
+  CodeSourceMapPositions positions(code);
+  EXPECT(positions.Length() > 0);
+  bool saw_call_line = false;
+  bool saw_return_line = false;
+  for (intptr_t i = 0; i < positions.Length(); i++) {
+    if (i > 0) {
+      EXPECT(positions.PCOffsetAt(i - 1) <= positions.PCOffsetAt(i));
+    }
+    // File URIs are given as paths.
+    EXPECT(strncmp(positions.FileAt(i), "file://", 7) != 0);
+    EXPECT(positions.LineAt(i) >= 0);
+    EXPECT(positions.LineAt(i) <= 5);
+    saw_call_line = saw_call_line || (positions.LineAt(i) == 3);
+    saw_return_line = saw_return_line || (positions.LineAt(i) == 4);
+  }
+  EXPECT(saw_call_line);
+  EXPECT(saw_return_line);
+}
+#endif  // !defined(PRODUCT)
+
 }  // namespace dart
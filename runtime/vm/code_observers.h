@@ -30,6 +30,22 @@ class CodeComments : public ValueObject {
 
 #if !defined(PRODUCT)
 
+// An abstract representation of the source positions of the given code
+// object: runs of instructions starting at PCOffsetAt, each attributed to a
+// line of the innermost function inlined there. Runs are sorted by PCOffset.
+class CodeSourcePositions : public ValueObject {
+ public:
+  CodeSourcePositions() = default;
+  virtual ~CodeSourcePositions() = default;
+
+  virtual intptr_t Length() const = 0;
+  virtual intptr_t PCOffsetAt(intptr_t index) const = 0;
+  virtual const char* FileAt(intptr_t index) const = 0;
+  // Line and column are 1-based, and 0 when the run has no source position.
+  virtual intptr_t LineAt(intptr_t index) const = 0;
+  virtual intptr_t ColumnAt(intptr_t index) const = 0;
+};
+
 // Object observing code creation events. Used by external profilers and
 // debuggers to map address ranges to function names.
 class CodeObserver {
@@ -49,7 +65,8 @@ class CodeObserver {
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) = 0;
+                      const CodeComments* comments,
+                      const CodeSourcePositions* positions) = 0;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(CodeObserver);
@@ -71,7 +88,8 @@ class CodeObservers : public AllStatic {
                         uword prologue_offset,
                         uword size,
                         bool optimized,
-                        const CodeComments* comments);
+                        const CodeComments* comments,
+                        const CodeSourcePositions* positions);
 
   // Returns true if there is at least one active code observer.
   static bool AreActive();
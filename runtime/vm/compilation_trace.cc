@@ -635,6 +635,11 @@ ObjectPtr TypeFeedbackLoader::LoadFeedback(ReadStream* stream) {
     }
   }
 
+  if (FLAG_precompiled_mode) {
+    // The precompiler only uses the usage counts to guide inlining.
+    thread_->isolate()->set_has_aot_feedback(true);
+  }
+
   while (functions_to_compile_.Length() > 0) {
     func_ ^= functions_to_compile_.RemoveLast();
 
@@ -692,8 +697,11 @@ ObjectPtr TypeFeedbackLoader::CheckHeader() {
       reinterpret_cast<const char*>(stream_->AddressOfCurrentPosition());
   ASSERT(features != NULL);
   intptr_t buffer_len = Utils::StrNLen(features, stream_->PendingBytes());
-  if ((buffer_len != expected_len) ||
-      (strncmp(features, expected_features, expected_len) != 0)) {
+  // A training run in the JIT has different features than the precompiler,
+  // which only consumes the usage counts.
+  if (!FLAG_precompiled_mode &&
+      ((buffer_len != expected_len) ||
+       (strncmp(features, expected_features, expected_len) != 0))) {
     const String& msg = String::Handle(String::NewFormatted(
         Heap::kOld,
         "Feedback not compatible with the current VM configuration: "
@@ -704,7 +712,7 @@ ObjectPtr TypeFeedbackLoader::CheckHeader() {
     return ApiError::New(msg, Heap::kOld);
   }
   free(expected_features);
-  stream_->Advance(expected_len + 1);
+  stream_->Advance(buffer_len + 1);
   return Error::null();
 }
 
@@ -732,7 +740,8 @@ ObjectPtr TypeFeedbackLoader::LoadClasses() {
 ObjectPtr TypeFeedbackLoader::LoadFields() {
   for (intptr_t cid = kNumPredefinedCids; cid < num_cids_; cid++) {
     cls_ = ReadClassByName();
-    bool skip = cls_.IsNull();
+    // The precompiler computes field guards from the whole program.
+    bool skip = cls_.IsNull() || FLAG_precompiled_mode;
 
     intptr_t num_fields = ReadInt();
     if (!skip && (num_fields > 0)) {
@@ -830,6 +839,12 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
     }
   }
 
+  if (!skip && FLAG_precompiled_mode) {
+    // Call sites have no ICData in AOT: keep only how hot the function was.
+    func_.set_usage_counter(usage);
+    skip = true;
+  }
+
   if (!skip) {
     error_ = Compiler::CompileFunction(thread_, func_);
     if (error_.IsError()) {
@@ -172,6 +172,8 @@ Precompiler::Precompiler(Thread* thread)
       fields_to_retain_(),
       functions_to_retain_(
           HashTables::New<FunctionSet>(/*initial_capacity=*/1024)),
+      functions_without_gc_(
+          HashTables::New<FunctionSet>(/*initial_capacity=*/1024)),
       classes_to_retain_(),
       typeargs_to_retain_(),
       types_to_retain_(),
@@ -190,6 +192,7 @@ Precompiler::~Precompiler() {
   seen_functions_.Release();
   possibly_retained_functions_.Release();
   functions_to_retain_.Release();
+  functions_without_gc_.Release();
 
   ASSERT(Precompiler::singleton_ == this);
   Precompiler::singleton_ = NULL;
@@ -486,6 +489,7 @@ void Precompiler::PrecompileConstructors() {
     Zone* zone_;
   };
 
+  TIMELINE_DURATION(T, CompilerVerbose, "PrecompileConstructors");
   phase_ = Phase::kCompilingConstructorsForInstructionCounts;
   HANDLESCOPE(T);
   ConstructorVisitor visitor(this, Z);
@@ -538,13 +542,22 @@ void Precompiler::Iterate() {
   while (changed_) {
     changed_ = false;
 
-    while (pending_functions_.Length() > 0) {
-      function ^= pending_functions_.RemoveLast();
-      ProcessFunction(function);
+    // Functions are compiled one at a time: compilation allocates into the
+    // shared heap, adds to the global object pool and queries CHA, none of
+    // which is safe to do from several threads yet.
+    {
+      TIMELINE_DURATION(T, CompilerVerbose, "CompilePendingFunctions");
+      while (pending_functions_.Length() > 0) {
+        function ^= pending_functions_.RemoveLast();
+        ProcessFunction(function);
+      }
     }
 
-    CheckForNewDynamicFunctions();
-    CollectCallbackFields();
+    {
+      TIMELINE_DURATION(T, CompilerVerbose, "CheckForNewDynamicFunctions");
+      CheckForNewDynamicFunctions();
+      CollectCallbackFields();
+    }
   }
   phase_ = Phase::kDone;
 }
@@ -1090,6 +1103,22 @@ void Precompiler::AddSelector(const String& selector) {
   }
 }
 
+void Precompiler::AddGCSummary(const Function& function,
+                               FlowGraph* flow_graph) {
+  // Intrinsics run before the code of the flow graph and may allocate.
+  if (function.is_intrinsic()) return;
+  for (auto block : flow_graph->reverse_postorder()) {
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      Instruction* const current = it.Current();
+      if (auto call = current->AsStaticCall()) {
+        if (CannotTriggerGC(call->function())) continue;
+      }
+      if (current->CanTriggerGC() || current->CanCallDart()) return;
+    }
+  }
+  functions_without_gc_.Insert(function);
+}
+
 void Precompiler::AddTableSelector(const compiler::TableSelector* selector) {
   ASSERT(FLAG_use_bare_instructions && FLAG_use_table_dispatch);
 
@@ -2674,6 +2703,10 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
         done = false;
         continue;
       }
+      if (precompiler_->phase() ==
+          Precompiler::Phase::kFixpointCodeGeneration) {
+        precompiler_->AddGCSummary(function, flow_graph);
+      }
       // Exit the loop and the function with the correct result value.
       is_compiled = true;
       done = true;
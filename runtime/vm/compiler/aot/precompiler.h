@@ -237,6 +237,17 @@ class Precompiler : public ValueObject {
   void AddField(const Field& field);
   void AddTableSelector(const compiler::TableSelector* selector);
 
+  // Records whether the code generated from [flow_graph] for [function] can
+  // trigger GC or call Dart code on a non-exceptional path.
+  void AddGCSummary(const Function& function, FlowGraph* flow_graph);
+
+  // Returns true if calling [function] is known to not trigger GC, which
+  // lets write barrier elimination look through calls to it. This is only
+  // known for functions compiled during the code generation fixpoint.
+  bool CannotTriggerGC(const Function& function) const {
+    return functions_without_gc_.ContainsKey(function);
+  }
+
   enum class Phase {
     kPreparation,
     kCompilingConstructorsForInstructionCounts,
@@ -357,6 +368,7 @@ class Precompiler : public ValueObject {
   FunctionSet possibly_retained_functions_;
   FieldSet fields_to_retain_;
   FunctionSet functions_to_retain_;
+  FunctionSet functions_without_gc_;
   ClassSet classes_to_retain_;
   TypeArgumentsSet typeargs_to_retain_;
   AbstractTypeSet types_to_retain_;
@@ -2177,7 +2177,7 @@ void AsmIntrinsifier::AllocateTwoByteString(Assembler* assembler,
 static void StringEquality(Assembler* assembler,
                            Label* normal_ir_body,
                            intptr_t string_cid) {
-  Label is_true, is_false, loop;
+  Label is_true, is_false, word_loop, byte_loop;
   __ ldr(R0, Address(SP, 1 * target::kWordSize));  // This.
   __ ldr(R1, Address(SP, 0 * target::kWordSize));  // Other.
 
@@ -2197,7 +2197,6 @@ static void StringEquality(Assembler* assembler,
   __ b(&is_false, NE);
 
   // Check contents, no fall-through possible.
-  // TODO(zra): try out other sequences.
   ASSERT((string_cid == kOneByteStringCid) ||
          (string_cid == kTwoByteStringCid));
   const intptr_t offset = (string_cid == kOneByteStringCid)
@@ -2205,27 +2204,32 @@ static void StringEquality(Assembler* assembler,
                               : target::TwoByteString::data_offset();
   __ AddImmediate(R0, offset - kHeapObjectTag);
   __ AddImmediate(R1, offset - kHeapObjectTag);
+  // R2 = length of the contents in bytes. The contents are compared a word at
+  // a time, then the remaining trailing bytes one at a time. We never read
+  // past the contents, as padding bytes are not initialized.
   __ SmiUntag(R2);
-  __ Bind(&loop);
+  if (string_cid == kTwoByteStringCid) {
+    __ LslImmediate(R2, R2, 1);
+  }
+  __ Bind(&word_loop);
+  __ CompareImmediate(R2, target::kWordSize);
+  __ b(&byte_loop, LT);
+  __ ldr(R3, Address(R0, target::kWordSize, Address::PostIndex));
+  __ ldr(R4, Address(R1, target::kWordSize, Address::PostIndex));
+  __ AddImmediate(R2, -target::kWordSize);
+  __ cmp(R3, Operand(R4));
+  __ b(&is_false, NE);
+  __ b(&word_loop);
+
+  __ Bind(&byte_loop);
   __ AddImmediate(R2, -1);
   __ CompareRegisters(R2, ZR);
   __ b(&is_true, LT);
-  if (string_cid == kOneByteStringCid) {
-    __ ldr(R3, Address(R0), kUnsignedByte);
-    __ ldr(R4, Address(R1), kUnsignedByte);
-    __ AddImmediate(R0, 1);
-    __ AddImmediate(R1, 1);
-  } else if (string_cid == kTwoByteStringCid) {
-    __ ldr(R3, Address(R0), kUnsignedTwoBytes);
-    __ ldr(R4, Address(R1), kUnsignedTwoBytes);
-    __ AddImmediate(R0, 2);
-    __ AddImmediate(R1, 2);
-  } else {
-    UNIMPLEMENTED();
-  }
+  __ ldr(R3, Address(R0, 1, Address::PostIndex), kUnsignedByte);
+  __ ldr(R4, Address(R1, 1, Address::PostIndex), kUnsignedByte);
   __ cmp(R3, Operand(R4));
   __ b(&is_false, NE);
-  __ b(&loop);
+  __ b(&byte_loop);
 
   __ Bind(&is_true);
   __ LoadObject(R0, CastHandle<Object>(TrueObject()));
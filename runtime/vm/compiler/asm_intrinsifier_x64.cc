@@ -2115,48 +2115,56 @@ void AsmIntrinsifier::AllocateTwoByteString(Assembler* assembler,
 static void StringEquality(Assembler* assembler,
                            Label* normal_ir_body,
                            intptr_t string_cid) {
-  Label is_true, is_false, loop;
+  Label is_true, is_false, word_loop, byte_loop;
   __ movq(RAX, Address(RSP, +2 * target::kWordSize));  // This.
   __ movq(RCX, Address(RSP, +1 * target::kWordSize));  // Other.
 
   // Are identical?
   __ cmpq(RAX, RCX);
-  __ j(EQUAL, &is_true, Assembler::kNearJump);
+  __ j(EQUAL, &is_true);
 
   // Is other target::OneByteString?
   __ testq(RCX, Immediate(kSmiTagMask));
   __ j(ZERO, &is_false);  // Smi
   __ CompareClassId(RCX, string_cid);
-  __ j(NOT_EQUAL, normal_ir_body, Assembler::kNearJump);
+  __ j(NOT_EQUAL, normal_ir_body);
 
   // Have same length?
   __ movq(RDI, FieldAddress(RAX, target::String::length_offset()));
   __ cmpq(RDI, FieldAddress(RCX, target::String::length_offset()));
-  __ j(NOT_EQUAL, &is_false, Assembler::kNearJump);
+  __ j(NOT_EQUAL, &is_false);
 
   // Check contents, no fall-through possible.
-  // TODO(srdjan): write a faster check.
+  ASSERT((string_cid == kOneByteStringCid) ||
+         (string_cid == kTwoByteStringCid));
+  const intptr_t offset = (string_cid == kOneByteStringCid)
+                              ? target::OneByteString::data_offset()
+                              : target::TwoByteString::data_offset();
+  // RDI = length of the contents in bytes. The contents are compared from the
+  // end a word at a time, then the remaining leading bytes one at a time. We
+  // never read past the contents, as padding bytes are not initialized.
   __ SmiUntag(RDI);
-  __ Bind(&loop);
+  if (string_cid == kTwoByteStringCid) {
+    __ shlq(RDI, Immediate(1));
+  }
+  __ Bind(&word_loop);
+  __ cmpq(RDI, Immediate(target::kWordSize));
+  __ j(LESS, &byte_loop, Assembler::kNearJump);
+  __ subq(RDI, Immediate(target::kWordSize));
+  __ movq(RBX, FieldAddress(RAX, RDI, TIMES_1, offset));
+  __ cmpq(RBX, FieldAddress(RCX, RDI, TIMES_1, offset));
+  __ j(NOT_EQUAL, &is_false);
+  __ jmp(&word_loop, Assembler::kNearJump);
+
+  __ Bind(&byte_loop);
   __ decq(RDI);
   __ cmpq(RDI, Immediate(0));
   __ j(LESS, &is_true, Assembler::kNearJump);
-  if (string_cid == kOneByteStringCid) {
-    __ movzxb(RBX, FieldAddress(RAX, RDI, TIMES_1,
-                                target::OneByteString::data_offset()));
-    __ movzxb(RDX, FieldAddress(RCX, RDI, TIMES_1,
-                                target::OneByteString::data_offset()));
-  } else if (string_cid == kTwoByteStringCid) {
-    __ movzxw(RBX, FieldAddress(RAX, RDI, TIMES_2,
-                                target::TwoByteString::data_offset()));
-    __ movzxw(RDX, FieldAddress(RCX, RDI, TIMES_2,
-                                target::TwoByteString::data_offset()));
-  } else {
-    UNIMPLEMENTED();
-  }
+  __ movzxb(RBX, FieldAddress(RAX, RDI, TIMES_1, offset));
+  __ movzxb(RDX, FieldAddress(RCX, RDI, TIMES_1, offset));
   __ cmpq(RBX, RDX);
   __ j(NOT_EQUAL, &is_false, Assembler::kNearJump);
-  __ jmp(&loop, Assembler::kNearJump);
+  __ jmp(&byte_loop, Assembler::kNearJump);
 
   __ Bind(&is_true);
   __ LoadObject(RAX, CastHandle<Object>(TrueObject()));
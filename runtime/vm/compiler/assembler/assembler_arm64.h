@@ -1274,6 +1274,10 @@ class Assembler : public AssemblerBase {
   void veor(VRegister vd, VRegister vn, VRegister vm) {
     EmitSIMDThreeSameOp(VEOR, vd, vn, vm);
   }
+  // vd = (vd & vn) | (~vd & vm).
+  void vbsl(VRegister vd, VRegister vn, VRegister vm) {
+    EmitSIMDThreeSameOp(VBSL, vd, vn, vm);
+  }
   void vaddw(VRegister vd, VRegister vn, VRegister vm) {
     EmitSIMDThreeSameOp(VADDW, vd, vn, vm);
   }
@@ -1359,6 +1363,11 @@ class Assembler : public AssemblerBase {
   void vrsqrtes(VRegister vd, VRegister vn) {
     EmitSIMDTwoRegOp(VRSQRTES, vd, vn);
   }
+  // Converts the two lower float lanes of vn to the two double lanes of vd.
+  void vfcvtl(VRegister vd, VRegister vn) { EmitSIMDTwoRegOp(VFCVTL, vd, vn); }
+  // Converts the two double lanes of vn to the two lower float lanes of vd,
+  // and clears the upper two.
+  void vfcvtn(VRegister vd, VRegister vn) { EmitSIMDTwoRegOp(VFCVTN, vd, vn); }
   void vdupw(VRegister vd, Register rn) {
     const VRegister vn = static_cast<VRegister>(rn);
     EmitSIMDCopyOp(VDUPI, vd, vn, kFourBytes, 0, 0);
@@ -3971,6 +3971,47 @@ ASSEMBLER_TEST_RUN(Veor, test) {
   EXPECT_EQ(42, EXECUTE_TEST_CODE_INT64(Int64Return, test->entry()));
 }
 
+ASSEMBLER_TEST_GENERATE(Vbsl, assembler) {
+  __ LoadDImmediate(V1, 21.0);
+  __ LoadDImmediate(V2, 100.0);
+  __ LoadImmediate(R0, 0xffffffff);
+
+  // V0 <- (0xffffffff, 0, 0xffffffff, 0)
+  __ fmovdr(V0, R0);
+  __ vinss(V0, 2, V0, 0);
+
+  // V1 <- (21.0, 21.0, 21.0, 21.0)
+  __ fcvtsd(V1, V1);
+  __ vdups(V1, V1, 0);
+
+  // V2 <- (100.0, 100.0, 100.0, 100.0)
+  __ fcvtsd(V2, V2);
+  __ vdups(V2, V2, 0);
+
+  // V0 <- (21.0, 100.0, 21.0, 100.0)
+  __ vbsl(V0, V1, V2);
+
+  __ vinss(V3, 0, V0, 0);
+  __ vinss(V4, 0, V0, 1);
+  __ vinss(V5, 0, V0, 2);
+  __ vinss(V6, 0, V0, 3);
+
+  __ fcvtds(V3, V3);
+  __ fcvtds(V4, V4);
+  __ fcvtds(V5, V5);
+  __ fcvtds(V6, V6);
+
+  __ faddd(V0, V3, V4);
+  __ faddd(V0, V0, V5);
+  __ faddd(V0, V0, V6);
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(Vbsl, test) {
+  typedef double (*DoubleReturn)() DART_UNUSED;
+  EXPECT_EQ(242.0, EXECUTE_TEST_CODE_DOUBLE(DoubleReturn, test->entry()));
+}
+
 ASSEMBLER_TEST_GENERATE(Vaddw, assembler) {
   __ LoadImmediate(R4, 21);
 
@@ -4558,6 +4599,68 @@ ASSEMBLER_TEST_RUN(Vrsqrtes, test) {
   EXPECT_FLOAT_EQ(arm_reciprocal_sqrt_estimate(147.0), res, 0.0001);
 }
 
+ASSEMBLER_TEST_GENERATE(Vfcvtl, assembler) {
+  __ LoadDImmediate(V0, 1.5);
+  __ LoadDImmediate(V1, 2.5);
+  __ LoadDImmediate(V2, 100.0);
+  __ fcvtsd(V0, V0);
+  __ fcvtsd(V1, V1);
+  __ fcvtsd(V2, V2);
+
+  // V3 <- (1.5, 2.5, 100.0, 100.0)
+  __ vdups(V3, V2, 0);
+  __ vinss(V3, 0, V0, 0);
+  __ vinss(V3, 1, V1, 0);
+
+  // V4 <- (1.5, 2.5) as doubles.
+  __ vfcvtl(V4, V3);
+
+  __ vinsd(V5, 0, V4, 0);
+  __ vinsd(V6, 0, V4, 1);
+  __ faddd(V0, V5, V6);
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(Vfcvtl, test) {
+  typedef double (*DoubleReturn)() DART_UNUSED;
+  EXPECT_EQ(4.0, EXECUTE_TEST_CODE_DOUBLE(DoubleReturn, test->entry()));
+}
+
+ASSEMBLER_TEST_GENERATE(Vfcvtn, assembler) {
+  __ LoadDImmediate(V0, 1.5);
+  __ LoadDImmediate(V1, 2.5);
+  __ LoadDImmediate(V2, 100.0);
+
+  // V3 <- (1.5, 2.5) as doubles.
+  __ vinsd(V3, 0, V0, 0);
+  __ vinsd(V3, 1, V1, 0);
+
+  // V4 <- (100.0, 100.0, 100.0, 100.0), then (1.5, 2.5, 0.0, 0.0).
+  __ fcvtsd(V2, V2);
+  __ vdups(V4, V2, 0);
+  __ vfcvtn(V4, V3);
+
+  __ vinss(V5, 0, V4, 0);
+  __ vinss(V6, 0, V4, 1);
+  __ vinss(V1, 0, V4, 2);
+  __ vinss(V2, 0, V4, 3);
+
+  __ fcvtds(V5, V5);
+  __ fcvtds(V6, V6);
+  __ fcvtds(V1, V1);
+  __ fcvtds(V2, V2);
+
+  __ faddd(V0, V5, V6);
+  __ faddd(V0, V0, V1);
+  __ faddd(V0, V0, V2);
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(Vfcvtn, test) {
+  typedef double (*DoubleReturn)() DART_UNUSED;
+  EXPECT_EQ(4.0, EXECUTE_TEST_CODE_DOUBLE(DoubleReturn, test->entry()));
+}
+
 ASSEMBLER_TEST_GENERATE(Vrsqrtss, assembler) {
   __ LoadDImmediate(V1, 5.0);
   __ LoadDImmediate(V2, 10.0);
@@ -1281,7 +1281,13 @@ void ARM64Decoder::DecodeSIMDThreeSame(Instr* instr) {
       Format(instr, "vorr 'vd, 'vn, 'vm");
     }
   } else if ((U == 1) && (opcode == 0x3)) {
-    Format(instr, "veor 'vd, 'vn, 'vm");
+    if (instr->Bits(22, 2) == 0) {
+      Format(instr, "veor 'vd, 'vn, 'vm");
+    } else if (instr->Bits(22, 2) == 1) {
+      Format(instr, "vbsl 'vd, 'vn, 'vm");
+    } else {
+      Unknown(instr);
+    }
   } else if ((U == 0) && (opcode == 0x10)) {
     Format(instr, "vadd'vsz 'vd, 'vn, 'vm");
   } else if ((U == 1) && (opcode == 0x10)) {
@@ -1327,6 +1333,14 @@ void ARM64Decoder::DecodeSIMDTwoReg(Instr* instr) {
   const int32_t op = instr->Bits(12, 5);
   const int32_t sz = instr->Bits(22, 2);
 
+  if ((Q == 0) && (U == 0) && (sz == 1) && (op == 0x17)) {
+    Format(instr, "vfcvtl 'vd, 'vn");
+    return;
+  } else if ((Q == 0) && (U == 0) && (sz == 1) && (op == 0x16)) {
+    Format(instr, "vfcvtn 'vd, 'vn");
+    return;
+  }
+
   if (Q == 0) {
     Unknown(instr);
     return;
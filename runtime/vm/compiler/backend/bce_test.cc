@@ -141,6 +141,28 @@ ISOLATE_UNIT_TEST_CASE(BCESimpleLoopsDown) {
   TestScriptJIT(kScriptChars, 2, 0);
 }
 
+ISOLATE_UNIT_TEST_CASE(BCEStridedLoops) {
+  const char* kScriptChars =
+      R"(
+      import 'dart:typed_data';
+      foo(Float64List l) {
+        for (int i = 0; i < l.length; i += 2) {
+          l[i] = 0;
+        }
+        for (int i = 0; i < l.length - 3; i += 4) {
+          l[i] = 1;
+          l[i + 1] = 1;
+          l[i + 2] = 1;
+          l[i + 3] = 1;
+        }
+      }
+      main() {
+        foo(new Float64List(100));
+      }
+    )";
+  TestScriptJIT(kScriptChars, 5, 0);
+}
+
 ISOLATE_UNIT_TEST_CASE(BCEModulo) {
   const char* kScriptChars =
       R"(
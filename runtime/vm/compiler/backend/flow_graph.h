@@ -419,6 +419,11 @@ class FlowGraph : public ZoneAllocated {
 
   bool should_print() const { return should_print_; }
 
+  // True if the graph was optimized by the quick JIT tier: its code counts
+  // invocations and is recompiled with the full pipeline once it gets hot.
+  bool is_quick_tier() const { return is_quick_tier_; }
+  void set_is_quick_tier(bool value) { is_quick_tier_ = value; }
+
   //
   // High-level utilities.
   //
@@ -574,6 +579,7 @@ class FlowGraph : public ZoneAllocated {
 
   intptr_t inlining_id_;
   bool should_print_;
+  bool is_quick_tier_ = false;
 };
 
 class LivenessAnalysis : public ValueObject {
@@ -62,6 +62,7 @@ DECLARE_FLAG(charp, deoptimize_filter);
 DECLARE_FLAG(bool, intrinsify);
 DECLARE_FLAG(int, regexp_optimization_counter_threshold);
 DECLARE_FLAG(int, reoptimization_counter_threshold);
+DECLARE_FLAG(int, full_optimization_counter_threshold);
 DECLARE_FLAG(int, stacktrace_every);
 DECLARE_FLAG(charp, stacktrace_filter);
 DECLARE_FLAG(int, gc_every);
@@ -236,7 +237,8 @@ void FlowGraphCompiler::InitCompiler() {
   block_info_.Clear();
   // Initialize block info and search optimized (non-OSR) code for calls
   // indicating a non-leaf routine and calls without IC data indicating
-  // possible reoptimization.
+  // possible reoptimization. Quick tier code is always reoptimized.
+  may_reoptimize_ = is_optimizing() && is_quick_tier();
 
   for (int i = 0; i < block_order_.length(); ++i) {
     block_info_.Add(new (zone()) BlockInfo());
@@ -2012,9 +2014,15 @@ const ICData* FlowGraphCompiler::GetOrAddStaticCallICData(
   return &ic_data;
 }
 
+bool FlowGraphCompiler::is_quick_tier() const {
+  return flow_graph().is_quick_tier();
+}
+
 intptr_t FlowGraphCompiler::GetOptimizationThreshold() const {
   intptr_t threshold;
-  if (is_optimizing()) {
+  if (is_optimizing() && is_quick_tier()) {
+    threshold = FLAG_full_optimization_counter_threshold;
+  } else if (is_optimizing()) {
     threshold = FLAG_reoptimization_counter_threshold;
   } else if (parsed_function_.function().IsIrregexpFunction()) {
     threshold = FLAG_regexp_optimization_counter_threshold;
@@ -916,6 +916,7 @@ class FlowGraphCompiler : public ValueObject {
   }
 
   bool may_reoptimize() const { return may_reoptimize_; }
+  bool is_quick_tier() const;
 
   // Use in unoptimized compilation to preserve/reuse ICData.
   //
@@ -5095,10 +5095,12 @@ class FfiCallInstr : public Definition {
  public:
   FfiCallInstr(Zone* zone,
                intptr_t deopt_id,
-               const compiler::ffi::CallMarshaller& marshaller)
+               const compiler::ffi::CallMarshaller& marshaller,
+               bool is_leaf)
       : Definition(deopt_id),
         zone_(zone),
         marshaller_(marshaller),
+        is_leaf_(is_leaf),
         inputs_(marshaller.NumDefinitions() + 1 +
                 (marshaller.PassTypedData() ? 1 : 0)) {
     inputs_.FillWith(
@@ -5117,16 +5119,21 @@ class FfiCallInstr : public Definition {
     return marshaller_.NumDefinitions() + 1;
   }
 
+  // Leaf calls stay in generated code: they neither set up an exit frame nor
+  // enter a safepoint, so the C function must not call back into Dart (or
+  // use the Dart API) and must not block.
+  bool is_leaf() const { return is_leaf_; }
+
   virtual intptr_t InputCount() const { return inputs_.length(); }
   virtual Value* InputAt(intptr_t i) const { return inputs_[i]; }
   virtual bool MayThrow() const {
     // By Dart_PropagateError.
-    return true;
+    return !is_leaf_;
   }
 
   // FfiCallInstr calls C code, which can call back into Dart.
   virtual bool ComputeCanDeoptimize() const {
-    return !CompilerState::Current().is_aot();
+    return !is_leaf_ && !CompilerState::Current().is_aot();
   }
 
   virtual bool HasUnknownSideEffects() const { return true; }
@@ -5156,6 +5163,7 @@ class FfiCallInstr : public Definition {
 
   Zone* const zone_;
   const compiler::ffi::CallMarshaller& marshaller_;
+  const bool is_leaf_;
 
   GrowableArray<Value*> inputs_;
 
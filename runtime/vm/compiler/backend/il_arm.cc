@@ -1305,43 +1305,55 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   if (compiler::Assembler::EmittingComments()) {
     __ Comment("Call");
   }
-  // We need to copy the return address up into the dummy stack frame so the
-  // stack walker will know which safepoint to use.
-  __ mov(TMP, compiler::Operand(PC));
-  __ str(TMP, compiler::Address(FPREG, kSavedCallerPcSlotFromFp *
-                                           compiler::target::kWordSize));
-
-  // For historical reasons, the PC on ARM points 8 bytes past the current
-  // instruction. Therefore we emit the metadata here, 8 bytes (2 instructions)
-  // after the original mov.
-  compiler->EmitCallsiteMetadata(TokenPosition::kNoSource, deopt_id(),
-                                 PcDescriptorsLayout::Kind::kOther, locs());
-
-  // Update information in the thread object and enter a safepoint.
-  if (CanExecuteGeneratedCodeInSafepoint()) {
-    __ LoadImmediate(temp, compiler::target::Thread::exit_through_ffi());
-    __ TransitionGeneratedToNative(branch, FPREG, temp, saved_fp,
-                                   /*enter_safepoint=*/true);
+  if (is_leaf_) {
+    // Leaf calls do not leave generated code, so no stack walk or GC can
+    // happen during the call and no exit frame is needed. Only the VM tag is
+    // updated, for the profiler.
+    __ StoreToOffset(branch, THR, compiler::target::Thread::vm_tag_offset());
 
     __ blx(branch);
 
-    // Update information in the thread object and leave the safepoint.
-    __ TransitionNativeToGenerated(saved_fp, temp, /*leave_safepoint=*/true);
+    __ LoadImmediate(temp, compiler::target::Thread::vm_tag_dart_id());
+    __ StoreToOffset(temp, THR, compiler::target::Thread::vm_tag_offset());
   } else {
-    // We cannot trust that this code will be executable within a safepoint.
-    // Therefore we delegate the responsibility of entering/exiting the
-    // safepoint to a stub which in the VM isolate's heap, which will never lose
-    // execute permission.
-    __ ldr(TMP,
-           compiler::Address(
-               THR, compiler::target::Thread::
-                        call_native_through_safepoint_entry_point_offset()));
-
-    // Calls R8 in a safepoint and clobbers R4 and NOTFP.
-    ASSERT(branch == R8 && temp == R4);
-    static_assert((kReservedCpuRegisters & (1 << NOTFP)) != 0,
-                  "NOTFP should be a reserved register");
-    __ blx(TMP);
+    // We need to copy the return address up into the dummy stack frame so the
+    // stack walker will know which safepoint to use.
+    __ mov(TMP, compiler::Operand(PC));
+    __ str(TMP, compiler::Address(FPREG, kSavedCallerPcSlotFromFp *
+                                             compiler::target::kWordSize));
+
+    // For historical reasons, the PC on ARM points 8 bytes past the current
+    // instruction. Therefore we emit the metadata here, 8 bytes (2
+    // instructions) after the original mov.
+    compiler->EmitCallsiteMetadata(TokenPosition::kNoSource, deopt_id(),
+                                   PcDescriptorsLayout::Kind::kOther, locs());
+
+    // Update information in the thread object and enter a safepoint.
+    if (CanExecuteGeneratedCodeInSafepoint()) {
+      __ LoadImmediate(temp, compiler::target::Thread::exit_through_ffi());
+      __ TransitionGeneratedToNative(branch, FPREG, temp, saved_fp,
+                                     /*enter_safepoint=*/true);
+
+      __ blx(branch);
+
+      // Update information in the thread object and leave the safepoint.
+      __ TransitionNativeToGenerated(saved_fp, temp, /*leave_safepoint=*/true);
+    } else {
+      // We cannot trust that this code will be executable within a
+      // safepoint. Therefore we delegate the responsibility of
+      // entering/exiting the safepoint to a stub which in the VM isolate's
+      // heap, which will never lose execute permission.
+      __ ldr(TMP,
+             compiler::Address(
+                 THR, compiler::target::Thread::
+                          call_native_through_safepoint_entry_point_offset()));
+
+      // Calls R8 in a safepoint and clobbers R4 and NOTFP.
+      ASSERT(branch == R8 && temp == R4);
+      static_assert((kReservedCpuRegisters & (1 << NOTFP)) != 0,
+                    "NOTFP should be a reserved register");
+      __ blx(TMP);
+    }
   }
 
   // Restore the global object pool after returning from runtime (old space is
@@ -1136,22 +1136,11 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   if (compiler::Assembler::EmittingComments()) {
     __ Comment("Call");
   }
-  // We need to copy a dummy return address up into the dummy stack frame so the
-  // stack walker will know which safepoint to use.
-  //
-  // ADR loads relative to itself, so add kInstrSize to point to the next
-  // instruction.
-  __ adr(temp, compiler::Immediate(Instr::kInstrSize));
-  compiler->EmitCallsiteMetadata(token_pos(), deopt_id(),
-                                 PcDescriptorsLayout::Kind::kOther, locs());
-
-  __ StoreToOffset(temp, FPREG, kSavedCallerPcSlotFromFp * kWordSize);
-
-  if (CanExecuteGeneratedCodeInSafepoint()) {
-    // Update information in the thread object and enter a safepoint.
-    __ LoadImmediate(temp, compiler::target::Thread::exit_through_ffi());
-    __ TransitionGeneratedToNative(branch, FPREG, temp,
-                                   /*enter_safepoint=*/true);
+  if (is_leaf_) {
+    // Leaf calls do not leave generated code, so no stack walk or GC can
+    // happen during the call and no exit frame is needed. Only the VM tag is
+    // updated, for the profiler.
+    __ StoreToOffset(branch, THR, compiler::target::Thread::vm_tag_offset());
 
     // We are entering runtime code, so the C stack pointer must be restored
     // from the stack limit to the top of the stack.
@@ -1164,21 +1153,53 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ mov(SP, CSP);
     __ mov(CSP, R25);
 
-    // Update information in the thread object and leave the safepoint.
-    __ TransitionNativeToGenerated(temp, /*leave_safepoint=*/true);
+    __ LoadImmediate(temp, compiler::target::Thread::vm_tag_dart_id());
+    __ StoreToOffset(temp, THR, compiler::target::Thread::vm_tag_offset());
   } else {
-    // We cannot trust that this code will be executable within a safepoint.
-    // Therefore we delegate the responsibility of entering/exiting the
-    // safepoint to a stub which in the VM isolate's heap, which will never lose
-    // execute permission.
-    __ ldr(TMP,
-           compiler::Address(
-               THR, compiler::target::Thread::
-                        call_native_through_safepoint_entry_point_offset()));
+    // We need to copy a dummy return address up into the dummy stack frame so
+    // the stack walker will know which safepoint to use.
+    //
+    // ADR loads relative to itself, so add kInstrSize to point to the next
+    // instruction.
+    __ adr(temp, compiler::Immediate(Instr::kInstrSize));
+    compiler->EmitCallsiteMetadata(token_pos(), deopt_id(),
+                                   PcDescriptorsLayout::Kind::kOther, locs());
+
+    __ StoreToOffset(temp, FPREG, kSavedCallerPcSlotFromFp * kWordSize);
+
+    if (CanExecuteGeneratedCodeInSafepoint()) {
+      // Update information in the thread object and enter a safepoint.
+      __ LoadImmediate(temp, compiler::target::Thread::exit_through_ffi());
+      __ TransitionGeneratedToNative(branch, FPREG, temp,
+                                     /*enter_safepoint=*/true);
+
+      // We are entering runtime code, so the C stack pointer must be restored
+      // from the stack limit to the top of the stack.
+      __ mov(R25, CSP);
+      __ mov(CSP, SP);
+
+      __ blr(branch);
+
+      // Restore the Dart stack pointer.
+      __ mov(SP, CSP);
+      __ mov(CSP, R25);
+
+      // Update information in the thread object and leave the safepoint.
+      __ TransitionNativeToGenerated(temp, /*leave_safepoint=*/true);
+    } else {
+      // We cannot trust that this code will be executable within a
+      // safepoint. Therefore we delegate the responsibility of
+      // entering/exiting the safepoint to a stub which in the VM isolate's
+      // heap, which will never lose execute permission.
+      __ ldr(TMP,
+             compiler::Address(
+                 THR, compiler::target::Thread::
+                          call_native_through_safepoint_entry_point_offset()));
 
-    // Calls R9 and clobbers R19 (along with volatile registers).
-    ASSERT(branch == R9 && temp == R19);
-    __ blr(TMP);
+      // Calls R9 and clobbers R19 (along with volatile registers).
+      ASSERT(branch == R9 && temp == R19);
+      __ blr(TMP);
+    }
   }
 
   // Refresh pinned registers values (inc. write barrier mask and null object).
@@ -1450,7 +1471,7 @@ void StringInterpolateInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 LocationSummary* Utf8ScanInstr::MakeLocationSummary(Zone* zone,
                                                     bool opt) const {
   const intptr_t kNumInputs = 5;
-  const intptr_t kNumTemps = 0;
+  const intptr_t kNumTemps = 1;
   LocationSummary* summary = new (zone)
       LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
   summary->set_in(0, Location::Any());               // decoder
@@ -1458,6 +1479,7 @@ LocationSummary* Utf8ScanInstr::MakeLocationSummary(Zone* zone,
   summary->set_in(2, Location::WritableRegister());  // start
   summary->set_in(3, Location::WritableRegister());  // end
   summary->set_in(4, Location::WritableRegister());  // table
+  summary->set_temp(0, Location::RequiresRegister());
   summary->set_out(0, Location::RequiresRegister());
   return summary;
 }
@@ -1472,14 +1494,18 @@ void Utf8ScanInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   const Register bytes_ptr_reg = start_reg;
   const Register bytes_end_reg = end_reg;
   const Register flags_reg = bytes_reg;
+  const Register word_end_reg = locs()->temp(0).reg();
   const Register temp_reg = TMP;
+  const Register word_reg = TMP2;
   const Register decoder_temp_reg = start_reg;
   const Register flags_temp_reg = end_reg;
 
   static const intptr_t kSizeMask = 0x03;
   static const intptr_t kFlagsMask = 0x3C;
+  static const int64_t kNonAsciiMask = 0x8080808080808080;
+  static const intptr_t kWordBytes = 8;
 
-  compiler::Label loop, loop_in;
+  compiler::Label word_loop, nonascii_word, word_byte_loop, loop, loop_in;
 
   // Address of input bytes.
   __ LoadFieldFromOffset(bytes_reg, bytes_reg,
@@ -1498,20 +1524,44 @@ void Utf8ScanInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ mov(size_reg, ZR);
   __ mov(flags_reg, ZR);
 
-  __ b(&loop_in);
+  // Reads the byte at bytes_ptr_reg, increments the pointer and updates size
+  // and flags based on byte value.
+  auto scan_byte = [&]() {
+    __ ldr(temp_reg,
+           compiler::Address(bytes_ptr_reg, 1, compiler::Address::PostIndex),
+           compiler::kUnsignedByte);
+    __ ldr(temp_reg, compiler::Address(table_reg, temp_reg),
+           compiler::kUnsignedByte);
+    __ orr(flags_reg, flags_reg, compiler::Operand(temp_reg));
+    __ andi(temp_reg, temp_reg, compiler::Immediate(kSizeMask));
+    __ add(size_reg, size_reg, compiler::Operand(temp_reg));
+  };
+
+  // Loop scanning through the bytes one 8-byte word at a time. A word of
+  // ASCII bytes adds 8 to the size and no flags. Any other word is scanned
+  // byte by byte.
+  __ Bind(&word_loop);
+  __ sub(temp_reg, bytes_end_reg, compiler::Operand(bytes_ptr_reg));
+  __ CompareImmediate(temp_reg, kWordBytes);
+  __ b(&loop_in, LT);
+  __ ldr(word_reg, compiler::Address(bytes_ptr_reg, 0));
+  __ tsti(word_reg, compiler::Immediate(kNonAsciiMask));
+  __ b(&nonascii_word, NE);
+  __ AddImmediate(bytes_ptr_reg, kWordBytes);
+  __ AddImmediate(size_reg, kWordBytes);
+  __ b(&word_loop);
+
+  __ Bind(&nonascii_word);
+  __ AddImmediate(word_end_reg, bytes_ptr_reg, kWordBytes);
+  __ Bind(&word_byte_loop);
+  scan_byte();
+  __ cmp(bytes_ptr_reg, compiler::Operand(word_end_reg));
+  __ b(&word_byte_loop, UNSIGNED_LESS);
+  __ b(&word_loop);
+
+  // Less than 8 bytes left. Process the remaining bytes individually.
   __ Bind(&loop);
-
-  // Read byte and increment pointer.
-  __ ldr(temp_reg,
-         compiler::Address(bytes_ptr_reg, 1, compiler::Address::PostIndex),
-         compiler::kUnsignedByte);
-
-  // Update size and flags based on byte value.
-  __ ldr(temp_reg, compiler::Address(table_reg, temp_reg),
-         compiler::kUnsignedByte);
-  __ orr(flags_reg, flags_reg, compiler::Operand(temp_reg));
-  __ andi(temp_reg, temp_reg, compiler::Immediate(kSizeMask));
-  __ add(size_reg, size_reg, compiler::Operand(temp_reg));
+  scan_byte();
 
   // Stop if end is reached.
   __ Bind(&loop_in);
@@ -4565,26 +4615,12 @@ DEFINE_EMIT(SimdUnaryOp, (VRegister result, VRegister value)) {
       __ vdupd(result, value, 0);
       break;
     case SimdOpInstr::kFloat64x2ToFloat32x4:
-      // Zero register.
-      __ veor(result, result, result);
-      // Set X lane.
-      __ vinsd(VTMP, 0, value, 0);
-      __ fcvtsd(VTMP, VTMP);
-      __ vinss(result, 0, VTMP, 0);
-      // Set Y lane.
-      __ vinsd(VTMP, 0, value, 1);
-      __ fcvtsd(VTMP, VTMP);
-      __ vinss(result, 1, VTMP, 0);
+      // Narrows into the X and Y lanes and clears Z and W.
+      __ vfcvtn(result, value);
       break;
     case SimdOpInstr::kFloat32x4ToFloat64x2:
-      // Set X.
-      __ vinss(VTMP, 0, value, 0);
-      __ fcvtds(VTMP, VTMP);
-      __ vinsd(result, 0, VTMP, 0);
-      // Set Y.
-      __ vinss(VTMP, 0, value, 1);
-      __ fcvtds(VTMP, VTMP);
-      __ vinsd(result, 1, VTMP, 0);
+      // Widens the X and Y lanes.
+      __ vfcvtl(result, value);
       break;
     default:
       UNREACHABLE();
@@ -4745,16 +4781,10 @@ DEFINE_EMIT(Int32x4Select,
              VRegister trueValue,
              VRegister falseValue,
              Temp<VRegister> temp)) {
-  // Copy mask.
+  // temp = (mask & trueValue) | (~mask & falseValue).
   __ vmov(temp, mask);
-  // Invert it.
-  __ vnot(temp, temp);
-  // mask = mask & trueValue.
-  __ vand(mask, mask, trueValue);
-  // temp = temp & falseValue.
-  __ vand(temp, temp, falseValue);
-  // out = mask | temp.
-  __ vorr(out, mask, temp);
+  __ vbsl(temp, trueValue, falseValue);
+  __ vmov(out, temp);
 }
 
 DEFINE_EMIT(Int32x4WithFlag,
@@ -1089,6 +1089,9 @@ void FfiCallInstr::PrintOperandsTo(BaseTextBuffer* f) const {
     arg_location.PrintTo(f);
     f->AddString(")");
   }
+  if (is_leaf_) {
+    f->AddString(", is_leaf");
+  }
 }
 
 void EnterHandleScopeInstr::PrintOperandsTo(BaseTextBuffer* f) const {
@@ -1069,40 +1069,51 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 
   EmitParamMoves(compiler);
 
-  // We need to copy a dummy return address up into the dummy stack frame so the
-  // stack walker will know which safepoint to use. RIP points to the *next*
-  // instruction, so 'AddressRIPRelative' loads the address of the following
-  // 'movq'.
-  __ leaq(TMP, compiler::Address::AddressRIPRelative(0));
-  compiler->EmitCallsiteMetadata(TokenPosition::kNoSource, deopt_id(),
-                                 PcDescriptorsLayout::Kind::kOther, locs());
-  __ movq(compiler::Address(FPREG, kSavedCallerPcSlotFromFp * kWordSize), TMP);
-
-  if (CanExecuteGeneratedCodeInSafepoint()) {
-    // Update information in the thread object and enter a safepoint.
-    __ movq(TMP,
-            compiler::Immediate(compiler::target::Thread::exit_through_ffi()));
-    __ TransitionGeneratedToNative(target_address, FPREG, TMP,
-                                   /*enter_safepoint=*/true);
-
+  if (is_leaf_) {
+    // Leaf calls do not leave generated code, so no stack walk or GC can
+    // happen during the call and no exit frame is needed. Only the VM tag is
+    // updated, for the profiler.
+    __ movq(compiler::Assembler::VMTagAddress(), target_address);
     __ CallCFunction(target_address, /*restore_rsp=*/true);
-
-    // Update information in the thread object and leave the safepoint.
-    __ TransitionNativeToGenerated(/*leave_safepoint=*/true);
+    __ movq(compiler::Assembler::VMTagAddress(),
+            compiler::Immediate(compiler::target::Thread::vm_tag_dart_id()));
   } else {
-    // We cannot trust that this code will be executable within a safepoint.
-    // Therefore we delegate the responsibility of entering/exiting the
-    // safepoint to a stub which in the VM isolate's heap, which will never lose
-    // execute permission.
-    __ movq(TMP,
-            compiler::Address(
-                THR, compiler::target::Thread::
-                         call_native_through_safepoint_entry_point_offset()));
+    // We need to copy a dummy return address up into the dummy stack frame so
+    // the stack walker will know which safepoint to use. RIP points to the
+    // *next* instruction, so 'AddressRIPRelative' loads the address of the
+    // following 'movq'.
+    __ leaq(TMP, compiler::Address::AddressRIPRelative(0));
+    compiler->EmitCallsiteMetadata(TokenPosition::kNoSource, deopt_id(),
+                                   PcDescriptorsLayout::Kind::kOther, locs());
+    __ movq(compiler::Address(FPREG, kSavedCallerPcSlotFromFp * kWordSize),
+            TMP);
+
+    if (CanExecuteGeneratedCodeInSafepoint()) {
+      // Update information in the thread object and enter a safepoint.
+      __ movq(TMP, compiler::Immediate(
+                       compiler::target::Thread::exit_through_ffi()));
+      __ TransitionGeneratedToNative(target_address, FPREG, TMP,
+                                     /*enter_safepoint=*/true);
+
+      __ CallCFunction(target_address, /*restore_rsp=*/true);
+
+      // Update information in the thread object and leave the safepoint.
+      __ TransitionNativeToGenerated(/*leave_safepoint=*/true);
+    } else {
+      // We cannot trust that this code will be executable within a
+      // safepoint. Therefore we delegate the responsibility of
+      // entering/exiting the safepoint to a stub which in the VM isolate's
+      // heap, which will never lose execute permission.
+      __ movq(TMP,
+              compiler::Address(
+                  THR, compiler::target::Thread::
+                           call_native_through_safepoint_entry_point_offset()));
 
-    // Calls RBX within a safepoint.
-    ASSERT(saved_fp == RBX);
-    __ movq(RBX, target_address);
-    __ call(TMP);
+      // Calls RBX within a safepoint.
+      ASSERT(saved_fp == RBX);
+      __ movq(RBX, target_address);
+      __ call(TMP);
+    }
   }
 
   EmitReturnMoves(compiler);
@@ -3797,6 +3808,76 @@ static bool IsSmiValue(const Object& constant, intptr_t value) {
   return constant.IsSmi() && (Smi::Cast(constant).Value() == value);
 }
 
+// Computes TMP ~/ divisor or TMP % divisor for an untagged numerator in TMP
+// and a constant divisor with |divisor| >= 2, using a multiplication by a
+// magic number instead of idiv. The quotient of ~/ ends up in RAX and the
+// remainder of % in RDX. Clobbers TMP.
+static void EmitDivRemByConstant(FlowGraphCompiler* compiler,
+                                 Token::Kind op_kind,
+                                 int64_t divisor) {
+  ASSERT(op_kind == Token::kMOD || op_kind == Token::kTRUNCDIV);
+  ASSERT(divisor <= -2 || divisor >= 2);
+  compiler::Label pos;
+  int64_t magic = 0;
+  int64_t shift = 0;
+  Utils::CalculateMagicAndShiftForDivRem(divisor, &magic, &shift);
+  // RDX:RAX = magic * numerator.
+  __ LoadImmediate(RAX, compiler::Immediate(magic));
+  __ imulq(TMP);
+  // RDX +/-= numerator.
+  if (divisor > 0 && magic < 0) {
+    __ addq(RDX, TMP);
+  } else if (divisor < 0 && magic > 0) {
+    __ subq(RDX, TMP);
+  }
+  // Shift if needed.
+  if (shift != 0) {
+    __ sarq(RDX, compiler::Immediate(shift));
+  }
+  // RDX += 1 if RDX < 0.
+  __ movq(RAX, RDX);
+  __ shrq(RDX, compiler::Immediate(63));
+  __ addq(RDX, RAX);
+  // Finalize DIV or MOD.
+  if (op_kind == Token::kTRUNCDIV) {
+    __ movq(RAX, RDX);
+  } else {
+    __ movq(RAX, TMP);
+    __ LoadImmediate(TMP, compiler::Immediate(divisor));
+    __ imulq(RDX, TMP);
+    __ subq(RAX, RDX);
+    // Compensate for Dart's Euclidean view of MOD.
+    __ testq(RAX, RAX);
+    __ j(GREATER_EQUAL, &pos);
+    if (divisor > 0) {
+      __ addq(RAX, TMP);
+    } else {
+      __ subq(RAX, TMP);
+    }
+    __ Bind(&pos);
+    __ movq(RDX, RAX);
+  }
+}
+
+// Smi ~/ and % by a constant other than 0, 1 and -1 use EmitDivRemByConstant.
+// Truncating division by a power of two has an even shorter sequence.
+static bool IsSmiDivRemByMagicConstant(const BinarySmiOpInstr* instr) {
+  if ((instr->op_kind() != Token::kTRUNCDIV) &&
+      (instr->op_kind() != Token::kMOD)) {
+    return false;
+  }
+  ConstantInstr* constant = instr->right()->definition()->AsConstant();
+  if ((constant == nullptr) || !constant->value().IsSmi()) {
+    return false;
+  }
+  const intptr_t divisor = Smi::Cast(constant->value()).Value();
+  if ((divisor >= -1) && (divisor <= 1)) {
+    return false;
+  }
+  return (instr->op_kind() == Token::kMOD) ||
+         !instr->RightIsPowerOfTwoConstant();
+}
+
 LocationSummary* BinarySmiOpInstr::MakeLocationSummary(Zone* zone,
                                                        bool opt) const {
   const intptr_t kNumInputs = 2;
@@ -3814,7 +3895,19 @@ LocationSummary* BinarySmiOpInstr::MakeLocationSummary(Zone* zone,
     return summary;
   }
 
-  if (op_kind() == Token::kTRUNCDIV) {
+  if (IsSmiDivRemByMagicConstant(this)) {
+    // The quotient is produced in RAX and the remainder in RDX, and both are
+    // clobbered.
+    const intptr_t kNumTemps = 1;
+    LocationSummary* summary = new (zone)
+        LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+    const bool is_mod = op_kind() == Token::kMOD;
+    summary->set_in(0, Location::RegisterLocation(is_mod ? RDX : RAX));
+    summary->set_in(1, Location::Constant(right_constant));
+    summary->set_temp(0, Location::RegisterLocation(is_mod ? RAX : RDX));
+    summary->set_out(0, Location::SameAsFirstInput());
+    return summary;
+  } else if (op_kind() == Token::kTRUNCDIV) {
     const intptr_t kNumTemps = 1;
     LocationSummary* summary = new (zone)
         LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
@@ -3896,6 +3989,18 @@ void BinarySmiOpInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     deopt = compiler->AddDeoptStub(deopt_id(), ICData::kDeoptBinarySmiOp);
   }
 
+  if (IsSmiDivRemByMagicConstant(this)) {
+    // The divisor is neither 0 nor -1, and the result of ~/ or % by it always
+    // fits in a Smi, so no checks are needed.
+    const intptr_t divisor = Smi::Cast(locs()->in(1).constant()).Value();
+    __ movq(TMP, left);
+    __ SmiUntag(TMP);
+    EmitDivRemByConstant(compiler, op_kind(), divisor);
+    ASSERT(result == (op_kind() == Token::kMOD ? RDX : RAX));
+    __ SmiTag(result);
+    return;
+  }
+
   if (locs()->in(1).IsConstant()) {
     const Object& constant = locs()->in(1).constant();
     ASSERT(constant.IsSmi());
@@ -6103,50 +6208,11 @@ static void EmitInt64ModTruncDiv(FlowGraphCompiler* compiler,
       const int64_t divisor = Integer::Cast(c->value()).AsInt64Value();
       if (divisor <= -2 || divisor >= 2) {
         // For x DIV c or x MOD c: use magic operations.
-        compiler::Label pos;
-        int64_t magic = 0;
-        int64_t shift = 0;
-        Utils::CalculateMagicAndShiftForDivRem(divisor, &magic, &shift);
-        // RDX:RAX = magic * numerator.
         ASSERT(left == RAX);
         __ MoveRegister(TMP, RAX);  // save numerator
-        __ LoadImmediate(RAX, compiler::Immediate(magic));
-        __ imulq(TMP);
-        // RDX +/-= numerator.
-        if (divisor > 0 && magic < 0) {
-          __ addq(RDX, TMP);
-        } else if (divisor < 0 && magic > 0) {
-          __ subq(RDX, TMP);
-        }
-        // Shift if needed.
-        if (shift != 0) {
-          __ sarq(RDX, compiler::Immediate(shift));
-        }
-        // RDX += 1 if RDX < 0.
-        __ movq(RAX, RDX);
-        __ shrq(RDX, compiler::Immediate(63));
-        __ addq(RDX, RAX);
-        // Finalize DIV or MOD.
-        if (op_kind == Token::kTRUNCDIV) {
-          ASSERT(out == RAX && tmp == RDX);
-          __ movq(RAX, RDX);
-        } else {
-          ASSERT(out == RDX && tmp == RAX);
-          __ movq(RAX, TMP);
-          __ LoadImmediate(TMP, compiler::Immediate(divisor));
-          __ imulq(RDX, TMP);
-          __ subq(RAX, RDX);
-          // Compensate for Dart's Euclidean view of MOD.
-          __ testq(RAX, RAX);
-          __ j(GREATER_EQUAL, &pos);
-          if (divisor > 0) {
-            __ addq(RAX, TMP);
-          } else {
-            __ subq(RAX, TMP);
-          }
-          __ Bind(&pos);
-          __ movq(RDX, RAX);
-        }
+        EmitDivRemByConstant(compiler, op_kind, divisor);
+        ASSERT(out == (op_kind == Token::kTRUNCDIV ? RAX : RDX));
+        ASSERT(tmp == (op_kind == Token::kTRUNCDIV ? RDX : RAX));
         return;
       }
     }
@@ -46,6 +46,23 @@ DEFINE_FLAG(
     inlining_size_threshold,
     25,
     "Always inline functions that have threshold or fewer instructions");
+DEFINE_FLAG(int,
+            inlining_boxed_result_size_threshold,
+            50,
+            "Always inline functions that return a boxed double or SIMD value "
+            "and have threshold or fewer instructions.");
+DEFINE_FLAG(int,
+            inlining_constant_type_arguments_size_threshold,
+            100,
+            "Always inline generic functions and factories which are passed a "
+            "constant type argument vector and have threshold or fewer "
+            "instructions (AOT only).");
+DEFINE_FLAG(int,
+            inlining_constant_type_arguments_budget,
+            2000,
+            "Stop inlining calls with constant type arguments under "
+            "--inlining-constant-type-arguments-size-threshold once this many "
+            "instructions have been inlined from such calls.");
 DEFINE_FLAG(int,
             inlining_callee_call_sites_threshold,
             1,
@@ -76,6 +93,12 @@ DEFINE_FLAG(int,
             500,
             "Max. number of inlined calls per depth");
 DEFINE_FLAG(bool, print_inlining_tree, false, "Print inlining tree");
+DEFINE_FLAG(bool,
+            inlining_prioritize_hot_calls,
+            true,
+            "Inline the call sites of each depth in order of call count times "
+            "estimated benefit, and keep the hottest --max-inlined-per-depth "
+            "call sites instead of giving up when there are more.");
 
 DECLARE_FLAG(int, max_deoptimization_counter_threshold);
 DECLARE_FLAG(bool, print_flow_graph);
@@ -272,6 +295,7 @@ class CallSites : public ValueObject {
   struct InstanceCallInfo {
     PolymorphicInstanceCallInstr* call;
     double ratio;
+    double priority;
     const FlowGraph* caller_graph;
     intptr_t nesting_depth;
     InstanceCallInfo(PolymorphicInstanceCallInstr* call_arg,
@@ -279,6 +303,7 @@ class CallSites : public ValueObject {
                      intptr_t depth)
         : call(call_arg),
           ratio(0.0),
+          priority(0.0),
           caller_graph(flow_graph),
           nesting_depth(depth) {}
     const Function& caller() const { return caller_graph->function(); }
@@ -287,6 +312,7 @@ class CallSites : public ValueObject {
   struct StaticCallInfo {
     StaticCallInstr* call;
     double ratio;
+    double priority;
     FlowGraph* caller_graph;
     intptr_t nesting_depth;
     StaticCallInfo(StaticCallInstr* value,
@@ -294,6 +320,7 @@ class CallSites : public ValueObject {
                    intptr_t depth)
         : call(value),
           ratio(0.0),
+          priority(0.0),
           caller_graph(flow_graph),
           nesting_depth(depth) {}
     const Function& caller() const { return caller_graph->function(); }
@@ -354,6 +381,54 @@ class CallSites : public ValueObject {
     }
   }
 
+  // Same as above, but static calls to functions that never ran during the
+  // training run are cold when AOT feedback was loaded.
+  static intptr_t AotCallCountApproximation(intptr_t nesting_depth,
+                                            const Function& target) {
+    if (Isolate::Current()->has_aot_feedback() &&
+        (target.usage_counter() <= 0)) {
+      return 0;
+    }
+    return AotCallCountApproximation(nesting_depth);
+  }
+
+  // Estimates how much inlining [call] gains beyond removing the call
+  // itself: constant arguments and a known receiver class let the callee
+  // body be specialized.
+  static double EstimateBenefit(Definition* call, bool receiver_cid_known) {
+    double benefit = receiver_cid_known ? 2.0 : 1.0;
+    for (intptr_t i = 0; i < call->ArgumentCount(); ++i) {
+      if (call->ArgumentValueAt(i)->BindsToConstant()) {
+        benefit += 1.0;
+      }
+    }
+    return benefit;
+  }
+
+  // Orders the instance and static calls by decreasing priority, keeping
+  // the order in which they were found for equal priorities.
+  void SortByPriority() {
+    SortByPriority(&instance_calls_);
+    SortByPriority(&static_calls_);
+  }
+
+  // Drops the calls with the lowest priority until at most [max_calls]
+  // remain.
+  void RemoveColdestCalls(intptr_t max_calls) {
+    SortByPriority();
+    while (NumCalls() > max_calls) {
+      if (!instance_calls_.is_empty() &&
+          (static_calls_.is_empty() || instance_calls_.Last().priority <=
+                                           static_calls_.Last().priority)) {
+        instance_calls_.RemoveLast();
+      } else if (!static_calls_.is_empty()) {
+        static_calls_.RemoveLast();
+      } else {
+        closure_calls_.RemoveLast();
+      }
+    }
+  }
+
   // Computes the ratio for each call site in a method, defined as the
   // number of times a call site is executed over the maximum number of
   // times any call site is executed in the method. JIT uses actual call
@@ -383,7 +458,8 @@ class CallSites : public ValueObject {
       const StaticCallInfo& info = static_calls_[i + static_call_start_ix];
       intptr_t aggregate_count =
           CompilerState::Current().is_aot()
-              ? AotCallCountApproximation(info.nesting_depth)
+              ? AotCallCountApproximation(info.nesting_depth,
+                                          info.call->function())
               : info.call->CallCount();
       static_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
@@ -395,14 +471,25 @@ class CallSites : public ValueObject {
           (max_count == 0)
               ? 0.0
               : static_cast<double>(instance_call_counts[i]) / max_count;
-      instance_calls_[i + instance_call_start_ix].ratio = ratio;
+      InstanceCallInfo* info = &instance_calls_[i + instance_call_start_ix];
+      info->ratio = ratio;
+      info->priority =
+          instance_call_counts[i] *
+          EstimateBenefit(info->call, info->call->targets().IsMonomorphic());
     }
     for (intptr_t i = 0; i < num_static_calls; ++i) {
       const double ratio =
           (max_count == 0)
               ? 0.0
               : static_cast<double>(static_call_counts[i]) / max_count;
-      static_calls_[i + static_call_start_ix].ratio = ratio;
+      StaticCallInfo* info = &static_calls_[i + static_call_start_ix];
+      info->ratio = ratio;
+      const bool receiver_cid_known =
+          !info->call->function().is_static() &&
+          (info->call->Receiver()->Type()->ToCid() != kDynamicCid);
+      info->priority =
+          static_call_counts[i] * EstimateBenefit(info->call,
+                                                  receiver_cid_known);
     }
   }
 
@@ -521,6 +608,20 @@ class CallSites : public ValueObject {
   }
 
  private:
+  // Stable insertion sort, as call sites with equal priority are common.
+  template <typename CallInfo>
+  static void SortByPriority(GrowableArray<CallInfo>* calls) {
+    for (intptr_t i = 1; i < calls->length(); ++i) {
+      const CallInfo info = (*calls)[i];
+      intptr_t j = i;
+      while (j > 0 && (*calls)[j - 1].priority < info.priority) {
+        (*calls)[j] = (*calls)[j - 1];
+        --j;
+      }
+      (*calls)[j] = info;
+    }
+  }
+
   intptr_t inlining_depth_threshold_;
   GrowableArray<StaticCallInfo> static_calls_;
   GrowableArray<ClosureCallInfo> closure_calls_;
@@ -755,6 +856,7 @@ class CallSiteInliner : public ValueObject {
         inlined_(false),
         initial_size_(inliner->flow_graph()->InstructionCount()),
         inlined_size_(0),
+        specialized_size_(0),
         inlined_recursive_call_(false),
         inlining_depth_(1),
         inlining_recursion_depth_(0),
@@ -787,9 +889,43 @@ class CallSiteInliner : public ValueObject {
   };
 
   // Inlining heuristics based on Cooper et al. 2008.
+  // Returns true if calling the callee allocates a box for its result which
+  // the caller is likely to unbox again: the result is in an unboxed
+  // representation inside the callee, but crosses the call as an object.
+  static bool ReturnsBoxedUnboxable(const Function& callee) {
+    if (callee.has_unboxed_return()) {
+      return false;
+    }
+    const AbstractType& result_type =
+        AbstractType::Handle(callee.result_type());
+    if (result_type.IsNull()) {
+      return false;
+    }
+    return result_type.IsDoubleType() ||
+           (FlowGraphCompiler::SupportsUnboxedSimd128() &&
+            (result_type.IsFloat32x4Type() || result_type.IsFloat64x2Type()));
+  }
+
+  // Returns true if the call passes a statically known, non-null type
+  // argument vector to the callee. Inlining such a call specializes the
+  // callee for these type arguments: type checks and instantiations in its
+  // body can be constant folded.
+  static bool HasConstantTypeArguments(const Function& callee,
+                                       const InlinedCallData& call_data) {
+    Value* type_args = nullptr;
+    if (call_data.first_arg_index > 0) {
+      type_args = (*call_data.arguments)[0];
+    } else if (callee.IsFactory() && !call_data.arguments->is_empty()) {
+      type_args = (*call_data.arguments)[0];
+    }
+    return (type_args != nullptr) && type_args->BindsToConstant() &&
+           !type_args->BoundConstant().IsNull();
+  }
+
   InliningDecision ShouldWeInline(const Function& callee,
                                   intptr_t instr_count,
-                                  intptr_t call_site_count) {
+                                  intptr_t call_site_count,
+                                  bool constant_type_arguments) {
     // Pragma or size heuristics.
     if (inliner_->AlwaysInline(callee)) {
       return InliningDecision::Yes("AlwaysInline");
@@ -814,6 +950,16 @@ class CallSiteInliner : public ValueObject {
       return InliningDecision::Yes("need to count first");
     } else if (instr_count <= FLAG_inlining_size_threshold) {
       return InliningDecision::Yes("--inlining-size-threshold");
+    } else if (instr_count <= FLAG_inlining_boxed_result_size_threshold &&
+               ReturnsBoxedUnboxable(callee)) {
+      return InliningDecision::Yes("--inlining-boxed-result-size-threshold");
+    } else if (constant_type_arguments && CompilerState::Current().is_aot() &&
+               instr_count <=
+                   FLAG_inlining_constant_type_arguments_size_threshold &&
+               specialized_size_ + instr_count <=
+                   FLAG_inlining_constant_type_arguments_budget) {
+      return InliningDecision::Yes(
+          "--inlining-constant-type-arguments-size-threshold");
     } else if (call_site_count <= FLAG_inlining_callee_call_sites_threshold) {
       return InliningDecision::Yes("--inlining-callee-call-sites-threshold");
     }
@@ -846,13 +992,18 @@ class CallSiteInliner : public ValueObject {
                   static_cast<intptr_t>(FLAG_max_inlined_per_depth));
       }
       if (collected_call_sites_->NumCalls() > FLAG_max_inlined_per_depth) {
-        break;
+        if (!FLAG_inlining_prioritize_hot_calls) break;
+        collected_call_sites_->RemoveColdestCalls(FLAG_max_inlined_per_depth);
       }
       // Swap collected and inlining arrays and clear the new collecting array.
       call_sites_temp = collected_call_sites_;
       collected_call_sites_ = inlining_call_sites_;
       inlining_call_sites_ = call_sites_temp;
       collected_call_sites_->Clear();
+      // Let the hottest calls use up the size budget first.
+      if (FLAG_inlining_prioritize_hot_calls) {
+        inlining_call_sites_->SortByPriority();
+      }
       // Inline call sites at the current depth.
       bool inlined_instance = InlineInstanceCalls();
       bool inlined_statics = InlineStaticCalls();
@@ -967,8 +1118,10 @@ class CallSiteInliner : public ValueObject {
         constant_arg_count == 0 ? function.optimized_instruction_count() : 0;
     const intptr_t call_site_count =
         constant_arg_count == 0 ? function.optimized_call_site_count() : 0;
-    InliningDecision decision =
-        ShouldWeInline(function, instruction_count, call_site_count);
+    const bool constant_type_arguments =
+        HasConstantTypeArguments(function, *call_data);
+    InliningDecision decision = ShouldWeInline(
+        function, instruction_count, call_site_count, constant_type_arguments);
     if (!decision.value) {
       TRACE_INLINING(
           THR_Print("     Bailout: early heuristics (%s) with "
@@ -1197,7 +1350,8 @@ class CallSiteInliner : public ValueObject {
 
         // Use heuristics do decide if this call should be inlined.
         InliningDecision decision =
-            ShouldWeInline(function, instruction_count, call_site_count);
+            ShouldWeInline(function, instruction_count, call_site_count,
+                           constant_type_arguments);
         if (!decision.value) {
           // If size is larger than all thresholds, don't consider it again.
           if ((instruction_count > FLAG_inlining_size_threshold) &&
@@ -1245,6 +1399,9 @@ class CallSiteInliner : public ValueObject {
         // Build succeeded so we restore the bailout jump.
         inlined_ = true;
         inlined_size_ += instruction_count;
+        if (constant_type_arguments) {
+          specialized_size_ += instruction_count;
+        }
         if (is_recursive_call) {
           inlined_recursive_call_ = true;
         }
@@ -1639,6 +1796,9 @@ class CallSiteInliner : public ValueObject {
   bool inlined_;
   const intptr_t initial_size_;
   intptr_t inlined_size_;
+  // Instructions inlined from calls with constant type arguments, bounded by
+  // --inlining-constant-type-arguments-budget.
+  intptr_t specialized_size_;
   bool inlined_recursive_call_;
   intptr_t inlining_depth_;
   intptr_t inlining_recursion_depth_;
@@ -13,6 +13,10 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, inlining_constant_type_arguments_size_threshold);
+DECLARE_FLAG(bool, inlining_prioritize_hot_calls);
+DECLARE_FLAG(int, max_inlined_per_depth);
+
 // Test that the redefinition for an inlined polymorphic function used with
 // multiple receiver cids does not have a concrete type.
 ISOLATE_UNIT_TEST_CASE(Inliner_PolyInliningRedefinition) {
@@ -254,6 +258,112 @@ ISOLATE_UNIT_TEST_CASE(Inliner_List_generate) {
   EXPECT(unbox2->IsUnboxedConstant() || unbox2->IsUnboxInt64());
 }
 
+static intptr_t CountStaticCallsTo(FlowGraph* flow_graph, const char* name) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      StaticCallInstr* call = it.Current()->AsStaticCall();
+      if (call != nullptr &&
+          strcmp(String::Handle(call->function().name()).ToCString(), name) ==
+              0) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+// Verifies that a generic function which is too large for the regular
+// heuristics is inlined (and thus specialized) when it is passed constant
+// type arguments.
+ISOLATE_UNIT_TEST_CASE(Inliner_ConstantTypeArguments) {
+  const char* kScript = R"(
+    @pragma('vm:never-inline')
+    void sink(Object o) {}
+
+    List<T> wrap<T>(Object a, Object b, Object c) {
+      final result = <T>[];
+      if (a is T) result.add(a);
+      if (b is T) result.add(b);
+      if (c is T) result.add(c);
+      sink(a);
+      sink(b);
+      sink(c);
+      return result;
+    }
+
+    foo() => wrap<int>(1, 2, 3);
+
+    main() {
+      foo();
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+
+  {
+    SetFlagScope<int> sfs(&FLAG_inlining_constant_type_arguments_size_threshold,
+                          0);
+    TestPipeline pipeline(function, CompilerPass::kAOT);
+    FlowGraph* flow_graph = pipeline.RunPasses({});
+    EXPECT_EQ(1, CountStaticCallsTo(flow_graph, "wrap"));
+  }
+
+  {
+    TestPipeline pipeline(function, CompilerPass::kAOT);
+    FlowGraph* flow_graph = pipeline.RunPasses({});
+    EXPECT_EQ(0, CountStaticCallsTo(flow_graph, "wrap"));
+  }
+}
+
+// Verifies that when a function has more call sites than can be inlined at
+// one depth, the hottest call sites are kept instead of inlining none.
+ISOLATE_UNIT_TEST_CASE(Inliner_PrioritizeHotCalls) {
+  const char* kScript = R"(
+    int cold1(int x) => x + 1;
+    int cold2(int x) => x + 2;
+    int cold3(int x) => x + 3;
+    int cold4(int x) => x + 4;
+    int cold5(int x) => x + 5;
+    int cold6(int x) => x + 6;
+
+    int hot(int x, int a, int b) => x * a + b;
+
+    int foo(int n) {
+      int r = cold1(n) + cold2(n) + cold3(n);
+      r += cold4(n) + cold5(n) + cold6(n);
+      for (int i = 0; i < n; i++) {
+        r = hot(r, 1, 2);
+      }
+      return r;
+    }
+
+    main() {
+      foo(10);
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  SetFlagScope<int> sfs(&FLAG_max_inlined_per_depth, 2);
+
+  {
+    SetFlagScope<bool> sfs2(&FLAG_inlining_prioritize_hot_calls, false);
+    TestPipeline pipeline(function, CompilerPass::kAOT);
+    FlowGraph* flow_graph = pipeline.RunPasses({});
+    EXPECT_EQ(1, CountStaticCallsTo(flow_graph, "hot"));
+  }
+
+  {
+    TestPipeline pipeline(function, CompilerPass::kAOT);
+    FlowGraph* flow_graph = pipeline.RunPasses({});
+    EXPECT_EQ(0, CountStaticCallsTo(flow_graph, "hot"));
+  }
+}
+
 #endif  // defined(DART_PRECOMPILER)
 
 }  // namespace dart
@@ -540,6 +540,25 @@ static bool HasOnlyUnconstrainedUses(LiveRange* range) {
   return true;
 }
 
+// Returns true if the value of the given definition can be recomputed by
+// a parallel move instead of being stored to and reloaded from a spill slot.
+static bool IsRematerializable(Definition* def) {
+  ConstantInstr* constant = def->AsConstant();
+  if ((constant == nullptr) || def->HasPairRepresentation()) {
+    return false;
+  }
+  switch (constant->representation()) {
+    case kTagged:
+    case kUnboxedDouble:
+    case kUnboxedInt32:
+    case kUnboxedUint32:
+    case kUnboxedInt64:
+      return true;
+    default:
+      return false;
+  }
+}
+
 void FlowGraphAllocator::BuildLiveRanges() {
   const intptr_t block_count = postorder_.length();
   ASSERT(postorder_.Last()->IsGraphEntry());
@@ -1237,6 +1256,14 @@ void FlowGraphAllocator::ProcessOneOutput(BlockEntryInstr* block,
     range->AddUse(pos, out);
   }
 
+  // Constants (e.g. UnboxedConstant) that needed a register at some use
+  // are rematerialized when spilled: parts of the range that do not get a
+  // register are assigned the constant itself, which avoids both the store
+  // at the definition and the reloads from the stack.
+  if ((range->vreg() >= 0) && IsRematerializable(def)) {
+    range->set_spill_slot(Location::Constant(def->AsConstant()));
+  }
+
   AssignSafepoints(def, range);
   CompleteRange(range, def->RegisterKindForResult());
 }
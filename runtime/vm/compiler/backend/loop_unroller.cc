@@ -0,0 +1,524 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_unroller.h"
+
+#include "vm/bit_vector.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/compiler/backend/range_analysis.h"
+#include "vm/flags.h"
+#include "vm/hash_map.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool, loop_unrolling, false, "Unroll small counted loops.");
+DEFINE_FLAG(int,
+            loop_unrolling_budget,
+            48,
+            "Maximum number of instructions in the body of an unrolled loop.");
+DEFINE_FLAG(bool,
+            induction_strength_reduction,
+            false,
+            "Replace multiplications of induction variables by additions.");
+
+static bool ToInt64(Value* value, int64_t* result) {
+  if (!value->BindsToConstant() || !value->BoundConstant().IsInteger()) {
+    return false;
+  }
+  *result = Integer::Cast(value->BoundConstant()).AsInt64Value();
+  return true;
+}
+
+static Definition* IntegerConstant(FlowGraph* flow_graph, int64_t value) {
+  return flow_graph->GetConstant(
+      Integer::ZoneHandle(flow_graph->zone(), Integer::NewCanonical(value)));
+}
+
+static void SetPhiInput(PhiInstr* phi, intptr_t i, Definition* def) {
+  Value* input = new Value(def);
+  phi->SetInputAt(i, input);
+  def->AddInputUse(input);
+}
+
+static PhiInstr* NewPhi(FlowGraph* flow_graph,
+                        JoinEntryInstr* join,
+                        Representation representation) {
+  PhiInstr* phi = new PhiInstr(join, join->PredecessorCount());
+  phi->set_representation(representation);
+  flow_graph->AllocateSSAIndexes(phi);
+  phi->mark_alive();
+  join->InsertPhi(phi);
+  return phi;
+}
+
+// Replaces every i * c in the loop, where i is a header phi, by a new induction
+// that is updated with an addition on the back edge.
+static void ReduceStrength(FlowGraph* flow_graph, LoopInfo* loop) {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  if (header == nullptr || header->PredecessorCount() != 2 ||
+      loop->back_edges().length() != 1) {
+    return;
+  }
+  BlockEntryInstr* back_edge = loop->back_edges()[0];
+  const intptr_t back_index = header->IndexOfPredecessor(back_edge);
+  if (back_index < 0) {
+    return;
+  }
+
+  for (BitVector::Iterator block_it(loop->blocks()); !block_it.Done();
+       block_it.Advance()) {
+    BlockEntryInstr* block = flow_graph->preorder()[block_it.Current()];
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      BinaryIntegerOpInstr* mul = it.Current()->AsBinaryIntegerOp();
+      if (mul == nullptr || mul->op_kind() != Token::kMUL ||
+          mul->CanDeoptimize()) {
+        continue;
+      }
+      const Representation rep = mul->representation();
+      if (rep != kTagged && rep != kUnboxedInt64) {
+        continue;
+      }
+      Value* induction = mul->left();
+      int64_t factor = 0;
+      if (!ToInt64(mul->right(), &factor)) {
+        induction = mul->right();
+        if (!ToInt64(mul->left(), &factor)) continue;
+      }
+      Definition* phi = induction->definition();
+      int64_t stride = 0;
+      int64_t initial = 0;
+      InductionVar* induc = loop->LookupInduction(phi);
+      if (!loop->IsHeaderPhi(phi) || !InductionVar::IsLinear(induc, &stride) ||
+          !InductionVar::IsConstant(induc->initial(), &initial)) {
+        continue;
+      }
+      const int64_t start = Utils::MulWithWrapAround(initial, factor);
+      const int64_t step = Utils::MulWithWrapAround(stride, factor);
+      if (rep == kTagged &&
+          (!Utils::IsInt(31, initial) || !Utils::IsInt(31, stride) ||
+           !Utils::IsInt(31, factor) || !Smi::IsValid(start) ||
+           !Smi::IsValid(step))) {
+        continue;
+      }
+
+      // The value computed for the iteration after the last one is never
+      // used, so the addition is allowed to wrap around.
+      PhiInstr* reduced = NewPhi(flow_graph, header, rep);
+      Definition* next = BinaryIntegerOpInstr::Make(
+          rep, Token::kADD, new Value(reduced),
+          new Value(IntegerConstant(flow_graph, step)), DeoptId::kNone,
+          /*can_overflow=*/false, /*is_truncating=*/rep != kTagged, nullptr,
+          Instruction::kNotSpeculative);
+      flow_graph->InsertBefore(back_edge->last_instruction(), next, nullptr,
+                               FlowGraph::kValue);
+      SetPhiInput(reduced, 1 - back_index, IntegerConstant(flow_graph, start));
+      SetPhiInput(reduced, back_index, next);
+
+      mul->ReplaceUsesWith(reduced);
+      it.RemoveCurrentFromGraph();
+    }
+  }
+}
+
+static intptr_t DeoptIdOf(Instruction* instr) {
+  return instr->ComputeCanDeoptimize() ? instr->deopt_id() : DeoptId::kNone;
+}
+
+// A loop of the form
+//
+//   preheader:
+//     goto header
+//   header:
+//     i = phi(i0, i + 1), other phis...
+//     [CheckStackOverflow]
+//     if (i < n) goto body else goto exit
+//   body:
+//     ...
+//     goto header
+//
+// with a small body that consists only of instructions that can be cloned.
+class UnrollableLoop : public ZoneAllocated {
+ public:
+  UnrollableLoop(FlowGraph* flow_graph, LoopInfo* loop)
+      : flow_graph_(flow_graph), loop_(loop), copies_() {}
+
+  // Returns true if the loop has the shape above. Chooses the unroll factor.
+  bool Analyze();
+
+  // Builds the unrolled loop in front of the scalar loop. Phis are wired up
+  // by ConnectPhis once the predecessors have been recomputed.
+  void Rewrite();
+  void ConnectPhis();
+
+ private:
+  typedef RawPointerKeyValueTrait<Definition, Definition*> CopyKV;
+
+  static bool IsCloneable(Instruction* instr);
+
+  Definition* CopyOf(Definition* def) const {
+    Definition* copy = copies_.LookupValue(def);
+    return copy != nullptr ? copy : def;
+  }
+  Value* CopyOf(Value* value) const {
+    return new Value(CopyOf(value->definition()));
+  }
+
+  Instruction* Clone(Instruction* instr);
+  void CloneEnvironment(Instruction* instr, Instruction* clone);
+
+  intptr_t PhiCount() const { return header_->phis()->length(); }
+  PhiInstr* PhiAt(intptr_t i) const { return (*header_->phis())[i]; }
+
+  FlowGraph* flow_graph_;
+  LoopInfo* loop_;
+  intptr_t factor_ = 0;
+
+  // The scalar loop.
+  JoinEntryInstr* header_ = nullptr;
+  BlockEntryInstr* preheader_ = nullptr;
+  TargetEntryInstr* body_ = nullptr;
+  PhiInstr* index_ = nullptr;
+  CheckStackOverflowInstr* check_ = nullptr;
+  RelationalOpInstr* compare_ = nullptr;
+  GrowableArray<Definition*> initial_values_;
+  GrowableArray<Definition*> next_values_;
+
+  // The unrolled loop.
+  DirectChainedHashMap<CopyKV> copies_;
+  JoinEntryInstr* unrolled_header_ = nullptr;
+  TargetEntryInstr* unrolled_body_ = nullptr;
+  TargetEntryInstr* unrolled_exit_ = nullptr;
+  GrowableArray<PhiInstr*> unrolled_phis_;
+  GrowableArray<Definition*> unrolled_next_values_;
+};
+
+bool UnrollableLoop::IsCloneable(Instruction* instr) {
+  return instr->IsLoadIndexed() || instr->IsStoreIndexed() ||
+         instr->IsCheckArrayBound() || instr->IsGenericCheckBound() ||
+         instr->IsBinaryIntegerOp() || instr->IsBinaryDoubleOp() ||
+         instr->IsBox() || instr->IsUnbox() || instr->IsIntConverter() ||
+         instr->IsFloatToDouble() || instr->IsDoubleToFloat();
+}
+
+bool UnrollableLoop::Analyze() {
+  header_ = loop_->header()->AsJoinEntry();
+  if (header_ == nullptr || header_->InsideTryBlock() ||
+      header_->PredecessorCount() != 2 || loop_->back_edges().length() != 1) {
+    return false;
+  }
+  body_ = loop_->back_edges()[0]->AsTargetEntry();
+  if (body_ == nullptr || body_->PredecessorAt(0) != header_ ||
+      !body_->last_instruction()->IsGoto()) {
+    return false;
+  }
+  const intptr_t body_index = header_->IndexOfPredecessor(body_);
+  preheader_ = header_->PredecessorAt(1 - body_index);
+  if (!preheader_->last_instruction()->IsGoto() ||
+      header_->phis() == nullptr) {
+    return false;
+  }
+
+  BranchInstr* branch = header_->last_instruction()->AsBranch();
+  if (branch == nullptr || branch->true_successor() != body_) {
+    return false;
+  }
+  for (ForwardInstructionIterator it(header_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current == branch) continue;
+    if (current->IsCheckStackOverflow() && check_ == nullptr) {
+      check_ = current->AsCheckStackOverflow();
+      continue;
+    }
+    return false;
+  }
+
+  // The loop test must be i < n for a unit stride induction i starting at a
+  // constant, and a non-negative invariant n, so that n - (k - 1) does not
+  // overflow.
+  compare_ = branch->comparison()->AsRelationalOp();
+  if (compare_ == nullptr || compare_->kind() != Token::kLT) {
+    return false;
+  }
+  index_ = compare_->left()->definition()->AsPhi();
+  Definition* limit = compare_->right()->definition();
+  int64_t stride = 0;
+  int64_t initial = 0;
+  if (index_ == nullptr || !loop_->IsHeaderPhi(index_) ||
+      !InductionVar::IsLinear(loop_->LookupInduction(index_), &stride) ||
+      stride != 1 ||
+      !InductionVar::IsConstant(loop_->LookupInduction(index_)->initial(),
+                                &initial) ||
+      loop_->Contains(limit->GetBlock())) {
+    return false;
+  }
+  int64_t constant_limit = 0;
+  if (!RangeUtils::IsPositive(limit->range()) &&
+      !(ToInt64(compare_->right(), &constant_limit) && constant_limit >= 0)) {
+    return false;
+  }
+  const bool is_smi = (compare_->operation_cid() == kSmiCid) &&
+                      (index_->representation() == kTagged);
+  const bool is_mint = (compare_->operation_cid() == kMintCid) &&
+                       (index_->representation() == kUnboxedInt64);
+  if (!is_smi && !is_mint) {
+    return false;
+  }
+
+  intptr_t size = 0;
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto()) continue;
+    if (!IsCloneable(current)) {
+      return false;
+    }
+    size++;
+  }
+  if (size == 0) {
+    return false;
+  }
+  factor_ = (4 * size <= FLAG_loop_unrolling_budget)
+                ? 4
+                : (2 * size <= FLAG_loop_unrolling_budget) ? 2 : 1;
+  if (factor_ == 1) {
+    return false;
+  }
+
+  for (intptr_t i = 0; i < PhiCount(); ++i) {
+    initial_values_.Add(PhiAt(i)->InputAt(1 - body_index)->definition());
+    next_values_.Add(PhiAt(i)->InputAt(body_index)->definition());
+  }
+  return true;
+}
+
+Instruction* UnrollableLoop::Clone(Instruction* instr) {
+  const intptr_t deopt_id = DeoptIdOf(instr);
+  if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+    return new LoadIndexedInstr(
+        CopyOf(load->array()), CopyOf(load->index()),
+        load->RequiredInputRepresentation(1) != kTagged, load->index_scale(),
+        load->class_id(), load->aligned() ? kAlignedAccess : kUnalignedAccess,
+        deopt_id, load->token_pos());
+  }
+  if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+    return new StoreIndexedInstr(
+        CopyOf(store->array()), CopyOf(store->index()), CopyOf(store->value()),
+        store->ShouldEmitStoreBarrier() ? kEmitStoreBarrier : kNoStoreBarrier,
+        store->RequiredInputRepresentation(1) != kTagged,
+        store->index_scale(), store->class_id(),
+        store->aligned() ? kAlignedAccess : kUnalignedAccess, deopt_id,
+        store->token_pos(), store->SpeculativeModeOfInputs());
+  }
+  if (CheckArrayBoundInstr* check = instr->AsCheckArrayBound()) {
+    return new CheckArrayBoundInstr(CopyOf(check->length()),
+                                    CopyOf(check->index()), deopt_id);
+  }
+  if (GenericCheckBoundInstr* check = instr->AsGenericCheckBound()) {
+    return new GenericCheckBoundInstr(CopyOf(check->length()),
+                                      CopyOf(check->index()), deopt_id);
+  }
+  if (BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp()) {
+    return BinaryIntegerOpInstr::Make(
+        op->representation(), op->op_kind(), CopyOf(op->left()),
+        CopyOf(op->right()), deopt_id, op->can_overflow(),
+        op->is_truncating(), op->range(), op->SpeculativeModeOfInputs());
+  }
+  if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+    return new BinaryDoubleOpInstr(op->op_kind(), CopyOf(op->left()),
+                                   CopyOf(op->right()), deopt_id,
+                                   op->token_pos(),
+                                   op->SpeculativeModeOfInputs());
+  }
+  if (BoxInstr* box = instr->AsBox()) {
+    return BoxInstr::Create(box->from_representation(), CopyOf(box->value()));
+  }
+  if (UnboxInstr* unbox = instr->AsUnbox()) {
+    UnboxInstr* clone =
+        UnboxInstr::Create(unbox->representation(), CopyOf(unbox->value()),
+                           deopt_id, unbox->SpeculativeModeOfInputs());
+    if (unbox->IsUnboxInteger() && unbox->AsUnboxInteger()->is_truncating()) {
+      clone->AsUnboxInteger()->mark_truncating();
+    }
+    return clone;
+  }
+  if (IntConverterInstr* conv = instr->AsIntConverter()) {
+    IntConverterInstr* clone = new IntConverterInstr(
+        conv->from(), conv->to(), CopyOf(conv->value()), deopt_id);
+    if (conv->is_truncating()) {
+      clone->mark_truncating();
+    }
+    return clone;
+  }
+  if (FloatToDoubleInstr* conv = instr->AsFloatToDouble()) {
+    return new FloatToDoubleInstr(CopyOf(conv->value()), deopt_id);
+  }
+  DoubleToFloatInstr* conv = instr->AsDoubleToFloat();
+  ASSERT(conv != nullptr);
+  return new DoubleToFloatInstr(CopyOf(conv->value()), deopt_id,
+                                conv->SpeculativeModeOfInputs());
+}
+
+void UnrollableLoop::CloneEnvironment(Instruction* instr, Instruction* clone) {
+  if (instr->env() == nullptr) {
+    return;
+  }
+  // A deoptimization in a copy resumes at the iteration that copy runs.
+  instr->env()->DeepCopyTo(flow_graph_->zone(), clone);
+  for (Environment::DeepIterator it(clone->env()); !it.Done(); it.Advance()) {
+    Definition* def = it.CurrentValue()->definition();
+    Definition* copy = CopyOf(def);
+    if (copy != def) {
+      it.CurrentValue()->BindToEnvironment(copy);
+    }
+  }
+}
+
+void UnrollableLoop::Rewrite() {
+  const Representation rep = index_->representation();
+  GotoInstr* preheader_goto = preheader_->last_instruction()->AsGoto();
+
+  Definition* limit = BinaryIntegerOpInstr::Make(
+      rep, Token::kSUB, new Value(compare_->right()->definition()),
+      new Value(IntegerConstant(flow_graph_, factor_ - 1)), DeoptId::kNone,
+      /*can_overflow=*/false, /*is_truncating=*/false, nullptr,
+      Instruction::kNotSpeculative);
+  flow_graph_->InsertBefore(preheader_goto, limit, nullptr, FlowGraph::kValue);
+
+  unrolled_header_ = new JoinEntryInstr(flow_graph_->allocate_block_id(),
+                                        header_->try_index(), DeoptId::kNone);
+  unrolled_body_ = new TargetEntryInstr(flow_graph_->allocate_block_id(),
+                                        header_->try_index(), DeoptId::kNone);
+  unrolled_exit_ = new TargetEntryInstr(flow_graph_->allocate_block_id(),
+                                        header_->try_index(), DeoptId::kNone);
+
+  // Unrolled loop header.
+  for (intptr_t i = 0; i < PhiCount(); ++i) {
+    PhiInstr* phi = new PhiInstr(unrolled_header_, 2);
+    phi->set_representation(PhiAt(i)->representation());
+    flow_graph_->AllocateSSAIndexes(phi);
+    phi->mark_alive();
+    unrolled_header_->InsertPhi(phi);
+    unrolled_phis_.Add(phi);
+    copies_.Update({PhiAt(i), phi});
+  }
+  Instruction* cursor = unrolled_header_;
+  if (check_ != nullptr) {
+    Instruction* check = new CheckStackOverflowInstr(
+        check_->token_pos(), check_->stack_depth(), check_->loop_depth(),
+        check_->deopt_id(), CheckStackOverflowInstr::kOsrAndPreemption);
+    cursor = cursor->AppendInstruction(check);
+    CloneEnvironment(check_, check);
+  }
+  BranchInstr* branch = new BranchInstr(
+      new RelationalOpInstr(compare_->token_pos(), Token::kLT,
+                            CopyOf(compare_->left()), new Value(limit),
+                            compare_->operation_cid(), DeoptId::kNone,
+                            Instruction::kNotSpeculative),
+      DeoptId::kNone);
+  cursor->AppendInstruction(branch);
+  unrolled_header_->set_last_instruction(branch);
+  *branch->true_successor_address() = unrolled_body_;
+  *branch->false_successor_address() = unrolled_exit_;
+
+  // Unrolled loop body: the scalar body repeated factor_ times, each copy
+  // reading the header phis from the values the previous copy computed.
+  cursor = unrolled_body_;
+  for (intptr_t copy = 0; copy < factor_; ++copy) {
+    for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+      Instruction* current = it.Current();
+      if (current->IsGoto()) continue;
+      Instruction* clone = Clone(current);
+      if (Definition* def = clone->AsDefinition()) {
+        flow_graph_->AllocateSSAIndexes(def);
+        copies_.Update({current->AsDefinition(), def});
+      }
+      cursor = cursor->AppendInstruction(clone);
+      CloneEnvironment(current, clone);
+    }
+    GrowableArray<Definition*> next_values(PhiCount());
+    for (intptr_t i = 0; i < PhiCount(); ++i) {
+      next_values.Add(CopyOf(next_values_[i]));
+    }
+    for (intptr_t i = 0; i < PhiCount(); ++i) {
+      copies_.Update({PhiAt(i), next_values[i]});
+    }
+  }
+  for (intptr_t i = 0; i < PhiCount(); ++i) {
+    unrolled_next_values_.Add(CopyOf(PhiAt(i)));
+  }
+  GotoInstr* back_edge = new GotoInstr(unrolled_header_, DeoptId::kNone);
+  cursor->AppendInstruction(back_edge);
+  unrolled_body_->set_last_instruction(back_edge);
+
+  // The scalar loop runs the remaining iterations.
+  GotoInstr* exit_goto = new GotoInstr(header_, DeoptId::kNone);
+  unrolled_exit_->AppendInstruction(exit_goto);
+  unrolled_exit_->set_last_instruction(exit_goto);
+  preheader_goto->set_successor(unrolled_header_);
+}
+
+void UnrollableLoop::ConnectPhis() {
+  const intptr_t unrolled_back = unrolled_header_->IndexOfPredecessor(
+      unrolled_body_);
+  const intptr_t scalar_back = header_->IndexOfPredecessor(body_);
+  ASSERT(unrolled_back >= 0 && scalar_back >= 0);
+  for (intptr_t i = 0; i < PhiCount(); ++i) {
+    PhiInstr* unrolled = unrolled_phis_[i];
+    SetPhiInput(unrolled, 1 - unrolled_back, initial_values_[i]);
+    SetPhiInput(unrolled, unrolled_back, unrolled_next_values_[i]);
+
+    // The scalar header is now entered from the exit of the unrolled loop.
+    PhiInstr* phi = PhiAt(i);
+    phi->InputAt(0)->RemoveFromUseList();
+    phi->InputAt(1)->RemoveFromUseList();
+    SetPhiInput(phi, 1 - scalar_back, unrolled);
+    SetPhiInput(phi, scalar_back, next_values_[i]);
+  }
+}
+
+void LoopUnroller::Optimize(FlowGraph* flow_graph) {
+  if (!FLAG_induction_strength_reduction && !FLAG_loop_unrolling) {
+    return;
+  }
+
+  const LoopHierarchy& loop_hierarchy = flow_graph->GetLoopHierarchy();
+  loop_hierarchy.ComputeInduction();
+  const ZoneGrowableArray<BlockEntryInstr*>& headers =
+      loop_hierarchy.headers();
+
+  if (FLAG_induction_strength_reduction) {
+    for (intptr_t i = 0; i < headers.length(); ++i) {
+      ReduceStrength(flow_graph, headers[i]->loop_info());
+    }
+  }
+
+  // The OSR entry of a loop would have to be duplicated into the copy.
+  if (!FLAG_loop_unrolling || flow_graph->IsCompiledForOsr()) {
+    return;
+  }
+  GrowableArray<UnrollableLoop*> candidates;
+  for (intptr_t i = 0; i < headers.length(); ++i) {
+    LoopInfo* loop = headers[i]->loop_info();
+    if (loop->inner() != nullptr) continue;
+    UnrollableLoop* candidate = new UnrollableLoop(flow_graph, loop);
+    if (candidate->Analyze()) {
+      candidates.Add(candidate);
+    }
+  }
+  if (candidates.is_empty()) {
+    return;
+  }
+  for (intptr_t i = 0; i < candidates.length(); ++i) {
+    candidates[i]->Rewrite();
+  }
+  flow_graph->DiscoverBlocks();
+  for (intptr_t i = 0; i < candidates.length(); ++i) {
+    candidates[i]->ConnectPhis();
+  }
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph->ComputeDominators(&dominance_frontier);
+}
+
+}  // namespace dart
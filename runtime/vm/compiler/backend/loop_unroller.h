@@ -0,0 +1,40 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+
+// Optimizes innermost loops using the induction variables found by
+// InductionVarAnalysis:
+//
+// - Strength reduction replaces i * c, where i is a linear induction with
+//   constant initial value and stride s, by a new induction j that starts
+//   at i0 * c and is incremented by s * c on the back edge.
+//
+// - Unrolling turns a loop 'for (i = i0; i < n; i++) body' whose body is a
+//   single small block into
+//
+//     for (; i < n - (k - 1); ) { body; i++; ... body; i++; }   // k times
+//     for (; i < n; i++) body;
+//
+//   which runs the stack overflow check and the loop test once per k
+//   iterations. The unroll factor k is chosen from the size of the body.
+class LoopUnroller : public AllStatic {
+ public:
+  static void Optimize(FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
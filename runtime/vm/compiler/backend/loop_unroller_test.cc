@@ -0,0 +1,97 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Unit tests for loop unrolling and induction strength reduction.
+
+#include "vm/compiler/backend/loop_unroller.h"
+
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+DECLARE_FLAG(bool, loop_unrolling);
+DECLARE_FLAG(bool, induction_strength_reduction);
+
+// Helper method to count instructions satisfying the given predicate.
+template <typename Predicate>
+static intptr_t CountInstructions(FlowGraph* flow_graph, Predicate predicate) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (predicate(it.Current())) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+// Helper method to optimize the given function after running main.
+static FlowGraph* OptimizeLoops(const char* script_chars,
+                                const char* function_name) {
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  const auto& function =
+      Function::Handle(GetFunction(root_library, function_name));
+  Invoke(root_library, "main");
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  return pipeline.RunPasses({});
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopUnroller_UnrollsTypedDataLoop) {
+  SetFlagScope<bool> sfs(&FLAG_loop_unrolling, true);
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      fill(Uint8List a) {
+        for (int i = 0; i < a.length; i++) {
+          a[i] = i;
+        }
+      }
+
+      main() {
+        final a = Uint8List(11);
+        fill(a);
+        if (a[10] != 10) throw "bad result";
+      }
+      )";
+  FlowGraph* flow_graph = OptimizeLoops(kScript, "fill");
+  // Four copies in the unrolled loop and one in the scalar loop.
+  EXPECT_EQ(5, CountInstructions(flow_graph, [](Instruction* instr) {
+              return instr->IsStoreIndexed();
+            }));
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopUnroller_ReducesInductionMultiply) {
+  SetFlagScope<bool> sfs(&FLAG_induction_strength_reduction, true);
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      stride(Uint8List a) {
+        for (int i = 0; i < 10; i++) {
+          a[i * 3] = 1;
+        }
+      }
+
+      main() {
+        final a = Uint8List(30);
+        stride(a);
+        if (a[27] != 1) throw "bad result";
+      }
+      )";
+  FlowGraph* flow_graph = OptimizeLoops(kScript, "stride");
+  EXPECT_EQ(0, CountInstructions(flow_graph, [](Instruction* instr) {
+              BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp();
+              return op != nullptr && op->op_kind() == Token::kMUL;
+            }));
+}
+
+}  // namespace dart
@@ -0,0 +1,629 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/flags.h"
+#include "vm/hash_map.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_vectorization,
+            false,
+            "Vectorize simple counted loops over typed data.");
+
+// Element type shared by all typed data accesses of a vectorized loop.
+enum LaneKind {
+  kNoLanes,
+  kFloat32Lanes,
+  kFloat64Lanes,
+  kInt32Lanes,
+};
+
+// Classification of the scalar definitions in the loop body.
+enum ValueKind {
+  kUnknownValue,
+  // The loop index, possibly converted or bounds checked.
+  kIndexValue,
+  // A lane of the vector: one element of every typed data access.
+  kLaneValue,
+  // A Float32 lane computed in double precision, which must be rounded back
+  // to single precision before any further use.
+  kWideLaneValue,
+};
+
+static LaneKind LaneKindOf(intptr_t array_cid) {
+  switch (array_cid) {
+    case kTypedDataFloat32ArrayCid:
+      return kFloat32Lanes;
+    case kTypedDataFloat64ArrayCid:
+      return kFloat64Lanes;
+    case kTypedDataInt32ArrayCid:
+    case kTypedDataUint32ArrayCid:
+      return kInt32Lanes;
+    default:
+      return kNoLanes;
+  }
+}
+
+static intptr_t VectorArrayCid(LaneKind lanes) {
+  switch (lanes) {
+    case kFloat32Lanes:
+      return kTypedDataFloat32x4ArrayCid;
+    case kFloat64Lanes:
+      return kTypedDataFloat64x2ArrayCid;
+    case kInt32Lanes:
+      return kTypedDataInt32x4ArrayCid;
+    default:
+      UNREACHABLE();
+      return kIllegalCid;
+  }
+}
+
+static intptr_t VectorValueCid(LaneKind lanes) {
+  switch (lanes) {
+    case kFloat32Lanes:
+      return kFloat32x4Cid;
+    case kFloat64Lanes:
+      return kFloat64x2Cid;
+    case kInt32Lanes:
+      return kInt32x4Cid;
+    default:
+      UNREACHABLE();
+      return kIllegalCid;
+  }
+}
+
+static void SetPhiInput(PhiInstr* phi, intptr_t i, Definition* def) {
+  Value* input = new Value(def);
+  phi->SetInputAt(i, input);
+  def->AddInputUse(input);
+}
+
+// A loop of the form
+//
+//   preheader:
+//     goto header
+//   header:
+//     i = phi(0, i + 1)
+//     [CheckStackOverflow]
+//     if (i < n) goto body else goto exit
+//   body:
+//     ... element-wise typed data accesses at index i ...
+//     goto header
+//
+// which is rewritten to run a vector loop over [0, n & ~(lanes - 1)) before
+// entering the original loop at the first unprocessed index.
+class VectorizableLoop : public ZoneAllocated {
+ public:
+  VectorizableLoop(FlowGraph* flow_graph, LoopInfo* loop)
+      : flow_graph_(flow_graph), loop_(loop), kinds_(), vectors_() {}
+
+  // Returns true if the loop matches the shape above and every instruction
+  // of the body can be mapped onto a vector instruction.
+  bool Analyze();
+
+  // Builds the vector loop and the guards in front of the scalar loop. The
+  // phis of the new blocks are wired up by ConnectPhis once the predecessors
+  // have been recomputed.
+  void Rewrite();
+  void ConnectPhis();
+
+ private:
+  typedef RawPointerKeyValueTrait<Definition, intptr_t> KindKV;
+  typedef RawPointerKeyValueTrait<Definition, Definition*> VectorKV;
+
+  ValueKind KindOf(Value* value) const {
+    Definition* def = value->definition();
+    if (def == phi_) return kIndexValue;
+    return static_cast<ValueKind>(kinds_.LookupValue(def));
+  }
+
+  bool SetKind(Definition* def, ValueKind kind) {
+    if (kind == kUnknownValue) return false;
+    kinds_.Insert({def, kind});
+    return true;
+  }
+
+  bool IsLaneOperand(Value* value);
+  bool IsVectorizableAccess(Value* array, Value* index, intptr_t class_id);
+  bool Classify(Instruction* instr);
+
+  Definition* VectorOf(Value* value);
+  Definition* Emit(Definition* def);
+
+  TargetEntryInstr* NewTarget() {
+    return new TargetEntryInstr(flow_graph_->allocate_block_id(),
+                                header_->try_index(), DeoptId::kNone);
+  }
+
+  JoinEntryInstr* NewJoin() {
+    return new JoinEntryInstr(flow_graph_->allocate_block_id(),
+                              header_->try_index(), DeoptId::kNone);
+  }
+
+  PhiInstr* NewPhi(JoinEntryInstr* join, intptr_t num_inputs) {
+    PhiInstr* phi = new PhiInstr(join, num_inputs);
+    phi->set_representation(phi_->representation());
+    flow_graph_->AllocateSSAIndexes(phi);
+    phi->mark_alive();
+    join->InsertPhi(phi);
+    return phi;
+  }
+
+  Definition* Constant(intptr_t value) {
+    return flow_graph_->GetConstant(
+        Smi::ZoneHandle(flow_graph_->zone(), Smi::New(value)));
+  }
+
+  intptr_t vector_length() const { return lanes_ == kFloat64Lanes ? 2 : 4; }
+
+  FlowGraph* flow_graph_;
+  LoopInfo* loop_;
+
+  // The scalar loop.
+  JoinEntryInstr* header_ = nullptr;
+  BlockEntryInstr* preheader_ = nullptr;
+  TargetEntryInstr* body_ = nullptr;
+  PhiInstr* phi_ = nullptr;
+  Definition* increment_ = nullptr;
+  CheckStackOverflowInstr* check_ = nullptr;
+  RelationalOpInstr* compare_ = nullptr;
+  LaneKind lanes_ = kNoLanes;
+  bool has_store_ = false;
+  GrowableArray<Definition*> lengths_;
+  DirectChainedHashMap<KindKV> kinds_;
+
+  // The vector loop.
+  DirectChainedHashMap<VectorKV> vectors_;
+  Instruction* cursor_ = nullptr;
+  Instruction* preheader_cursor_ = nullptr;
+  JoinEntryInstr* vector_header_ = nullptr;
+  TargetEntryInstr* vector_body_ = nullptr;
+  TargetEntryInstr* vector_exit_ = nullptr;
+  JoinEntryInstr* scalar_entry_ = nullptr;
+  PhiInstr* vector_index_ = nullptr;
+  PhiInstr* start_index_ = nullptr;
+  Definition* vector_next_ = nullptr;
+  GrowableArray<TargetEntryInstr*> failed_guards_;
+};
+
+bool VectorizableLoop::Analyze() {
+  header_ = loop_->header()->AsJoinEntry();
+  if (header_ == nullptr || header_->InsideTryBlock() ||
+      header_->PredecessorCount() != 2 || loop_->back_edges().length() != 1) {
+    return false;
+  }
+  body_ = loop_->back_edges()[0]->AsTargetEntry();
+  if (body_ == nullptr || body_->PredecessorAt(0) != header_ ||
+      !body_->last_instruction()->IsGoto()) {
+    return false;
+  }
+  const intptr_t body_index = header_->IndexOfPredecessor(body_);
+  preheader_ = header_->PredecessorAt(1 - body_index);
+  if (!preheader_->last_instruction()->IsGoto()) {
+    return false;
+  }
+
+  // The header holds the index phi, the interrupt check and the loop test.
+  if (header_->phis() == nullptr || header_->phis()->length() != 1) {
+    return false;
+  }
+  phi_ = (*header_->phis())[0];
+  BranchInstr* branch = header_->last_instruction()->AsBranch();
+  if (branch == nullptr || branch->true_successor() != body_) {
+    return false;
+  }
+  for (ForwardInstructionIterator it(header_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current == branch) continue;
+    if (current->IsCheckStackOverflow() && check_ == nullptr) {
+      check_ = current->AsCheckStackOverflow();
+      continue;
+    }
+    return false;
+  }
+  compare_ = branch->comparison()->AsRelationalOp();
+  if (compare_ == nullptr || compare_->kind() != Token::kLT ||
+      compare_->left()->definition() != phi_ ||
+      loop_->Contains(compare_->right()->definition()->GetBlock())) {
+    return false;
+  }
+  const bool is_smi = (compare_->operation_cid() == kSmiCid) &&
+                      (phi_->representation() == kTagged);
+  const bool is_mint = (compare_->operation_cid() == kMintCid) &&
+                       (phi_->representation() == kUnboxedInt64);
+  if (!is_smi && !is_mint) {
+    return false;
+  }
+
+  // The index must count up from zero in unit steps.
+  InductionVar* induc = loop_->LookupInduction(phi_);
+  int64_t stride = 0;
+  int64_t initial = -1;
+  if (!InductionVar::IsLinear(induc, &stride) || stride != 1 ||
+      !InductionVar::IsConstant(induc->initial(), &initial) || initial != 0) {
+    return false;
+  }
+  increment_ = phi_->InputAt(body_index)->definition();
+  if (!increment_->IsBinaryIntegerOp() || increment_->GetBlock() != body_) {
+    return false;
+  }
+
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current == increment_ || current->IsGoto()) continue;
+    if (!Classify(current)) {
+      return false;
+    }
+  }
+  return has_store_;
+}
+
+bool VectorizableLoop::IsLaneOperand(Value* value) {
+  if (KindOf(value) == kLaneValue) {
+    return true;
+  }
+  if (!value->BindsToConstant() || !value->BoundConstant().IsDouble()) {
+    return false;
+  }
+  // Splatting a Float32x4 rounds the constant to single precision, so it
+  // must be exactly representable there.
+  const double constant = Double::Cast(value->BoundConstant()).value();
+  return (lanes_ == kFloat64Lanes) ||
+         (static_cast<double>(static_cast<float>(constant)) == constant);
+}
+
+bool VectorizableLoop::IsVectorizableAccess(Value* array,
+                                            Value* index,
+                                            intptr_t class_id) {
+  const LaneKind lanes = LaneKindOf(class_id);
+  if (lanes == kNoLanes || (lanes_ != kNoLanes && lanes_ != lanes)) {
+    return false;
+  }
+  // Distinct internal typed data never overlap, so element-wise accesses at
+  // the same index cannot carry a dependence between iterations. External
+  // data may alias at an offset.
+  Definition* array_def = array->definition();
+  if (array_def->representation() == kUntagged ||
+      loop_->Contains(array_def->GetBlock()) ||
+      KindOf(index) != kIndexValue) {
+    return false;
+  }
+  lanes_ = lanes;
+  return true;
+}
+
+bool VectorizableLoop::Classify(Instruction* instr) {
+  if (CheckBoundBase* check = instr->AsCheckBoundBase()) {
+    Definition* length = check->length()->definition();
+    if (KindOf(check->index()) != kIndexValue ||
+        loop_->Contains(length->GetBlock())) {
+      return false;
+    }
+    bool found = false;
+    for (intptr_t i = 0; i < lengths_.length(); ++i) {
+      found = found || (lengths_[i] == length);
+    }
+    if (!found) lengths_.Add(length);
+    return SetKind(check, kIndexValue);
+  }
+
+  if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+    return IsVectorizableAccess(load->array(), load->index(),
+                                load->class_id()) &&
+           SetKind(load, kLaneValue);
+  }
+
+  if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+    if (!IsVectorizableAccess(store->array(), store->index(),
+                              store->class_id()) ||
+        KindOf(store->value()) != kLaneValue) {
+      return false;
+    }
+    has_store_ = true;
+    return true;
+  }
+
+  if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+      case Token::kMUL:
+      case Token::kDIV:
+        break;
+      default:
+        return false;
+    }
+    if ((lanes_ != kFloat32Lanes && lanes_ != kFloat64Lanes) ||
+        !IsLaneOperand(op->left()) || !IsLaneOperand(op->right())) {
+      return false;
+    }
+    // A single float operation computed in double precision and rounded
+    // once gives the correctly rounded float result; a chain of them does
+    // not.
+    return SetKind(op, lanes_ == kFloat32Lanes ? kWideLaneValue : kLaneValue);
+  }
+
+  if (BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp()) {
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+      case Token::kBIT_AND:
+      case Token::kBIT_OR:
+      case Token::kBIT_XOR:
+        break;
+      default:
+        return false;
+    }
+    // The low 32 bits of these operations only depend on the low 32 bits of
+    // their inputs, and only those bits are stored.
+    return (lanes_ == kInt32Lanes) && !op->CanDeoptimize() &&
+           (KindOf(op->left()) == kLaneValue) &&
+           (KindOf(op->right()) == kLaneValue) && SetKind(op, kLaneValue);
+  }
+
+  if (FloatToDoubleInstr* conv = instr->AsFloatToDouble()) {
+    return (lanes_ == kFloat32Lanes) &&
+           (KindOf(conv->value()) == kLaneValue) && SetKind(conv, kLaneValue);
+  }
+
+  if (DoubleToFloatInstr* conv = instr->AsDoubleToFloat()) {
+    const ValueKind kind = KindOf(conv->value());
+    return (lanes_ == kFloat32Lanes) &&
+           (kind == kLaneValue || kind == kWideLaneValue) &&
+           SetKind(conv, kLaneValue);
+  }
+
+  // Representation changes are dropped in the vector loop; the final
+  // SelectRepresentations inserts whatever the vector instructions need.
+  if (instr->IsBox() || instr->IsUnbox() || instr->IsIntConverter()) {
+    return !instr->CanDeoptimize() &&
+           SetKind(instr->AsDefinition(), KindOf(instr->InputAt(0)));
+  }
+
+  return false;
+}
+
+Definition* VectorizableLoop::VectorOf(Value* value) {
+  Definition* def = value->definition();
+  if (KindOf(value) == kIndexValue) {
+    return vector_index_;
+  }
+  Definition* vector = vectors_.LookupValue(def);
+  if (vector != nullptr) {
+    return vector;
+  }
+  // Constants are splatted once in the preheader.
+  ASSERT(value->BindsToConstant());
+  const MethodRecognizer::Kind splat = (lanes_ == kFloat32Lanes)
+                                           ? MethodRecognizer::kFloat32x4Splat
+                                           : MethodRecognizer::kFloat64x2Splat;
+  vector = SimdOpInstr::Create(splat, new Value(def), DeoptId::kNone);
+  flow_graph_->InsertBefore(preheader_cursor_, vector, nullptr,
+                            FlowGraph::kValue);
+  vectors_.Insert({def, vector});
+  return vector;
+}
+
+Definition* VectorizableLoop::Emit(Definition* def) {
+  cursor_ = flow_graph_->AppendTo(cursor_, def, nullptr, FlowGraph::kValue);
+  return def;
+}
+
+void VectorizableLoop::Rewrite() {
+  const TokenPosition pos = compare_->token_pos();
+  const intptr_t cid = compare_->operation_cid();
+  const Representation rep = phi_->representation();
+  GotoInstr* preheader_goto = preheader_->last_instruction()->AsGoto();
+  preheader_cursor_ = preheader_goto;
+
+  Definition* limit = compare_->right()->definition();
+  Definition* vector_end = BinaryIntegerOpInstr::Make(
+      rep, Token::kBIT_AND, new Value(limit),
+      new Value(Constant(-vector_length())), DeoptId::kNone,
+      /*can_overflow=*/false, /*is_truncating=*/false, nullptr,
+      Instruction::kNotSpeculative);
+  flow_graph_->InsertBefore(preheader_goto, vector_end, nullptr,
+                            FlowGraph::kValue);
+
+  vector_header_ = NewJoin();
+  vector_body_ = NewTarget();
+  vector_exit_ = NewTarget();
+  scalar_entry_ = NewJoin();
+
+  // Vector loop header.
+  vector_index_ = NewPhi(vector_header_, 2);
+  cursor_ = vector_header_;
+  if (check_ != nullptr) {
+    // An interrupt here resumes the unoptimized loop at the vector index.
+    Instruction* check = new CheckStackOverflowInstr(
+        check_->token_pos(), check_->stack_depth(), check_->loop_depth(),
+        check_->deopt_id(), CheckStackOverflowInstr::kOsrAndPreemption);
+    cursor_ = flow_graph_->AppendTo(cursor_, check, check_->env(),
+                                    FlowGraph::kEffect);
+    if (check->env() != nullptr) {
+      for (Environment::DeepIterator it(check->env()); !it.Done();
+           it.Advance()) {
+        if (it.CurrentValue()->definition() == phi_) {
+          it.CurrentValue()->BindToEnvironment(vector_index_);
+        }
+      }
+    }
+  }
+  BranchInstr* branch = new BranchInstr(
+      new RelationalOpInstr(pos, Token::kLT, new Value(vector_index_),
+                            new Value(vector_end), cid, DeoptId::kNone,
+                            Instruction::kNotSpeculative),
+      DeoptId::kNone);
+  cursor_->AppendInstruction(branch);
+  vector_header_->set_last_instruction(branch);
+  *branch->true_successor_address() = vector_body_;
+  *branch->false_successor_address() = vector_exit_;
+
+  // Vector loop body, in the order of the scalar body.
+  const intptr_t array_cid = VectorArrayCid(lanes_);
+  const intptr_t value_cid = VectorValueCid(lanes_);
+  cursor_ = vector_body_;
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current == increment_ || current->IsGoto()) continue;
+    if (LoadIndexedInstr* load = current->AsLoadIndexed()) {
+      vectors_.Insert(
+          {load, Emit(new LoadIndexedInstr(
+                     new Value(load->array()->definition()),
+                     new Value(vector_index_),
+                     load->RequiredInputRepresentation(1) != kTagged,
+                     load->index_scale(), array_cid, kAlignedAccess,
+                     DeoptId::kNone, load->token_pos()))});
+    } else if (StoreIndexedInstr* store = current->AsStoreIndexed()) {
+      Instruction* vector_store = new StoreIndexedInstr(
+          new Value(store->array()->definition()), new Value(vector_index_),
+          new Value(VectorOf(store->value())), kNoStoreBarrier,
+          store->RequiredInputRepresentation(1) != kTagged,
+          store->index_scale(), array_cid, kAlignedAccess, DeoptId::kNone,
+          store->token_pos(), Instruction::kNotSpeculative);
+      cursor_ = flow_graph_->AppendTo(cursor_, vector_store, nullptr,
+                                      FlowGraph::kEffect);
+    } else if (BinaryDoubleOpInstr* op = current->AsBinaryDoubleOp()) {
+      vectors_.Insert(
+          {op, Emit(SimdOpInstr::Create(
+                   SimdOpInstr::KindForOperator(value_cid, op->op_kind()),
+                   new Value(VectorOf(op->left())),
+                   new Value(VectorOf(op->right())), DeoptId::kNone))});
+    } else if (BinaryIntegerOpInstr* op = current->AsBinaryIntegerOp()) {
+      vectors_.Insert(
+          {op, Emit(SimdOpInstr::Create(
+                   SimdOpInstr::KindForOperator(value_cid, op->op_kind()),
+                   new Value(VectorOf(op->left())),
+                   new Value(VectorOf(op->right())), DeoptId::kNone))});
+    } else if (KindOf(current->InputAt(0)) != kIndexValue &&
+               !current->IsCheckBoundBase()) {
+      // Conversions map onto the vector of their input.
+      vectors_.Insert(
+          {current->AsDefinition(), VectorOf(current->InputAt(0))});
+    }
+  }
+  vector_next_ = Emit(BinaryIntegerOpInstr::Make(
+      rep, Token::kADD, new Value(vector_index_),
+      new Value(Constant(vector_length())), DeoptId::kNone,
+      /*can_overflow=*/false, /*is_truncating=*/false, nullptr,
+      Instruction::kNotSpeculative));
+  GotoInstr* back_edge = new GotoInstr(vector_header_, DeoptId::kNone);
+  cursor_->AppendInstruction(back_edge);
+  vector_body_->set_last_instruction(back_edge);
+
+  GotoInstr* exit_goto = new GotoInstr(scalar_entry_, DeoptId::kNone);
+  vector_exit_->AppendInstruction(exit_goto);
+  vector_exit_->set_last_instruction(exit_goto);
+
+  // Guards in the preheader replace the bounds checks of the vector loop. If
+  // any of them fails the scalar loop runs from zero.
+  if (lengths_.is_empty()) {
+    preheader_goto->set_successor(vector_header_);
+  } else {
+    BlockEntryInstr* block = preheader_;
+    Instruction* cursor = preheader_goto->previous();
+    for (intptr_t i = 0; i < lengths_.length(); ++i) {
+      BranchInstr* guard = new BranchInstr(
+          new RelationalOpInstr(pos, Token::kLTE, new Value(vector_end),
+                                new Value(lengths_[i]), cid, DeoptId::kNone,
+                                Instruction::kNotSpeculative),
+          DeoptId::kNone);
+      cursor->AppendInstruction(guard);
+      block->set_last_instruction(guard);
+      TargetEntryInstr* passed = NewTarget();
+      TargetEntryInstr* failed = NewTarget();
+      *guard->true_successor_address() = passed;
+      *guard->false_successor_address() = failed;
+      GotoInstr* failed_goto = new GotoInstr(scalar_entry_, DeoptId::kNone);
+      failed->AppendInstruction(failed_goto);
+      failed->set_last_instruction(failed_goto);
+      failed_guards_.Add(failed);
+      block = passed;
+      cursor = passed;
+    }
+    GotoInstr* enter_goto = new GotoInstr(vector_header_, DeoptId::kNone);
+    cursor->AppendInstruction(enter_goto);
+    block->set_last_instruction(enter_goto);
+  }
+
+  // The scalar loop continues from where the vector loop stopped.
+  start_index_ = NewPhi(scalar_entry_, failed_guards_.length() + 1);
+  GotoInstr* scalar_goto = new GotoInstr(header_, DeoptId::kNone);
+  scalar_entry_->AppendInstruction(scalar_goto);
+  scalar_entry_->set_last_instruction(scalar_goto);
+}
+
+void VectorizableLoop::ConnectPhis() {
+  Definition* zero = Constant(0);
+  for (intptr_t i = 0; i < 2; ++i) {
+    SetPhiInput(vector_index_, i,
+                vector_header_->PredecessorAt(i) == vector_body_
+                    ? vector_next_
+                    : zero);
+  }
+  for (intptr_t i = 0; i < scalar_entry_->PredecessorCount(); ++i) {
+    SetPhiInput(start_index_, i,
+                scalar_entry_->PredecessorAt(i) == vector_exit_
+                    ? static_cast<Definition*>(vector_index_)
+                    : zero);
+  }
+  // The header's predecessors are now the body and the scalar entry, in
+  // block id order.
+  ASSERT(header_->PredecessorCount() == 2);
+  for (intptr_t i = 0; i < 2; ++i) {
+    phi_->InputAt(i)->RemoveFromUseList();
+  }
+  for (intptr_t i = 0; i < 2; ++i) {
+    SetPhiInput(phi_, i,
+                header_->PredecessorAt(i) == body_
+                    ? increment_
+                    : static_cast<Definition*>(start_index_));
+  }
+}
+
+void LoopVectorizer::Vectorize(FlowGraph* flow_graph) {
+  if (!FLAG_loop_vectorization || flow_graph->IsCompiledForOsr() ||
+      !FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    return;
+  }
+
+  const LoopHierarchy& loop_hierarchy = flow_graph->GetLoopHierarchy();
+  loop_hierarchy.ComputeInduction();
+  const ZoneGrowableArray<BlockEntryInstr*>& headers =
+      loop_hierarchy.headers();
+
+  // Analyze all innermost loops before changing the graph, since the loop
+  // information is invalidated by the rewrite.
+  GrowableArray<VectorizableLoop*> candidates;
+  for (intptr_t i = 0; i < headers.length(); ++i) {
+    LoopInfo* loop = headers[i]->loop_info();
+    if (loop->inner() != nullptr) continue;
+    VectorizableLoop* candidate = new VectorizableLoop(flow_graph, loop);
+    if (candidate->Analyze()) {
+      candidates.Add(candidate);
+    }
+  }
+  if (candidates.is_empty()) {
+    return;
+  }
+
+  for (intptr_t i = 0; i < candidates.length(); ++i) {
+    candidates[i]->Rewrite();
+  }
+  flow_graph->DiscoverBlocks();
+  for (intptr_t i = 0; i < candidates.length(); ++i) {
+    candidates[i]->ConnectPhis();
+  }
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph->ComputeDominators(&dominance_frontier);
+}
+
+}  // namespace dart
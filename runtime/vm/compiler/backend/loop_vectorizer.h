@@ -0,0 +1,43 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+
+// Rewrites simple counted loops over typed data into a loop that processes
+// four (or two, for Float64List) elements per iteration with SimdOpInstr,
+// followed by the original scalar loop as an epilogue:
+//
+//   for (i = 0; i < n; i++) c[i] = a[i] op b[i];
+//
+// becomes
+//
+//   vend = n & ~3;
+//   i = 0;
+//   if (vend <= bounds of every checked access) {
+//     for (; i < vend; i += 4) c[i..i+3] = a[i..i+3] op b[i..i+3];
+//   }
+//   for (; i < n; i++) c[i] = a[i] op b[i];
+//
+// Every bounds check left in the body by range analysis is replaced by a
+// single guard in the preheader; when a guard fails the scalar loop runs
+// in full and deoptimizes exactly as before.
+class LoopVectorizer : public AllStatic {
+ public:
+  static void Vectorize(FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
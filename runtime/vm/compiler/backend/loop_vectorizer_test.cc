@@ -0,0 +1,122 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Unit tests for vectorization of counted loops over typed data.
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+DECLARE_FLAG(bool, loop_vectorization);
+
+// Helper method to count vector stores into typed data.
+static intptr_t CountVectorStores(FlowGraph* flow_graph) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      StoreIndexedInstr* store = it.Current()->AsStoreIndexed();
+      if (store != nullptr &&
+          (store->class_id() == kTypedDataFloat32x4ArrayCid ||
+           store->class_id() == kTypedDataInt32x4ArrayCid ||
+           store->class_id() == kTypedDataFloat64x2ArrayCid)) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+// Helper method to optimize the given function after running main.
+static intptr_t VectorizeAndCount(const char* script_chars,
+                                  const char* function_name) {
+  SetFlagScope<bool> sfs(&FLAG_loop_vectorization, true);
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  const auto& function =
+      Function::Handle(GetFunction(root_library, function_name));
+  Invoke(root_library, "main");
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  return CountVectorStores(flow_graph);
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_Float32Add) {
+  if (!FlowGraphCompiler::SupportsUnboxedSimd128()) return;
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      add(Float32List a, Float32List b, Float32List c) {
+        for (int i = 0; i < c.length; i++) {
+          c[i] = a[i] + b[i];
+        }
+      }
+
+      main() {
+        final a = Float32List(17), b = Float32List(17), c = Float32List(17);
+        for (int i = 0; i < 17; i++) {
+          a[i] = i.toDouble();
+          b[i] = 0.5;
+        }
+        add(a, b, c);
+        if (c[16] != 16.5) throw "bad result";
+      }
+      )";
+  EXPECT_EQ(1, VectorizeAndCount(kScript, "add"));
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_Int32Xor) {
+  if (!FlowGraphCompiler::SupportsUnboxedSimd128()) return;
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      mix(Int32List a, Int32List b) {
+        for (int i = 0; i < a.length; i++) {
+          a[i] = a[i] ^ b[i];
+        }
+      }
+
+      main() {
+        final a = Int32List(9), b = Int32List(9);
+        for (int i = 0; i < 9; i++) {
+          a[i] = i;
+          b[i] = 1;
+        }
+        mix(a, b);
+        if (a[8] != 9) throw "bad result";
+      }
+      )";
+  EXPECT_EQ(1, VectorizeAndCount(kScript, "mix"));
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_RejectsShiftedIndex) {
+  if (!FlowGraphCompiler::SupportsUnboxedSimd128()) return;
+  // Iterations depend on each other through a[i + 1].
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      shift(Float32List a) {
+        for (int i = 0; i < a.length - 1; i++) {
+          a[i] = a[i + 1];
+        }
+      }
+
+      main() {
+        shift(Float32List(10));
+      }
+      )";
+  EXPECT_EQ(0, VectorizeAndCount(kScript, "shift"));
+}
+
+}  // namespace dart
@@ -448,8 +448,13 @@ void InductionVarAnalysis::ClassifyControl(LoopInfo* loop) {
     // bound due to aritmetic wrap-around.
     switch (cmp) {
       case Token::kLT:
-        // Accept i < U (i++).
+        // Accept i < U (i++), and i < U (i += C) with C > 1 when U is
+        // bounded by an array length, since then i + C cannot wrap around.
         if (stride == 1) break;
+        if (stride > 1 && InductionVar::IsInvariant(y) && y->mult() == 1 &&
+            Definition::IsArrayLength(y->def()) && y->offset() <= 0) {
+          break;
+        }
         continue;
       case Token::kGT:
         // Accept i > L (i--).
@@ -491,8 +496,10 @@ void InductionVarAnalysis::ClassifyControl(LoopInfo* loop) {
       default:
         continue;
     }
-    // We found a strict upper or lower bound on a unit stride linear
-    // induction. Note that depending on the intended use of this
+    // We found a strict upper or lower bound on a linear induction (which
+    // has unit stride unless bounded by an array length, so clients that
+    // rely on unit strides must check). Note that depending on the intended
+    // use of this
     // information, clients should still test dominance on the test
     // and the initial value of the induction variable.
     x->bounds_.Add(InductionVar::Bound(branch, y));
@@ -1083,6 +1090,11 @@ InductionVar* LoopInfo::LookupInduction(Definition* def) const {
 //   for (int i = initial; i <= length - C; i++) {
 //     .... a[i] ....  // initial >= 0 and C > 0:
 //   }
+// or, for an upward stride S and an offset D >= 0 that is compensated in
+// the loop condition:
+//   for (int i = initial; i < length - D; i += S) {
+//     .... a[i + D] ....  // initial + D >= 0
+//   }
 bool LoopInfo::IsInRange(Instruction* pos, Value* index, Value* length) {
   InductionVar* induc = LookupInduction(
       index->definition()->OriginalDefinitionIgnoreBoxingAndConstraints());
@@ -1094,7 +1106,7 @@ bool LoopInfo::IsInRange(Instruction* pos, Value* index, Value* length) {
     int64_t stride = 0;
     int64_t val = 0;
     int64_t diff = 0;
-    if (InductionVar::IsLinear(induc, &stride) && stride == 1 &&
+    if (InductionVar::IsLinear(induc, &stride) && stride > 0 &&
         InductionVar::IsConstant(induc->initial(), &val) && 0 <= val) {
       for (auto bound : induc->bounds()) {
         if (pos->IsDominatedBy(bound.branch_) &&
@@ -1102,6 +1114,20 @@ bool LoopInfo::IsInRange(Instruction* pos, Value* index, Value* length) {
           return true;
         }
       }
+      // An induction at a fixed offset from the loop control is bounded
+      // by the control's bounds shifted by that offset. There is no
+      // arithmetic wrap-around since the control is below a length.
+      int64_t offset = 0;
+      if (control_ != nullptr && control_ != induc &&
+          control_->CanComputeDifferenceWith(induc, &offset)) {
+        for (auto bound : control_->bounds()) {
+          if (pos->IsDominatedBy(bound.branch_) &&
+              len->CanComputeDifferenceWith(bound.limit_, &diff) &&
+              diff + offset <= 0) {
+            return true;
+          }
+        }
+      }
     }
     // If that fails, try to compute bounds using more outer loops.
     // Since array lengths >= 0, the conditions used during this
@@ -21,6 +21,11 @@ DEFINE_FLAG(bool,
             optimize_lazy_initializer_calls,
             true,
             "Eliminate redundant lazy initializer calls.");
+DEFINE_FLAG(int,
+            max_unchecked_loop_trip_count,
+            1000,
+            "Maximum constant trip count of a leaf loop whose header does not "
+            "check for stack overflow and interrupts.");
 DEFINE_FLAG(bool,
             trace_load_optimization,
             false,
@@ -3202,6 +3207,81 @@ void AllocationSinking::EliminateAllocation(Definition* alloc) {
   alloc->RemoveFromGraph();
 }
 
+// Folds the given use of an allocation if it only observes the identity of
+// the allocated object. Returns true if the use was removed.
+static bool FoldIdentityUse(FlowGraph* flow_graph,
+                            Definition* alloc,
+                            Value* use) {
+  Instruction* instr = use->instruction();
+  if (instr->IsRedefinition() || instr->IsCheckNull()) {
+    // A fresh allocation is never null and already has its exact type.
+    Definition* def = instr->AsDefinition();
+    def->ReplaceUsesWith(alloc);
+    def->RemoveFromGraph();
+    return true;
+  }
+  if (auto load_cid = instr->AsLoadClassId()) {
+    const intptr_t cid = alloc->Type()->ToCid();
+    if (load_cid->representation() != kTagged || cid == kDynamicCid) {
+      return false;
+    }
+    load_cid->ReplaceUsesWith(flow_graph->GetConstant(
+        Smi::ZoneHandle(flow_graph->zone(), Smi::New(cid))));
+    load_cid->RemoveFromGraph();
+    return true;
+  }
+  if (auto compare = instr->AsStrictCompare()) {
+    Value* other =
+        (use == compare->left()) ? compare->right() : compare->left();
+    Definition* other_def = other->definition()->OriginalDefinition();
+    bool identical;
+    if (other_def == alloc) {
+      identical = true;
+    } else if (other_def->IsConstant() || IsSupportedAllocation(other_def)) {
+      // Distinct allocations and constants are never the same object.
+      identical = false;
+    } else {
+      return false;
+    }
+    const bool result = (compare->kind() == Token::kEQ_STRICT) == identical;
+    compare->ReplaceUsesWith(flow_graph->GetConstant(Bool::Get(result)));
+    compare->RemoveFromGraph();
+    return true;
+  }
+  return false;
+}
+
+// After inlining an allocation is often still used by instructions that only
+// look at the identity of the object: redefinitions and null checks left at
+// inlined call sites, class id loads from inlined type tests and identical()
+// checks. None of them lets the object escape, so fold them before
+// looking for candidates.
+void AllocationSinking::FoldIdentityUses() {
+  GrowableArray<Definition*> allocations;
+  for (BlockIterator block_it = flow_graph_->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (IsSupportedAllocation(it.Current())) {
+        allocations.Add(it.Current()->Cast<Definition>());
+      }
+    }
+  }
+
+  for (intptr_t i = 0; i < allocations.length(); i++) {
+    Definition* alloc = allocations[i];
+    Value* use = alloc->input_use_list();
+    while (use != nullptr) {
+      Value* next = use->next_use();
+      if (FoldIdentityUse(flow_graph_, alloc, use)) {
+        // Folding may have moved other uses onto the allocation.
+        next = alloc->input_use_list();
+      }
+      use = next;
+    }
+  }
+}
+
 // Find allocation instructions that can be potentially eliminated and
 // rematerialized at deoptimization exits if needed. See IsSafeUse
 // for the description of algorithm used below.
@@ -3396,6 +3476,8 @@ void AllocationSinking::DiscoverFailedCandidates() {
 }
 
 void AllocationSinking::Optimize() {
+  FoldIdentityUses();
+
   CollectCandidates();
 
   // Insert MaterializeObject instructions that will describe the state of the
@@ -4228,7 +4310,87 @@ void DeadCodeElimination::EliminateDeadCode(FlowGraph* flow_graph) {
   }
 }
 
+// Returns the number of iterations of a loop controlled by a unit stride
+// induction between two constants, or -1 if it is not known.
+static int64_t ConstantTripCount(LoopInfo* loop) {
+  InductionVar* control = loop->control();
+  if (control == nullptr) {
+    return -1;
+  }
+  InductionVar* limit = nullptr;
+  for (auto bound : control->bounds()) {
+    if (bound.branch_ == loop->header()->last_instruction()) {
+      limit = bound.limit_;
+      break;
+    }
+  }
+  int64_t stride = 0;
+  int64_t begin = 0;
+  int64_t end = 0;
+  if (limit == nullptr || !InductionVar::IsLinear(control, &stride) ||
+      !InductionVar::IsConstant(control->initial(), &begin) ||
+      !InductionVar::IsConstant(limit, &end)) {
+    return -1;
+  }
+  if (stride == 1) {
+    return (begin < end) ? Utils::SubWithWrapAround(end, begin) : 0;
+  }
+  if (stride == -1) {
+    return (begin > end) ? Utils::SubWithWrapAround(begin, end) : 0;
+  }
+  return -1;
+}
+
+// Removes the check in the header of innermost loops that run a small,
+// constant number of iterations and make no calls. Such a loop finishes in
+// bounded time, so the checks of the enclosing loop or function still keep
+// interrupts responsive.
+static void EliminateLeafLoopChecks(FlowGraph* graph) {
+  const LoopHierarchy& loop_hierarchy = graph->GetLoopHierarchy();
+  if (loop_hierarchy.num_loops() == 0) {
+    return;
+  }
+  loop_hierarchy.ComputeInduction();
+  for (BlockEntryInstr* header : loop_hierarchy.headers()) {
+    LoopInfo* loop = header->loop_info();
+    if (loop->inner() != nullptr) {
+      continue;
+    }
+    const int64_t trip_count = ConstantTripCount(loop);
+    if (trip_count < 0 || trip_count > FLAG_max_unchecked_loop_trip_count) {
+      continue;
+    }
+    CheckStackOverflowInstr* check = nullptr;
+    bool is_leaf = true;
+    for (BitVector::Iterator block_it(loop->blocks());
+         is_leaf && !block_it.Done(); block_it.Advance()) {
+      BlockEntryInstr* block = graph->preorder()[block_it.Current()];
+      for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+        Instruction* current = it.Current();
+        if (CheckStackOverflowInstr* instr = current->AsCheckStackOverflow()) {
+          if (block == header) {
+            check = instr;
+          }
+          continue;
+        }
+        if (current->IsBranch()) {
+          current = current->AsBranch()->comparison();
+        }
+        if (current->HasUnknownSideEffects() || current->CanCallDart()) {
+          is_leaf = false;
+          break;
+        }
+      }
+    }
+    if (is_leaf && check != nullptr) {
+      check->RemoveFromGraph();
+    }
+  }
+}
+
 void CheckStackOverflowElimination::EliminateStackOverflow(FlowGraph* graph) {
+  EliminateLeafLoopChecks(graph);
+
   CheckStackOverflowInstr* first_stack_overflow_instr = NULL;
   for (BlockIterator block_it = graph->reverse_postorder_iterator();
        !block_it.Done(); block_it.Advance()) {
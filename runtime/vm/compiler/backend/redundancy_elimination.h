@@ -56,6 +56,8 @@ class AllocationSinking : public ZoneAllocated {
     GrowableArray<Definition*> worklist_;
   };
 
+  void FoldIdentityUses();
+
   void CollectCandidates();
 
   void NormalizeMaterializations();
@@ -158,6 +160,7 @@ class DelayAllocations : public AllStatic {
 class CheckStackOverflowElimination : public AllStatic {
  public:
   // For leaf functions with only a single [StackOverflowInstr] we remove it.
+  // The checks in the headers of small counted leaf loops are removed too.
   static void EliminateStackOverflow(FlowGraph* graph);
 };
 
@@ -1249,6 +1249,101 @@ main() {
   EXPECT(string_interpolate->value()->definition() == create_array);
 }
 
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_IdentityUses) {
+  const char* kScript = R"(
+class A {
+  dynamic x;
+  A(this.x);
+}
+
+@pragma('vm:never-inline')
+bool foo(int v) {
+  // Comparing the identity of two fresh objects does not make them escape.
+  final a = A(v);
+  final b = A(v);
+  return identical(a, b);
+}
+
+main() {
+  foo(42);
+}
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  ASSERT(flow_graph != nullptr);
+
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      EXPECT(!it.Current()->IsAllocateObject());
+    }
+  }
+}
+
+static intptr_t CountStackOverflowChecks(FlowGraph* flow_graph) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsCheckStackOverflow()) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+ISOLATE_UNIT_TEST_CASE(CheckStackOverflowElimination_SmallLeafLoop) {
+  const char* kScript = R"(
+    @pragma('vm:never-inline')
+    int small() {
+      int sum = 0;
+      for (int i = 0; i < 16; i++) {
+        sum += i;
+      }
+      return sum;
+    }
+
+    @pragma('vm:never-inline')
+    int large() {
+      int sum = 0;
+      for (int i = 0; i < 100000; i++) {
+        sum += i;
+      }
+      return sum;
+    }
+
+    main() {
+      small();
+      large();
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+
+  // The loop of a leaf function with a small constant trip count needs no
+  // check, and neither does the function entry then.
+  auto& function = Function::Handle(GetFunction(root_library, "small"));
+  TestPipeline small_pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = small_pipeline.RunPasses({});
+  ASSERT(flow_graph != nullptr);
+  EXPECT_EQ(0, CountStackOverflowChecks(flow_graph));
+
+  // A long-running loop keeps its check.
+  function = GetFunction(root_library, "large");
+  TestPipeline large_pipeline(function, CompilerPass::kJIT);
+  flow_graph = large_pipeline.RunPasses({});
+  ASSERT(flow_graph != nullptr);
+  EXPECT_EQ(1, CountStackOverflowChecks(flow_graph));
+}
+
 #if !defined(TARGET_ARCH_IA32)
 
 ISOLATE_UNIT_TEST_CASE(DelayAllocations_DelayAcrossCalls) {
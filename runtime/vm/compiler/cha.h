@@ -60,6 +60,9 @@ class CHA : public ValueObject {
 
   void RegisterDependencies(const Code& code) const;
 
+  // Whether any decision so far depended on the class hierarchy.
+  bool HasGuardedClasses() const { return !guarded_classes_.is_empty(); }
+
   // Used for testing.
   bool IsGuardedClass(intptr_t cid) const;
 
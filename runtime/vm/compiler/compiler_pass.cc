@@ -13,10 +13,14 @@
 #include "vm/compiler/backend/il_serializer.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/linearscan.h"
+#include "vm/compiler/backend/loop_unroller.h"
+#include "vm/compiler/backend/loop_vectorizer.h"
+#include "vm/compiler/backend/loops.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
 #include "vm/compiler/call_specializer.h"
+#include "vm/compiler/jit/flow_graph_cache.h"
 #include "vm/compiler/write_barrier_elimination.h"
 #if defined(DART_PRECOMPILER)
 #include "vm/compiler/aot/aot_call_specializer.h"
@@ -63,6 +67,11 @@ DEFINE_FLAG(bool,
             late_round_trip_serialization,
             false,
             "Perform late round trip serialization compiler pass.");
+DEFINE_FLAG(bool,
+            print_compiler_pass_stats,
+            false,
+            "Print the time and flow graph sizes of each compiler pass, summed "
+            "over all compilations, when an isolate group shuts down.");
 DECLARE_FLAG(bool, print_flow_graph);
 DECLARE_FLAG(bool, print_flow_graph_optimized);
 
@@ -192,7 +201,38 @@ void CompilerPass::Run(CompilerPassState* state) const {
     PrintGraph(state, kTraceBefore, round);
     {
       TIMELINE_DURATION(thread, CompilerVerbose, name());
+      bool record_stats = FLAG_print_compiler_pass_stats;
+#if defined(SUPPORT_TIMELINE)
+      record_stats = record_stats || tbes.enabled();
+#endif
+      intptr_t instructions_before = 0;
+      intptr_t zone_before = 0;
+      int64_t start = 0;
+      if (record_stats) {
+        instructions_before = state->flow_graph()->InstructionCount();
+        zone_before = thread->zone()->SizeInBytes();
+        start = OS::GetCurrentMonotonicMicros();
+      }
       repeat = DoBody(state);
+      if (record_stats) {
+        const int64_t micros = OS::GetCurrentMonotonicMicros() - start;
+        const intptr_t instructions_after =
+            state->flow_graph()->InstructionCount();
+        const intptr_t zone_bytes = Utils::Maximum<intptr_t>(
+            thread->zone()->SizeInBytes() - zone_before, 0);
+        thread->isolate_group()->compiler_pass_stats()->Add(
+            id(), micros, instructions_before, instructions_after, zone_bytes);
+#if defined(SUPPORT_TIMELINE)
+        if (tbes.enabled()) {
+          tbes.SetNumArguments(3);
+          tbes.FormatArgument(0, "instructionsBefore", "%" Pd "",
+                              instructions_before);
+          tbes.FormatArgument(1, "instructionsAfter", "%" Pd "",
+                              instructions_after);
+          tbes.FormatArgument(2, "zoneBytes", "%" Pd "", zone_bytes);
+        }
+#endif
+      }
       thread->CheckForSafepoint();
     }
     PrintGraph(state, kTraceAfter, round);
@@ -202,6 +242,66 @@ void CompilerPass::Run(CompilerPassState* state) const {
   }
 }
 
+void CompilerPassStats::Add(CompilerPass::Id id,
+                            int64_t micros,
+                            intptr_t instructions_before,
+                            intptr_t instructions_after,
+                            intptr_t zone_bytes) {
+  MutexLocker ml(&mutex_);
+  Entry* entry = &entries_[id];
+  entry->rounds++;
+  entry->total_micros += micros;
+  entry->max_micros = Utils::Maximum(entry->max_micros, micros);
+  entry->instructions_before += instructions_before;
+  entry->instructions_after += instructions_after;
+  entry->zone_bytes += zone_bytes;
+}
+
+int CompilerPassStats::CompareByTime(const void* a, const void* b) {
+  const Entry* entry_a = reinterpret_cast<const Entry*>(a);
+  const Entry* entry_b = reinterpret_cast<const Entry*>(b);
+  if (entry_a->total_micros != entry_b->total_micros) {
+    return (entry_a->total_micros > entry_b->total_micros) ? -1 : 1;
+  }
+  return (entry_a->id < entry_b->id) ? -1 : 1;
+}
+
+void CompilerPassStats::Print(const char* name) {
+  Entry entries[CompilerPass::kNumPasses];
+  int64_t total_micros = 0;
+  {
+    MutexLocker ml(&mutex_);
+    for (intptr_t i = 0; i < CompilerPass::kNumPasses; i++) {
+      entries[i] = entries_[i];
+      entries[i].id = i;
+      total_micros += entries_[i].total_micros;
+    }
+  }
+  if (total_micros == 0) {
+    return;
+  }
+  qsort(entries, CompilerPass::kNumPasses, sizeof(Entry), CompareByTime);
+
+  OS::PrintErr("Compiler pass statistics for %s (%.1f ms):\n", name,
+               MicrosecondsToMilliseconds(total_micros));
+  OS::PrintErr("%-40s %8s %10s %8s %12s %12s %10s\n", "pass", "rounds",
+               "total ms", "max ms", "instrs in", "instrs out", "zone kB");
+  for (intptr_t i = 0; i < CompilerPass::kNumPasses; i++) {
+    const Entry& entry = entries[i];
+    if (entry.rounds == 0) {
+      continue;
+    }
+    OS::PrintErr("%-40s %8" Pd64 " %10.1f %8.1f %12" Pd64 " %12" Pd64
+                 " %10" Pd64 "\n",
+                 CompilerPass::Get(static_cast<CompilerPass::Id>(entry.id))
+                     ->name(),
+                 entry.rounds, MicrosecondsToMilliseconds(entry.total_micros),
+                 MicrosecondsToMilliseconds(entry.max_micros),
+                 entry.instructions_before, entry.instructions_after,
+                 entry.zone_bytes / KB);
+  }
+}
+
 void CompilerPass::PrintGraph(CompilerPassState* state,
                               Flag mask,
                               intptr_t round) const {
@@ -291,8 +391,38 @@ FlowGraph* CompilerPass::RunForceOptimizedPipeline(
   return pass_state->flow_graph();
 }
 
-FlowGraph* CompilerPass::RunPipeline(PipelineMode mode,
-                                     CompilerPassState* pass_state) {
+FlowGraph* CompilerPass::RunQuickPipeline(CompilerPassState* pass_state) {
+  INVOKE_PASS(ComputeSSA);
+  INVOKE_PASS(ApplyICData);
+  INVOKE_PASS(TryOptimizePatterns);
+  INVOKE_PASS(SetOuterInliningId);
+  INVOKE_PASS(TypePropagation);
+  INVOKE_PASS(ApplyClassIds);
+  INVOKE_PASS(Canonicalize);
+  INVOKE_PASS(BranchSimplify);
+  INVOKE_PASS(IfConvert);
+  INVOKE_PASS(ConstantPropagation);
+  INVOKE_PASS(TypePropagation);
+  INVOKE_PASS(WidenSmiToInt32);
+  INVOKE_PASS(SelectRepresentations);
+  INVOKE_PASS(CSE);
+  INVOKE_PASS(TypePropagation);
+  INVOKE_PASS(TryCatchOptimization);
+  INVOKE_PASS(EliminateEnvironments);
+  INVOKE_PASS(EliminateDeadPhis);
+  // Currently DCE assumes that EliminateEnvironments has already been run,
+  // so it should not be lifted earlier than that pass.
+  INVOKE_PASS(DCE);
+  INVOKE_PASS(Canonicalize);
+  INVOKE_PASS(EliminateWriteBarriers);
+  INVOKE_PASS(FinalizeGraph);
+  INVOKE_PASS(AllocateRegisters);
+  INVOKE_PASS(ReorderBlocks);
+  return pass_state->flow_graph();
+}
+
+void CompilerPass::RunPipelineThroughInlining(PipelineMode mode,
+                                              CompilerPassState* pass_state) {
   INVOKE_PASS(ComputeSSA);
   if (FLAG_early_round_trip_serialization) {
     INVOKE_PASS(RoundTripSerialization);
@@ -305,6 +435,16 @@ FlowGraph* CompilerPass::RunPipeline(PipelineMode mode,
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(ApplyClassIds);
   INVOKE_PASS(Inlining);
+}
+
+FlowGraph* CompilerPass::RunPipeline(PipelineMode mode,
+                                     CompilerPassState* pass_state) {
+  if (!pass_state->from_flow_graph_cache) {
+    RunPipelineThroughInlining(mode, pass_state);
+    if (mode == kJIT && FlowGraphCache::IsEnabled()) {
+      INVOKE_PASS(CacheFlowGraph);
+    }
+  }
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(ApplyClassIds);
   INVOKE_PASS(TypePropagation);
@@ -331,6 +471,8 @@ FlowGraph* CompilerPass::RunPipeline(PipelineMode mode,
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(RangeAnalysis);
   INVOKE_PASS(OptimizeBranches);
+  INVOKE_PASS(VectorizeLoops);
+  INVOKE_PASS(UnrollLoops);
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(TryCatchOptimization);
   INVOKE_PASS(EliminateEnvironments);
@@ -474,6 +616,10 @@ COMPILER_PASS(OptimizeBranches, {
   ConstantPropagator::OptimizeBranches(flow_graph);
 });
 
+COMPILER_PASS(VectorizeLoops, { LoopVectorizer::Vectorize(flow_graph); });
+
+COMPILER_PASS(UnrollLoops, { LoopUnroller::Optimize(flow_graph); });
+
 COMPILER_PASS(OptimizeTypedDataAccesses,
               { TypedDataSpecializer::Optimize(flow_graph); });
 
@@ -550,8 +696,37 @@ COMPILER_PASS(FinalizeGraph, {
 });
 
 #if defined(DART_PRECOMPILER)
+DEFINE_FLAG(bool,
+            serialize_only_llvm_candidates,
+            false,
+            "Only serialize flow graphs of numeric kernels, i.e. graphs with "
+            "unboxed arithmetic inside loops, that are worth handing to the "
+            "LLVM backend in runtime/llvm_codegen "
+            "(with --serialize_flow_graphs_to)");
+
+// Without a profile, the hot code of an AOT compiled function is assumed to
+// be in its loops. Graphs which do unboxed arithmetic there are the ones for
+// which LLVM's loop and vector optimizations can pay off.
+static bool IsLLVMCandidate(FlowGraph* flow_graph) {
+  if (flow_graph->GetLoopHierarchy().num_loops() == 0) return false;
+  for (auto block : flow_graph->reverse_postorder()) {
+    if (block->loop_info() == nullptr) continue;
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      Definition* defn = it.Current()->AsDefinition();
+      if ((defn != nullptr) && !defn->CanCallDart() &&
+          RepresentationUtils::IsUnboxed(defn->representation())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 COMPILER_PASS(SerializeGraph, {
   if (state->precompiler == nullptr) return false;
+  if (FLAG_serialize_only_llvm_candidates && !IsLLVMCandidate(flow_graph)) {
+    return false;
+  }
   if (auto stream = state->precompiler->il_serialization_stream()) {
     auto file_write = Dart::file_write_callback();
     ASSERT(file_write != nullptr);
@@ -567,6 +742,8 @@ COMPILER_PASS(SerializeGraph, {
 });
 #endif
 
+COMPILER_PASS(CacheFlowGraph, { FlowGraphCache::Store(state); });
+
 COMPILER_PASS(RoundTripSerialization, {
   FlowGraphDeserializer::RoundTripSerialization(state);
   ASSERT(state->flow_graph() != nullptr);
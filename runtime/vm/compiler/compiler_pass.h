@@ -12,6 +12,7 @@
 #include <initializer_list>
 
 #include "vm/growable_array.h"
+#include "vm/lockers.h"
 #include "vm/token_position.h"
 #include "vm/zone.h"
 
@@ -26,6 +27,7 @@ namespace dart {
   V(ApplyICData)                                                               \
   V(BranchSimplify)                                                            \
   V(CSE)                                                                       \
+  V(CacheFlowGraph)                                                            \
   V(Canonicalize)                                                              \
   V(ComputeSSA)                                                                \
   V(ConstantPropagation)                                                       \
@@ -51,7 +53,9 @@ namespace dart {
   V(TryCatchOptimization)                                                      \
   V(TryOptimizePatterns)                                                       \
   V(TypePropagation)                                                           \
+  V(UnrollLoops)                                                               \
   V(UseTableDispatch)                                                          \
+  V(VectorizeLoops)                                                            \
   V(WidenSmiToInt32)                                                           \
   V(EliminateWriteBarriers)
 
@@ -78,6 +82,7 @@ struct CompilerPassState {
         speculative_policy(speculative_policy),
         reorder_blocks(false),
         sticky_flags(0),
+        from_flow_graph_cache(false),
         flow_graph_(flow_graph) {}
 
   FlowGraph* flow_graph() const { return flow_graph_; }
@@ -105,6 +110,10 @@ struct CompilerPassState {
 
   intptr_t sticky_flags;
 
+  // Whether the flow graph was loaded from the FlowGraphCache, in which case
+  // the passes up to and including inlining have already been applied.
+  bool from_flow_graph_cache;
+
  private:
   FlowGraph* flow_graph_;
 };
@@ -121,7 +130,7 @@ class CompilerPass {
   static constexpr intptr_t kNumPasses = 0 COMPILER_PASS_LIST(ADD_ONE);
 #undef ADD_ONE
 
-  CompilerPass(Id id, const char* name) : name_(name), flags_(0) {
+  CompilerPass(Id id, const char* name) : id_(id), name_(name), flags_(0) {
     ASSERT(passes_[id] == NULL);
     passes_[id] = this;
 
@@ -142,6 +151,7 @@ class CompilerPass {
 
   void Run(CompilerPassState* state) const;
 
+  Id id() const { return id_; }
   intptr_t flags() const { return flags_; }
   const char* name() const { return name_; }
 
@@ -171,6 +181,11 @@ class CompilerPass {
       CompilerPassState* state,
       std::initializer_list<CompilerPass::Id> passes);
 
+  // Pipeline of the quick JIT tier used for warm functions: no inlining and
+  // no loop or range based optimizations.
+  DART_WARN_UNUSED_RESULT
+  static FlowGraph* RunQuickPipeline(CompilerPassState* state);
+
   // Pipeline which is used for "force-optimized" functions.
   //
   // Must not include speculative or inter-procedural optimizations.
@@ -185,6 +200,10 @@ class CompilerPass {
   virtual bool DoBody(CompilerPassState* state) const = 0;
 
  private:
+  // The part of RunPipeline that FlowGraphCache entries have already done.
+  static void RunPipelineThroughInlining(PipelineMode mode,
+                                         CompilerPassState* state);
+
   static CompilerPass* FindPassByName(const char* name) {
     for (intptr_t i = 0; i < kNumPasses; i++) {
       if ((passes_[i] != NULL) && (strcmp(passes_[i]->name_, name) == 0)) {
@@ -198,10 +217,48 @@ class CompilerPass {
 
   static CompilerPass* passes_[];
 
+  const Id id_;
   const char* name_;
   intptr_t flags_;
 };
 
+// Time, flow graph sizes and zone allocation of the compiler passes run for
+// an isolate group, summed over all compilations. Only recorded when
+// --print_compiler_pass_stats is given or the CompilerVerbose timeline stream
+// is enabled, since counting instructions walks the whole graph.
+class CompilerPassStats {
+ public:
+  CompilerPassStats() {}
+
+  // Records one round of a pass.
+  void Add(CompilerPass::Id id,
+           int64_t micros,
+           intptr_t instructions_before,
+           intptr_t instructions_after,
+           intptr_t zone_bytes);
+
+  // Prints one line per pass that ran, slowest first.
+  void Print(const char* name);
+
+ private:
+  struct Entry {
+    intptr_t id;
+    int64_t rounds;
+    int64_t total_micros;
+    int64_t max_micros;
+    int64_t instructions_before;
+    int64_t instructions_after;
+    int64_t zone_bytes;
+  };
+
+  static int CompareByTime(const void* a, const void* b);
+
+  Mutex mutex_;
+  Entry entries_[CompilerPass::kNumPasses] = {};
+
+  DISALLOW_COPY_AND_ASSIGN(CompilerPassStats);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_COMPILER_COMPILER_PASS_H_
@@ -19,8 +19,11 @@ namespace compiler {
 
 namespace ffi {
 
+// Creates the trampoline function for a Dart -> native call. Leaf calls
+// ([is_leaf]) skip the transition to native code, see FfiCallInstr.
 FunctionPtr TrampolineFunction(const Function& dart_signature,
-                               const Function& c_signature);
+                               const Function& c_signature,
+                               bool is_leaf);
 
 }  // namespace ffi
 
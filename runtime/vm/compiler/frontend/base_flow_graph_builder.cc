@@ -995,7 +995,8 @@ Fragment BaseFlowGraphBuilder::Box(Representation from) {
 }
 
 Fragment BaseFlowGraphBuilder::BuildFfiAsFunctionInternalCall(
-    const TypeArguments& signatures) {
+    const TypeArguments& signatures,
+    bool is_leaf) {
   ASSERT(signatures.IsInstantiated());
   ASSERT(signatures.Length() == 2);
 
@@ -1006,7 +1007,7 @@ Fragment BaseFlowGraphBuilder::BuildFfiAsFunctionInternalCall(
   const Function& target =
       Function::ZoneHandle(compiler::ffi::TrampolineFunction(
           Function::Handle(Z, Type::Cast(dart_type).signature()),
-          Function::Handle(Z, Type::Cast(native_type).signature())));
+          Function::Handle(Z, Type::Cast(native_type).signature()), is_leaf));
 
   Fragment code;
   // Store the pointer in the context, we cannot load the untagged address
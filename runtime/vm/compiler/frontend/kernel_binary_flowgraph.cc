@@ -15,6 +15,11 @@
 namespace dart {
 namespace kernel {
 
+// Switch statements with at least this many Smi case values dispatch by
+// binary search, down to ranges of at most kMaxSmiSwitchLinearCases values.
+static constexpr intptr_t kMinSmiSwitchCases = 8;
+static constexpr intptr_t kMaxSmiSwitchLinearCases = 3;
+
 #define Z (zone_)
 #define H (translation_helper_)
 #define T (type_translator_)
@@ -4347,10 +4352,64 @@ Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
 
   intptr_t end_offset = ReaderOffset();
 
+  // If all cases are Smi constants and there are many of them, a Smi value is
+  // dispatched by binary search instead of being compared with every case in
+  // turn. Other values still take the chain of == calls below, which is what
+  // the language specifies for them (e.g. 1.0 matches `case 1`).
+  GrowableArray<SmiSwitchCase> smi_cases(Z, case_count);
+  bool all_smi_cases = true;
+  Instance& value = Instance::Handle(Z);
+  for (intptr_t i = 0; all_smi_cases && (i < case_count); ++i) {
+    if (i == default_case) continue;
+    SetOffset(case_expression_offsets[i]);
+    int expression_count = ReadListLength();  // read length of expressions.
+    for (intptr_t j = 0; all_smi_cases && (j < expression_count); ++j) {
+      ReadPosition();  // read jth position.
+      value = constant_reader_.ReadConstantExpression();
+      all_smi_cases = value.IsSmi() &&
+                      compiler::target::IsSmi(Smi::Cast(value).Value());
+      if (all_smi_cases) {
+        smi_cases.Add({Smi::Cast(value).Value(), i});
+      }
+    }
+  }
+  const bool use_smi_dispatch =
+      all_smi_cases && (smi_cases.length() >= kMinSmiSwitchCases);
+
   // Phase 2: Generate everything except the real bodies:
   //   * jump directly to a body (if there is no jumper)
   //   * jump to a wrapper block which jumps to the body (if there is a jumper)
   Fragment current_instructions = head_instructions;
+  JoinEntryInstr* smi_dispatch_miss = nullptr;
+  if (use_smi_dispatch) {
+    // The first of equal case values matches.
+    smi_cases.Sort([](const SmiSwitchCase* a, const SmiSwitchCase* b) {
+      if (a->value != b->value) return (a->value < b->value) ? -1 : 1;
+      return (a->case_index < b->case_index) ? -1 : 1;
+    });
+    intptr_t length = 1;
+    for (intptr_t k = 1; k < smi_cases.length(); ++k) {
+      if (smi_cases[k].value != smi_cases[length - 1].value) {
+        smi_cases[length++] = smi_cases[k];
+      }
+    }
+    smi_cases.TruncateTo(length);
+
+    // Every body now has two incoming edges, so the dispatch creates the
+    // join blocks the loop below jumps to.
+    smi_dispatch_miss = BuildJoinEntry();
+    TargetEntryInstr* is_smi;
+    TargetEntryInstr* is_not_smi;
+    current_instructions += LoadLocal(scopes()->switch_variable);
+    current_instructions += B->LoadClassId();
+    current_instructions += IntConstant(kSmiCid);
+    current_instructions += B->BranchIfStrictEqual(&is_smi, &is_not_smi);
+    Fragment(is_smi) + BuildSmiSwitchDispatch(&block, smi_cases, 0,
+                                              smi_cases.length(),
+                                              smi_dispatch_miss);
+    current_instructions = Fragment(is_not_smi);
+  }
+
   for (intptr_t i = 0; i < case_count; ++i) {
     SetOffset(case_expression_offsets[i]);
     int expression_count = ReadListLength();  // read length of expressions.
@@ -4358,6 +4417,11 @@ Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
     if (i == default_case) {
       ASSERT(i == (case_count - 1));
 
+      if (smi_dispatch_miss != nullptr) {
+        current_instructions += Goto(smi_dispatch_miss);
+        current_instructions = Fragment(smi_dispatch_miss);
+      }
+
       if (block.HadJumper(i)) {
         // There are several branches to the body, so we will make a goto to
         // the join block (and prepend a join instruction to the real body).
@@ -4409,15 +4473,21 @@ Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
   }
 
   if (case_count > 0 && default_case < 0) {
+    if (smi_dispatch_miss != nullptr) {
+      current_instructions += Goto(smi_dispatch_miss);
+      current_instructions = Fragment(smi_dispatch_miss);
+    }
+
     // There is no default, which means we have an open [current_instructions]
-    // (which is a [TargetEntryInstruction] for the last "otherwise" branch).
+    // (which is a [TargetEntryInstruction] for the last "otherwise" branch, or
+    // the [JoinEntryInstr] it shares with the Smi dispatch).
     //
     // Furthermore the last [SwitchCase] can be open as well.  If so, we need
     // to join these two.
     Fragment& last_body = body_fragments[case_count - 1];
     if (last_body.is_open()) {
       ASSERT(current_instructions.is_open());
-      ASSERT(current_instructions.current->IsTargetEntry());
+      ASSERT(current_instructions.current->IsBlockEntry());
 
       // Join the last "otherwise" branch and the last [SwitchCase] fragment.
       JoinEntryInstr* join = BuildJoinEntry();
@@ -4436,6 +4506,39 @@ Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
   return Fragment(head_instructions.entry, current_instructions.current);
 }
 
+Fragment StreamingFlowGraphBuilder::BuildSmiSwitchDispatch(
+    SwitchBlock* block,
+    const GrowableArray<SmiSwitchCase>& cases,
+    intptr_t lo,
+    intptr_t hi,
+    JoinEntryInstr* miss) {
+  Fragment instructions;
+  if ((hi - lo) <= kMaxSmiSwitchLinearCases) {
+    for (intptr_t k = lo; k < hi; ++k) {
+      TargetEntryInstr* then;
+      TargetEntryInstr* otherwise;
+      instructions += LoadLocal(scopes()->switch_variable);
+      instructions += IntConstant(cases[k].value);
+      instructions += B->BranchIfStrictEqual(&then, &otherwise);
+      Fragment(then) + Goto(block->DestinationDirect(cases[k].case_index));
+      instructions = Fragment(instructions.entry, otherwise);
+    }
+    instructions += Goto(miss);
+    return instructions;
+  }
+
+  const intptr_t mid = lo + (hi - lo) / 2;
+  TargetEntryInstr* less;
+  TargetEntryInstr* not_less;
+  instructions += LoadLocal(scopes()->switch_variable);
+  instructions += IntConstant(cases[mid].value);
+  instructions += B->SmiRelationalOp(Token::kLT);
+  instructions += BranchIfTrue(&less, &not_less, false);
+  Fragment(less) + BuildSmiSwitchDispatch(block, cases, lo, mid, miss);
+  Fragment(not_less) + BuildSmiSwitchDispatch(block, cases, mid, hi, miss);
+  return instructions;
+}
+
 Fragment StreamingFlowGraphBuilder::BuildContinueSwitchStatement() {
   TokenPosition position = ReadPosition();  // read position.
   intptr_t target_index = ReadUInt();       // read target index.
@@ -5036,8 +5139,13 @@ Fragment StreamingFlowGraphBuilder::BuildFunctionNode(
 }
 
 Fragment StreamingFlowGraphBuilder::BuildFfiAsFunctionInternal() {
+  // The call-site must look like this (guaranteed by the FE which inserts it):
+  //
+  //   _asFunctionInternal<DartSignature, NativeSignature>(pointer, isLeaf)
+  //
+  // The FE also guarantees that 'isLeaf' is a constant.
   const intptr_t argc = ReadUInt();               // read argument count.
-  ASSERT(argc == 1);                              // pointer
+  ASSERT(argc == 2);                              // pointer, isLeaf
   const intptr_t list_length = ReadListLength();  // read types list length.
   ASSERT(list_length == 2);  // dart signature, then native signature
   const TypeArguments& type_arguments =
@@ -5045,12 +5153,20 @@ Fragment StreamingFlowGraphBuilder::BuildFfiAsFunctionInternal() {
   Fragment code;
   const intptr_t positional_count =
       ReadListLength();  // read positional argument count
-  ASSERT(positional_count == 1);
+  ASSERT(positional_count == 2);
   code += BuildExpression();  // build first positional argument (pointer)
+
+  // Build second positional argument (isLeaf).
+  code += BuildExpression();
+  Definition* is_leaf_def = B->Peek();
+  ASSERT(is_leaf_def->IsConstant());
+  const bool is_leaf = Bool::Cast(is_leaf_def->AsConstant()->value()).value();
+  code += Drop();
+
   const intptr_t named_args_len =
       ReadListLength();  // skip (empty) named arguments list
   ASSERT(named_args_len == 0);
-  code += B->BuildFfiAsFunctionInternalCall(type_arguments);
+  code += B->BuildFfiAsFunctionInternalCall(type_arguments, is_leaf);
   return code;
 }
 
@@ -20,6 +20,12 @@
 namespace dart {
 namespace kernel {
 
+// A case expression of a switch statement whose cases are all Smi constants.
+struct SmiSwitchCase {
+  int64_t value;
+  intptr_t case_index;
+};
+
 class StreamingFlowGraphBuilder : public KernelReaderHelper {
  public:
   StreamingFlowGraphBuilder(FlowGraphBuilder* flow_graph_builder,
@@ -334,6 +340,11 @@ class StreamingFlowGraphBuilder : public KernelReaderHelper {
   Fragment BuildForStatement();
   Fragment BuildForInStatement(bool async);
   Fragment BuildSwitchStatement();
+  Fragment BuildSmiSwitchDispatch(SwitchBlock* block,
+                                  const GrowableArray<SmiSwitchCase>& cases,
+                                  intptr_t lo,
+                                  intptr_t hi,
+                                  JoinEntryInstr* miss);
   Fragment BuildContinueSwitchStatement();
   Fragment BuildIfStatement();
   Fragment BuildReturnStatement();
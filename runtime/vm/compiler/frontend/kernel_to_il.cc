@@ -7,6 +7,7 @@
 #include "platform/assert.h"
 #include "platform/globals.h"
 #include "vm/class_id.h"
+#include "vm/code_coverage.h"
 #include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/il.h"
 #include "vm/compiler/backend/il_printer.h"
@@ -382,11 +383,12 @@ Fragment FlowGraphBuilder::InstanceCall(
 }
 
 Fragment FlowGraphBuilder::FfiCall(
-    const compiler::ffi::CallMarshaller& marshaller) {
+    const compiler::ffi::CallMarshaller& marshaller,
+    bool is_leaf) {
   Fragment body;
 
   FfiCallInstr* const call =
-      new (Z) FfiCallInstr(Z, GetNextDeoptId(), marshaller);
+      new (Z) FfiCallInstr(Z, GetNextDeoptId(), marshaller, is_leaf);
 
   for (intptr_t i = call->InputCount() - 1; i >= 0; --i) {
     call->SetInputAt(i, Pop());
@@ -763,7 +765,61 @@ FlowGraph* FlowGraphBuilder::BuildGraph() {
 
   StreamingFlowGraphBuilder streaming_flow_graph_builder(
       this, kernel_data, kernel_data_program_offset);
-  return streaming_flow_graph_builder.BuildGraph();
+  FlowGraph* graph = streaming_flow_graph_builder.BuildGraph();
+  if ((graph != nullptr) && CodeCoverage::IsEnabled()) {
+    InstrumentBlockCoverage(graph);
+  }
+  return graph;
+}
+
+static int CompareTokenPositions(const TokenPosition* a,
+                                 const TokenPosition* b) {
+  if (*a == *b) return 0;
+  return (*a < *b) ? -1 : 1;
+}
+
+void FlowGraphBuilder::InstrumentBlockCoverage(FlowGraph* graph) {
+  GrowableArray<BlockEntryInstr*> blocks(Z, 16);
+  GrowableArray<TokenPosition> positions(Z, 16);
+  for (BlockEntryInstr* block : graph->reverse_postorder()) {
+    if (block->IsGraphEntry()) continue;
+    for (Instruction* instr = block->next(); instr != nullptr;
+         instr = instr->next()) {
+      if (instr->token_pos().IsReal()) {
+        blocks.Add(block);
+        positions.Add(instr->token_pos());
+        break;
+      }
+    }
+  }
+  if (blocks.is_empty()) return;
+
+  GrowableArray<TokenPosition> sorted(Z, positions.length());
+  sorted.AddArray(positions);
+  sorted.Sort(CompareTokenPositions);
+  intptr_t length = 1;
+  for (intptr_t i = 1; i < sorted.length(); i++) {
+    if (sorted[i] != sorted[length - 1]) {
+      sorted[length++] = sorted[i];
+    }
+  }
+  sorted.TruncateTo(length);
+
+  const Array& coverage = Array::ZoneHandle(
+      Z, CodeCoverage::ArrayFor(thread_, parsed_function_->function(), sorted));
+  for (intptr_t i = 0; i < blocks.length(); i++) {
+    const intptr_t index = CodeCoverage::FlagIndexOf(coverage, positions[i]);
+    if (index < 0) continue;
+    // The hit flag is a Smi, so the store needs no barrier and no
+    // read-modify-write, and optimized code keeps it as a side effect.
+    Fragment set_flag = Constant(coverage);
+    set_flag += IntConstant(index);
+    set_flag += IntConstant(1);
+    set_flag += StoreIndexed(kArrayCid);
+    Instruction* first = blocks[i]->next();
+    blocks[i]->LinkTo(set_flag.entry);
+    set_flag.current->LinkTo(first);
+  }
 }
 
 Fragment FlowGraphBuilder::NativeFunctionBody(const Function& function,
@@ -4091,8 +4147,11 @@ Fragment FlowGraphBuilder::FfiConvertPrimitiveToNative(
 
   Fragment body;
   if (marshaller.IsPointer(arg_index)) {
-    // This can only be Pointer, so it is always safe to LoadUntagged.
-    body += LoadUntagged(compiler::target::Pointer::data_field_offset());
+    // This is a Pointer or, in leaf calls, a TypedDataBase. Both are
+    // PointerBase, so it is always safe to LoadUntagged. The data field of
+    // internal typed data moves with the object, but no GC can happen during
+    // a leaf call.
+    body += LoadUntagged(compiler::target::PointerBase::data_field_offset());
     body += ConvertUntaggedToUnboxed(kUnboxedFfiIntPtr);
   } else if (marshaller.IsHandle(arg_index)) {
     body += WrapHandle(api_local_scope);
@@ -4139,6 +4198,9 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
   const auto& marshaller = *new (Z) compiler::ffi::CallMarshaller(Z, function);
 
   const bool signature_contains_handles = marshaller.ContainsHandles();
+  const bool is_leaf = function.FfiIsLeaf();
+  // The FE rejects leaf calls with handles, which need the API scope.
+  ASSERT(!is_leaf || !signature_contains_handles);
 
   // FFI trampolines are accessed via closures, so non-covariant argument types
   // and type arguments are either statically checked by the type system or
@@ -4189,6 +4251,14 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
 
   // Unbox and push the arguments.
   for (intptr_t i = 0; i < marshaller.num_args(); i++) {
+#if defined(DEBUG)
+    if (marshaller.IsPointer(i)) {
+      // The FE only allows typed data in place of pointers for leaf calls.
+      const auto& type = AbstractType::Handle(
+          Z, function.ParameterTypeAt(kFirstArgumentParameterOffset + i));
+      ASSERT(is_leaf || type.type_class_id() == kFfiPointerCid);
+    }
+#endif
     if (marshaller.IsStruct(i)) {
       body += FfiCallConvertStructArgumentToNative(
           parsed_function_->ParameterVariable(kFirstArgumentParameterOffset +
@@ -4219,7 +4289,7 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
     body += LoadLocal(typed_data);
   }
 
-  body += FfiCall(marshaller);
+  body += FfiCall(marshaller, is_leaf);
 
   for (intptr_t i = 0; i < marshaller.num_args(); i++) {
     if (marshaller.IsPointer(i)) {
@@ -69,6 +69,10 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
   BlockEntryInstr* BuildPrologue(BlockEntryInstr* normal_entry,
                                  PrologueInfo* prologue_info);
 
+  // Starts each block of [graph] with a source position by setting its hit
+  // flag in the coverage array of the function (see CodeCoverage).
+  void InstrumentBlockCoverage(FlowGraph* graph);
+
   // Return names of optional named parameters of [function].
   ArrayPtr GetOptionalParameterNames(const Function& function);
 
@@ -191,7 +195,8 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
       const CallSiteAttributesMetadata* call_site_attrs = nullptr,
       bool receiver_is_not_smi = false);
 
-  Fragment FfiCall(const compiler::ffi::CallMarshaller& marshaller);
+  Fragment FfiCall(const compiler::ffi::CallMarshaller& marshaller,
+                   bool is_leaf);
 
   Fragment ThrowException(TokenPosition position);
   Fragment RethrowException(TokenPosition position, int catch_try_index);
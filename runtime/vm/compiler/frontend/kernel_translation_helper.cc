@@ -35,7 +35,8 @@ TranslationHelper::TranslationHelper(Thread* thread)
       constants_(Array::Handle(Z)),
       constants_table_(ExternalTypedData::Handle(Z)),
       info_(KernelProgramInfo::Handle(Z)),
-      name_index_handle_(Smi::Handle(Z)) {}
+      name_index_handle_(Smi::Handle(Z)),
+      symbols_(Z) {}
 
 TranslationHelper::TranslationHelper(Thread* thread, Heap::Space space)
     : thread_(thread),
@@ -50,7 +51,8 @@ TranslationHelper::TranslationHelper(Thread* thread, Heap::Space space)
       constants_(Array::Handle(Z)),
       constants_table_(ExternalTypedData::Handle(Z)),
       info_(KernelProgramInfo::Handle(Z)),
-      name_index_handle_(Smi::Handle(Z)) {}
+      name_index_handle_(Smi::Handle(Z)),
+      symbols_(Z) {}
 
 void TranslationHelper::Reset() {
   string_offsets_ = TypedData::null();
@@ -59,6 +61,7 @@ void TranslationHelper::Reset() {
   metadata_payloads_ = ExternalTypedData::null();
   metadata_mappings_ = ExternalTypedData::null();
   constants_ = Array::null();
+  symbols_.Clear();
 }
 
 void TranslationHelper::InitFromScript(const Script& script) {
@@ -375,16 +378,25 @@ const String& TranslationHelper::DartSymbolPlain(const char* content) const {
   return String::ZoneHandle(Z, Symbols::New(thread_, content));
 }
 
-String& TranslationHelper::DartSymbolPlain(StringIndex string_index) const {
+StringPtr TranslationHelper::Symbol(StringIndex string_index) const {
+  const String* cached = symbols_.Lookup(string_index);
+  if (cached != nullptr) {
+    return cached->raw();
+  }
   intptr_t length = StringSize(string_index);
   uint8_t* buffer = Z->Alloc<uint8_t>(length);
   {
     NoSafepointScope no_safepoint;
     memmove(buffer, StringBuffer(string_index), length);
   }
-  String& result =
+  const String& symbol =
       String::ZoneHandle(Z, Symbols::FromUTF8(thread_, buffer, length));
-  return result;
+  symbols_.Insert(string_index, &symbol);
+  return symbol.raw();
+}
+
+String& TranslationHelper::DartSymbolPlain(StringIndex string_index) const {
+  return String::ZoneHandle(Z, Symbol(string_index));
 }
 
 const String& TranslationHelper::DartSymbolObfuscate(
@@ -398,14 +410,7 @@ const String& TranslationHelper::DartSymbolObfuscate(
 }
 
 String& TranslationHelper::DartSymbolObfuscate(StringIndex string_index) const {
-  intptr_t length = StringSize(string_index);
-  uint8_t* buffer = Z->Alloc<uint8_t>(length);
-  {
-    NoSafepointScope no_safepoint;
-    memmove(buffer, StringBuffer(string_index), length);
-  }
-  String& result =
-      String::ZoneHandle(Z, Symbols::FromUTF8(thread_, buffer, length));
+  String& result = String::ZoneHandle(Z, Symbol(string_index));
   if (I->obfuscate()) {
     Obfuscator obfuscator(thread_, String::Handle(Z));
     result = obfuscator.Rename(result, true);
@@ -10,6 +10,7 @@
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 
 #include "vm/compiler/backend/il.h"  // For CompileType.
+#include "vm/hash_map.h"
 #include "vm/kernel.h"
 #include "vm/kernel_binary.h"
 #include "vm/object.h"
@@ -228,6 +229,10 @@ class TranslationHelper {
                             bool symbolize = true,
                             bool obfuscate = true);
 
+  // Returns the symbol for the string at [string_index], which is created at
+  // most once per string while the string data is set.
+  StringPtr Symbol(StringIndex string_index) const;
+
   Thread* thread_;
   Zone* zone_;
   Isolate* isolate_;
@@ -245,6 +250,7 @@ class TranslationHelper {
   GrowableObjectArray* potential_extension_libraries_ = nullptr;
   Function* expression_evaluation_function_ = nullptr;
   Class* expression_evaluation_real_class_ = nullptr;
+  mutable IntMap<const String*> symbols_;
 
   DISALLOW_COPY_AND_ASSIGN(TranslationHelper);
 };
@@ -24,6 +24,7 @@
 #include "vm/compiler/compiler_state.h"
 #include "vm/compiler/frontend/flow_graph_builder.h"
 #include "vm/compiler/frontend/kernel_to_il.h"
+#include "vm/compiler/jit/flow_graph_cache.h"
 #include "vm/compiler/jit/jit_call_specializer.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
@@ -82,6 +83,16 @@ DEFINE_FLAG(bool,
             false,
             "Trace only optimizing compiler operations.");
 DEFINE_FLAG(bool, trace_bailout, false, "Print bailout from ssa compiler.");
+DEFINE_FLAG(bool,
+            optimization_tiers,
+            false,
+            "Optimize warm functions with a quick pipeline first and use the "
+            "full pipeline only for functions that stay hot.");
+DEFINE_FLAG(int,
+            full_optimization_counter_threshold,
+            30000,
+            "Usage count of quick tier code before the function is "
+            "reoptimized with the full pipeline.");
 
 DECLARE_FLAG(bool, huge_method_cutoff_in_code_size);
 DECLARE_FLAG(bool, trace_failed_optimization_attempts);
@@ -344,6 +355,14 @@ CodePtr CompileParsedFunctionHelper::FinalizeCompilation(
   const Function& function = parsed_function()->function();
   Zone* const zone = thread()->zone();
 
+  if (FLAG_enable_isolate_groups && !optimized() && function.HasCode()) {
+    // Another isolate of the group installed unoptimized code while this one
+    // was compiling. Keep that code: the function's ICData map refers to the
+    // ICData it calls through, so all isolates accumulate their feedback in
+    // one set of ICData.
+    return function.unoptimized_code();
+  }
+
   // CreateDeoptInfo uses the object pool and needs to be done before
   // FinalizeCode.
   Array& deopt_info_array = Array::Handle(zone, Object::empty_array().raw());
@@ -513,6 +532,7 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
     LongJumpScope jump;
     if (setjmp(*jump.Set()) == 0) {
       FlowGraph* flow_graph = nullptr;
+      bool from_flow_graph_cache = false;
       ZoneGrowableArray<const ICData*>* ic_data_array = nullptr;
 
       CompilerState compiler_state(thread(), /*is_aot=*/false,
@@ -553,9 +573,18 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
           }
         }
 
-        TIMELINE_DURATION(thread(), CompilerVerbose, "BuildFlowGraph");
-        flow_graph = pipeline->BuildFlowGraph(
-            zone, parsed_function(), ic_data_array, osr_id(), optimized());
+        if (optimized() && (osr_id() == Compiler::kNoOSRDeoptId) &&
+            FlowGraphCache::IsEnabled()) {
+          TIMELINE_DURATION(thread(), CompilerVerbose, "LoadCachedFlowGraph");
+          flow_graph = FlowGraphCache::Load(thread(), parsed_function());
+        }
+        if (flow_graph == nullptr) {
+          TIMELINE_DURATION(thread(), CompilerVerbose, "BuildFlowGraph");
+          flow_graph = pipeline->BuildFlowGraph(
+              zone, parsed_function(), ic_data_array, osr_id(), optimized());
+        } else {
+          from_flow_graph_cache = true;
+        }
       }
 
       const bool print_flow_graph =
@@ -569,7 +598,9 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 
       const bool reorder_blocks =
           FlowGraph::ShouldReorderBlocks(function, optimized());
-      if (reorder_blocks) {
+      // The edge counters of the unoptimized code refer to the blocks built
+      // from kernel, so they do not apply to a cached graph.
+      if (reorder_blocks && !from_flow_graph_cache) {
         TIMELINE_DURATION(thread(), CompilerVerbose,
                           "BlockScheduler::AssignEdgeWeights");
         BlockScheduler::AssignEdgeWeights(flow_graph);
@@ -577,6 +608,7 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 
       CompilerPassState pass_state(thread(), flow_graph, &speculative_policy);
       pass_state.reorder_blocks = reorder_blocks;
+      pass_state.from_flow_graph_cache = from_flow_graph_cache;
 
       if (function.ForceOptimize()) {
         ASSERT(optimized());
@@ -598,7 +630,21 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
         JitCallSpecializer call_specializer(flow_graph, &speculative_policy);
         pass_state.call_specializer = &call_specializer;
 
-        flow_graph = CompilerPass::RunPipeline(CompilerPass::kJIT, &pass_state);
+        // The first optimization of a function uses the quick tier; its code
+        // counts invocations and triggers the full pipeline when hot.
+        // Cached graphs went through the full pipeline's inliner, so they
+        // skip the quick tier.
+        const bool quick_tier = FLAG_optimization_tiers &&
+                                (osr_id() == Compiler::kNoOSRDeoptId) &&
+                                !function.HasOptimizedCode() &&
+                                !from_flow_graph_cache;
+        if (quick_tier) {
+          flow_graph = CompilerPass::RunQuickPipeline(&pass_state);
+          flow_graph->set_is_quick_tier(true);
+        } else {
+          flow_graph =
+              CompilerPass::RunPipeline(CompilerPass::kJIT, &pass_state);
+        }
       }
 
       ASSERT(pass_state.inline_id_to_function.length() ==
@@ -1018,8 +1064,8 @@ void Compiler::AbortBackgroundCompilation(intptr_t deopt_id, const char* msg) {
 // C-heap allocated background compilation queue element.
 class QueueElement {
  public:
-  explicit QueueElement(const Function& function)
-      : next_(NULL), function_(function.raw()) {}
+  explicit QueueElement(const Function& function, intptr_t priority = 0)
+      : next_(NULL), function_(function.raw()), priority_(priority) {}
 
   virtual ~QueueElement() {
     next_ = NULL;
@@ -1034,15 +1080,20 @@ class QueueElement {
   ObjectPtr function() const { return function_; }
   ObjectPtr* function_ptr() { return reinterpret_cast<ObjectPtr*>(&function_); }
 
+  intptr_t priority() const { return priority_; }
+
  private:
   QueueElement* next_;
   FunctionPtr function_;
+  intptr_t priority_;
 
   DISALLOW_COPY_AND_ASSIGN(QueueElement);
 };
 
 // Allocated in C-heap. Handles both input and output of background compilation.
-// It implements a FIFO queue, using Peek, Add, Remove operations.
+// It implements a priority queue, using Peek, Add, Remove operations: elements
+// with a higher priority come first, elements of equal priority are kept in
+// FIFO order.
 class BackgroundCompilationQueue {
  public:
   BackgroundCompilationQueue() : first_(NULL), last_(NULL) {}
@@ -1065,11 +1116,23 @@ class BackgroundCompilationQueue {
     if (first_ == NULL) {
       first_ = value;
       ASSERT(last_ == NULL);
+      last_ = value;
+    } else if (first_->priority() < value->priority()) {
+      value->set_next(first_);
+      first_ = value;
     } else {
       ASSERT(last_ != NULL);
-      last_->set_next(value);
+      QueueElement* p = first_;
+      while ((p->next() != NULL) &&
+             (p->next()->priority() >= value->priority())) {
+        p = p->next();
+      }
+      value->set_next(p->next());
+      p->set_next(value);
+      if (p == last_) {
+        last_ = value;
+      }
     }
-    last_ = value;
     ASSERT(first_ != NULL && last_ != NULL);
   }
 
@@ -1091,9 +1154,30 @@ class BackgroundCompilationQueue {
     if (first_ == NULL) {
       last_ = NULL;
     }
+    result->set_next(NULL);
     return result;
   }
 
+  // Removes the given element, which need not be the first one any more
+  // since elements of higher priority may have been added in front of it.
+  void Remove(QueueElement* value) {
+    ASSERT(first_ != NULL);
+    if (first_ == value) {
+      Remove();
+      return;
+    }
+    QueueElement* p = first_;
+    while (p->next() != value) {
+      p = p->next();
+      ASSERT(p != NULL);
+    }
+    p->set_next(value->next());
+    if (last_ == value) {
+      last_ = p;
+    }
+    value->set_next(NULL);
+  }
+
   bool ContainsObj(const Object& obj) const {
     QueueElement* p = first_;
     while (p != NULL) {
@@ -1147,9 +1231,12 @@ void BackgroundCompiler::Run() {
       Zone* zone = stack_zone.GetZone();
       HANDLESCOPE(thread);
       Function& function = Function::Handle(zone);
+      // Stays in the queue while being compiled so that GC visits it.
+      QueueElement* current = NULL;
       {
         MonitorLocker ml(&queue_monitor_);
         if (running_) {
+          current = function_queue()->Peek();
           function = function_queue()->PeekFunction();
         }
       }
@@ -1165,7 +1252,8 @@ void BackgroundCompiler::Run() {
             // We are shutting down, queue was cleared.
             function = Function::null();
           } else {
-            qelem = function_queue()->Remove();
+            qelem = current;
+            function_queue()->Remove(qelem);
             const Function& old = Function::Handle(qelem->Function());
             // If an optimizable method is not optimized, put it back on
             // the background queue (unless it was passed to foreground).
@@ -1174,10 +1262,12 @@ void BackgroundCompiler::Run() {
                 FLAG_stress_test_background_compilation) {
               if (old.is_background_optimizable() &&
                   Compiler::CanOptimizeFunction(thread, old)) {
-                QueueElement* repeat_qelem = new QueueElement(old);
+                QueueElement* repeat_qelem =
+                    new QueueElement(old, qelem->priority());
                 function_queue()->Add(repeat_qelem);
               }
             }
+            current = function_queue()->Peek();
             function = function_queue()->PeekFunction();
           }
         }
@@ -1204,14 +1294,14 @@ void BackgroundCompiler::Run() {
   }
 }
 
-void BackgroundCompiler::Compile(const Function& function) {
+void BackgroundCompiler::Compile(const Function& function, intptr_t priority) {
   ASSERT(Thread::Current()->IsMutatorThread());
   MonitorLocker ml(&queue_monitor_);
   ASSERT(running_);
   if (function_queue()->ContainsObj(function)) {
     return;
   }
-  QueueElement* elem = new QueueElement(function);
+  QueueElement* elem = new QueueElement(function, priority);
   function_queue()->Add(elem);
   ml.Notify();
 }
@@ -157,8 +157,9 @@ class BackgroundCompiler {
   }
 
   // Call to compile (unoptimized or optimized) a function in the background,
-  // enters the function in the compilation queue.
-  void Compile(const Function& function);
+  // enters the function in the compilation queue. Functions with a higher
+  // priority are compiled first.
+  void Compile(const Function& function, intptr_t priority = 0);
 
   void VisitPointers(ObjectPointerVisitor* visitor);
 
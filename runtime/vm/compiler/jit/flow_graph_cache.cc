@@ -0,0 +1,183 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/jit/flow_graph_cache.h"
+
+#include "platform/text_buffer.h"
+#include "platform/utils.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il_deserializer.h"
+#include "vm/compiler/backend/il_serializer.h"
+#include "vm/compiler/backend/sexpression.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/compiler/compiler_state.h"
+#include "vm/dart.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/parser.h"
+#include "vm/version.h"
+
+namespace dart {
+
+DEFINE_FLAG(charp,
+            il_cache_dir,
+            nullptr,
+            "Directory in which optimized flow graphs are cached across runs "
+            "of the same program.");
+DEFINE_FLAG(bool,
+            trace_il_cache,
+            false,
+            "Trace loads and stores of the flow graph cache.");
+
+static bool CanBeCached(const Function& function) {
+  switch (function.kind()) {
+    case FunctionLayout::kRegularFunction:
+    case FunctionLayout::kGetterFunction:
+    case FunctionLayout::kSetterFunction:
+      // Default values of optional parameters are only set up by the flow
+      // graph builder.
+      return !function.HasOptionalParameters() && !function.ForceOptimize();
+    default:
+      return false;
+  }
+}
+
+// Identifies the function and the program it was compiled in. Class ids are
+// embedded in the graphs, so a changed class table invalidates the entry.
+static const char* CacheKey(Thread* thread, const Function& function) {
+  return thread->zone()->PrintToString(
+      "%s %s %" Pd32 " %" Pd "\n", Version::SnapshotString(),
+      function.ToFullyQualifiedCString(), function.SourceFingerprint(),
+      thread->isolate()->class_table()->NumCids());
+}
+
+static const char* CachePath(Zone* zone, const char* key) {
+  return zone->PrintToString("%s/%08x.il", FLAG_il_cache_dir,
+                             Utils::StringHash(key, strlen(key)));
+}
+
+FlowGraph* FlowGraphCache::Load(Thread* thread,
+                                ParsedFunction* parsed_function) {
+  const Function& function = parsed_function->function();
+  auto file_open = Dart::file_open_callback();
+  auto file_read = Dart::file_read_callback();
+  auto file_close = Dart::file_close_callback();
+  if (!CanBeCached(function) || (file_open == nullptr) ||
+      (file_read == nullptr) || (file_close == nullptr)) {
+    return nullptr;
+  }
+
+  Zone* const zone = thread->zone();
+  const char* key = CacheKey(thread, function);
+  const char* path = CachePath(zone, key);
+  void* file = file_open(path, /*write=*/false);
+  if (file == nullptr) {
+    return nullptr;
+  }
+  uint8_t* data = nullptr;
+  intptr_t length = 0;
+  file_read(&data, &length, file);
+  file_close(file);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  char* contents = zone->Alloc<char>(length + 1);
+  memmove(contents, data, length);
+  contents[length] = '\0';
+  free(data);
+
+  // The entry starts with the key, followed by the deopt id counter at the
+  // time the graph was stored.
+  const intptr_t key_length = strlen(key);
+  if (length < key_length || strncmp(contents, key, key_length) != 0) {
+    return nullptr;
+  }
+  char* end = nullptr;
+  const intptr_t deopt_id = strtol(contents + key_length, &end, 10);
+  if ((end == contents + key_length) || (*end != '\n') || (deopt_id < 0)) {
+    return nullptr;
+  }
+  end++;
+
+  SExpParser parser(zone, end, contents + length - end);
+  SExpression* root = parser.Parse();
+  if (root == nullptr) {
+    if (FLAG_trace_il_cache) {
+      THR_Print("Failed to parse cached graph for %s: %s\n",
+                function.ToFullyQualifiedCString(), parser.error_message());
+    }
+    return nullptr;
+  }
+
+  // The deserialized graph uses the scopes and variables the builder would
+  // have set up.
+  parsed_function->EnsureKernelScopes();
+  FlowGraphDeserializer deserializer(thread, zone, root, parsed_function);
+  FlowGraph* flow_graph = deserializer.ParseFlowGraph();
+  if (flow_graph == nullptr) {
+    if (FLAG_trace_il_cache) {
+      THR_Print("Failed to deserialize cached graph for %s: %s\n",
+                function.ToFullyQualifiedCString(),
+                deserializer.error_message());
+    }
+    return nullptr;
+  }
+  thread->compiler_state().set_deopt_id(deopt_id);
+  if (FLAG_trace_il_cache) {
+    THR_Print("Loaded cached graph for %s from %s\n",
+              function.ToFullyQualifiedCString(), path);
+  }
+  return flow_graph;
+}
+
+void FlowGraphCache::Store(CompilerPassState* state) {
+  if (!IsEnabled() || (state->precompiler != nullptr)) return;
+  FlowGraph* flow_graph = state->flow_graph();
+  const Function& function = flow_graph->function();
+  if (!CanBeCached(function) || flow_graph->IsCompiledForOsr()) return;
+
+  // A loaded graph skips the inliner and the flow graph builder, which are
+  // the ones registering inlined functions and code dependencies.
+  Thread* const thread = state->thread;
+  if ((state->inline_id_to_function.length() > 1) ||
+      thread->compiler_state().cha().HasGuardedClasses() ||
+      !flow_graph->parsed_function().guarded_fields()->is_empty()) {
+    return;
+  }
+  GrowableArray<Instruction*> unhandled;
+  FlowGraphDeserializer::AllUnhandledInstructions(flow_graph, &unhandled);
+  if (!unhandled.is_empty()) return;
+
+  auto file_open = Dart::file_open_callback();
+  auto file_write = Dart::file_write_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_write == nullptr) ||
+      (file_close == nullptr)) {
+    return;
+  }
+
+  Zone* const zone = thread->zone();
+  const char* key = CacheKey(thread, function);
+  const char* path = CachePath(zone, key);
+  TextBuffer buffer(1 * KB);
+  buffer.AddString(key);
+  buffer.Printf("%" Pd "\n", thread->compiler_state().deopt_id());
+  FlowGraphSerializer::SerializeToBuffer(zone, flow_graph, &buffer);
+
+  void* file = file_open(path, /*write=*/true);
+  if (file == nullptr) {
+    if (FLAG_trace_il_cache) {
+      THR_Print("Failed to open %s\n", path);
+    }
+    return;
+  }
+  file_write(buffer.buffer(), buffer.length(), file);
+  file_close(file);
+  if (FLAG_trace_il_cache) {
+    THR_Print("Stored graph for %s in %s\n",
+              function.ToFullyQualifiedCString(), path);
+  }
+}
+
+}  // namespace dart
@@ -0,0 +1,47 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_JIT_FLOW_GRAPH_CACHE_H_
+#define RUNTIME_VM_COMPILER_JIT_FLOW_GRAPH_CACHE_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/flags.h"
+
+namespace dart {
+
+struct CompilerPassState;
+class FlowGraph;
+class ParsedFunction;
+class Thread;
+
+DECLARE_FLAG(charp, il_cache_dir);
+
+// Persists optimized flow graphs across runs of the same program in the
+// directory given by --il_cache_dir.
+//
+// Graphs are stored after inlining, in the S-expression format of the
+// FlowGraphSerializer, and only when the FlowGraphDeserializer can read
+// them back and nothing that was decided during graph building or inlining
+// needs to be re-registered with the loaded graph: no callees were inlined
+// and no CHA or field guard dependencies were recorded. A graph loaded from
+// the cache skips the frontend and the passes up to and including inlining.
+class FlowGraphCache : public AllStatic {
+ public:
+  static bool IsEnabled() { return FLAG_il_cache_dir != nullptr; }
+
+  // Returns the cached graph for [parsed_function] or nullptr on a miss.
+  // On a hit, also restores the deopt id counter of the compiler state.
+  static FlowGraph* Load(Thread* thread, ParsedFunction* parsed_function);
+
+  // Writes the flow graph in [state] to the cache if it can be reused.
+  static void Store(CompilerPassState* state);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_JIT_FLOW_GRAPH_CACHE_H_
@@ -164,7 +164,7 @@ namespace dart {
   V(_WeakProperty, set:value, WeakProperty_setValue, 0x804f96dd)               \
   V(::, _classRangeCheck, ClassRangeCheck, 0x071d2ec8)                         \
   V(::, _abi, FfiAbi, 0x54918e73)                                              \
-  V(::, _asFunctionInternal, FfiAsFunctionInternal, 0x2d4e5e32)                \
+  V(::, _asFunctionInternal, FfiAsFunctionInternal, 0x00000000)                \
   V(::, _nativeCallbackFunction, FfiNativeCallbackFunction, 0x68db1afc)        \
   V(::, _loadInt8, FfiLoadInt8, 0x3b38d254)                                    \
   V(::, _loadInt16, FfiLoadInt16, 0x187823ab)                                  \
@@ -40,6 +40,10 @@ bool WillAllocateNewOrRememberedArray(intptr_t length) {
   return !dart::Array::UseCardMarkingForAllocation(length);
 }
 
+bool WillRememberLiveTemporaryArray(intptr_t length) {
+  return length <= dart::Array::kMaxLengthForWriteBarrierElimination;
+}
+
 }  // namespace target
 }  // namespace compiler
 }  // namespace dart
@@ -433,6 +437,11 @@ bool Class::TraceAllocation(const dart::Class& klass) {
   return klass.TraceAllocation(dart::Isolate::Current());
 }
 
+bool Class::IsPretenured(const dart::Class& klass) {
+  return dart::IsolateGroup::Current()->heap()->new_space()->ShouldPretenure(
+      klass.id());
+}
+
 word Instance::first_field_offset() {
   return TranslateOffsetInWords(dart::Instance::NextFieldOffset());
 }
@@ -400,6 +400,11 @@ bool WillAllocateNewOrRememberedContext(intptr_t num_context_variables);
 
 bool WillAllocateNewOrRememberedArray(intptr_t length);
 
+// Returns true if arrays of the given length are added to the store buffer
+// together with other live temporaries after a scavenge (see
+// Thread::RememberLiveTemporaries()).
+bool WillRememberLiveTemporaryArray(intptr_t length);
+
 //
 // Target specific offsets and constants.
 //
@@ -481,6 +486,9 @@ class Class : public AllStatic {
 
   // Whether to trace allocation for this klass.
   static bool TraceAllocation(const dart::Class& klass);
+
+  // Whether instances of this klass should be allocated in old space.
+  static bool IsPretenured(const dart::Class& klass);
 };
 
 class Instance : public AllStatic {
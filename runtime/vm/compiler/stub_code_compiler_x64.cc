@@ -1959,6 +1959,7 @@ void StubCodeCompiler::GenerateAllocationStubForClass(
   // Load the appropriate generic alloc. stub.
   if (!FLAG_use_slow_path && FLAG_inline_alloc &&
       !target::Class::TraceAllocation(cls) &&
+      !target::Class::IsPretenured(cls) &&
       target::SizeFitsInSizeTag(instance_size)) {
     if (is_cls_parameterized) {
       // TODO(41974): Assign all allocation stubs to the root loading unit?
@@ -8,6 +8,10 @@
 #include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/write_barrier_elimination.h"
 
+#if defined(DART_PRECOMPILER)
+#include "vm/compiler/aot/precompiler.h"
+#endif
+
 namespace dart {
 
 #if defined(DEBUG)
@@ -68,6 +72,14 @@ typedef DirectChainedHashMap<DefinitionIndexPairTrait> DefinitionIndexMap;
 // buffer. Additionally, if concurrent marking was initiated, the runtime
 // ensures that all live temporaries are also in the deferred marking stack.
 //
+// Arrays are only added to the store buffer by the runtime if they are short
+// (see Array::kMaxLengthForWriteBarrierElimination), so longer arrays are no
+// longer usable after any instruction which can trigger GC.
+//
+// In AOT, calls to functions whose code is known to neither trigger GC nor
+// call other Dart code (see Precompiler::CannotTriggerGC()) don't interrupt
+// write barrier elimination either.
+//
 // See also Thread::RememberLiveTemporaries() and
 // Thread::DeferredMarkLiveTemporaries().
 class WriteBarrierElimination : public ValueObject {
@@ -99,6 +111,18 @@ class WriteBarrierElimination : public ValueObject {
                             def->AsAllocation()->WillAllocateNewOrRemembered());
   }
 
+  // Whether [def] is an array which is not added to the store buffer after a
+  // scavenge.
+  static bool IsLargeArrayAllocation(Definition* def) {
+    CreateArrayInstr* const create_array = def->AsCreateArray();
+    return (create_array != nullptr) &&
+           !compiler::target::WillRememberLiveTemporaryArray(
+               create_array->GetConstantNumElements());
+  }
+
+  // Whether [instr] is a call which is known to not trigger GC.
+  static bool IsCallWithoutGC(Instruction* instr);
+
 #if defined(DEBUG)
   static bool SlotEligibleForWBE(const Slot& slot);
 #endif
@@ -112,8 +136,9 @@ class WriteBarrierElimination : public ValueObject {
   // Maps each usable definition to its index in the bitvectors.
   DefinitionIndexMap definition_indices_;
 
-  // Bitvector with all non-Array-allocation instructions set. Used to
-  // un-mark Array allocations as usable.
+  // Bitvector with all instructions set except the allocations of arrays
+  // which are too large to be added to the store buffer after a scavenge.
+  // Used to un-mark these allocations as usable.
   BitVector* array_allocations_mask_;
 
   // Bitvectors for each block of which allocations are new or remembered
@@ -211,7 +236,7 @@ void WriteBarrierElimination::IndexDefinitions(Zone* zone) {
     for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
       if (Definition* current = it.Current()->AsDefinition()) {
         if (IsUsable(current)) {
-          const bool is_create_array = current->IsCreateArray();
+          const bool is_create_array = IsLargeArrayAllocation(current);
           array_allocations.Set(definition_count_, is_create_array);
           definition_indices_.Insert({current, definition_count_++});
           if (is_create_array) {
@@ -384,11 +409,13 @@ void WriteBarrierElimination::UpdateVectorForBlock(BlockEntryInstr* entry,
       }
     }
 
-    if (current->CanCallDart()) {
+    if (IsCallWithoutGC(current)) {
+      // Nothing is promoted during the call.
+    } else if (current->CanCallDart()) {
       vector_->Clear();
     } else if (current->CanTriggerGC()) {
-      // Clear array allocations. These are not added to the remembered set
-      // by Thread::RememberLiveTemporaries() after a scavenge.
+      // Clear large array allocations. These are not added to the remembered
+      // set by Thread::RememberLiveTemporaries() after a scavenge.
       vector_->Intersect(array_allocations_mask_);
     }
 
@@ -400,6 +427,17 @@ void WriteBarrierElimination::UpdateVectorForBlock(BlockEntryInstr* entry,
   }
 }
 
+bool WriteBarrierElimination::IsCallWithoutGC(Instruction* instr) {
+#if defined(DART_PRECOMPILER)
+  if (StaticCallInstr* call = instr->AsStaticCall()) {
+    Precompiler* const precompiler = Precompiler::Instance();
+    return CompilerState::Current().is_aot() && (precompiler != nullptr) &&
+           precompiler->CannotTriggerGC(call->function());
+  }
+#endif
+  return false;
+}
+
 void EliminateWriteBarriers(FlowGraph* flow_graph) {
   WriteBarrierElimination elimination(Thread::Current()->zone(), flow_graph);
   elimination.Analyze();
@@ -143,9 +143,10 @@ ISOLATE_UNIT_TEST_CASE(IRTest_WriteBarrierElimination_Arrays) {
       SetFlagScope<bool> sfs(&FLAG_trace_write_barrier_elimination, true));
   const char* nullable_tag = TestCase::NullableTag();
 
-  // Test that array allocations are not considered usable after a
-  // may-trigger-GC instruction (in this case CheckStackOverflow), unlike
-  // normal allocations, which are only interruped by a Dart call.
+  // Test that allocations of arrays longer than
+  // Array::kMaxLengthForWriteBarrierElimination are not considered usable
+  // after a may-trigger-GC instruction (in this case CheckStackOverflow),
+  // unlike normal allocations, which are only interruped by a Dart call.
   // clang-format off
   auto kScript =
       Utils::CStringUniquePtr(OS::SCreate(nullptr, R"(
@@ -159,7 +160,7 @@ ISOLATE_UNIT_TEST_CASE(IRTest_WriteBarrierElimination_Arrays) {
       foo(int x) {
         C c = C();
         C n = C();
-        List<C%s> array = List<C%s>.filled(1, null);
+        List<C%s> array = List<C%s>.filled(16, null);
         while (x --> 0) {
           c.next = n;
           n = c;
@@ -207,6 +208,56 @@ ISOLATE_UNIT_TEST_CASE(IRTest_WriteBarrierElimination_Arrays) {
   EXPECT(store_into_array->ShouldEmitStoreBarrier() == true);
 }
 
+ISOLATE_UNIT_TEST_CASE(IRTest_WriteBarrierElimination_SmallArrayFill) {
+  DEBUG_ONLY(
+      SetFlagScope<bool> sfs(&FLAG_trace_write_barrier_elimination, true));
+  const char* nullable_tag = TestCase::NullableTag();
+
+  // Test that short arrays remain usable across may-trigger-GC instructions,
+  // so that filling them in a loop doesn't need write barriers.
+  // clang-format off
+  auto kScript =
+      Utils::CStringUniquePtr(OS::SCreate(nullptr, R"(
+      class C {}
+
+      foo() {
+        List<C%s> array = List<C%s>.filled(4, null);
+        for (int i = 0; i < 4; i++) {
+          array[i] = C();
+        }
+        return array;
+      }
+
+      main() { foo(); }
+      )", nullable_tag, nullable_tag), std::free);
+  // clang-format on
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript.get()));
+
+  Invoke(root_library, "main");
+
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+
+  auto entry = flow_graph->graph_entry()->normal_entry();
+  EXPECT(entry != nullptr);
+
+  StoreIndexedInstr* store_into_array = nullptr;
+
+  ILMatcher cursor(flow_graph, entry);
+  RELEASE_ASSERT(cursor.TryMatch({
+      kMoveGlob,
+      kMatchAndMoveGoto,
+      kMoveGlob,
+      kMatchAndMoveBranchTrue,
+      kMoveGlob,
+      {kMatchAndMoveStoreIndexed, &store_into_array},
+  }));
+
+  EXPECT(store_into_array->ShouldEmitStoreBarrier() == false);
+}
+
 ISOLATE_UNIT_TEST_CASE(IRTest_WriteBarrierElimination_Regress43786) {
   DEBUG_ONLY(
       SetFlagScope<bool> sfs(&FLAG_trace_write_barrier_elimination, true));
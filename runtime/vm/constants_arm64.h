@@ -797,6 +797,7 @@ enum SIMDThreeSameOp {
   VAND = SIMDThreeSameFixed | B30 | B12 | B11,
   VORR = SIMDThreeSameFixed | B30 | B23 | B12 | B11,
   VEOR = SIMDThreeSameFixed | B30 | B29 | B12 | B11,
+  VBSL = SIMDThreeSameFixed | B30 | B29 | B22 | B12 | B11,
   VADDW = SIMDThreeSameFixed | B30 | B23 | B15,
   VADDX = SIMDThreeSameFixed | B30 | B23 | B22 | B15,
   VSUBW = SIMDThreeSameFixed | B30 | B29 | B23 | B15,
@@ -837,6 +838,9 @@ enum SIMDTwoRegOp {
       SIMDTwoRegFixed | B30 | B29 | B23 | B22 | B16 | B15 | B14 | B13 | B12,
   VRECPES = SIMDTwoRegFixed | B30 | B23 | B16 | B15 | B14 | B12,
   VRSQRTES = SIMDTwoRegFixed | B30 | B29 | B23 | B16 | B15 | B14 | B12,
+  // Only the lower halves of the 2S arrangements are used, so Q is 0.
+  VFCVTL = SIMDTwoRegFixed | B22 | B16 | B14 | B13 | B12,
+  VFCVTN = SIMDTwoRegFixed | B22 | B16 | B14 | B13,
 };
 
 // C.3.6.22
@@ -21,6 +21,7 @@
 #include "vm/heap/freelist.h"
 #include "vm/heap/heap.h"
 #include "vm/heap/pointer_block.h"
+#include "vm/heap/shared_heap.h"
 #include "vm/isolate.h"
 #include "vm/isolate_reload.h"
 #include "vm/kernel_isolate.h"
@@ -43,6 +44,7 @@
 #include "vm/thread_interrupter.h"
 #include "vm/thread_pool.h"
 #include "vm/timeline.h"
+#include "vm/transferable_buffer_pool.h"
 #include "vm/virtual_memory.h"
 #include "vm/zone.h"
 
@@ -234,6 +236,7 @@ char* Dart::Init(const uint8_t* vm_isolate_snapshot,
   VirtualMemory::Init();
   OSThread::Init();
   Zone::Init();
+  VMHandles::InitBlockCache();
 #if defined(SUPPORT_TIMELINE)
   Timeline::Init();
   TimelineBeginEndScope tbes(Timeline::GetVMStream(), "Dart::Init");
@@ -247,9 +250,12 @@ char* Dart::Init(const uint8_t* vm_isolate_snapshot,
   NativeSymbolResolver::Init();
   NOT_IN_PRODUCT(Profiler::Init());
   SemiSpace::Init();
+  OldPage::Init();
+  TransferableBufferPool::Init();
   NOT_IN_PRODUCT(Metric::Init());
   StoreBuffer::Init();
   MarkingStack::Init();
+  SharedHeap::Init();
 
 #if defined(USING_SIMULATOR)
   Simulator::Init();
@@ -636,10 +642,13 @@ char* Dart::Cleanup() {
   SubtypeTestCache::Cleanup();
   ArgumentsDescriptor::Cleanup();
   TargetCPUFeatures::Cleanup();
+  SharedHeap::Cleanup();
   MarkingStack::Cleanup();
   StoreBuffer::Cleanup();
   Object::Cleanup();
   SemiSpace::Cleanup();
+  OldPage::Cleanup();
+  TransferableBufferPool::Cleanup();
   StubCode::Cleanup();
 #if defined(SUPPORT_TIMELINE)
   if (FLAG_trace_shutdown) {
@@ -648,6 +657,7 @@ char* Dart::Cleanup() {
   }
   Timeline::Cleanup();
 #endif
+  VMHandles::CleanupBlockCache();
   Zone::Cleanup();
   // Delete the current thread's TLS and set it's TLS to null.
   // If it is the last thread then the destructor would call
@@ -13,6 +13,7 @@
 #include "platform/unicode.h"
 #include "vm/class_finalizer.h"
 #include "vm/clustered_snapshot.h"
+#include "vm/code_coverage.h"
 #include "vm/compilation_trace.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/dart.h"
@@ -26,6 +27,8 @@
 #include "vm/exceptions.h"
 #include "vm/flags.h"
 #include "vm/growable_array.h"
+#include "vm/heap/memory_pressure.h"
+#include "vm/heap/shared_heap.h"
 #include "vm/heap/verifier.h"
 #include "vm/image_snapshot.h"
 #include "vm/isolate_reload.h"
@@ -81,6 +84,11 @@ DEFINE_FLAG(bool,
             dump_tables,
             false,
             "Dump common hash tables before snapshotting.");
+DEFINE_FLAG(bool,
+            app_jit_optimize_queued_functions,
+            true,
+            "Optimize functions still waiting for background compilation "
+            "before writing an app-JIT snapshot.");
 
 #define CHECK_ERROR_HANDLE(error)                                              \
   {                                                                            \
@@ -717,6 +725,14 @@ void FinalizablePersistentHandle::Finalize(
   ApiState* state = isolate_group->api_state();
   ASSERT(state != NULL);
 
+  if (handle->finalizer_deferred()) {
+    // The callback runs after the GC without access to the handle, so the
+    // handle is deleted here regardless of auto_delete.
+    state->FreeWeakPersistentHandle(handle);
+    state->DeferFinalizer(callback, isolate_group->embedder_data(), peer);
+    return;
+  }
+
   if (!handle->auto_delete()) {
     // Clear handle before running finalizer, finalizer can free the handle.
     state->ClearWeakPersistentHandle(handle);
@@ -1098,6 +1114,32 @@ DART_EXPORT void Dart_UpdateFinalizableExternalSize(
   ::Dart_UpdateExternalSize(wph_object, external_allocation_size);
 }
 
+DART_EXPORT void Dart_DeferWeakPersistentHandleFinalizer(
+    Dart_WeakPersistentHandle object) {
+  IsolateGroup* isolate_group = IsolateGroup::Current();
+  CHECK_ISOLATE_GROUP(isolate_group);
+  NoSafepointScope no_safepoint_scope;
+  ApiState* state = isolate_group->api_state();
+  ASSERT(state != NULL);
+  ASSERT(state->IsActiveWeakPersistentHandle(object));
+  auto weak_ref = FinalizablePersistentHandle::Cast(object);
+  weak_ref->SetFinalizerDeferred();
+}
+
+DART_EXPORT void Dart_DeferFinalizableHandleFinalizer(
+    Dart_FinalizableHandle object,
+    Dart_Handle strong_ref_to_object) {
+  if (!::Dart_IdentityEquals(strong_ref_to_object,
+                             HandleFromFinalizable(object))) {
+    FATAL1(
+        "%s expects arguments 'object' and 'strong_ref_to_object' to point to "
+        "the same object.",
+        CURRENT_FUNC);
+  }
+  auto wph_object = reinterpret_cast<Dart_WeakPersistentHandle>(object);
+  ::Dart_DeferWeakPersistentHandleFinalizer(wph_object);
+}
+
 DART_EXPORT void Dart_DeletePersistentHandle(Dart_PersistentHandle object) {
   IsolateGroup* isolate_group = IsolateGroup::Current();
   CHECK_ISOLATE_GROUP(isolate_group);
@@ -1511,6 +1553,36 @@ DART_EXPORT void* Dart_IsolateGroupData(Dart_Isolate isolate) {
   return reinterpret_cast<Isolate*>(isolate)->group()->embedder_data();
 }
 
+DART_EXPORT Dart_Handle Dart_PublishSharedImmutable(const char* name,
+                                                    Dart_Handle object) {
+  DARTSCOPE(Thread::Current());
+  if (name == NULL) {
+    RETURN_NULL_ERROR(name);
+  }
+  const Object& obj = Object::Handle(Z, Api::UnwrapHandle(object));
+  if (obj.IsError()) {
+    return object;
+  }
+  const char* error = NULL;
+  const Object& copy = Object::Handle(Z, SharedHeap::Copy(T, obj, &error));
+  if (error != NULL) {
+    return Api::NewError("%s: %s", CURRENT_FUNC, error);
+  }
+  if (!SharedHeap::Publish(name, copy.raw())) {
+    return Api::NewError("%s: '%s' is already published.", CURRENT_FUNC,
+                         name);
+  }
+  return Api::NewHandle(T, copy.raw());
+}
+
+DART_EXPORT Dart_Handle Dart_LookupSharedImmutable(const char* name) {
+  DARTSCOPE(Thread::Current());
+  if (name == NULL) {
+    RETURN_NULL_ERROR(name);
+  }
+  return Api::NewHandle(T, SharedHeap::Lookup(name));
+}
+
 DART_EXPORT Dart_Handle Dart_DebugName() {
   DARTSCOPE(Thread::Current());
   Isolate* I = T->isolate();
@@ -1632,6 +1704,104 @@ DART_EXPORT bool Dart_WriteProfileToTimeline(Dart_Port main_port,
 #endif
 }
 
+DART_EXPORT bool Dart_GetProfileFoldedStacks(int64_t time_origin_micros,
+                                             int64_t time_extent_micros,
+                                             char** profile,
+                                             intptr_t* profile_length,
+                                             char** error) {
+#if defined(PRODUCT)
+  if (error != NULL) {
+    *error = Utils::StrDup("Profiling is not supported in PRODUCT builds.");
+  }
+  return false;
+#else
+  CHECK_ISOLATE(Isolate::Current());
+  if ((profile == NULL) || (profile_length == NULL)) {
+    if (error != NULL) {
+      *error = Utils::StrDup("profile and profile_length must not be NULL.");
+    }
+    return false;
+  }
+  if (!FLAG_profiler || (Profiler::sample_buffer() == NULL)) {
+    if (error != NULL) {
+      *error = Utils::StrDup("The profiler is not running.");
+    }
+    return false;
+  }
+  TextBuffer buffer(1 * KB);
+  {
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    ProfilerService::PrintFoldedStacks(&buffer, time_origin_micros,
+                                       time_extent_micros);
+  }
+  *profile_length = buffer.length();
+  *profile = buffer.Steal();
+  return true;
+#endif
+}
+
+DART_EXPORT bool Dart_GetHeapSampleFoldedStacks(char** profile,
+                                                intptr_t* profile_length,
+                                                char** error) {
+#if defined(PRODUCT)
+  if (error != NULL) {
+    *error = Utils::StrDup("Heap sampling is not supported in PRODUCT builds.");
+  }
+  return false;
+#else
+  CHECK_ISOLATE(Isolate::Current());
+  if ((profile == NULL) || (profile_length == NULL)) {
+    if (error != NULL) {
+      *error = Utils::StrDup("profile and profile_length must not be NULL.");
+    }
+    return false;
+  }
+  if (!HeapSampler::IsEnabled()) {
+    if (error != NULL) {
+      *error = Utils::StrDup("Heap sampling is not enabled.");
+    }
+    return false;
+  }
+  TextBuffer buffer(1 * KB);
+  {
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    thread->heap()->sampler()->PrintLiveFoldedStacks(thread, &buffer);
+  }
+  *profile_length = buffer.length();
+  *profile = buffer.Steal();
+  return true;
+#endif
+}
+
+DART_EXPORT bool Dart_GetCodeCoverage(char** coverage,
+                                      intptr_t* coverage_length,
+                                      char** error) {
+  CHECK_ISOLATE(Isolate::Current());
+  if ((coverage == NULL) || (coverage_length == NULL)) {
+    if (error != NULL) {
+      *error = Utils::StrDup("coverage and coverage_length must not be NULL.");
+    }
+    return false;
+  }
+  if (!CodeCoverage::IsEnabled()) {
+    if (error != NULL) {
+      *error = Utils::StrDup("Code coverage is not enabled.");
+    }
+    return false;
+  }
+  TextBuffer buffer(1 * KB);
+  {
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    CodeCoverage::Print(thread, &buffer);
+  }
+  *coverage_length = buffer.length();
+  *coverage = buffer.Steal();
+  return true;
+}
+
 DART_EXPORT bool Dart_ShouldPauseOnStart() {
 #if defined(PRODUCT)
   return false;
@@ -1801,6 +1971,11 @@ DART_EXPORT void Dart_NotifyLowMemory() {
   Isolate::NotifyLowMemory();
 }
 
+DART_EXPORT void Dart_SetMemoryPressureCallback(
+    Dart_MemoryPressureCallback callback) {
+  MemoryPressure::set_callback(callback);
+}
+
 DART_EXPORT void Dart_ExitIsolate() {
   Thread* T = Thread::Current();
   CHECK_ISOLATE(T->isolate());
@@ -2972,6 +3147,44 @@ DART_EXPORT Dart_Handle Dart_StringToUTF8(Dart_Handle str,
   return Api::Success();
 }
 
+DART_EXPORT Dart_Handle Dart_StringUTF8Length(Dart_Handle str,
+                                              intptr_t* length) {
+  DARTSCOPE(Thread::Current());
+  API_TIMELINE_DURATION(T);
+  if (length == NULL) {
+    RETURN_NULL_ERROR(length);
+  }
+  const String& str_obj = Api::UnwrapStringHandle(Z, str);
+  if (str_obj.IsNull()) {
+    RETURN_TYPE_ERROR(Z, str, String);
+  }
+  *length = Utf8::Length(str_obj);
+  return Api::Success();
+}
+
+DART_EXPORT Dart_Handle Dart_CopyUTF8EncodingOfString(Dart_Handle str,
+                                                      uint8_t* utf8_array,
+                                                      intptr_t length) {
+  DARTSCOPE(Thread::Current());
+  API_TIMELINE_DURATION(T);
+  if (utf8_array == NULL) {
+    RETURN_NULL_ERROR(utf8_array);
+  }
+  const String& str_obj = Api::UnwrapStringHandle(Z, str);
+  if (str_obj.IsNull()) {
+    RETURN_TYPE_ERROR(Z, str, String);
+  }
+  const intptr_t str_len = Utf8::Length(str_obj);
+  if (length < str_len) {
+    return Api::NewError(
+        "%s expects argument 'length' to be at least the UTF-8 length of the "
+        "string (%" Pd ").",
+        CURRENT_FUNC, str_len);
+  }
+  str_obj.ToUTF8(utf8_array, str_len);
+  return Api::Success();
+}
+
 DART_EXPORT Dart_Handle Dart_StringToLatin1(Dart_Handle str,
                                             uint8_t* latin1_array,
                                             intptr_t* length) {
@@ -3124,6 +3337,43 @@ DART_EXPORT Dart_Handle Dart_NewListOfType(Dart_Handle element_type,
   return Api::NewHandle(T, Array::New(length, type));
 }
 
+DART_EXPORT Dart_Handle
+Dart_NewListOfStringsFromUTF8(const uint8_t* const* utf8_arrays,
+                              const intptr_t* lengths,
+                              intptr_t count) {
+  DARTSCOPE(Thread::Current());
+  API_TIMELINE_DURATION(T);
+  CHECK_LENGTH(count, Array::kMaxElements);
+  if ((utf8_arrays == NULL) && (count != 0)) {
+    RETURN_NULL_ERROR(utf8_arrays);
+  }
+  if ((lengths == NULL) && (count != 0)) {
+    RETURN_NULL_ERROR(lengths);
+  }
+  for (intptr_t i = 0; i < count; i++) {
+    if ((utf8_arrays[i] == NULL) && (lengths[i] != 0)) {
+      return Api::NewError("%s expects argument 'utf8_arrays' to not contain "
+                           "null at index %" Pd ".",
+                           CURRENT_FUNC, i);
+    }
+    CHECK_LENGTH(lengths[i], String::kMaxElements);
+    if (!Utf8::IsValid(utf8_arrays[i], lengths[i])) {
+      return Api::NewError("%s expects argument 'utf8_arrays' to contain "
+                           "valid UTF-8 at index %" Pd ".",
+                           CURRENT_FUNC, i);
+    }
+  }
+  CHECK_CALLBACK_STATE(T);
+  const Array& list =
+      Array::Handle(Z, Array::New(count, Type::Handle(Z, Type::StringType())));
+  String& str = String::Handle(Z);
+  for (intptr_t i = 0; i < count; i++) {
+    str = String::FromUTF8(utf8_arrays[i], lengths[i]);
+    list.SetAt(i, str);
+  }
+  return Api::NewHandle(T, list.raw());
+}
+
 DART_EXPORT Dart_Handle Dart_NewListOfTypeFilled(Dart_Handle element_type,
                                                  Dart_Handle fill_object,
                                                  intptr_t length) {
@@ -4127,6 +4377,22 @@ class AcquiredData {
   DISALLOW_COPY_AND_ASSIGN(AcquiredData);
 };
 
+// Whether the elements of a typed data object or view live outside the heap.
+static bool IsExternalTypedDataBacked(Zone* zone,
+                                      Dart_Handle object,
+                                      intptr_t class_id) {
+  if (IsExternalTypedDataClassId(class_id)) {
+    return true;
+  }
+  if (IsTypedDataViewClassId(class_id)) {
+    const auto& view_obj = Api::UnwrapTypedDataViewHandle(zone, object);
+    ASSERT(!view_obj.IsNull());
+    const auto& obj = Instance::Handle(zone, view_obj.typed_data());
+    return ExternalTypedData::IsExternalTypedData(obj);
+  }
+  return false;
+}
+
 DART_EXPORT Dart_Handle Dart_TypedDataAcquireData(Dart_Handle object,
                                                   Dart_TypedData_Type* type,
                                                   void** data,
@@ -4153,7 +4419,6 @@ DART_EXPORT Dart_Handle Dart_TypedDataAcquireData(Dart_Handle object,
   intptr_t size_in_bytes = 0;
   void* data_tmp = NULL;
   bool external = false;
-  T->IncrementNoSafepointScopeDepth();
   START_NO_CALLBACK_SCOPE(T);
   if (IsExternalTypedDataClassId(class_id)) {
     const ExternalTypedData& obj =
@@ -4190,6 +4455,12 @@ DART_EXPORT Dart_Handle Dart_TypedDataAcquireData(Dart_Handle object,
       external = true;
     }
   }
+  // Data inside the heap may be moved by the GC, which must wait for the
+  // release. External data stays in place while the object is reachable
+  // from the caller's handle, so it does not hold up safepoints.
+  if (!external) {
+    T->IncrementNoSafepointScopeDepth();
+  }
   if (FLAG_verify_acquired_data) {
     if (external) {
       ASSERT(!I->heap()->Contains(reinterpret_cast<uword>(data_tmp)));
@@ -4222,7 +4493,9 @@ DART_EXPORT Dart_Handle Dart_TypedDataReleaseData(Dart_Handle object) {
       !IsTypedDataViewClassId(class_id) && !IsTypedDataClassId(class_id)) {
     RETURN_TYPE_ERROR(Z, object, 'TypedData');
   }
-  T->DecrementNoSafepointScopeDepth();
+  if (!IsExternalTypedDataBacked(Z, object, class_id)) {
+    T->DecrementNoSafepointScopeDepth();
+  }
   END_NO_CALLBACK_SCOPE(T);
   if (FLAG_verify_acquired_data) {
     const Object& obj = Object::Handle(Z, Api::UnwrapHandle(object));
@@ -5926,6 +6199,9 @@ static Dart_Handle DeferredLoadComplete(intptr_t loading_unit_id,
   if (unit.loaded()) {
     return Api::NewError("Unit already loaded");
   }
+  if (error && !unit.load_outstanding()) {
+    return Api::NewError("No load outstanding for unit");
+  }
 
   if (error) {
     CHECK_NULL(error_message);
@@ -5937,6 +6213,13 @@ static Dart_Handle DeferredLoadComplete(intptr_t loading_unit_id,
     TimelineBeginEndScope tbes(T, Timeline::GetIsolateStream(),
                                "ReadUnitSnapshot");
 #endif  // defined(SUPPORT_TIMELINE)
+    // A prefetched unit may arrive before its parent, whose objects it refers
+    // to.
+    const LoadingUnit& parent = LoadingUnit::Handle(unit.parent());
+    if (!parent.IsNull() && (parent.id() != LoadingUnit::kRootId) &&
+        !parent.loaded()) {
+      return Api::NewError("Parent unit not loaded");
+    }
     const Snapshot* snapshot = Snapshot::SetupFromBuffer(snapshot_data);
     if (snapshot == NULL) {
       return Api::NewError("Invalid snapshot");
@@ -6277,6 +6560,18 @@ DART_EXPORT void Dart_SetGCEventCallback(Dart_GCEventCallback callback) {
   Dart::set_gc_event_callback(callback);
 }
 
+DART_EXPORT void Dart_GetGCStatistics(Dart_Isolate isolate,
+                                      Dart_GCStatistics* stats) {
+  if (isolate == nullptr) {
+    FATAL1("%s expects argument 'isolate' to be non-null.", CURRENT_FUNC);
+  }
+  if (stats == nullptr) {
+    FATAL1("%s expects argument 'stats' to be non-null.", CURRENT_FUNC);
+  }
+  Isolate* iso = reinterpret_cast<Isolate*>(isolate);
+  iso->group()->heap()->GetGCStatistics(stats);
+}
+
 DART_EXPORT char* Dart_SetFileModifiedCallback(
     Dart_FileModifiedCallback file_modified_callback) {
 #if !defined(PRODUCT)
@@ -6837,6 +7132,23 @@ DART_EXPORT Dart_Handle Dart_LoadingUnitLibraryUris(intptr_t loading_unit_id) {
 #endif
 }
 
+DART_EXPORT Dart_Handle Dart_LoadingUnitParent(intptr_t loading_unit_id) {
+  DARTSCOPE(Thread::Current());
+  API_TIMELINE_DURATION(T);
+
+  const Array& loading_units =
+      Array::Handle(Z, T->isolate()->object_store()->loading_units());
+  if (loading_units.IsNull() || (loading_unit_id < LoadingUnit::kRootId) ||
+      (loading_unit_id >= loading_units.Length())) {
+    return Api::NewError("Invalid loading unit");
+  }
+  LoadingUnit& unit = LoadingUnit::Handle(Z);
+  unit ^= loading_units.At(loading_unit_id);
+  unit = unit.parent();
+  return Api::NewHandle(
+      T, Integer::New(unit.IsNull() ? LoadingUnit::kIllegalId : unit.id()));
+}
+
 #if (!defined(TARGET_ARCH_IA32) && !defined(DART_PRECOMPILED_RUNTIME))
 
 // Any flag that affects how we compile code might cause a problem when the
@@ -6951,6 +7263,54 @@ DART_EXPORT Dart_Handle Dart_CreateCoreJITSnapshotAsBlobs(
 }
 
 #if !defined(TARGET_ARCH_IA32) && !defined(DART_PRECOMPILED_RUNTIME)
+// Functions that became hot late in the training run may still be waiting in
+// the background compiler's queue, which BackgroundCompiler::Stop discards.
+// They are optimized here so that the snapshot carries their optimized code.
+static ErrorPtr OptimizeQueuedFunctions(Thread* thread) {
+  class QueuedFunctionsCollector : public FunctionVisitor {
+   public:
+    QueuedFunctionsCollector(Zone* zone,
+                             GrowableArray<const Function*>* functions)
+        : zone_(zone), functions_(functions) {}
+
+    void VisitFunction(const Function& function) {
+      if (!function.HasCode() || function.HasOptimizedCode() ||
+          !function.IsOptimizable()) {
+        return;
+      }
+      // The usage counter of a queued function is parked at INT32_MIN.
+      const intptr_t usage = function.usage_counter();
+      if ((usage >= 0) && (usage < FLAG_optimization_counter_threshold)) {
+        return;
+      }
+      functions_->Add(&Function::ZoneHandle(zone_, function.raw()));
+    }
+
+   private:
+    Zone* const zone_;
+    GrowableArray<const Function*>* const functions_;
+  };
+
+  Zone* zone = thread->zone();
+  GrowableArray<const Function*> functions;
+  QueuedFunctionsCollector collector(zone, &functions);
+  ProgramVisitor::WalkProgram(zone, thread->isolate(), &collector);
+
+  Object& result = Object::Handle(zone);
+  for (intptr_t i = 0; i < functions.length(); i++) {
+    const Function& function = *functions[i];
+    if (!Compiler::CanOptimizeFunction(thread, function)) {
+      continue;
+    }
+    function.SetUsageCounter(0);
+    result = Compiler::CompileOptimizedFunction(thread, function);
+    if (result.IsError()) {
+      return Error::Cast(result).raw();
+    }
+  }
+  return Error::null();
+}
+
 static void KillNonMainIsolatesSlow(Thread* thread, Isolate* main_isolate) {
   auto group = main_isolate->group();
   while (true) {
@@ -7000,6 +7360,9 @@ Dart_CreateAppJITSnapshotAsBlobs(uint8_t** isolate_snapshot_data_buffer,
   KillNonMainIsolatesSlow(T, I);
 
   BackgroundCompiler::Stop(I);
+  if (FLAG_app_jit_optimize_queued_functions) {
+    CHECK_ERROR_HANDLE(OptimizeQueuedFunctions(T));
+  }
   DropRegExpMatchCode(Z);
 
   ProgramVisitor::Dedup(T);
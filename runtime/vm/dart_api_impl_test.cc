@@ -1531,6 +1531,78 @@ TEST_CASE(DartAPI_NewString) {
   EXPECT(Dart_IsError(invalid_str));
 }
 
+TEST_CASE(DartAPI_NewListOfStringsFromUTF8) {
+  const uint8_t ascii[] = {'o', 'n', 'e'};
+  const uint8_t two_byte[] = {0xE4, 0xBA, 0x8C};  // U+4E8C.
+  const uint8_t* utf8_arrays[] = {ascii, two_byte, NULL};
+  const intptr_t lengths[] = {ARRAY_SIZE(ascii), ARRAY_SIZE(two_byte), 0};
+
+  Dart_Handle list = Dart_NewListOfStringsFromUTF8(utf8_arrays, lengths, 3);
+  EXPECT_VALID(list);
+  EXPECT(Dart_IsList(list));
+  intptr_t length = 0;
+  EXPECT_VALID(Dart_ListLength(list, &length));
+  EXPECT_EQ(3, length);
+  for (intptr_t i = 0; i < length; i++) {
+    Dart_Handle element = Dart_ListGetAt(list, i);
+    EXPECT_VALID(element);
+    EXPECT(Dart_IsString(element));
+    uint8_t* utf8 = NULL;
+    intptr_t utf8_length = 0;
+    EXPECT_VALID(Dart_StringToUTF8(element, &utf8, &utf8_length));
+    EXPECT_EQ(lengths[i], utf8_length);
+    EXPECT(memcmp(utf8_arrays[i], utf8, utf8_length) == 0);
+  }
+
+  list = Dart_NewListOfStringsFromUTF8(NULL, NULL, 0);
+  EXPECT_VALID(list);
+  EXPECT_VALID(Dart_ListLength(list, &length));
+  EXPECT_EQ(0, length);
+
+  const uint8_t invalid[] = {0xE4, 0xBA};  // Underflow.
+  const uint8_t* invalid_arrays[] = {ascii, invalid};
+  const intptr_t invalid_lengths[] = {ARRAY_SIZE(ascii), ARRAY_SIZE(invalid)};
+  EXPECT_ERROR(
+      Dart_NewListOfStringsFromUTF8(invalid_arrays, invalid_lengths, 2),
+      "Dart_NewListOfStringsFromUTF8 expects argument 'utf8_arrays' to "
+      "contain valid UTF-8 at index 1.");
+}
+
+TEST_CASE(DartAPI_CopyUTF8EncodingOfString) {
+  const char* kScriptChars =
+      "String lowSurrogate() => '\\u{1D11E}'[1];\n"
+      "String mixed() => 'a\\u00E9\\u4E8C';\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+
+  Dart_Handle mixed = Dart_Invoke(lib, NewString("mixed"), 0, NULL);
+  EXPECT_VALID(mixed);
+  intptr_t length = 0;
+  EXPECT_VALID(Dart_StringUTF8Length(mixed, &length));
+  EXPECT_EQ(1 + 2 + 3, length);
+  uint8_t buffer[8];
+  memset(buffer, 0xFF, sizeof(buffer));
+  EXPECT_VALID(Dart_CopyUTF8EncodingOfString(mixed, buffer, length));
+  const uint8_t expected[] = {'a', 0xC3, 0xA9, 0xE4, 0xBA, 0x8C};
+  EXPECT(memcmp(expected, buffer, ARRAY_SIZE(expected)) == 0);
+  EXPECT_EQ(0xFF, buffer[length]);
+
+  EXPECT_ERROR(Dart_CopyUTF8EncodingOfString(mixed, buffer, length - 1),
+               "expects argument 'length' to be at least the UTF-8 length");
+
+  // Unpaired surrogates become replacement characters.
+  Dart_Handle surrogate = Dart_Invoke(lib, NewString("lowSurrogate"), 0, NULL);
+  EXPECT_VALID(surrogate);
+  EXPECT_VALID(Dart_StringUTF8Length(surrogate, &length));
+  EXPECT_EQ(3, length);
+  EXPECT_VALID(Dart_CopyUTF8EncodingOfString(surrogate, buffer, length));
+  EXPECT_EQ(0xEF, buffer[0]);
+  EXPECT_EQ(0xBF, buffer[1]);
+  EXPECT_EQ(0xBD, buffer[2]);
+
+  EXPECT_ERROR(Dart_CopyUTF8EncodingOfString(Dart_Null(), buffer, 8),
+               "expects argument 'str' to be non-null");
+}
+
 TEST_CASE(DartAPI_MalformedStringToUTF8) {
   // 1D11E = treble clef
   // [0] should be high surrogate D834
@@ -2317,6 +2389,43 @@ TEST_CASE(DartAPI_ExternalByteDataFinalizer) {
   EXPECT(byte_data_finalizer_run);
 }
 
+TEST_CASE(DartAPI_ExternalTypedDataAcquireAllowsGC) {
+  uint8_t data[] = {1, 2, 3, 4};
+  Dart_Handle array = Dart_NewExternalTypedData(Dart_TypedData_kUint8, data,
+                                                ARRAY_SIZE(data));
+  EXPECT_VALID(array);
+
+  Dart_TypedData_Type type;
+  void* acquired = NULL;
+  intptr_t length = 0;
+  EXPECT_VALID(Dart_TypedDataAcquireData(array, &type, &acquired, &length));
+  EXPECT_EQ(Dart_TypedData_kUint8, type);
+  EXPECT_EQ(static_cast<intptr_t>(ARRAY_SIZE(data)), length);
+  if (!FLAG_verify_acquired_data) {
+    EXPECT_EQ(data, acquired);
+  }
+
+  // External data does not move, so holding it does not block the GC.
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT_EQ(0, thread->no_safepoint_scope_depth());
+    GCTestHelper::CollectAllGarbage();
+  }
+
+  EXPECT_EQ(3, reinterpret_cast<uint8_t*>(acquired)[2]);
+  EXPECT_VALID(Dart_TypedDataReleaseData(array));
+
+  // Data in the heap still blocks it until the release.
+  Dart_Handle internal = Dart_NewTypedData(Dart_TypedData_kUint8, 4);
+  EXPECT_VALID(internal);
+  EXPECT_VALID(Dart_TypedDataAcquireData(internal, &type, &acquired, &length));
+#if defined(DEBUG)
+  EXPECT_EQ(1, thread->no_safepoint_scope_depth());
+#endif
+  EXPECT_VALID(Dart_TypedDataReleaseData(internal));
+  EXPECT_EQ(0, thread->no_safepoint_scope_depth());
+}
+
 #ifndef PRODUCT
 
 static const intptr_t kOptExtLength = 16;
@@ -3524,6 +3633,47 @@ TEST_CASE(DartAPI_FinalizableHandleCallback) {
   }
 }
 
+static RelaxedAtomic<intptr_t> deferred_finalizer_count = 0;
+
+static void DeferredFinalizer(void* isolate_callback_data, void* peer) {
+  deferred_finalizer_count.fetch_add(reinterpret_cast<intptr_t>(peer));
+}
+
+TEST_CASE(DartAPI_DeferredFinalizers) {
+  // Enough handles to fill several handle blocks.
+  const intptr_t kNumHandles = 1000;
+  deferred_finalizer_count = 0;
+  int peer = 0;
+  {
+    Dart_EnterScope();
+    for (intptr_t i = 0; i < kNumHandles; i++) {
+      Dart_Handle obj = NewString("new string");
+      EXPECT_VALID(obj);
+      if ((i % 2) == 0) {
+        Dart_FinalizableHandle ref = Dart_NewFinalizableHandle(
+            obj, reinterpret_cast<void*>(1), 0, DeferredFinalizer);
+        Dart_DeferFinalizableHandleFinalizer(ref, obj);
+      } else {
+        Dart_WeakPersistentHandle ref = Dart_NewWeakPersistentHandle(
+            obj, reinterpret_cast<void*>(1), 0, DeferredFinalizer);
+        Dart_DeferWeakPersistentHandleFinalizer(ref);
+      }
+    }
+    Dart_Handle obj = NewString("new string");
+    EXPECT_VALID(obj);
+    Dart_NewFinalizableHandle(obj, &peer, 0, FinalizableHandlePeerFinalizer);
+    Dart_ExitScope();
+  }
+  {
+    TransitionNativeToVM transition(thread);
+    GCTestHelper::CollectNewSpace();
+    // Finalizers that were not deferred still run during the GC.
+    EXPECT(peer == 42);
+    thread->isolate_group()->api_state()->WaitForDeferredFinalizers();
+    EXPECT_EQ(kNumHandles, deferred_finalizer_count.load());
+  }
+}
+
 TEST_CASE(DartAPI_WeakPersistentHandleNoCallback) {
   Dart_WeakPersistentHandle weak_ref = NULL;
   int peer = 0;
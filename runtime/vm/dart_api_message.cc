@@ -498,18 +498,24 @@ Dart_CObject* ApiMessageReader::ReadInternalVMObject(intptr_t class_id,
     }
     case kOneByteStringCid: {
       intptr_t len = ReadSmiValue();
-      uint8_t* latin1 =
-          reinterpret_cast<uint8_t*>(allocator(len * sizeof(uint8_t)));
+      // The characters are encoded as raw bytes, so they are read in place.
+      const uint8_t* latin1 = CurrentBufferAddress();
+      Advance(len);
       intptr_t utf8_len = 0;
       for (intptr_t i = 0; i < len; i++) {
-        latin1[i] = Read<uint8_t>();
         utf8_len += Utf8::Length(latin1[i]);
       }
       Dart_CObject* object = AllocateDartCObjectString(utf8_len);
       AddBackRef(object_id, object, kIsDeserialized);
       char* p = object->value.as_string;
-      for (intptr_t i = 0; i < len; i++) {
-        p += Utf8::Encode(latin1[i], p);
+      if (utf8_len == len) {
+        // An ASCII string is its own UTF-8 encoding.
+        memmove(p, latin1, len);
+        p += len;
+      } else {
+        for (intptr_t i = 0; i < len; i++) {
+          p += Utf8::Encode(latin1[i], p);
+        }
       }
       *p = '\0';
       ASSERT(p == (object->value.as_string + utf8_len));
@@ -575,7 +581,10 @@ Dart_CObject* ApiMessageReader::ReadInternalVMObject(intptr_t class_id,
     object->type = Dart_CObject_kTypedData;                                    \
     object->value.as_typed_data.type = type;                                   \
     object->value.as_typed_data.length = length_in_bytes;                      \
-    if (len > 0) {                                                             \
+    if (Read<bool>()) {                                                        \
+      object->value.as_typed_data.values =                                     \
+          reinterpret_cast<uint8_t*>(finalizable_data_->Get().data);           \
+    } else if (len > 0) {                                                      \
       Align(Zone::kAlignment);                                                 \
       object->value.as_typed_data.values =                                     \
           const_cast<uint8_t*>(CurrentBufferAddress());                        \
@@ -1038,15 +1047,18 @@ bool ApiMessageWriter::WriteCObjectInlined(Dart_CObject* object,
       // Write string length and content.
       WriteSmi(len);
       if (type == Utf8::kLatin1) {
-        uint8_t* latin1_str =
-            reinterpret_cast<uint8_t*>(dart::malloc(len * sizeof(uint8_t)));
-        bool success =
-            Utf8::DecodeToLatin1(utf8_str, utf8_len, latin1_str, len);
-        ASSERT(success);
-        for (intptr_t i = 0; i < len; i++) {
-          Write<uint8_t>(latin1_str[i]);
+        if (len == utf8_len) {
+          // An ASCII string is its own Latin-1 encoding.
+          WriteBytes(utf8_str, len);
+        } else {
+          uint8_t* latin1_str =
+              reinterpret_cast<uint8_t*>(dart::malloc(len * sizeof(uint8_t)));
+          bool success =
+              Utf8::DecodeToLatin1(utf8_str, utf8_len, latin1_str, len);
+          ASSERT(success);
+          WriteBytes(latin1_str, len);
+          ::free(latin1_str);
         }
-        ::free(latin1_str);
       } else {
         uint16_t* utf16_str =
             reinterpret_cast<uint16_t*>(dart::malloc(len * sizeof(uint16_t)));
@@ -1087,6 +1099,8 @@ bool ApiMessageWriter::WriteCObjectInlined(Dart_CObject* object,
       WriteIndexedObject(class_id);
       WriteTags(0);
       WriteSmi(len);
+      // The contents are always written into the snapshot.
+      Write<bool>(false);
       switch (class_id) {
         case kTypedDataInt8ArrayCid:
         case kTypedDataUint8ArrayCid: {
@@ -6,6 +6,7 @@
 
 #include "platform/assert.h"
 #include "platform/utils.h"
+#include "vm/dart.h"
 #include "vm/heap/heap.h"
 #include "vm/isolate.h"
 #include "vm/lockers.h"
@@ -16,4 +17,85 @@ namespace dart {
 
 RelaxedAtomic<intptr_t> ApiNativeScope::current_memory_usage_ = 0;
 
+void ApiState::RunPendingFinalizations(IsolateGroup* isolate_group) {
+  // Workers have finished visiting handles; no further handles are added.
+  for (intptr_t i = 0; i < pending_finalizations_.length(); i++) {
+    pending_finalizations_[i]->UpdateUnreachable(isolate_group);
+  }
+  pending_finalizations_.Clear();
+}
+
+void ApiState::DeferFinalizer(Dart_HandleFinalizer callback,
+                              void* isolate_callback_data,
+                              void* peer) {
+  MonitorLocker ml(&deferred_finalizers_monitor_);
+  DeferredFinalizer finalizer = {callback, isolate_callback_data, peer};
+  deferred_finalizers_.Add(finalizer);
+}
+
+class DeferredFinalizerTask : public ThreadPool::Task {
+ public:
+  explicit DeferredFinalizerTask(ApiState* state) : state_(state) {}
+
+  virtual void Run() { state_->RunDeferredFinalizers(); }
+
+ private:
+  ApiState* state_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeferredFinalizerTask);
+};
+
+void ApiState::ScheduleDeferredFinalizers() {
+  {
+    MonitorLocker ml(&deferred_finalizers_monitor_);
+    if (deferred_finalizers_.is_empty() || deferred_finalizers_running_) {
+      return;
+    }
+    deferred_finalizers_running_ = true;
+  }
+  if (!Dart::thread_pool()->Run<DeferredFinalizerTask>(this)) {
+    // The thread pool is shutting down.
+    RunDeferredFinalizers();
+  }
+}
+
+void ApiState::RunDeferredFinalizers() {
+  MallocGrowableArray<DeferredFinalizer> batch;
+  for (;;) {
+    {
+      MonitorLocker ml(&deferred_finalizers_monitor_);
+      if (deferred_finalizers_.is_empty()) {
+        deferred_finalizers_running_ = false;
+        ml.NotifyAll();
+        return;
+      }
+      batch.Clear();
+      for (intptr_t i = 0; i < deferred_finalizers_.length(); i++) {
+        batch.Add(deferred_finalizers_[i]);
+      }
+      deferred_finalizers_.Clear();
+    }
+    // Run the callbacks without holding the lock, so that GCs finding more
+    // unreachable handles are not blocked on them.
+    for (intptr_t i = 0; i < batch.length(); i++) {
+      const DeferredFinalizer& finalizer = batch[i];
+      (*finalizer.callback)(finalizer.isolate_callback_data, finalizer.peer);
+    }
+  }
+}
+
+void ApiState::WaitForDeferredFinalizers() {
+  {
+    MonitorLocker ml(&deferred_finalizers_monitor_);
+    while (deferred_finalizers_running_) {
+      ml.Wait();
+    }
+    if (deferred_finalizers_.is_empty()) {
+      return;
+    }
+    deferred_finalizers_running_ = true;
+  }
+  RunDeferredFinalizers();
+}
+
 }  // namespace dart
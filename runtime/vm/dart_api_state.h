@@ -214,6 +214,12 @@ class FinalizablePersistentHandle {
 
   bool auto_delete() const { return auto_delete_; }
 
+  // Deferred finalizers run on a background thread after the GC that found
+  // the referent unreachable, rather than in the GC pause. The handle is
+  // deleted by the VM before the finalizer runs.
+  bool finalizer_deferred() const { return finalizer_deferred_; }
+  void SetFinalizerDeferred() { finalizer_deferred_ = true; }
+
   bool IsFinalizedNotFreed() const {
     return raw_ == static_cast<ObjectPtr>(reinterpret_cast<uword>(this));
   }
@@ -287,7 +293,12 @@ class FinalizablePersistentHandle {
   friend class FinalizablePersistentHandles;
 
   FinalizablePersistentHandle()
-      : raw_(nullptr), peer_(NULL), external_data_(0), callback_(NULL) {}
+      : raw_(nullptr),
+        peer_(NULL),
+        external_data_(0),
+        callback_(NULL),
+        auto_delete_(false),
+        finalizer_deferred_(false) {}
   ~FinalizablePersistentHandle() {}
 
   static void Finalize(IsolateGroup* isolate_group,
@@ -320,6 +331,7 @@ class FinalizablePersistentHandle {
     external_data_ = 0;
     callback_ = nullptr;
     auto_delete_ = false;
+    finalizer_deferred_ = false;
   }
 
   void set_raw(ObjectPtr raw) { raw_ = raw; }
@@ -362,6 +374,7 @@ class FinalizablePersistentHandle {
   uword external_data_;
   Dart_HandleFinalizer callback_;
   bool auto_delete_;
+  bool finalizer_deferred_;
 
   DISALLOW_ALLOCATION();  // Allocated through AllocateHandle methods.
   DISALLOW_COPY_AND_ASSIGN(FinalizablePersistentHandle);
@@ -544,6 +557,17 @@ class FinalizablePersistentHandles
             kOffsetOfRawPtrInFinalizablePersistentHandle>::Visit(visitor);
   }
 
+  // Visit the handles in one of num_slices disjoint sets of handle blocks.
+  void VisitHandlesSlice(HandleVisitor* visitor,
+                         intptr_t slice,
+                         intptr_t num_slices) {
+    Handles<kFinalizablePersistentHandleSizeInWords,
+            kFinalizablePersistentHandlesPerChunk,
+            kOffsetOfRawPtrInFinalizablePersistentHandle>::VisitSlice(visitor,
+                                                                      slice,
+                                                                      num_slices);
+  }
+
   // Visit all object pointers stored in the various handles.
   void VisitObjectPointers(ObjectPointerVisitor* visitor) {
     visitor->set_gc_root_type("weak persistent handle");
@@ -727,8 +751,12 @@ class ApiState {
         null_(NULL),
         true_(NULL),
         false_(NULL),
-        acquired_error_(NULL) {}
+        acquired_error_(NULL),
+        deferred_finalizers_running_(false) {}
   ~ApiState() {
+    ASSERT(deferred_finalizers_.is_empty());
+    ASSERT(!deferred_finalizers_running_);
+    ASSERT(pending_finalizations_.is_empty());
     if (null_ != NULL) {
       persistent_handles_.FreeHandle(null_);
       null_ = NULL;
@@ -760,6 +788,41 @@ class ApiState {
     weak_persistent_handles_.VisitHandles(visitor);
   }
 
+  // Used by GC workers visiting disjoint slices of the weak handles in
+  // parallel.
+  void VisitWeakHandlesSliceUnlocked(HandleVisitor* visitor,
+                                     intptr_t slice,
+                                     intptr_t num_slices) {
+    weak_persistent_handles_.VisitHandlesSlice(visitor, slice, num_slices);
+  }
+
+  // Embedder finalizers that were not deferred run one at a time, so parallel
+  // GC workers record unreachable handles here and the GC's main thread
+  // finalizes them once the workers are done.
+  void AddPendingFinalization(FinalizablePersistentHandle* handle) {
+    MutexLocker ml(&pending_finalizations_mutex_);
+    pending_finalizations_.Add(handle);
+  }
+  void RunPendingFinalizations(IsolateGroup* isolate_group);
+
+  // Queues the finalizer of an unreachable handle that opted into deferred
+  // finalization. Safe to call from GC workers.
+  void DeferFinalizer(Dart_HandleFinalizer callback,
+                      void* isolate_callback_data,
+                      void* peer);
+
+  // Starts a background task running the queued deferred finalizers, if
+  // there are any and no such task is running yet.
+  void ScheduleDeferredFinalizers();
+
+  // Runs queued deferred finalizers on the current thread until the queue
+  // is empty.
+  void RunDeferredFinalizers();
+
+  // Waits for the background task, then runs the remaining deferred
+  // finalizers. Called before the isolate group is destroyed.
+  void WaitForDeferredFinalizers();
+
   PersistentHandle* AllocatePersistentHandle() {
     MutexLocker ml(&mutex_);
     return persistent_handles_.AllocateHandle();
@@ -860,6 +923,18 @@ class ApiState {
   PersistentHandle* false_;
   PersistentHandle* acquired_error_;
 
+  Mutex pending_finalizations_mutex_;
+  MallocGrowableArray<FinalizablePersistentHandle*> pending_finalizations_;
+
+  struct DeferredFinalizer {
+    Dart_HandleFinalizer callback;
+    void* isolate_callback_data;
+    void* peer;
+  };
+  Monitor deferred_finalizers_monitor_;
+  MallocGrowableArray<DeferredFinalizer> deferred_finalizers_;
+  bool deferred_finalizers_running_;
+
   DISALLOW_COPY_AND_ASSIGN(ApiState);
 };
 
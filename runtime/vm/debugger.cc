@@ -1604,11 +1604,68 @@ bool Debugger::SetResumeAction(ResumeAction action,
   }
 }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+// Whether |function| is one of |functions|, or has optimized code that
+// inlines one of them.
+static bool FunctionCodeContainsAnyOf(Zone* zone,
+                                      const Function& function,
+                                      const GrowableObjectArray& functions) {
+  Array& inlined = Array::Handle(zone);
+  if (function.HasOptimizedCode()) {
+    const Code& code = Code::Handle(zone, function.CurrentCode());
+    inlined = code.inlined_id_to_function();
+  }
+  const intptr_t num_inlined = inlined.IsNull() ? 0 : inlined.Length();
+  for (intptr_t i = 0; i < functions.Length(); i++) {
+    const ObjectPtr other = functions.At(i);
+    if (function.raw() == other) {
+      return true;
+    }
+    for (intptr_t j = 0; j < num_inlined; j++) {
+      if (inlined.At(j) == other) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Switches |function| to its unoptimized code and resets the switchable calls
+// in it, if its code contains one of |functions| or if |functions| is null.
+static void DeoptimizeFunction(Zone* zone,
+                               const Function& function,
+                               const GrowableObjectArray* functions,
+                               CallSiteResetter* resetter,
+                               Code* code) {
+  if ((functions != nullptr) &&
+      !FunctionCodeContainsAnyOf(zone, function, *functions)) {
+    return;
+  }
+  if (function.HasOptimizedCode()) {
+    function.SwitchToUnoptimizedCode();
+  }
+  *code = function.unoptimized_code();
+  if (!code->IsNull()) {
+    resetter->ResetSwitchableCalls(*code);
+  }
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 // Deoptimize all functions in the isolate.
-// TODO(hausner): Actually we only need to deoptimize those functions
-// that inline the function that contains the newly created breakpoint.
-// We currently don't have this info so we deoptimize all functions.
 void Debugger::DeoptimizeWorld() {
+  DeoptimizeFunctions(nullptr);
+}
+
+// Deoptimize only |functions| and the optimized code that inlines them. Other
+// optimized code cannot reach a breakpoint in them, and Function::CanBeInlined
+// keeps functions with breakpoints from being inlined into code that is
+// optimized later.
+void Debugger::DeoptimizeFunctionsInlining(
+    const GrowableObjectArray& functions) {
+  DeoptimizeFunctions(&functions);
+}
+
+void Debugger::DeoptimizeFunctions(const GrowableObjectArray* functions) {
 #if defined(DART_PRECOMPILED_RUNTIME)
   UNREACHABLE();
 #else
@@ -1616,7 +1673,11 @@ void Debugger::DeoptimizeWorld() {
   if (FLAG_trace_deoptimization) {
     THR_Print("Deopt for debugger\n");
   }
-  isolate_->set_has_attempted_stepping(true);
+  if (functions == nullptr) {
+    // Only stepping deoptimizes all functions, and monomorphic calls in
+    // unoptimized code skip its checks.
+    isolate_->set_has_attempted_stepping(true);
+  }
 
   DeoptimizeFunctionsOnStack();
 
@@ -1627,7 +1688,7 @@ void Debugger::DeoptimizeWorld() {
   Zone* zone = thread->zone();
   CallSiteResetter resetter(zone);
   Class& cls = Class::Handle(zone);
-  Array& functions = Array::Handle(zone);
+  Array& class_functions = Array::Handle(zone);
   GrowableObjectArray& closures = GrowableObjectArray::Handle(zone);
   Function& function = Function::Handle(zone);
   Code& code = Code::Handle(zone);
@@ -1644,11 +1705,11 @@ void Debugger::DeoptimizeWorld() {
       cls = class_table.At(cid);
 
       // Disable optimized functions.
-      functions = cls.functions();
-      if (!functions.IsNull()) {
-        intptr_t num_functions = functions.Length();
+      class_functions = cls.functions();
+      if (!class_functions.IsNull()) {
+        intptr_t num_functions = class_functions.Length();
         for (intptr_t pos = 0; pos < num_functions; pos++) {
-          function ^= functions.At(pos);
+          function ^= class_functions.At(pos);
           ASSERT(!function.IsNull());
           // Force-optimized functions don't have unoptimized code and can't
           // deoptimize. Their optimized codes are still valid.
@@ -1656,23 +1717,11 @@ void Debugger::DeoptimizeWorld() {
             ASSERT(!function.HasImplicitClosureFunction());
             continue;
           }
-          if (function.HasOptimizedCode()) {
-            function.SwitchToUnoptimizedCode();
-          }
-          code = function.unoptimized_code();
-          if (!code.IsNull()) {
-            resetter.ResetSwitchableCalls(code);
-          }
+          DeoptimizeFunction(zone, function, functions, &resetter, &code);
           // Also disable any optimized implicit closure functions.
           if (function.HasImplicitClosureFunction()) {
             function = function.ImplicitClosureFunction();
-            if (function.HasOptimizedCode()) {
-              function.SwitchToUnoptimizedCode();
-            }
-            code = function.unoptimized_code();
-            if (!code.IsNull()) {
-              resetter.ResetSwitchableCalls(code);
-            }
+            DeoptimizeFunction(zone, function, functions, &resetter, &code);
           }
         }
       }
@@ -1685,13 +1734,7 @@ void Debugger::DeoptimizeWorld() {
   for (intptr_t pos = 0; pos < num_closures; pos++) {
     function ^= closures.At(pos);
     ASSERT(!function.IsNull());
-    if (function.HasOptimizedCode()) {
-      function.SwitchToUnoptimizedCode();
-    }
-    code = function.unoptimized_code();
-    if (!code.IsNull()) {
-      resetter.ResetSwitchableCalls(code);
-    }
+    DeoptimizeFunction(zone, function, functions, &resetter, &code);
   }
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 }
@@ -2810,7 +2853,7 @@ BreakpointLocation* Debugger::SetBreakpoint(const Script& script,
             FindExactTokenPosition(script, token_pos, requested_column);
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
       }
-      DeoptimizeWorld();
+      DeoptimizeFunctionsInlining(code_functions);
       BreakpointLocation* loc =
           SetCodeBreakpoints(script, token_pos, last_token_pos, requested_line,
                              requested_column, exact_token_pos, code_functions);
@@ -632,6 +632,8 @@ class Debugger {
                                      intptr_t requested_column,
                                      TokenPosition exact_token_pos);
   void DeoptimizeWorld();
+  void DeoptimizeFunctionsInlining(const GrowableObjectArray& functions);
+  void DeoptimizeFunctions(const GrowableObjectArray* functions);
   void NotifySingleStepping(bool value) const;
   BreakpointLocation* SetCodeBreakpoints(const Script& script,
                                          TokenPosition token_pos,
@@ -50,6 +50,46 @@ void DoubleToCString(double d, char* buffer, int buffer_size) {
   ASSERT(result == buffer);
 }
 
+// Writes the decimal digits of an integral value in [0, 2^53] backwards,
+// ending at buffer_end, and returns the start of the digits.
+static char* WriteIntegralDigits(uint64_t value, char* buffer_end) {
+  char* p = buffer_end;
+  do {
+    *--p = '0' + static_cast<char>(value % 10);
+    value /= 10;
+  } while (value != 0);
+  return p;
+}
+
+StringPtr DoubleToString(double d, Heap::Space space) {
+  const int kBufferSize = 128;
+  char buffer[kBufferSize];
+  const char* start;
+  intptr_t length;
+  // Integral doubles below 2^53 are printed by ToShortest as their integer
+  // digits followed by ".0", since no shorter digit string rounds back to
+  // them. They are common enough to skip the digit generation for.
+  const double kMaxExactInteger = 9007199254740992.0;  // 2^53
+  const double magnitude = fabs(d);
+  if ((magnitude <= kMaxExactInteger) && (magnitude == trunc(magnitude))) {
+    char* end = buffer + kBufferSize;
+    *--end = '0';
+    *--end = '.';
+    char* p = WriteIntegralDigits(static_cast<uint64_t>(magnitude), end);
+    if (signbit(d)) {
+      *--p = '-';
+    }
+    start = p;
+    length = (buffer + kBufferSize) - p;
+  } else {
+    DoubleToCString(d, buffer, kBufferSize);
+    start = buffer;
+    length = strlen(buffer);
+  }
+  return OneByteString::New(reinterpret_cast<const uint8_t*>(start), length,
+                            space);
+}
+
 StringPtr DoubleToStringAsFixed(double d, int fraction_digits) {
   static const int kMinFractionDigits = 0;
   static const int kMaxFractionDigits = 20;
@@ -159,10 +199,95 @@ StringPtr DoubleToStringAsPrecision(double d, int precision) {
   return String::New(builder.Finalize());
 }
 
+// The powers of ten that are exactly representable as doubles.
+static const double kExactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Parses [+-]?[0-9]+(\.[0-9]+)?([eE][+-]?[0-9]+)? without going through the
+// general converter, when the value is an integer of at most 53 bits scaled
+// by an exactly representable power of ten. Both operands of the single
+// multiplication or division are then exact, so its IEEE rounding gives the
+// correctly rounded result (Clinger's fast path). Returns false for anything
+// else, including input that is valid but must take the slow path.
+static bool FastCStringToDouble(const char* str,
+                                intptr_t length,
+                                double* result) {
+  // Keeps the significand from overflowing a uint64_t.
+  const intptr_t kMaxSignificantDigits = 19;
+  const uint64_t kMaxExactInteger = static_cast<uint64_t>(1) << 53;
+  const intptr_t kMaxExactPowerOfTen = ARRAY_SIZE(kExactPowersOfTen) - 1;
+
+  intptr_t i = 0;
+  bool negative = false;
+  if ((str[i] == '-') || (str[i] == '+')) {
+    negative = (str[i] == '-');
+    i++;
+  }
+
+  uint64_t significand = 0;
+  intptr_t significant_digits = 0;
+  intptr_t exponent = 0;
+  const intptr_t integer_start = i;
+  for (; (i < length) && Utils::IsDecimalDigit(str[i]); i++) {
+    if (significant_digits == kMaxSignificantDigits) return false;
+    significand = significand * 10 + (str[i] - '0');
+    if (significand != 0) significant_digits++;
+  }
+  if (i == integer_start) return false;
+
+  if ((i < length) && (str[i] == '.')) {
+    i++;
+    const intptr_t fraction_start = i;
+    for (; (i < length) && Utils::IsDecimalDigit(str[i]); i++) {
+      if (significant_digits == kMaxSignificantDigits) return false;
+      significand = significand * 10 + (str[i] - '0');
+      if (significand != 0) significant_digits++;
+      exponent--;
+    }
+    if (i == fraction_start) return false;
+  }
+
+  if ((i < length) && ((str[i] == 'e') || (str[i] == 'E'))) {
+    i++;
+    bool negative_exponent = false;
+    if ((i < length) && ((str[i] == '-') || (str[i] == '+'))) {
+      negative_exponent = (str[i] == '-');
+      i++;
+    }
+    const intptr_t exponent_start = i;
+    intptr_t explicit_exponent = 0;
+    for (; (i < length) && Utils::IsDecimalDigit(str[i]); i++) {
+      if (explicit_exponent > kMaxExactPowerOfTen) return false;
+      explicit_exponent = explicit_exponent * 10 + (str[i] - '0');
+    }
+    if (i == exponent_start) return false;
+    exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+  }
+
+  if ((i != length) || (significand > kMaxExactInteger) ||
+      (exponent < -kMaxExactPowerOfTen) || (exponent > kMaxExactPowerOfTen)) {
+    return false;
+  }
+
+  double value = static_cast<double>(significand);
+  if (exponent < 0) {
+    value /= kExactPowersOfTen[-exponent];
+  } else {
+    value *= kExactPowersOfTen[exponent];
+  }
+  *result = negative ? -value : value;
+  return true;
+}
+
 bool CStringToDouble(const char* str, intptr_t length, double* result) {
   if (length == 0) {
     return false;
   }
+  if (FastCStringToDouble(str, length, result)) {
+    return true;
+  }
 
   double_conversion::StringToDoubleConverter converter(
       double_conversion::StringToDoubleConverter::NO_FLAGS, 0.0, 0.0,
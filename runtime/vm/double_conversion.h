@@ -18,6 +18,9 @@ struct DoubleToStringConstants : AllStatic {
 };
 
 void DoubleToCString(double d, char* buffer, int buffer_size);
+// Same as DoubleToCString, but allocates the result as a OneByteString
+// without an intermediate zone copy.
+StringPtr DoubleToString(double d, Heap::Space space);
 StringPtr DoubleToStringAsFixed(double d, int fraction_digits);
 StringPtr DoubleToStringAsExponential(double d, int fraction_digits);
 StringPtr DoubleToStringAsPrecision(double d, int precision);
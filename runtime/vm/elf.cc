@@ -1181,6 +1181,17 @@ class DwarfElfStream : public DwarfWriteStream {
 };
 
 static constexpr intptr_t kInitialDwarfBufferSize = 64 * KB;
+
+// The DWARF sections are built in malloc'd buffers and only copied into the
+// zone once their final size is known. Growing them in the zone instead would
+// leave each outgrown buffer behind until the zone is deleted, which for the
+// line number program of a large app roughly doubles its footprint.
+static const uint8_t* CopyToZone(Zone* zone, const MallocWriteStream& stream) {
+  const intptr_t size = stream.bytes_written();
+  uint8_t* const bytes = zone->Alloc<uint8_t>(size);
+  memmove(bytes, stream.buffer(), size);
+  return bytes;
+}
 #endif
 
 Segment* Elf::LastLoadSegment() const {
@@ -1210,27 +1221,30 @@ void Elf::FinalizeDwarfSections() {
   if (dwarf_ == nullptr) return;
 #if defined(DART_PRECOMPILER)
   {
-    ZoneWriteStream stream(zone(), kInitialDwarfBufferSize);
+    MallocWriteStream stream(kInitialDwarfBufferSize);
     // We can use symtab_ without checking because this is an unstripped
     // snapshot or separate debugging information, both of which have static
     // symbol tables, and the static symbol table is a superset of the dynamic.
     DwarfElfStream dwarf_stream(zone_, &stream, symtab_);
     dwarf_->WriteAbbreviations(&dwarf_stream);
-    AddDebug(".debug_abbrev", stream.buffer(), stream.bytes_written());
+    AddDebug(".debug_abbrev", CopyToZone(zone_, stream),
+             stream.bytes_written());
   }
 
   {
-    ZoneWriteStream stream(zone(), kInitialDwarfBufferSize);
+    MallocWriteStream stream(kInitialDwarfBufferSize);
     DwarfElfStream dwarf_stream(zone_, &stream, symtab_);
     dwarf_->WriteDebugInfo(&dwarf_stream);
-    AddDebug(".debug_info", stream.buffer(), stream.bytes_written());
+    AddDebug(".debug_info", CopyToZone(zone_, stream),
+             stream.bytes_written());
   }
 
   {
-    ZoneWriteStream stream(zone(), kInitialDwarfBufferSize);
+    MallocWriteStream stream(kInitialDwarfBufferSize);
     DwarfElfStream dwarf_stream(zone_, &stream, symtab_);
     dwarf_->WriteLineNumberProgram(&dwarf_stream);
-    AddDebug(".debug_line", stream.buffer(), stream.bytes_written());
+    AddDebug(".debug_line", CopyToZone(zone_, stream),
+             stream.bytes_written());
   }
 #endif
 }
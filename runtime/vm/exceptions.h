@@ -118,6 +118,9 @@ struct ExceptionHandlerInfo {
   int8_t is_generated;         // True if this is a generated handler.
 };
 
+// Handler pc offset of a cached lookup that found no handler for its pc.
+static const uint32_t kNoHandlerPcOffset = kMaxUint32;
+
 //
 // Support for try/catch in the optimized code.
 //
@@ -118,4 +118,39 @@ TEST_CASE(UnhandledExceptions) {
   EXPECT_VALID(Dart_Invoke(lib, NewString("testMain"), 0, NULL));
 }
 
+// Throws repeatedly through frames that have try blocks which do not cover the
+// call being unwound, so the later throws use cached "no handler" lookups.
+TEST_CASE(ExceptionsUnwindPastUncoveredTry) {
+  const char* kScriptChars =
+      "thrower(int depth) {\n"
+      "  if (depth == 0) throw depth;\n"
+      "  return passThrough(depth - 1);\n"
+      "}\n"
+      "passThrough(int depth) {\n"
+      "  try {\n"
+      "    if (depth < 0) return -1;\n"
+      "  } catch (e) {\n"
+      "    return -2;\n"
+      "  }\n"
+      "  return thrower(depth);\n"
+      "}\n"
+      "testMain() {\n"
+      "  int caught = 0;\n"
+      "  for (int i = 0; i < 100; i++) {\n"
+      "    try {\n"
+      "      passThrough(10);\n"
+      "    } on int catch (e) {\n"
+      "      caught++;\n"
+      "    }\n"
+      "  }\n"
+      "  return caught;\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle result = Dart_Invoke(lib, NewString("testMain"), 0, NULL);
+  EXPECT_VALID(result);
+  int64_t value = 0;
+  EXPECT_VALID(Dart_IntegerToInt64(result, &value));
+  EXPECT_EQ(100, value);
+}
+
 }  // namespace dart
@@ -17,6 +17,12 @@ namespace dart {
 DECLARE_FLAG(bool, disassemble_stubs);
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
+DEFINE_FLAG(int,
+            ffi_callback_trampoline_pages,
+            4,
+            "Number of pages of FFI callback trampolines to map and protect "
+            "at once.");
+
 uword NativeCallbackTrampolines::TrampolineForId(int32_t callback_id) {
 #if defined(DART_PRECOMPILER)
   ASSERT(!Enabled());
@@ -24,7 +30,7 @@ uword NativeCallbackTrampolines::TrampolineForId(int32_t callback_id) {
 #else
   const intptr_t trampolines_per_page = NumCallbackTrampolinesPerPage();
   const intptr_t page_index = callback_id / trampolines_per_page;
-  const uword entry_point = trampoline_pages_[page_index]->start();
+  const uword entry_point = trampoline_pages_[page_index];
 
   return entry_point +
          (callback_id % trampolines_per_page) *
@@ -39,35 +45,61 @@ void NativeCallbackTrampolines::AllocateTrampoline() {
 #else
 
   // Callback IDs are limited to 32-bits for trampoline compactness.
-  if (kWordSize == 8 &&
-      !Utils::IsInt(32, next_callback_id_ + NumCallbackTrampolinesPerPage())) {
+  const intptr_t batch_size =
+      Utils::Maximum<intptr_t>(1, FLAG_ffi_callback_trampoline_pages) *
+      NumCallbackTrampolinesPerPage();
+  if (kWordSize == 8 && !Utils::IsInt(32, next_callback_id_ + batch_size)) {
     Exceptions::ThrowOOM();
   }
 
   if (trampolines_left_on_page_ == 0) {
-    // Fuchsia requires memory to be allocated with ZX_RIGHT_EXECUTE in order
-    // to be flipped to kReadExecute after being kReadWrite.
-    VirtualMemory* const memory = VirtualMemory::AllocateAligned(
-        /*size=*/VirtualMemory::PageSize(),
-        /*alignment=*/VirtualMemory::PageSize(),
-        /*is_executable=*/true, /*name=*/"Dart VM FFI callback trampolines");
-    memory->Protect(VirtualMemory::kReadWrite);
-
-    if (memory == nullptr) {
-      Exceptions::ThrowOOM();
+    if (reserved_pages_left_ == 0) {
+      AllocateTrampolinePages();
     }
+    ASSERT(reserved_pages_left_ > 0);
+    reserved_pages_left_--;
+    trampolines_left_on_page_ = NumCallbackTrampolinesPerPage();
+  }
+
+  trampolines_left_on_page_--;
+  next_callback_id_++;
+#endif  // defined(DART_PRECOMPILER)
+}
+
+#if !defined(DART_PRECOMPILER)
+void NativeCallbackTrampolines::AllocateTrampolinePages() {
+  // Map, fill and protect several pages at once: every page costs an mmap and
+  // two mprotect calls, which dominates creating the first callback on a page.
+  const intptr_t num_pages =
+      Utils::Maximum<intptr_t>(1, FLAG_ffi_callback_trampoline_pages);
+  const intptr_t page_size = VirtualMemory::PageSize();
+
+  // Fuchsia requires memory to be allocated with ZX_RIGHT_EXECUTE in order
+  // to be flipped to kReadExecute after being kReadWrite.
+  VirtualMemory* const memory = VirtualMemory::AllocateAligned(
+      /*size=*/num_pages * page_size,
+      /*alignment=*/page_size,
+      /*is_executable=*/true, /*name=*/"Dart VM FFI callback trampolines");
+  if (memory == nullptr) {
+    Exceptions::ThrowOOM();
+  }
+  memory->Protect(VirtualMemory::kReadWrite);
+
+  trampoline_memory_.Add(memory);
 
-    trampoline_pages_.Add(memory);
+  for (intptr_t i = 0; i < num_pages; ++i) {
+    const uword page_start = memory->start() + i * page_size;
+    const intptr_t first_callback_id =
+        trampoline_pages_.length() * NumCallbackTrampolinesPerPage();
+    trampoline_pages_.Add(page_start);
 
     compiler::Assembler assembler(/*object_pool_builder=*/nullptr);
     compiler::StubCodeCompiler::GenerateJITCallbackTrampolines(
-        &assembler, next_callback_id_);
+        &assembler, first_callback_id);
 
-    MemoryRegion region(memory->address(), memory->size());
+    MemoryRegion region(reinterpret_cast<void*>(page_start), page_size);
     assembler.FinalizeInstructions(region);
 
-    memory->Protect(VirtualMemory::kReadExecute);
-
 #if !defined(PRODUCT)
     const char* name = "FfiJitCallbackTrampolines";
     ASSERT(!Thread::Current()->IsAtSafepoint());
@@ -75,11 +107,11 @@ void NativeCallbackTrampolines::AllocateTrampoline() {
       const auto& comments = CreateCommentsFrom(&assembler);
       CodeCommentsWrapper wrapper(comments);
       CodeObservers::NotifyAll(name,
-                               /*base=*/memory->start(),
+                               /*base=*/page_start,
                                /*prologue_offset=*/0,
                                /*size=*/assembler.CodeSize(),
                                /*optimized=*/false,  // not really relevant
-                               &wrapper);
+                               &wrapper, /*positions=*/nullptr);
     }
 #endif
 #if !defined(PRODUCT) || defined(FORCE_INCLUDE_DISASSEMBLER)
@@ -88,22 +120,19 @@ void NativeCallbackTrampolines::AllocateTrampoline() {
       THR_Print(
           "Code for native callback trampolines "
           "[%" Pd " -> %" Pd "]: {\n",
-          next_callback_id_,
-          next_callback_id_ + NumCallbackTrampolinesPerPage() - 1);
+          first_callback_id,
+          first_callback_id + NumCallbackTrampolinesPerPage() - 1);
       const auto& comments = CreateCommentsFrom(&assembler);
-      Disassembler::Disassemble(memory->start(),
-                                memory->start() + assembler.CodeSize(),
+      Disassembler::Disassemble(page_start, page_start + assembler.CodeSize(),
                                 &formatter, &comments);
     }
 #endif
-
-    trampolines_left_on_page_ = NumCallbackTrampolinesPerPage();
   }
 
-  trampolines_left_on_page_--;
-  next_callback_id_++;
-#endif  // defined(DART_PRECOMPILER)
+  memory->Protect(VirtualMemory::kReadExecute);
+  reserved_pages_left_ += num_pages;
 }
+#endif  // !defined(DART_PRECOMPILER)
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
 }  // namespace dart
@@ -27,7 +27,9 @@ namespace dart {
 //
 // Since we can never map these trampolines RX -> RW, we eagerly generate as
 // many as will fit on a single page, since pages are the smallest granularity
-// of memory protection.
+// of memory protection. Pages are mapped in batches of
+// FLAG_ffi_callback_trampoline_pages so that creating many callbacks does not
+// pay for a mapping and two protection changes every page.
 //
 // See also:
 //  - StubCodeCompiler::GenerateJITCallbackTrampolines
@@ -47,8 +49,8 @@ class NativeCallbackTrampolines : public ValueObject {
   NativeCallbackTrampolines() {}
   ~NativeCallbackTrampolines() {
     // Unmap all the trampoline pages. 'VirtualMemory's are new-allocated.
-    for (intptr_t i = 0; i < trampoline_pages_.length(); ++i) {
-      delete trampoline_pages_[i];
+    for (intptr_t i = 0; i < trampoline_memory_.length(); ++i) {
+      delete trampoline_memory_[i];
     }
   }
 
@@ -65,7 +67,14 @@ class NativeCallbackTrampolines : public ValueObject {
   uword TrampolineForId(int32_t callback_id);
 
  private:
-  MallocGrowableArray<VirtualMemory*> trampoline_pages_;
+  // Maps, generates and protects the next batch of trampoline pages.
+  void AllocateTrampolinePages();
+
+  // Owns the memory of every batch of trampoline pages.
+  MallocGrowableArray<VirtualMemory*> trampoline_memory_;
+  // Start address of every generated trampoline page, in callback ID order.
+  MallocGrowableArray<uword> trampoline_pages_;
+  intptr_t reserved_pages_left_ = 0;
   intptr_t trampolines_left_on_page_ = 0;
   intptr_t next_callback_id_ = 0;
 
@@ -5,6 +5,7 @@
 #include "vm/field_table.h"
 
 #include "platform/atomic.h"
+#include "platform/utils.h"
 #include "vm/flags.h"
 #include "vm/growable_array.h"
 #include "vm/heap/heap.h"
@@ -60,8 +61,7 @@ bool FieldTable::Register(const Field& field, intptr_t expected_field_id) {
   if (free_head_ < 0) {
     bool grown_backing_store = false;
     if (top_ == capacity_) {
-      const intptr_t new_capacity = capacity_ + kCapacityIncrement;
-      Grow(new_capacity);
+      Grow(GrownCapacity(top_ + 1));
       grown_backing_store = true;
     }
 
@@ -95,8 +95,7 @@ void FieldTable::SetAt(intptr_t index, InstancePtr raw_instance) {
 
 void FieldTable::AllocateIndex(intptr_t index) {
   if (index >= capacity_) {
-    const intptr_t new_capacity = index + kCapacityIncrement;
-    Grow(new_capacity);
+    Grow(GrownCapacity(index + 1));
   }
 
   ASSERT(table_[index] == InstancePtr());
@@ -105,6 +104,16 @@ void FieldTable::AllocateIndex(intptr_t index) {
   }
 }
 
+intptr_t FieldTable::GrownCapacity(intptr_t min_capacity) const {
+  // Growing geometrically keeps the number of elements copied, and the size
+  // of the old tables kept in [old_tables_], linear in the number of fields.
+  // Each growth also requires a safepoint operation across all isolates of
+  // the group in IsolateGroup::RegisterStaticField.
+  intptr_t new_capacity = Utils::Maximum(capacity_ + kCapacityIncrement,
+                                         capacity_ * kCapacityGrowthFactor);
+  return Utils::Maximum(new_capacity, min_capacity + kCapacityIncrement);
+}
+
 void FieldTable::Grow(intptr_t new_capacity) {
   ASSERT(new_capacity > capacity_);
 
@@ -134,9 +143,13 @@ FieldTable* FieldTable::Clone(Isolate* for_isolate) {
       IsolateGroup::Current()->program_lock()->IsCurrentThreadReader());
 
   FieldTable* clone = new FieldTable(for_isolate);
+  // The clone needs the same capacity, so that it only has to grow when this
+  // table grows (see IsolateGroup::RegisterStaticField). Only the used part
+  // is copied: the unused part is zero, which calloc can provide without
+  // touching the memory.
   auto new_table = static_cast<InstancePtr*>(
-      malloc(capacity_ * sizeof(InstancePtr)));  // NOLINT
-  memmove(new_table, table_, capacity_ * sizeof(InstancePtr));
+      calloc(capacity_, sizeof(InstancePtr)));  // NOLINT
+  memmove(new_table, table_, top_ * sizeof(InstancePtr));
   ASSERT(clone->table_ == nullptr);
   clone->table_ = new_table;
   clone->capacity_ = capacity_;
@@ -69,6 +69,7 @@ class FieldTable {
 
   static const int kInitialCapacity = 512;
   static const int kCapacityIncrement = 256;
+  static const int kCapacityGrowthFactor = 2;
 
  private:
   friend class GCMarker;
@@ -76,6 +77,9 @@ class FieldTable {
   friend class Scavenger;
   friend class ScavengerWeakVisitor;
 
+  // Returns the capacity to grow to in order to hold at least [min_capacity]
+  // elements.
+  intptr_t GrownCapacity(intptr_t min_capacity) const;
   void Grow(intptr_t new_capacity);
 
   intptr_t top_;
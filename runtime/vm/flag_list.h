@@ -132,6 +132,9 @@ constexpr bool kDartUseBackgroundCompilation = true;
     "Consider thread pool isolates for idle tasks after this long.")           \
   P(idle_duration_micros, int, 500 * kMicrosecondsPerMillisecond,              \
     "Allow idle tasks to run for this long.")                                  \
+  P(idle_slice_micros, int, 10 * kMicrosecondsPerMillisecond,                  \
+    "Run short GC steps once all of a group's isolates have been idle this "   \
+    "long, before the full idle timeout. 0 disables idle slices.")             \
   P(interpret_irregexp, bool, false, "Use irregexp bytecode interpreter")      \
   P(link_natives_lazily, bool, false, "Link native calls lazily")              \
   R(log_marker_tasks, false, bool, false,                                      \
@@ -142,10 +145,15 @@ constexpr bool kDartUseBackgroundCompilation = true;
   P(marker_tasks, int, 2,                                                      \
     "The number of tasks to spawn during old gen GC marking (0 means "         \
     "perform all marking on main thread).")                                    \
+  P(sweeper_tasks, int, 2,                                                     \
+    "The number of tasks that share concurrent old gen sweeping.")             \
   P(max_polymorphic_checks, int, 4,                                            \
     "Maximum number of polymorphic check, otherwise it is megamorphic.")       \
   P(max_equality_polymorphic_checks, int, 32,                                  \
     "Maximum number of polymorphic checks in equality operator,")              \
+  P(max_switchable_polymorphic_checks, int, 8,                                 \
+    "Maximum number of receiver classes cached at an AOT switchable call "     \
+    "before it becomes megamorphic.")                                          \
   P(new_gen_semi_max_size, int, (kWordSize <= 4) ? 8 : 16,                     \
     "Max size of new gen semi space in MB")                                    \
   P(new_gen_semi_initial_size, int, (kWordSize <= 4) ? 1 : 2,                  \
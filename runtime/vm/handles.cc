@@ -39,20 +39,31 @@ static bool IsCurrentApiNativeScope(Zone* zone) {
   ApiNativeScope* scope = ApiNativeScope::Current();
   return (scope != NULL) && (scope->zone() == zone);
 }
-#endif  // DEBUG
 
-uword VMHandles::AllocateHandle(Zone* zone) {
-  DEBUG_ASSERT(!IsCurrentApiNativeScope(zone));
-  return Handles<kVMHandleSizeInWords, kVMHandlesPerChunk,
-                 kOffsetOfRawPtr>::AllocateHandle(zone);
+void VMHandles::VerifyAllocateHandle(Zone* zone) {
+  ASSERT(!IsCurrentApiNativeScope(zone));
+  Thread* thread = Thread::Current();
+  ASSERT(thread->top_handle_scope() != NULL);
+  ASSERT(thread->MayAllocateHandles());
+  ASSERT(zone->handles() != NULL);
 }
 
-uword VMHandles::AllocateZoneHandle(Zone* zone) {
-  DEBUG_ASSERT(!IsCurrentApiNativeScope(zone));
-  return Handles<kVMHandleSizeInWords, kVMHandlesPerChunk,
-                 kOffsetOfRawPtr>::AllocateZoneHandle(zone);
+void VMHandles::VerifyAllocateZoneHandle(Zone* zone) {
+  ASSERT(!IsCurrentApiNativeScope(zone));
+  Thread* thread = Thread::Current();
+  ASSERT(zone->ContainsNestedZone(thread->zone()));
+  ASSERT(thread->MayAllocateHandles());
+  ASSERT(zone->handles() != NULL);
 }
 
+intptr_t VMHandles::AllocatedHandleCount() {
+  Thread* thread = Thread::Current();
+  ASSERT(thread->zone() != NULL);
+  VMHandles* handles = thread->zone()->handles();
+  return handles->allocated_handle_count();
+}
+#endif  // DEBUG
+
 bool VMHandles::IsZoneHandle(uword handle) {
   return Handles<kVMHandleSizeInWords, kVMHandlesPerChunk,
                  kOffsetOfRawPtr>::IsZoneHandle(handle);
@@ -47,6 +47,7 @@ namespace dart {
 //   zone handles in the dart VM.
 
 // Forward declarations.
+class Mutex;
 class ObjectPointerVisitor;
 class HandleVisitor;
 
@@ -58,7 +59,9 @@ class Handles {
   Handles()
       : zone_blocks_(NULL),
         first_scoped_block_(NULL),
-        scoped_blocks_(&first_scoped_block_) {}
+        scoped_blocks_(&first_scoped_block_) {
+    DEBUG_ONLY(allocated_handle_count_ = 0);
+  }
   ~Handles() { DeleteAll(); }
 
   // Visit all object pointers stored in the various handles.
@@ -77,6 +80,11 @@ class Handles {
   // Visit all of the various handles.
   void Visit(HandleVisitor* visitor);
 
+  // Visit the handles of every num_slices'th block, starting with block
+  // number slice. Visiting slices 0 .. num_slices - 1 visits all handles,
+  // so the slices can be visited in parallel.
+  void VisitSlice(HandleVisitor* visitor, intptr_t slice, intptr_t num_slices);
+
   // Reset the handles so that we can reuse.
   void Reset();
 
@@ -97,9 +105,18 @@ class Handles {
     if (scoped_blocks_->IsFull()) {
       SetupNextScopeBlock();
     }
+    DEBUG_ONLY(allocated_handle_count_++);
     return scoped_blocks_->AllocateHandle();
   }
 
+  // Sets up and tears down the process-wide cache of free handle blocks of
+  // this handle size. Blocks are only cached between the two calls.
+  static void InitBlockCache();
+  static void CleanupBlockCache();
+
+  // Returns the number of handle blocks in the cache.
+  static intptr_t CachedBlockCount();
+
  protected:
   // Returns a count of active handles (used for testing purposes).
   int CountScopedHandles() const;
@@ -109,6 +126,21 @@ class Handles {
   bool IsValidScopedHandle(uword handle) const;
   bool IsValidZoneHandle(uword handle) const;
 
+  // Allocates space for a zone handle.
+  uword AllocateHandleInZone() {
+    if (zone_blocks_ == NULL || zone_blocks_->IsFull()) {
+      SetupNextZoneBlock();
+    }
+    DEBUG_ONLY(allocated_handle_count_++);
+    return zone_blocks_->AllocateHandle();
+  }
+
+#if defined(DEBUG)
+  // Returns the number of handles ever allocated, including the ones
+  // released by exiting handle scopes (used for testing purposes).
+  intptr_t allocated_handle_count() const { return allocated_handle_count_; }
+#endif
+
  private:
   // Base structure for managing blocks of handles.
   // Handles are allocated in Chunks (each chunk holds kHandlesPerChunk
@@ -182,17 +214,19 @@ class Handles {
   // Sets up the next handle block (allocates a new one if needed).
   void SetupNextScopeBlock();
 
-  // Allocates space for a zone handle.
-  uword AllocateHandleInZone() {
-    if (zone_blocks_ == NULL || zone_blocks_->IsFull()) {
-      SetupNextZoneBlock();
-    }
-    return zone_blocks_->AllocateHandle();
-  }
-
   // Allocates a new handle block and links it up.
   void SetupNextZoneBlock();
 
+  // Returns a block linked to [next], taking it from the block cache if
+  // possible.
+  static HandlesBlock* NewBlock(HandlesBlock* next);
+
+  // Up to this many deleted blocks are kept for reuse by NewBlock.
+  static constexpr intptr_t kBlockCacheCapacity = 64;
+  static Mutex* block_cache_mutex_;
+  static HandlesBlock* block_cache_;
+  static intptr_t block_cache_size_;
+
 #if defined(DEBUG)
   // Verifies consistency of handle blocks after a scope is destroyed.
   void VerifyScopedHandleState();
@@ -204,6 +238,9 @@ class Handles {
   HandlesBlock* zone_blocks_;        // List of zone handles.
   HandlesBlock first_scoped_block_;  // First block of scoped handles.
   HandlesBlock* scoped_blocks_;      // List of scoped handles.
+#if defined(DEBUG)
+  intptr_t allocated_handle_count_;  // Number of handles ever allocated.
+#endif
 
   friend class HandleScope;
   friend class Dart;
@@ -238,11 +275,13 @@ class VMHandles : public Handles<kVMHandleSizeInWords,
   // Allocates a handle in the current handle scope of 'zone', which must be
   // the current zone. This handle is valid only in the current handle scope
   // and is destroyed when the current handle scope ends.
-  static uword AllocateHandle(Zone* zone);
+  // Defined in zone.h, so the common case is inlined at the call site.
+  inline static uword AllocateHandle(Zone* zone);
 
   // Allocates a handle in 'zone', which must be the current zone. This handle
   // will be destroyed when the current zone is destroyed.
-  static uword AllocateZoneHandle(Zone* zone);
+  // Defined in zone.h, so the common case is inlined at the call site.
+  inline static uword AllocateZoneHandle(Zone* zone);
 
   // Returns true if specified handle is a zone handle.
   static bool IsZoneHandle(uword handle);
@@ -251,6 +290,17 @@ class VMHandles : public Handles<kVMHandleSizeInWords,
   static int ScopedHandleCount();
   static int ZoneHandleCount();
 
+#if defined(DEBUG)
+  // Returns the number of handles ever allocated in the current zone.
+  static intptr_t AllocatedHandleCount();
+#endif
+
+ private:
+#if defined(DEBUG)
+  static void VerifyAllocateHandle(Zone* zone);
+  static void VerifyAllocateZoneHandle(Zone* zone);
+#endif
+
   friend class ApiZone;
   friend class ApiNativeScope;
 };
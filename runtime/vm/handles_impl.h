@@ -6,11 +6,58 @@
 #define RUNTIME_VM_HANDLES_IMPL_H_
 
 #include "vm/heap/heap.h"
+#include "vm/lockers.h"
+#include "vm/os_thread.h"
 #include "vm/thread.h"
 #include "vm/visitor.h"
 
 namespace dart {
 
+template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
+Mutex* Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
+    block_cache_mutex_ = nullptr;
+
+template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
+typename Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
+    HandlesBlock*
+        Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
+            block_cache_ = nullptr;
+
+template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
+intptr_t Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
+    block_cache_size_ = 0;
+
+template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
+void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
+    InitBlockCache() {
+  ASSERT(block_cache_mutex_ == nullptr);
+  block_cache_mutex_ = new Mutex(NOT_IN_PRODUCT("handle_block_cache_mutex"));
+}
+
+template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
+void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
+    CleanupBlockCache() {
+  {
+    MutexLocker ml(block_cache_mutex_);
+    while (block_cache_ != nullptr) {
+      HandlesBlock* block = block_cache_;
+      block_cache_ = block->next_block();
+      delete block;
+    }
+    block_cache_size_ = 0;
+  }
+  delete block_cache_mutex_;
+  block_cache_mutex_ = nullptr;
+}
+
+template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
+intptr_t Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
+    CachedBlockCount() {
+  if (block_cache_mutex_ == nullptr) return 0;
+  MutexLocker ml(block_cache_mutex_);
+  return block_cache_size_;
+}
+
 template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
 void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
     VisitObjectPointers(ObjectPointerVisitor* visitor) {
@@ -57,6 +104,30 @@ void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::Visit(
   } while (block != NULL);
 }
 
+template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
+void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::VisitSlice(
+    HandleVisitor* visitor,
+    intptr_t slice,
+    intptr_t num_slices) {
+  ASSERT((slice >= 0) && (slice < num_slices));
+  intptr_t index = 0;
+  HandlesBlock* block = zone_blocks_;
+  while (block != NULL) {
+    if ((index++ % num_slices) == slice) {
+      block->Visit(visitor);
+    }
+    block = block->next_block();
+  }
+
+  block = &first_scoped_block_;
+  do {
+    if ((index++ % num_slices) == slice) {
+      block->Visit(visitor);
+    }
+    block = block->next_block();
+  } while (block != NULL);
+}
+
 template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
 void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::Reset() {
   // Delete all the extra zone handle blocks allocated and reinit the first
@@ -140,6 +211,16 @@ void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
 template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
 void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
     DeleteHandleBlocks(HandlesBlock* blocks) {
+  if ((blocks != NULL) && (block_cache_mutex_ != nullptr)) {
+    MutexLocker ml(block_cache_mutex_);
+    while ((blocks != NULL) && (block_cache_size_ < kBlockCacheCapacity)) {
+      HandlesBlock* block = blocks;
+      blocks = blocks->next_block();
+      block->set_next_block(block_cache_);
+      block_cache_ = block;
+      block_cache_size_++;
+    }
+  }
   while (blocks != NULL) {
     HandlesBlock* block = blocks;
     blocks = blocks->next_block();
@@ -156,8 +237,7 @@ void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
                  CountScopedHandles());
   }
   if (scoped_blocks_->next_block() == NULL) {
-    HandlesBlock* block = new HandlesBlock(NULL);
-    scoped_blocks_->set_next_block(block);
+    scoped_blocks_->set_next_block(NewBlock(NULL));
   }
   scoped_blocks_ = scoped_blocks_->next_block();
   scoped_blocks_->set_next_handle_slot(0);
@@ -203,7 +283,26 @@ void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
                  reinterpret_cast<intptr_t>(this), CountZoneHandles(),
                  CountScopedHandles());
   }
-  zone_blocks_ = new HandlesBlock(zone_blocks_);
+  zone_blocks_ = NewBlock(zone_blocks_);
+}
+
+template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
+typename Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::
+    HandlesBlock*
+    Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::NewBlock(
+        HandlesBlock* next) {
+  if (block_cache_mutex_ != nullptr) {
+    MutexLocker ml(block_cache_mutex_);
+    if (block_cache_ != nullptr) {
+      HandlesBlock* block = block_cache_;
+      block_cache_ = block->next_block();
+      block_cache_size_--;
+      block->ReInit();
+      block->set_next_block(next);
+      return block;
+    }
+  }
+  return new HandlesBlock(next);
 }
 
 #if defined(DEBUG)
@@ -77,6 +77,44 @@ ISOLATE_UNIT_TEST_CASE(AllocateScopeHandle) {
   EXPECT_EQ(handle_count, VMHandles::ScopedHandleCount());
 }
 
+// Unit test for reuse of the handle blocks of deleted zones.
+ISOLATE_UNIT_TEST_CASE(HandleBlockCache) {
+  static const int kNumHandles = 1000;
+  {
+    StackZone zone(thread);
+    HANDLESCOPE(thread);
+#if defined(DEBUG)
+    const intptr_t allocated_count = VMHandles::AllocatedHandleCount();
+#endif
+    for (int i = 0; i < kNumHandles; i++) {
+      HANDLESCOPE(thread);
+      Smi::Handle(Smi::New(i));
+      Smi::ZoneHandle(Smi::New(i));
+    }
+    for (int i = 0; i < kNumHandles; i++) {
+      Smi::Handle(Smi::New(i));
+    }
+    EXPECT_EQ(kNumHandles, VMHandles::ZoneHandleCount());
+    EXPECT_EQ(kNumHandles, VMHandles::ScopedHandleCount());
+#if defined(DEBUG)
+    EXPECT_EQ(allocated_count + (3 * kNumHandles),
+              VMHandles::AllocatedHandleCount());
+#endif
+  }
+  // The blocks of the deleted zone are cached and reused by the next one.
+  const intptr_t cached_count = VMHandles::CachedBlockCount();
+  EXPECT(cached_count > 0);
+  {
+    StackZone zone(thread);
+    HANDLESCOPE(thread);
+    for (int i = 0; i < kNumHandles; i++) {
+      const Smi& handle = Smi::ZoneHandle(Smi::New(i));
+      EXPECT_EQ(i, handle.Value());
+    }
+    EXPECT(VMHandles::CachedBlockCount() < cached_count);
+  }
+}
+
 static void NoopCallback(void* isolate_callback_data, void* peer) {}
 
 // Unit test for handle validity checks.
@@ -71,6 +71,22 @@ namespace dart {
 //    uword Hash(const Key& key) for any number of desired lookup key types.
 //  kPayloadSize: number of components of the payload in each entry.
 //  kMetaDataSize: number of elements reserved (e.g., for iteration order data).
+//
+// KeyTraits may also define 'static const bool kCachesHashes = true;' to store
+// a fragment of the hash of each key after its payload. Probes compare the
+// fragment before calling IsMatch, which avoids most of the expensive key
+// comparisons on collisions at the cost of one more element per entry.
+template <typename KeyTraits, typename = void>
+struct HashTableCachesHashes {
+  static const bool value = false;
+};
+
+template <typename KeyTraits>
+struct HashTableCachesHashes<KeyTraits,
+                             decltype(void(KeyTraits::kCachesHashes))> {
+  static const bool value = KeyTraits::kCachesHashes;
+};
+
 template <typename KeyTraits, intptr_t kPayloadSize, intptr_t kMetaDataSize>
 class HashTable : public ValueObject {
  public:
@@ -156,6 +172,7 @@ class HashTable : public ValueObject {
     // TODO(koda): Add salt.
     NOT_IN_PRODUCT(intptr_t collisions = 0;)
     uword hash = KeyTraits::Hash(key);
+    const intptr_t fragment = HashFragment(hash);
     ASSERT(Utils::IsPowerOfTwo(num_entries));
     intptr_t probe = hash & (num_entries - 1);
     int probe_distance = 1;
@@ -164,10 +181,12 @@ class HashTable : public ValueObject {
         NOT_IN_PRODUCT(UpdateCollisions(collisions);)
         return -1;
       } else if (!IsDeleted(probe)) {
-        *key_handle_ = GetKey(probe);
-        if (KeyTraits::IsMatch(key, *key_handle_)) {
-          NOT_IN_PRODUCT(UpdateCollisions(collisions);)
-          return probe;
+        if (MatchesHashFragment(probe, fragment)) {
+          *key_handle_ = GetKey(probe);
+          if (KeyTraits::IsMatch(key, *key_handle_)) {
+            NOT_IN_PRODUCT(UpdateCollisions(collisions);)
+            return probe;
+          }
         }
         NOT_IN_PRODUCT(collisions += 1;)
       }
@@ -191,6 +210,7 @@ class HashTable : public ValueObject {
     ASSERT(NumOccupied() < num_entries);
     NOT_IN_PRODUCT(intptr_t collisions = 0;)
     uword hash = KeyTraits::Hash(key);
+    const intptr_t fragment = HashFragment(hash);
     ASSERT(Utils::IsPowerOfTwo(num_entries));
     intptr_t probe = hash & (num_entries - 1);
     int probe_distance = 1;
@@ -205,11 +225,13 @@ class HashTable : public ValueObject {
           deleted = probe;
         }
       } else {
-        *key_handle_ = GetKey(probe);
-        if (KeyTraits::IsMatch(key, *key_handle_)) {
-          *entry = probe;
-          NOT_IN_PRODUCT(UpdateCollisions(collisions);)
-          return true;
+        if (MatchesHashFragment(probe, fragment)) {
+          *key_handle_ = GetKey(probe);
+          if (KeyTraits::IsMatch(key, *key_handle_)) {
+            *entry = probe;
+            NOT_IN_PRODUCT(UpdateCollisions(collisions);)
+            return true;
+          }
         }
         NOT_IN_PRODUCT(collisions += 1;)
       }
@@ -235,6 +257,9 @@ class HashTable : public ValueObject {
       ASSERT(IsUnused(entry));
     }
     InternalSetKey(entry, key);
+    if (kCachesHashes) {
+      SetSmiValueAt(HashIndex(entry), HashFragment(KeyTraits::Hash(key)));
+    }
     ASSERT(IsOccupied(entry));
     ASSERT(NumOccupied() < NumEntries());
   }
@@ -358,7 +383,10 @@ class HashTable : public ValueObject {
 #endif
   static const intptr_t kMetaDataIndex = kHeaderSize;
   static const intptr_t kFirstKeyIndex = kHeaderSize + kMetaDataSize;
-  static const intptr_t kEntrySize = 1 + kPayloadSize;
+  static const bool kCachesHashes = HashTableCachesHashes<KeyTraits>::value;
+  static const intptr_t kEntrySize = 1 + kPayloadSize + (kCachesHashes ? 1 : 0);
+  // Fragments are stored as Smis, which have at least 30 value bits.
+  static const uword kHashFragmentMask = (static_cast<uword>(1) << 30) - 1;
 
   intptr_t KeyIndex(intptr_t entry) const {
     ASSERT(0 <= entry && entry < NumEntries());
@@ -370,6 +398,21 @@ class HashTable : public ValueObject {
     return KeyIndex(entry) + 1 + component;
   }
 
+  intptr_t HashIndex(intptr_t entry) const {
+    ASSERT(kCachesHashes);
+    return KeyIndex(entry) + 1 + kPayloadSize;
+  }
+
+  static intptr_t HashFragment(uword hash) {
+    return static_cast<intptr_t>(hash & kHashFragmentMask);
+  }
+
+  // Always true for tables that do not cache hashes. Must only be called on
+  // occupied entries.
+  bool MatchesHashFragment(intptr_t entry, intptr_t fragment) const {
+    return !kCachesHashes || (GetSmiValueAt(HashIndex(entry)) == fragment);
+  }
+
   ObjectPtr InternalGetKey(intptr_t entry) const {
     return data_->At(KeyIndex(entry));
   }
@@ -510,6 +553,30 @@ class HashTables : public AllStatic {
     NOT_IN_PRODUCT(table.UpdateGrowth(); table.PrintStats();)
   }
 
+  // Grows 'table' if needed so that 'num_additional' more keys can be
+  // inserted without exceeding the load factor 'high', so that inserting a
+  // known number of keys rehashes the table at most once.
+  template <typename Table>
+  static void Reserve(double high,
+                      intptr_t num_additional,
+                      const Table& table) {
+    ASSERT(num_additional >= 0);
+    const intptr_t num_needed = table.NumOccupied() + num_additional;
+    const double load = (1 + num_needed + table.NumDeleted()) /
+                        static_cast<double>(table.NumEntries());
+    if (load < high) {
+      return;
+    }
+    const intptr_t new_capacity = num_needed * 2 + 1;
+    ASSERT(((1.0 + num_needed) / Utils::RoundUpToPowerOfTwo(new_capacity)) <=
+           high);
+    Table new_table(New<Table>(new_capacity,  // Is rounded up to power of 2.
+                               table.data_->IsOld() ? Heap::kOld : Heap::kNew));
+    Copy(table, new_table);
+    *table.data_ = new_table.Release().raw();
+    NOT_IN_PRODUCT(table.UpdateGrowth(); table.PrintStats();)
+  }
+
   // Serializes a table by concatenating its entries as an array.
   template <typename Table>
   static ArrayPtr ToArray(const Table& table, bool include_payload) {
@@ -702,6 +769,13 @@ class HashSet : public BaseIterTable {
 
   void Clear() const { BaseIterTable::Initialize(); }
 
+  // Makes room for inserting 'num_additional' more keys without growing the
+  // set on the way.
+  void Reserve(intptr_t num_additional) const {
+    static const double kMaxLoadFactor = 0.71;
+    HashTables::Reserve(kMaxLoadFactor, num_additional, *this);
+  }
+
  protected:
   void EnsureCapacity() const {
     static const double kMaxLoadFactor = 0.71;
@@ -35,6 +35,13 @@ class TestTraits {
   static ObjectPtr NewKey(const char* key) { return String::New(key); }
 };
 
+// Same as TestTraits, but also stores a fragment of the hash in each entry.
+class CachingTestTraits : public TestTraits {
+ public:
+  static const char* Name() { return "CachingTestTraits"; }
+  static const bool kCachesHashes = true;
+};
+
 template <typename Table>
 void Validate(const Table& table) {
   // Verify consistency of entry state tracking.
@@ -257,4 +264,49 @@ ISOLATE_UNIT_TEST_CASE(Maps) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(CachingSetsAndMaps) {
+  for (intptr_t initial_capacity = 0; initial_capacity < 32;
+       ++initial_capacity) {
+    TestSet<UnorderedHashSet<CachingTestTraits> >(initial_capacity, false);
+    TestMap<UnorderedHashMap<CachingTestTraits> >(initial_capacity, false);
+  }
+
+  // Keys with equal hashes are still told apart by IsMatch.
+  typedef UnorderedHashSet<CachingTestTraits> Set;
+  Set set(HashTables::New<Set>(4));
+  EXPECT(!set.Insert(String::Handle(String::New("ab"))));
+  EXPECT(!set.Insert(String::Handle(String::New("cd"))));
+  EXPECT(set.ContainsKey("ab"));
+  EXPECT(set.ContainsKey("cd"));
+  EXPECT(!set.ContainsKey("ef"));
+  EXPECT(set.Remove("ab"));
+  EXPECT(!set.ContainsKey("ab"));
+  EXPECT(set.ContainsKey("cd"));
+  Validate(set);
+  set.Release();
+}
+
+ISOLATE_UNIT_TEST_CASE(SetReserve) {
+  typedef UnorderedHashSet<TestTraits> Set;
+  Set set(HashTables::New<Set>(4));
+  const intptr_t kNumKeys = 100;
+  set.Reserve(kNumKeys);
+  const intptr_t num_entries = set.NumEntries();
+  EXPECT_LE((1.0 + kNumKeys) / num_entries, 0.71);
+  char buffer[8];
+  for (intptr_t i = 0; i < kNumKeys; ++i) {
+    Utils::SNPrint(buffer, sizeof(buffer), "%" Pd, i);
+    EXPECT(!set.Insert(String::Handle(String::New(buffer))));
+  }
+  // Inserting the reserved number of keys did not grow the set.
+  EXPECT_EQ(num_entries, set.NumEntries());
+  EXPECT_EQ(kNumKeys, set.NumOccupied());
+  Validate(set);
+
+  // Reserving room that is already available keeps the backing store.
+  set.Reserve(0);
+  EXPECT_EQ(num_entries, set.NumEntries());
+  set.Release();
+}
+
 }  // namespace dart
@@ -8,7 +8,11 @@
 #include "platform/utils.h"
 
 #include "vm/dart_api_state.h"
+#include "vm/flags.h"
+#include "vm/heap/pages.h"
+#include "vm/heap/pointer_block.h"
 #include "vm/heap/safepoint.h"
+#include "vm/heap/scavenger.h"
 #include "vm/isolate_reload.h"
 #include "vm/object.h"
 #include "vm/raw_object.h"
@@ -17,6 +21,13 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            become_new_space_only,
+            true,
+            "When every object being forwarded is in new space, only visit "
+            "new space, the remembered set and the roots instead of the whole "
+            "heap.");
+
 ForwardingCorpse* ForwardingCorpse::AsForwarder(uword addr, intptr_t size) {
   ASSERT(size >= kObjectAlignment);
   ASSERT(Utils::IsAligned(size, kObjectAlignment));
@@ -236,6 +247,7 @@ void Become::ElementsForwardIdentity(const Array& before, const Array& after) {
 
   // Setup forwarding pointers.
   ASSERT(before.Length() == after.Length());
+  bool all_new_before = true;
   for (intptr_t i = 0; i < before.Length(); i++) {
     ObjectPtr before_obj = before.At(i);
     ObjectPtr after_obj = after.At(i);
@@ -265,6 +277,7 @@ void Become::ElementsForwardIdentity(const Array& before, const Array& after) {
       FATAL("become: No indirect chains of forwarding");
     }
 
+    all_new_before = all_new_before && before_obj->IsNewObject();
     ForwardObjectTo(before_obj, after_obj);
     heap->ForwardWeakEntries(before_obj, after_obj);
 #if defined(HASH_IN_OBJECT_HEADER)
@@ -272,7 +285,11 @@ void Become::ElementsForwardIdentity(const Array& before, const Array& after) {
 #endif
   }
 
-  FollowForwardingPointers(thread);
+  if (FLAG_become_new_space_only && all_new_before) {
+    FollowNewSpaceForwardingPointers(thread);
+  } else {
+    FollowForwardingPointers(thread);
+  }
 
 #if defined(DEBUG)
   for (intptr_t i = 0; i < before.Length(); i++) {
@@ -320,4 +337,68 @@ void Become::FollowForwardingPointers(Thread* thread) {
   isolate_group->VisitWeakPersistentHandles(&handle_visitor);
 }
 
+void Become::FollowNewSpaceForwardingPointers(Thread* thread) {
+  // Only new-space objects are forwarded, so by the generational invariant
+  // their referrers are the roots, new-space objects, and old-space objects
+  // in the remembered set or with remembered cards: the same set a scavenge
+  // visits.
+  auto isolate_group = thread->isolate_group();
+  Heap* heap = isolate_group->heap();
+
+  ForwardPointersVisitor pointer_visitor(thread);
+
+  {
+    WritableCodeLiteralsScope writable_code(heap);
+
+    // Remembered old-space objects. The barrier re-remembers each object that
+    // still points into new space after forwarding.
+    isolate_group->ReleaseStoreBuffers();
+    StoreBuffer* store_buffer = isolate_group->store_buffer();
+    StoreBufferBlock* pending = store_buffer->TakeBlocks();
+    while (pending != nullptr) {
+      StoreBufferBlock* next = pending->next();
+      // Generated code appends to store buffers; tell MemorySanitizer.
+      MSAN_UNPOISON(pending, sizeof(*pending));
+      while (!pending->IsEmpty()) {
+        ObjectPtr raw_object = pending->Pop();
+        ASSERT(raw_object->ptr()->IsRemembered());
+        pointer_visitor.VisitingObject(raw_object);
+        raw_object->ptr()->VisitPointers(&pointer_visitor);
+      }
+      pending->Reset();
+      store_buffer->PushBlock(pending, StoreBuffer::kIgnoreThreshold);
+      pending = next;
+    }
+
+    // Card-remembered arrays. Cards are kept while they hold new-space
+    // targets, so plain stores suffice.
+    pointer_visitor.VisitingObject(nullptr);
+    heap->old_space()->SnapshotRememberedCardPages();
+    heap->old_space()->VisitRememberedCards(&pointer_visitor);
+
+    // New-space objects.
+    ForwardHeapPointersVisitor object_visitor(&pointer_visitor);
+    heap->new_space()->VisitObjects(&object_visitor);
+    pointer_visitor.VisitingObject(nullptr);
+  }
+
+  // C++ pointers.
+  isolate_group->VisitObjectPointers(&pointer_visitor,
+                                     ValidationPolicy::kValidateFrames);
+#ifndef PRODUCT
+  isolate_group->ForEachIsolate(
+      [&](Isolate* isolate) {
+        ObjectIdRing* ring = isolate->object_id_ring();
+        if (ring != nullptr) {
+          ring->VisitPointers(&pointer_visitor);
+        }
+      },
+      /*at_safepoint=*/true);
+#endif  // !PRODUCT
+
+  // Weak persistent handles.
+  ForwardHeapPointersHandleVisitor handle_visitor(thread);
+  isolate_group->VisitWeakPersistentHandles(&handle_visitor);
+}
+
 }  // namespace dart
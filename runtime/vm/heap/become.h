@@ -88,6 +88,10 @@ class Become : public AllStatic {
   static void FollowForwardingPointers(Thread* thread);
 
  private:
+  // Like FollowForwardingPointers, for when every forwarded object is in new
+  // space. Visits new space and the remembered set instead of the whole heap.
+  static void FollowNewSpaceForwardingPointers(Thread* thread);
+
   static void CrashDump(ObjectPtr before_obj, ObjectPtr after_obj);
 };
 
@@ -148,4 +148,42 @@ ISOLATE_UNIT_TEST_CASE(BecomeForwardRememberedCards) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(BecomeForwardNewSpaceReferrers) {
+  // Forwarding only new-space objects visits new space, the remembered set
+  // and the roots rather than the whole heap; all referrers must be found.
+  const String& before_obj = String::Handle(String::New("before", Heap::kNew));
+  const String& after_obj = String::Handle(String::New("after", Heap::kOld));
+
+  const Array& old_referrer = Array::Handle(Array::New(1, Heap::kOld));
+  old_referrer.SetAt(0, before_obj);
+  EXPECT(old_referrer.raw()->ptr()->IsRemembered());
+  const Array& new_referrer = Array::Handle(Array::New(1, Heap::kNew));
+  new_referrer.SetAt(0, before_obj);
+  const intptr_t length = Heap::kNewAllocatableSize / kWordSize;
+  ASSERT(Array::UseCardMarkingForAllocation(length));
+  const Array& card_referrer = Array::Handle(Array::New(length));
+  EXPECT(card_referrer.raw()->ptr()->IsCardRemembered());
+  card_referrer.SetAt(length - 1, before_obj);
+
+  const Array& before = Array::Handle(Array::New(1, Heap::kOld));
+  before.SetAt(0, before_obj);
+  const Array& after = Array::Handle(Array::New(1, Heap::kOld));
+  after.SetAt(0, after_obj);
+  Become::ElementsForwardIdentity(before, after);
+
+  EXPECT(before_obj.raw() == after_obj.raw());
+  EXPECT(old_referrer.At(0) == after_obj.raw());
+  EXPECT(new_referrer.At(0) == after_obj.raw());
+  EXPECT(card_referrer.At(length - 1) == after_obj.raw());
+  // The old referrer no longer points into new space.
+  EXPECT(!old_referrer.raw()->ptr()->IsRemembered());
+
+  GCTestHelper::CollectAllGarbage();
+
+  EXPECT(before_obj.raw() == after_obj.raw());
+  EXPECT(old_referrer.At(0) == after_obj.raw());
+  EXPECT(new_referrer.At(0) == after_obj.raw());
+  EXPECT(card_referrer.At(length - 1) == after_obj.raw());
+}
+
 }  // namespace dart
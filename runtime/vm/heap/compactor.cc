@@ -9,6 +9,7 @@
 #include "vm/heap/become.h"
 #include "vm/heap/heap.h"
 #include "vm/heap/pages.h"
+#include "vm/heap/sweeper.h"
 #include "vm/thread_barrier.h"
 #include "vm/timeline.h"
 
@@ -18,6 +19,12 @@ DEFINE_FLAG(bool,
             force_evacuation,
             false,
             "Force compaction to move every movable object");
+DEFINE_FLAG(int,
+            compactor_dense_page_percent,
+            90,
+            "Pages whose live data at the last sweep was at least this "
+            "percentage of their capacity are swept in place instead of "
+            "compacted (100 compacts every page).");
 
 // Each OldPage is divided into blocks of size kBlockSize. Each object belongs
 // to the block containing its header word (so up to kBlockSize +
@@ -65,6 +72,13 @@ class ForwardingBlock {
                        << first_unit_position;
   }
 
+  // Makes Lookup the identity for every address in the block, for blocks of
+  // pages that are swept in place rather than slid.
+  void SetIdentity(uword block_start) {
+    new_address_ = block_start;
+    live_bitvector_ = ~static_cast<uword>(0);
+  }
+
   bool IsLive(uword old_addr) const {
     uword block_offset = old_addr & ~kBlockMask;
     intptr_t first_unit_position = block_offset >> kObjectAlignmentLog2;
@@ -94,6 +108,13 @@ class ForwardingPage {
 
   uword Lookup(uword old_addr) { return BlockFor(old_addr)->Lookup(old_addr); }
 
+  void SetIdentity(OldPage* page) {
+    const uword page_start = reinterpret_cast<uword>(page);
+    for (intptr_t i = 0; i < kBlocksPerPage; i++) {
+      blocks_[i].SetIdentity(page_start + i * kBlockSize);
+    }
+  }
+
   ForwardingBlock* BlockFor(uword old_addr) {
     intptr_t page_offset = old_addr & ~kOldPageMask;
     intptr_t block_number = page_offset / kBlockSize;
@@ -125,6 +146,7 @@ class CompactorTask : public ThreadPool::Task {
                 RelaxedAtomic<intptr_t>* next_forwarding_task,
                 OldPage* head,
                 OldPage** tail,
+                OldPage* in_place_head,
                 FreeList* freelist)
       : isolate_group_(isolate_group),
         compactor_(compactor),
@@ -132,6 +154,7 @@ class CompactorTask : public ThreadPool::Task {
         next_forwarding_task_(next_forwarding_task),
         head_(head),
         tail_(tail),
+        in_place_head_(in_place_head),
         freelist_(freelist),
         free_page_(NULL),
         free_current_(0),
@@ -146,6 +169,7 @@ class CompactorTask : public ThreadPool::Task {
   uword PlanBlock(uword first_object, ForwardingPage* forwarding_page);
   uword SlideBlock(uword first_object, ForwardingPage* forwarding_page);
   void PlanMoveToContiguousSize(intptr_t size);
+  void SweepInPlacePage(OldPage* page);
 
   IsolateGroup* isolate_group_;
   GCCompactor* compactor_;
@@ -153,6 +177,7 @@ class CompactorTask : public ThreadPool::Task {
   RelaxedAtomic<intptr_t>* next_forwarding_task_;
   OldPage* head_;
   OldPage** tail_;
+  OldPage* in_place_head_;
   FreeList* freelist_;
   OldPage* free_page_;
   uword free_current_;
@@ -172,6 +197,43 @@ void GCCompactor::Compact(OldPage* pages,
                           Mutex* pages_lock) {
   SetupImagePageBoundaries();
 
+  // Only slide the fragmented pages. Pages that were dense at the last sweep
+  // are swept in place, which costs a visit of their objects but no copying.
+  OldPage* in_place_pages = NULL;
+  intptr_t num_in_place_pages = 0;
+  if (!FLAG_force_evacuation && (FLAG_compactor_dense_page_percent < 100)) {
+    OldPage* movable_head = NULL;
+    OldPage* movable_tail = NULL;
+    OldPage* page = pages;
+    while (page != NULL) {
+      OldPage* next = page->next();
+      const intptr_t capacity = page->object_end() - page->object_start();
+      if ((page->used_in_bytes() * 100) >=
+          static_cast<uword>(capacity * FLAG_compactor_dense_page_percent)) {
+        page->set_next(in_place_pages);
+        in_place_pages = page;
+        num_in_place_pages++;
+      } else {
+        page->set_next(NULL);
+        if (movable_tail == NULL) {
+          movable_head = page;
+        } else {
+          movable_tail->set_next(page);
+        }
+        movable_tail = page;
+      }
+      page = next;
+    }
+    if (movable_head == NULL) {
+      // Keep at least one page to slide so every task has a destination.
+      movable_head = in_place_pages;
+      in_place_pages = in_place_pages->next();
+      movable_head->set_next(NULL);
+      num_in_place_pages--;
+    }
+    pages = movable_head;
+  }
+
   // Divide the heap.
   // TODO(30978): Try to divide based on live bytes or with work stealing.
   intptr_t num_pages = 0;
@@ -186,6 +248,30 @@ void GCCompactor::Compact(OldPage* pages,
   }
   OldPage** heads = new OldPage*[num_tasks];
   OldPage** tails = new OldPage*[num_tasks];
+  OldPage** in_place_heads = new OldPage*[num_tasks];
+  OldPage** in_place_tails = new OldPage*[num_tasks];
+  for (intptr_t task_index = 0; task_index < num_tasks; task_index++) {
+    in_place_heads[task_index] = in_place_tails[task_index] = NULL;
+  }
+  {
+    // Deal the in-place pages out round-robin.
+    intptr_t task_index = 0;
+    OldPage* page = in_place_pages;
+    while (page != NULL) {
+      OldPage* next = page->next();
+      page->set_next(in_place_heads[task_index]);
+      if (in_place_heads[task_index] == NULL) {
+        in_place_tails[task_index] = page;
+      }
+      in_place_heads[task_index] = page;
+      task_index = (task_index + 1) % num_tasks;
+      page = next;
+    }
+  }
+  if (FLAG_verbose_gc) {
+    OS::PrintErr("Compacting %" Pd " pages, sweeping %" Pd " in place\n",
+                 num_pages, num_in_place_pages);
+  }
 
   {
     const intptr_t pages_per_task = num_pages / num_tasks;
@@ -247,12 +333,14 @@ void GCCompactor::Compact(OldPage* pages,
         // Begin compacting on a helper thread.
         Dart::thread_pool()->Run<CompactorTask>(
             thread()->isolate_group(), this, &barrier, &next_forwarding_task,
-            heads[task_index], &tails[task_index], freelist);
+            heads[task_index], &tails[task_index], in_place_heads[task_index],
+            freelist);
       } else {
         // Last worker is the main thread.
         CompactorTask task(thread()->isolate_group(), this, &barrier,
                            &next_forwarding_task, heads[task_index],
-                           &tails[task_index], freelist);
+                           &tails[task_index], in_place_heads[task_index],
+                           freelist);
         task.RunEnteredIsolateGroup();
         barrier.Exit();
       }
@@ -308,21 +396,32 @@ void GCCompactor::Compact(OldPage* pages,
         OldPage* next = page->next();
         heap_->old_space()->IncreaseCapacityInWordsLocked(
             -(page->memory_->size() >> kWordSizeLog2));
+        heap_->old_space()->UnregisterPageLocked(page);
         page->Deallocate();
         page = next;
       }
     }
 
-    // Re-join the heap.
+    // Re-join the heap, with the pages swept in place after the compacted
+    // ones.
     for (intptr_t task_index = 0; task_index < num_tasks - 1; task_index++) {
       tails[task_index]->set_next(heads[task_index + 1]);
     }
-    tails[num_tasks - 1]->set_next(NULL);
+    OldPage* tail = tails[num_tasks - 1];
+    for (intptr_t task_index = 0; task_index < num_tasks; task_index++) {
+      if (in_place_heads[task_index] != NULL) {
+        tail->set_next(in_place_heads[task_index]);
+        tail = in_place_tails[task_index];
+      }
+    }
+    tail->set_next(NULL);
     heap_->old_space()->pages_ = pages = heads[0];
-    heap_->old_space()->pages_tail_ = tails[num_tasks - 1];
+    heap_->old_space()->pages_tail_ = tail;
 
     delete[] heads;
     delete[] tails;
+    delete[] in_place_heads;
+    delete[] in_place_tails;
   }
 }
 
@@ -354,6 +453,10 @@ void CompactorTask::RunEnteredIsolateGroup() {
       for (OldPage* page = head_; page != NULL; page = page->next()) {
         PlanPage(page);
       }
+      // Pointers into pages swept in place must forward to themselves.
+      for (OldPage* page = in_place_head_; page != NULL; page = page->next()) {
+        page->forwarding_page()->SetIdentity(page);
+      }
     }
 
     barrier_->Sync();
@@ -379,6 +482,13 @@ void CompactorTask::RunEnteredIsolateGroup() {
       *tail_ = free_page_;  // Last live page.
     }
 
+    {
+      TIMELINE_FUNCTION_GC_DURATION(thread, "SweepInPlace");
+      for (OldPage* page = in_place_head_; page != NULL; page = page->next()) {
+        SweepInPlacePage(page);
+      }
+    }
+
     // Heap: Regular pages already visited during sliding. Code and image pages
     // have no pointers to forward. Visit large pages and new-space.
 
@@ -461,6 +571,19 @@ void CompactorTask::SlidePage(OldPage* page) {
   }
 }
 
+// Sweeps a dense page without moving its objects, then forwards the pointers
+// of its survivors. Sweeping first turns the dead objects into free list
+// elements, so no stale pointer is followed into a released page.
+void CompactorTask::SweepInPlacePage(OldPage* page) {
+  GCSweeper sweeper;
+  if (!sweeper.SweepPage(page, freelist_, false)) {
+    // Everything died. The page stays in the heap, so make it walkable.
+    freelist_->Free(page->object_start(),
+                    page->object_end() - page->object_start());
+  }
+  page->VisitObjectPointers(compactor_);
+}
+
 // Plans the destination for a set of live objects starting with the first
 // live object that starts in a block, up to and including the last live
 // object that starts in that block.
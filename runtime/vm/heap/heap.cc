@@ -11,6 +11,7 @@
 #include "platform/utils.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/dart.h"
+#include "vm/dart_api_state.h"
 #include "vm/flags.h"
 #include "vm/heap/pages.h"
 #include "vm/heap/safepoint.h"
@@ -20,6 +21,7 @@
 #include "vm/isolate.h"
 #include "vm/lockers.h"
 #include "vm/object.h"
+#include "vm/object_graph.h"
 #include "vm/object_set.h"
 #include "vm/os.h"
 #include "vm/raw_object.h"
@@ -39,6 +41,11 @@ DEFINE_FLAG(bool,
             disable_heap_verification,
             false,
             "Explicitly disable heap verification.");
+DEFINE_FLAG(int,
+            external_gc_threshold,
+            400,
+            "Scavenge when the external memory owned by new-space objects "
+            "exceeds this percentage of the new space capacity.");
 
 // We ensure that the GC does not use the current isolate.
 class NoActiveIsolateScope {
@@ -65,6 +72,7 @@ Heap::Heap(IsolateGroup* isolate_group,
       is_vm_isolate_(is_vm_isolate),
       new_space_(this, max_new_gen_semi_words),
       old_space_(this, max_old_gen_words),
+      sampler_(this),
       barrier_(),
       barrier_done_(),
       read_only_(false),
@@ -111,36 +119,70 @@ uword Heap::AllocateNew(intptr_t size) {
   return AllocateOld(size, OldPage::kData);
 }
 
-uword Heap::AllocateOld(intptr_t size, OldPage::PageType type) {
+HeapBulkAllocator::HeapBulkAllocator(Thread* thread,
+                                     Heap::Space space,
+                                     intptr_t size)
+    : thread_(thread),
+      heap_(thread->heap()),
+      space_(space),
+      use_old_cache_(false) {
+  ASSERT(!heap_->read_only_);
+  ASSERT((space == Heap::kNew) || (space == Heap::kOld));
+  ASSERT(size >= 0);
+  size = Utils::RoundUp(size, kObjectAlignment);
+  // The reservation is a hint; a failure to reserve only means the batch is
+  // allocated object by object.
+  if (space == Heap::kNew) {
+    heap_->new_space()->TryReserveTLAB(
+        thread, Utils::Minimum(size, Heap::kNewAllocatableSize));
+  } else {
+    use_old_cache_ = true;
+    heap_->old_space()->TryReserveThreadCache(
+        thread,
+        Utils::Minimum(size, Heap::kAllocatablePageSize - kObjectAlignment));
+  }
+}
+
+uword Heap::AllocateOld(intptr_t size,
+                        OldPage::PageType type,
+                        bool is_hot_code) {
   ASSERT(Thread::Current()->no_safepoint_scope_depth() == 0);
   if (old_space_.GrowthControlState()) {
     CollectForDebugging();
-    uword addr = old_space_.TryAllocate(size, type);
+    Thread* thread = Thread::Current();
+    uword addr =
+        ((type == OldPage::kData) && (thread->heap() == this))
+            ? old_space_.TryAllocateCached(thread, size)
+            : old_space_.TryAllocate(size, type, PageSpace::kControlGrowth,
+                                     is_hot_code);
     if (addr != 0) {
       return addr;
     }
-    Thread* thread = Thread::Current();
     // Wait for any GC tasks that are in progress.
     WaitForSweeperTasks(thread);
-    addr = old_space_.TryAllocate(size, type);
+    addr = old_space_.TryAllocate(size, type, PageSpace::kControlGrowth,
+                                  is_hot_code);
     if (addr != 0) {
       return addr;
     }
     // All GC tasks finished without allocating successfully. Collect both
     // generations.
     CollectMostGarbage();
-    addr = old_space_.TryAllocate(size, type);
+    addr = old_space_.TryAllocate(size, type, PageSpace::kControlGrowth,
+                                  is_hot_code);
     if (addr != 0) {
       return addr;
     }
     // Wait for all of the concurrent tasks to finish before giving up.
     WaitForSweeperTasks(thread);
-    addr = old_space_.TryAllocate(size, type);
+    addr = old_space_.TryAllocate(size, type, PageSpace::kControlGrowth,
+                                  is_hot_code);
     if (addr != 0) {
       return addr;
     }
     // Force growth before attempting another synchronous GC.
-    addr = old_space_.TryAllocate(size, type, PageSpace::kForceGrowth);
+    addr = old_space_.TryAllocate(size, type, PageSpace::kForceGrowth,
+                                  is_hot_code);
     if (addr != 0) {
       return addr;
     }
@@ -148,7 +190,8 @@ uword Heap::AllocateOld(intptr_t size, OldPage::PageType type) {
     CollectAllGarbage(kLowMemory);
     WaitForSweeperTasks(thread);
   }
-  uword addr = old_space_.TryAllocate(size, type, PageSpace::kForceGrowth);
+  uword addr = old_space_.TryAllocate(size, type, PageSpace::kForceGrowth,
+                                      is_hot_code);
   if (addr != 0) {
     return addr;
   }
@@ -166,7 +209,8 @@ void Heap::AllocatedExternal(intptr_t size, Space space) {
   if (space == kNew) {
     Isolate::Current()->AssertCurrentThreadIsMutator();
     new_space_.AllocatedExternal(size);
-    if (new_space_.ExternalInWords() <= (4 * new_space_.CapacityInWords())) {
+    if ((new_space_.ExternalInWords() * 100) <=
+        (FLAG_external_gc_threshold * new_space_.CapacityInWords())) {
       return;
     }
     // Attempt to free some external allocation by a scavenge. (If the total
@@ -423,8 +467,40 @@ void Heap::NotifyIdle(int64_t deadline) {
   }
 }
 
+bool Heap::NotifyIdleSlice(int64_t deadline) {
+  Thread* thread = Thread::Current();
+  SafepointOperationScope safepoint_operation(thread);
+
+  // Marking and sweeping proceed concurrently, so the steps that need the
+  // mutators stopped are finalizing marking, scavenging and starting marking.
+  // Collections that block for O(heap) are left to NotifyIdle.
+  PageSpace::Phase phase;
+  {
+    MonitorLocker ml(old_space_.tasks_lock());
+    phase = old_space_.phase();
+  }
+  if (phase == PageSpace::kAwaitingFinalization) {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "IdleSliceGC");
+    CollectOldSpaceGarbage(thread, kMarkSweep, kFinalize);
+    return true;
+  }
+  if (new_space_.ShouldPerformIdleScavenge(deadline)) {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "IdleSliceGC");
+    CollectNewSpaceGarbage(thread, kIdle);
+    return true;
+  }
+  if ((phase == PageSpace::kDone) &&
+      old_space_.ShouldStartIdleMarkSweep(deadline)) {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "IdleSliceGC");
+    StartConcurrentMarking(thread);
+    return true;
+  }
+  return false;
+}
+
 void Heap::NotifyLowMemory() {
   CollectMostGarbage(kLowMemory);
+  OldPage::ClearCache();
 }
 
 void Heap::EvacuateNewSpace(Thread* thread, GCReason reason) {
@@ -451,16 +527,17 @@ void Heap::EvacuateNewSpace(Thread* thread, GCReason reason) {
 }
 
 void Heap::CollectNewSpaceGarbage(Thread* thread, GCReason reason) {
-  NoActiveIsolateScope no_active_isolate_scope;
-  ASSERT((reason != kOldSpace) && (reason != kPromotion));
-  if (thread->isolate_group() == Dart::vm_isolate()->group()) {
-    // The vm isolate cannot safely collect garbage due to unvisited read-only
-    // handles and slots bootstrapped with RAW_NULL. Ignore GC requests to
-    // trigger a nice out-of-memory message instead of a crash in the middle of
-    // visiting pointers.
-    return;
-  }
+  MallocGrowableArray<intptr_t> pretenured_cids;
   {
+    NoActiveIsolateScope no_active_isolate_scope;
+    ASSERT((reason != kOldSpace) && (reason != kPromotion));
+    if (thread->isolate_group() == Dart::vm_isolate()->group()) {
+      // The vm isolate cannot safely collect garbage due to unvisited
+      // read-only handles and slots bootstrapped with RAW_NULL. Ignore GC
+      // requests to trigger a nice out-of-memory message instead of a crash in
+      // the middle of visiting pointers.
+      return;
+    }
     SafepointOperationScope safepoint_operation(thread);
     RecordBeforeGC(kScavenge, reason);
     {
@@ -468,6 +545,7 @@ void Heap::CollectNewSpaceGarbage(Thread* thread, GCReason reason) {
                                                   : VMTag::kGCNewSpaceTagId);
       TIMELINE_FUNCTION_GC_DURATION_BASIC(thread, "CollectNewGeneration");
       new_space_.Scavenge();
+      new_space_.pretenuring()->TakeNewlyPretenured(&pretenured_cids);
       RecordAfterGC(kScavenge);
       PrintStats();
       NOT_IN_PRODUCT(PrintStatsToTimeline(&tbes, reason));
@@ -481,6 +559,31 @@ void Heap::CollectNewSpaceGarbage(Thread* thread, GCReason reason) {
       }
     }
   }
+  if (!pretenured_cids.is_empty()) {
+    DisableAllocationStubs(thread, pretenured_cids);
+  }
+}
+
+void Heap::DisableAllocationStubs(Thread* thread,
+                                  const MallocGrowableArray<intptr_t>& cids) {
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // The regenerated stubs of pretenured classes allocate through the runtime,
+  // which places the instances in old space. Other isolates of the group keep
+  // their inline allocation until their stubs are regenerated.
+  if (FLAG_precompiled_mode || !thread->IsMutatorThread()) {
+    return;
+  }
+  HANDLESCOPE(thread);
+  ClassTable* class_table = thread->isolate()->class_table();
+  Class& cls = Class::Handle(thread->zone());
+  for (intptr_t i = 0; i < cids.length(); i++) {
+    const intptr_t cid = cids[i];
+    if (class_table->IsValidIndex(cid) && class_table->HasValidClassAt(cid)) {
+      cls = class_table->At(cid);
+      cls.DisableAllocationStub();
+    }
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
 }
 
 void Heap::CollectOldSpaceGarbage(Thread* thread,
@@ -520,10 +623,7 @@ void Heap::CollectOldSpaceGarbage(Thread* thread,
 
     // Some Code objects may have been collected so invalidate handler cache.
     thread->isolate_group()->ForEachIsolate(
-        [&](Isolate* isolate) {
-          isolate->handler_info_cache()->Clear();
-          isolate->catch_entry_moves_cache()->Clear();
-        },
+        [&](Isolate* isolate) { isolate->ClearExceptionHandlerCaches(); },
         /*at_safepoint=*/true);
     last_gc_was_old_space_ = true;
     assume_scavenge_will_fail_ = false;
@@ -699,6 +799,7 @@ const char* Heap::RegionName(Space space) {
     case kOld:
       return "dart-oldspace";
     case kCode:
+    case kHotCode:
       return "dart-codespace";
     default:
       UNREACHABLE();
@@ -958,6 +1059,36 @@ void Heap::PrintToJSONObject(Space space, JSONObject* object) const {
   }
 }
 
+void Heap::PrintExternalToJSONObject(Space space, JSONObject* object) const {
+  Thread* thread = Thread::Current();
+  Isolate* isolate = thread->isolate();
+  if (isolate == nullptr) {
+    return;
+  }
+  ClassTable* class_table = isolate->class_table();
+  CountObjectsVisitor visitor(thread, class_table->NumCids());
+  // Mutators cannot be at a safepoint here, so the handles' referents do not
+  // move while they are visited.
+  isolate->group()->api_state()->RunWithLockedWeakPersistentHandles(
+      [&](FinalizablePersistentHandles& handles) {
+        handles.VisitHandles(&visitor);
+      });
+  const intptr_t* external_size = (space == kNew)
+                                      ? visitor.new_external_size_.get()
+                                      : visitor.old_external_size_.get();
+  JSONArray classes(object, "_externalByClass");
+  Class& cls = Class::Handle(thread->zone());
+  for (intptr_t cid = 1; cid < class_table->NumCids(); cid++) {
+    if ((external_size[cid] == 0) || !class_table->HasValidClassAt(cid)) {
+      continue;
+    }
+    cls = class_table->At(cid);
+    JSONObject entry(&classes);
+    entry.AddProperty("class", cls);
+    entry.AddProperty64("external", external_size[cid]);
+  }
+}
+
 void Heap::PrintMemoryUsageJSON(JSONStream* stream) const {
   JSONObject obj(stream);
   PrintMemoryUsageJSON(&obj);
@@ -1004,6 +1135,7 @@ void Heap::RecordAfterGC(GCType type) {
   }
   stats_.after_.new_ = new_space_.GetCurrentUsage();
   stats_.after_.old_ = old_space_.GetCurrentUsage();
+  RecordTotals(delta);
 #ifndef PRODUCT
   // For now we'll emit the same GC events on all isolates.
   if (Service::gc_stream.enabled()) {
@@ -1068,6 +1200,72 @@ void Heap::RecordAfterGC(GCType type) {
   }
 }
 
+void Heap::RecordTotals(int64_t pause_micros) {
+  const bool is_scavenge = stats_.type_ == kScavenge;
+  {
+    MutexLocker ml(&totals_mutex_);
+    GCTotals* totals = is_scavenge ? &scavenge_totals_ : &old_totals_;
+    totals->pauses.Add(pause_micros);
+    for (intptr_t i = 0; i < GCStats::kTimeEntries; i++) {
+      totals->times[i] += stats_.times_[i];
+    }
+  }
+  if (is_scavenge) {
+    isolate_group_->GetGCScavengeCountMetric()->increment();
+    isolate_group_->GetGCScavengeTimeMetric()->add(pause_micros);
+    isolate_group_->GetGCScavengeTimeMaxMetric()->SetValue(pause_micros);
+    isolate_group_->GetGCScavengeCopiedMetric()->add(
+        stats_.data_[Scavenger::kBytesCopied]);
+    isolate_group_->GetGCScavengePromotedMetric()->add(
+        stats_.data_[Scavenger::kBytesPromoted]);
+  } else {
+    isolate_group_->GetGCOldCountMetric()->increment();
+    isolate_group_->GetGCOldTimeMetric()->add(pause_micros);
+    isolate_group_->GetGCOldTimeMaxMetric()->SetValue(pause_micros);
+  }
+}
+
+static void GetPauseStats(const Histogram& pauses, Dart_GCPauseStats* stats) {
+  stats->total = pauses.total();
+  stats->max = pauses.max();
+  stats->p50 = pauses.Percentile(50.0);
+  stats->p90 = pauses.Percentile(90.0);
+  stats->p99 = pauses.Percentile(99.0);
+}
+
+void Heap::GetGCStatistics(Dart_GCStatistics* stats) {
+  MutexLocker ml(&totals_mutex_);
+  stats->scavenge_count = scavenge_totals_.pauses.count();
+  GetPauseStats(scavenge_totals_.pauses, &stats->scavenge_pause);
+  const int64_t* times = scavenge_totals_.times;
+  stats->scavenge_roots = times[Scavenger::kVisitIsolateRoots];
+  stats->scavenge_store_buffers = times[Scavenger::kIterateStoreBuffers];
+  stats->scavenge_copy = times[Scavenger::kProcessToSpace];
+  stats->scavenge_weak = times[Scavenger::kIterateWeaks];
+  stats->scavenge_copied = isolate_group_->GetGCScavengeCopiedMetric()->value();
+  stats->scavenge_promoted =
+      isolate_group_->GetGCScavengePromotedMetric()->value();
+
+  stats->old_count = old_totals_.pauses.count();
+  GetPauseStats(old_totals_.pauses, &stats->old_pause);
+  times = old_totals_.times;
+  stats->old_mark = times[PageSpace::kMarkObjects];
+  stats->old_sweep = times[PageSpace::kSweepPages] +
+                     times[PageSpace::kSweepLargePages] -
+                     times[PageSpace::kCompact];
+  stats->old_compact = times[PageSpace::kCompact];
+}
+
+int64_t Heap::ScavengePausePercentile(double percentile) {
+  MutexLocker ml(&totals_mutex_);
+  return scavenge_totals_.pauses.Percentile(percentile);
+}
+
+int64_t Heap::OldPausePercentile(double percentile) {
+  MutexLocker ml(&totals_mutex_);
+  return old_totals_.pauses.Percentile(percentile);
+}
+
 void Heap::PrintStats() {
 #if !defined(PRODUCT)
   if (!FLAG_verbose_gc) return;
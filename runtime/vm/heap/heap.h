@@ -16,6 +16,7 @@
 #include "vm/flags.h"
 #include "vm/globals.h"
 #include "vm/heap/pages.h"
+#include "vm/heap/sampler.h"
 #include "vm/heap/scavenger.h"
 #include "vm/heap/spaces.h"
 #include "vm/heap/weak_table.h"
@@ -38,6 +39,9 @@ class Heap {
     kNew,
     kOld,
     kCode,
+    // Code which is expected to run often. It is allocated on executable
+    // pages of its own to keep it dense.
+    kHotCode,
   };
 
   enum WeakSelector {
@@ -48,6 +52,7 @@ class Heap {
     kCanonicalHashes,
     kObjectIds,
     kLoadingUnits,
+    kHeapSamples,
     kNumWeakSelectors
   };
 
@@ -91,6 +96,8 @@ class Heap {
         return AllocateOld(size, OldPage::kData);
       case kCode:
         return AllocateOld(size, OldPage::kExecutable);
+      case kHotCode:
+        return AllocateOld(size, OldPage::kExecutable, /*is_hot_code=*/true);
       default:
         UNREACHABLE();
     }
@@ -125,6 +132,9 @@ class Heap {
 
   void HintFreed(intptr_t size);
   void NotifyIdle(int64_t deadline);
+  // Like NotifyIdle, but only runs GC work that is expected to finish by
+  // [deadline]. Returns whether any work was done.
+  bool NotifyIdleSlice(int64_t deadline);
   void NotifyLowMemory();
 
   // Collect a single generation.
@@ -248,6 +258,8 @@ class Heap {
     return GetWeakEntry(raw_obj, kLoadingUnits);
   }
 
+  HeapSampler* sampler() { return &sampler_; }
+
   // Used by the GC algorithms to propagate weak entries.
   intptr_t GetWeakEntry(ObjectPtr raw_obj, WeakSelector sel) const;
   void SetWeakEntry(ObjectPtr raw_obj, WeakSelector sel, intptr_t val);
@@ -284,6 +296,12 @@ class Heap {
 
   void UpdateGlobalMaxUsed();
 
+  // Cumulative statistics of all collections of this heap. Safe to call from
+  // any thread.
+  void GetGCStatistics(Dart_GCStatistics* stats);
+  int64_t ScavengePausePercentile(double percentile);
+  int64_t OldPausePercentile(double percentile);
+
   static bool IsAllocatableInNewSpace(intptr_t size) {
     return size <= kNewAllocatableSize;
   }
@@ -294,6 +312,10 @@ class Heap {
 #ifndef PRODUCT
   void PrintToJSONObject(Space space, JSONObject* object) const;
 
+  // Adds the external memory owned by the objects of the given space,
+  // attributed to their classes.
+  void PrintExternalToJSONObject(Space space, JSONObject* object) const;
+
   // Returns a JSON object with total memory usage statistics for both new and
   // old space combined.
   void PrintMemoryUsageJSON(JSONStream* stream) const;
@@ -341,7 +363,7 @@ class Heap {
       DISALLOW_COPY_AND_ASSIGN(Data);
     };
 
-    enum { kTimeEntries = 6 };
+    enum { kTimeEntries = 7 };
     enum { kDataEntries = 4 };
 
     Data before_;
@@ -359,7 +381,9 @@ class Heap {
        intptr_t max_old_gen_words);
 
   uword AllocateNew(intptr_t size);
-  uword AllocateOld(intptr_t size, OldPage::PageType type);
+  uword AllocateOld(intptr_t size,
+                    OldPage::PageType type,
+                    bool is_hot_code = false);
 
   // Visit all pointers. Caller must ensure concurrent sweeper is not running,
   // and the visitor must not allocate.
@@ -377,12 +401,17 @@ class Heap {
 
   // Helper functions for garbage collection.
   void CollectNewSpaceGarbage(Thread* thread, GCReason reason);
+  // Makes the next allocation of newly pretenured classes regenerate their
+  // allocation stubs.
+  void DisableAllocationStubs(Thread* thread,
+                              const MallocGrowableArray<intptr_t>& cids);
   void CollectOldSpaceGarbage(Thread* thread, GCType type, GCReason reason);
   void EvacuateNewSpace(Thread* thread, GCReason reason);
 
   // GC stats collection.
   void RecordBeforeGC(GCType type, GCReason reason);
   void RecordAfterGC(GCType type);
+  void RecordTotals(int64_t pause_micros);
   void PrintStats();
   void PrintStatsToTimeline(TimelineEventScope* event, GCReason reason);
 
@@ -401,12 +430,23 @@ class Heap {
   WeakTable* new_weak_tables_[kNumWeakSelectors];
   WeakTable* old_weak_tables_[kNumWeakSelectors];
 
+  HeapSampler sampler_;
+
   mutable Monitor barrier_;
   mutable Monitor barrier_done_;
 
   // GC stats collection.
   GCStats stats_;
 
+  // Pauses and phase times summed over all collections of a kind.
+  struct GCTotals {
+    Histogram pauses;
+    int64_t times[GCStats::kTimeEntries] = {};
+  };
+  Mutex totals_mutex_;
+  GCTotals scavenge_totals_;
+  GCTotals old_totals_;
+
   // This heap is in read-only mode: No allocation is allowed.
   bool read_only_;
 
@@ -432,12 +472,58 @@ class Heap {
   friend class HeapIterationScope;    // VisitObjects
   friend class ProgramVisitor;        // VisitObjectsImagePages
   friend class Serializer;            // VisitObjectsImagePages
+  friend class HeapBulkAllocator;     // read_only_
+  friend class HeapSnapshotWriter;    // EvacuateNewSpace
   friend class HeapTestHelper;
   friend class MetricsTestHelper;
 
   DISALLOW_COPY_AND_ASSIGN(Heap);
 };
 
+// Reserves room for a batch of objects whose total size is known up front,
+// e.g., when deserializing a message, so that each object is carved out by
+// bumping the thread's allocation top instead of going through
+// Heap::Allocate. Objects that do not fit the reservation, e.g., because a GC
+// discarded it, fall back to Heap::Allocate. The caller initializes the
+// objects as usual.
+class HeapBulkAllocator : public ValueObject {
+ public:
+  HeapBulkAllocator(Thread* thread, Heap::Space space, intptr_t size);
+
+  uword Allocate(intptr_t size) {
+    ASSERT(Utils::IsAligned(size, kObjectAlignment));
+    if (space_ == Heap::kNew) {
+      const uword top = thread_->top();
+      if (LIKELY(Heap::IsAllocatableInNewSpace(size) &&
+                 (static_cast<intptr_t>(thread_->end() - top) >= size))) {
+        thread_->set_top(top + size);
+        return top;
+      }
+    } else if (use_old_cache_) {
+      const uword top = thread_->old_cache_top();
+      const uword end = thread_->old_cache_end();
+      if (LIKELY(static_cast<intptr_t>(end - top) >= size)) {
+        const uword new_top = top + size;
+        if (new_top < end) {
+          // Keep the rest of the reservation walkable.
+          FreeListElement::AsElement(new_top, end - new_top);
+        }
+        thread_->set_old_cache(new_top, end);
+        return top;
+      }
+    }
+    return heap_->Allocate(size, space_);
+  }
+
+ private:
+  Thread* const thread_;
+  Heap* const heap_;
+  const Heap::Space space_;
+  bool use_old_cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapBulkAllocator);
+};
+
 class HeapIterationScope : public ThreadStackResource {
  public:
   explicit HeapIterationScope(Thread* thread, bool writable = false);
@@ -15,6 +15,7 @@
 #include "vm/globals.h"
 #include "vm/heap/become.h"
 #include "vm/heap/heap.h"
+#include "vm/json_stream.h"
 #include "vm/message_handler.h"
 #include "vm/object_graph.h"
 #include "vm/port.h"
@@ -23,6 +24,15 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, concurrent_from_space_release);
+DECLARE_FLAG(int, external_gc_threshold);
+DECLARE_FLAG(int, heap_sample_interval);
+DECLARE_FLAG(int, new_gen_pause_target_micros);
+DECLARE_FLAG(bool, marker_prefetch);
+DECLARE_FLAG(bool, pretenure);
+DECLARE_FLAG(int, pretenure_min_promoted_kb);
+DECLARE_FLAG(int, pretenure_scavenges);
+
 TEST_CASE(OldGC) {
   const char* kScriptChars =
       "main() {\n"
@@ -482,6 +492,445 @@ ISOLATE_UNIT_TEST_CASE(CollectAllGarbage_LiveOldToNewChain) {
   EXPECT(size_before < size_after);
 }
 
+ISOLATE_UNIT_TEST_CASE(ParallelScavenge_DeepChains) {
+  Heap* heap = Isolate::Current()->heap();
+
+  // A few long chains, so that most of the work initially belongs to the few
+  // workers that happen to visit the chains' roots first.
+  const intptr_t kNumChains = 8;
+  const intptr_t kChainLength = 2000;
+  Array& roots = Array::Handle(Array::New(kNumChains, Heap::kOld));
+  Array& node = Array::Handle();
+  Array& previous = Array::Handle();
+  Smi& value = Smi::Handle();
+  for (intptr_t i = 0; i < kNumChains; i++) {
+    previous = Array::null();
+    for (intptr_t j = 0; j < kChainLength; j++) {
+      node = Array::New(2, Heap::kNew);
+      node.SetAt(0, previous);
+      value = Smi::New(i * kChainLength + j);
+      node.SetAt(1, value);
+      previous = node.raw();
+    }
+    roots.SetAt(i, previous);
+  }
+
+  // The first scavenge copies the chains, the second promotes them.
+  GCTestHelper::CollectNewSpace();
+  GCTestHelper::CollectNewSpace();
+
+  for (intptr_t i = 0; i < kNumChains; i++) {
+    node ^= roots.At(i);
+    for (intptr_t j = kChainLength - 1; j >= 0; j--) {
+      value ^= node.At(1);
+      EXPECT_EQ(i * kChainLength + j, value.Value());
+      node ^= node.At(0);
+    }
+    EXPECT(node.IsNull());
+  }
+
+  const ScavengeStats& stats = heap->new_space()->last_stats();
+  if (FLAG_scavenger_tasks == 0) {
+    EXPECT_EQ(0, stats.num_workers());
+  } else {
+    EXPECT_EQ(Utils::Minimum<intptr_t>(FLAG_scavenger_tasks,
+                                       ScavengeStats::kMaxRecordedWorkers),
+              stats.num_workers());
+    for (intptr_t i = 0; i < stats.num_workers(); i++) {
+      EXPECT(stats.worker(i).busy_micros >= 0);
+      EXPECT(stats.worker(i).idle_micros >= 0);
+    }
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(ConcurrentFromSpaceRelease) {
+  FLAG_concurrent_from_space_release = true;
+  Array& survivors = Array::Handle(Array::New(16, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < 8; i++) {
+    // Fill new space with mostly garbage so every scavenge has a full
+    // from-space to hand off.
+    for (intptr_t j = 0; j < 1000; j++) {
+      element = Array::New(16, Heap::kNew);
+    }
+    survivors.SetAt(i, element);
+    GCTestHelper::CollectNewSpace();
+  }
+  for (intptr_t i = 0; i < 8; i++) {
+    element ^= survivors.At(i);
+    EXPECT_EQ(16, element.Length());
+  }
+  FLAG_concurrent_from_space_release = false;
+}
+
+ISOLATE_UNIT_TEST_CASE(NewGenPauseTarget) {
+  Heap* heap = Isolate::Current()->heap();
+  const intptr_t max_in_words = FLAG_new_gen_semi_max_size * MBInWords;
+  const intptr_t min_in_words =
+      Utils::Minimum(max_in_words, FLAG_new_gen_semi_initial_size * MBInWords);
+  Array& survivors = Array::Handle(Array::New(64, Heap::kOld));
+  Array& element = Array::Handle();
+
+  // An unreachable target shrinks new space towards its initial size.
+  FLAG_new_gen_pause_target_micros = 1;
+  for (intptr_t i = 0; i < 8; i++) {
+    for (intptr_t j = 0; j < 64; j++) {
+      element = Array::New(64, Heap::kNew);
+      survivors.SetAt(j, element);
+    }
+    GCTestHelper::CollectNewSpace();
+    EXPECT(heap->new_space()->CapacityInWords() >= min_in_words);
+    EXPECT(heap->new_space()->CapacityInWords() <= max_in_words);
+  }
+  const intptr_t small_in_words = heap->new_space()->CapacityInWords();
+
+  // A generous target lets it grow again, bounded by the maximum.
+  FLAG_new_gen_pause_target_micros = 1000000;
+  for (intptr_t i = 0; i < 8; i++) {
+    GCTestHelper::CollectNewSpace();
+    EXPECT(heap->new_space()->CapacityInWords() <= max_in_words);
+  }
+  EXPECT(heap->new_space()->CapacityInWords() >= small_in_words);
+  FLAG_new_gen_pause_target_micros = 0;
+}
+
+ISOLATE_UNIT_TEST_CASE(ConcurrentSweep_LazyAllocation) {
+  Heap* heap = Isolate::Current()->heap();
+  GCTestHelper::CollectOldSpace();
+
+  // Leave many partially live pages behind for the sweeper.
+  const intptr_t kNumArrays = 20000;
+  Array& survivors = Array::Handle(Array::New(kNumArrays / 4, Heap::kOld));
+  Array& element = Array::Handle();
+  Smi& value = Smi::Handle();
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element = Array::New(8, Heap::kOld);
+    if ((i % 4) == 0) {
+      value = Smi::New(i);
+      element.SetAt(0, value);
+      survivors.SetAt(i / 4, element);
+    }
+  }
+
+  // Start a concurrent sweep and allocate while it may still be running, so
+  // some of the allocations are satisfied by sweeping pages lazily.
+  heap->CollectGarbage(Heap::kMarkSweep, Heap::kDebugging);
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element = Array::New(8, Heap::kOld);
+  }
+  GCTestHelper::WaitForGCTasks();
+
+  for (intptr_t i = 0; i < kNumArrays / 4; i++) {
+    element ^= survivors.At(i);
+    value ^= element.At(0);
+    EXPECT_EQ(i * 4, value.Value());
+  }
+  GCTestHelper::CollectOldSpace();
+}
+
+ISOLATE_UNIT_TEST_CASE(PartialCompaction) {
+  Heap* heap = Isolate::Current()->heap();
+  GCTestHelper::CollectOldSpace();
+
+  // Interleave objects that all survive with objects of which only one in
+  // eight survives, so the sweep before compaction leaves both dense and
+  // fragmented pages.
+  const intptr_t kNumArrays = 8000;
+  Array& dense = Array::Handle(Array::New(kNumArrays, Heap::kOld));
+  Array& sparse = Array::Handle(Array::New(kNumArrays / 8, Heap::kOld));
+  Array& element = Array::Handle();
+  Smi& value = Smi::Handle();
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element = Array::New(4, Heap::kOld);
+    value = Smi::New(i);
+    element.SetAt(0, value);
+    dense.SetAt(i, element);
+  }
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element = Array::New(4, Heap::kOld);
+    value = Smi::New(-i);
+    element.SetAt(0, value);
+    element.SetAt(1, dense);
+    if ((i % 8) == 0) {
+      sparse.SetAt(i / 8, element);
+    }
+  }
+  GCTestHelper::CollectOldSpace();
+
+  heap->CollectGarbage(Heap::kMarkCompact, Heap::kDebugging);
+  GCTestHelper::WaitForGCTasks();
+
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element ^= dense.At(i);
+    value ^= element.At(0);
+    EXPECT_EQ(i, value.Value());
+  }
+  for (intptr_t i = 0; i < kNumArrays / 8; i++) {
+    element ^= sparse.At(i);
+    value ^= element.At(0);
+    EXPECT_EQ(-i * 8, value.Value());
+    EXPECT(element.At(1) == dense.raw());
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(OldSpaceThreadCache) {
+  Heap* heap = Isolate::Current()->heap();
+  GCTestHelper::CollectOldSpace();
+
+  // Consecutive small old-space allocations are bump allocated from the
+  // thread's cache.
+  Array& first = Array::Handle(Array::New(1, Heap::kOld));
+  Array& second = Array::Handle(Array::New(1, Heap::kOld));
+  EXPECT_EQ(ObjectLayout::ToAddr(first.raw()) + first.raw()->ptr()->HeapSize(),
+            ObjectLayout::ToAddr(second.raw()));
+  EXPECT(thread->old_cache_top() == ObjectLayout::ToAddr(second.raw()) +
+                                        second.raw()->ptr()->HeapSize());
+
+  // The rest of the cache stays walkable, and is reclaimed by a collection.
+  EXPECT(heap->Verify());
+  GCTestHelper::CollectOldSpace();
+  EXPECT_EQ(0u, thread->old_cache_top());
+  EXPECT_EQ(0u, thread->old_cache_end());
+  EXPECT_EQ(1, first.Length());
+  EXPECT_EQ(1, second.Length());
+}
+
+ISOLATE_UNIT_TEST_CASE(ParallelMark_DeepChains) {
+  Heap* heap = Isolate::Current()->heap();
+
+  // A single deep chain next to a wide array, so that one marker must share
+  // its work and the prefetch ring sees both long and short runs of objects.
+  const intptr_t kChainLength = 10000;
+  const intptr_t kWidth = 1000;
+  Array& roots = Array::Handle(Array::New(2, Heap::kOld));
+  Array& node = Array::Handle();
+  Array& previous = Array::Handle();
+  Smi& value = Smi::Handle();
+  for (intptr_t j = 0; j < kChainLength; j++) {
+    node = Array::New(2, Heap::kOld);
+    node.SetAt(0, previous);
+    value = Smi::New(j);
+    node.SetAt(1, value);
+    previous = node.raw();
+  }
+  roots.SetAt(0, previous);
+  Array& wide = Array::Handle(Array::New(kWidth, Heap::kOld));
+  for (intptr_t j = 0; j < kWidth; j++) {
+    node = Array::New(1, Heap::kOld);
+    wide.SetAt(j, node);
+  }
+  roots.SetAt(1, wide);
+  previous = Array::null();
+  wide = Array::null();
+
+  const bool saved_prefetch = FLAG_marker_prefetch;
+  intptr_t used_in_words[2];
+  for (intptr_t i = 0; i < 2; i++) {
+    FLAG_marker_prefetch = (i == 0);
+    GCTestHelper::CollectOldSpace();
+    used_in_words[i] = heap->UsedInWords(Heap::kOld);
+
+    node ^= roots.At(0);
+    for (intptr_t j = kChainLength - 1; j >= 0; j--) {
+      value ^= node.At(1);
+      EXPECT_EQ(j, value.Value());
+      node ^= node.At(0);
+    }
+    EXPECT(node.IsNull());
+    wide ^= roots.At(1);
+    for (intptr_t j = 0; j < kWidth; j++) {
+      node ^= wide.At(j);
+      EXPECT_EQ(1, node.Length());
+    }
+    wide = Array::null();
+    EXPECT(heap->Verify());
+  }
+  FLAG_marker_prefetch = saved_prefetch;
+
+  // Prefetching only changes the order in which objects are marked.
+  EXPECT_EQ(used_in_words[0], used_in_words[1]);
+}
+
+ISOLATE_UNIT_TEST_CASE(PromotedLargeArrayUsesCards) {
+  Heap* heap = Isolate::Current()->heap();
+
+  // Big enough for a large page once promoted, small enough for new space.
+  const intptr_t kLength = 10000;
+  EXPECT(!Array::UseCardMarkingForAllocation(kLength));
+  EXPECT(!Heap::IsAllocatableViaFreeLists(Array::InstanceSize(kLength)));
+
+  Array& array = Array::Handle(Array::New(kLength, Heap::kNew));
+  EXPECT(!array.raw()->ptr()->IsCardRemembered());
+  GCTestHelper::CollectNewSpace();
+  GCTestHelper::CollectNewSpace();
+  EXPECT(array.raw()->IsOldObject());
+  EXPECT(array.raw()->ptr()->IsCardRemembered());
+  EXPECT(!array.raw()->ptr()->IsRemembered());
+
+  // Stores of new objects dirty single cards, which keep their targets alive
+  // across scavenges.
+  String& string = String::Handle();
+  for (intptr_t i = 0; i < kLength; i += kLength / 7) {
+    string = OneByteString::New("card", Heap::kNew);
+    array.SetAt(i, string);
+  }
+  string = String::null();
+  GCTestHelper::CollectNewSpace();
+  GCTestHelper::CollectNewSpace();
+  GCTestHelper::CollectNewSpace();
+  for (intptr_t i = 0; i < kLength; i++) {
+    string ^= array.At(i);
+    if ((i % (kLength / 7)) == 0) {
+      EXPECT(string.Equals("card"));
+    } else {
+      EXPECT(string.IsNull());
+    }
+  }
+  EXPECT(heap->Verify());
+}
+
+ISOLATE_UNIT_TEST_CASE(LargePageContainsEveryGranule) {
+  Heap* heap = Isolate::Current()->heap();
+
+  // Spans several kOldPageSize granules of the page table.
+  const intptr_t kLength = 4 * kOldPageSize / kWordSize;
+  const Array& array = Array::Handle(Array::New(kLength, Heap::kOld));
+  const uword start = ObjectLayout::ToAddr(array.raw());
+  const uword end = start + array.raw()->ptr()->HeapSize();
+  for (uword addr = start; addr < end; addr += kOldPageSize / 2) {
+    EXPECT(heap->Contains(addr));
+    EXPECT(heap->DataContains(addr));
+    EXPECT(!heap->CodeContains(addr));
+  }
+  EXPECT(heap->Contains(end - kWordSize));
+}
+
+ISOLATE_UNIT_TEST_CASE(OldPageCache_ReusesFreedPages) {
+  Heap* heap = Isolate::Current()->heap();
+  OldPage::ClearCache();
+
+  {
+    HANDLESCOPE(thread);
+    Array& array = Array::Handle();
+    for (intptr_t i = 0; i < 4 * kOldPageSize / KB; i++) {
+      array = Array::New(KB / kWordSize, Heap::kOld);
+    }
+  }
+  GCTestHelper::CollectAllGarbage();
+  EXPECT(OldPage::CachedSize() > 0);
+
+  heap->NotifyLowMemory();
+  EXPECT_EQ(0, OldPage::CachedSize());
+}
+
+ISOLATE_UNIT_TEST_CASE(BlockStack_LockFreeFullHandOff) {
+  MarkingStack stack;
+  EXPECT(stack.IsEmpty());
+
+  // Full blocks take the lock-free path, partial blocks the locked one.
+  const intptr_t kNumFull = 5;
+  for (intptr_t i = 0; i < kNumFull; i++) {
+    MarkingStackBlock* block = stack.PopEmptyBlock();
+    while (!block->IsFull()) {
+      block->Push(Smi::New(i));
+    }
+    stack.PushBlock(block);
+  }
+  MarkingStackBlock* partial = stack.PopEmptyBlock();
+  partial->Push(Smi::New(kNumFull));
+  stack.PushBlock(partial);
+  EXPECT(!stack.IsEmpty());
+
+  intptr_t num_full = 0;
+  intptr_t num_partial = 0;
+  MarkingStackBlock* block;
+  while ((block = stack.PopNonEmptyBlock()) != nullptr) {
+    if (block->IsFull()) {
+      num_full++;
+    } else {
+      num_partial++;
+    }
+    while (!block->IsEmpty()) {
+      block->Pop();
+    }
+    stack.PushBlock(block);
+  }
+  EXPECT_EQ(kNumFull, num_full);
+  EXPECT_EQ(1, num_partial);
+  EXPECT(stack.IsEmpty());
+}
+
+ISOLATE_UNIT_TEST_CASE(Heap_BulkAllocator) {
+  Heap* heap = IsolateGroup::Current()->heap();
+  const intptr_t kNumObjects = 100;
+  const intptr_t kObjectSize = 4 * kObjectAlignment;
+  const Heap::Space spaces[] = {Heap::kNew, Heap::kOld};
+  for (Heap::Space space : spaces) {
+    GCTestHelper::CollectAllGarbage();
+    HeapBulkAllocator allocator(thread, space, kNumObjects * kObjectSize);
+    uword previous = 0;
+    for (intptr_t i = 0; i < kNumObjects; i++) {
+      const uword address = allocator.Allocate(kObjectSize);
+      EXPECT(address != 0);
+      // Objects come out of the reservation back to back.
+      if (previous != 0) {
+        EXPECT_EQ(previous + kObjectSize, address);
+      }
+      EXPECT_EQ(space == Heap::kNew,
+                heap->new_space()->Contains(address));
+      FreeListElement::AsElement(address, kObjectSize);
+      previous = address;
+    }
+  }
+  GCTestHelper::CollectAllGarbage();
+  EXPECT(heap->Verify());
+}
+
+TEST_CASE(Pretenuring_PromotedClass) {
+  const char* kScriptChars =
+      "class Entry {\n"
+      "  var next;\n"
+      "  Entry(this.next);\n"
+      "}\n"
+      "var cache;\n"
+      "build(n) {\n"
+      "  var head = null;\n"
+      "  for (var i = 0; i < n; i++) head = new Entry(head);\n"
+      "  cache = head;\n"
+      "}\n"
+      "allocate() => new Entry(null);\n";
+  FLAG_pretenure = true;
+  FLAG_pretenure_min_promoted_kb = 1;
+  FLAG_pretenure_scavenges = 1;
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(h_lib);
+  Dart_Handle args[] = {Dart_NewInteger(10000)};
+  EXPECT_VALID(Dart_Invoke(h_lib, NewString("build"), 1, args));
+  {
+    TransitionNativeToVM transition(thread);
+    Library& lib = Library::Handle();
+    lib ^= Api::UnwrapHandle(h_lib);
+    const Class& cls = Class::Handle(
+        lib.LookupClass(String::Handle(Symbols::New(thread, "Entry"))));
+    EXPECT(!cls.IsNull());
+    Heap* heap = thread->heap();
+    EXPECT(!heap->new_space()->ShouldPretenure(cls.id()));
+    // The first scavenge copies the entries, the second promotes them.
+    heap->CollectGarbage(Heap::kNew);
+    heap->CollectGarbage(Heap::kNew);
+    EXPECT(heap->new_space()->ShouldPretenure(cls.id()));
+  }
+  Dart_Handle result = Dart_Invoke(h_lib, NewString("allocate"), 0, NULL);
+  EXPECT_VALID(result);
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT(Api::UnwrapHandle(result)->IsOldObject());
+  }
+  FLAG_pretenure = false;
+  FLAG_pretenure_min_promoted_kb = 256;
+  FLAG_pretenure_scavenges = 3;
+}
+
 static void NoopFinalizer(void* isolate_callback_data, void* peer) {}
 
 ISOLATE_UNIT_TEST_CASE(ExternalPromotion) {
@@ -689,8 +1138,45 @@ ISOLATE_UNIT_TEST_CASE(ExternalAllocationStats) {
               heap->new_space()->ExternalInWords() * kWordSize);
   }
 }
+
+ISOLATE_UNIT_TEST_CASE(ExternalByClassJSON) {
+  Isolate* isolate = thread->isolate();
+  Heap* heap = thread->heap();
+
+  const Array& old = Array::Handle(Array::New(1, Heap::kOld));
+  FinalizablePersistentHandle::New(isolate, old, NULL, NoopFinalizer, 1 * MB,
+                                   /*auto_delete=*/true);
+
+  JSONStream js;
+  {
+    JSONObject jsobj(&js);
+    heap->PrintToJSONObject(Heap::kOld, &jsobj);
+  }
+  EXPECT_SUBSTRING("\"_externalByClass\":[{", js.ToCString());
+  EXPECT_SUBSTRING("\"name\":\"_List\"", js.ToCString());
+}
 #endif  // !defined(PRODUCT)
 
+ISOLATE_UNIT_TEST_CASE(ExternalGCThreshold) {
+  Isolate* isolate = thread->isolate();
+  Heap* heap = thread->heap();
+  const intptr_t saved_threshold = FLAG_external_gc_threshold;
+
+  // With no allowance, any external memory owned by a new-space object
+  // triggers a scavenge.
+  FLAG_external_gc_threshold = 0;
+  const intptr_t collections_before = heap->new_space()->collections();
+  {
+    HANDLESCOPE(thread);
+    const Array& neu = Array::Handle(Array::New(1, Heap::kNew));
+    FinalizablePersistentHandle::New(isolate, neu, NULL, NoopFinalizer, 1 * MB,
+                                     /*auto_delete=*/true);
+  }
+  EXPECT_LT(collections_before, heap->new_space()->collections());
+
+  FLAG_external_gc_threshold = saved_threshold;
+}
+
 ISOLATE_UNIT_TEST_CASE(ArrayTruncationRaces) {
   // Alternate between allocating new lists and truncating.
   // For each list, the life cycle is
@@ -736,4 +1222,42 @@ ISOLATE_UNIT_TEST_CASE(ArrayTruncationRaces) {
   }
 }
 
+#if !defined(PRODUCT)
+TEST_CASE(HeapSampler_LiveFoldedStacks) {
+  SetFlagScope<int> sfs(&FLAG_heap_sample_interval, 4 * KB);
+  const char* kScriptChars =
+      "class Foo {}\n"
+      "var live;\n"
+      "makeFoos() {\n"
+      "  live = <Foo>[];\n"
+      "  for (var i = 0; i < 100000; i++) live.add(new Foo());\n"
+      "}\n"
+      "makeGarbage() {\n"
+      "  var sum = 0;\n"
+      "  for (var i = 0; i < 100000; i++) sum += new List(4).length;\n"
+      "  return sum;\n"
+      "}\n"
+      "main() {\n"
+      "  makeFoos();\n"
+      "  makeGarbage();\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+
+  char* profile = NULL;
+  intptr_t profile_length = 0;
+  char* error = NULL;
+  EXPECT(Dart_GetHeapSampleFoldedStacks(&profile, &profile_length, &error));
+  EXPECT(error == NULL);
+  EXPECT_EQ(static_cast<intptr_t>(strlen(profile)), profile_length);
+  // The sampled Foos are still alive, but the lists allocated by makeGarbage
+  // are all dead.
+  EXPECT_SUBSTRING("makeFoos;Foo ", profile);
+  EXPECT_NOTSUBSTRING("makeGarbage;", profile);
+  free(profile);
+}
+#endif  // !defined(PRODUCT)
+
 }  // namespace dart
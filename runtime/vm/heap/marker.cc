@@ -22,6 +22,12 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            marker_prefetch,
+            true,
+            "Prefetch the headers of objects found by the marker before "
+            "testing their mark bits.");
+
 template <bool sync>
 class MarkingVisitorBase : public ObjectPointerVisitor {
  public:
@@ -41,6 +47,14 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   }
   ~MarkingVisitorBase() {}
 
+  // Enables sharing work with idle parallel markers. num_busy counts the
+  // markers that are not waiting for work.
+  void set_work_sharing(RelaxedAtomic<uintptr_t>* num_busy,
+                        intptr_t num_markers) {
+    num_busy_ = num_busy;
+    num_markers_ = num_markers;
+  }
+
   uintptr_t marked_bytes() const { return marked_bytes_; }
   int64_t marked_micros() const { return marked_micros_; }
   void AddMicros(int64_t micros) { marked_micros_ += micros; }
@@ -73,9 +87,9 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   }
 
   void DrainMarkingStack() {
-    ObjectPtr raw_obj = work_list_.Pop();
+    ObjectPtr raw_obj = PopWork();
     if ((raw_obj == nullptr) && ProcessPendingWeakProperties()) {
-      raw_obj = work_list_.Pop();
+      raw_obj = PopWork();
     }
 
     if (raw_obj == nullptr) {
@@ -96,7 +110,16 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
         }
         marked_bytes_ += size;
 
-        raw_obj = work_list_.Pop();
+        if (UNLIKELY(++objects_since_share_check_ >= kShareCheckInterval)) {
+          objects_since_share_check_ = 0;
+          if ((num_busy_ != nullptr) &&
+              (num_busy_->load() < static_cast<uintptr_t>(num_markers_))) {
+            // Another marker is waiting for work; give it some of ours.
+            work_list_.Share();
+          }
+        }
+
+        raw_obj = PopWork();
       } while (raw_obj != nullptr);
 
       // Marking stack is empty.
@@ -104,7 +127,7 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
       // Check whether any further work was pushed either by other markers or
       // by the handling of weak properties.
-      raw_obj = work_list_.Pop();
+      raw_obj = PopWork();
     } while (raw_obj != nullptr);
   }
 
@@ -173,6 +196,7 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
         marked_bytes_ += size;
       }
     }
+    FlushPrefetchedObjects();
   }
 
   void FinalizeDeferredMarking() {
@@ -182,6 +206,7 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
   // Called when all marking is complete.
   void Finalize() {
+    ASSERT(prefetch_count_ == 0);
     work_list_.Finalize();
     // Clear pending weak properties.
     WeakPropertyPtr cur_weak = delayed_weak_properties_;
@@ -199,11 +224,41 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   }
 
   void AbandonWork() {
+    prefetch_count_ = 0;
     work_list_.AbandonWork();
     deferred_work_list_.AbandonWork();
   }
 
  private:
+  // Objects found by the marker wait in a small ring after their header is
+  // prefetched, so that the mark bit test of one overlaps the cache misses
+  // of the next few. The ring must be flushed before deciding there is no
+  // more work.
+  static constexpr intptr_t kPrefetchRingSize = 8;
+  static constexpr intptr_t kShareCheckInterval = 128;
+
+  ObjectPtr PopWork() {
+    ObjectPtr raw_obj = work_list_.Pop();
+    if ((raw_obj == nullptr) && FlushPrefetchedObjects()) {
+      raw_obj = work_list_.Pop();
+    }
+    return raw_obj;
+  }
+
+  // Returns true if any object was flushed from the ring.
+  bool FlushPrefetchedObjects() {
+    if (prefetch_count_ == 0) {
+      return false;
+    }
+    while (prefetch_count_ > 0) {
+      const intptr_t index =
+          (prefetch_next_ - prefetch_count_) & (kPrefetchRingSize - 1);
+      prefetch_count_--;
+      MarkObjectNow(prefetch_ring_[index]);
+    }
+    return true;
+  }
+
   void PushMarked(ObjectPtr raw_obj) {
     ASSERT(raw_obj->IsHeapObject());
     ASSERT(raw_obj->IsOldObject());
@@ -234,6 +289,27 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
       return;
     }
 
+    if (!FLAG_marker_prefetch) {
+      MarkObjectNow(raw_obj);
+      return;
+    }
+    PREFETCH_FOR_WRITE(reinterpret_cast<void*>(ObjectLayout::ToAddr(raw_obj)));
+    const intptr_t index = prefetch_next_ & (kPrefetchRingSize - 1);
+    prefetch_next_++;
+    if (prefetch_count_ == kPrefetchRingSize) {
+      // The slot holds the oldest object, whose header should have arrived.
+      ObjectPtr oldest = prefetch_ring_[index];
+      prefetch_ring_[index] = raw_obj;
+      MarkObjectNow(oldest);
+    } else {
+      prefetch_ring_[index] = raw_obj;
+      prefetch_count_++;
+    }
+  }
+
+  DART_FORCE_INLINE
+  void MarkObjectNow(ObjectPtr raw_obj) {
+
     // While it might seem this is redundant with TryAcquireMarkBit, we must
     // do this check first to avoid attempting an atomic::fetch_and on the
     // read-only vm-isolate or image pages, which can fault even if there is no
@@ -273,6 +349,12 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   WeakPropertyPtr delayed_weak_properties_;
   uintptr_t marked_bytes_;
   int64_t marked_micros_;
+  ObjectPtr prefetch_ring_[kPrefetchRingSize];
+  intptr_t prefetch_next_ = 0;
+  intptr_t prefetch_count_ = 0;
+  RelaxedAtomic<uintptr_t>* num_busy_ = nullptr;
+  intptr_t num_markers_ = 0;
+  intptr_t objects_since_share_check_ = 0;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkingVisitorBase);
 };
@@ -295,21 +377,28 @@ static bool IsUnreachable(const ObjectPtr raw_obj) {
 
 class MarkingWeakVisitor : public HandleVisitor {
  public:
-  explicit MarkingWeakVisitor(Thread* thread)
+  MarkingWeakVisitor(Thread* thread, bool parallel)
       : HandleVisitor(thread),
-        class_table_(thread->isolate_group()->shared_class_table()) {}
+        class_table_(thread->isolate_group()->shared_class_table()),
+        parallel_(parallel) {}
 
   void VisitHandle(uword addr) {
     FinalizablePersistentHandle* handle =
         reinterpret_cast<FinalizablePersistentHandle*>(addr);
     ObjectPtr raw_obj = handle->raw();
     if (IsUnreachable(raw_obj)) {
-      handle->UpdateUnreachable(thread()->isolate_group());
+      IsolateGroup* isolate_group = thread()->isolate_group();
+      if (parallel_ && !handle->finalizer_deferred()) {
+        isolate_group->api_state()->AddPendingFinalization(handle);
+      } else {
+        handle->UpdateUnreachable(isolate_group);
+      }
     }
   }
 
  private:
   SharedClassTable* class_table_;
+  const bool parallel_;
 
   DISALLOW_COPY_AND_ASSIGN(MarkingWeakVisitor);
 };
@@ -337,6 +426,7 @@ void GCMarker::ResetSlices() {
   }
 
   weak_slices_started_ = 0;
+  num_weak_handle_slices_ = Utils::Maximum<intptr_t>(FLAG_marker_tasks, 1);
 }
 
 void GCMarker::IterateRoots(ObjectPointerVisitor* visitor) {
@@ -375,9 +465,9 @@ void GCMarker::IterateRoots(ObjectPointerVisitor* visitor) {
   }
 }
 
+// Followed by num_weak_handle_slices_ slices of the weak persistent handles.
 enum WeakSlices {
-  kWeakHandles = 0,
-  kWeakTables,
+  kWeakTables = 0,
   kObjectIdRing,
   kRememberedSet,
   kNumWeakSlices,
@@ -387,13 +477,15 @@ void GCMarker::IterateWeakRoots(Thread* thread) {
   for (;;) {
     intptr_t slice = weak_slices_started_.fetch_add(1);
     if (slice >= kNumWeakSlices) {
-      return;  // No more slices.
+      slice -= kNumWeakSlices;
+      if (slice >= num_weak_handle_slices_) {
+        return;  // No more slices.
+      }
+      ProcessWeakHandles(thread, slice);
+      continue;
     }
 
     switch (slice) {
-      case kWeakHandles:
-        ProcessWeakHandles(thread);
-        break;
       case kWeakTables:
         ProcessWeakTables(thread);
         break;
@@ -409,12 +501,13 @@ void GCMarker::IterateWeakRoots(Thread* thread) {
   }
 }
 
-void GCMarker::ProcessWeakHandles(Thread* thread) {
+void GCMarker::ProcessWeakHandles(Thread* thread, intptr_t slice) {
   TIMELINE_FUNCTION_GC_DURATION(thread, "ProcessWeakHandles");
-  MarkingWeakVisitor visitor(thread);
+  MarkingWeakVisitor visitor(thread, num_weak_handle_slices_ > 1);
   ApiState* state = isolate_group_->api_state();
   ASSERT(state != NULL);
-  isolate_group_->VisitWeakPersistentHandles(&visitor);
+  state->VisitWeakHandlesSliceUnlocked(&visitor, slice,
+                                       num_weak_handle_slices_);
 }
 
 void GCMarker::ProcessWeakTables(Thread* thread) {
@@ -422,15 +515,20 @@ void GCMarker::ProcessWeakTables(Thread* thread) {
   for (int sel = 0; sel < Heap::kNumWeakSelectors; sel++) {
     WeakTable* table =
         heap_->GetWeakTable(Heap::kOld, static_cast<Heap::WeakSelector>(sel));
-    intptr_t size = table->size();
-    for (intptr_t i = 0; i < size; i++) {
+    // Dead entries are removed in place; removal moves the next entry of
+    // the probe sequence into slot i, so look at it again.
+    intptr_t i = 0;
+    while (i < table->size()) {
       if (table->IsValidEntryAtExclusive(i)) {
         ObjectPtr raw_obj = table->ObjectAtExclusive(i);
         if (raw_obj->IsHeapObject() && !raw_obj->ptr()->IsMarked()) {
           table->InvalidateAtExclusive(i);
+          continue;
         }
       }
+      i++;
     }
+    table->MaybeShrinkExclusive();
   }
 }
 
@@ -502,7 +600,9 @@ class ParallelMarkTask : public ThreadPool::Task {
         marking_stack_(marking_stack),
         barrier_(barrier),
         visitor_(visitor),
-        num_busy_(num_busy) {}
+        num_busy_(num_busy) {
+    visitor_->set_work_sharing(num_busy_, FLAG_marker_tasks);
+  }
 
   virtual void Run() {
     bool result = Thread::EnterIsolateGroupAsHelper(
@@ -767,6 +867,10 @@ void GCMarker::StartConcurrentMark(PageSpace* page_space) {
 void GCMarker::MarkObjects(PageSpace* page_space) {
   if (isolate_group_->marking_stack() != NULL) {
     isolate_group_->DisableIncrementalBarrier();
+    // All mutators have now handed off their marking stack blocks.
+    isolate_group_->GetGCOldBarrierMarkedMetric()->add(
+        marking_stack_.mutator_objects() +
+        deferred_marking_stack_.mutator_objects());
   }
 
   Prologue();
@@ -820,6 +924,10 @@ void GCMarker::MarkObjects(PageSpace* page_space) {
         }
       }
     }
+    // Finalizers that were not deferred run one at a time on this thread.
+    ApiState* state = isolate_group_->api_state();
+    state->RunPendingFinalizations(isolate_group_);
+    state->ScheduleDeferredFinalizers();
   }
   Epilogue();
 }
@@ -51,7 +51,7 @@ class GCMarker {
   void ResetSlices();
   void IterateRoots(ObjectPointerVisitor* visitor);
   void IterateWeakRoots(Thread* thread);
-  void ProcessWeakHandles(Thread* thread);
+  void ProcessWeakHandles(Thread* thread, intptr_t slice);
   void ProcessWeakTables(Thread* thread);
   void ProcessRememberedSet(Thread* thread);
   void ProcessObjectIdTable(Thread* thread);
@@ -72,6 +72,7 @@ class GCMarker {
   intptr_t root_slices_finished_;
   intptr_t root_slices_count_;
   RelaxedAtomic<intptr_t> weak_slices_started_;
+  intptr_t num_weak_handle_slices_;
 
   Mutex stats_mutex_;
   uintptr_t marked_bytes_;
@@ -0,0 +1,91 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/heap/memory_pressure.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform/utils.h"
+#include "vm/flags.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            heap_cgroup_limits,
+            false,
+            "Limit old gen growth to the headroom left below the cgroup v2 "
+            "memory.high (or memory.max) of the process.");
+DEFINE_FLAG(charp,
+            heap_cgroup_path,
+            "/sys/fs/cgroup",
+            "Directory holding the cgroup v2 memory files of the process.");
+
+Dart_MemoryPressureCallback MemoryPressure::callback_ = nullptr;
+
+bool MemoryPressure::Sample(intptr_t* used_bytes, intptr_t* limit_bytes) {
+  Dart_MemoryPressureCallback callback = callback_;
+  if (callback != nullptr) {
+    return callback(used_bytes, limit_bytes);
+  }
+  if (FLAG_heap_cgroup_limits) {
+    return SampleCgroup(used_bytes, limit_bytes);
+  }
+  return false;
+}
+
+#if defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+// Reads a cgroup memory file. Returns -1 if the file is missing or holds
+// "max", i.e., no limit.
+static int64_t ReadCgroupValue(const char* name) {
+  char path[PATH_MAX];
+  Utils::SNPrint(path, sizeof(path), "%s/%s", FLAG_heap_cgroup_path, name);
+  FILE* fp = fopen(path, "r");
+  if (fp == nullptr) {
+    return -1;
+  }
+  char buffer[32];
+  int64_t value = -1;
+  if (fgets(buffer, sizeof(buffer), fp) != nullptr) {
+    char* end = nullptr;
+    const int64_t parsed = strtoll(buffer, &end, 10);
+    if ((end != buffer) && (parsed >= 0)) {
+      value = parsed;
+    }
+  }
+  fclose(fp);
+  return value;
+}
+
+bool MemoryPressure::SampleCgroup(intptr_t* used_bytes,
+                                  intptr_t* limit_bytes) {
+  const int64_t current = ReadCgroupValue("memory.current");
+  if (current < 0) {
+    return false;
+  }
+  // memory.high is where the kernel starts throttling and reclaiming, which
+  // is the limit we want to stay under; memory.max is where the OOM killer
+  // steps in.
+  int64_t limit = ReadCgroupValue("memory.high");
+  if (limit < 0) {
+    limit = ReadCgroupValue("memory.max");
+  }
+  if (limit < 0) {
+    return false;
+  }
+  *used_bytes = static_cast<intptr_t>(
+      Utils::Minimum<int64_t>(current, kIntptrMax));
+  *limit_bytes =
+      static_cast<intptr_t>(Utils::Minimum<int64_t>(limit, kIntptrMax));
+  return true;
+}
+#else
+bool MemoryPressure::SampleCgroup(intptr_t* used_bytes,
+                                  intptr_t* limit_bytes) {
+  return false;
+}
+#endif  // defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+
+}  // namespace dart
@@ -0,0 +1,35 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_MEMORY_PRESSURE_H_
+#define RUNTIME_VM_HEAP_MEMORY_PRESSURE_H_
+
+#include "include/dart_api.h"
+#include "vm/allocation.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+// Reports how close the process is to a memory limit imposed outside of the
+// VM, so that old-space growth can be planned around it. The limit comes from
+// the embedder callback if one is installed, and otherwise from the cgroup v2
+// controller of the process when --heap_cgroup_limits is given.
+class MemoryPressure : public AllStatic {
+ public:
+  // Returns false if no limit is known.
+  static bool Sample(intptr_t* used_bytes, intptr_t* limit_bytes);
+
+  static void set_callback(Dart_MemoryPressureCallback callback) {
+    callback_ = callback;
+  }
+
+ private:
+  static bool SampleCgroup(intptr_t* used_bytes, intptr_t* limit_bytes);
+
+  static Dart_MemoryPressureCallback callback_;
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_MEMORY_PRESSURE_H_
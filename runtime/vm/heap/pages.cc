@@ -10,6 +10,7 @@
 #include "vm/heap/become.h"
 #include "vm/heap/compactor.h"
 #include "vm/heap/marker.h"
+#include "vm/heap/memory_pressure.h"
 #include "vm/heap/safepoint.h"
 #include "vm/heap/sweeper.h"
 #include "vm/lockers.h"
@@ -17,6 +18,7 @@
 #include "vm/object.h"
 #include "vm/object_set.h"
 #include "vm/os_thread.h"
+#include "vm/thread_registry.h"
 #include "vm/virtual_memory.h"
 
 namespace dart {
@@ -42,14 +44,65 @@ DEFINE_FLAG(bool,
             false,
             "Print free list statistics after a GC");
 DEFINE_FLAG(bool, log_growth, false, "Log PageSpace growth policy decisions.");
+DEFINE_FLAG(int,
+            old_gen_limit_headroom_ratio,
+            50,
+            "The max percentage of the headroom below an external memory limit "
+            "the old gen may grow into before the next GC");
+DEFINE_FLAG(int,
+            old_page_cache_capacity,
+            32,
+            "Number of freed old-space data pages kept mapped for reuse by "
+            "all isolate groups.");
+
+// Like the new-space page cache, this avoids unmapping and refaulting pages
+// when old space shrinks and grows again after each GC.
+static constexpr intptr_t kMaxOldPageCacheCapacity = 256;
+static Mutex* old_page_cache_mutex = nullptr;
+static VirtualMemory* old_page_cache[kMaxOldPageCacheCapacity] = {nullptr};
+static intptr_t old_page_cache_size = 0;
+
+void OldPage::Init() {
+  ASSERT(old_page_cache_mutex == nullptr);
+  old_page_cache_mutex = new Mutex(NOT_IN_PRODUCT("old_page_cache_mutex"));
+}
+
+void OldPage::Cleanup() {
+  ClearCache();
+  delete old_page_cache_mutex;
+  old_page_cache_mutex = nullptr;
+}
+
+void OldPage::ClearCache() {
+  MutexLocker ml(old_page_cache_mutex);
+  ASSERT(old_page_cache_size >= 0);
+  ASSERT(old_page_cache_size <= kMaxOldPageCacheCapacity);
+  while (old_page_cache_size > 0) {
+    delete old_page_cache[--old_page_cache_size];
+  }
+}
+
+intptr_t OldPage::CachedSize() {
+  MutexLocker ml(old_page_cache_mutex);
+  return old_page_cache_size * kOldPageSize;
+}
 
 OldPage* OldPage::Allocate(intptr_t size_in_words,
                            PageType type,
                            const char* name) {
   const bool executable = type == kExecutable;
 
-  VirtualMemory* memory = VirtualMemory::AllocateAligned(
-      size_in_words << kWordSizeLog2, kOldPageSize, executable, name);
+  VirtualMemory* memory = nullptr;
+  if (!executable && (size_in_words == kOldPageSizeInWords)) {
+    MutexLocker ml(old_page_cache_mutex);
+    if (old_page_cache_size > 0) {
+      memory = old_page_cache[--old_page_cache_size];
+    }
+  }
+  if (memory == nullptr) {
+    memory = VirtualMemory::AllocateAligned(size_in_words << kWordSizeLog2,
+                                            kOldPageSize, executable, name);
+  }
   if (memory == NULL) {
     return NULL;
   }
@@ -62,6 +115,7 @@ OldPage* OldPage::Allocate(intptr_t size_in_words,
   result->forwarding_page_ = NULL;
   result->card_table_ = NULL;
   result->type_ = type;
+  result->is_hot_code_ = false;
 
   LSAN_REGISTER_ROOT_REGION(result, sizeof(*result));
 
@@ -82,7 +136,20 @@ void OldPage::Deallocate() {
 
   // For a regular heap pages, the memory for this object will become
   // unavailable after the delete below.
-  delete memory_;
+  VirtualMemory* memory = memory_;
+  if (!image_page && (type_ == kData) && (memory->size() == kOldPageSize)) {
+    MutexLocker ml(old_page_cache_mutex);
+    const intptr_t capacity = Utils::Minimum<intptr_t>(
+        FLAG_old_page_cache_capacity, kMaxOldPageCacheCapacity);
+    if (old_page_cache_size < capacity) {
+#if defined(DEBUG)
+      memset(memory->address(), Heap::kZapByte, memory->size());
+#endif
+      old_page_cache[old_page_cache_size++] = memory;
+      memory = nullptr;
+    }
+  }
+  delete memory;
 
   // For a heap page from a snapshot, the OldPage object lives in the malloc
   // heap rather than the page itself.
@@ -126,17 +193,34 @@ void OldPage::VisitRememberedCards(ObjectPointerVisitor* visitor) {
     return;
   }
 
-  bool table_is_empty = false;
-
   ArrayPtr obj = static_cast<ArrayPtr>(ObjectLayout::FromAddr(object_start()));
+  if (!obj->ptr()->IsCardRemembered()) {
+    // The array was promoted by a scavenge that was then reversed, leaving a
+    // forwarding corpse behind.
+    free(card_table_);
+    card_table_ = NULL;
+    return;
+  }
   ASSERT(obj->IsArray());
-  ASSERT(obj->ptr()->IsCardRemembered());
   ObjectPtr* obj_from = obj->ptr()->from();
   ObjectPtr* obj_to = obj->ptr()->to(Smi::Value(obj->ptr()->length_));
 
+  bool table_is_empty = true;
+
   const intptr_t size = card_table_size();
-  for (intptr_t i = 0; i < size; i++) {
-    if (card_table_[i] != 0) {
+  for (intptr_t word_start = 0; word_start < size; word_start += kWordSize) {
+    // Skip a word's worth of clean cards at once. The table is padded to a
+    // whole number of words, and the padding is never dirtied.
+    uword cards;
+    memcpy(&cards, &card_table_[word_start], sizeof(cards));
+    if (cards == 0) {
+      continue;
+    }
+    const intptr_t word_end = Utils::Minimum(word_start + kWordSize, size);
+    for (intptr_t i = word_start; i < word_end; i++) {
+      if (card_table_[i] == 0) {
+        continue;
+      }
       ObjectPtr* card_from =
           reinterpret_cast<ObjectPtr*>(this) + (i << kSlotsPerCardLog2);
       ObjectPtr* card_to = reinterpret_cast<ObjectPtr*>(card_from) +
@@ -220,7 +304,7 @@ static const intptr_t kConservativeInitialMarkSpeed = 20;
 
 PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
     : heap_(heap),
-      num_freelists_(Utils::Maximum(FLAG_scavenger_tasks, 1) + 1),
+      num_freelists_(Utils::Maximum(FLAG_scavenger_tasks, 1) + 2),
       freelists_(new FreeList[num_freelists_]),
       pages_lock_(),
       max_capacity_in_words_(max_capacity_in_words),
@@ -238,6 +322,7 @@ PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
                              FLAG_old_gen_growth_rate,
                              FLAG_old_gen_growth_time_ratio),
       marker_(NULL),
+      sweep_queue_(new SweepQueue()),
       gc_time_micros_(0),
       collections_(0),
       mark_words_per_micro_(kConservativeInitialMarkSpeed),
@@ -265,6 +350,7 @@ PageSpace::~PageSpace() {
   FreePages(large_pages_);
   FreePages(image_pages_);
   ASSERT(marker_ == NULL);
+  delete sweep_queue_;
   delete[] freelists_;
 }
 
@@ -281,6 +367,7 @@ void PageSpace::AddPageLocked(OldPage* page) {
     pages_tail_->set_next(page);
   }
   pages_tail_ = page;
+  RegisterPageLocked(page);
 }
 
 void PageSpace::AddLargePageLocked(OldPage* page) {
@@ -290,6 +377,7 @@ void PageSpace::AddLargePageLocked(OldPage* page) {
     large_pages_tail_->set_next(page);
   }
   large_pages_tail_ = page;
+  RegisterPageLocked(page);
 }
 
 void PageSpace::AddExecPageLocked(OldPage* page) {
@@ -305,9 +393,11 @@ void PageSpace::AddExecPageLocked(OldPage* page) {
     }
   }
   exec_pages_tail_ = page;
+  RegisterPageLocked(page);
 }
 
 void PageSpace::RemovePageLocked(OldPage* page, OldPage* previous_page) {
+  UnregisterPageLocked(page);
   if (previous_page != NULL) {
     previous_page->set_next(page->next());
   } else {
@@ -319,6 +409,7 @@ void PageSpace::RemovePageLocked(OldPage* page, OldPage* previous_page) {
 }
 
 void PageSpace::RemoveLargePageLocked(OldPage* page, OldPage* previous_page) {
+  UnregisterPageLocked(page);
   if (previous_page != NULL) {
     previous_page->set_next(page->next());
   } else {
@@ -330,6 +421,7 @@ void PageSpace::RemoveLargePageLocked(OldPage* page, OldPage* previous_page) {
 }
 
 void PageSpace::RemoveExecPageLocked(OldPage* page, OldPage* previous_page) {
+  UnregisterPageLocked(page);
   if (previous_page != NULL) {
     previous_page->set_next(page->next());
   } else {
@@ -340,6 +432,39 @@ void PageSpace::RemoveExecPageLocked(OldPage* page, OldPage* previous_page) {
   }
 }
 
+void PageSpace::RegisterPageLocked(OldPage* page) {
+  const uword first = page->memory_->start() >> kOldPageSizeLog2;
+  const uword last = (page->memory_->end() - 1) >> kOldPageSizeLog2;
+  for (uword granule = first; granule <= last; granule++) {
+    ASSERT(page_table_.LookupValue(granule) == nullptr);
+    page_table_.Insert({static_cast<intptr_t>(granule), page});
+  }
+}
+
+void PageSpace::UnregisterPageLocked(OldPage* page) {
+  const uword first = page->memory_->start() >> kOldPageSizeLog2;
+  const uword last = (page->memory_->end() - 1) >> kOldPageSizeLog2;
+  for (uword granule = first; granule <= last; granule++) {
+    const bool removed = page_table_.Remove(static_cast<intptr_t>(granule));
+    ASSERT(removed);
+  }
+}
+
+OldPage* PageSpace::PageContainingLocked(uword addr) const {
+  DEBUG_ASSERT(pages_lock_.IsOwnedByCurrentThread());
+  OldPage* page =
+      page_table_.LookupValue(static_cast<intptr_t>(addr >> kOldPageSizeLog2));
+  if ((page != nullptr) && page->Contains(addr)) {
+    return page;
+  }
+  for (page = image_pages_; page != nullptr; page = page->next()) {
+    if (page->Contains(addr)) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
 OldPage* PageSpace::AllocatePage(OldPage::PageType type, bool link) {
   {
     MutexLocker ml(&pages_lock_);
@@ -414,8 +539,12 @@ void PageSpace::TruncateLargePage(OldPage* page,
   VirtualMemory* memory = page->memory_;
   const intptr_t old_page_size_in_words = (memory->size() >> kWordSizeLog2);
   if (new_page_size_in_words < old_page_size_in_words) {
+    MutexLocker ml(&pages_lock_);
+    UnregisterPageLocked(page);
     memory->Truncate(new_page_size_in_words << kWordSizeLog2);
-    IncreaseCapacityInWords(new_page_size_in_words - old_page_size_in_words);
+    RegisterPageLocked(page);
+    IncreaseCapacityInWordsLocked(new_page_size_in_words -
+                                  old_page_size_in_words);
     page->set_object_end(page->object_start() + new_object_size_in_bytes);
   }
 }
@@ -485,6 +614,8 @@ uword PageSpace::TryAllocateInFreshPage(intptr_t size,
     if (page == NULL) {
       return 0;
     }
+    // The remainder of the page is only used for hot code from now on.
+    page->is_hot_code_ = (freelist == HotCodeFreeList());
     // Start of the newly allocated page is the allocated object.
     result = page->object_start();
     // Note: usage_.capacity_in_words is increased by AllocatePage.
@@ -532,6 +663,69 @@ uword PageSpace::TryAllocateInFreshLargePage(intptr_t size,
   return result;
 }
 
+uword PageSpace::TryAllocateCachedSlow(Thread* thread, intptr_t size) {
+  AbandonThreadCache(thread);
+  // The whole batch is accounted as used now; AbandonThreadCache gives back
+  // whatever is left.
+  const uword start = TryAllocate(kThreadCacheSize, OldPage::kData);
+  if (start == 0) {
+    // Close to the growth limit or badly fragmented: allocate just this
+    // object and let the caller decide whether to collect.
+    return TryAllocate(size, OldPage::kData);
+  }
+  const uword top = start + size;
+  const uword end = start + kThreadCacheSize;
+  FreeListElement::AsElement(top, end - top);
+  thread->set_old_cache(top, end);
+  return start;
+}
+
+bool PageSpace::TryReserveThreadCache(Thread* thread, intptr_t size) {
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+  ASSERT(Heap::IsAllocatableViaFreeLists(size));
+  if (static_cast<intptr_t>(thread->old_cache_end() -
+                            thread->old_cache_top()) >= size) {
+    return true;
+  }
+  AbandonThreadCache(thread);
+  const intptr_t cache_size = Utils::Maximum(size, kThreadCacheSize);
+  const uword start = TryAllocate(cache_size, OldPage::kData);
+  if (start == 0) {
+    return false;
+  }
+  FreeListElement::AsElement(start, cache_size);
+  thread->set_old_cache(start, start + cache_size);
+  return true;
+}
+
+void PageSpace::AbandonThreadCache(Thread* thread) {
+  const uword top = thread->old_cache_top();
+  const uword end = thread->old_cache_end();
+  thread->set_old_cache(0, 0);
+  if (top < end) {
+    const intptr_t size = end - top;
+    freelists_[OldPage::kData].Free(top, size);
+    usage_.used_in_words -= (size >> kWordSizeLog2);
+  }
+}
+
+uword PageSpace::TryAllocateAfterLazySweep(intptr_t size,
+                                           FreeList* freelist,
+                                           bool is_protected) {
+  // Before growing, sweep a few of the pages the concurrent sweeper has not
+  // reached yet; their free space likely satisfies this request.
+  for (intptr_t i = 0; i < kMaxLazySweepPages; i++) {
+    if (!sweep_queue_->SweepNext(this, freelist)) {
+      break;
+    }
+    uword result = freelist->TryAllocate(size, is_protected);
+    if (result != 0) {
+      return result;
+    }
+  }
+  return 0;
+}
+
 uword PageSpace::TryAllocateInternal(intptr_t size,
                                      FreeList* freelist,
                                      OldPage::PageType type,
@@ -547,6 +741,9 @@ uword PageSpace::TryAllocateInternal(intptr_t size,
     } else {
       result = freelist->TryAllocate(size, is_protected);
     }
+    if ((result == 0) && (type == OldPage::kData) && !is_locked) {
+      result = TryAllocateAfterLazySweep(size, freelist, is_protected);
+    }
     if (result == 0) {
       result = TryAllocateInFreshPage(size, freelist, type, growth_policy,
                                       is_locked);
@@ -713,12 +910,8 @@ void PageSpace::UpdateMaxUsed() {
 }
 
 bool PageSpace::Contains(uword addr) const {
-  for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
-    if (it.page()->Contains(addr)) {
-      return true;
-    }
-  }
-  return false;
+  MutexLocker ml(&pages_lock_);
+  return PageContainingLocked(addr) != nullptr;
 }
 
 bool PageSpace::ContainsUnsafe(uword addr) const {
@@ -731,31 +924,20 @@ bool PageSpace::ContainsUnsafe(uword addr) const {
 }
 
 bool PageSpace::Contains(uword addr, OldPage::PageType type) const {
-  if (type == OldPage::kExecutable) {
-    // Fast path executable pages.
-    for (ExclusiveCodePageIterator it(this); !it.Done(); it.Advance()) {
-      if (it.page()->Contains(addr)) {
-        return true;
-      }
-    }
+  MutexLocker ml(&pages_lock_);
+  OldPage* page = PageContainingLocked(addr);
+  if ((page == nullptr) || (page->type() != type)) {
     return false;
   }
-  for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
-    if ((it.page()->type() == type) && it.page()->Contains(addr)) {
-      return true;
-    }
-  }
-  return false;
+  // Executable image pages are not in exec_pages_ and were never considered
+  // to contain code.
+  return (type != OldPage::kExecutable) || !page->is_image_page();
 }
 
 bool PageSpace::DataContains(uword addr) const {
-  for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
-    if ((it.page()->type() != OldPage::kExecutable) &&
-        it.page()->Contains(addr)) {
-      return true;
-    }
-  }
-  return false;
+  MutexLocker ml(&pages_lock_);
+  OldPage* page = PageContainingLocked(addr);
+  return (page != nullptr) && (page->type() != OldPage::kExecutable);
 }
 
 void PageSpace::AddRegionsToObjectSet(ObjectSet* set) const {
@@ -793,9 +975,8 @@ void PageSpace::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
   }
 }
 
-void PageSpace::VisitRememberedCards(ObjectPointerVisitor* visitor) const {
-  ASSERT(Thread::Current()->IsAtSafepoint() ||
-         (Thread::Current()->task_kind() == Thread::kScavengerTask));
+void PageSpace::SnapshotRememberedCardPages() {
+  ASSERT(Thread::Current()->IsAtSafepoint());
 
   // Wait for the sweeper to finish mutating the large page list.
   MonitorLocker ml(tasks_lock());
@@ -803,17 +984,21 @@ void PageSpace::VisitRememberedCards(ObjectPointerVisitor* visitor) const {
     ml.Wait();  // No safepoint check.
   }
 
+  MutexLocker pl(&pages_lock_);
+  remembered_cards_head_ = large_pages_;
+  remembered_cards_tail_ = large_pages_tail_;
+}
+
+void PageSpace::VisitRememberedCards(ObjectPointerVisitor* visitor) const {
+  ASSERT(Thread::Current()->IsAtSafepoint() ||
+         (Thread::Current()->task_kind() == Thread::kScavengerTask));
+
   // Large pages may be added concurrently due to promotion in another scavenge
-  // worker, so terminate the traversal when we hit the tail we saw while
-  // holding the pages lock, instead of at NULL, otherwise we are racing when we
-  // read OldPage::next_ and OldPage::remembered_cards_.
-  OldPage* page;
-  OldPage* tail;
-  {
-    MutexLocker ml(&pages_lock_);
-    page = large_pages_;
-    tail = large_pages_tail_;
-  }
+  // worker, so terminate the traversal when we hit the tail of the snapshot,
+  // instead of at NULL, otherwise we are racing when we read OldPage::next_
+  // and OldPage::card_table_, which the promoting worker may be writing.
+  OldPage* page = remembered_cards_head_;
+  OldPage* tail = remembered_cards_tail_;
   while (page != nullptr) {
     page->VisitRememberedCards(visitor);
     if (page == tail) break;
@@ -849,6 +1034,11 @@ void PageSpace::WriteProtect(bool read_only) {
   if (read_only) {
     // Avoid MakeIterable trying to write to the heap.
     AbandonBumpAllocation();
+    // Nor may threads keep bump allocating into, or later return, their
+    // caches.
+    if (heap_ != NULL) {
+      heap_->isolate_group()->thread_registry()->ResetOldSpaceCaches();
+    }
   }
   for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
     if (!it.page()->is_image_page()) {
@@ -869,6 +1059,7 @@ void PageSpace::PrintToJSONObject(JSONObject* object) const {
   space.AddProperty64("used", UsedInWords() * kWordSize);
   space.AddProperty64("capacity", CapacityInWords() * kWordSize);
   space.AddProperty64("external", ExternalInWords() * kWordSize);
+  heap_->PrintExternalToJSONObject(Heap::kOld, &space);
   space.AddProperty("time", MicrosecondsToSeconds(gc_time_micros()));
   if (collections() > 0) {
     int64_t run_time = isolate_group->UptimeMicros();
@@ -1188,8 +1379,12 @@ void PageSpace::CollectGarbageHelper(bool compact,
 
   int64_t mid1 = OS::GetCurrentMonotonicMicros();
 
-  // Abandon the remainder of the bump allocation block.
+  // Abandon the remainder of the bump allocation block and of the threads'
+  // caches. Sweeping finds the latter again, as free space.
   AbandonBumpAllocation();
+  if (heap_ != NULL) {
+    heap_->isolate_group()->thread_registry()->ResetOldSpaceCaches();
+  }
   // Reset the freelists and setup sweeping.
   for (intptr_t i = 0; i < num_freelists_; i++) {
     freelists_[i].Reset();
@@ -1213,10 +1408,14 @@ void PageSpace::CollectGarbageHelper(bool compact,
     OldPage* prev_page = NULL;
     OldPage* page = exec_pages_;
     FreeList* freelist = &freelists_[OldPage::kExecutable];
+    FreeList* hot_code_freelist = HotCodeFreeList();
     MutexLocker ml(freelist->mutex());
+    MutexLocker ml_hot_code(hot_code_freelist->mutex());
     while (page != NULL) {
       OldPage* next_page = page->next();
-      bool page_in_use = sweeper.SweepPage(page, freelist, true /*is_locked*/);
+      bool page_in_use = sweeper.SweepPage(
+          page, page->is_hot_code() ? hot_code_freelist : freelist,
+          true /*is_locked*/);
       if (page_in_use) {
         prev_page = page;
       } else {
@@ -1233,7 +1432,10 @@ void PageSpace::CollectGarbageHelper(bool compact,
 
   if (compact) {
     SweepLarge();
+    const int64_t compact_start = OS::GetCurrentMonotonicMicros();
     Compact(thread);
+    heap_->RecordTime(kCompact,
+                      OS::GetCurrentMonotonicMicros() - compact_start);
     set_phase(kDone);
   } else if (FLAG_concurrent_sweep && has_reservation) {
     ConcurrentSweep(isolate_group);
@@ -1405,6 +1607,12 @@ uword PageSpace::TryAllocatePromoLockedSlow(FreeList* freelist, intptr_t size) {
   return TryAllocateDataBumpLocked(freelist, size);
 }
 
+uword PageSpace::TryAllocatePromoLargeLocked(FreeList* freelist,
+                                             intptr_t size) {
+  ASSERT(!Heap::IsAllocatableViaFreeLists(size));
+  return TryAllocateDataLocked(freelist, size, kForceGrowth);
+}
+
 void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   // Setup a OldPage so precompiled Instructions can be traversed.
   // Instructions are contiguous at [pointer, pointer + size). OldPage
@@ -1429,6 +1637,7 @@ void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   } else {
     page->type_ = OldPage::kData;
   }
+  page->is_hot_code_ = false;
 
   MutexLocker ml(&pages_lock_);
   page->next_ = image_pages_;
@@ -1596,6 +1805,7 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
     grow_heap = Utils::Maximum(min_step, grow_heap);
   }
 
+  grow_heap = ApplyMemoryPressure(after, grow_heap);
   RecordUpdate(before, after, grow_heap, "gc");
 }
 
@@ -1615,10 +1825,44 @@ void PageSpaceController::EvaluateAfterLoading(SpaceUsage after) {
   // Apply growth cap.
   growth_in_pages =
       Utils::Minimum(static_cast<intptr_t>(heap_growth_max_), growth_in_pages);
+  growth_in_pages = ApplyMemoryPressure(after, growth_in_pages);
 
   RecordUpdate(after, after, growth_in_pages, "loaded");
 }
 
+intptr_t PageSpaceController::ApplyMemoryPressure(SpaceUsage after,
+                                                  intptr_t grow_heap) {
+  intptr_t used_bytes = 0;
+  intptr_t limit_bytes = 0;
+  if (!MemoryPressure::Sample(&used_bytes, &limit_bytes)) {
+    return grow_heap;
+  }
+  const intptr_t headroom_bytes =
+      Utils::Maximum<intptr_t>(limit_bytes - used_bytes, 0);
+  // The rest of the headroom is left to new space, native allocations and
+  // other isolate groups between now and the next GC.
+  const intptr_t max_grow_heap =
+      static_cast<intptr_t>(static_cast<double>(headroom_bytes) *
+                            FLAG_old_gen_limit_headroom_ratio / 100.0) /
+      kOldPageSize;
+  intptr_t result = grow_heap;
+  if (used_bytes < (limit_bytes / 2)) {
+    // Far from the limit: collect less often than the heuristics above ask.
+    result = grow_heap * 2;
+  }
+  result = Utils::Minimum(result, max_grow_heap);
+  if (FLAG_log_growth) {
+    THR_Print("%s: memory pressure used=%" Pd "kB limit=%" Pd
+              "kB old gen combined=%" Pd "kB growth=%" Pd " -> %" Pd
+              " pages\n",
+              heap_ == nullptr ? "<none>"
+                               : heap_->isolate_group()->source()->name,
+              used_bytes / KB, limit_bytes / KB,
+              RoundWordsToKB(after.CombinedUsedInWords()), grow_heap, result);
+  }
+  return result;
+}
+
 void PageSpaceController::RecordUpdate(SpaceUsage before,
                                        SpaceUsage after,
                                        intptr_t growth_in_pages,
@@ -7,6 +7,7 @@
 
 #include "platform/atomic.h"
 #include "vm/globals.h"
+#include "vm/hash_map.h"
 #include "vm/heap/freelist.h"
 #include "vm/heap/spaces.h"
 #include "vm/lockers.h"
@@ -25,8 +26,10 @@ class ObjectPointerVisitor;
 class ObjectSet;
 class ForwardingPage;
 class GCMarker;
+class SweepQueue;
 
-static constexpr intptr_t kOldPageSize = 512 * KB;
+static constexpr intptr_t kOldPageSizeLog2 = 19;
+static constexpr intptr_t kOldPageSize = 1 << kOldPageSizeLog2;
 static constexpr intptr_t kOldPageSizeInWords = kOldPageSize / kWordSize;
 static constexpr intptr_t kOldPageMask = ~(kOldPageSize - 1);
 
@@ -41,6 +44,12 @@ class OldPage {
  public:
   enum PageType { kExecutable = 0, kData };
 
+  // Manage the process-wide cache of freed data pages.
+  static void Init();
+  static void Cleanup();
+  static void ClearCache();
+  static intptr_t CachedSize();
+
   OldPage* next() const { return next_; }
   void set_next(OldPage* next) { next_ = next; }
 
@@ -60,6 +69,10 @@ class OldPage {
 
   PageType type() const { return type_; }
 
+  // Whether this executable page is reserved for hot code (see
+  // Heap::kHotCode).
+  bool is_hot_code() const { return is_hot_code_; }
+
   bool is_image_page() const { return !memory_->vm_owns_region(); }
 
   void VisitObjects(ObjectVisitor* visitor) const;
@@ -136,8 +149,10 @@ class OldPage {
   void RememberCard(ObjectPtr const* slot) {
     ASSERT(Contains(reinterpret_cast<uword>(slot)));
     if (card_table_ == NULL) {
+      // Padded to whole words so VisitRememberedCards can skip clean cards a
+      // word at a time.
       card_table_ = reinterpret_cast<uint8_t*>(
-          calloc(card_table_size(), sizeof(uint8_t)));
+          calloc(Utils::RoundUp(card_table_size(), kWordSize), sizeof(uint8_t)));
     }
     intptr_t offset =
         reinterpret_cast<uword>(slot) - reinterpret_cast<uword>(this);
@@ -169,6 +184,7 @@ class OldPage {
   ForwardingPage* forwarding_page_;
   uint8_t* card_table_;  // Remembered set, not marking.
   PageType type_;
+  bool is_hot_code_;
 
   friend class PageSpace;
   friend class GCCompactor;
@@ -239,6 +255,11 @@ class PageSpaceController {
  private:
   friend class PageSpace;  // For MergeOtherPageSpaceController
 
+  // Limits growth to the headroom below an external memory limit, if the
+  // embedder or the cgroup reports one, and grows more eagerly when the
+  // process is far below it.
+  intptr_t ApplyMemoryPressure(SpaceUsage after, intptr_t grow_heap);
+
   void RecordUpdate(SpaceUsage before, SpaceUsage after, const char* reason);
   void RecordUpdate(SpaceUsage before,
                     SpaceUsage after,
@@ -295,16 +316,49 @@ class PageSpace {
   PageSpace(Heap* heap, intptr_t max_capacity_in_words);
   ~PageSpace();
 
+  // Hot code is allocated from a freelist of its own, which is only refilled
+  // from pages that were allocated for hot code.
   uword TryAllocate(intptr_t size,
                     OldPage::PageType type = OldPage::kData,
-                    GrowthPolicy growth_policy = kControlGrowth) {
+                    GrowthPolicy growth_policy = kControlGrowth,
+                    bool is_hot_code = false) {
+    ASSERT(!is_hot_code || (type == OldPage::kExecutable));
     bool is_protected =
         (type == OldPage::kExecutable) && FLAG_write_protect_code;
     bool is_locked = false;
-    return TryAllocateInternal(size, &freelists_[type], type, growth_policy,
+    FreeList* freelist = is_hot_code ? HotCodeFreeList() : &freelists_[type];
+    return TryAllocateInternal(size, freelist, type, growth_policy,
                                is_protected, is_locked);
   }
 
+  // Small data allocations are bump allocated from a region owned by the
+  // allocating thread. The region is refilled from the data freelist a
+  // kThreadCacheSize batch at a time, so mutators sharing this space only
+  // contend on the freelist lock once per batch.
+  uword TryAllocateCached(Thread* thread, intptr_t size) {
+    ASSERT(Utils::IsAligned(size, kObjectAlignment));
+    if (size > kMaxCachedAllocationSize) {
+      return TryAllocate(size, OldPage::kData);
+    }
+    const uword top = thread->old_cache_top();
+    const uword end = thread->old_cache_end();
+    if (static_cast<intptr_t>(end - top) >= size) {
+      const uword new_top = top + size;
+      if (new_top < end) {
+        // Keep the rest of the region walkable.
+        FreeListElement::AsElement(new_top, end - new_top);
+      }
+      thread->set_old_cache(new_top, end);
+      return top;
+    }
+    return TryAllocateCachedSlow(thread, size);
+  }
+  // Makes sure the thread's cache has at least size bytes left, refilling it
+  // if needed. Returns false on failure.
+  bool TryReserveThreadCache(Thread* thread, intptr_t size);
+  // Returns the unused part of the thread's cache to the data freelist.
+  void AbandonThreadCache(Thread* thread);
+
   void TryReleaseReservation();
   bool MarkReservation();
   void TryReserveForOOM();
@@ -367,6 +421,10 @@ class PageSpace {
   void VisitObjectsImagePages(ObjectVisitor* visitor) const;
   void VisitObjectPointers(ObjectPointerVisitor* visitor) const;
 
+  // Records the large pages whose cards the next VisitRememberedCards visits.
+  // Arrays promoted afterwards get pages outside the snapshot, so a scavenge
+  // worker can dirty their cards while another visits the snapshot.
+  void SnapshotRememberedCardPages();
   void VisitRememberedCards(ObjectPointerVisitor* visitor) const;
 
   ObjectPtr FindObject(FindObjectVisitor* visitor,
@@ -432,6 +490,7 @@ class PageSpace {
   FreeList* DataFreeList(intptr_t i = 0) {
     return &freelists_[OldPage::kData + i];
   }
+  FreeList* HotCodeFreeList() { return &freelists_[num_freelists_ - 1]; }
   void AcquireLock(FreeList* freelist);
   void ReleaseLock(FreeList* freelist);
 
@@ -458,6 +517,9 @@ class PageSpace {
   Phase phase() const { return phase_; }
   void set_phase(Phase val) { phase_ = val; }
 
+  // Pages not yet reached by the concurrent sweeper, when kSweepingRegular.
+  SweepQueue* sweep_queue() const { return sweep_queue_; }
+
   // Attempt to allocate from bump block rather than normal freelist.
   uword TryAllocateDataBumpLocked(intptr_t size) {
     return TryAllocateDataBumpLocked(&freelists_[OldPage::kData], size);
@@ -472,6 +534,9 @@ class PageSpace {
     return TryAllocatePromoLockedSlow(freelist, size);
   }
   uword TryAllocatePromoLockedSlow(FreeList* freelist, intptr_t size);
+  // Promotes an object too big for the freelists onto a large page of its
+  // own, never into a bump region of a regular page.
+  uword TryAllocatePromoLargeLocked(FreeList* freelist, intptr_t size);
 
   void SetupImagePage(void* pointer, uword size, bool is_executable);
 
@@ -487,7 +552,6 @@ class PageSpace {
 
   bool IsObjectFromImagePages(ObjectPtr object);
 
- private:
   // Ids for time and data records in Heap::GCStats.
   enum {
     // Time
@@ -496,7 +560,8 @@ class PageSpace {
     kMarkObjects = 2,
     kResetFreeLists = 3,
     kSweepPages = 4,
-    kSweepLargePages = 5,
+    kSweepLargePages = 5,  // Includes kCompact.
+    kCompact = 6,
     // Data
     kGarbageRatio = 0,
     kGCTimeFraction = 1,
@@ -504,6 +569,8 @@ class PageSpace {
     kAllowedGrowth = 3
   };
 
+ private:
+
   uword TryAllocateInternal(intptr_t size,
                             FreeList* freelist,
                             OldPage::PageType type,
@@ -515,6 +582,10 @@ class PageSpace {
                                OldPage::PageType type,
                                GrowthPolicy growth_policy,
                                bool is_locked);
+  uword TryAllocateCachedSlow(Thread* thread, intptr_t size);
+  uword TryAllocateAfterLazySweep(intptr_t size,
+                                  FreeList* freelist,
+                                  bool is_protected);
   uword TryAllocateInFreshLargePage(intptr_t size,
                                     OldPage::PageType type,
                                     GrowthPolicy growth_policy);
@@ -531,6 +602,11 @@ class PageSpace {
   void RemoveLargePageLocked(OldPage* page, OldPage* previous_page);
   void RemoveExecPageLocked(OldPage* page, OldPage* previous_page);
 
+  // Maintain page_table_ for a page in one of the page lists.
+  void RegisterPageLocked(OldPage* page);
+  void UnregisterPageLocked(OldPage* page);
+  OldPage* PageContainingLocked(uword addr) const;
+
   OldPage* AllocatePage(OldPage::PageType type, bool link = true);
   OldPage* AllocateLargePage(intptr_t size, OldPage::PageType type);
 
@@ -567,11 +643,16 @@ class PageSpace {
   // FLAG_scavenger_tasks count of lists for data pages starting at
   // freelists_[OldPage::kData]. The sweeper inserts into the data page
   // freelists round-robin. The scavenger workers each use one of the data
-  // page freelists without locking.
+  // page freelists without locking. The last list is for executable pages
+  // holding hot code.
   const intptr_t num_freelists_;
   FreeList* freelists_;
   static constexpr intptr_t kOOMReservationSize = 32 * KB;
   FreeListElement* oom_reservation_ = nullptr;
+  static constexpr intptr_t kThreadCacheSize = 8 * KB;
+  static constexpr intptr_t kMaxCachedAllocationSize = 256;
+  // Upper bound on pages an allocating thread sweeps itself on a freelist miss.
+  static constexpr intptr_t kMaxLazySweepPages = 4;
 
   // Use ExclusivePageIterator for safe access to these.
   mutable Mutex pages_lock_;
@@ -582,6 +663,13 @@ class PageSpace {
   OldPage* large_pages_ = nullptr;
   OldPage* large_pages_tail_ = nullptr;
   OldPage* image_pages_ = nullptr;
+  OldPage* remembered_cards_head_ = nullptr;
+  OldPage* remembered_cards_tail_ = nullptr;
+  // Maps each kOldPageSize-aligned granule covered by the writable memory of
+  // a page in pages_, exec_pages_ or large_pages_ to that page. No two pages
+  // share a granule because all of them start aligned to kOldPageSize. Image
+  // pages are not aligned and are searched linearly instead.
+  MallocDirectChainedHashMap<IntKeyRawPointerValueTrait<OldPage*>> page_table_;
 
   // Various sizes being tracked for this generation.
   intptr_t max_capacity_in_words_;
@@ -602,6 +690,7 @@ class PageSpace {
 #endif
   PageSpaceController page_space_controller_;
   GCMarker* marker_;
+  SweepQueue* sweep_queue_;
 
   int64_t gc_time_micros_;
   intptr_t collections_;
@@ -617,6 +706,7 @@ class PageSpace {
   friend class HeapSnapshotWriter;
   friend class PageSpaceController;
   friend class ConcurrentSweeperTask;
+  friend class SweepQueue;
   friend class GCCompactor;
   friend class CompactorTask;
 
@@ -3,11 +3,21 @@
 // BSD-style license that can be found in the LICENSE file.
 
 #include "vm/heap/pages.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
 #include "platform/assert.h"
+#include "vm/heap/memory_pressure.h"
 #include "vm/unit_test.h"
 
 namespace dart {
 
+DECLARE_FLAG(bool, heap_cgroup_limits);
+DECLARE_FLAG(charp, heap_cgroup_path);
+DECLARE_FLAG(bool, write_protect_code);
+
 TEST_CASE(Pages) {
   PageSpace* space = new PageSpace(NULL, 4 * MBInWords);
   space->InitGrowthControl();
@@ -32,4 +42,121 @@ TEST_CASE(Pages) {
   delete space;
 }
 
+TEST_CASE(Pages_HotCode) {
+  SetFlagScope<bool> sfs(&FLAG_write_protect_code, false);
+  PageSpace* space = new PageSpace(NULL, 4 * MBInWords);
+  space->InitGrowthControl();
+  const intptr_t kBlockSize = 16 * kWordSize;
+  uword cold = space->TryAllocate(kBlockSize, OldPage::kExecutable);
+  uword hot = space->TryAllocate(kBlockSize, OldPage::kExecutable,
+                                 PageSpace::kControlGrowth,
+                                 /*is_hot_code=*/true);
+  uword other_cold = space->TryAllocate(kBlockSize, OldPage::kExecutable);
+  uword other_hot = space->TryAllocate(kBlockSize, OldPage::kExecutable,
+                                       PageSpace::kControlGrowth,
+                                       /*is_hot_code=*/true);
+  EXPECT(cold != 0);
+  EXPECT(hot != 0);
+  EXPECT(other_cold != 0);
+  EXPECT(other_hot != 0);
+  // Hot code is allocated densely on pages without cold code.
+  EXPECT(!OldPage::Of(cold)->is_hot_code());
+  EXPECT(OldPage::Of(hot)->is_hot_code());
+  EXPECT(OldPage::Of(cold) == OldPage::Of(other_cold));
+  EXPECT(OldPage::Of(hot) == OldPage::Of(other_hot));
+  EXPECT(OldPage::Of(cold) != OldPage::Of(hot));
+  delete space;
+}
+
+static intptr_t pressure_used_bytes = 0;
+static intptr_t pressure_limit_bytes = 0;
+
+static bool TestMemoryPressureCallback(intptr_t* used_bytes,
+                                       intptr_t* limit_bytes) {
+  *used_bytes = pressure_used_bytes;
+  *limit_bytes = pressure_limit_bytes;
+  return true;
+}
+
+VM_UNIT_TEST_CASE(PageSpaceController_MemoryPressure) {
+  SpaceUsage usage;
+  usage.used_in_words = 10 * MBInWords;
+  usage.capacity_in_words = 10 * MBInWords;
+  SpaceUsage grown = usage;
+  grown.used_in_words = usage.used_in_words + 4 * kOldPageSizeInWords;
+
+  PageSpaceController controller(nullptr, 20, 280, 3);
+  controller.Enable();
+  controller.EvaluateAfterLoading(usage);
+  EXPECT(!controller.ReachedHardThreshold(grown));
+
+  // Close to the limit: growth is capped by the headroom left.
+  MemoryPressure::set_callback(TestMemoryPressureCallback);
+  pressure_used_bytes = 100 * MB;
+  pressure_limit_bytes = 100 * MB + 2 * kOldPageSize;
+  controller.EvaluateAfterLoading(usage);
+  EXPECT(controller.ReachedHardThreshold(grown));
+
+  // Far from the limit: growth is not capped.
+  pressure_limit_bytes = 1024 * MB;
+  controller.EvaluateAfterLoading(usage);
+  EXPECT(!controller.ReachedHardThreshold(grown));
+
+  MemoryPressure::set_callback(nullptr);
+}
+
+#if defined(HOST_OS_LINUX)
+static void WriteCgroupFile(const char* dir,
+                            const char* name,
+                            const char* contents) {
+  char path[PATH_MAX];
+  Utils::SNPrint(path, sizeof(path), "%s/%s", dir, name);
+  FILE* fp = fopen(path, "w");
+  EXPECT(fp != nullptr);
+  fputs(contents, fp);
+  fclose(fp);
+}
+
+static void RemoveCgroupFile(const char* dir, const char* name) {
+  char path[PATH_MAX];
+  Utils::SNPrint(path, sizeof(path), "%s/%s", dir, name);
+  unlink(path);
+}
+
+VM_UNIT_TEST_CASE(MemoryPressure_Cgroup) {
+  char dir[] = "/tmp/dart_cgroup_XXXXXX";
+  EXPECT(mkdtemp(dir) != nullptr);
+  const bool saved_limits = FLAG_heap_cgroup_limits;
+  const char* saved_path = FLAG_heap_cgroup_path;
+  FLAG_heap_cgroup_limits = true;
+  FLAG_heap_cgroup_path = dir;
+
+  intptr_t used = 0;
+  intptr_t limit = 0;
+  EXPECT(!MemoryPressure::Sample(&used, &limit));
+
+  WriteCgroupFile(dir, "memory.current", "1048576\n");
+  WriteCgroupFile(dir, "memory.high", "max\n");
+  WriteCgroupFile(dir, "memory.max", "4194304\n");
+  EXPECT(MemoryPressure::Sample(&used, &limit));
+  EXPECT_EQ(1 * MB, used);
+  EXPECT_EQ(4 * MB, limit);
+
+  WriteCgroupFile(dir, "memory.high", "2097152\n");
+  EXPECT(MemoryPressure::Sample(&used, &limit));
+  EXPECT_EQ(2 * MB, limit);
+
+  WriteCgroupFile(dir, "memory.high", "max\n");
+  WriteCgroupFile(dir, "memory.max", "max\n");
+  EXPECT(!MemoryPressure::Sample(&used, &limit));
+
+  RemoveCgroupFile(dir, "memory.current");
+  RemoveCgroupFile(dir, "memory.high");
+  RemoveCgroupFile(dir, "memory.max");
+  rmdir(dir);
+  FLAG_heap_cgroup_limits = saved_limits;
+  FLAG_heap_cgroup_path = saved_path;
+}
+#endif  // defined(HOST_OS_LINUX)
+
 }  // namespace dart
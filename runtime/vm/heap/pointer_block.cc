@@ -41,7 +41,8 @@ void BlockStack<BlockSize>::Cleanup() {
 }
 
 template <int BlockSize>
-BlockStack<BlockSize>::BlockStack() : mutex_() {}
+BlockStack<BlockSize>::BlockStack()
+    : mutex_(), incoming_full_(nullptr), incoming_length_(0) {}
 
 template <int BlockSize>
 BlockStack<BlockSize>::~BlockStack() {
@@ -51,6 +52,7 @@ BlockStack<BlockSize>::~BlockStack() {
 template <int BlockSize>
 void BlockStack<BlockSize>::Reset() {
   MutexLocker local_mutex_locker(&mutex_);
+  DrainIncomingLocked();
   {
     // Empty all blocks and move them to the global cache.
     MutexLocker global_mutex_locker(global_mutex_);
@@ -71,6 +73,7 @@ void BlockStack<BlockSize>::Reset() {
 template <int BlockSize>
 typename BlockStack<BlockSize>::Block* BlockStack<BlockSize>::TakeBlocks() {
   MutexLocker ml(&mutex_);
+  DrainIncomingLocked();
   while (!partial_.IsEmpty()) {
     full_.Push(partial_.Pop());
   }
@@ -81,8 +84,12 @@ template <int BlockSize>
 void BlockStack<BlockSize>::PushBlockImpl(Block* block) {
   ASSERT(block->next() == NULL);  // Should be just a single block.
   if (block->IsFull()) {
-    MutexLocker ml(&mutex_);
-    full_.Push(block);
+    Block* head = incoming_full_.load(std::memory_order_relaxed);
+    do {
+      block->next_ = head;
+    } while (!incoming_full_.compare_exchange_weak(
+        head, block, std::memory_order_release, std::memory_order_relaxed));
+    incoming_length_.fetch_add(1);
   } else if (block->IsEmpty()) {
     MutexLocker ml(global_mutex_);
     global_empty_->Push(block);
@@ -93,6 +100,19 @@ void BlockStack<BlockSize>::PushBlockImpl(Block* block) {
   }
 }
 
+template <int BlockSize>
+void BlockStack<BlockSize>::DrainIncomingLocked() {
+  DEBUG_ASSERT(mutex_.IsOwnedByCurrentThread());
+  Block* block = incoming_full_.exchange(nullptr, std::memory_order_acquire);
+  while (block != nullptr) {
+    Block* next = block->next_;
+    block->next_ = nullptr;
+    full_.Push(block);
+    incoming_length_.fetch_sub(1);
+    block = next;
+  }
+}
+
 template <int Size>
 void PointerBlock<Size>::VisitObjectPointers(ObjectPointerVisitor* visitor) {
   // Generated code appends to store buffers; tell MemorySanitizer.
@@ -117,7 +137,9 @@ void StoreBuffer::PushBlock(Block* block, ThresholdPolicy policy) {
 template <int BlockSize>
 typename BlockStack<BlockSize>::Block*
 BlockStack<BlockSize>::PopNonFullBlock() {
-  {
+  // Skip the lock when there is evidently no partial block. Losing a race
+  // with a concurrent push only means taking an empty block instead.
+  if (partial_.length() > 0) {
     MutexLocker ml(&mutex_);
     if (!partial_.IsEmpty()) {
       return partial_.Pop();
@@ -141,6 +163,7 @@ template <int BlockSize>
 typename BlockStack<BlockSize>::Block*
 BlockStack<BlockSize>::PopNonEmptyBlock() {
   MutexLocker ml(&mutex_);
+  DrainIncomingLocked();
   if (!full_.IsEmpty()) {
     return full_.Pop();
   } else if (!partial_.IsEmpty()) {
@@ -153,6 +176,7 @@ BlockStack<BlockSize>::PopNonEmptyBlock() {
 template <int BlockSize>
 bool BlockStack<BlockSize>::IsEmpty() {
   MutexLocker ml(&mutex_);
+  DrainIncomingLocked();
   return full_.IsEmpty() && partial_.IsEmpty();
 }
 
@@ -167,7 +191,7 @@ template <int BlockSize>
 typename BlockStack<BlockSize>::Block* BlockStack<BlockSize>::List::Pop() {
   Block* result = head_;
   head_ = head_->next_;
-  --length_;
+  length_ -= 1;
   result->next_ = NULL;
   return result;
 }
@@ -185,15 +209,20 @@ void BlockStack<BlockSize>::List::Push(Block* block) {
   ASSERT(block->next_ == NULL);
   block->next_ = head_;
   head_ = block;
-  ++length_;
+  length_ += 1;
 }
 
 bool StoreBuffer::Overflowed() {
-  MutexLocker ml(&mutex_);
-  return (full_.length() + partial_.length()) > kMaxNonEmpty;
+  // Checked on every block hand-off; a slightly stale count only moves the
+  // interrupt by a block.
+  return ApproximateNonEmptyLength() > kMaxNonEmpty;
 }
 
 void StoreBuffer::VisitObjectPointers(ObjectPointerVisitor* visitor) {
+  {
+    MutexLocker ml(&mutex_);
+    DrainIncomingLocked();
+  }
   for (Block* block = full_.Peek(); block != NULL; block = block->next()) {
     block->VisitObjectPointers(visitor);
   }
@@ -5,7 +5,10 @@
 #ifndef RUNTIME_VM_HEAP_POINTER_BLOCK_H_
 #define RUNTIME_VM_HEAP_POINTER_BLOCK_H_
 
+#include <atomic>
+
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "vm/globals.h"
 #include "vm/os_thread.h"
 #include "vm/tagged_pointer.h"
@@ -115,6 +118,7 @@ class BlockStack {
     ~List();
     void Push(Block* block);
     Block* Pop();
+    // May be read without holding the lock, as a hint.
     intptr_t length() const { return length_; }
     bool IsEmpty() const { return head_ == nullptr; }
     Block* PopAll();
@@ -122,13 +126,21 @@ class BlockStack {
 
    private:
     Block* head_;
-    intptr_t length_;
+    RelaxedAtomic<intptr_t> length_;
     DISALLOW_COPY_AND_ASSIGN(List);
   };
 
   // Adds and transfers ownership of the block to the buffer.
   void PushBlockImpl(Block* block);
 
+  // Moves the full blocks pushed without the lock into full_.
+  void DrainIncomingLocked();
+
+  // Number of non-empty blocks, without taking the lock.
+  intptr_t ApproximateNonEmptyLength() const {
+    return full_.length() + partial_.length() + incoming_length_.load();
+  }
+
   // If needed, trims the global cache of empty blocks.
   static void TrimGlobalEmpty();
 
@@ -136,6 +148,12 @@ class BlockStack {
   List partial_;
   Mutex mutex_;
 
+  // Full blocks are handed off by mutators on every block overflow, so they
+  // are pushed onto this lock-free stack instead of taking mutex_. Readers of
+  // full_ take the whole stack with a single exchange, which avoids ABA.
+  std::atomic<Block*> incoming_full_;
+  RelaxedAtomic<intptr_t> incoming_length_;
+
   // Note: This is shared on the basis of block size.
   static const intptr_t kMaxGlobalEmpty = 100;
   static List* global_empty_;
@@ -187,6 +205,28 @@ class BlockWorkList : public ValueObject {
     work_->Push(raw_obj);
   }
 
+  // Publishes the current work block, if non-empty, to the stack so that it
+  // can be taken by other workers.
+  void Flush() {
+    if (!work_->IsEmpty()) {
+      stack_->PushBlock(work_);
+      work_ = stack_->PopEmptyBlock();
+    }
+  }
+
+  // Moves half of the current work block to the stack if the stack has
+  // nothing else for idle workers to take.
+  void Share() {
+    if ((work_->Count() < 2) || !stack_->IsEmpty()) {
+      return;
+    }
+    Block* shared = stack_->PopEmptyBlock();
+    for (intptr_t i = work_->Count() / 2; i > 0; i--) {
+      shared->Push(work_->Pop());
+    }
+    stack_->PushBlock(shared);
+  }
+
   void Finalize() {
     ASSERT(work_->IsEmpty());
     stack_->PushBlock(work_);
@@ -242,6 +282,19 @@ class MarkingStack : public BlockStack<kMarkingStackBlockSize> {
   void PushBlock(Block* block) {
     BlockStack<Block::kSize>::PushBlockImpl(block);
   }
+
+  // Like PushBlock, for a block a mutator filled through its write barrier.
+  // Counting whole blocks as they are handed off leaves the barrier itself
+  // unchanged.
+  void PushMutatorBlock(Block* block) {
+    mutator_objects_.fetch_add(block->Count());
+    PushBlock(block);
+  }
+
+  intptr_t mutator_objects() const { return mutator_objects_; }
+
+ private:
+  RelaxedAtomic<intptr_t> mutator_objects_ = {0};
 };
 
 typedef MarkingStack::Block MarkingStackBlock;
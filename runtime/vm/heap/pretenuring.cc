@@ -0,0 +1,86 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/heap/pretenuring.h"
+
+#include "vm/flags.h"
+#include "vm/log.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            pretenure,
+            false,
+            "Allocate instances of classes that keep surviving scavenges "
+            "directly in old space.");
+DEFINE_FLAG(int,
+            pretenure_min_promoted_kb,
+            256,
+            "Bytes (in KB) of a class a scavenge must promote for the scavenge "
+            "to count towards pretenuring the class.");
+DEFINE_FLAG(int,
+            pretenure_scavenges,
+            3,
+            "Number of consecutive scavenges that must promote enough of a "
+            "class before it is pretenured.");
+DEFINE_FLAG(bool, trace_pretenuring, false, "Trace pretenuring decisions.");
+
+void PretenuringFeedback::AddPromoted(
+    MallocGrowableArray<intptr_t>* promoted_by_cid) {
+  const intptr_t length = promoted_by_cid->length();
+  while (entries_.length() < length) {
+    entries_.Add({0, 0, false});
+  }
+  for (intptr_t cid = 0; cid < length; cid++) {
+    entries_[cid].promoted_bytes += (*promoted_by_cid)[cid];
+  }
+  promoted_by_cid->Clear();
+}
+
+intptr_t PretenuringFeedback::EndScavenge(bool aborted) {
+  const intptr_t min_promoted_bytes =
+      static_cast<intptr_t>(FLAG_pretenure_min_promoted_kb) * KB;
+  intptr_t num_selected = 0;
+  for (intptr_t cid = 0; cid < entries_.length(); cid++) {
+    Entry* entry = &entries_[cid];
+    // The promotions of an aborted scavenge were reversed.
+    const bool counts =
+        !aborted && (entry->promoted_bytes >= min_promoted_bytes);
+    const intptr_t promoted_bytes = entry->promoted_bytes;
+    entry->promoted_bytes = 0;
+    if (entry->pretenured) {
+      continue;
+    }
+    if (!counts) {
+      entry->streak = 0;
+      continue;
+    }
+    entry->streak++;
+    if (entry->streak >= FLAG_pretenure_scavenges) {
+      entry->pretenured = true;
+      newly_pretenured_.Add(cid);
+      num_selected++;
+      if (FLAG_trace_pretenuring) {
+        THR_Print("Pretenuring cid %" Pd " after promoting %" Pd " kB\n", cid,
+                  promoted_bytes / KB);
+      }
+    }
+  }
+  return num_selected;
+}
+
+void PretenuringFeedback::TakeNewlyPretenured(
+    MallocGrowableArray<intptr_t>* cids) {
+  for (intptr_t i = 0; i < newly_pretenured_.length(); i++) {
+    cids->Add(newly_pretenured_[i]);
+  }
+  newly_pretenured_.Clear();
+}
+
+void PretenuringFeedback::Reset() {
+  entries_.Clear();
+  newly_pretenured_.Clear();
+}
+
+}  // namespace dart
@@ -0,0 +1,57 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_PRETENURING_H_
+#define RUNTIME_VM_HEAP_PRETENURING_H_
+
+#include "platform/growable_array.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+// Tracks, per class id, how many bytes of instances each scavenge promotes.
+// A class whose instances keep being promoted in bulk, e.g., while a cache is
+// being built, is selected for allocation directly in old space, so that its
+// instances are no longer copied through the survivor space first.
+//
+// Only instances of user classes are tracked, since those are the ones
+// allocated by AllocateObject. A selection is sticky until Reset.
+class PretenuringFeedback {
+ public:
+  PretenuringFeedback() {}
+
+  // May be called by mutators and the compiler while no scavenge is running.
+  bool ShouldPretenure(intptr_t cid) const {
+    return (cid < entries_.length()) && entries_[cid].pretenured;
+  }
+
+  // Adds the bytes a scavenge worker promoted, indexed by cid, and clears
+  // them.
+  void AddPromoted(MallocGrowableArray<intptr_t>* promoted_by_cid);
+
+  // Ends the scavenge whose promotions were added. Returns the number of
+  // classes selected by this scavenge.
+  intptr_t EndScavenge(bool aborted);
+
+  // Moves the cids selected since the last call into cids.
+  void TakeNewlyPretenured(MallocGrowableArray<intptr_t>* cids);
+
+  void Reset();
+
+ private:
+  struct Entry {
+    intptr_t promoted_bytes;
+    intptr_t streak;
+    bool pretenured;
+  };
+
+  MallocGrowableArray<Entry> entries_;
+  MallocGrowableArray<intptr_t> newly_pretenured_;
+
+  DISALLOW_COPY_AND_ASSIGN(PretenuringFeedback);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_PRETENURING_H_
@@ -5,12 +5,24 @@
 #include "vm/heap/safepoint.h"
 
 #include "vm/heap/heap.h"
+#include "vm/os.h"
 #include "vm/thread.h"
 #include "vm/thread_registry.h"
+#include "vm/timeline.h"
 
 namespace dart {
 
 DEFINE_FLAG(bool, trace_safepoint, false, "Trace Safepoint logic.");
+DEFINE_FLAG(int,
+            safepoint_spin_micros,
+            50,
+            "Time the thread starting a safepoint operation polls for the "
+            "other threads to check in before waiting on a monitor.");
+DEFINE_FLAG(bool,
+            print_safepoint_latency,
+            false,
+            "Print a histogram of the time safepoint operations waited for "
+            "threads to check in when an isolate group shuts down.");
 
 SafepointOperationScope::SafepointOperationScope(Thread* T)
     : ThreadStackResource(T) {
@@ -84,10 +96,16 @@ SafepointHandler::SafepointHandler(IsolateGroup* isolate_group)
     : isolate_group_(isolate_group),
       safepoint_lock_(),
       number_threads_not_at_safepoint_(0),
+      all_threads_checked_in_(false),
+      last_arrival_id_(OSThread::kInvalidThreadId),
+      last_arrival_state_(Thread::kThreadInVM),
       safepoint_operation_count_(0),
       owner_(NULL) {}
 
 SafepointHandler::~SafepointHandler() {
+  if (FLAG_print_safepoint_latency) {
+    PrintLatencyHistogram();
+  }
   ASSERT(owner_ == NULL);
   ASSERT(safepoint_operation_count_ == 0);
   isolate_group_ = NULL;
@@ -97,6 +115,8 @@ void SafepointHandler::SafepointThreads(Thread* T) {
   ASSERT(T->no_safepoint_scope_depth() == 0);
   ASSERT(T->execution_state() == Thread::kThreadInVM);
 
+  int64_t start;
+  bool wait;
   {
     // First grab the threads list lock for this isolate
     // and check if a safepoint is already in progress. This
@@ -120,6 +140,13 @@ void SafepointHandler::SafepointThreads(Thread* T) {
     // Set safepoint in progress state by this thread.
     SetSafepointInProgress(T);
 
+    // Hold one count ourselves while requesting the safepoint, so that the
+    // threads checking in meanwhile cannot bring it to zero early.
+    start = OS::GetCurrentMonotonicMicros();
+    all_threads_checked_in_.store(false, std::memory_order_relaxed);
+    last_arrival_id_ = OSThread::kInvalidThreadId;
+    number_threads_not_at_safepoint_.store(1, std::memory_order_relaxed);
+
     // Go over the active thread list and ensure that all threads active
     // in the isolate reach a safepoint.
     Thread* current = isolate_group()->thread_registry()->active_list();
@@ -132,37 +159,52 @@ void SafepointHandler::SafepointThreads(Thread* T) {
           uint32_t state = current->SetSafepointRequested(true);
           if (!Thread::IsAtSafepoint(state)) {
             // Thread is not already at a safepoint so try to
-            // get it to a safepoint and wait for it to check in.
+            // get it to a safepoint and wait for it to check in. It cannot
+            // check in before we release its thread lock.
             if (current->IsMutatorThread()) {
               current->ScheduleInterruptsLocked(Thread::kVMInterrupt);
             }
-            MonitorLocker sl(&safepoint_lock_);
-            ++number_threads_not_at_safepoint_;
+            number_threads_not_at_safepoint_.fetch_add(1);
           }
         }
       }
       current = current->next();
     }
+    wait = (number_threads_not_at_safepoint_.fetch_sub(1) != 1);
   }
   // Now wait for all threads that are not already at a safepoint to check-in.
-  {
-    MonitorLocker sl(&safepoint_lock_);
-    intptr_t num_attempts = 0;
-    while (number_threads_not_at_safepoint_ > 0) {
-      Monitor::WaitResult retval = sl.Wait(1000);
-      if (retval == Monitor::kTimedOut) {
-        num_attempts += 1;
-        if (FLAG_trace_safepoint && num_attempts > 10) {
-          // We have been waiting too long, start logging this as we might
-          // have an issue where a thread is not checking in for a safepoint.
-          for (Thread* current =
-                   isolate_group()->thread_registry()->active_list();
-               current != NULL; current = current->next()) {
-            if (!current->IsAtSafepoint()) {
-              OS::PrintErr("Attempt:%" Pd
-                           " waiting for thread %s to check in\n",
-                           num_attempts, current->os_thread()->name());
-            }
+  if (wait) {
+    WaitForCheckIns(T);
+  }
+  RecordLatency(T, OS::GetCurrentMonotonicMicros() - start);
+}
+
+void SafepointHandler::WaitForCheckIns(Thread* T) {
+  // Threads usually check in within microseconds, which is less than it
+  // takes to sleep on the monitor and be woken up again.
+  const int64_t spin_until =
+      OS::GetCurrentMonotonicMicros() + FLAG_safepoint_spin_micros;
+  while (!all_threads_checked_in_.load(std::memory_order_acquire)) {
+    if (OS::GetCurrentMonotonicMicros() >= spin_until) {
+      break;
+    }
+  }
+
+  MonitorLocker sl(&safepoint_lock_);
+  intptr_t num_attempts = 0;
+  while (!all_threads_checked_in_.load(std::memory_order_acquire)) {
+    Monitor::WaitResult retval = sl.Wait(1000);
+    if (retval == Monitor::kTimedOut) {
+      num_attempts += 1;
+      if (FLAG_trace_safepoint && num_attempts > 10) {
+        // We have been waiting too long, start logging this as we might
+        // have an issue where a thread is not checking in for a safepoint.
+        for (Thread* current =
+                 isolate_group()->thread_registry()->active_list();
+             current != NULL; current = current->next()) {
+          if (!current->IsAtSafepoint()) {
+            OS::PrintErr("Attempt:%" Pd " waiting for thread %s to check in\n",
+                         num_attempts, current->os_thread()->name());
           }
         }
       }
@@ -170,6 +212,94 @@ void SafepointHandler::SafepointThreads(Thread* T) {
   }
 }
 
+void SafepointHandler::CheckIn(Thread* T) {
+  ASSERT(T->thread_lock()->IsOwnedByCurrentThread());
+  const intptr_t before = number_threads_not_at_safepoint_.fetch_sub(1);
+  ASSERT(before > 0);
+  if (before == 1) {
+    MonitorLocker sl(&safepoint_lock_);
+    last_arrival_id_ = T->os_thread()->id();
+    last_arrival_state_ = T->execution_state();
+    all_threads_checked_in_.store(true, std::memory_order_release);
+    sl.Notify();
+  }
+}
+
+static const char* ExecutionStateToCString(Thread::ExecutionState state) {
+  switch (state) {
+    case Thread::kThreadInVM:
+      return "VM";
+    case Thread::kThreadInGenerated:
+      return "Generated";
+    case Thread::kThreadInNative:
+      return "Native";
+    case Thread::kThreadInBlockedState:
+      return "Blocked";
+  }
+  return "Unknown";
+}
+
+void SafepointHandler::RecordLatency(Thread* T, int64_t micros) {
+  intptr_t bucket = 0;
+  while ((bucket < kNumLatencyBuckets - 1) &&
+         (micros >= (static_cast<int64_t>(1) << bucket))) {
+    bucket++;
+  }
+  latency_histogram_[bucket].fetch_add(1);
+
+  IsolateGroup* isolate_group = isolate_group_;
+  isolate_group->GetSafepointCountMetric()->increment();
+  isolate_group->GetSafepointLatencyMetric()->set_value(micros);
+  isolate_group->GetSafepointLatencyMaxMetric()->SetValue(micros);
+
+#if !defined(PRODUCT)
+  TimelineStream* stream = Timeline::GetGCStream();
+  if (stream->enabled()) {
+    TimelineEvent* event = stream->StartEvent();
+    if (event != nullptr) {
+      const int64_t end = OS::GetCurrentMonotonicMicros();
+      event->Duration("SafepointThreads", end - micros, end);
+      event->SetNumArguments(2);
+      if (last_arrival_id_ == OSThread::kInvalidThreadId) {
+        event->CopyArgument(0, "LastArrival", "none");
+        event->CopyArgument(1, "LastArrivalState", "none");
+      } else {
+        event->FormatArgument(0, "LastArrival", "%" Pd "",
+                              OSThread::ThreadIdToIntPtr(last_arrival_id_));
+        event->CopyArgument(1, "LastArrivalState",
+                            ExecutionStateToCString(last_arrival_state_));
+      }
+      event->Complete();
+    }
+  }
+#endif  // !defined(PRODUCT)
+
+  if (FLAG_trace_safepoint &&
+      (last_arrival_id_ != OSThread::kInvalidThreadId)) {
+    OS::PrintErr("Safepoint reached in %" Pd64 " us; last thread %" Pd
+                 " arrived from %s\n",
+                 micros, OSThread::ThreadIdToIntPtr(last_arrival_id_),
+                 ExecutionStateToCString(last_arrival_state_));
+  }
+}
+
+void SafepointHandler::PrintLatencyHistogram() const {
+  OS::PrintErr("Safepoint latency histogram:\n");
+  for (intptr_t i = 0; i < kNumLatencyBuckets; i++) {
+    const int64_t count = latency_histogram_[i];
+    if (count == 0) {
+      continue;
+    }
+    if (i == kNumLatencyBuckets - 1) {
+      OS::PrintErr("  >= %" Pd64 " us: %" Pd64 "\n",
+                   static_cast<int64_t>(1) << (i - 1), count);
+    } else {
+      OS::PrintErr("  < %" Pd64 " us: %" Pd64 "\n",
+                   static_cast<int64_t>(1) << i, count);
+    }
+  }
+}
+
 void SafepointHandler::ResumeThreads(Thread* T) {
   // First resume all the threads which are blocked for the safepoint
   // operation.
@@ -208,10 +338,7 @@ void SafepointHandler::EnterSafepointUsingLock(Thread* T) {
   MonitorLocker tl(T->thread_lock());
   T->SetAtSafepoint(true);
   if (T->IsSafepointRequested()) {
-    MonitorLocker sl(&safepoint_lock_);
-    ASSERT(number_threads_not_at_safepoint_ > 0);
-    number_threads_not_at_safepoint_ -= 1;
-    sl.Notify();
+    CheckIn(T);
   }
 }
 
@@ -231,12 +358,7 @@ void SafepointHandler::BlockForSafepoint(Thread* T) {
   MonitorLocker tl(T->thread_lock());
   if (T->IsSafepointRequested()) {
     T->SetAtSafepoint(true);
-    {
-      MonitorLocker sl(&safepoint_lock_);
-      ASSERT(number_threads_not_at_safepoint_ > 0);
-      number_threads_not_at_safepoint_ -= 1;
-      sl.Notify();
-    }
+    CheckIn(T);
     while (T->IsSafepointRequested()) {
       T->SetBlockedForSafepoint(true);
       tl.Wait();
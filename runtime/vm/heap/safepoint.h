@@ -5,6 +5,9 @@
 #ifndef RUNTIME_VM_HEAP_SAFEPOINT_H_
 #define RUNTIME_VM_HEAP_SAFEPOINT_H_
 
+#include <atomic>
+
+#include "platform/atomic.h"
 #include "vm/globals.h"
 #include "vm/isolate.h"
 #include "vm/lockers.h"
@@ -53,10 +56,25 @@ class SafepointHandler {
 
   bool IsOwnedByTheThread(Thread* thread) { return owner_ == thread; }
 
+  // Histogram of the time safepoint operations waited for the other threads
+  // to check in. Bucket i counts waits shorter than 2^i microseconds (and at
+  // least 2^(i-1)); the last bucket also counts all longer waits.
+  static constexpr intptr_t kNumLatencyBuckets = 20;
+  int64_t LatencyBucketCount(intptr_t bucket) const {
+    ASSERT((bucket >= 0) && (bucket < kNumLatencyBuckets));
+    return latency_histogram_[bucket];
+  }
+  void PrintLatencyHistogram() const;
+
  private:
   void SafepointThreads(Thread* T);
   void ResumeThreads(Thread* T);
 
+  // Called by a thread that reached a safepoint requested from it.
+  void CheckIn(Thread* T);
+  void WaitForCheckIns(Thread* T);
+  void RecordLatency(Thread* T, int64_t micros);
+
   IsolateGroup* isolate_group() const { return isolate_group_; }
   Monitor* threads_lock() const { return isolate_group_->threads_lock(); }
   bool SafepointInProgress() const {
@@ -94,10 +112,19 @@ class SafepointHandler {
 
   IsolateGroup* isolate_group_;
 
-  // Monitor used by thread initiating a safepoint operation to track threads
-  // not at a safepoint and wait for these threads to reach a safepoint.
+  // Monitor used by thread initiating a safepoint operation to wait for the
+  // threads not at a safepoint to reach one.
   Monitor safepoint_lock_;
-  int32_t number_threads_not_at_safepoint_;
+  // Threads not yet at a safepoint, plus one held by the initiating thread
+  // while it requests the safepoint. Decremented without a lock; only the
+  // thread that brings it to zero takes safepoint_lock_, to record itself as
+  // the last arrival and notify.
+  std::atomic<intptr_t> number_threads_not_at_safepoint_;
+  std::atomic<bool> all_threads_checked_in_;
+  ThreadId last_arrival_id_;
+  Thread::ExecutionState last_arrival_state_;
+
+  RelaxedAtomic<int64_t> latency_histogram_[kNumLatencyBuckets];
 
   // Count that indicates if a safepoint operation is currently in progress
   // and also tracks the number of recursive safepoint operations on the
@@ -0,0 +1,259 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/heap/sampler.h"
+
+#include <math.h>
+
+#include "platform/text_buffer.h"
+#include "vm/flags.h"
+#include "vm/hash.h"
+#include "vm/heap/heap.h"
+#include "vm/object.h"
+#include "vm/stack_frame.h"
+#include "vm/thread.h"
+
+namespace dart {
+
+DEFINE_FLAG(int,
+            heap_sample_interval,
+            0,
+            "Record the allocating stack of about one new-space allocation "
+            "every this many bytes, for live-heap profiles (0 disables).");
+
+HeapSampler::Site::Site(intptr_t length, uword* pcs)
+    : id_(-1), length_(length), pcs_(pcs), hash_(length) {
+  for (intptr_t i = 0; i < length; i++) {
+    hash_ = CombineHashes(hash_, static_cast<uint32_t>(pcs[i]));
+  }
+  hash_ = FinalizeHash(hash_, kBitsPerInt32 - 1);
+}
+
+HeapSampler::Site* HeapSampler::Site::Clone() const {
+  uword* pcs = reinterpret_cast<uword*>(malloc(length_ * sizeof(uword)));
+  memmove(pcs, pcs_, length_ * sizeof(uword));
+  return new Site(length_, pcs);
+}
+
+void HeapSampler::Site::Free() {
+  free(pcs_);
+  delete this;
+}
+
+bool HeapSampler::Site::Equals(const Site* other) const {
+  if ((hash_ != other->hash_) || (length_ != other->length_)) {
+    return false;
+  }
+  for (intptr_t i = 0; i < length_; i++) {
+    if (pcs_[i] != other->pcs_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HeapSampler::~HeapSampler() {
+  for (intptr_t i = 0; i < sites_.length(); i++) {
+    sites_[i]->Free();
+  }
+}
+
+bool HeapSampler::IsEnabled() {
+  return FLAG_heap_sample_interval > 0;
+}
+
+intptr_t HeapSampler::NextInterval(Thread* thread) {
+  // Exponentially distributed with mean FLAG_heap_sample_interval, from a
+  // uniform double in (0, 1].
+  const double uniform =
+      static_cast<double>((thread->GetRandomUInt64() >> 11) + 1) /
+      static_cast<double>(static_cast<uint64_t>(1) << 53);
+  const double interval = -log(uniform) * FLAG_heap_sample_interval;
+  return static_cast<intptr_t>(
+      Utils::Minimum(interval, static_cast<double>(kMaxInt32)));
+}
+
+void HeapSampler::ArmTLAB(Thread* thread) {
+  const uword top = thread->top();
+  thread->set_heap_sample_base(top);
+  if (!IsEnabled()) {
+    return;
+  }
+  intptr_t countdown = thread->heap_sample_countdown();
+  if (countdown < 0) {
+    countdown = NextInterval(thread);
+    thread->set_heap_sample_countdown(countdown);
+  }
+  if (countdown < static_cast<intptr_t>(thread->end() - top)) {
+    thread->set_end(top + countdown);
+  }
+}
+
+void HeapSampler::DisarmTLAB(Thread* thread) {
+  const intptr_t countdown = thread->heap_sample_countdown();
+  if (countdown < 0) {
+    return;
+  }
+  const uword top = thread->top();
+  const intptr_t allocated = top - thread->heap_sample_base();
+  thread->set_heap_sample_countdown(
+      Utils::Maximum<intptr_t>(countdown - allocated, 0));
+  thread->set_heap_sample_base(top);
+}
+
+bool HeapSampler::HandleSamplingPoint(Thread* thread,
+                                      intptr_t size,
+                                      uword page_end) {
+  const uword top = thread->top();
+  if (thread->end() >= page_end) {
+    // The TLAB is really exhausted.
+    return false;
+  }
+  if (!IsEnabled()) {
+    // Sampling was turned off after this TLAB was armed.
+    thread->set_end(page_end);
+    return static_cast<intptr_t>(page_end - top) >= size;
+  }
+
+  // The allocation crosses the sampling point at thread->end(). Sampling
+  // points it covers beyond that one are skipped, so that the next point
+  // falls after it.
+  DisarmTLAB(thread);
+  intptr_t remaining = thread->heap_sample_countdown() - size;
+  ASSERT(remaining < 0);
+  do {
+    remaining += NextInterval(thread);
+  } while (remaining < 0);
+  thread->set_heap_sample_countdown(size + remaining);
+  thread->set_heap_sample_pending(true);
+
+  if (static_cast<intptr_t>(page_end - top) < size) {
+    // Take a new TLAB, which is armed from the updated countdown.
+    return false;
+  }
+  thread->set_end(page_end);
+  ArmTLAB(thread);
+  return true;
+}
+
+void HeapSampler::RecordSample(Thread* thread, ObjectPtr obj) {
+  thread->set_heap_sample_pending(false);
+
+  uword pcs[kMaxFrames];
+  intptr_t length = 0;
+  if (thread->top_exit_frame_info() != 0) {
+    DartFrameIterator frames(thread,
+                             StackFrameIterator::kNoCrossThreadIteration);
+    for (StackFrame* frame = frames.NextFrame();
+         (frame != nullptr) && (length < kMaxFrames);
+         frame = frames.NextFrame()) {
+      pcs[length++] = frame->pc();
+    }
+  }
+
+  Site key(length, pcs);
+  MutexLocker ml(&mutex_);
+  Site* site = site_map_.LookupValue(&key);
+  if (site == nullptr) {
+    site = key.Clone();
+    site->set_id(sites_.length());
+    sites_.Add(site);
+    site_map_.Insert(site);
+  }
+  heap_->SetWeakEntry(obj, Heap::kHeapSamples, site->id() + 1);
+}
+
+namespace {
+
+struct LiveSample {
+  intptr_t site;
+  intptr_t cid;
+  double bytes;
+};
+
+}  // namespace
+
+static int CompareLiveSamples(const LiveSample* a, const LiveSample* b) {
+  if (a->site != b->site) {
+    return (a->site < b->site) ? -1 : 1;
+  }
+  if (a->cid != b->cid) {
+    return (a->cid < b->cid) ? -1 : 1;
+  }
+  return 0;
+}
+
+static const char* FrameName(Zone* zone, uword pc) {
+  Code& code = Code::Handle(zone, Code::LookupCode(pc));
+  if (code.IsNull()) {
+    code = Code::LookupCodeInVmIsolate(pc);
+  }
+  if (code.IsNull()) {
+    return OS::SCreate(zone, "0x%" Px "", pc);
+  }
+  const Object& owner = Object::Handle(zone, code.owner());
+  if (owner.IsFunction()) {
+    return Function::Cast(owner).QualifiedUserVisibleNameCString();
+  }
+  return code.QualifiedName(NameFormattingParams(Object::kUserVisibleName));
+}
+
+void HeapSampler::PrintLiveFoldedStacks(Thread* thread, TextBuffer* buffer) {
+  heap_->CollectAllGarbage();
+
+  Zone* zone = thread->zone();
+  GrowableArray<LiveSample> samples(zone, 64);
+  {
+    HeapIterationScope iteration(thread);
+    const double interval = FLAG_heap_sample_interval;
+    for (Heap::Space space : {Heap::kNew, Heap::kOld}) {
+      WeakTable* table = heap_->GetWeakTable(space, Heap::kHeapSamples);
+      for (intptr_t i = 0; i < table->size(); i++) {
+        if (!table->IsValidEntryAtExclusive(i)) {
+          continue;
+        }
+        ObjectPtr obj = table->ObjectAtExclusive(i);
+        const double size = obj->ptr()->HeapSize();
+        // An object of size bytes is sampled with probability
+        // 1 - exp(-size / interval), so it stands for this many bytes.
+        const double bytes = size / (1.0 - exp(-size / interval));
+        samples.Add({table->ValueAtExclusive(i) - 1, obj->GetClassId(), bytes});
+      }
+    }
+  }
+  samples.Sort(CompareLiveSamples);
+
+  // Sites are never changed once added, but symbolizing frames may allocate,
+  // so it must not happen while holding the lock RecordSample takes inside a
+  // NoSafepointScope.
+  GrowableArray<const Site*> sites(zone, samples.length());
+  {
+    MutexLocker ml(&mutex_);
+    for (intptr_t i = 0; i < samples.length(); i++) {
+      sites.Add(sites_[samples[i].site]);
+    }
+  }
+
+  ClassTable* class_table = thread->isolate_group()->class_table();
+  Class& cls = Class::Handle(zone);
+  intptr_t i = 0;
+  while (i < samples.length()) {
+    const intptr_t first = i;
+    double bytes = 0;
+    for (; (i < samples.length()) && (samples[i].site == samples[first].site) &&
+           (samples[i].cid == samples[first].cid);
+         i++) {
+      bytes += samples[i].bytes;
+    }
+    const Site* site = sites[first];
+    for (intptr_t j = site->length() - 1; j >= 0; j--) {
+      buffer->Printf("%s;", FrameName(zone, site->PcAt(j)));
+    }
+    cls = class_table->At(samples[first].cid);
+    buffer->Printf("%s %" Pd64 "\n", cls.ScrubbedNameCString(),
+                   static_cast<int64_t>(bytes + 0.5));
+  }
+}
+
+}  // namespace dart
@@ -0,0 +1,99 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_SAMPLER_H_
+#define RUNTIME_VM_HEAP_SAMPLER_H_
+
+#include "platform/growable_array.h"
+#include "vm/globals.h"
+#include "vm/hash_map.h"
+#include "vm/lockers.h"
+#include "vm/tagged_pointer.h"
+
+namespace dart {
+
+class Heap;
+class TextBuffer;
+class Thread;
+
+// Samples new-space allocations as a Poisson process over the allocated
+// bytes, one sample every --heap_sample_interval bytes on average, as
+// heapprofd and JFR do.
+//
+// The inline allocation fast paths are not changed. Instead, the end of a
+// thread's TLAB is moved back to the next sampling point, so the allocation
+// that crosses it takes the slow path through Scavenger::TryAllocateNewTLAB,
+// which marks it as sampled. Object::InitializeAllocation then records the
+// allocating stack. Sampled objects are tagged with their allocation site in
+// a weak table, so the live-heap profile only counts objects that survived.
+class HeapSampler {
+ public:
+  explicit HeapSampler(Heap* heap) : heap_(heap) {}
+  ~HeapSampler();
+
+  static bool IsEnabled();
+
+  // Moves the end of a freshly acquired TLAB back to the next sampling point.
+  static void ArmTLAB(Thread* thread);
+
+  // Counts the bytes allocated in the TLAB towards the next sampling point
+  // before the TLAB is released.
+  static void DisarmTLAB(Thread* thread);
+
+  // Called when an allocation of size bytes does not fit below thread->end()
+  // of a TLAB on a page ending at page_end. Returns true if the TLAB only
+  // ended at a sampling point and has been extended, so the allocation can
+  // proceed from it.
+  static bool HandleSamplingPoint(Thread* thread,
+                                  intptr_t size,
+                                  uword page_end);
+
+  // Records the allocation site of obj, the allocation marked as sampled by
+  // HandleSamplingPoint.
+  void RecordSample(Thread* thread, ObjectPtr obj);
+
+  // Collects garbage, then writes one "outer;...;inner;Class bytes" line per
+  // allocation site and class of the sampled objects that are still alive.
+  // The bytes are an estimate of all live objects the samples stand for.
+  void PrintLiveFoldedStacks(Thread* thread, TextBuffer* buffer);
+
+ private:
+  class Site {
+   public:
+    Site(intptr_t length, uword* pcs);
+
+    intptr_t id() const { return id_; }
+    void set_id(intptr_t id) { id_ = id; }
+    intptr_t length() const { return length_; }
+    uword PcAt(intptr_t i) const { return pcs_[i]; }
+
+    // Copies pcs, which Site otherwise does not own.
+    Site* Clone() const;
+    void Free();
+
+    intptr_t Hashcode() const { return hash_; }
+    bool Equals(const Site* other) const;
+
+   private:
+    intptr_t id_;
+    intptr_t length_;
+    uword* pcs_;
+    intptr_t hash_;
+  };
+
+  static const intptr_t kMaxFrames = 64;
+
+  static intptr_t NextInterval(Thread* thread);
+
+  Heap* heap_;
+  Mutex mutex_;
+  MallocGrowableArray<Site*> sites_;
+  MallocDirectChainedHashMap<PointerKeyValueTrait<Site>> site_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSampler);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_SAMPLER_H_
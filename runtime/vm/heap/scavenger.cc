@@ -11,6 +11,7 @@
 #include "vm/heap/become.h"
 #include "vm/heap/pointer_block.h"
 #include "vm/heap/safepoint.h"
+#include "vm/heap/sampler.h"
 #include "vm/heap/verifier.h"
 #include "vm/heap/weak_table.h"
 #include "vm/isolate.h"
@@ -21,6 +22,7 @@
 #include "vm/object_set.h"
 #include "vm/stack_frame.h"
 #include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/thread_registry.h"
 #include "vm/timeline.h"
 #include "vm/visitor.h"
@@ -37,6 +39,22 @@ DEFINE_FLAG(int,
             90,
             "Grow new gen when less than this percentage is garbage.");
 DEFINE_FLAG(int, new_gen_growth_factor, 2, "Grow new gen by this factor.");
+DEFINE_FLAG(int,
+            new_gen_pause_target_micros,
+            0,
+            "When positive, size new gen from recent survival rates and "
+            "scavenge speed so that scavenges take about this long.");
+DEFINE_FLAG(bool,
+            trace_scavenger_workers,
+            false,
+            "Print per-worker statistics after each parallel scavenge.");
+DEFINE_FLAG(bool,
+            concurrent_from_space_release,
+            false,
+            "Return the pages of the evacuated semi-space on a helper thread "
+            "instead of during the scavenge pause.");
+
+DECLARE_FLAG(bool, pretenure);
 
 // Scavenger uses the kCardRememberedBit to distinguish forwarded and
 // non-forwarded objects. We must choose a bit that is clear for all new-space
@@ -105,11 +123,18 @@ static inline void objcpy(void* dst, const void* src, size_t size) {
 template <bool parallel>
 class ScavengerVisitorBase : public ObjectPointerVisitor {
  public:
+  // A parallel visitor works off its own deque, worker_stacks[worker_index],
+  // and steals blocks from the deques of the other workers when it runs out
+  // of work.
   explicit ScavengerVisitorBase(IsolateGroup* isolate_group,
                                 Scavenger* scavenger,
                                 SemiSpace* from,
                                 FreeList* freelist,
-                                PromotionStack* promotion_stack)
+                                PromotionStack* promotion_stack,
+                                PromotionStack* worker_stacks = nullptr,
+                                intptr_t num_workers = 1,
+                                intptr_t worker_index = 0,
+                                RelaxedAtomic<uintptr_t>* num_busy = nullptr)
       : ObjectPointerVisitor(isolate_group),
         thread_(nullptr),
         scavenger_(scavenger),
@@ -117,9 +142,16 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
         page_space_(scavenger->heap_->old_space()),
         freelist_(freelist),
         bytes_promoted_(0),
+        bytes_copied_(0),
         visiting_old_object_(nullptr),
         promoted_list_(promotion_stack),
-        delayed_weak_properties_(WeakProperty::null()) {}
+        worker_stacks_(worker_stacks),
+        num_workers_(num_workers),
+        worker_index_(worker_index),
+        num_busy_(num_busy),
+        delayed_weak_properties_(WeakProperty::null()) {
+    ASSERT(!parallel || (promotion_stack == &worker_stacks[worker_index]));
+  }
 
   virtual void VisitTypedDataViewPointers(TypedDataViewPtr view,
                                           ObjectPtr* first,
@@ -171,12 +203,25 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
     ASSERT((obj == nullptr) || obj->IsOldObject());
     visiting_old_object_ = obj;
     if (obj != nullptr) {
-      // Card update happens in OldPage::VisitRememberedCards.
-      ASSERT(!obj->ptr()->IsCardRemembered());
+      // Card update happens in OldPage::VisitRememberedCards, except for
+      // arrays promoted by this scavenge (see UpdateStoreBuffer).
+      ASSERT(!obj->ptr()->IsCardRemembered() || obj->IsArray());
     }
   }
 
   intptr_t bytes_promoted() const { return bytes_promoted_; }
+  MallocGrowableArray<intptr_t>* promoted_by_cid() { return &promoted_by_cid_; }
+
+  ScavengeWorkerStats worker_stats() const {
+    ScavengeWorkerStats result = stats_;
+    result.bytes_copied = bytes_copied_;
+    result.bytes_promoted = bytes_promoted_;
+    return result;
+  }
+  void RecordTimes(int64_t busy_micros, int64_t idle_micros) {
+    stats_.busy_micros = busy_micros;
+    stats_.idle_micros = idle_micros;
+  }
 
   void ProcessRoots() {
     thread_ = Thread::Current();
@@ -226,7 +271,7 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
   bool HasWork() {
     if (scavenger_->abort_) return false;
     return (scan_ != tail_) || (scan_ != nullptr && !scan_->IsResolved()) ||
-           !promoted_list_.IsEmpty();
+           !promoted_list_.IsEmpty() || HasStealableWork();
   }
 
   void Finalize() {
@@ -252,10 +297,72 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
   NewPage* tail() const { return tail_; }
 
  private:
+  // Whether the deque of another worker has blocks that can be stolen.
+  bool HasStealableWork() {
+    if (!parallel) return false;
+    for (intptr_t i = 1; i < num_workers_; i++) {
+      if (!worker_stacks_[(worker_index_ + i) % num_workers_].IsEmpty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Moves a non-empty block from another worker's deque into ours. Victims
+  // are probed round-robin starting after this worker.
+  bool TrySteal() {
+    ASSERT(parallel);
+    for (intptr_t i = 1; i < num_workers_; i++) {
+      PromotionStack* victim =
+          &worker_stacks_[(worker_index_ + i) % num_workers_];
+      PromotionStackBlock* block = victim->PopNonEmptyBlock();
+      if (block != nullptr) {
+        worker_stacks_[worker_index_].PushBlock(block);
+        stats_.blocks_stolen++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Whether other workers are idle and our deque has nothing for them to
+  // steal. Only checked every kDonationCheckInterval scanned objects.
+  DART_FORCE_INLINE
+  bool ShouldDonate() {
+    if (--donation_countdown_ > 0) return false;
+    donation_countdown_ = kDonationCheckInterval;
+    return (num_busy_->load() < static_cast<uintptr_t>(num_workers_)) &&
+           worker_stacks_[worker_index_].IsEmpty();
+  }
+
+  // Pushes up to a block of copied but not yet scanned to-space objects to our
+  // deque, where idle workers can steal them. Returns the new scan address.
+  uword DonateToSpace(uword scan, uword top) {
+    intptr_t count = 0;
+    while ((scan < top) && (count < kPromotionStackBlockSize)) {
+      ObjectPtr raw_obj = ObjectLayout::FromAddr(scan);
+      scan += raw_obj->ptr()->HeapSize();
+      promoted_list_.Push(raw_obj);
+      count++;
+    }
+    promoted_list_.Flush();
+    stats_.objects_donated += count;
+    return scan;
+  }
+
   void UpdateStoreBuffer(ObjectPtr* p, ObjectPtr obj) {
     ASSERT(obj->IsHeapObject());
     // If the newly written object is not a new object, drop it immediately.
-    if (!obj->IsNewObject() || visiting_old_object_->ptr()->IsRemembered()) {
+    if (!obj->IsNewObject()) {
+      return;
+    }
+    if (UNLIKELY(visiting_old_object_->ptr()->IsCardRemembered())) {
+      // A large array promoted by this scavenge. Its page is not part of the
+      // snapshot the card slice visits, so only this worker touches its cards.
+      OldPage::Of(visiting_old_object_)->RememberCard(p);
+      return;
+    }
+    if (visiting_old_object_->ptr()->IsRemembered()) {
       return;
     }
     visiting_old_object_->ptr()->SetRememberedBit();
@@ -284,7 +391,9 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
       new_obj = ForwardedObj(header);
     } else {
       intptr_t size = raw_obj->ptr()->HeapSize(header);
+      intptr_t cid = ObjectLayout::ClassIdTag::decode(header);
       uword new_addr = 0;
+      bool card_remembered = false;
       // Check whether object should be promoted.
       if (!NewPage::Of(raw_obj)->IsSurvivor(raw_addr)) {
         // Not a survivor of a previous scavenge. Just copy the object into the
@@ -294,12 +403,22 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
       if (new_addr == 0) {
         // This object is a survivor of a previous scavenge. Attempt to promote
         // the object. (Or, unlikely, to-space was exhausted by fragmentation.)
-        new_addr = page_space_->TryAllocatePromoLocked(freelist_, size);
+        if (UNLIKELY(!Heap::IsAllocatableViaFreeLists(size)) &&
+            (cid == kArrayCid)) {
+          // Large arrays get a page of their own and remember individual
+          // cards from now on, so that later scavenges visit only the parts
+          // written since instead of the whole array.
+          new_addr = page_space_->TryAllocatePromoLargeLocked(freelist_, size);
+          card_remembered = (new_addr != 0);
+        } else {
+          new_addr = page_space_->TryAllocatePromoLocked(freelist_, size);
+        }
         if (LIKELY(new_addr != 0)) {
           // If promotion succeeded then we need to remember it so that it can
           // be traversed later.
           promoted_list_.Push(ObjectLayout::FromAddr(new_addr));
           bytes_promoted_ += size;
+          RecordPromotedByCid(cid, size);
         } else {
           // Promotion did not succeed. Copy into the to space instead.
           scavenger_->failed_to_promote_ = true;
@@ -330,10 +449,10 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
         // push it to the mark stack after forwarding its slots.
         tags = ObjectLayout::OldAndNotMarkedBit::update(!thread_->is_marking(),
                                                         tags);
+        tags = ObjectLayout::CardRememberedBit::update(card_remembered, tags);
         new_obj->ptr()->tags_ = tags;
       }
 
-      intptr_t cid = ObjectLayout::ClassIdTag::decode(header);
       if (IsTypedDataClassId(cid)) {
         static_cast<TypedDataPtr>(new_obj)->ptr()->RecomputeDataField();
       }
@@ -346,12 +465,15 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
           // Abandon as a free list element.
           FreeListElement::AsElement(new_addr, size);
           bytes_promoted_ -= size;
+          RecordPromotedByCid(cid, -size);
         } else {
           // Undo to-space allocation.
           tail_->Unallocate(new_addr, size);
         }
         // Use the winner's forwarding target.
         new_obj = ForwardedObj(header);
+      } else if (new_obj->IsNewObject()) {
+        bytes_copied_ += size;
       }
     }
 
@@ -418,15 +540,39 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
   inline void EnqueueWeakProperty(WeakPropertyPtr raw_weak);
   inline void MournWeakProperties();
 
+  void RecordPromotedByCid(intptr_t cid, intptr_t size) {
+    if (!FLAG_pretenure || (cid < kNumPredefinedCids)) {
+      return;
+    }
+    while (promoted_by_cid_.length() <= cid) {
+      promoted_by_cid_.Add(0);
+    }
+    promoted_by_cid_[cid] += size;
+  }
+
+  static constexpr intptr_t kDonationCheckInterval = 256;
+
   Thread* thread_;
   Scavenger* scavenger_;
   SemiSpace* from_;
   PageSpace* page_space_;
   FreeList* freelist_;
   intptr_t bytes_promoted_;
+  intptr_t bytes_copied_;
   ObjectPtr visiting_old_object_;
+  // Bytes promoted by instances of user classes, indexed by cid.
+  MallocGrowableArray<intptr_t> promoted_by_cid_;
 
+  // Promoted objects whose slots still need to be visited. During a parallel
+  // scavenge this also holds to-space objects donated to idle workers.
   PromotionWorkList promoted_list_;
+  PromotionStack* const worker_stacks_;
+  const intptr_t num_workers_;
+  const intptr_t worker_index_;
+  RelaxedAtomic<uintptr_t>* const num_busy_;
+  intptr_t donation_countdown_ = kDonationCheckInterval;
+  ScavengeWorkerStats stats_;
+
   WeakPropertyPtr delayed_weak_properties_;
 
   NewPage* head_ = nullptr;
@@ -441,10 +587,11 @@ typedef ScavengerVisitorBase<true> ParallelScavengerVisitor;
 
 class ScavengerWeakVisitor : public HandleVisitor {
  public:
-  ScavengerWeakVisitor(Thread* thread, Scavenger* scavenger)
+  ScavengerWeakVisitor(Thread* thread, Scavenger* scavenger, bool parallel)
       : HandleVisitor(thread),
         scavenger_(scavenger),
-        class_table_(thread->isolate_group()->shared_class_table()) {
+        class_table_(thread->isolate_group()->shared_class_table()),
+        parallel_(parallel) {
     ASSERT(scavenger->heap_->isolate_group() == thread->isolate_group());
   }
 
@@ -453,7 +600,12 @@ class ScavengerWeakVisitor : public HandleVisitor {
         reinterpret_cast<FinalizablePersistentHandle*>(addr);
     ObjectPtr* p = handle->raw_addr();
     if (scavenger_->IsUnreachable(p)) {
-      handle->UpdateUnreachable(thread()->isolate_group());
+      IsolateGroup* isolate_group = thread()->isolate_group();
+      if (parallel_ && !handle->finalizer_deferred()) {
+        isolate_group->api_state()->AddPendingFinalization(handle);
+      } else {
+        handle->UpdateUnreachable(isolate_group);
+      }
     } else {
       handle->UpdateRelocated(thread()->isolate_group());
     }
@@ -462,10 +614,53 @@ class ScavengerWeakVisitor : public HandleVisitor {
  private:
   Scavenger* scavenger_;
   SharedClassTable* class_table_;
+  const bool parallel_;
 
   DISALLOW_COPY_AND_ASSIGN(ScavengerWeakVisitor);
 };
 
+class MournWeakHandlesTask : public ThreadPool::Task {
+ public:
+  MournWeakHandlesTask(IsolateGroup* isolate_group,
+                       Scavenger* scavenger,
+                       ThreadBarrier* barrier,
+                       intptr_t slice,
+                       intptr_t num_slices)
+      : isolate_group_(isolate_group),
+        scavenger_(scavenger),
+        barrier_(barrier),
+        slice_(slice),
+        num_slices_(num_slices) {}
+
+  virtual void Run() {
+    bool result = Thread::EnterIsolateGroupAsHelper(
+        isolate_group_, Thread::kScavengerTask, /*bypass_safepoint=*/true);
+    ASSERT(result);
+
+    RunEnteredIsolateGroup();
+
+    Thread::ExitIsolateGroupAsHelper(/*bypass_safepoint=*/true);
+
+    barrier_->Exit();
+  }
+
+  void RunEnteredIsolateGroup() {
+    ScavengerWeakVisitor weak_visitor(Thread::Current(), scavenger_,
+                                      /*parallel=*/true);
+    isolate_group_->api_state()->VisitWeakHandlesSliceUnlocked(
+        &weak_visitor, slice_, num_slices_);
+  }
+
+ private:
+  IsolateGroup* isolate_group_;
+  Scavenger* scavenger_;
+  ThreadBarrier* barrier_;
+  const intptr_t slice_;
+  const intptr_t num_slices_;
+
+  DISALLOW_COPY_AND_ASSIGN(MournWeakHandlesTask);
+};
+
 class ParallelScavengerTask : public ThreadPool::Task {
  public:
   ParallelScavengerTask(IsolateGroup* isolate_group,
@@ -492,6 +687,7 @@ class ParallelScavengerTask : public ThreadPool::Task {
 
   void RunEnteredIsolateGroup() {
     TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ParallelScavenge");
+    const int64_t start = OS::GetCurrentMonotonicMicros();
 
     visitor_->ProcessRoots();
 
@@ -508,8 +704,10 @@ class ParallelScavengerTask : public ThreadPool::Task {
         // Wait for some work to appear.
         // TODO(iposva): Replace busy-waiting with a solution using Monitor,
         // and redraw the boundaries between stack/visitor/task as needed.
+        const int64_t wait_start = OS::GetCurrentMonotonicMicros();
         while (!visitor_->HasWork() && num_busy_->load() > 0) {
         }
+        idle_micros_ += OS::GetCurrentMonotonicMicros() - wait_start;
 
         // If no tasks are busy, there will never be more work.
         if (num_busy_->load() == 0) break;
@@ -518,13 +716,13 @@ class ParallelScavengerTask : public ThreadPool::Task {
         num_busy_->fetch_add(1u);
       } while (true);
       // Wait for all scavengers to stop.
-      barrier_->Sync();
+      Sync();
 #if defined(DEBUG)
       ASSERT(num_busy_->load() == 0);
       // Caveat: must not allow any marker to continue past the barrier
       // before we checked num_busy, otherwise one of them might rush
       // ahead and increment it.
-      barrier_->Sync();
+      Sync();
 #endif
       // Check if we have any pending properties with marked keys.
       // Those might have been marked by another marker.
@@ -539,30 +737,57 @@ class ParallelScavengerTask : public ThreadPool::Task {
       // weak properties and decide if they need to continue marking.
       // Caveat: we need two barriers here to make this decision in lock step
       // between all scavengers and the main thread.
-      barrier_->Sync();
+      Sync();
       if (!more_to_scavenge && (num_busy_->load() > 0)) {
         // All scavengers continue to mark as long as any single marker has
         // some work to do.
         num_busy_->fetch_add(1u);
         more_to_scavenge = true;
       }
-      barrier_->Sync();
+      Sync();
     } while (more_to_scavenge);
 
     // Phase 2: Weak processing, statistics.
     visitor_->Finalize();
+    // The visitor must not be touched after the final barrier: the main
+    // thread collects its statistics and deletes it.
+    const int64_t total_micros = OS::GetCurrentMonotonicMicros() - start;
+    visitor_->RecordTimes(total_micros - idle_micros_, idle_micros_);
     barrier_->Sync();
   }
 
  private:
+  // Waits for all other scavengers, accounting the wait as idle time.
+  void Sync() {
+    const int64_t wait_start = OS::GetCurrentMonotonicMicros();
+    barrier_->Sync();
+    idle_micros_ += OS::GetCurrentMonotonicMicros() - wait_start;
+  }
+
   IsolateGroup* isolate_group_;
   ThreadBarrier* barrier_;
   ParallelScavengerVisitor* visitor_;
   RelaxedAtomic<uintptr_t>* num_busy_;
+  int64_t idle_micros_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(ParallelScavengerTask);
 };
 
+// Frees the pages of an evacuated semi-space after mutators resume. Nothing
+// refers into from-space once Epilogue runs, so the pages are only touched by
+// this task and the (locked) page cache.
+class SemiSpaceReleaseTask : public ThreadPool::Task {
+ public:
+  explicit SemiSpaceReleaseTask(SemiSpace* space) : space_(space) {}
+
+  virtual void Run() { delete space_; }
+
+ private:
+  SemiSpace* space_;
+
+  DISALLOW_COPY_AND_ASSIGN(SemiSpaceReleaseTask);
+};
+
 SemiSpace::SemiSpace(intptr_t max_capacity_in_words)
     : max_capacity_in_words_(max_capacity_in_words), head_(nullptr) {}
 
@@ -757,6 +982,9 @@ intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   if (stats_history_.Size() == 0) {
     return old_size_in_words;
   }
+  if (FLAG_new_gen_pause_target_micros > 0) {
+    return PauseTargetSizeInWords(old_size_in_words);
+  }
   double garbage = stats_history_.Get(0).ExpectedGarbageFraction();
   if (garbage < (FLAG_new_gen_garbage_threshold / 100.0)) {
     return Utils::Minimum(max_semi_capacity_in_words_,
@@ -766,6 +994,54 @@ intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   }
 }
 
+// Scavenge time is proportional to the amount of surviving data, which is
+// roughly the survival rate times the semi-space size. Pick the size whose
+// predicted pause matches the target, moving at most one growth step up or
+// halving down per scavenge so a single outlier cannot swing the size.
+intptr_t Scavenger::PauseTargetSizeInWords(intptr_t old_size_in_words) const {
+  intptr_t history_before = 0;
+  intptr_t history_survived = 0;
+  int64_t history_micros = 0;
+  for (intptr_t i = 0; i < stats_history_.Size(); i++) {
+    const ScavengeStats& stats = stats_history_.Get(i);
+    history_before += stats.UsedBeforeInWords();
+    history_survived += stats.SurvivedInWords();
+    history_micros += stats.DurationMicros();
+  }
+  if ((history_before == 0) || (history_survived == 0)) {
+    // Nothing survives: any size meets the target, so keep growing to make
+    // scavenges rarer.
+    return Utils::Minimum(max_semi_capacity_in_words_,
+                          old_size_in_words * FLAG_new_gen_growth_factor);
+  }
+  if (history_micros == 0) {
+    history_micros = 1;
+  }
+  const double survival_rate =
+      static_cast<double>(history_survived) / history_before;
+  const double survived_words_per_micro =
+      static_cast<double>(history_survived) / history_micros;
+  const double target_words = FLAG_new_gen_pause_target_micros *
+                              survived_words_per_micro / survival_rate;
+
+  intptr_t new_size_in_words;
+  if (target_words >= static_cast<double>(max_semi_capacity_in_words_)) {
+    new_size_in_words = max_semi_capacity_in_words_;
+  } else {
+    new_size_in_words = static_cast<intptr_t>(target_words);
+  }
+  new_size_in_words = Utils::Minimum(
+      new_size_in_words, old_size_in_words * FLAG_new_gen_growth_factor);
+  new_size_in_words = Utils::Maximum(new_size_in_words, old_size_in_words / 2);
+  new_size_in_words =
+      Utils::RoundUp(new_size_in_words, kNewPageSizeInWords);
+  const intptr_t min_size_in_words = Utils::Minimum(
+      max_semi_capacity_in_words_, FLAG_new_gen_semi_initial_size * MBInWords);
+  return Utils::Maximum(
+      min_size_in_words,
+      Utils::Minimum(max_semi_capacity_in_words_, new_size_in_words));
+}
+
 class CollectStoreBufferVisitor : public ObjectPointerVisitor {
  public:
   explicit CollectStoreBufferVisitor(ObjectSet* in_store_buffer)
@@ -962,7 +1238,12 @@ void Scavenger::Epilogue(SemiSpace* from) {
     OS::PrintErr(" done.\n");
   }
 
-  delete from;
+  // The thread pool drains queued tasks before shutting down, so a pending
+  // release always finishes before SemiSpace::Cleanup empties the page cache.
+  if (!FLAG_concurrent_from_space_release ||
+      !Dart::thread_pool()->Run<SemiSpaceReleaseTask>(from)) {
+    delete from;
+  }
   UpdateMaxHeapUsage();
   if (heap_ != NULL) {
     heap_->UpdateGlobalMaxUsed();
@@ -1039,8 +1320,6 @@ void Scavenger::IterateStoreBuffers(ScavengerVisitorBase<parallel>* visitor) {
   visitor->VisitingOldObject(nullptr);
 
   heap_->RecordData(kStoreBufferEntries, total_count);
-  heap_->RecordData(kDataUnused1, 0);
-  heap_->RecordData(kDataUnused2, 0);
 }
 
 template <bool parallel>
@@ -1074,6 +1353,7 @@ void Scavenger::IterateRoots(ScavengerVisitorBase<parallel>* visitor) {
       return;  // No more slices.
     }
 
+    const int64_t start = OS::GetCurrentMonotonicMicros();
     switch (slice) {
       case kIsolate:
         IterateIsolateRoots(visitor);
@@ -1090,6 +1370,12 @@ void Scavenger::IterateRoots(ScavengerVisitorBase<parallel>* visitor) {
       default:
         UNREACHABLE();
     }
+    const int64_t micros = OS::GetCurrentMonotonicMicros() - start;
+    if (slice == kStoreBuffer) {
+      store_buffer_micros_.fetch_add(micros);
+    } else {
+      roots_micros_.fetch_add(micros);
+    }
   }
 }
 
@@ -1116,8 +1402,31 @@ bool Scavenger::IsUnreachable(ObjectPtr* p) {
 void Scavenger::MournWeakHandles() {
   Thread* thread = Thread::Current();
   TIMELINE_FUNCTION_GC_DURATION(thread, "MournWeakHandles");
-  ScavengerWeakVisitor weak_visitor(thread, this);
-  heap_->isolate_group()->VisitWeakPersistentHandles(&weak_visitor);
+  IsolateGroup* isolate_group = heap_->isolate_group();
+  const intptr_t num_tasks = FLAG_scavenger_tasks;
+  if (num_tasks <= 1) {
+    ScavengerWeakVisitor weak_visitor(thread, this, /*parallel=*/false);
+    isolate_group->VisitWeakPersistentHandles(&weak_visitor);
+  } else {
+    {
+      ThreadBarrier barrier(num_tasks, heap_->barrier(), heap_->barrier_done());
+      for (intptr_t i = 0; i < num_tasks; i++) {
+        if (i < (num_tasks - 1)) {
+          bool result = Dart::thread_pool()->Run<MournWeakHandlesTask>(
+              isolate_group, this, &barrier, i, num_tasks);
+          ASSERT(result);
+        } else {
+          MournWeakHandlesTask task(isolate_group, this, &barrier, i,
+                                    num_tasks);
+          task.RunEnteredIsolateGroup();
+          barrier.Exit();
+        }
+      }
+    }
+    // Finalizers that were not deferred run one at a time on this thread.
+    isolate_group->api_state()->RunPendingFinalizations(isolate_group);
+  }
+  isolate_group->api_state()->ScheduleDeferredFinalizers();
 }
 
 template <bool parallel>
@@ -1125,6 +1434,12 @@ void ScavengerVisitorBase<parallel>::ProcessToSpace() {
   while (scan_ != nullptr) {
     uword resolved_top = scan_->resolved_top_;
     while (resolved_top < scan_->top_) {
+      if (parallel && ShouldDonate()) {
+        // Let idle workers help with a large object graph that is being
+        // copied into this worker's to-space pages.
+        resolved_top = DonateToSpace(resolved_top, scan_->top_);
+        continue;
+      }
       ObjectPtr raw_obj = ObjectLayout::FromAddr(resolved_top);
       resolved_top += ProcessCopied(raw_obj);
     }
@@ -1142,22 +1457,30 @@ void ScavengerVisitorBase<parallel>::ProcessToSpace() {
 template <bool parallel>
 void ScavengerVisitorBase<parallel>::ProcessPromotedList() {
   ObjectPtr raw_object;
-  while ((raw_object = promoted_list_.Pop()) != nullptr) {
-    // Resolve or copy all objects referred to by the current object. This
-    // can potentially push more objects on this stack as well as add more
-    // objects to be resolved in the to space.
-    ASSERT(!raw_object->ptr()->IsRemembered());
-    VisitingOldObject(raw_object);
-    raw_object->ptr()->VisitPointersNonvirtual(this);
-    if (raw_object->ptr()->IsMarked()) {
-      // Complete our promise from ScavengePointer. Note that marker cannot
-      // visit this object until it pops a block from the mark stack, which
-      // involves a memory fence from the mutex, so even on architectures
-      // with a relaxed memory model, the marker will see the fully
-      // forwarded contents of this object.
-      thread_->MarkingStackAddObject(raw_object);
+  do {
+    while ((raw_object = promoted_list_.Pop()) != nullptr) {
+      if (parallel && raw_object->IsNewObject()) {
+        // A to-space object donated by DonateToSpace.
+        VisitingOldObject(nullptr);
+        ProcessCopied(raw_object);
+        continue;
+      }
+      // Resolve or copy all objects referred to by the current object. This
+      // can potentially push more objects on this stack as well as add more
+      // objects to be resolved in the to space.
+      ASSERT(!raw_object->ptr()->IsRemembered());
+      VisitingOldObject(raw_object);
+      raw_object->ptr()->VisitPointersNonvirtual(this);
+      if (raw_object->ptr()->IsMarked()) {
+        // Complete our promise from ScavengePointer. Note that marker cannot
+        // visit this object until it pops a block from the mark stack, which
+        // involves a memory fence from the mutex, so even on architectures
+        // with a relaxed memory model, the marker will see the fully
+        // forwarded contents of this object.
+        thread_->MarkingStackAddObject(raw_object);
+      }
     }
-  }
+  } while (parallel && TrySteal());
   VisitingOldObject(NULL);
 }
 
@@ -1386,6 +1709,12 @@ void Scavenger::TryAllocateNewTLAB(Thread* thread, intptr_t min_size) {
   ASSERT(heap_ != Dart::vm_isolate()->heap());
   ASSERT(!scavenging_);
 
+  if ((thread->top() != 0) &&
+      HeapSampler::HandleSamplingPoint(
+          thread, min_size, NewPage::Of(thread->top() - 1)->end())) {
+    return;
+  }
+
   AbandonRemainingTLAB(thread);
 
   MutexLocker ml(&space_lock_);
@@ -1394,6 +1723,7 @@ void Scavenger::TryAllocateNewTLAB(Thread* thread, intptr_t min_size) {
     intptr_t available = page->end() - page->object_end();
     if (available >= min_size) {
       page->Acquire(thread);
+      HeapSampler::ArmTLAB(thread);
       return;
     }
   }
@@ -1403,6 +1733,16 @@ void Scavenger::TryAllocateNewTLAB(Thread* thread, intptr_t min_size) {
     return;
   }
   page->Acquire(thread);
+  HeapSampler::ArmTLAB(thread);
+}
+
+bool Scavenger::TryReserveTLAB(Thread* thread, intptr_t size) {
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+  if (static_cast<intptr_t>(thread->end() - thread->top()) >= size) {
+    return true;
+  }
+  TryAllocateNewTLAB(thread, size);
+  return static_cast<intptr_t>(thread->end() - thread->top()) >= size;
 }
 
 void Scavenger::AbandonRemainingTLABForDebugging(Thread* thread) {
@@ -1420,6 +1760,7 @@ void Scavenger::AbandonRemainingTLABForDebugging(Thread* thread) {
 
 void Scavenger::AbandonRemainingTLAB(Thread* thread) {
   if (thread->top() == 0) return;
+  HeapSampler::DisarmTLAB(thread);
   NewPage* page = NewPage::Of(thread->top() - 1);
   {
     MutexLocker ml(&space_lock_);
@@ -1479,6 +1820,8 @@ void Scavenger::Scavenge() {
   failed_to_promote_ = false;
   abort_ = false;
   root_slices_started_ = 0;
+  roots_micros_ = 0;
+  store_buffer_micros_ = 0;
   intptr_t abandoned_bytes = 0;  // TODO(rmacnak): Count fragmentation?
   SpaceUsage usage_before = GetCurrentUsage();
   intptr_t promo_candidate_words = 0;
@@ -1490,13 +1833,23 @@ void Scavenger::Scavenge() {
     promo_candidate_words += page->promo_candidate_words();
   }
   SemiSpace* from = Prologue();
+  heap_->old_space()->SnapshotRememberedCardPages();
 
+  num_worker_stats_ = 0;
   intptr_t bytes_promoted;
+  const int64_t copy_start = OS::GetCurrentMonotonicMicros();
   if (FLAG_scavenger_tasks == 0) {
     bytes_promoted = SerialScavenge(from);
   } else {
     bytes_promoted = ParallelScavenge(from);
   }
+  heap_->RecordTime(kProcessToSpace,
+                    OS::GetCurrentMonotonicMicros() - copy_start);
+  heap_->RecordTime(kVisitIsolateRoots, roots_micros_);
+  heap_->RecordTime(kIterateStoreBuffers, store_buffer_micros_);
+  if (FLAG_pretenure) {
+    pretenuring_.EndScavenge(abort_);
+  }
   if (abort_) {
     ReverseScavenge(&from);
     bytes_promoted = 0;
@@ -1506,17 +1859,29 @@ void Scavenger::Scavenge() {
     heap_->assume_scavenge_will_fail_ = true;
   }
   ASSERT(promotion_stack_.IsEmpty());
+  const int64_t weak_start = OS::GetCurrentMonotonicMicros();
   MournWeakHandles();
   MournWeakTables();
+  heap_->RecordTime(kIterateWeaks,
+                    OS::GetCurrentMonotonicMicros() - weak_start);
 
   // Restore write-barrier assumptions.
   heap_->isolate_group()->RememberLiveTemporaries();
 
   // Scavenge finished. Run accounting.
   int64_t end = OS::GetCurrentMonotonicMicros();
-  stats_history_.Add(ScavengeStats(
-      start, end, usage_before, GetCurrentUsage(), promo_candidate_words,
-      bytes_promoted >> kWordSizeLog2, abandoned_bytes >> kWordSizeLog2));
+  ScavengeStats stats(start, end, usage_before, GetCurrentUsage(),
+                      promo_candidate_words, bytes_promoted >> kWordSizeLog2,
+                      abandoned_bytes >> kWordSizeLog2);
+  for (intptr_t i = 0; i < num_worker_stats_; i++) {
+    stats.AddWorker(worker_stats_[i]);
+  }
+  stats_history_.Add(stats);
+  heap_->RecordData(kBytesCopied, stats.CopiedInWords() * kWordSize);
+  heap_->RecordData(kBytesPromoted, bytes_promoted);
+  if (FLAG_trace_scavenger_workers) {
+    stats.PrintWorkers();
+  }
   Epilogue(from);
 
   if (FLAG_verify_after_gc) {
@@ -1543,6 +1908,7 @@ intptr_t Scavenger::SerialScavenge(SemiSpace* from) {
   visitor.Finalize();
 
   to_->AddList(visitor.head(), visitor.tail());
+  pretenuring_.AddPromoted(visitor.promoted_by_cid());
   return visitor.bytes_promoted();
 }
 
@@ -1554,12 +1920,16 @@ intptr_t Scavenger::ParallelScavenge(SemiSpace* from) {
   ThreadBarrier barrier(num_tasks, heap_->barrier(), heap_->barrier_done());
   RelaxedAtomic<uintptr_t> num_busy = num_tasks;
 
+  // One work deque per worker. Idle workers steal from the others.
+  PromotionStack* worker_stacks = new PromotionStack[num_tasks];
+
   ParallelScavengerVisitor** visitors =
       new ParallelScavengerVisitor*[num_tasks];
   for (intptr_t i = 0; i < num_tasks; i++) {
     FreeList* freelist = heap_->old_space()->DataFreeList(i);
     visitors[i] = new ParallelScavengerVisitor(
-        heap_->isolate_group(), this, from, freelist, &promotion_stack_);
+        heap_->isolate_group(), this, from, freelist, &worker_stacks[i],
+        worker_stacks, num_tasks, i, &num_busy);
     if (i < (num_tasks - 1)) {
       // Begin scavenging on a helper thread.
       bool result = Dart::thread_pool()->Run<ParallelScavengerTask>(
@@ -1577,13 +1947,32 @@ intptr_t Scavenger::ParallelScavenge(SemiSpace* from) {
   for (intptr_t i = 0; i < num_tasks; i++) {
     to_->AddList(visitors[i]->head(), visitors[i]->tail());
     bytes_promoted += visitors[i]->bytes_promoted();
+    pretenuring_.AddPromoted(visitors[i]->promoted_by_cid());
+    if (num_worker_stats_ < ScavengeStats::kMaxRecordedWorkers) {
+      worker_stats_[num_worker_stats_++] = visitors[i]->worker_stats();
+    }
     delete visitors[i];
   }
 
   delete[] visitors;
+  // Any work left behind by an aborted scavenge is discarded here.
+  delete[] worker_stacks;
   return bytes_promoted;
 }
 
+void ScavengeStats::PrintWorkers() const {
+  for (intptr_t i = 0; i < num_workers_; i++) {
+    const ScavengeWorkerStats& w = workers_[i];
+    OS::PrintErr("[ scavenge worker %" Pd ": busy %.3f ms, idle %.3f ms, "
+                 "copied %" Pd " kB, promoted %" Pd " kB, stolen %" Pd
+                 " blocks, donated %" Pd " objects ]\n",
+                 i, MicrosecondsToMilliseconds(w.busy_micros),
+                 MicrosecondsToMilliseconds(w.idle_micros),
+                 w.bytes_copied / KB, w.bytes_promoted / KB, w.blocks_stolen,
+                 w.objects_donated);
+  }
+}
+
 void Scavenger::ReverseScavenge(SemiSpace** from) {
   Thread* thread = Thread::Current();
   TIMELINE_FUNCTION_GC_DURATION(thread, "ReverseScavenge");
@@ -1613,6 +2002,10 @@ void Scavenger::ReverseScavenge(SemiSpace** from) {
         from_header = ObjectLayout::NewBit::update(true, from_header);
         from_header =
             ObjectLayout::OldAndNotMarkedBit::update(false, from_header);
+        // Promoted large arrays are card remembered, and a set card bit would
+        // read as a forwarding header.
+        from_header =
+            ObjectLayout::CardRememberedBit::update(false, from_header);
 
         WriteHeader(from_obj, from_header);
 
@@ -1685,6 +2078,7 @@ void Scavenger::PrintToJSONObject(JSONObject* object) const {
   space.AddProperty64("used", UsedInWords() * kWordSize);
   space.AddProperty64("capacity", CapacityInWords() * kWordSize);
   space.AddProperty64("external", ExternalInWords() * kWordSize);
+  heap_->PrintExternalToJSONObject(Heap::kNew, &space);
   space.AddProperty("time", MicrosecondsToSeconds(gc_time_micros()));
 }
 #endif  // !PRODUCT
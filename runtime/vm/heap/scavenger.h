@@ -11,6 +11,7 @@
 #include "vm/dart.h"
 #include "vm/flags.h"
 #include "vm/globals.h"
+#include "vm/heap/pretenuring.h"
 #include "vm/heap/spaces.h"
 #include "vm/lockers.h"
 #include "vm/raw_object.h"
@@ -196,9 +197,26 @@ class SemiSpace {
   NewPage* tail_ = nullptr;
 };
 
+// Statistics for one worker of a particular parallel scavenge.
+struct ScavengeWorkerStats {
+  // Time spent scavenging, excluding time spent waiting for other workers.
+  int64_t busy_micros = 0;
+  // Time spent waiting for work to appear or at barriers.
+  int64_t idle_micros = 0;
+  intptr_t bytes_copied = 0;
+  intptr_t bytes_promoted = 0;
+  // Number of work blocks taken from other workers' deques.
+  intptr_t blocks_stolen = 0;
+  // Number of to-space objects handed out to idle workers.
+  intptr_t objects_donated = 0;
+};
+
 // Statistics for a particular scavenge.
 class ScavengeStats {
  public:
+  // Only the first workers of a parallel scavenge are recorded.
+  static constexpr intptr_t kMaxRecordedWorkers = 16;
+
   ScavengeStats() {}
   ScavengeStats(int64_t start_micros,
                 int64_t end_micros,
@@ -235,8 +253,31 @@ class ScavengeStats {
 
   intptr_t UsedBeforeInWords() const { return before_.used_in_words; }
 
+  // Words copied within new space or promoted, i.e. the live data this
+  // scavenge had to move.
+  intptr_t SurvivedInWords() const {
+    return after_.used_in_words + promoted_in_words_;
+  }
+
+  // Words copied within new space.
+  intptr_t CopiedInWords() const { return after_.used_in_words; }
+
   int64_t DurationMicros() const { return end_micros_ - start_micros_; }
 
+  // Number of recorded workers; zero for a serial scavenge.
+  intptr_t num_workers() const { return num_workers_; }
+  const ScavengeWorkerStats& worker(intptr_t i) const {
+    ASSERT((i >= 0) && (i < num_workers_));
+    return workers_[i];
+  }
+  void AddWorker(const ScavengeWorkerStats& worker) {
+    if (num_workers_ < kMaxRecordedWorkers) {
+      workers_[num_workers_++] = worker;
+    }
+  }
+
+  void PrintWorkers() const;
+
  private:
   int64_t start_micros_;
   int64_t end_micros_;
@@ -245,6 +286,8 @@ class ScavengeStats {
   intptr_t promo_candidates_in_words_;
   intptr_t promoted_in_words_;
   intptr_t abandoned_in_words_;
+  intptr_t num_workers_ = 0;
+  ScavengeWorkerStats workers_[kMaxRecordedWorkers];
 };
 
 class Scavenger {
@@ -271,6 +314,9 @@ class Scavenger {
     TryAllocateNewTLAB(thread, size);
     return TryAllocateFromTLAB(thread, size);
   }
+  // Makes sure the thread's TLAB has at least size bytes left, taking a new
+  // TLAB if needed. Does not collect garbage. Returns false on failure.
+  bool TryReserveTLAB(Thread* thread, intptr_t size);
   void AbandonRemainingTLAB(Thread* thread);
   void AbandonRemainingTLABForDebugging(Thread* thread);
 
@@ -311,6 +357,9 @@ class Scavenger {
 
   intptr_t collections() const { return collections_; }
 
+  // Statistics of the most recent scavenge. Requires collections() > 0.
+  const ScavengeStats& last_stats() const { return stats_history_.Get(0); }
+
 #ifndef PRODUCT
   void PrintToJSONObject(JSONObject* object) const;
 #endif  // !PRODUCT
@@ -341,6 +390,13 @@ class Scavenger {
 
   bool scavenging() const { return scavenging_; }
 
+  // Whether instances of cid should be allocated in old space because the
+  // recent scavenges kept promoting them.
+  bool ShouldPretenure(intptr_t cid) const {
+    return pretenuring_.ShouldPretenure(cid);
+  }
+  PretenuringFeedback* pretenuring() { return &pretenuring_; }
+
   // The maximum number of Dart mutator threads we allow to execute at the same
   // time.
   static intptr_t MaxMutatorThreadCount() {
@@ -354,7 +410,6 @@ class Scavenger {
 
   NewPage* head() const { return to_->head(); }
 
- private:
   // Ids for time and data records in Heap::GCStats.
   enum {
     // Time
@@ -366,11 +421,13 @@ class Scavenger {
     kIterateWeaks = 5,
     // Data
     kStoreBufferEntries = 0,
-    kDataUnused1 = 1,
-    kDataUnused2 = 2,
+    kBytesCopied = 1,
+    kBytesPromoted = 2,
     kToKBAfterStoreBuffer = 3
   };
 
+ private:
+
   uword TryAllocateFromTLAB(Thread* thread, intptr_t size) {
     ASSERT(Utils::IsAligned(size, kObjectAlignment));
     ASSERT(heap_ != Dart::vm_isolate()->heap());
@@ -413,6 +470,7 @@ class Scavenger {
   void MournWeakTables();
 
   intptr_t NewSizeInWords(intptr_t old_size_in_words) const;
+  intptr_t PauseTargetSizeInWords(intptr_t old_size_in_words) const;
 
   Heap* heap_;
 
@@ -426,6 +484,9 @@ class Scavenger {
   bool scavenging_;
   bool early_tenure_ = false;
   RelaxedAtomic<intptr_t> root_slices_started_;
+  // Time the workers of the current scavenge spent on the root slices.
+  RelaxedAtomic<int64_t> roots_micros_;
+  RelaxedAtomic<int64_t> store_buffer_micros_;
   StoreBufferBlock* blocks_ = nullptr;
 
   int64_t gc_time_micros_;
@@ -433,6 +494,10 @@ class Scavenger {
   static const int kStatsHistoryCapacity = 4;
   RingBuffer<ScavengeStats, kStatsHistoryCapacity> stats_history_;
 
+  // Per-worker statistics of the current parallel scavenge.
+  ScavengeWorkerStats worker_stats_[ScavengeStats::kMaxRecordedWorkers];
+  intptr_t num_worker_stats_ = 0;
+
   intptr_t scavenge_words_per_micro_;
   intptr_t idle_scavenge_threshold_in_words_;
 
@@ -442,6 +507,8 @@ class Scavenger {
   RelaxedAtomic<bool> failed_to_promote_;
   RelaxedAtomic<bool> abort_;
 
+  PretenuringFeedback pretenuring_;
+
   bool growth_control_;
 
   // Protects new space during the allocation of new TLABs
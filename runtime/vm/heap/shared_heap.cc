@@ -0,0 +1,209 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/heap/shared_heap.h"
+
+#include "platform/utils.h"
+#include "vm/dart.h"
+#include "vm/heap/heap.h"
+#include "vm/heap/pages.h"
+#include "vm/heap/weak_table.h"
+#include "vm/isolate.h"
+#include "vm/lockers.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/raw_object.h"
+#include "vm/thread.h"
+
+namespace dart {
+
+Mutex* SharedHeap::mutex_ = nullptr;
+MallocGrowableArray<SharedHeap::Entry>* SharedHeap::entries_ = nullptr;
+#if defined(HASH_IN_OBJECT_HEADER)
+uint32_t SharedHeap::hash_counter_ = 7919;
+#endif
+
+void SharedHeap::Init() {
+  ASSERT(mutex_ == nullptr);
+  mutex_ = new Mutex();
+  entries_ = new MallocGrowableArray<Entry>();
+}
+
+void SharedHeap::Cleanup() {
+  for (intptr_t i = 0; i < entries_->length(); i++) {
+    free(entries_->At(i).name);
+  }
+  delete entries_;
+  entries_ = nullptr;
+  delete mutex_;
+  mutex_ = nullptr;
+}
+
+static bool IsSharedObject(ObjectPtr object) {
+  return !object->IsHeapObject() || object->ptr()->InVMIsolateHeap();
+}
+
+bool SharedHeap::IsShareable(Thread* thread,
+                             ObjectPtr object,
+                             const char** error) {
+  switch (object->GetClassId()) {
+    case kOneByteStringCid:
+    case kTwoByteStringCid:
+    case kMintCid:
+    case kDoubleCid:
+      return true;
+    case kArrayCid:
+    case kImmutableArrayCid:
+      if (Array::RawCast(object)->ptr()->type_arguments() !=
+          TypeArguments::null()) {
+        *error = "Cannot share a list with type arguments";
+        return false;
+      }
+      return true;
+    default:
+      *error = OS::SCreate(thread->zone(), "Cannot share an instance of %s",
+                           Object::Handle(thread->zone(), object).ToCString());
+      return false;
+  }
+}
+
+#if defined(HASH_IN_OBJECT_HEADER)
+uint32_t SharedHeap::NextIdentityHash() {
+  ASSERT(mutex_->IsOwnedByCurrentThread());
+  // Same scheme as the identity hashes given to the VM isolate's objects.
+  hash_counter_ += 2011;
+  hash_counter_ &= 0x3fffffff;
+  if (hash_counter_ == 0) hash_counter_++;
+  return hash_counter_;
+}
+#endif
+
+ObjectPtr SharedHeap::Copy(Thread* thread,
+                           const Object& root,
+                           const char** error) {
+  ASSERT(error != nullptr);
+  if (IsSharedObject(root.raw())) {
+    return root.raw();
+  }
+
+  // Objects are moved into the VM isolate without moving their referents, so
+  // the graph must not change until every reference has been forwarded.
+  NoSafepointScope no_safepoint;
+  MutexLocker ml(mutex_);
+
+  // Find the objects to copy. The forwarding table maps each of them to its
+  // index in objects, plus one because zero means absent.
+  WeakTable forwarding;
+  MallocGrowableArray<ObjectPtr> objects;
+  MallocGrowableArray<ObjectPtr> worklist;
+  worklist.Add(root.raw());
+  while (!worklist.is_empty()) {
+    ObjectPtr object = worklist.RemoveLast();
+    if (IsSharedObject(object) ||
+        (forwarding.GetValueExclusive(object) != WeakTable::kNoValue)) {
+      continue;
+    }
+    if (!IsShareable(thread, object, error)) {
+      return Object::null();
+    }
+    objects.Add(object);
+    forwarding.SetValueExclusive(object, objects.length());
+    if (object->IsArray() || object->IsImmutableArray()) {
+      ArrayPtr array = Array::RawCast(object);
+      const intptr_t length = Array::LengthOf(array);
+      for (intptr_t i = 0; i < length; i++) {
+        worklist.Add(Array::DataOf(array)[i]);
+      }
+    }
+  }
+
+  WritableVMIsolateScope writable(thread);
+  PageSpace* space = Dart::vm_isolate()->heap()->old_space();
+  MallocGrowableArray<ObjectPtr> copies(objects.length());
+  for (intptr_t i = 0; i < objects.length(); i++) {
+    ObjectPtr object = objects[i];
+    const intptr_t size = object->ptr()->HeapSize();
+    const uword addr =
+        space->TryAllocate(size, OldPage::kData, PageSpace::kForceGrowth);
+    if (addr == 0) {
+      // Give back what was allocated. Free list elements are never marked,
+      // so the VM isolate's pages stay consistent.
+      for (intptr_t j = 0; j < copies.length(); j++) {
+        FreeListElement::AsElement(ObjectLayout::ToAddr(copies[j]),
+                                   copies[j]->ptr()->HeapSize());
+      }
+      *error = "Out of memory copying into the shared heap";
+      return Object::null();
+    }
+    memmove(reinterpret_cast<void*>(addr),
+            reinterpret_cast<void*>(ObjectLayout::ToAddr(object)), size);
+    copies.Add(ObjectLayout::FromAddr(addr));
+  }
+
+  for (intptr_t i = 0; i < copies.length(); i++) {
+    ObjectPtr copy = copies[i];
+    // Make the copy look like the other objects of the VM isolate: old,
+    // marked and never remembered.
+    uword tags = copy->ptr()->tags_;
+    intptr_t cid = ObjectLayout::ClassIdTag::decode(tags);
+    if (cid == kArrayCid) {
+      cid = kImmutableArrayCid;
+      tags = ObjectLayout::ClassIdTag::update(cid, tags);
+    }
+    tags = ObjectLayout::OldBit::update(true, tags);
+    tags = ObjectLayout::NewBit::update(false, tags);
+    tags = ObjectLayout::OldAndNotMarkedBit::update(false, tags);
+    tags = ObjectLayout::OldAndNotRememberedBit::update(true, tags);
+    tags = ObjectLayout::CardRememberedBit::update(false, tags);
+    copy->ptr()->tags_ = tags;
+
+    if (cid == kImmutableArrayCid) {
+      ArrayPtr array = Array::RawCast(copy);
+      ObjectPtr* data = Array::DataOf(array);
+      const intptr_t length = Array::LengthOf(array);
+      for (intptr_t j = 0; j < length; j++) {
+        if (!IsSharedObject(data[j])) {
+          const intptr_t index = forwarding.GetValueExclusive(data[j]) - 1;
+          ASSERT(index >= 0);
+          data[j] = copies[index];
+        }
+      }
+    }
+
+    Object::FinalizeReadOnlyObject(copy);
+#if defined(HASH_IN_OBJECT_HEADER)
+    // The VM isolate is read-only, so identity hashes cannot be added later.
+    if ((cid == kImmutableArrayCid) && (Object::GetCachedHash(copy) == 0)) {
+      Object::SetCachedHash(copy, NextIdentityHash());
+    }
+#endif
+  }
+
+  return copies[0];
+}
+
+bool SharedHeap::Publish(const char* name, ObjectPtr object) {
+  ASSERT(IsSharedObject(object));
+  MutexLocker ml(mutex_);
+  for (intptr_t i = 0; i < entries_->length(); i++) {
+    if (strcmp(entries_->At(i).name, name) == 0) {
+      return false;
+    }
+  }
+  Entry entry = {Utils::StrDup(name), object};
+  entries_->Add(entry);
+  return true;
+}
+
+ObjectPtr SharedHeap::Lookup(const char* name) {
+  MutexLocker ml(mutex_);
+  for (intptr_t i = 0; i < entries_->length(); i++) {
+    if (strcmp(entries_->At(i).name, name) == 0) {
+      return entries_->At(i).object;
+    }
+  }
+  return Object::null();
+}
+
+}  // namespace dart
@@ -0,0 +1,65 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_SHARED_HEAP_H_
+#define RUNTIME_VM_HEAP_SHARED_HEAP_H_
+
+#include "platform/growable_array.h"
+#include "vm/allocation.h"
+#include "vm/globals.h"
+#include "vm/tagged_pointer.h"
+
+namespace dart {
+
+class Mutex;
+class Object;
+class Thread;
+
+// Holds deeply immutable object graphs that all isolate groups can read
+// without copying.
+//
+// A graph is copied once into the old space of the VM isolate. The copies are
+// pre-marked like the other VM isolate objects, so the collectors of the
+// isolate groups treat them as roots they never need to visit. References to
+// them are serialized by value in messages (see SnapshotWriter).
+//
+// Only objects whose classes are shared by all isolate groups can be copied:
+// null, booleans, numbers, strings and lists of those. Lists become immutable
+// and must not have type arguments. The VM isolate is never collected, so
+// shared graphs live until the VM shuts down.
+class SharedHeap : public AllStatic {
+ public:
+  static void Init();
+  static void Cleanup();
+
+  // Returns the shared copy of the graph reachable from root, or null with
+  // error set to a zone allocated message if the graph cannot be shared.
+  static ObjectPtr Copy(Thread* thread, const Object& root, const char** error);
+
+  // Publishes a shared object under name. Returns false if the name is taken.
+  static bool Publish(const char* name, ObjectPtr object);
+
+  // Returns the object published under name, or null.
+  static ObjectPtr Lookup(const char* name);
+
+ private:
+  struct Entry {
+    char* name;
+    ObjectPtr object;
+  };
+
+  static bool IsShareable(Thread* thread, ObjectPtr object, const char** error);
+
+#if defined(HASH_IN_OBJECT_HEADER)
+  static uint32_t NextIdentityHash();
+  static uint32_t hash_counter_;
+#endif
+
+  static Mutex* mutex_;
+  static MallocGrowableArray<Entry>* entries_;
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_SHARED_HEAP_H_
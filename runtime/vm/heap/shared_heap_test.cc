@@ -0,0 +1,75 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "platform/assert.h"
+#include "vm/globals.h"
+#include "vm/heap/heap.h"
+#include "vm/heap/shared_heap.h"
+#include "vm/object.h"
+#include "vm/symbols.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+ISOLATE_UNIT_TEST_CASE(SharedHeap_CopyList) {
+  const Array& inner = Array::Handle(Array::New(2));
+  inner.SetAt(0, String::Handle(String::New("inner")));
+  inner.SetAt(1, Double::Handle(Double::New(1.5)));
+  const Array& list = Array::Handle(Array::New(5));
+  list.SetAt(0, String::Handle(String::New("shared")));
+  list.SetAt(1, Smi::Handle(Smi::New(42)));
+  list.SetAt(2, Integer::Handle(Integer::New(kMaxInt64)));
+  list.SetAt(3, inner);
+  list.SetAt(4, inner);
+
+  const char* error = nullptr;
+  const Object& copy = Object::Handle(SharedHeap::Copy(thread, list, &error));
+  EXPECT(error == nullptr);
+  EXPECT(copy.IsArray() && Array::Cast(copy).IsImmutable());
+  EXPECT(copy.raw()->ptr()->InVMIsolateHeap());
+
+  const Array& shared = Array::Cast(copy);
+  EXPECT_EQ(5, shared.Length());
+  EXPECT_STREQ("shared",
+               String::Cast(Object::Handle(shared.At(0))).ToCString());
+  EXPECT_EQ(42, Smi::Value(Smi::RawCast(shared.At(1))));
+  EXPECT_EQ(kMaxInt64,
+            Integer::Cast(Object::Handle(shared.At(2))).AsInt64Value());
+  // Shared structure is preserved.
+  EXPECT_EQ(shared.At(3), shared.At(4));
+  const Array& shared_inner = Array::Handle(Array::RawCast(shared.At(3)));
+  EXPECT(shared_inner.IsImmutable());
+  EXPECT(shared_inner.raw()->ptr()->InVMIsolateHeap());
+  EXPECT_EQ(1.5, Double::Cast(Object::Handle(shared_inner.At(1))).value());
+
+  // The original is untouched and the copy survives collections.
+  EXPECT(!list.IsImmutable());
+  GCTestHelper::CollectAllGarbage();
+  EXPECT_STREQ("inner",
+               String::Cast(Object::Handle(shared_inner.At(0))).ToCString());
+
+  EXPECT(SharedHeap::Publish("SharedHeap_CopyList", copy.raw()));
+  EXPECT(!SharedHeap::Publish("SharedHeap_CopyList", copy.raw()));
+  EXPECT_EQ(copy.raw(), SharedHeap::Lookup("SharedHeap_CopyList"));
+  EXPECT_EQ(Object::null(), SharedHeap::Lookup("SharedHeap_Missing"));
+}
+
+ISOLATE_UNIT_TEST_CASE(SharedHeap_RejectsMutableClasses) {
+  const Array& list = Array::Handle(Array::New(2));
+  list.SetAt(0, String::Handle(String::New("ok")));
+  list.SetAt(1, GrowableObjectArray::Handle(GrowableObjectArray::New()));
+
+  const char* error = nullptr;
+  const Object& copy = Object::Handle(SharedHeap::Copy(thread, list, &error));
+  EXPECT(copy.IsNull());
+  EXPECT(error != nullptr);
+
+  // Objects already shared are returned as is.
+  error = nullptr;
+  EXPECT_EQ(Symbols::Empty().raw(),
+            SharedHeap::Copy(thread, Symbols::Empty(), &error));
+  EXPECT(error == nullptr);
+}
+
+}  // namespace dart
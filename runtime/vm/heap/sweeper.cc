@@ -106,6 +106,142 @@ intptr_t GCSweeper::SweepLargePage(OldPage* page) {
   return words_to_end;
 }
 
+SweepQueue::~SweepQueue() {
+  ASSERT(pages_ == nullptr);
+  ASSERT(in_use_ == nullptr);
+}
+
+void SweepQueue::Start(OldPage* first, OldPage* last) {
+  // Don't access last->next(), which would be a race with mutator allocating
+  // new pages.
+  intptr_t length = 1;
+  for (OldPage* page = first; page != last; page = page->next()) {
+    length++;
+  }
+  OldPage** pages = new OldPage*[length];
+  OldPage* page = first;
+  for (intptr_t i = 0; i < length - 1; i++) {
+    pages[i] = page;
+    page = page->next();
+  }
+  pages[length - 1] = page;
+  ASSERT(page == last);
+
+  MonitorLocker ml(&monitor_);
+  ASSERT(pages_ == nullptr);
+  pages_ = pages;
+  in_use_ = new bool[length];
+  length_ = length;
+  next_ = 0;
+  pending_ = 0;
+  unclaimed_ = length;
+}
+
+bool SweepQueue::SweepNext(PageSpace* old_space, FreeList* freelist) {
+  if (!HasUnclaimedPages()) {
+    return false;
+  }
+  intptr_t index;
+  {
+    MonitorLocker ml(&monitor_);
+    if (next_ >= length_) {
+      return false;
+    }
+    index = next_++;
+    pending_++;
+    unclaimed_ = length_ - next_;
+  }
+
+  OldPage* page = pages_[index];
+  ASSERT(page->type() == OldPage::kData);
+  if (freelist == nullptr) {
+    const intptr_t num_shards = Utils::Maximum(FLAG_scavenger_tasks, 1);
+    freelist = old_space->DataFreeList(index % num_shards);
+  }
+  GCSweeper sweeper;
+  in_use_[index] = sweeper.SweepPage(page, freelist, false);
+
+  {
+    MonitorLocker ml(&monitor_);
+    if (--pending_ == 0) {
+      ml.NotifyAll();
+    }
+  }
+  return true;
+}
+
+void SweepQueue::Finish(PageSpace* old_space) {
+  OldPage** pages;
+  bool* in_use;
+  intptr_t length;
+  {
+    MonitorLocker ml(&monitor_);
+    ASSERT(next_ == length_);
+    while (pending_ > 0) {
+      ml.Wait();
+    }
+    pages = pages_;
+    in_use = in_use_;
+    length = length_;
+    pages_ = nullptr;
+    in_use_ = nullptr;
+    length_ = next_ = 0;
+  }
+
+  // Empty pages are only unlinked here, in list order, so that each removal
+  // sees the correct previous page.
+  OldPage* prev_page = nullptr;
+  for (intptr_t i = 0; i < length; i++) {
+    if (in_use[i]) {
+      prev_page = pages[i];
+    } else {
+      old_space->FreePage(pages[i], prev_page);
+    }
+  }
+  delete[] pages;
+  delete[] in_use;
+}
+
+// Helps the concurrent sweeper task drain the sweep queue.
+class ParallelSweeperTask : public ThreadPool::Task {
+ public:
+  ParallelSweeperTask(IsolateGroup* isolate_group, PageSpace* old_space)
+      : task_isolate_group_(isolate_group), old_space_(old_space) {
+    MonitorLocker ml(old_space_->tasks_lock());
+    old_space_->set_tasks(old_space_->tasks() + 1);
+  }
+
+  virtual void Run() {
+    bool result = Thread::EnterIsolateGroupAsHelper(
+        task_isolate_group_, Thread::kSweeperTask, /*bypass_safepoint=*/true);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      ASSERT(thread->BypassSafepoints());  // Or we should be checking in.
+      TIMELINE_FUNCTION_GC_DURATION(thread, "ParallelSweep");
+      while (old_space_->sweep_queue()->SweepNext(old_space_, nullptr)) {
+        // Notify the mutator thread that we have added elements to the free
+        // list.
+        MonitorLocker ml(old_space_->tasks_lock());
+        ml.Notify();
+      }
+    }
+    // Exit isolate cleanly *before* notifying it, to avoid shutdown race.
+    Thread::ExitIsolateGroupAsHelper(/*bypass_safepoint=*/true);
+    {
+      MonitorLocker ml(old_space_->tasks_lock());
+      old_space_->set_tasks(old_space_->tasks() - 1);
+      ml.NotifyAll();
+    }
+  }
+
+ private:
+  IsolateGroup* task_isolate_group_;
+  PageSpace* old_space_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelSweeperTask);
+};
+
 class ConcurrentSweeperTask : public ThreadPool::Task {
  public:
   ConcurrentSweeperTask(IsolateGroup* isolate_group,
@@ -168,36 +304,20 @@ class ConcurrentSweeperTask : public ThreadPool::Task {
         ml.NotifyAll();
       }
 
-      intptr_t shard = 0;
-      const intptr_t num_shards = Utils::Maximum(FLAG_scavenger_tasks, 1);
-      page = first_;
-      prev_page = NULL;
-      while (page != NULL) {
-        OldPage* next_page;
-        if (page == last_) {
-          // Don't access page->next(), which would be a race with mutator
-          // allocating new pages.
-          next_page = NULL;
-        } else {
-          next_page = page->next();
-        }
-        ASSERT(page->type() == OldPage::kData);
-        shard = (shard + 1) % num_shards;
-        bool page_in_use =
-            sweeper.SweepPage(page, old_space_->DataFreeList(shard), false);
-        if (page_in_use) {
-          prev_page = page;
-        } else {
-          old_space_->FreePage(page, prev_page);
-        }
-        {
-          // Notify the mutator thread that we have added elements to the free
-          // list or that more capacity is available.
-          MonitorLocker ml(old_space_->tasks_lock());
-          ml.Notify();
-        }
-        page = next_page;
+      SweepQueue* queue = old_space_->sweep_queue();
+      queue->Start(first_, last_);
+      for (intptr_t i = 1; i < FLAG_sweeper_tasks; i++) {
+        bool result = Dart::thread_pool()->Run<ParallelSweeperTask>(
+            task_isolate_group_, old_space_);
+        ASSERT(result);
+      }
+      while (queue->SweepNext(old_space_, nullptr)) {
+        // Notify the mutator thread that we have added elements to the free
+        // list or that more capacity is available.
+        MonitorLocker ml(old_space_->tasks_lock());
+        ml.Notify();
       }
+      queue->Finish(old_space_);
     }
     // Exit isolate cleanly *before* notifying it, to avoid shutdown race.
     Thread::ExitIsolateGroupAsHelper(/*bypass_safepoint=*/true);
@@ -5,7 +5,9 @@
 #ifndef RUNTIME_VM_HEAP_SWEEPER_H_
 #define RUNTIME_VM_HEAP_SWEEPER_H_
 
+#include "platform/atomic.h"
 #include "vm/globals.h"
+#include "vm/os_thread.h"
 
 namespace dart {
 
@@ -43,6 +45,41 @@ class GCSweeper {
                               FreeList* freelist);
 };
 
+// Regular data pages left for concurrent sweeping. Sweeper tasks, and
+// allocating threads that miss in the freelist, claim pages in list order, so
+// freelist refill keeps pace with allocation rather than with heap size.
+class SweepQueue {
+ public:
+  SweepQueue() {}
+  ~SweepQueue();
+
+  // Publishes the regular data pages between first and last inclusive.
+  void Start(OldPage* first, OldPage* last);
+
+  // Claims and sweeps the next unswept page into freelist, or into a data
+  // freelist shard chosen by page if freelist is NULL. Returns false if no
+  // unclaimed pages remain.
+  bool SweepNext(PageSpace* old_space, FreeList* freelist);
+
+  // Cheap check without taking the lock; may be stale.
+  bool HasUnclaimedPages() const { return unclaimed_ > 0; }
+
+  // Waits until every claimed page has been swept, then releases the pages
+  // that were found empty. Must be called by the task that called Start.
+  void Finish(PageSpace* old_space);
+
+ private:
+  Monitor monitor_;
+  OldPage** pages_ = nullptr;
+  bool* in_use_ = nullptr;
+  intptr_t length_ = 0;
+  intptr_t next_ = 0;
+  intptr_t pending_ = 0;  // Claimed but not yet swept.
+  RelaxedAtomic<intptr_t> unclaimed_ = {0};
+
+  DISALLOW_COPY_AND_ASSIGN(SweepQueue);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_HEAP_SWEEPER_H_
@@ -29,66 +29,111 @@ intptr_t WeakTable::SizeFor(intptr_t count, intptr_t size) {
   return result;
 }
 
+intptr_t* WeakTable::AllocateData(intptr_t size) {
+  intptr_t* data =
+      reinterpret_cast<intptr_t*>(malloc(size * kEntrySize * kWordSize));
+  for (intptr_t i = 0; i < size; i++) {
+    data[i * kEntrySize + kObjectOffset] = kNoEntry;
+    data[i * kEntrySize + kValueOffset] = kNoValue;
+  }
+  return data;
+}
+
 void WeakTable::SetValueExclusive(ObjectPtr key, intptr_t val) {
-  intptr_t mask = size() - 1;
+  const intptr_t mask = size() - 1;
   intptr_t idx = Hash(key) & mask;
-  intptr_t empty_idx = -1;
-  ObjectPtr obj = ObjectAtExclusive(idx);
-
-  while (obj != static_cast<ObjectPtr>(kNoEntry)) {
+  intptr_t dist = 0;
+  for (;;) {
+    ObjectPtr obj = ObjectAtExclusive(idx);
     if (obj == key) {
-      SetValueAt(idx, val);
+      if (val == 0) {
+        // Associating 0 with a key deletes it from this weak table.
+        RemoveAt(idx);
+      } else {
+        data_[ValueIndex(idx)] = val;
+      }
       return;
-    } else if ((empty_idx < 0) &&
-               (static_cast<intptr_t>(obj) == kDeletedEntry)) {
-      empty_idx = idx;  // Insert at this location if not found.
+    }
+    if ((obj == static_cast<ObjectPtr>(kNoEntry)) ||
+        (ProbeDistance(idx) < dist)) {
+      break;
     }
     idx = (idx + 1) & mask;
-    obj = ObjectAtExclusive(idx);
+    dist++;
   }
 
   if (val == 0) {
-    // Do not enter an invalid value. Associating 0 with a key deletes it from
-    // this weak table above in SetValueAt. If the key was not present in the
-    // weak table we are done.
+    // Do not enter an invalid value. If the key was not present in the weak
+    // table we are done.
     return;
   }
 
-  if (empty_idx >= 0) {
-    // We will be reusing a slot below.
-    set_used(used() - 1);
-    idx = empty_idx;
+  InsertAt(idx, dist, key, val);
+
+  // Rehash if needed to ensure that there are empty slots available.
+  if (count_ >= limit()) {
+    Rehash();
   }
+}
 
-  ASSERT(!IsValidEntryAtExclusive(idx));
-  // Set the key and value.
-  SetObjectAt(idx, key);
-  SetValueAt(idx, val);
-  // Update the counts.
-  set_used(used() + 1);
+void WeakTable::InsertAt(intptr_t idx,
+                         intptr_t dist,
+                         ObjectPtr key,
+                         intptr_t val) {
+  ASSERT(val != 0);
+  const intptr_t mask = size() - 1;
+  intptr_t cur_key = static_cast<intptr_t>(key);
+  intptr_t cur_val = val;
+  for (;;) {
+    if (data_[ObjectIndex(idx)] == kNoEntry) {
+      data_[ObjectIndex(idx)] = cur_key;
+      data_[ValueIndex(idx)] = cur_val;
+      break;
+    }
+    const intptr_t resident_dist = ProbeDistance(idx);
+    if (resident_dist < dist) {
+      // Take the slot from the entry closer to its home and carry that entry
+      // forward instead.
+      intptr_t resident_key = data_[ObjectIndex(idx)];
+      intptr_t resident_val = data_[ValueIndex(idx)];
+      data_[ObjectIndex(idx)] = cur_key;
+      data_[ValueIndex(idx)] = cur_val;
+      cur_key = resident_key;
+      cur_val = resident_val;
+      dist = resident_dist;
+    }
+    idx = (idx + 1) & mask;
+    dist++;
+  }
   set_count(count() + 1);
+}
 
-  // Rehash if needed to ensure that there are empty slots available.
-  if (used_ >= limit()) {
-    Rehash();
+void WeakTable::RemoveAt(intptr_t i) {
+  const intptr_t mask = size() - 1;
+  intptr_t next = (i + 1) & mask;
+  // Shift the rest of the probe sequence back by one slot. It ends at an
+  // empty slot or at an entry already in its home slot.
+  while ((data_[ObjectIndex(next)] != kNoEntry) && (ProbeDistance(next) != 0)) {
+    data_[ObjectIndex(i)] = data_[ObjectIndex(next)];
+    data_[ValueIndex(i)] = data_[ValueIndex(next)];
+    i = next;
+    next = (next + 1) & mask;
   }
+  data_[ObjectIndex(i)] = kNoEntry;
+  data_[ValueIndex(i)] = kNoValue;
+  set_count(count() - 1);
 }
 
 void WeakTable::Reset() {
   intptr_t* old_data = data_;
-  used_ = 0;
   count_ = 0;
   size_ = kMinSize;
   free(old_data);
-  data_ = reinterpret_cast<intptr_t*>(malloc(size_ * kEntrySize * kWordSize));
-  for (intptr_t i = 0; i < size_; i++) {
-    data_[ObjectIndex(i)] = kNoEntry;
-    data_[ValueIndex(i)] = kNoValue;
-  }
+  data_ = AllocateData(size_);
 }
 
 void WeakTable::Forward(ObjectPointerVisitor* visitor) {
-  if (used_ == 0) return;
+  if (count_ == 0) return;
 
   for (intptr_t i = 0; i < size_; i++) {
     if (IsValidEntryAtExclusive(i)) {
@@ -100,43 +145,25 @@ void WeakTable::Forward(ObjectPointerVisitor* visitor) {
 }
 
 void WeakTable::Rehash() {
-  intptr_t old_size = size();
+  const intptr_t old_size = size();
   intptr_t* old_data = data_;
 
   intptr_t new_size = SizeFor(count(), size());
   ASSERT(Utils::IsPowerOfTwo(new_size));
-  intptr_t* new_data =
-      reinterpret_cast<intptr_t*>(malloc(new_size * kEntrySize * kWordSize));
-  for (intptr_t i = 0; i < new_size; i++) {
-    new_data[ObjectIndex(i)] = kNoEntry;
-    new_data[ValueIndex(i)] = kNoValue;
-  }
+  size_ = new_size;
+  data_ = AllocateData(new_size);
+  set_count(0);
 
-  intptr_t mask = new_size - 1;
-  set_used(0);
+  const intptr_t mask = new_size - 1;
   for (intptr_t i = 0; i < old_size; i++) {
-    if (IsValidEntryAtExclusive(i)) {
-      // Find the new hash location for this entry.
-      ObjectPtr key = ObjectAtExclusive(i);
-      intptr_t idx = Hash(key) & mask;
-      ObjectPtr obj = static_cast<ObjectPtr>(new_data[ObjectIndex(idx)]);
-      while (obj != static_cast<ObjectPtr>(kNoEntry)) {
-        ASSERT(obj != key);  // Duplicate entry is not expected.
-        idx = (idx + 1) & mask;
-        obj = static_cast<ObjectPtr>(new_data[ObjectIndex(idx)]);
-      }
-
-      new_data[ObjectIndex(idx)] = static_cast<intptr_t>(key);
-      new_data[ValueIndex(idx)] = ValueAtExclusive(i);
-      set_used(used() + 1);
+    const intptr_t key = old_data[i * kEntrySize + kObjectOffset];
+    if (key != kNoEntry) {
+      ObjectPtr obj = static_cast<ObjectPtr>(key);
+      ASSERT(FindIndex(obj) < 0);  // Duplicate entry is not expected.
+      InsertAt(Hash(obj) & mask, 0, obj,
+               old_data[i * kEntrySize + kValueOffset]);
     }
   }
-  // We should only have used valid entries.
-  ASSERT(used() == count());
-
-  // Switch to using the newly allocated backing store.
-  size_ = new_size;
-  data_ = new_data;
   free(old_data);
 }
 
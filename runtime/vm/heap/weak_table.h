@@ -13,12 +13,17 @@
 
 namespace dart {
 
+// An open-addressing table keyed by object address, kept in Robin Hood order:
+// along a probe sequence, entries appear in non-decreasing distance from their
+// home slot. Removals shift the rest of the sequence back instead of leaving
+// tombstones, so the GC can drop dead entries in place without rebuilding the
+// table.
 class WeakTable {
  public:
   static constexpr intptr_t kNoValue = 0;
 
   WeakTable() : WeakTable(kMinSize) {}
-  explicit WeakTable(intptr_t size) : used_(0), count_(0) {
+  explicit WeakTable(intptr_t size) : count_(0) {
     ASSERT(size >= 0);
     ASSERT(Utils::IsPowerOfTwo(kMinSize));
     if (size < kMinSize) {
@@ -33,11 +38,7 @@ class WeakTable {
     }
     size_ = size;
     ASSERT(Utils::IsPowerOfTwo(size_));
-    data_ = reinterpret_cast<intptr_t*>(malloc(size_ * kEntrySize * kWordSize));
-    for (intptr_t i = 0; i < size_; i++) {
-      data_[ObjectIndex(i)] = kNoEntry;
-      data_[ValueIndex(i)] = kNoValue;
-    }
+    data_ = AllocateData(size_);
   }
 
   ~WeakTable() { free(data_); }
@@ -47,7 +48,8 @@ class WeakTable {
   }
 
   intptr_t size() const { return size_; }
-  intptr_t used() const { return used_; }
+  // Without tombstones every occupied slot holds a valid entry.
+  intptr_t used() const { return count_; }
   intptr_t count() const { return count_; }
 
   // The following methods can be called concurrently and are guarded by a lock.
@@ -68,17 +70,17 @@ class WeakTable {
   // This is mostly limited to GC related code (e.g. scavenger, marker, ...)
 
   bool IsValidEntryAtExclusive(intptr_t i) const {
-    ASSERT((ValueAtExclusive(i) == 0 &&
-            (data_[ObjectIndex(i)] == kNoEntry ||
-             data_[ObjectIndex(i)] == kDeletedEntry)) ||
-           (ValueAtExclusive(i) != 0 && data_[ObjectIndex(i)] != kNoEntry &&
-            data_[ObjectIndex(i)] != kDeletedEntry));
+    ASSERT((ValueAtExclusive(i) == 0) ==
+           (data_[ObjectIndex(i)] == kNoEntry));
     return (data_[ValueIndex(i)] != 0);
   }
 
+  // Removes the entry at |i|. The entry that followed it in its probe
+  // sequence, if any, moves to |i|, so a caller iterating over the table must
+  // look at |i| again.
   void InvalidateAtExclusive(intptr_t i) {
     ASSERT(IsValidEntryAtExclusive(i));
-    SetValueAt(i, 0);
+    RemoveAt(i);
   }
 
   ObjectPtr ObjectAtExclusive(intptr_t i) const {
@@ -96,37 +98,28 @@ class WeakTable {
   void SetValueExclusive(ObjectPtr key, intptr_t val);
 
   intptr_t GetValueExclusive(ObjectPtr key) const {
-    intptr_t mask = size() - 1;
-    intptr_t idx = Hash(key) & mask;
-    ObjectPtr obj = ObjectAtExclusive(idx);
-    while (obj != static_cast<ObjectPtr>(kNoEntry)) {
-      if (obj == key) {
-        return ValueAtExclusive(idx);
-      }
-      idx = (idx + 1) & mask;
-      obj = ObjectAtExclusive(idx);
-    }
-    ASSERT(ValueAtExclusive(idx) == 0);
-    return kNoValue;
+    const intptr_t idx = FindIndex(key);
+    return (idx < 0) ? kNoValue : ValueAtExclusive(idx);
   }
 
   // Removes and returns the value associated with |key|. Returns 0 if there is
   // no value associated with |key|.
   intptr_t RemoveValueExclusive(ObjectPtr key) {
-    intptr_t mask = size() - 1;
-    intptr_t idx = Hash(key) & mask;
-    ObjectPtr obj = ObjectAtExclusive(idx);
-    while (obj != static_cast<ObjectPtr>(kNoEntry)) {
-      if (obj == key) {
-        intptr_t result = ValueAtExclusive(idx);
-        InvalidateAtExclusive(idx);
-        return result;
-      }
-      idx = (idx + 1) & mask;
-      obj = ObjectAtExclusive(idx);
+    const intptr_t idx = FindIndex(key);
+    if (idx < 0) {
+      return kNoValue;
+    }
+    intptr_t result = ValueAtExclusive(idx);
+    RemoveAt(idx);
+    return result;
+  }
+
+  // Shrinks the backing store after many removals, so that the next walk
+  // over the table does not pay for its former size.
+  void MaybeShrinkExclusive() {
+    if ((size_ > kMinSize) && (count_ <= (size_ / 8))) {
+      Rehash();
     }
-    ASSERT(ValueAtExclusive(idx) == 0);
-    return kNoValue;
   }
 
   void Forward(ObjectPointerVisitor* visitor);
@@ -140,8 +133,7 @@ class WeakTable {
     kEntrySize,
   };
 
-  static const intptr_t kNoEntry = 1;       // Not a valid OOP.
-  static const intptr_t kDeletedEntry = 3;  // Not a valid OOP.
+  static const intptr_t kNoEntry = 1;  // Not a valid OOP.
   static const intptr_t kMinSize = 8;
 
   static intptr_t SizeFor(intptr_t count, intptr_t size);
@@ -151,16 +143,12 @@ class WeakTable {
   }
   intptr_t limit() const { return LimitFor(size()); }
 
-  intptr_t index(intptr_t i) const { return i * kEntrySize; }
+  static intptr_t* AllocateData(intptr_t size);
 
-  void set_used(intptr_t val) {
-    ASSERT(val <= limit());
-    used_ = val;
-  }
+  intptr_t index(intptr_t i) const { return i * kEntrySize; }
 
   void set_count(intptr_t val) {
     ASSERT(val <= limit());
-    ASSERT(val <= used());
     count_ = val;
   }
 
@@ -174,38 +162,51 @@ class WeakTable {
     return reinterpret_cast<ObjectPtr*>(&data_[ObjectIndex(i)]);
   }
 
-  void SetObjectAt(intptr_t i, ObjectPtr key) {
-    ASSERT(i >= 0);
-    ASSERT(i < size());
-    data_[ObjectIndex(i)] = static_cast<intptr_t>(key);
+  // Distance of the entry at |i| from its home slot.
+  intptr_t ProbeDistance(intptr_t i) const {
+    const intptr_t mask = size() - 1;
+    return (i - (Hash(ObjectAtExclusive(i)) & mask)) & mask;
   }
 
-  void SetValueAt(intptr_t i, intptr_t val) {
-    ASSERT(i >= 0);
-    ASSERT(i < size());
-    // Setting a value of 0 is equivalent to invalidating the entry.
-    if (val == 0) {
-      data_[ObjectIndex(i)] = kDeletedEntry;
-      set_count(count() - 1);
+  // Returns the slot holding |key|, or -1.
+  intptr_t FindIndex(ObjectPtr key) const {
+    const intptr_t mask = size() - 1;
+    intptr_t idx = Hash(key) & mask;
+    for (intptr_t dist = 0;; dist++) {
+      ObjectPtr obj = ObjectAtExclusive(idx);
+      if (obj == key) {
+        return idx;
+      }
+      // Robin Hood order: |key| would have displaced a closer entry.
+      if ((obj == static_cast<ObjectPtr>(kNoEntry)) ||
+          (ProbeDistance(idx) < dist)) {
+        return -1;
+      }
+      idx = (idx + 1) & mask;
     }
-    data_[ValueIndex(i)] = val;
   }
 
+  // Inserts a key known to be absent, starting |dist| slots past its home at
+  // |idx|.
+  void InsertAt(intptr_t idx, intptr_t dist, ObjectPtr key, intptr_t val);
+  void RemoveAt(intptr_t i);
+
   void Rehash();
 
   static intptr_t Hash(ObjectPtr key) {
-    return static_cast<uintptr_t>(key) * 92821;
+    // Heap objects share their low bits, so fold the aligned-away bits in.
+    const uintptr_t bits = static_cast<uintptr_t>(key);
+    return (bits ^ (bits >> kObjectAlignmentLog2)) * 92821;
   }
 
   Mutex mutex_;
 
   // data_ contains size_ tuples of key/value.
   intptr_t* data_;
-  // size_ keeps the number of entries in data_. used_ maintains the number of
-  // non-NULL entries and will trigger rehashing if needed. count_ stores the
-  // number valid entries, and will determine the size_ after rehashing.
+  // size_ keeps the number of entries in data_. count_ stores the number of
+  // valid entries, which triggers rehashing if needed and determines the size_
+  // after rehashing.
   intptr_t size_;
-  intptr_t used_;
   intptr_t count_;
 
   DISALLOW_COPY_AND_ASSIGN(WeakTable);
@@ -59,4 +59,73 @@ ISOLATE_UNIT_TEST_CASE(WeakTables) {
   EXPECT_EQ(kNoValue, heap->GetObjectId(imm_obj.raw()));
 }
 
+ISOLATE_UNIT_TEST_CASE(WeakTable_InsertRemoveInPlace) {
+  WeakTable table;
+  const intptr_t kNumKeys = 1000;
+  for (intptr_t i = 0; i < kNumKeys; i++) {
+    table.SetValueExclusive(Smi::New(i), i + 1);
+  }
+  EXPECT_EQ(kNumKeys, table.count());
+
+  // Remove every third key; removal shifts successors back, leaving no
+  // tombstones behind.
+  const intptr_t size_before = table.size();
+  for (intptr_t i = 0; i < kNumKeys; i += 3) {
+    EXPECT_EQ(i + 1, table.RemoveValueExclusive(Smi::New(i)));
+  }
+  EXPECT_EQ(size_before, table.size());
+  EXPECT_EQ(table.count(), table.used());
+  for (intptr_t i = 0; i < kNumKeys; i++) {
+    const intptr_t expected = ((i % 3) == 0) ? WeakTable::kNoValue : i + 1;
+    EXPECT_EQ(expected, table.GetValueExclusive(Smi::New(i)));
+  }
+
+  // Invalidating in a walk revisits the slot that was shifted into.
+  intptr_t i = 0;
+  while (i < table.size()) {
+    if (table.IsValidEntryAtExclusive(i)) {
+      table.InvalidateAtExclusive(i);
+      continue;
+    }
+    i++;
+  }
+  EXPECT_EQ(0, table.count());
+  table.MaybeShrinkExclusive();
+  EXPECT(table.size() < size_before);
+  for (intptr_t i = 0; i < kNumKeys; i++) {
+    EXPECT_EQ(WeakTable::kNoValue, table.GetValueExclusive(Smi::New(i)));
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(WeakTable_DeadEntriesDroppedByMarker) {
+  Heap* heap = thread->heap();
+  GCTestHelper::CollectAllGarbage();
+  WeakTable* table = heap->GetWeakTable(Heap::kOld, Heap::kObjectIds);
+  const intptr_t count_before = table->count();
+
+  const intptr_t kNumObjects = 100;
+  const Array& live = Array::Handle(Array::New(kNumObjects / 2, Heap::kOld));
+  {
+    HANDLESCOPE(thread);
+    String& str = String::Handle();
+    for (intptr_t i = 0; i < kNumObjects; i++) {
+      str = String::New("weak", Heap::kOld);
+      heap->SetObjectId(str.raw(), i + 1);
+      if ((i % 2) == 0) {
+        live.SetAt(i / 2, str);
+      }
+    }
+  }
+  EXPECT_EQ(count_before + kNumObjects, table->count());
+
+  GCTestHelper::CollectOldSpace();
+  table = heap->GetWeakTable(Heap::kOld, Heap::kObjectIds);
+  EXPECT_EQ(count_before + kNumObjects / 2, table->count());
+  Object& obj = Object::Handle();
+  for (intptr_t i = 0; i < kNumObjects / 2; i++) {
+    obj = live.At(i);
+    EXPECT_EQ(2 * i + 1, heap->GetObjectId(obj.raw()));
+  }
+}
+
 }  // namespace dart
@@ -281,6 +281,8 @@ intptr_t ImageWriter::SizeInSnapshot(ObjectPtr raw_object) {
       return compiler::target::String::InstanceSize(
           String::LengthOf(raw_str) * TwoByteString::kBytesPerElement);
     }
+    case kDoubleCid:
+      return compiler::target::Double::InstanceSize();
     default: {
       const Class& clazz = Class::Handle(Object::Handle(raw_object).clazz());
       FATAL("Unsupported class %s in rodata section.\n", clazz.ToCString());
@@ -548,6 +550,13 @@ void ImageWriter::WriteROData(NonStreamingWriteStream* stream, bool vm) {
           str.Length() * (str.IsOneByteString()
                               ? OneByteString::kBytesPerElement
                               : TwoByteString::kBytesPerElement));
+    } else if (obj.IsDouble()) {
+      ASSERT(obj.IsCanonical());
+      stream->Align(compiler::target::Double::value_offset());
+      ASSERT_EQUAL(stream->Position() - object_start,
+                   compiler::target::Double::value_offset());
+      const double value = Double::Cast(obj).value();
+      stream->WriteBytes(&value, sizeof(value));
     } else {
       const Class& clazz = Class::Handle(obj.clazz());
       FATAL("Unsupported class %s in rodata section.\n", clazz.ToCString());
@@ -52,15 +52,20 @@
 #include "vm/timeline.h"
 #include "vm/timeline_analysis.h"
 #include "vm/visitor.h"
+#include "vm/zone.h"
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
 #include "vm/compiler/assembler/assembler.h"
+#include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/stub_code_compiler.h"
 #endif
 
 namespace dart {
 
 DECLARE_FLAG(bool, print_metrics);
+#if !defined(DART_PRECOMPILED_RUNTIME)
+DECLARE_FLAG(bool, print_compiler_pass_stats);
+#endif
 DECLARE_FLAG(bool, timing);
 DECLARE_FLAG(bool, trace_service);
 DECLARE_FLAG(bool, warn_on_pause_with_no_debugger);
@@ -211,6 +216,7 @@ void IdleTimeHandler::UpdateStartIdleTime() {
   MutexLocker ml(&mutex_);
   if (disabled_counter_ == 0) {
     idle_start_time_ = OS::GetCurrentMonotonicMicros();
+    slices_exhausted_ = false;
   }
 }
 
@@ -238,6 +244,7 @@ void IdleTimeHandler::NotifyIdle(int64_t deadline) {
   if (heap_ != nullptr) {
     heap_->NotifyIdle(deadline);
   }
+  Zone::TrimSegmentCache();
   {
     MutexLocker ml(&mutex_);
     disabled_counter_--;
@@ -250,6 +257,45 @@ void IdleTimeHandler::NotifyIdleUsingDefaultDeadline() {
   NotifyIdle(now + FLAG_idle_timeout_micros);
 }
 
+bool IdleTimeHandler::ShouldNotifyIdleSlice(int64_t* expiry) {
+  const int64_t now = OS::GetCurrentMonotonicMicros();
+
+  MutexLocker ml(&mutex_);
+  if (FLAG_idle_slice_micros == 0 || idle_start_time_ == 0 ||
+      disabled_counter_ != 0 || slices_exhausted_) {
+    *expiry = kMaxInt64;
+    return false;
+  }
+  const int64_t expiry_time =
+      Utils::Maximum(idle_start_time_, last_slice_time_) +
+      FLAG_idle_slice_micros;
+  if (expiry_time <= now) {
+    return true;
+  }
+  *expiry = expiry_time;
+  return false;
+}
+
+void IdleTimeHandler::NotifyIdleSlice() {
+  {
+    MutexLocker ml(&mutex_);
+    disabled_counter_++;
+  }
+  // Having been idle for a slice suggests the idle period lasts about as long
+  // again.
+  const int64_t deadline =
+      OS::GetCurrentMonotonicMicros() + FLAG_idle_slice_micros;
+  const bool did_work = (heap_ != nullptr) && heap_->NotifyIdleSlice(deadline);
+  {
+    MutexLocker ml(&mutex_);
+    disabled_counter_--;
+    last_slice_time_ = OS::GetCurrentMonotonicMicros();
+    if (!did_work) {
+      slices_exhausted_ = true;
+    }
+  }
+}
+
 DisableIdleTimerScope::DisableIdleTimerScope(IdleTimeHandler* handler)
     : handler_(handler) {
   if (handler_ != nullptr) {
@@ -290,31 +336,48 @@ void MutatorThreadPool::OnEnterIdleLocked(MonitorLocker* ml) {
   // idle time.
   if (!isolate_group_->initial_spawn_successful()) return;
 
+  IdleTimeHandler* handler = isolate_group_->idle_time_handler();
   int64_t idle_expiry = 0;
+  int64_t slice_expiry = 0;
   // Obtain the idle time we should wait.
-  if (isolate_group_->idle_time_handler()->ShouldNotifyIdle(&idle_expiry)) {
+  if (handler->ShouldNotifyIdle(&idle_expiry)) {
     MonitorLeaveScope mls(ml);
     NotifyIdle();
     return;
   }
 
-  // Wait for the recommended idle timeout.
-  // We can be woken up because of a), b) or c)
-  const auto result =
-      ml->WaitMicros(idle_expiry - OS::GetCurrentMonotonicMicros());
+  // No worker is running, so all isolates of the group are idle. Until the
+  // full idle timeout, spend each idle slice on short GC steps.
+  while (true) {
+    if (handler->ShouldNotifyIdleSlice(&slice_expiry)) {
+      {
+        MonitorLeaveScope mls(ml);
+        NotifyIdleSlice();
+      }
+      if (TasksWaitingToRunLocked() || ShuttingDownLocked()) return;
+      continue;
+    }
+
+    // Wait for the next idle slice or the recommended idle timeout.
+    // We can be woken up because of a), b) or c)
+    const auto result =
+        ml->WaitMicros(Utils::Minimum(idle_expiry, slice_expiry) -
+                       OS::GetCurrentMonotonicMicros());
 
-  // a) If there are new tasks we have to run them.
-  if (TasksWaitingToRunLocked()) return;
+    // a) If there are new tasks we have to run them.
+    if (TasksWaitingToRunLocked()) return;
 
-  // b) If the thread pool is shutting down we're done.
-  if (ShuttingDownLocked()) return;
+    // b) If the thread pool is shutting down we're done.
+    if (ShuttingDownLocked()) return;
 
-  // c) We timed out and should run the idle notifier.
-  if (result == Monitor::kTimedOut &&
-      isolate_group_->idle_time_handler()->ShouldNotifyIdle(&idle_expiry)) {
-    MonitorLeaveScope mls(ml);
-    NotifyIdle();
-    return;
+    // c) We timed out and should run the idle notifier or another slice.
+    if (result != Monitor::kTimedOut) break;
+    if (handler->ShouldNotifyIdle(&idle_expiry)) {
+      MonitorLeaveScope mls(ml);
+      NotifyIdle();
+      return;
+    }
+    if (!handler->ShouldNotifyIdleSlice(&slice_expiry)) break;
   }
 
   // There must've been another thread doing active work in the meantime.
@@ -327,6 +390,11 @@ void MutatorThreadPool::NotifyIdle() {
   isolate_group_->idle_time_handler()->NotifyIdleUsingDefaultDeadline();
 }
 
+void MutatorThreadPool::NotifyIdleSlice() {
+  EnterIsolateGroupScope isolate_group_scope(isolate_group_);
+  isolate_group_->idle_time_handler()->NotifyIdleSlice();
+}
+
 IsolateGroup::IsolateGroup(std::shared_ptr<IsolateGroupSource> source,
                            void* embedder_data,
                            ObjectStore* object_store)
@@ -371,6 +439,10 @@ IsolateGroup::IsolateGroup(std::shared_ptr<IsolateGroupSource> source,
           NOT_IN_PRODUCT("IsolateGroup::kernel_data_class_cache_mutex_")),
       kernel_constants_mutex_(
           NOT_IN_PRODUCT("IsolateGroup::kernel_constants_mutex_")),
+      regexp_bytecode_cache_mutex_(
+          NOT_IN_PRODUCT("IsolateGroup::regexp_bytecode_cache_mutex_")),
+      code_coverage_mutex_(
+          NOT_IN_PRODUCT("IsolateGroup::code_coverage_mutex_")),
       program_lock_(new SafepointRwLock()),
       active_mutators_monitor_(new Monitor()),
       max_active_mutators_(Scavenger::MaxMutatorThreadCount()) {
@@ -385,6 +457,9 @@ IsolateGroup::IsolateGroup(std::shared_ptr<IsolateGroupSource> source,
     WriteRwLocker wl(ThreadState::Current(), isolate_groups_rwlock_);
     id_ = isolate_group_random_->NextUInt64();
   }
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  compiler_pass_stats_.reset(new CompilerPassStats());
+#endif
 }
 
 IsolateGroup::IsolateGroup(std::shared_ptr<IsolateGroupSource> source,
@@ -399,6 +474,7 @@ IsolateGroup::~IsolateGroup() {
   // Finalize any weak persistent handles with a non-null referent.
   FinalizeWeakPersistentHandlesVisitor visitor(this);
   api_state()->VisitWeakHandlesUnlocked(&visitor);
+  api_state()->WaitForDeferredFinalizers();
 
   // Ensure we destroy the heap before the other members.
   heap_ = nullptr;
@@ -480,6 +556,12 @@ void IsolateGroup::Shutdown() {
     old_space->AbandonMarkingForShutdown();
   }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  if (FLAG_print_compiler_pass_stats) {
+    compiler_pass_stats_->Print(source()->name);
+  }
+#endif
+
   UnregisterIsolateGroup(this);
 
   // If the creation of the isolate group (or the first isolate within the
@@ -575,6 +657,7 @@ void IsolateGroup::UnscheduleThreadLocked(MonitorLocker* ml,
                                           bool is_mutator,
                                           bool bypass_safepoint) {
   thread->heap()->new_space()->AbandonRemainingTLAB(thread);
+  thread->heap()->old_space()->AbandonThreadCache(thread);
 
   // Clear since GC will not visit the thread once it is unscheduled. Do this
   // under the thread lock to prevent races with the GC visiting thread roots.
@@ -675,19 +758,26 @@ void IsolateGroup::IncreaseMutatorCount(Isolate* mutator) {
 
   // Prevent too many mutators from entering the isolate group to avoid
   // pathological behavior where many threads are fighting for obtaining TLABs.
-  {
-    // NOTE: This is performance critical code, we should avoid monitors and use
-    // std::atomics in the fast case (where active_mutators <
-    // max_active_mutators) and only use montiors in the uncommon case.
-    MonitorLocker ml(active_mutators_monitor_.get());
-    ASSERT(active_mutators_ <= max_active_mutators_);
-    while (active_mutators_ == max_active_mutators_) {
-      waiting_mutators_++;
-      ml.Wait();
-      waiting_mutators_--;
-    }
-    active_mutators_++;
+  if (TryIncreaseActiveMutators()) {
+    return;
   }
+  MonitorLocker ml(active_mutators_monitor_.get());
+  waiting_mutators_++;
+  while (!TryIncreaseActiveMutators()) {
+    ml.Wait();
+  }
+  waiting_mutators_--;
+}
+
+bool IsolateGroup::TryIncreaseActiveMutators() {
+  intptr_t active = active_mutators_.load();
+  do {
+    ASSERT(active <= max_active_mutators_);
+    if (active == max_active_mutators_) {
+      return false;
+    }
+  } while (!active_mutators_.compare_exchange_weak(active, active + 1));
+  return true;
 }
 
 void IsolateGroup::DecreaseMutatorCount(Isolate* mutator) {
@@ -702,16 +792,11 @@ void IsolateGroup::DecreaseMutatorCount(Isolate* mutator) {
     thread_pool()->MarkCurrentWorkerAsBlocked();
   }
 
-  {
-    // NOTE: This is performance critical code, we should avoid monitors and use
-    // std::atomics in the fast case (where active_mutators <
-    // max_active_mutators) and only use montiors in the uncommon case.
+  ASSERT(active_mutators_ > 0);
+  active_mutators_--;
+  if (waiting_mutators_ > 0) {
     MonitorLocker ml(active_mutators_monitor_.get());
-    ASSERT(active_mutators_ <= max_active_mutators_);
-    active_mutators_--;
-    if (waiting_mutators_ > 0) {
-      ml.Notify();
-    }
+    ml.Notify();
   }
 }
 
@@ -1003,6 +1088,9 @@ class IsolateMessageHandler : public MessageHandler {
 #endif
   bool IsCurrentIsolate() const;
   virtual Isolate* isolate() const { return isolate_; }
+  virtual bool IsLatencySensitive() const {
+    return isolate_->is_latency_sensitive();
+  }
 
  private:
   // A result of false indicates that the isolate should terminate the
@@ -1660,9 +1748,7 @@ Isolate::Isolate(IsolateGroup* isolate_group,
       sticky_error_(Error::null()),
       field_list_mutex_(NOT_IN_PRODUCT("Isolate::field_list_mutex_")),
       boxed_field_list_(GrowableObjectArray::null()),
-      spawn_count_monitor_(),
-      handler_info_cache_(),
-      catch_entry_moves_cache_() {
+      spawn_count_monitor_() {
   cached_object_store_ = object_store_shared_ptr_.get();
   cached_class_table_table_ = class_table_->table();
   FlagsCopyFrom(api_flags);
@@ -1711,6 +1797,10 @@ Isolate::~Isolate() {
 #endif
   delete pending_deopts_;
   pending_deopts_ = nullptr;
+  delete handler_info_cache_;
+  handler_info_cache_ = nullptr;
+  delete catch_entry_moves_cache_;
+  catch_entry_moves_cache_ = nullptr;
   delete message_handler_;
   message_handler_ =
       nullptr;  // Fail fast if we send messages to a dead isolate.
@@ -2103,8 +2193,12 @@ bool Isolate::AddResumeCapability(const Capability& capability) {
   static const intptr_t kMaxResumeCapabilities =
       compiler::target::kSmiMax / (6 * kWordSize);
 
-  const GrowableObjectArray& caps = GrowableObjectArray::Handle(
+  GrowableObjectArray& caps = GrowableObjectArray::Handle(
       current_zone(), isolate_object_store()->resume_capabilities());
+  if (caps.IsNull()) {
+    caps = GrowableObjectArray::New();
+    isolate_object_store()->set_resume_capabilities(caps);
+  }
   Capability& current = Capability::Handle(current_zone());
   intptr_t insertion_index = -1;
   for (intptr_t i = 0; i < caps.Length(); i++) {
@@ -2134,6 +2228,7 @@ bool Isolate::AddResumeCapability(const Capability& capability) {
 bool Isolate::RemoveResumeCapability(const Capability& capability) {
   const GrowableObjectArray& caps = GrowableObjectArray::Handle(
       current_zone(), isolate_object_store()->resume_capabilities());
+  if (caps.IsNull()) return false;
   Capability& current = Capability::Handle(current_zone());
   for (intptr_t i = 0; i < caps.Length(); i++) {
     current ^= caps.At(i);
@@ -2155,8 +2250,12 @@ void Isolate::AddExitListener(const SendPort& listener,
   static const intptr_t kMaxListeners =
       compiler::target::kSmiMax / (12 * kWordSize);
 
-  const GrowableObjectArray& listeners = GrowableObjectArray::Handle(
+  GrowableObjectArray& listeners = GrowableObjectArray::Handle(
       current_zone(), isolate_object_store()->exit_listeners());
+  if (listeners.IsNull()) {
+    listeners = GrowableObjectArray::New();
+    isolate_object_store()->set_exit_listeners(listeners);
+  }
   SendPort& current = SendPort::Handle(current_zone());
   intptr_t insertion_index = -1;
   for (intptr_t i = 0; i < listeners.Length(); i += 2) {
@@ -2188,6 +2287,7 @@ void Isolate::AddExitListener(const SendPort& listener,
 void Isolate::RemoveExitListener(const SendPort& listener) {
   const GrowableObjectArray& listeners = GrowableObjectArray::Handle(
       current_zone(), isolate_object_store()->exit_listeners());
+  if (listeners.IsNull()) return;
   SendPort& current = SendPort::Handle(current_zone());
   for (intptr_t i = 0; i < listeners.Length(); i += 2) {
     current ^= listeners.At(i);
@@ -2223,8 +2323,12 @@ void Isolate::AddErrorListener(const SendPort& listener) {
   static const intptr_t kMaxListeners =
       compiler::target::kSmiMax / (6 * kWordSize);
 
-  const GrowableObjectArray& listeners = GrowableObjectArray::Handle(
+  GrowableObjectArray& listeners = GrowableObjectArray::Handle(
       current_zone(), isolate_object_store()->error_listeners());
+  if (listeners.IsNull()) {
+    listeners = GrowableObjectArray::New();
+    isolate_object_store()->set_error_listeners(listeners);
+  }
   SendPort& current = SendPort::Handle(current_zone());
   intptr_t insertion_index = -1;
   for (intptr_t i = 0; i < listeners.Length(); i++) {
@@ -2253,6 +2357,7 @@ void Isolate::AddErrorListener(const SendPort& listener) {
 void Isolate::RemoveErrorListener(const SendPort& listener) {
   const GrowableObjectArray& listeners = GrowableObjectArray::Handle(
       current_zone(), isolate_object_store()->error_listeners());
+  if (listeners.IsNull()) return;
   SendPort& current = SendPort::Handle(current_zone());
   for (intptr_t i = 0; i < listeners.Length(); i++) {
     current ^= listeners.At(i);
@@ -2368,6 +2473,7 @@ FunctionPtr Isolate::ClosureFunctionFromIndex(intptr_t idx) const {
 
 // static
 void Isolate::NotifyLowMemory() {
+  Zone::TrimSegmentCache(/*release_all=*/true);
   Isolate::KillAllIsolates(Isolate::kLowMemoryMsg);
 }
 
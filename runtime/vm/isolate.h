@@ -9,6 +9,7 @@
 #error "Should not include runtime"
 #endif
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -48,6 +49,7 @@ class ApiState;
 class BackgroundCompiler;
 class Capability;
 class CodeIndexTable;
+class CompilerPassStats;
 class Debugger;
 class DeoptContext;
 class ExternalTypedData;
@@ -165,8 +167,9 @@ class NoReloadScope : public ThreadStackResource {
   DISALLOW_COPY_AND_ASSIGN(NoReloadScope);
 };
 
-// Fixed cache for exception handler lookup.
-typedef FixedCache<intptr_t, ExceptionHandlerInfo, 16> HandlerInfoCache;
+// Fixed cache for exception handler lookup, including lookups that found no
+// handler.
+typedef FixedCache<intptr_t, ExceptionHandlerInfo, 64> HandlerInfoCache;
 // Fixed cache for catch entry state lookup.
 typedef FixedCache<intptr_t, CatchEntryMovesRefPtr, 16> CatchEntryMovesCache;
 
@@ -191,6 +194,8 @@ typedef FixedCache<intptr_t, CatchEntryMovesRefPtr, 16> CatchEntryMovesCache;
   V(PRODUCT, copy_parent_code, CopyParentCode, copy_parent_code,               \
     false_by_default)                                                          \
   V(PRODUCT, is_system_isolate, IsSystemIsolate, is_system_isolate,            \
+    false_by_default)                                                          \
+  V(PRODUCT, is_latency_sensitive, IsLatencySensitive, is_latency_sensitive,   \
     false_by_default)
 
 // List of Isolate flags with custom getters named #name().
@@ -293,6 +298,15 @@ class IdleTimeHandler : public ValueObject {
   // Calls [NotifyIdle] with the default deadline.
   void NotifyIdleUsingDefaultDeadline();
 
+  // Returns whether all isolates of the group have been idle for an idle
+  // slice and [NotifyIdleSlice] should be called. Otherwise sets [expiry] to
+  // when the next slice is due.
+  bool ShouldNotifyIdleSlice(int64_t* expiry);
+
+  // Runs GC work that fits in an idle slice. Until the group runs code again,
+  // further slices are only due if this one found work to do.
+  void NotifyIdleSlice();
+
  private:
   friend class DisableIdleTimerScope;
 
@@ -300,6 +314,8 @@ class IdleTimeHandler : public ValueObject {
   Heap* heap_ = nullptr;
   intptr_t disabled_counter_ = 0;
   int64_t idle_start_time_ = 0;
+  int64_t last_slice_time_ = 0;
+  bool slices_exhausted_ = false;
 };
 
 // Disables firing of the idle timer while this object is alive.
@@ -323,6 +339,7 @@ class MutatorThreadPool : public ThreadPool {
 
  private:
   void NotifyIdle();
+  void NotifyIdleSlice();
 
   IsolateGroup* isolate_group_ = nullptr;
 };
@@ -347,6 +364,12 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 
   Heap* heap() const { return heap_.get(); }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  CompilerPassStats* compiler_pass_stats() const {
+    return compiler_pass_stats_.get();
+  }
+#endif
+
   IdleTimeHandler* idle_time_handler() { return &idle_time_handler_; }
 
   // Returns true if this is the first isolate registered.
@@ -435,6 +458,10 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
     return &kernel_data_class_cache_mutex_;
   }
   Mutex* kernel_constants_mutex() { return &kernel_constants_mutex_; }
+  Mutex* regexp_bytecode_cache_mutex() {
+    return &regexp_bytecode_cache_mutex_;
+  }
+  Mutex* code_coverage_mutex() { return &code_coverage_mutex_; }
 
 #if defined(DART_PRECOMPILED_RUNTIME)
   Mutex* unlinked_call_map_mutex() { return &unlinked_call_map_mutex_; }
@@ -650,6 +677,9 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   // For `object_store_shared_ptr()`, `class_table_shared_ptr()`
   friend class Isolate;
 
+  // Takes one of the max_active_mutators_ slots if one is free.
+  bool TryIncreaseActiveMutators();
+
 #define ISOLATE_GROUP_FLAG_BITS(V) V(CompactionInProgress)
 
   // Isolate specific flags.
@@ -723,6 +753,9 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   std::unique_ptr<StoreBuffer> store_buffer_;
   std::unique_ptr<Heap> heap_;
   std::unique_ptr<DispatchTable> dispatch_table_;
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  std::unique_ptr<CompilerPassStats> compiler_pass_stats_;
+#endif
   const uint8_t* dispatch_table_snapshot_ = nullptr;
   intptr_t dispatch_table_snapshot_size_ = 0;
   ArrayPtr saved_unlinked_calls_;
@@ -740,6 +773,8 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   Mutex kernel_data_lib_cache_mutex_;
   Mutex kernel_data_class_cache_mutex_;
   Mutex kernel_constants_mutex_;
+  Mutex regexp_bytecode_cache_mutex_;
+  Mutex code_coverage_mutex_;
 
 #if defined(DART_PRECOMPILED_RUNTIME)
   Mutex unlinked_call_map_mutex_;
@@ -755,14 +790,19 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   std::unique_ptr<SafepointRwLock> program_lock_;
 
   // Allow us to ensure the number of active mutators is limited by a maximum.
+  // The counters are updated without the monitor while below the maximum, so
+  // they use sequentially consistent atomics: a waiting mutator increments
+  // [waiting_mutators_] before it checks [active_mutators_], and a leaving
+  // one decrements [active_mutators_] before it checks [waiting_mutators_].
   std::unique_ptr<Monitor> active_mutators_monitor_;
-  intptr_t active_mutators_ = 0;
-  intptr_t waiting_mutators_ = 0;
+  std::atomic<intptr_t> active_mutators_ = {0};
+  std::atomic<intptr_t> waiting_mutators_ = {0};
   intptr_t max_active_mutators_ = 0;
 };
 
-// When an isolate sends-and-exits this class represent things that it passed
-// to the beneficiary.
+// When an isolate sends-and-exits, or sends a message which was copied within
+// its isolate group, this class represent things that it passed to the
+// beneficiary.
 class Bequest {
  public:
   Bequest(PersistentHandle* handle, Dart_Port beneficiary)
@@ -1223,6 +1263,15 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
     isolate_flags_ = RemappingCidsBit::update(value, isolate_flags_);
   }
 
+  // In precompilation, set when usage counts of a training run were loaded
+  // with Dart_LoadTypeFeedback.
+  bool has_aot_feedback() const {
+    return HasAotFeedbackBit::decode(isolate_flags_);
+  }
+  void set_has_aot_feedback(bool value) {
+    isolate_flags_ = HasAotFeedbackBit::update(value, isolate_flags_);
+  }
+
   // Used by background compiler which field became boxed and must trigger
   // deoptimization in the mutator thread.
   void AddDeoptimizingBoxedField(const Field& field);
@@ -1382,10 +1431,26 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   }
 #endif  // !defined(PRODUCT)
 
-  HandlerInfoCache* handler_info_cache() { return &handler_info_cache_; }
+  // Only isolates that throw need these caches, so they are allocated by the
+  // first mutator lookup.
+  HandlerInfoCache* handler_info_cache() {
+    if (handler_info_cache_ == nullptr) {
+      handler_info_cache_ = new HandlerInfoCache();
+    }
+    return handler_info_cache_;
+  }
 
   CatchEntryMovesCache* catch_entry_moves_cache() {
-    return &catch_entry_moves_cache_;
+    if (catch_entry_moves_cache_ == nullptr) {
+      catch_entry_moves_cache_ = new CatchEntryMovesCache();
+    }
+    return catch_entry_moves_cache_;
+  }
+
+  // Called at a safepoint when Code objects may have been collected.
+  void ClearExceptionHandlerCaches() {
+    if (handler_info_cache_ != nullptr) handler_info_cache_->Clear();
+    if (catch_entry_moves_cache_ != nullptr) catch_entry_moves_cache_->Clear();
   }
 
   void MaybeIncreaseReloadEveryNStackOverflowChecks();
@@ -1518,6 +1583,7 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   V(IsKernelIsolate)                                                           \
   V(AllClassesFinalized)                                                       \
   V(RemappingCids)                                                             \
+  V(HasAotFeedback)                                                            \
   V(ResumeRequest)                                                             \
   V(HasAttemptedReload)                                                        \
   V(HasAttemptedStepping)                                                      \
@@ -1530,7 +1596,8 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   V(ShouldLoadVmService)                                                       \
   V(NullSafety)                                                                \
   V(NullSafetySet)                                                             \
-  V(IsSystemIsolate)
+  V(IsSystemIsolate)                                                           \
+  V(IsLatencySensitive)
 
   // Isolate specific flags.
   enum FlagBits {
@@ -1629,8 +1696,8 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   Monitor spawn_count_monitor_;
   intptr_t spawn_count_ = 0;
 
-  HandlerInfoCache handler_info_cache_;
-  CatchEntryMovesCache catch_entry_moves_cache_;
+  HandlerInfoCache* handler_info_cache_ = nullptr;
+  CatchEntryMovesCache* catch_entry_moves_cache_ = nullptr;
 
   Dart_QualifiedFunctionName* embedder_entry_points_ = nullptr;
   const char** obfuscation_map_ = nullptr;
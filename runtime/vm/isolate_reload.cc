@@ -2063,17 +2063,15 @@ void IsolateReloadContext::InvalidateKernelInfos(
   for (intptr_t i = 0; i < kernel_infos.length(); i++) {
     const KernelProgramInfo& info = *kernel_infos[i];
     // Clear the libraries cache.
-    {
-      data = info.libraries_cache();
-      ASSERT(!data.IsNull());
+    data = info.libraries_cache();
+    if (!data.IsNull()) {
       IntHashMap table(&key, &value, &data);
       table.Clear();
       info.set_libraries_cache(table.Release());
     }
     // Clear the classes cache.
-    {
-      data = info.classes_cache();
-      ASSERT(!data.IsNull());
+    data = info.classes_cache();
+    if (!data.IsNull()) {
       IntHashMap table(&key, &value, &data);
       table.Clear();
       info.set_classes_cache(table.Release());
@@ -2087,7 +2085,7 @@ void IsolateReloadContext::InvalidateFunctions(
   TIMELINE_SCOPE(InvalidateFunctions);
   HANDLESCOPE(Thread::Current());
 
-  CallSiteResetter resetter(zone);
+  CallSiteResetter resetter(zone, this);
 
   Class& owning_class = Class::Handle(zone);
   Library& owning_lib = Library::Handle(zone);
@@ -2125,7 +2123,8 @@ void IsolateReloadContext::InvalidateFunctions(
       func.SetWasCompiled(false);
     } else {
       // We are preserving the unoptimized code, reset instance calls and type
-      // test caches.
+      // test caches. Calls that only ever reached classes and functions of
+      // clean libraries keep their entries, since neither can have changed.
       resetter.ResetSwitchableCalls(code);
       resetter.ResetCaches(code);
     }
@@ -2138,6 +2137,61 @@ void IsolateReloadContext::InvalidateFunctions(
   }
 }
 
+bool IsolateReloadContext::MayCallDirtyCode(const ICData& ic) {
+  if (dirty_cids_ == nullptr) {
+    ClassTable* class_table = I->class_table();
+    const intptr_t num_cids = class_table->NumCids();
+    dirty_cids_ = new (Z) BitVector(Z, num_cids);
+    Class& cls = Class::Handle();
+    Library& lib = Library::Handle();
+    for (intptr_t cid = kNumPredefinedCids; cid < num_cids; cid++) {
+      if (!class_table->HasValidClassAt(cid)) {
+        continue;
+      }
+      cls = class_table->At(cid);
+      lib = cls.library();
+      if (!lib.IsNull() && IsDirty(lib)) {
+        dirty_cids_->Add(cid);
+      }
+    }
+  }
+
+  HANDLESCOPE(Thread::Current());
+  Function& function = Function::Handle();
+  Class& owner = Class::Handle();
+  Library& lib = Library::Handle();
+  if (ic.rebind_rule() == ICData::kSuper) {
+    // The target is looked up from the caller's superclass.
+    function = ic.Owner();
+    owner = function.Owner();
+    lib = owner.library();
+    if (IsDirty(lib)) {
+      return true;
+    }
+  }
+
+  const intptr_t num_args = ic.NumArgsTested();
+  const intptr_t num_checks = ic.NumberOfChecks();
+  for (intptr_t i = 0; i < num_checks; i++) {
+    for (intptr_t arg = 0; arg < num_args; arg++) {
+      const intptr_t cid = ic.GetClassIdAt(i, arg);
+      if ((cid < dirty_cids_->length()) && dirty_cids_->Contains(cid)) {
+        return true;
+      }
+    }
+    function = ic.GetTargetAt(i);
+    if (function.IsNull()) {
+      continue;
+    }
+    owner = function.Owner();
+    lib = owner.library();
+    if (!lib.IsNull() && IsDirty(lib)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // Finds fields that are initialized or have a value that does not conform to
 // the field's static type, setting Field::needs_load_guard(). Accessors for
 // such fields are compiled with additional checks to handle lazy initialization
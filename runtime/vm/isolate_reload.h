@@ -375,6 +375,11 @@ class IsolateReloadContext {
   void ResetMegamorphicCaches();
   void InvalidateWorld();
 
+  // Whether 'ic' has cached a receiver class or a target function that
+  // belongs to a dirty library. Call sites in clean code that have not keep
+  // their entries across the reload.
+  bool MayCallDirtyCode(const ICData& ic);
+
   struct LibraryInfo {
     bool dirty;
   };
@@ -388,6 +393,9 @@ class IsolateReloadContext {
   std::atomic<ClassPtr*> saved_class_table_;
   std::atomic<ClassPtr*> saved_tlc_class_table_;
   MallocGrowableArray<LibraryInfo> library_infos_;
+  // Class ids of the classes in dirty libraries, computed on first use by
+  // MayCallDirtyCode.
+  BitVector* dirty_cids_ = nullptr;
 
   ClassPtr OldClassOrNull(const Class& replacement_or_new);
   LibraryPtr OldLibraryOrNull(const Library& replacement_or_new);
@@ -426,11 +434,15 @@ class IsolateReloadContext {
   friend class MarkFunctionsForRecompilation;  // IsDirty.
   friend class ReasonForCancelling;
   friend class IsolateGroupReloadContext;
+  friend class CallSiteResetter;  // MayCallDirtyCode.
 };
 
 class CallSiteResetter : public ValueObject {
  public:
   explicit CallSiteResetter(Zone* zone);
+  // Only resets the caches of call sites that 'reload_context' reports as
+  // possibly calling into dirty libraries.
+  CallSiteResetter(Zone* zone, IsolateReloadContext* reload_context);
 
   void ZeroEdgeCounters(const Function& function);
   void ResetCaches(const Code& code);
@@ -440,6 +452,7 @@ class CallSiteResetter : public ValueObject {
 
  private:
   Zone* zone_;
+  IsolateReloadContext* reload_context_;
   Instructions& instrs_;
   ObjectPool& pool_;
   Object& object_;
@@ -3257,6 +3257,42 @@ TEST_CASE(IsolateReload_MainLibModified) {
   EXPECT_STREQ("fancy pants", SimpleInvokeStr(lib, "main"));
 }
 
+TEST_CASE(IsolateReload_CleanLibCallSiteSeesDirtyClass) {
+  const char* kImportScript = "describe(x) => x.toString();";
+  TestCase::AddTestLib("test:lib1", kImportScript);
+
+  const char* kScript =
+      "import 'test:lib1';\n"
+      "class A {\n"
+      "  toString() => 'old';\n"
+      "}\n"
+      "main() {\n"
+      "  return describe(new A()) + describe(1);\n"
+      "}\n";
+
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(lib);
+  EXPECT_STREQ("old1", SimpleInvokeStr(lib, "main"));
+
+  const char* kReloadScript =
+      "import 'test:lib1';\n"
+      "class A {\n"
+      "  toString() => 'new';\n"
+      "}\n"
+      "main() {\n"
+      "  return describe(new A()) + describe(1);\n"
+      "}\n";
+
+  Dart_SetFileModifiedCallback(&MainModifiedCallback);
+  lib = TestCase::ReloadTestScript(kReloadScript);
+  EXPECT_VALID(lib);
+  Dart_SetFileModifiedCallback(NULL);
+
+  // The call in the clean library has cached a receiver class from the
+  // reloaded library, so it is reset and dispatches to the new method.
+  EXPECT_STREQ("new1", SimpleInvokeStr(lib, "main"));
+}
+
 static bool ImportModifiedCallback(const char* url, int64_t since) {
   if (strcmp(url, "test:lib1") == 0) {
     return true;
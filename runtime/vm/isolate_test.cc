@@ -248,4 +248,35 @@ TEST_CASE(NoOOBMessageScope) {
   EXPECT_EQ(kZero, IsolateTestHelper::GetDeferredInterrupts(thread));
 }
 
+VM_UNIT_TEST_CASE(IdleTimeHandler_Slices) {
+  const intptr_t saved_slice_micros = FLAG_idle_slice_micros;
+  FLAG_idle_slice_micros = 1;
+  IdleTimeHandler handler;
+  int64_t expiry = 0;
+
+  // Not idle before the first message has been handled.
+  EXPECT(!handler.ShouldNotifyIdleSlice(&expiry));
+
+  handler.UpdateStartIdleTime();
+  OS::Sleep(1);
+  EXPECT(handler.ShouldNotifyIdleSlice(&expiry));
+  {
+    DisableIdleTimerScope disable_idle_timer(&handler);
+    EXPECT(!handler.ShouldNotifyIdleSlice(&expiry));
+  }
+
+  // Without a heap a slice finds no work, so no further slices are due until
+  // the group is idle again.
+  handler.UpdateStartIdleTime();
+  OS::Sleep(1);
+  handler.NotifyIdleSlice();
+  OS::Sleep(1);
+  EXPECT(!handler.ShouldNotifyIdleSlice(&expiry));
+  handler.UpdateStartIdleTime();
+  OS::Sleep(1);
+  EXPECT(handler.ShouldNotifyIdleSlice(&expiry));
+
+  FLAG_idle_slice_micros = saved_slice_micros;
+}
+
 }  // namespace dart
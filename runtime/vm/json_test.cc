@@ -201,6 +201,37 @@ TEST_CASE(JSON_JSONStream_EscapedString) {
   EXPECT_STREQ("[\"Hel\\\"\\\"lo\\r\\n\\t\"]", js.ToCString());
 }
 
+TEST_CASE(JSON_JSONStream_EscapedRuns) {
+  JSONStream js;
+  {
+    JSONArray jsarr(&js);
+    jsarr.AddValue("");
+    jsarr.AddValue("/a/b");
+    jsarr.AddValue("caf\xC3\xA9 au lait\x01");
+    jsarr.AddValue("plain ascii text");
+  }
+  EXPECT_STREQ(
+      "[\"\",\"\\/a\\/b\",\"caf\xC3\xA9 au lait\\u0001\","
+      "\"plain ascii text\"]",
+      js.ToCString());
+}
+
+TEST_CASE(JSON_JSONStream_Integers) {
+  JSONStream js;
+  {
+    JSONArray jsarr(&js);
+    jsarr.AddValue(static_cast<intptr_t>(0));
+    jsarr.AddValue(static_cast<intptr_t>(-7));
+    jsarr.AddValue64(kMaxInt32);
+    jsarr.AddValue64(kMinInt32);
+    jsarr.AddValue64(9007199254740991LL);
+    jsarr.AddValue64(-9007199254740991LL);
+  }
+  EXPECT_STREQ(
+      "[0,-7,2147483647,-2147483648,9007199254740991,-9007199254740991]",
+      js.ToCString());
+}
+
 TEST_CASE(JSON_JSONStream_DartString) {
   const char* kScriptChars =
       "var ascii = 'Hello, World!';\n"
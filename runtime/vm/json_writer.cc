@@ -32,6 +32,30 @@ class MaybeOnStackBuffer {
   char buffer_[kOnStackBufferCapacity];
 };
 
+// Returns true if the character can be copied into a JSON string literal
+// as is. Everything else goes through BaseTextBuffer::EscapeAndAddCodeUnit.
+static inline bool IsSafeJSONCharacter(uint32_t ch) {
+  return (ch >= 0x20) && (ch < 0x80) && (ch != '"') && (ch != '\\') &&
+         (ch != '/');
+}
+
+// Formats i in decimal backwards from buffer_end and returns the start of
+// the digits. The buffer must hold kMaxInt64Digits characters.
+static const intptr_t kMaxInt64Digits = 20;
+static char* FormatInt64(int64_t i, char* buffer_end) {
+  uint64_t magnitude =
+      (i < 0) ? -static_cast<uint64_t>(i) : static_cast<uint64_t>(i);
+  char* p = buffer_end;
+  do {
+    *--p = '0' + static_cast<char>(magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (i < 0) {
+    *--p = '-';
+  }
+  return p;
+}
+
 JSONWriter::JSONWriter(intptr_t buf_size)
     : open_objects_(0), buffer_(buf_size) {}
 
@@ -97,24 +121,31 @@ void JSONWriter::CloseArray() {
 
 void JSONWriter::PrintValueNull() {
   PrintCommaIfNeeded();
-  buffer_.Printf("null");
+  buffer_.AddRaw(reinterpret_cast<const uint8_t*>("null"), 4);
 }
 
 void JSONWriter::PrintValueBool(bool b) {
   PrintCommaIfNeeded();
-  buffer_.Printf("%s", b ? "true" : "false");
+  if (b) {
+    buffer_.AddRaw(reinterpret_cast<const uint8_t*>("true"), 4);
+  } else {
+    buffer_.AddRaw(reinterpret_cast<const uint8_t*>("false"), 5);
+  }
 }
 
 void JSONWriter::PrintValue(intptr_t i) {
-  EnsureIntegerIsRepresentableInJavaScript(static_cast<int64_t>(i));
-  PrintCommaIfNeeded();
-  buffer_.Printf("%" Pd "", i);
+  PrintValue64(static_cast<int64_t>(i));
 }
 
 void JSONWriter::PrintValue64(int64_t i) {
   EnsureIntegerIsRepresentableInJavaScript(i);
   PrintCommaIfNeeded();
-  buffer_.Printf("%" Pd64 "", i);
+  // Service responses are mostly made of integers, which are formatted
+  // here without going through Printf.
+  char buffer[kMaxInt64Digits];
+  char* buffer_end = buffer + kMaxInt64Digits;
+  char* start = FormatInt64(i, buffer_end);
+  buffer_.AddRaw(reinterpret_cast<const uint8_t*>(start), buffer_end - start);
 }
 
 void JSONWriter::PrintValue(double d) {
@@ -124,7 +155,7 @@ void JSONWriter::PrintValue(double d) {
   char buffer[kBufferLen];
   DoubleToCString(d, buffer, kBufferLen);
   PrintCommaIfNeeded();
-  buffer_.Printf("%s", buffer);
+  buffer_.AddString(buffer);
 }
 
 static const char base64_digits[65] =
@@ -180,7 +211,7 @@ bool JSONWriter::PrintValueStr(const String& s,
 
 void JSONWriter::PrintValueNoEscape(const char* s) {
   PrintCommaIfNeeded();
-  buffer_.Printf("%s", s);
+  buffer_.AddString(s);
 }
 
 void JSONWriter::PrintfValue(const char* format, ...) {
@@ -351,6 +382,16 @@ void JSONWriter::AddEscapedUTF8String(const char* s, intptr_t len) {
   const uint8_t* s8 = reinterpret_cast<const uint8_t*>(s);
   intptr_t i = 0;
   for (; i < len;) {
+    // Copy runs of characters that need no escaping in bulk.
+    intptr_t run_end = i;
+    while ((run_end < len) && IsSafeJSONCharacter(s8[run_end])) {
+      run_end++;
+    }
+    if (run_end > i) {
+      buffer_.AddRaw(&s8[i], run_end - i);
+      i = run_end;
+      if (i == len) break;
+    }
     // Extract next UTF8 character.
     int32_t ch = 0;
     int32_t ch_len = Utf8::Decode(&s8[i], len - i, &ch);
@@ -374,6 +415,26 @@ bool JSONWriter::AddDartString(const String& s,
     count = length - offset;
   }
   intptr_t limit = offset + count;
+  if (s.IsOneByteString()) {
+    // Latin-1 has no surrogates, and its ASCII runs are copied in bulk.
+    NoSafepointScope no_safepoint;
+    const uint8_t* chars = OneByteString::DataStart(s);
+    intptr_t i = offset;
+    while (i < limit) {
+      intptr_t run_end = i;
+      while ((run_end < limit) && IsSafeJSONCharacter(chars[run_end])) {
+        run_end++;
+      }
+      if (run_end > i) {
+        buffer_.AddRaw(&chars[i], run_end - i);
+        i = run_end;
+      } else {
+        buffer_.EscapeAndAddCodeUnit(chars[i]);
+        i++;
+      }
+    }
+    return (offset > 0) || (limit < length);
+  }
   for (intptr_t i = offset; i < limit; i++) {
     uint16_t code_unit = s.CharAt(i);
     if (Utf16::IsTrailSurrogate(code_unit)) {
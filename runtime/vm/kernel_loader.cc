@@ -778,9 +778,15 @@ void KernelLoader::LoadLibrary(const Library& library) {
 
   const auto& uri = String::Handle(Z, library.url());
   const intptr_t num_libraries = program_->library_count();
+  if (library_uris_.is_empty()) {
+    // The bootstrapper loads libraries one at a time, so the URIs of all
+    // libraries in the component are read once instead of for every call.
+    for (intptr_t i = 0; i < num_libraries; ++i) {
+      library_uris_.Add(&LibraryUri(i));
+    }
+  }
   for (intptr_t i = 0; i < num_libraries; ++i) {
-    const String& library_uri = LibraryUri(i);
-    if (library_uri.Equals(uri)) {
+    if (library_uris_[i]->Equals(uri)) {
       LoadLibrary(i);
       return;
     }
@@ -452,6 +452,10 @@ class KernelLoader : public ValueObject {
   GrowableArray<const Function*> functions_;
   GrowableArray<const Field*> fields_;
 
+  // URIs of the libraries of the component, by library index. Filled on the
+  // first lookup of a library by URI.
+  GrowableArray<const String*> library_uris_;
+
   friend class BuildingTranslationHelper;
 
   DISALLOW_COPY_AND_ASSIGN(KernelLoader);
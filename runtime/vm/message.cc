@@ -105,7 +105,7 @@ const char* Message::PriorityAsString(Priority priority) {
   }
 }
 
-MessageQueue::MessageQueue() {
+MessageQueue::MessageQueue() : pending_(nullptr) {
   head_ = NULL;
   tail_ = NULL;
 }
@@ -122,6 +122,8 @@ void MessageQueue::Enqueue(std::unique_ptr<Message> msg0, bool before_events) {
 
   // Make sure messages are not reused.
   ASSERT(msg->next_ == NULL);
+  // Keep the order with messages posted concurrently before this one.
+  FlushPending();
   if (head_ == NULL) {
     // Only element in the queue.
     ASSERT(tail_ == NULL);
@@ -160,7 +162,47 @@ void MessageQueue::Enqueue(std::unique_ptr<Message> msg0, bool before_events) {
   }
 }
 
+bool MessageQueue::EnqueueConcurrent(std::unique_ptr<Message> msg0) {
+  Message* msg = msg0.release();
+
+  // Make sure messages are not reused.
+  ASSERT(msg->next_ == NULL);
+  Message* next = pending_.load(std::memory_order_relaxed);
+  do {
+    msg->next_ = next;
+  } while (!pending_.compare_exchange_weak(next, msg, std::memory_order_release,
+                                           std::memory_order_relaxed));
+  return next == nullptr;
+}
+
+void MessageQueue::FlushPending() {
+  Message* pending = pending_.exchange(nullptr, std::memory_order_acquire);
+  if (pending == nullptr) {
+    return;
+  }
+  // The pending messages are linked most recent first.
+  Message* last = pending;
+  Message* first = nullptr;
+  while (pending != nullptr) {
+    Message* next = pending->next_;
+    pending->next_ = first;
+    first = pending;
+    pending = next;
+  }
+  if (head_ == NULL) {
+    ASSERT(tail_ == NULL);
+    head_ = first;
+  } else {
+    ASSERT(tail_ != NULL);
+    tail_->next_ = first;
+  }
+  tail_ = last;
+}
+
 std::unique_ptr<Message> MessageQueue::Dequeue() {
+  if (head_ == nullptr) {
+    FlushPending();
+  }
   Message* result = head_;
   if (result != nullptr) {
     head_ = result->next_;
@@ -177,6 +219,7 @@ std::unique_ptr<Message> MessageQueue::Dequeue() {
 }
 
 void MessageQueue::Clear() {
+  FlushPending();
   std::unique_ptr<Message> cur(head_);
   head_ = nullptr;
   tail_ = nullptr;
@@ -223,6 +266,7 @@ intptr_t MessageQueue::Length() const {
 }
 
 Message* MessageQueue::FindMessageById(intptr_t id) {
+  FlushPending();
   MessageQueue::Iterator it(this);
   while (it.HasNext()) {
     Message* current = it.Next();
@@ -236,6 +280,7 @@ Message* MessageQueue::FindMessageById(intptr_t id) {
 
 void MessageQueue::PrintJSON(JSONStream* stream) {
 #ifndef PRODUCT
+  FlushPending();
   JSONArray messages(stream);
 
   Object& msg_handler = Object::Handle();
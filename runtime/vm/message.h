@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_MESSAGE_H_
 #define RUNTIME_VM_MESSAGE_H_
 
+#include <atomic>
 #include <memory>
 #include <utility>
 
@@ -127,6 +128,13 @@ class Message {
 
   intptr_t Id() const;
 
+#if !defined(PRODUCT)
+  // The time the message was posted to its handler, used to report how long
+  // messages wait in the queue.
+  int64_t post_time_micros() const { return post_time_micros_; }
+  void set_post_time_micros(int64_t value) { post_time_micros_ = value; }
+#endif
+
   static const char* PriorityAsString(Priority priority);
 
  private:
@@ -147,11 +155,17 @@ class Message {
   intptr_t snapshot_length_;
   MessageFinalizableData* finalizable_data_;
   Priority priority_;
+#if !defined(PRODUCT)
+  int64_t post_time_micros_ = 0;
+#endif
 
   DISALLOW_COPY_AND_ASSIGN(Message);
 };
 
 // There is a message queue per isolate.
+//
+// Except for [EnqueueConcurrent], the methods of the queue must be called
+// while holding the lock of its owner.
 class MessageQueue {
  public:
   MessageQueue();
@@ -159,11 +173,26 @@ class MessageQueue {
 
   void Enqueue(std::unique_ptr<Message> msg, bool before_events);
 
+  // Appends a message without holding the lock of the owner, so it can be
+  // called concurrently with all other methods. The messages posted this way
+  // are moved into the queue in one batch once the queue runs empty.
+  //
+  // Returns true if no other message posted this way was pending, in which
+  // case the caller is responsible for waking up the consumer.
+  bool EnqueueConcurrent(std::unique_ptr<Message> msg);
+
+  // Moves the messages posted with [EnqueueConcurrent] into the queue. The
+  // [Iterator] and [Length] only see messages that have been moved.
+  void FlushPending();
+
   // Gets the next message from the message queue or NULL if no
   // message is available.  This function will not block.
   std::unique_ptr<Message> Dequeue();
 
-  bool IsEmpty() { return head_ == NULL; }
+  bool IsEmpty() {
+    return (head_ == NULL) &&
+           (pending_.load(std::memory_order_relaxed) == nullptr);
+  }
 
   // Clear all messages from the message queue.
   void Clear();
@@ -196,6 +225,8 @@ class MessageQueue {
  private:
   Message* head_;
   Message* tail_;
+  // Messages posted with [EnqueueConcurrent], most recent first.
+  std::atomic<Message*> pending_;
 
   DISALLOW_COPY_AND_ASSIGN(MessageQueue);
 };
@@ -9,6 +9,7 @@
 #include "vm/dart.h"
 #include "vm/heap/safepoint.h"
 #include "vm/isolate.h"
+#include "vm/json_stream.h"
 #include "vm/lockers.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
@@ -19,6 +20,12 @@
 namespace dart {
 
 DECLARE_FLAG(bool, trace_service_pause_events);
+DEFINE_FLAG(int,
+            message_handler_time_slice_micros,
+            10000,
+            "Time after which a message handler running on a thread pool "
+            "yields its thread to other waiting handlers between two messages. "
+            "0 means never.");
 
 class MessageHandlerTask : public ThreadPool::Task {
  public:
@@ -118,43 +125,68 @@ void MessageHandler::Run(ThreadPool* pool,
   end_callback_ = end_callback;
   callback_data_ = data;
   task_running_ = true;
-  const bool launched_successfully = pool_->Run<MessageHandlerTask>(this);
+  const bool launched_successfully = RunTaskLocked();
   ASSERT(launched_successfully);
 }
 
+bool MessageHandler::RunTaskLocked() {
+  ASSERT(monitor_.IsOwnedByCurrentThread());
+  if (IsLatencySensitive()) {
+    return pool_->RunUrgent<MessageHandlerTask>(this);
+  }
+  return pool_->Run<MessageHandlerTask>(this);
+}
+
 void MessageHandler::PostMessage(std::unique_ptr<Message> message,
                                  bool before_events) {
-  Message::Priority saved_priority;
+  if (FLAG_trace_isolates) {
+    Isolate* source_isolate = Isolate::Current();
+    if (source_isolate != nullptr) {
+      OS::PrintErr(
+          "[>] Posting message:\n"
+          "\tlen:        %" Pd "\n\tsource:     (%" Pd64
+          ") %s\n\tdest:       %s\n"
+          "\tdest_port:  %" Pd64 "\n",
+          message->Size(), static_cast<int64_t>(source_isolate->main_port()),
+          source_isolate->name(), name(), message->dest_port());
+    } else {
+      OS::PrintErr(
+          "[>] Posting message:\n"
+          "\tlen:        %" Pd
+          "\n\tsource:     <native code>\n"
+          "\tdest:       %s\n"
+          "\tdest_port:  %" Pd64 "\n",
+          message->Size(), name(), message->dest_port());
+    }
+  }
 
-  {
+#if !defined(PRODUCT)
+  message->set_post_time_micros(OS::GetCurrentMonotonicMicros());
+  const intptr_t depth = queue_depth_.fetch_add(1) + 1;
+  intptr_t depth_max = queue_depth_max_;
+  while ((depth > depth_max) &&
+         !queue_depth_max_.compare_exchange_weak(depth_max, depth)) {
+  }
+#endif
+
+  const Message::Priority saved_priority = message->priority();
+  // Normal messages are appended without taking the monitor. Only the
+  // sender finding no other such message pending has to make sure that the
+  // messages get handled, any later ones are handled in the same batch.
+  bool wake_up_handler = true;
+  if (!message->IsOOB() && !before_events) {
+    wake_up_handler = queue_->EnqueueConcurrent(std::move(message));
+  }
+
+  if (wake_up_handler) {
     MonitorLocker ml(&monitor_);
-    if (FLAG_trace_isolates) {
-      Isolate* source_isolate = Isolate::Current();
-      if (source_isolate != nullptr) {
-        OS::PrintErr(
-            "[>] Posting message:\n"
-            "\tlen:        %" Pd "\n\tsource:     (%" Pd64
-            ") %s\n\tdest:       %s\n"
-            "\tdest_port:  %" Pd64 "\n",
-            message->Size(), static_cast<int64_t>(source_isolate->main_port()),
-            source_isolate->name(), name(), message->dest_port());
+    if (message != nullptr) {
+      if (message->IsOOB()) {
+        oob_queue_->Enqueue(std::move(message), before_events);
       } else {
-        OS::PrintErr(
-            "[>] Posting message:\n"
-            "\tlen:        %" Pd
-            "\n\tsource:     <native code>\n"
-            "\tdest:       %s\n"
-            "\tdest_port:  %" Pd64 "\n",
-            message->Size(), name(), message->dest_port());
+        queue_->Enqueue(std::move(message), before_events);
       }
     }
-
-    saved_priority = message->priority();
-    if (message->IsOOB()) {
-      oob_queue_->Enqueue(std::move(message), before_events);
-    } else {
-      queue_->Enqueue(std::move(message), before_events);
-    }
     if (paused_for_messages_) {
       ml.Notify();
     }
@@ -162,7 +194,7 @@ void MessageHandler::PostMessage(std::unique_ptr<Message> message,
     if (pool_ != nullptr && !task_running_) {
       ASSERT(!delete_me_);
       task_running_ = true;
-      const bool launched_successfully = pool_->Run<MessageHandlerTask>(this);
+      const bool launched_successfully = RunTaskLocked();
       ASSERT(launched_successfully);
     }
   }
@@ -178,6 +210,11 @@ std::unique_ptr<Message> MessageHandler::DequeueMessage(
   if ((message == nullptr) && (min_priority < Message::kOOBPriority)) {
     message = queue_->Dequeue();
   }
+#if !defined(PRODUCT)
+  if (message != nullptr) {
+    queue_depth_.fetch_sub(1);
+  }
+#endif
   return message;
 }
 
@@ -205,12 +242,26 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
   auto idle_time_handler =
       isolate() != nullptr ? isolate()->group()->idle_time_handler() : nullptr;
 
+  // Once its time slice is used up, a handler stops handling normal messages
+  // if other tasks are waiting for a thread of the pool (see TaskCallback).
+  const int64_t slice_end =
+      (allow_multiple_normal_messages && (pool_ != nullptr) &&
+       (FLAG_message_handler_time_slice_micros > 0))
+          ? OS::GetCurrentMonotonicMicros() +
+                FLAG_message_handler_time_slice_micros
+          : 0;
+
   MessageStatus max_status = kOK;
   Message::Priority min_priority =
       ((allow_normal_messages && !paused()) ? Message::kNormalPriority
                                             : Message::kOOBPriority);
   std::unique_ptr<Message> message = DequeueMessage(min_priority);
   while (message != nullptr) {
+#if !defined(PRODUCT)
+    const int64_t start_micros = OS::GetCurrentMonotonicMicros();
+    queueing_delay_[message->priority()].Add(start_micros -
+                                             message->post_time_micros());
+#endif
     intptr_t message_len = message->Size();
     if (FLAG_trace_isolates) {
       OS::PrintErr(
@@ -236,6 +287,9 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
       max_status = status;
     }
     ml->Enter();
+#if !defined(PRODUCT)
+    handling_time_.Add(OS::GetCurrentMonotonicMicros() - start_micros);
+#endif
     if (FLAG_trace_isolates) {
       OS::PrintErr(
           "[.] Message handled (%s):\n"
@@ -266,6 +320,11 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
         !allow_multiple_normal_messages) {
       // We processed one normal message.  Allow no more.
       allow_normal_messages = false;
+    } else if ((saved_priority == Message::kNormalPriority) &&
+               (slice_end != 0) &&
+               (OS::GetCurrentMonotonicMicros() >= slice_end) &&
+               pool_->HasTasksWaitingToRun()) {
+      allow_normal_messages = false;
     }
 
     // Reevaluate the minimum allowable priority.  The paused state
@@ -343,6 +402,46 @@ MessageHandler::MessageStatus MessageHandler::HandleOOBMessages() {
 }
 
 #if !defined(PRODUCT)
+static void PrintHistogramJSON(JSONObject* jsobj, const Histogram& histogram) {
+  jsobj->AddProperty64("count", histogram.count());
+  jsobj->AddProperty64("totalMicros", histogram.total());
+  jsobj->AddProperty64("maxMicros", histogram.max());
+  jsobj->AddProperty64("p50Micros", histogram.Percentile(50.0));
+  jsobj->AddProperty64("p90Micros", histogram.Percentile(90.0));
+  jsobj->AddProperty64("p99Micros", histogram.Percentile(99.0));
+}
+
+void MessageHandler::PrintMessageMetricsJSON(JSONObject* jsobj) {
+  MonitorLocker ml(&monitor_);
+  {
+    JSONArray delays(jsobj, "queueingDelays");
+    for (intptr_t i = Message::kFirstPriority; i < Message::kNumPriorities;
+         i++) {
+      const Message::Priority priority = static_cast<Message::Priority>(i);
+      JSONObject entry(&delays);
+      entry.AddProperty("type", "_QueueingDelay");
+      entry.AddProperty("priority", Message::PriorityAsString(priority));
+      PrintHistogramJSON(&entry, queueing_delay_[priority]);
+    }
+  }
+  {
+    JSONObject handling(jsobj, "handlingTime");
+    handling.AddProperty("type", "_HandlingTime");
+    PrintHistogramJSON(&handling, handling_time_);
+  }
+  jsobj->AddProperty64("queueDepthMax", queue_depth_max_);
+}
+
+int64_t MessageHandler::MessageLatencyPercentile(double percentile) {
+  MonitorLocker ml(&monitor_);
+  return queueing_delay_[Message::kNormalPriority].Percentile(percentile);
+}
+
+int64_t MessageHandler::MessageHandlingPercentile(double percentile) {
+  MonitorLocker ml(&monitor_);
+  return handling_time_.Percentile(percentile);
+}
+
 bool MessageHandler::ShouldPauseOnStart(MessageStatus status) const {
   Isolate* owning_isolate = isolate();
   if (owning_isolate == NULL) {
@@ -444,6 +543,15 @@ void MessageHandler::TaskCallback() {
       }
     }
 
+    // A handler which used up its time slice with messages left goes to the
+    // back of the queue of the thread pool, keeping [task_running_] set for
+    // the new task.
+    if ((status == kOK) && HasLivePorts() && !paused() && (pool_ != nullptr) &&
+        !queue_->IsEmpty() && pool_->Run<MessageHandlerTask>(this)) {
+      ASSERT(oob_queue_->IsEmpty());
+      return;
+    }
+
     // The isolate exits when it encounters an error or when it no
     // longer has live ports.
     if (status != kOK || !HasLivePorts()) {
@@ -536,6 +644,9 @@ void MessageHandler::CloseAllPorts() {
   }
   queue_->Clear();
   oob_queue_->Clear();
+#if !defined(PRODUCT)
+  queue_depth_ = 0;
+#endif
 }
 
 void MessageHandler::RequestDeletion() {
@@ -641,6 +752,7 @@ MessageHandler::AcquiredQueues::AcquiredQueues(MessageHandler* handler)
     : handler_(handler), ml_(&handler->monitor_) {
   ASSERT(handler != NULL);
   handler_->oob_message_handling_allowed_ = false;
+  handler_->queue_->FlushPending();
 }
 
 MessageHandler::AcquiredQueues::~AcquiredQueues() {
@@ -16,6 +16,8 @@
 
 namespace dart {
 
+class JSONObject;
+
 // A MessageHandler is an entity capable of accepting messages.
 class MessageHandler {
  protected:
@@ -113,6 +115,17 @@ class MessageHandler {
   // Timestamp of the paused on start or paused on exit.
   int64_t paused_timestamp() const { return paused_timestamp_; }
 
+  // Adds the time messages waited in the queue before being handled, the time
+  // handling them took and the most messages that were queued at once.
+  void PrintMessageMetricsJSON(JSONObject* jsobj);
+
+  // Percentiles, in microseconds, of the time normal messages waited in the
+  // queue and of the time handling a message took.
+  int64_t MessageLatencyPercentile(double percentile);
+  int64_t MessageHandlingPercentile(double percentile);
+
+  intptr_t queue_depth_max() const { return queue_depth_max_; }
+
   bool ShouldPauseOnStart(MessageStatus status) const;
   bool ShouldPauseOnExit(MessageStatus status) const;
   void PausedOnStart(bool paused);
@@ -193,6 +206,11 @@ class MessageHandler {
   void decrement_live_ports();
   // ------------ END PortMap API ------------
 
+  // Whether the tasks of this handler are run ahead of the tasks of other
+  // handlers waiting for a thread of the pool. Optionally overridden by
+  // subclass.
+  virtual bool IsLatencySensitive() const { return false; }
+
   // Custom message notification.  Optionally provided by subclass.
   virtual void MessageNotify(Message::Priority priority);
 
@@ -225,6 +243,9 @@ class MessageHandler {
   // scheduled.
   bool CheckIfIdleLocked(MonitorLocker* ml);
 
+  // Schedules a task handling the messages of this handler on the pool.
+  bool RunTaskLocked();
+
   // Triggers a run of the idle task.
   void RunIdleTaskLocked(MonitorLocker* ml);
 
@@ -261,6 +282,14 @@ class MessageHandler {
   bool is_paused_on_start_;
   bool is_paused_on_exit_;
   int64_t paused_timestamp_;
+
+  // Time the handled messages waited in the queue, by priority, and the time
+  // handling them took.
+  Histogram queueing_delay_[Message::kNumPriorities];
+  Histogram handling_time_;
+  // Messages posted and not yet dequeued, and the most there have been.
+  RelaxedAtomic<intptr_t> queue_depth_ = 0;
+  RelaxedAtomic<intptr_t> queue_depth_max_ = 0;
 #endif
   bool task_running_;
   bool delete_me_;
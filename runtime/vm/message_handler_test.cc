@@ -10,6 +10,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, message_handler_time_slice_micros);
+
 class MessageHandlerTestPeer {
  public:
   explicit MessageHandlerTestPeer(MessageHandler* handler)
@@ -27,6 +29,18 @@ class MessageHandlerTestPeer {
   MessageQueue* queue() const { return handler_->queue_; }
   MessageQueue* oob_queue() const { return handler_->oob_queue_; }
 
+#if !defined(PRODUCT)
+  int64_t queueing_delay_count(Message::Priority priority) const {
+    return handler_->queueing_delay_[priority].count();
+  }
+  int64_t queueing_delay_max_micros(Message::Priority priority) const {
+    return handler_->queueing_delay_[priority].max();
+  }
+  int64_t handling_time_count() const {
+    return handler_->handling_time_.count();
+  }
+#endif
+
  private:
   MessageHandler* handler_;
 
@@ -249,6 +263,28 @@ VM_UNIT_TEST_CASE(MessageHandler_HandleNextMessage) {
   EXPECT_EQ(port1, ports[2]);
 }
 
+#if !defined(PRODUCT)
+VM_UNIT_TEST_CASE(MessageHandler_QueueingDelay) {
+  TestMessageHandler handler;
+  MessageHandlerTestPeer handler_peer(&handler);
+  Dart_Port port = PortMap::CreatePort(&handler);
+  handler_peer.PostMessage(BlankMessage(port, Message::kNormalPriority));
+  handler_peer.PostMessage(BlankMessage(port, Message::kOOBPriority));
+  handler_peer.PostMessage(BlankMessage(port, Message::kOOBPriority));
+  OS::Sleep(1);
+
+  EXPECT_EQ(MessageHandler::kOK, handler.HandleNextMessage());
+  EXPECT_EQ(3, handler.message_count());
+  EXPECT_EQ(1, handler_peer.queueing_delay_count(Message::kNormalPriority));
+  EXPECT_EQ(2, handler_peer.queueing_delay_count(Message::kOOBPriority));
+  EXPECT_LE(1000,
+            handler_peer.queueing_delay_max_micros(Message::kNormalPriority));
+  EXPECT_LE(1000, handler.MessageLatencyPercentile(99.0));
+  EXPECT_EQ(3, handler_peer.handling_time_count());
+  EXPECT_EQ(3, handler.queue_depth_max());
+}
+#endif  // !defined(PRODUCT)
+
 VM_UNIT_TEST_CASE(MessageHandler_HandleNextMessage_ProcessOOBAfterError) {
   TestMessageHandler handler;
   MessageHandler::MessageStatus results[] = {
@@ -409,4 +445,89 @@ VM_UNIT_TEST_CASE(MessageHandler_Run) {
   OSThread::Join(info.join_id);
 }
 
+// Records the order in which messages are handled by several handlers.
+class OrderedMessageHandler : public MessageHandler {
+ public:
+  OrderedMessageHandler(Monitor* monitor,
+                        MallocGrowableArray<Dart_Port>* order,
+                        int64_t handle_micros)
+      : monitor_(monitor), order_(order), handle_micros_(handle_micros) {}
+
+  ~OrderedMessageHandler() { PortMap::ClosePorts(this); }
+
+  MessageStatus HandleMessage(std::unique_ptr<Message> message) {
+    OS::SleepMicros(handle_micros_);
+    MonitorLocker ml(monitor_);
+    order_->Add(message->dest_port());
+    ml.NotifyAll();
+    return kOK;
+  }
+
+ private:
+  Monitor* monitor_;
+  MallocGrowableArray<Dart_Port>* order_;
+  int64_t handle_micros_;
+
+  DISALLOW_COPY_AND_ASSIGN(OrderedMessageHandler);
+};
+
+struct BlockedStart {
+  Monitor monitor;
+  bool released = false;
+};
+
+static MessageHandler::MessageStatus WaitForRelease(uword data) {
+  BlockedStart* start = reinterpret_cast<BlockedStart*>(data);
+  MonitorLocker ml(&start->monitor);
+  while (!start->released) {
+    ml.Wait();
+  }
+  return MessageHandler::kOK;
+}
+
+VM_UNIT_TEST_CASE(MessageHandler_YieldTimeSlice) {
+  SetFlagScope<int> sfs(&FLAG_message_handler_time_slice_micros, 1);
+  Monitor monitor;
+  MallocGrowableArray<Dart_Port> order;
+  BlockedStart start;
+  OrderedMessageHandler busy(&monitor, &order, 1000);
+  OrderedMessageHandler other(&monitor, &order, 0);
+  // A single worker, so the handlers have to take turns.
+  ThreadPool pool(1);
+  MessageHandlerTestPeer busy_peer(&busy);
+  MessageHandlerTestPeer other_peer(&other);
+  busy_peer.increment_live_ports();
+  other_peer.increment_live_ports();
+
+  Dart_Port busy_port = PortMap::CreatePort(&busy);
+  Dart_Port other_port = PortMap::CreatePort(&other);
+  for (intptr_t i = 0; i < 3; i++) {
+    busy_peer.PostMessage(BlankMessage(busy_port, Message::kNormalPriority));
+  }
+  other_peer.PostMessage(BlankMessage(other_port, Message::kNormalPriority));
+
+  // Keep the worker busy until the task of the other handler is waiting.
+  busy.Run(&pool, WaitForRelease, nullptr, reinterpret_cast<uword>(&start));
+  other.Run(&pool, nullptr, nullptr, 0);
+  {
+    MonitorLocker ml(&start.monitor);
+    start.released = true;
+    ml.Notify();
+  }
+
+  {
+    MonitorLocker ml(&monitor);
+    while (order.length() < 4) {
+      ml.Wait();
+    }
+  }
+  // The busy handler yields the worker after its first message.
+  EXPECT_EQ(busy_port, order[0]);
+  EXPECT_EQ(other_port, order[1]);
+  EXPECT_EQ(busy_port, order[2]);
+  EXPECT_EQ(busy_port, order[3]);
+  busy_peer.decrement_live_ports();
+  other_peer.decrement_live_ports();
+}
+
 }  // namespace dart
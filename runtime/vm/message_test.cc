@@ -118,6 +118,55 @@ TEST_CASE(MessageQueue_BasicOperations) {
   EXPECT(queue.IsEmpty());
 }
 
+TEST_CASE(MessageQueue_EnqueueConcurrent) {
+  MessageQueue queue;
+  Dart_Port port = 1;
+
+  const char* str1 = "msg1";
+  const char* str2 = "msg2";
+  const char* str3 = "msg3";
+  const char* str4 = "msg4";
+
+  std::unique_ptr<Message> msg;
+  msg = Message::New(port, AllocMsg(str1), strlen(str1) + 1, nullptr,
+                     Message::kNormalPriority);
+  queue.Enqueue(std::move(msg), false);
+
+  // Only the first concurrently enqueued message has to wake up the
+  // consumer.
+  msg = Message::New(port, AllocMsg(str2), strlen(str2) + 1, nullptr,
+                     Message::kNormalPriority);
+  EXPECT(queue.EnqueueConcurrent(std::move(msg)));
+  msg = Message::New(port, AllocMsg(str3), strlen(str3) + 1, nullptr,
+                     Message::kNormalPriority);
+  EXPECT(!queue.EnqueueConcurrent(std::move(msg)));
+  EXPECT(!queue.IsEmpty());
+  EXPECT(queue.Length() == 1);
+
+  // A regular enqueue keeps the order with the pending messages.
+  msg = Message::New(port, AllocMsg(str4), strlen(str4) + 1, nullptr,
+                     Message::kNormalPriority);
+  queue.Enqueue(std::move(msg), false);
+  EXPECT(queue.Length() == 4);
+
+  const char* expected[] = {str1, str2, str3, str4};
+  for (intptr_t i = 0; i < 4; i++) {
+    msg = queue.Dequeue();
+    EXPECT(msg != nullptr);
+    EXPECT_STREQ(expected[i], reinterpret_cast<char*>(msg->snapshot()));
+  }
+  EXPECT(queue.IsEmpty());
+
+  // Pending messages are picked up once the queue runs empty.
+  msg = Message::New(port, AllocMsg(str1), strlen(str1) + 1, nullptr,
+                     Message::kNormalPriority);
+  EXPECT(queue.EnqueueConcurrent(std::move(msg)));
+  msg = queue.Dequeue();
+  EXPECT(msg != nullptr);
+  EXPECT_STREQ(str1, reinterpret_cast<char*>(msg->snapshot()));
+  EXPECT(queue.IsEmpty());
+}
+
 TEST_CASE(MessageQueue_Clear) {
   MessageQueue queue;
   Dart_Port port1 = 1;
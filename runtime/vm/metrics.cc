@@ -4,12 +4,16 @@
 
 #include "vm/metrics.h"
 
+#include <math.h>
+
 #include "vm/isolate.h"
 #include "vm/json_stream.h"
 #include "vm/log.h"
+#include "vm/message_handler.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/runtime_entry.h"
+#include "vm/zone.h"
 
 namespace dart {
 
@@ -171,6 +175,14 @@ int64_t MetricHeapNewExternal::Value() const {
   return isolate_group()->heap()->ExternalInWords(Heap::kNew) * kWordSize;
 }
 
+int64_t MetricGCScavengeTimeP99::Value() const {
+  return isolate_group()->heap()->ScavengePausePercentile(99.0);
+}
+
+int64_t MetricGCOldTimeP99::Value() const {
+  return isolate_group()->heap()->OldPausePercentile(99.0);
+}
+
 int64_t MetricHeapUsed::Value() const {
   ASSERT(isolate_group() == IsolateGroup::Current());
   return isolate_group()->heap()->UsedInWords(Heap::kNew) * kWordSize +
@@ -189,6 +201,29 @@ int64_t MetricCurrentRSS::Value() const {
 int64_t MetricPeakRSS::Value() const {
   return Service::MaxRSS();
 }
+
+int64_t MetricZoneSize::Value() const {
+  return Zone::Size();
+}
+
+int64_t MetricZoneCached::Value() const {
+  return Zone::CachedSegmentsSize();
+}
+
+int64_t MetricMessageLatencyP99::Value() const {
+  MessageHandler* handler = isolate()->message_handler();
+  return (handler == nullptr) ? 0 : handler->MessageLatencyPercentile(99.0);
+}
+
+int64_t MetricMessageHandlingP99::Value() const {
+  MessageHandler* handler = isolate()->message_handler();
+  return (handler == nullptr) ? 0 : handler->MessageHandlingPercentile(99.0);
+}
+
+int64_t MetricMessageQueueDepthMax::Value() const {
+  MessageHandler* handler = isolate()->message_handler();
+  return (handler == nullptr) ? 0 : handler->queue_depth_max();
+}
 #endif  // !defined(PRODUCT)
 
 #if !defined(PRODUCT)
@@ -221,6 +256,57 @@ void Metric::Cleanup() {
 
 #endif  // !defined(PRODUCT)
 
+intptr_t Histogram::BucketIndex(int64_t value) {
+  ASSERT(value >= 0);
+  if (value < kSubBuckets) {
+    return value;
+  }
+  const intptr_t high_bit = Utils::HighestBit(value);
+  if (high_bit >= kMaxValueBits) {
+    return kNumBuckets - 1;
+  }
+  const intptr_t shift = high_bit - kSubBucketBits;
+  const intptr_t sub_bucket = (value >> shift) & (kSubBuckets - 1);
+  return (shift + 1) * kSubBuckets + sub_bucket;
+}
+
+int64_t Histogram::BucketUpperBound(intptr_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const intptr_t shift = index / kSubBuckets - 1;
+  const int64_t sub_bucket = index % kSubBuckets;
+  return ((kSubBuckets + sub_bucket + 1) << shift) - 1;
+}
+
+void Histogram::Add(int64_t value) {
+  if (value < 0) {
+    value = 0;
+  }
+  counts_[BucketIndex(value)]++;
+  count_++;
+  total_ += value;
+  if (value > max_) {
+    max_ = value;
+  }
+}
+
+int64_t Histogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  int64_t rank = static_cast<int64_t>(ceil(count_ * percentile / 100.0));
+  rank = Utils::Maximum<int64_t>(rank, 1);
+  int64_t seen = 0;
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return Utils::Minimum(BucketUpperBound(i), max_);
+    }
+  }
+  return max_;
+}
+
 MaxMetric::MaxMetric() : Metric() {
   set_value(kMinInt64);
 }
@@ -26,17 +26,40 @@ class JSONStream;
   V(MaxMetric, HeapNewCapacityMax, "heap.new.capacity.max", kByte)             \
   V(MetricHeapNewExternal, HeapNewExternal, "heap.new.external", kByte)        \
   V(MetricHeapUsed, HeapGlobalUsed, "heap.global.used", kByte)                 \
-  V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)
+  V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)               \
+  V(Metric, SafepointCount, "safepoint.count", kCounter)                       \
+  V(Metric, SafepointLatency, "safepoint.latency", kMicrosecond)               \
+  V(MaxMetric, SafepointLatencyMax, "safepoint.latency.max", kMicrosecond)   \
+  V(Metric, GCScavengeCount, "gc.scavenge.count", kCounter)                    \
+  V(Metric, GCScavengeTime, "gc.scavenge.time", kMicrosecond)                  \
+  V(MaxMetric, GCScavengeTimeMax, "gc.scavenge.time.max", kMicrosecond)        \
+  V(MetricGCScavengeTimeP99, GCScavengeTimeP99, "gc.scavenge.time.p99",        \
+    kMicrosecond)                                                              \
+  V(Metric, GCScavengeCopied, "gc.scavenge.copied", kByte)                     \
+  V(Metric, GCScavengePromoted, "gc.scavenge.promoted", kByte)                 \
+  V(Metric, GCOldCount, "gc.old.count", kCounter)                              \
+  V(Metric, GCOldTime, "gc.old.time", kMicrosecond)                            \
+  V(MaxMetric, GCOldTimeMax, "gc.old.time.max", kMicrosecond)                  \
+  V(MetricGCOldTimeP99, GCOldTimeP99, "gc.old.time.p99", kMicrosecond)         \
+  V(Metric, GCOldBarrierMarked, "gc.old.barrier.marked", kCounter)
 
 // Metrics for each isolate.
 #define ISOLATE_METRIC_LIST(V)                                                 \
   V(Metric, RunnableLatency, "isolate.runnable.latency", kMicrosecond)         \
-  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)
+  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)                  \
+  V(MetricMessageLatencyP99, MessageLatencyP99,                                \
+    "isolate.message.latency.p99", kMicrosecond)                               \
+  V(MetricMessageHandlingP99, MessageHandlingP99,                              \
+    "isolate.message.handling.p99", kMicrosecond)                              \
+  V(MetricMessageQueueDepthMax, MessageQueueDepthMax,                          \
+    "isolate.message.queue.depth.max", kCounter)
 
 #define VM_METRIC_LIST(V)                                                      \
   V(MetricIsolateCount, IsolateCount, "vm.isolate.count", kCounter)            \
   V(MetricCurrentRSS, CurrentRSS, "vm.memory.current", kByte)                  \
-  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)
+  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)                            \
+  V(MetricZoneSize, ZoneSize, "vm.memory.zone", kByte)                         \
+  V(MetricZoneCached, ZoneCached, "vm.memory.zone.cached", kByte)
 
 class Metric {
  public:
@@ -84,6 +107,7 @@ class Metric {
   void set_value(int64_t value) { value_ = value; }
 
   void increment() { value_++; }
+  void add(int64_t delta) { value_ += delta; }
 
   const char* name() const { return name_; }
   const char* description() const { return description_; }
@@ -131,6 +155,45 @@ class MinMetric : public Metric {
   void SetValue(int64_t new_value);
 };
 
+// A histogram of non-negative values in the style of HDR histograms. Values
+// are bucketed by their highest set bit, and each such range is split into
+// kSubBuckets linear buckets, so percentiles are reported to within 1/8 of
+// the recorded value in a fixed, small amount of memory. Values of
+// 2^kMaxValueBits or more are counted in the last bucket.
+//
+// Not thread safe.
+class Histogram {
+ public:
+  Histogram() { memset(counts_, 0, sizeof(counts_)); }
+
+  void Add(int64_t value);
+
+  int64_t count() const { return count_; }
+  int64_t total() const { return total_; }
+  int64_t max() const { return max_; }
+
+  // Returns an upper bound of the smallest value that is at least as large as
+  // |percentile| percent of the values, or 0 if there are no values.
+  int64_t Percentile(double percentile) const;
+
+ private:
+  static const intptr_t kSubBucketBits = 3;
+  static const intptr_t kSubBuckets = 1 << kSubBucketBits;
+  static const intptr_t kMaxValueBits = 36;
+  static const intptr_t kNumBuckets =
+      (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+  static intptr_t BucketIndex(int64_t value);
+  static int64_t BucketUpperBound(intptr_t index);
+
+  uint32_t counts_[kNumBuckets];
+  int64_t count_ = 0;
+  int64_t total_ = 0;
+  int64_t max_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(Histogram);
+};
+
 class MetricHeapOldUsed : public Metric {
  public:
   virtual int64_t Value() const;
@@ -161,6 +224,16 @@ class MetricHeapNewExternal : public Metric {
   virtual int64_t Value() const;
 };
 
+class MetricGCScavengeTimeP99 : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricGCOldTimeP99 : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
 #if !defined(PRODUCT)
 class MetricIsolateCount : public Metric {
  public:
@@ -176,6 +249,31 @@ class MetricPeakRSS : public Metric {
  public:
   virtual int64_t Value() const;
 };
+
+class MetricZoneSize : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricZoneCached : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricMessageLatencyP99 : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricMessageHandlingP99 : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricMessageQueueDepthMax : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
 #endif  // !defined(PRODUCT)
 
 class MetricHeapUsed : public Metric {
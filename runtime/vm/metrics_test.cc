@@ -77,6 +77,29 @@ VM_UNIT_TEST_CASE(Metric_OnDemand) {
 }
 #endif  // !defined(PRODUCT)
 
+VM_UNIT_TEST_CASE(Metric_Histogram) {
+  Histogram histogram;
+  EXPECT_EQ(0, histogram.Percentile(99.0));
+
+  for (intptr_t i = 1; i <= 100; i++) {
+    histogram.Add(i);
+  }
+  histogram.Add(1000);
+  EXPECT_EQ(101, histogram.count());
+  EXPECT_EQ(6050, histogram.total());
+  EXPECT_EQ(1000, histogram.max());
+
+  // Values below 8 are exact, larger ones are rounded up to within 1/8.
+  EXPECT_EQ(6, histogram.Percentile(5.0));
+  const int64_t p50 = histogram.Percentile(50.0);
+  EXPECT_LE(51, p50);
+  EXPECT_GE(51 + 51 / 8, p50);
+  const int64_t p99 = histogram.Percentile(99.0);
+  EXPECT_LE(100, p99);
+  EXPECT_GE(100 + 100 / 8, p99);
+  EXPECT_EQ(1000, histogram.Percentile(100.0));
+}
+
 ISOLATE_UNIT_TEST_CASE(Metric_EmbedderAPI) {
   {
     TransitionVMToNative transition(Thread::Current());
@@ -166,4 +189,38 @@ ISOLATE_UNIT_TEST_CASE(Metric_SetGCEventCallback) {
   EXPECT_STREQ("low memory", last_gcevent_reason);
 }
 
+ISOLATE_UNIT_TEST_CASE(Metric_GCStatistics) {
+  IsolateGroup* isolate_group = IsolateGroup::Current();
+  const int64_t scavenges_before =
+      isolate_group->GetGCScavengeCountMetric()->value();
+  const int64_t old_before = isolate_group->GetGCOldCountMetric()->value();
+
+  String::New("<land-in-new-space>", Heap::kNew);
+  MetricsTestHelper::Scavenge(Thread::Current());
+  Isolate::Current()->heap()->CollectAllGarbage(Heap::kDebugging);
+
+  {
+    TransitionVMToNative transition(Thread::Current());
+
+    Dart_Isolate isolate = Dart_CurrentIsolate();
+    Dart_GCStatistics stats;
+    Dart_GetGCStatistics(isolate, &stats);
+    EXPECT_LE(scavenges_before + 1, stats.scavenge_count);
+    EXPECT_LE(old_before + 1, stats.old_count);
+    EXPECT_EQ(stats.scavenge_count,
+              Dart_IsolateGCScavengeCountMetric(isolate));
+    EXPECT_EQ(stats.old_count, Dart_IsolateGCOldCountMetric(isolate));
+    EXPECT_EQ(stats.scavenge_pause.total,
+              Dart_IsolateGCScavengeTimeMetric(isolate));
+    EXPECT_EQ(stats.old_pause.total, Dart_IsolateGCOldTimeMetric(isolate));
+    EXPECT_LE(stats.scavenge_pause.p50, stats.scavenge_pause.p99);
+    EXPECT_LE(stats.scavenge_pause.p99, stats.scavenge_pause.max);
+    EXPECT_LE(stats.old_pause.p99, stats.old_pause.max);
+    EXPECT_LE(stats.scavenge_pause.max,
+              Dart_IsolateGCScavengeTimeMaxMetric(isolate));
+    EXPECT_LE(0, stats.old_mark);
+    EXPECT_LE(0, stats.old_sweep);
+  }
+}
+
 }  // namespace dart
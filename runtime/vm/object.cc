@@ -58,6 +58,7 @@
 #include "vm/tags.h"
 #include "vm/thread_registry.h"
 #include "vm/timeline.h"
+#include "vm/transferable_buffer_pool.h"
 #include "vm/type_testing_stubs.h"
 #include "vm/zone_text_buffer.h"
 
@@ -91,6 +92,12 @@ DEFINE_FLAG(bool,
             remove_script_timestamps_for_test,
             false,
             "Remove script timestamps to allow for deterministic testing.");
+DEFINE_FLAG(bool,
+            segregate_optimized_code,
+            false,
+            "Allocate the instructions of optimized code on executable pages "
+            "of their own, so that hot code is not interleaved with cold "
+            "unoptimized code.");
 
 DECLARE_FLAG(bool, dual_map_code);
 DECLARE_FLAG(bool, intrinsify);
@@ -2543,6 +2550,27 @@ ObjectPtr Object::Allocate(intptr_t cls_id, intptr_t size, Heap::Space space) {
   Heap* heap = thread->heap();
 
   uword address = heap->Allocate(size, space);
+  return InitializeAllocation(thread, address, cls_id, size);
+}
+
+ObjectPtr Object::Allocate(intptr_t cls_id,
+                           intptr_t size,
+                           HeapBulkAllocator* allocator) {
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+  Thread* thread = Thread::Current();
+  ASSERT(thread->execution_state() == Thread::kThreadInVM);
+  ASSERT(thread->no_safepoint_scope_depth() == 0);
+  ASSERT(thread->no_callback_scope_depth() == 0);
+
+  uword address = allocator->Allocate(size);
+  return InitializeAllocation(thread, address, cls_id, size);
+}
+
+ObjectPtr Object::InitializeAllocation(Thread* thread,
+                                       uword address,
+                                       intptr_t cls_id,
+                                       intptr_t size) {
+  Heap* heap = thread->heap();
   if (UNLIKELY(address == 0)) {
     // SuspendLongJumpScope during Dart entry ensures that if a longjmp base is
     // available, it is the innermost error handler, so check for a longjmp base
@@ -2572,6 +2600,11 @@ ObjectPtr Object::Allocate(intptr_t cls_id, intptr_t size, Heap::Space space) {
   InitializeObject(address, cls_id, size);
   ObjectPtr raw_obj = static_cast<ObjectPtr>(address + kHeapObjectTag);
   ASSERT(cls_id == ObjectLayout::ClassIdTag::decode(raw_obj->ptr()->tags_));
+#ifndef PRODUCT
+  if (UNLIKELY(thread->heap_sample_pending())) {
+    heap->sampler()->RecordSample(thread, raw_obj);
+  }
+#endif  // !PRODUCT
   if (raw_obj->IsOldObject() && UNLIKELY(thread->is_marking())) {
     // Black allocation. Prevents a data race between the mutator and concurrent
     // marker on ARM and ARM64 (the marker may observe a publishing store of
@@ -6367,45 +6400,78 @@ TypeArgumentsPtr TypeArguments::InstantiateFrom(
   return instantiated_array.raw();
 }
 
+// Searches the instantiations cache of a type argument vector for the given
+// instantiators. Returns true and sets 'result' if found. Otherwise returns
+// false and sets 'sentinel_index' to the position of the kNoInstantiator
+// marker. Note that a cached result may be the null vector.
+//
+// This does not require the type arguments canonicalization mutex: new entries
+// are published by a store-release of their instantiator type arguments (see
+// TypeArguments::InstantiateAndCanonicalizeFrom), which is matched here by a
+// load-acquire.
+static bool LookupInstantiation(
+    const Array& instantiations,
+    const TypeArguments& instantiator_type_arguments,
+    const TypeArguments& function_type_arguments,
+    TypeArguments* result,
+    intptr_t* sentinel_index) {
+  // The instantiations cache is initialized with Object::zero_array() and is
+  // therefore guaranteed to contain kNoInstantiator. No length check needed.
+  ASSERT(instantiations.Length() > 0);  // Always at least a sentinel.
+  intptr_t index = 0;
+  while (true) {
+    const ObjectPtr instantiator = instantiations.AtAcquire(
+        index + TypeArguments::Instantiation::kInstantiatorTypeArgsIndex);
+    if ((instantiator == instantiator_type_arguments.raw()) &&
+        (instantiations.At(
+             index + TypeArguments::Instantiation::kFunctionTypeArgsIndex) ==
+         function_type_arguments.raw())) {
+      *result ^= instantiations.At(
+          index + TypeArguments::Instantiation::kInstantiatedTypeArgsIndex);
+      return true;
+    }
+    if (instantiator == Smi::New(TypeArguments::kNoInstantiator)) {
+      break;
+    }
+    index += TypeArguments::Instantiation::kSizeInWords;
+  }
+  *sentinel_index = index;
+  return false;
+}
+
 TypeArgumentsPtr TypeArguments::InstantiateAndCanonicalizeFrom(
     const TypeArguments& instantiator_type_arguments,
     const TypeArguments& function_type_arguments) const {
   auto thread = Thread::Current();
   auto zone = thread->zone();
-  SafepointMutexLocker ml(
-      thread->isolate_group()->type_arguments_canonicalization_mutex());
 
   ASSERT(!IsInstantiated());
   ASSERT(instantiator_type_arguments.IsNull() ||
          instantiator_type_arguments.IsCanonical());
   ASSERT(function_type_arguments.IsNull() ||
          function_type_arguments.IsCanonical());
-  // Lookup instantiators and if found, return instantiated result.
+  // Lookup instantiators and if found, return instantiated result. Try first
+  // without holding the mutex, so that mutators hitting the cache concurrently
+  // do not contend on it.
   Array& prior_instantiations = Array::Handle(zone, instantiations());
   ASSERT(!prior_instantiations.IsNull() && prior_instantiations.IsArray());
-  // The instantiations cache is initialized with Object::zero_array() and is
-  // therefore guaranteed to contain kNoInstantiator. No length check needed.
-  ASSERT(prior_instantiations.Length() > 0);  // Always at least a sentinel.
+  TypeArguments& result = TypeArguments::Handle(zone);
   intptr_t index = 0;
-  while (true) {
-    if ((prior_instantiations.At(
-             index +
-             TypeArguments::Instantiation::kInstantiatorTypeArgsIndex) ==
-         instantiator_type_arguments.raw()) &&
-        (prior_instantiations.At(
-             index + TypeArguments::Instantiation::kFunctionTypeArgsIndex) ==
-         function_type_arguments.raw())) {
-      return TypeArguments::RawCast(prior_instantiations.At(
-          index + TypeArguments::Instantiation::kInstantiatedTypeArgsIndex));
-    }
-    if (prior_instantiations.At(index) ==
-        Smi::New(TypeArguments::kNoInstantiator)) {
-      break;
-    }
-    index += TypeArguments::Instantiation::kSizeInWords;
+  if (LookupInstantiation(prior_instantiations, instantiator_type_arguments,
+                          function_type_arguments, &result, &index)) {
+    return result.raw();
+  }
+
+  SafepointMutexLocker ml(
+      thread->isolate_group()->type_arguments_canonicalization_mutex());
+  // Another mutator may have added the entry (or grown the array) before we
+  // acquired the mutex, so look again.
+  prior_instantiations = instantiations();
+  if (LookupInstantiation(prior_instantiations, instantiator_type_arguments,
+                          function_type_arguments, &result, &index)) {
+    return result.raw();
   }
   // Cache lookup failed. Instantiate the type arguments.
-  TypeArguments& result = TypeArguments::Handle(zone);
   result = InstantiateFrom(instantiator_type_arguments, function_type_arguments,
                            kAllFree, Heap::kOld);
   // Canonicalize type arguments.
@@ -7167,6 +7233,20 @@ void Function::SetFfiCallbackId(int32_t value) const {
   FfiTrampolineData::Cast(obj).set_callback_id(value);
 }
 
+bool Function::FfiIsLeaf() const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(raw_ptr()->data());
+  ASSERT(!obj.IsNull());
+  return FfiTrampolineData::Cast(obj).is_leaf();
+}
+
+void Function::SetFfiIsLeaf(bool is_leaf) const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(raw_ptr()->data());
+  ASSERT(!obj.IsNull());
+  FfiTrampolineData::Cast(obj).set_is_leaf(is_leaf);
+}
+
 FunctionPtr Function::FfiCallbackTarget() const {
   ASSERT(IsFfiTrampoline());
   const Object& obj = Object::Handle(raw_ptr()->data());
@@ -9855,6 +9935,10 @@ void FfiTrampolineData::set_callback_id(int32_t callback_id) const {
   StoreNonPointer(&raw_ptr()->callback_id_, callback_id);
 }
 
+void FfiTrampolineData::set_is_leaf(bool is_leaf) const {
+  StoreNonPointer(&raw_ptr()->is_leaf_, is_leaf);
+}
+
 void FfiTrampolineData::set_callback_exceptional_return(
     const Instance& value) const {
   raw_ptr()->set_callback_exceptional_return(value.raw());
@@ -9867,6 +9951,7 @@ FfiTrampolineDataPtr FfiTrampolineData::New() {
                        FfiTrampolineData::InstanceSize(), Heap::kOld);
   FfiTrampolineDataPtr data = static_cast<FfiTrampolineDataPtr>(raw);
   data->ptr()->callback_id_ = 0;
+  data->ptr()->is_leaf_ = false;
   return data;
 }
 
@@ -13476,7 +13561,9 @@ LibraryPtr KernelProgramInfo::LookupLibrary(Thread* thread,
     SafepointMutexLocker ml(
         thread->isolate_group()->kernel_data_lib_cache_mutex());
     data = libraries_cache();
-    ASSERT(!data.IsNull());
+    if (data.IsNull()) {
+      return Library::null();
+    }
     IntHashMap table(&key, &value, &data);
     result ^= table.GetOrNull(name_index);
     table.Release();
@@ -13499,7 +13586,9 @@ LibraryPtr KernelProgramInfo::InsertLibrary(Thread* thread,
     SafepointMutexLocker ml(
         thread->isolate_group()->kernel_data_lib_cache_mutex());
     data = libraries_cache();
-    ASSERT(!data.IsNull());
+    if (data.IsNull()) {
+      data = HashTables::New<IntHashMap>(16, Heap::kOld);
+    }
     IntHashMap table(&key, &value, &data);
     result ^= table.InsertOrGetValue(name_index, lib);
     set_libraries_cache(table.Release());
@@ -13525,7 +13614,9 @@ ClassPtr KernelProgramInfo::LookupClass(Thread* thread,
     SafepointMutexLocker ml(
         thread->isolate_group()->kernel_data_class_cache_mutex());
     data = classes_cache();
-    ASSERT(!data.IsNull());
+    if (data.IsNull()) {
+      return Class::null();
+    }
     IntHashMap table(&key, &value, &data);
     result ^= table.GetOrNull(name_index);
     table.Release();
@@ -13548,7 +13639,9 @@ ClassPtr KernelProgramInfo::InsertClass(Thread* thread,
     SafepointMutexLocker ml(
         thread->isolate_group()->kernel_data_class_cache_mutex());
     data = classes_cache();
-    ASSERT(!data.IsNull());
+    if (data.IsNull()) {
+      data = HashTables::New<IntHashMap>(16, Heap::kOld);
+    }
     IntHashMap table(&key, &value, &data);
     result ^= table.InsertOrGetValue(name_index, klass);
     set_classes_cache(table.Release());
@@ -13784,7 +13877,9 @@ void Library::CheckFunctionFingerprints() {
 }
 #endif  // defined(DEBUG) && !defined(DART_PRECOMPILED_RUNTIME).
 
-InstructionsPtr Instructions::New(intptr_t size, bool has_monomorphic_entry) {
+InstructionsPtr Instructions::New(intptr_t size,
+                                  bool has_monomorphic_entry,
+                                  bool is_hot) {
   ASSERT(size >= 0);
   ASSERT(Object::instructions_class() != Class::null());
   if (size < 0 || size > kMaxElements) {
@@ -13795,7 +13890,8 @@ InstructionsPtr Instructions::New(intptr_t size, bool has_monomorphic_entry) {
   {
     uword aligned_size = Instructions::InstanceSize(size);
     ObjectPtr raw =
-        Object::Allocate(Instructions::kClassId, aligned_size, Heap::kCode);
+        Object::Allocate(Instructions::kClassId, aligned_size,
+                         is_hot ? Heap::kHotCode : Heap::kCode);
     NoSafepointScope no_safepoint;
     result ^= raw;
     result.SetSize(size);
@@ -16301,8 +16397,11 @@ CodePtr Code::FinalizeCode(FlowGraphCompiler* compiler,
 #ifdef TARGET_ARCH_IA32
   assembler->GetSelfHandle() = code.raw();
 #endif
+  // Only functions which ran often get optimized, so their code is kept
+  // apart from the mostly cold unoptimized code.
   Instructions& instrs = Instructions::ZoneHandle(Instructions::New(
-      assembler->CodeSize(), assembler->has_monomorphic_entry()));
+      assembler->CodeSize(), assembler->has_monomorphic_entry(),
+      /*is_hot=*/optimized && FLAG_segregate_optimized_code));
 
   {
     // Important: if GC is triggerred at any point between Instructions::New
@@ -16440,9 +16539,10 @@ void Code::NotifyCodeObservers(const char* name,
   if (CodeObservers::AreActive()) {
     const auto& instrs = Instructions::Handle(code.instructions());
     CodeCommentsWrapper comments_wrapper(code.comments());
+    CodeSourceMapPositions positions(code);
     CodeObservers::NotifyAll(name, instrs.PayloadStart(),
                              code.GetPrologueOffset(), instrs.Size(), optimized,
-                             &comments_wrapper);
+                             &comments_wrapper, &positions);
   }
 #endif
 }
@@ -17070,12 +17170,22 @@ void MegamorphicCache::InsertLocked(const Smi& class_id,
   auto isolate_group = IsolateGroup::Current();
   ASSERT(isolate_group->type_feedback_mutex()->IsOwnedByCurrentThread());
 
-  // As opposed to ICData we are stopping mutator threads from other isolates
-  // while modifying the megamorphic cache, since updates are not atomic.
-  //
-  // NOTE: In the future we might change the megamorphic cache insertions to
-  // carefully use store-release barriers on the writer as well as
-  // load-acquire barriers on the reader, ...
+#if defined(TARGET_ARCH_IA32) || defined(TARGET_ARCH_X64)
+  // An entry which fits into a free slot is published by storing its class id
+  // after its target (see SetEntry). x86 neither reorders stores with other
+  // stores nor the megamorphic call stub's loads with other loads, so other
+  // mutators probing the cache meanwhile see either the free slot or the
+  // complete entry, and need not be stopped.
+  if (static_cast<double>(filled_entry_count() + 1) <=
+      (kLoadFactor * static_cast<double>(mask() + 1))) {
+    InsertEntryLocked(class_id, target);
+    return;
+  }
+#endif
+
+  // Growing the cache replaces both its buckets and its mask, which the stub
+  // loads separately, and on other architectures the stub's loads may be
+  // reordered, so the mutator threads of other isolates are stopped.
   isolate_group->RunWithStoppedMutators(
       [&]() {
         EnsureCapacityLocked();
@@ -17499,7 +17609,8 @@ ObjectPtr LoadingUnit::IssueLoad() const {
 ObjectPtr LoadingUnit::CompleteLoad(const String& error_message,
                                     bool transient_error) const {
   ASSERT(!loaded());
-  ASSERT(load_outstanding());
+  // A unit loaded ahead of any loadLibrary() has no outstanding load.
+  ASSERT(load_outstanding() || error_message.IsNull());
   set_loaded(error_message.IsNull());
   set_load_outstanding(false);
 
@@ -21463,6 +21574,9 @@ DoublePtr Double::NewCanonical(const String& str) {
 }
 
 StringPtr Number::ToString(Heap::Space space) const {
+  if (IsDouble()) {
+    return DoubleToString(Double::Cast(*this).value(), space);
+  }
   // Refactoring can avoid Zone::Alloc and strlen, but gains are insignificant.
   const char* cstr = ToCString();
   intptr_t len = strlen(cstr);
@@ -23632,6 +23746,30 @@ uint32_t TypedData::CanonicalizeHash() const {
   return FinalizeHash(hash, kHashBits);
 }
 
+void TypedData::ClampInt8ToUint8(uint8_t* dst,
+                                 const int8_t* src,
+                                 intptr_t length) {
+  if ((reinterpret_cast<uword>(dst) > reinterpret_cast<uword>(src)) &&
+      (reinterpret_cast<uword>(dst) < reinterpret_cast<uword>(src + length))) {
+    // A forward copy would read bytes it has already written.
+    for (intptr_t i = length - 1; i >= 0; i--) {
+      dst[i] = src[i] < 0 ? 0 : src[i];
+    }
+    return;
+  }
+  // Clamp eight bytes at a time: a byte is cleared if its sign bit is set.
+  const uint64_t kSignBits = 0x8080808080808080ULL;
+  intptr_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t bytes = LoadUnaligned(reinterpret_cast<const uint64_t*>(src + i));
+    bytes &= ~(((bytes & kSignBits) >> 7) * 0xFF);
+    StoreUnaligned(reinterpret_cast<uint64_t*>(dst + i), bytes);
+  }
+  for (; i < length; i++) {
+    dst[i] = src[i] < 0 ? 0 : src[i];
+  }
+}
+
 TypedDataPtr TypedData::New(intptr_t class_id,
                             intptr_t len,
                             Heap::Space space) {
@@ -23873,6 +24011,10 @@ const char* SendPort::ToCString() const {
   return "SendPort";
 }
 
+TransferableTypedDataPeer::~TransferableTypedDataPeer() {
+  TransferableBufferPool::Free(data_);
+}
+
 static void TransferableTypedDataFinalizer(void* isolate_callback_data,
                                            void* peer) {
   delete (reinterpret_cast<TransferableTypedDataPeer*>(peer));
@@ -37,6 +37,7 @@
 #include "vm/tags.h"
 #include "vm/thread.h"
 #include "vm/token_position.h"
+#include "vm/zone.h"
 
 namespace dart {
 
@@ -613,6 +614,14 @@ class Object {
   void set_vtable(cpp_vtable value) { *vtable_address() = value; }
 
   static ObjectPtr Allocate(intptr_t cls_id, intptr_t size, Heap::Space space);
+  // Allocates from a reservation made for a batch of objects.
+  static ObjectPtr Allocate(intptr_t cls_id,
+                            intptr_t size,
+                            HeapBulkAllocator* allocator);
+  static ObjectPtr InitializeAllocation(Thread* thread,
+                                        uword address,
+                                        intptr_t cls_id,
+                                        intptr_t size);
 
   static intptr_t RoundedAllocationSize(intptr_t size) {
     return Utils::RoundUp(size, kObjectAlignment);
@@ -2486,6 +2495,14 @@ class Function : public Object {
   // Can only be called on FFI trampolines.
   void SetFfiCallbackId(int32_t value) const;
 
+  // Can only be called on FFI trampolines.
+  // Leaf calls are made without a safepoint transition or exit frame, so the
+  // native function must not call back into Dart or block.
+  bool FfiIsLeaf() const;
+
+  // Can only be called on FFI trampolines.
+  void SetFfiIsLeaf(bool is_leaf) const;
+
   // Can only be called on FFI trampolines.
   // Null for Dart -> native calls.
   FunctionPtr FfiCallbackTarget() const;
@@ -3932,6 +3949,9 @@ class FfiTrampolineData : public Object {
   int32_t callback_id() const { return raw_ptr()->callback_id_; }
   void set_callback_id(int32_t value) const;
 
+  bool is_leaf() const { return raw_ptr()->is_leaf_; }
+  void set_is_leaf(bool value) const;
+
   static FfiTrampolineDataPtr New();
 
   FINAL_HEAP_OBJECT_IMPLEMENTATION(FfiTrampolineData, Object);
@@ -5429,7 +5449,9 @@ class Instructions : public Object {
   // only be created using the Code::FinalizeCode method. This method creates
   // the RawInstruction and RawCode objects, sets up the pointer offsets
   // and links the two in a GC safe manner.
-  static InstructionsPtr New(intptr_t size, bool has_monomorphic_entry);
+  static InstructionsPtr New(intptr_t size,
+                             bool has_monomorphic_entry,
+                             bool is_hot);
 
   FINAL_HEAP_OBJECT_IMPLEMENTATION(Instructions, Object);
   friend class Class;
@@ -7360,6 +7382,7 @@ class Instance : public Object {
   friend class ClassDeserializationCluster;  // vtable
   friend class InstanceMorpher;
   friend class Obfuscator;  // RawGetFieldAtOffset, RawSetFieldAtOffset
+  friend class ObjectGraphCopier;  // RawGetFieldAtOffset, RawSetFieldAtOffset
 };
 
 class LibraryPrefix : public Instance {
@@ -9105,6 +9128,8 @@ class OneByteString : public AllStatic {
   friend class Class;
   friend class ExternalOneByteString;
   friend class ImageWriter;
+  friend class IrregexpInterpreter;
+  friend class JSONWriter;
   friend class SnapshotReader;
   friend class String;
   friend class StringHasher;
@@ -9323,6 +9348,7 @@ class ExternalOneByteString : public AllStatic {
   }
 
   friend class Class;
+  friend class IrregexpInterpreter;
   friend class String;
   friend class StringHasher;
   friend class SnapshotReader;
@@ -9469,6 +9495,12 @@ class Array : public Instance {
     return Array::InstanceSize(array_length) > Heap::kNewAllocatableSize;
   }
 
+  // Arrays up to this length are cheap enough to rescan that they are added
+  // to the store buffer with the other live temporaries after a scavenge,
+  // which lets write barrier elimination keep them across instructions that
+  // may trigger GC.
+  static constexpr intptr_t kMaxLengthForWriteBarrierElimination = 8;
+
   intptr_t Length() const { return LengthOf(raw()); }
   static intptr_t LengthOf(const ArrayPtr array) {
     return Smi::Value(array->ptr()->length());
@@ -10069,21 +10101,20 @@ class TypedData : public TypedDataBase {
     {
       NoSafepointScope no_safepoint;
       if (length_in_bytes > 0) {
-        uint8_t* dst_data =
-            reinterpret_cast<uint8_t*>(dst.DataAddr(dst_offset_in_bytes));
-        int8_t* src_data =
-            reinterpret_cast<int8_t*>(src.DataAddr(src_offset_in_bytes));
-        for (intptr_t ix = 0; ix < length_in_bytes; ix++) {
-          int8_t v = *src_data;
-          if (v < 0) v = 0;
-          *dst_data = v;
-          src_data++;
-          dst_data++;
-        }
+        ClampInt8ToUint8(
+            reinterpret_cast<uint8_t*>(dst.DataAddr(dst_offset_in_bytes)),
+            reinterpret_cast<const int8_t*>(src.DataAddr(src_offset_in_bytes)),
+            length_in_bytes);
       }
     }
   }
 
+  // Copies length bytes from src to dst, replacing negative values with 0.
+  // The ranges may overlap.
+  static void ClampInt8ToUint8(uint8_t* dst,
+                               const int8_t* src,
+                               intptr_t length);
+
   static bool IsTypedData(const Instance& obj) {
     ASSERT(!obj.IsNull());
     intptr_t cid = obj.raw()->GetClassId();
@@ -10642,11 +10673,11 @@ class SendPort : public Instance {
 // [TransferableTypedData::New].
 class TransferableTypedDataPeer {
  public:
-  // [data] backing store should be malloc'ed, not new'ed.
+  // [data] backing store should be allocated by the TransferableBufferPool.
   TransferableTypedDataPeer(uint8_t* data, intptr_t length)
       : data_(data), length_(length), handle_(nullptr) {}
 
-  ~TransferableTypedDataPeer() { free(data_); }
+  ~TransferableTypedDataPeer();
 
   uint8_t* data() const { return data_; }
   intptr_t length() const { return length_; }
@@ -11220,19 +11251,22 @@ void MegamorphicCache::SetEntry(const Array& array,
                                 const Smi& class_id,
                                 const Object& target) {
   ASSERT(target.IsNull() || target.IsFunction() || target.IsSmi());
-  array.SetAt((index * kEntryLength) + kClassIdIndex, class_id);
+  // The target is stored before the class id, so that a probe which finds
+  // the class id also finds the target (see MegamorphicCache::InsertLocked).
 #if defined(DART_PRECOMPILED_RUNTIME)
-  if (FLAG_precompiled_mode && FLAG_use_bare_instructions) {
-    if (target.IsFunction()) {
-      const auto& function = Function::Cast(target);
-      const auto& entry_point = Smi::Handle(
-          Smi::FromAlignedAddress(Code::EntryPointOf(function.CurrentCode())));
-      array.SetAt((index * kEntryLength) + kTargetFunctionIndex, entry_point);
-      return;
-    }
+  if (FLAG_precompiled_mode && FLAG_use_bare_instructions &&
+      target.IsFunction()) {
+    const auto& function = Function::Cast(target);
+    const auto& entry_point = Smi::Handle(
+        Smi::FromAlignedAddress(Code::EntryPointOf(function.CurrentCode())));
+    array.SetAt((index * kEntryLength) + kTargetFunctionIndex, entry_point);
+  } else {
+    array.SetAt((index * kEntryLength) + kTargetFunctionIndex, target);
   }
-#endif  // defined(DART_PRECOMPILED_RUNTIME)
+#else
   array.SetAt((index * kEntryLength) + kTargetFunctionIndex, target);
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+  array.SetAtRelease((index * kEntryLength) + kClassIdIndex, class_id);
 }
 
 ObjectPtr MegamorphicCache::GetClassId(const Array& array, intptr_t index) {
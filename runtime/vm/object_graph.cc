@@ -65,6 +65,7 @@ class ObjectGraph::Stack : public ObjectPointerVisitor {
         node.ptr = current;
         node.obj = *current;
         node.gc_root_type = gc_root_type();
+        node.parent = parent_;
         data_.Add(node);
       }
     }
@@ -84,6 +85,7 @@ class ObjectGraph::Stack : public ObjectPointerVisitor {
       ASSERT(obj->IsHeapObject());
       Node sentinel;
       sentinel.ptr = kSentinel;
+      sentinel.parent = kNoParent;
       data_.Add(sentinel);
       StackIterator it(this, data_.length() - 2);
       visitor->gc_root_type = node.gc_root_type;
@@ -93,7 +95,9 @@ class ObjectGraph::Stack : public ObjectPointerVisitor {
       }
       if (direction == ObjectGraph::Visitor::kProceed) {
         set_gc_root_type(node.gc_root_type);
+        parent_ = data_.length() - 2;
         obj->ptr()->VisitPointers(this);
+        parent_ = kNoParent;
         clear_gc_root_type();
       }
     }
@@ -114,21 +118,23 @@ class ObjectGraph::Stack : public ObjectPointerVisitor {
     ObjectPtr* ptr;  // kSentinel for the sentinel node.
     ObjectPtr obj;
     const char* gc_root_type;
+    // Index of the node whose pointers this node was pushed from, which stays
+    // on the stack below its sentinel while this node is there.
+    intptr_t parent;
   };
 
   bool visit_weak_persistent_handles_ = false;
+  intptr_t parent_ = kNoParent;
   static ObjectPtr* const kSentinel;
   static const intptr_t kInitialCapacity = 1024;
   static const intptr_t kNoParent = -1;
 
   intptr_t Parent(intptr_t index) const {
-    // The parent is just below the next sentinel.
-    for (intptr_t i = index; i >= 1; --i) {
-      if (data_[i].ptr == kSentinel) {
-        return i - 1;
-      }
-    }
-    return kNoParent;
+    // The parent is just below the next sentinel, but it is recorded when the
+    // node is pushed so that climbing a path does not rescan the unvisited
+    // siblings of every node on it.
+    ASSERT(data_[index].ptr != kSentinel);
+    return data_[index].parent;
   }
 
   // During the iteration of the heap we are already at a safepoint, so there is
@@ -602,6 +608,20 @@ class CountingPage {
   DISALLOW_IMPLICIT_CONSTRUCTORS(CountingPage);
 };
 
+// Counting blocks covering [start, end) for a page whose end does not hold a
+// CountingPage: a code, large or image page, or any page of the VM isolate.
+struct CountingRange {
+  uword start;  // Rounded down to kBlockSize.
+  uword end;
+  CountingBlock* blocks;
+};
+
+static int CompareCountingRanges(CountingRange* const* a,
+                                 CountingRange* const* b) {
+  if ((*a)->start == (*b)->start) return 0;
+  return ((*a)->start < (*b)->start) ? -1 : 1;
+}
+
 void HeapSnapshotWriter::EnsureAvailable(intptr_t needed) {
   intptr_t available = capacity_ - size_;
   if (available >= needed) {
@@ -681,13 +701,52 @@ void HeapSnapshotWriter::SetupCountingPages() {
 
   OldPage* page = isolate()->heap()->old_space()->pages_;
   while (page != NULL) {
-    page->forwarding_page();
     CountingPage* counting_page =
         reinterpret_cast<CountingPage*>(page->forwarding_page());
     ASSERT(counting_page != NULL);
     counting_page->Clear();
     page = page->next();
   }
+
+  // Every other page gets counting blocks of its own for the duration of the
+  // snapshot, about 2% of the page's size. Only objects left in new space
+  // then need the object id table, whose size grows with the object count.
+  for (intptr_t i = 0; i < kMaxImagePages; i++) {
+    if (image_page_ranges_[i].size != 0) {
+      AddCountingRange(
+          image_page_ranges_[i].base,
+          image_page_ranges_[i].base + image_page_ranges_[i].size);
+    }
+  }
+  AddCountingRanges(Dart::vm_isolate()->heap()->old_space());
+  AddCountingRanges(isolate()->heap()->old_space());
+  counting_ranges_.Sort(CompareCountingRanges);
+}
+
+void HeapSnapshotWriter::AddCountingRanges(PageSpace* space) {
+  OldPage* lists[] = {space->pages_, space->exec_pages_, space->large_pages_};
+  for (OldPage* page : lists) {
+    for (; page != NULL; page = page->next()) {
+      if (page->forwarding_page() == NULL) {
+        AddCountingRange(page->object_start(), page->object_end());
+      }
+    }
+  }
+}
+
+void HeapSnapshotWriter::AddCountingRange(uword start, uword end) {
+  CountingRange* range = new CountingRange();
+  range->start = Utils::RoundDown(start, kBlockSize);
+  range->end = end;
+  const intptr_t num_blocks =
+      Utils::RoundUp(end - range->start, kBlockSize) / kBlockSize;
+  // Zeroed blocks are clear.
+  range->blocks = reinterpret_cast<CountingBlock*>(
+      calloc(num_blocks, sizeof(CountingBlock)));
+  if (range->blocks == NULL) {
+    OUT_OF_MEMORY();
+  }
+  counting_ranges_.Add(range);
 }
 
 bool HeapSnapshotWriter::OnImagePage(ObjectPtr obj) const {
@@ -700,26 +759,47 @@ bool HeapSnapshotWriter::OnImagePage(ObjectPtr obj) const {
   return false;
 }
 
-CountingPage* HeapSnapshotWriter::FindCountingPage(ObjectPtr obj) const {
-  if (obj->IsOldObject() && !OnImagePage(obj)) {
-    // On a regular or large page.
-    OldPage* page = OldPage::Of(obj);
-    return reinterpret_cast<CountingPage*>(page->forwarding_page());
+CountingBlock* HeapSnapshotWriter::FindCountingBlock(ObjectPtr obj) const {
+  if (!obj->IsOldObject()) {
+    // In new space.
+    return nullptr;
+  }
+
+  const uword addr = ObjectLayout::ToAddr(obj);
+  if (!OnImagePage(obj)) {
+    CountingPage* counting_page =
+        reinterpret_cast<CountingPage*>(OldPage::Of(obj)->forwarding_page());
+    if (counting_page != nullptr) {
+      // Likely: object on an ordinary page.
+      return counting_page->BlockFor(addr);
+    }
   }
 
-  // On an image page or in new space.
+  // On a code, large or image page.
+  intptr_t lo = 0;
+  intptr_t hi = counting_ranges_.length() - 1;
+  while (lo <= hi) {
+    const intptr_t mid = lo + (hi - lo) / 2;
+    const CountingRange* range = counting_ranges_[mid];
+    if (addr < range->start) {
+      hi = mid - 1;
+    } else if (addr >= range->end) {
+      lo = mid + 1;
+    } else {
+      return &range->blocks[(addr - range->start) / kBlockSize];
+    }
+  }
   return nullptr;
 }
 
 void HeapSnapshotWriter::AssignObjectId(ObjectPtr obj) {
   ASSERT(obj->IsHeapObject());
 
-  CountingPage* counting_page = FindCountingPage(obj);
-  if (counting_page != nullptr) {
-    // Likely: object on an ordinary page.
-    counting_page->Record(ObjectLayout::ToAddr(obj), ++object_count_);
+  CountingBlock* counting_block = FindCountingBlock(obj);
+  if (counting_block != nullptr) {
+    counting_block->Record(ObjectLayout::ToAddr(obj), ++object_count_);
   } else {
-    // Unlikely: new space object, or object on a large or image page.
+    // Unlikely: new space object that could not be promoted.
     thread()->heap()->SetObjectId(obj, ++object_count_);
   }
 }
@@ -734,13 +814,12 @@ intptr_t HeapSnapshotWriter::GetObjectId(ObjectPtr obj) const {
     obj = OldPage::ToWritable(obj);
   }
 
-  CountingPage* counting_page = FindCountingPage(obj);
+  CountingBlock* counting_block = FindCountingBlock(obj);
   intptr_t id;
-  if (counting_page != nullptr) {
-    // Likely: object on an ordinary page.
-    id = counting_page->Lookup(ObjectLayout::ToAddr(obj));
+  if (counting_block != nullptr) {
+    id = counting_block->Lookup(ObjectLayout::ToAddr(obj));
   } else {
-    // Unlikely: new space object, or object on a large or image page.
+    // Unlikely: new space object that could not be promoted.
     id = thread()->heap()->GetObjectId(obj);
   }
   ASSERT(id != 0);
@@ -749,6 +828,11 @@ intptr_t HeapSnapshotWriter::GetObjectId(ObjectPtr obj) const {
 
 void HeapSnapshotWriter::ClearObjectIds() {
   thread()->heap()->ResetObjectIdTable();
+  for (intptr_t i = 0; i < counting_ranges_.length(); i++) {
+    free(counting_ranges_[i]->blocks);
+    delete counting_ranges_[i];
+  }
+  counting_ranges_.Clear();
 }
 
 void HeapSnapshotWriter::CountReferences(intptr_t count) {
@@ -1013,6 +1097,11 @@ class Pass2Visitor : public ObjectVisitor,
 };
 
 void HeapSnapshotWriter::Write() {
+  // Objects in new space are the only ones whose ids need a table that grows
+  // with the number of objects, so promote them first. This also leaves the
+  // snapshot without the garbage new space would have held.
+  thread()->heap()->EvacuateNewSpace(thread(), Heap::kDebugging);
+
   HeapIterationScope iteration(thread());
 
   WriteBytes("dartheap", 8);  // Magic value.
@@ -15,7 +15,10 @@ namespace dart {
 
 class Array;
 class Object;
+class CountingBlock;
 class CountingPage;
+class PageSpace;
+struct CountingRange;
 
 #if !defined(PRODUCT)
 
@@ -191,8 +194,10 @@ class HeapSnapshotWriter : public ThreadStackResource {
   static const intptr_t kPreferredChunkSize = MB;
 
   void SetupCountingPages();
+  void AddCountingRanges(PageSpace* space);
+  void AddCountingRange(uword start, uword end);
   bool OnImagePage(ObjectPtr obj) const;
-  CountingPage* FindCountingPage(ObjectPtr obj) const;
+  CountingBlock* FindCountingBlock(ObjectPtr obj) const;
 
   void EnsureAvailable(intptr_t needed);
   void Flush(bool last = false);
@@ -215,6 +220,10 @@ class HeapSnapshotWriter : public ThreadStackResource {
   static const intptr_t kMaxImagePages = 4;
   ImagePageRange image_page_ranges_[kMaxImagePages];
 
+  // Counting blocks for the pages that have no forwarding page to hold them,
+  // sorted by address.
+  MallocGrowableArray<CountingRange*> counting_ranges_;
+
   DISALLOW_COPY_AND_ASSIGN(HeapSnapshotWriter);
 };
 
@@ -0,0 +1,230 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/object_graph_copy.h"
+
+#include "vm/heap/weak_table.h"
+#include "vm/isolate.h"
+#include "vm/object_store.h"
+#include "vm/thread.h"
+#include "vm/visitor.h"
+
+namespace dart {
+
+// Collects the offsets of the slots of an object which refer to objects that
+// have to be copied.
+class CopiedSlotsVisitor : public ObjectPointerVisitor {
+ public:
+  CopiedSlotsVisitor(IsolateGroup* isolate_group,
+                     uword object_addr,
+                     GrowableArray<intptr_t>* offsets)
+      : ObjectPointerVisitor(isolate_group),
+        object_addr_(object_addr),
+        offsets_(offsets) {}
+
+  void VisitPointers(ObjectPtr* first, ObjectPtr* last) {
+    for (ObjectPtr* current = first; current <= last; current++) {
+      if (!ObjectGraphCopier::IsDeeplyImmutable(*current)) {
+        offsets_->Add(reinterpret_cast<uword>(current) - object_addr_);
+      }
+    }
+  }
+
+ private:
+  const uword object_addr_;
+  GrowableArray<intptr_t>* const offsets_;
+
+  DISALLOW_COPY_AND_ASSIGN(CopiedSlotsVisitor);
+};
+
+ObjectGraphCopier::ObjectGraphCopier(Thread* thread)
+    : zone_(thread->zone()),
+      isolate_(thread->isolate()),
+      from_(zone_, 0),
+      to_(zone_, 0),
+      slot_offsets_(zone_, 0),
+      cls_(Class::Handle(zone_)),
+      value_(Object::Handle(zone_)),
+      copy_(Object::Handle(zone_)) {
+  ASSERT(isolate_->forward_table_new() == nullptr);
+  ASSERT(isolate_->forward_table_old() == nullptr);
+  isolate_->set_forward_table_new(new WeakTable());
+  isolate_->set_forward_table_old(new WeakTable());
+}
+
+ObjectGraphCopier::~ObjectGraphCopier() {
+  isolate_->set_forward_table_new(nullptr);
+  isolate_->set_forward_table_old(nullptr);
+}
+
+bool ObjectGraphCopier::IsDeeplyImmutable(ObjectPtr raw) {
+  if (!raw->IsHeapObject() || raw->ptr()->IsCanonical()) {
+    return true;
+  }
+  switch (raw->GetClassId()) {
+    case kNullCid:
+    case kBoolCid:
+    case kMintCid:
+    case kDoubleCid:
+    case kFloat32x4Cid:
+    case kInt32x4Cid:
+    case kFloat64x2Cid:
+    case kOneByteStringCid:
+    case kTwoByteStringCid:
+    case kSendPortCid:
+    case kCapabilityCid:
+    case kTypeArgumentsCid:
+    case kTypeCid:
+    case kTypeRefCid:
+    case kTypeParameterCid:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The index of a map is only valid for the copy if the copied keys have the
+// same hash codes as the original ones.
+static bool HasOnlyDeeplyImmutableKeys(const LinkedHashMap& map) {
+  NoSafepointScope no_safepoint;
+  const ArrayPtr data = map.data();
+  if (data == Array::null()) {
+    return true;
+  }
+  const intptr_t used_data = Smi::Value(map.used_data());
+  for (intptr_t i = 0; i < used_data; i += 2) {
+    const ObjectPtr key = Array::DataOf(data)[i];
+    // Deleted entries use the data array as key.
+    if ((key != data) && !ObjectGraphCopier::IsDeeplyImmutable(key)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+intptr_t ObjectGraphCopier::GetObjectId(ObjectPtr raw) {
+  if (raw->IsNewObject()) {
+    return isolate_->forward_table_new()->GetValueExclusive(raw);
+  }
+  return isolate_->forward_table_old()->GetValueExclusive(raw);
+}
+
+void ObjectGraphCopier::SetObjectId(ObjectPtr raw, intptr_t id) {
+  if (raw->IsNewObject()) {
+    isolate_->forward_table_new()->SetValueExclusive(raw, id);
+  } else {
+    isolate_->forward_table_old()->SetValueExclusive(raw, id);
+  }
+}
+
+bool ObjectGraphCopier::Copy(const Object& root, Object* result) {
+  if (!Forward(root, result)) {
+    return false;
+  }
+  // Copies are queued when they are allocated, so this visits the graph
+  // breadth first.
+  for (intptr_t i = 0; i < from_.length(); i++) {
+    if (!CopyFields(*from_[i], *to_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ObjectGraphCopier::Forward(const Object& from, Object* to) {
+  if (IsDeeplyImmutable(from.raw())) {
+    *to = from.raw();
+    return true;
+  }
+  const intptr_t id = GetObjectId(from.raw());
+  if (id != 0) {
+    *to = to_[id - 1]->raw();
+    return true;
+  }
+
+  const intptr_t cid = from.GetClassId();
+  switch (cid) {
+    case kArrayCid:
+    case kImmutableArrayCid:
+    case kGrowableObjectArrayCid:
+      *to = Object::Clone(from, Heap::kNew);
+      break;
+    case kLinkedHashMapCid:
+      if (!HasOnlyDeeplyImmutableKeys(LinkedHashMap::Cast(from))) {
+        return false;
+      }
+      *to = Object::Clone(from, Heap::kNew);
+      break;
+    default:
+      if (IsTypedDataClassId(cid)) {
+        const TypedData& typed_data = TypedData::Cast(from);
+        const intptr_t length = typed_data.Length();
+        *to = TypedData::New(cid, length);
+        NoSafepointScope no_safepoint;
+        memmove(TypedData::Cast(*to).DataAddr(0), typed_data.DataAddr(0),
+                typed_data.LengthInBytes());
+      } else if (cid >= kNumPredefinedCids) {
+        cls_ = isolate_->class_table()->At(cid);
+        // Native fields cannot be sent. The index of a set, like the one of a
+        // map, depends on the hash codes of its elements.
+        if ((cls_.num_native_fields() != 0) ||
+            (cls_.raw() == isolate_->object_store()->linked_hash_set_class())) {
+          return false;
+        }
+        *to = Object::Clone(from, Heap::kNew);
+      } else {
+        return false;
+      }
+  }
+
+  NoSafepointScope no_safepoint;
+  from_.Add(&Object::Handle(zone_, from.raw()));
+  to_.Add(&Object::Handle(zone_, to->raw()));
+  SetObjectId(from.raw(), from_.length());
+  return true;
+}
+
+bool ObjectGraphCopier::CopyFields(const Object& from, const Object& to) {
+  if (from.IsTypedData()) {
+    return true;
+  }
+  if (from.IsArray()) {
+    const Array& from_array = Array::Cast(from);
+    const Array& to_array = Array::Cast(to);
+    const intptr_t length = from_array.Length();
+    for (intptr_t i = 0; i < length; i++) {
+      value_ = from_array.At(i);
+      if (IsDeeplyImmutable(value_.raw())) {
+        continue;
+      }
+      if (!Forward(value_, &copy_)) {
+        return false;
+      }
+      to_array.SetAt(i, copy_);
+    }
+    return true;
+  }
+
+  slot_offsets_.Clear();
+  {
+    NoSafepointScope no_safepoint;
+    CopiedSlotsVisitor visitor(isolate_->group(),
+                               ObjectLayout::ToAddr(from.raw()),
+                               &slot_offsets_);
+    from.raw()->ptr()->VisitPointers(&visitor);
+  }
+  const Instance& from_instance = Instance::Cast(from);
+  const Instance& to_instance = Instance::Cast(to);
+  for (intptr_t i = 0; i < slot_offsets_.length(); i++) {
+    const intptr_t offset = slot_offsets_[i];
+    value_ = from_instance.RawGetFieldAtOffset(offset);
+    if (!Forward(value_, &copy_)) {
+      return false;
+    }
+    to_instance.RawSetFieldAtOffset(offset, copy_);
+  }
+  return true;
+}
+
+}  // namespace dart
@@ -0,0 +1,66 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_OBJECT_GRAPH_COPY_H_
+#define RUNTIME_VM_OBJECT_GRAPH_COPY_H_
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/object.h"
+
+namespace dart {
+
+class Isolate;
+class Thread;
+class Zone;
+
+// Copies the object graph of a message directly in the heap of the sending
+// isolate, for a receiver in the same isolate group (which shares the heap).
+//
+// Deeply immutable objects (numbers, strings, send ports, canonical objects,
+// ...) are shared with the copy instead of being copied. The copier handles
+// plain instances, arrays, growable arrays, maps whose keys are all deeply
+// immutable and internal typed data. Graphs containing anything else are
+// left to the message snapshot, which also reports the errors for objects
+// that cannot be sent.
+//
+// Like the snapshot writer, the copier uses the forwarding tables of the
+// isolate to map original objects to their copies.
+class ObjectGraphCopier : public ValueObject {
+ public:
+  explicit ObjectGraphCopier(Thread* thread);
+  ~ObjectGraphCopier();
+
+  // Returns false if the graph reachable from [root] cannot be copied.
+  // Otherwise sets [result] to the copy of [root].
+  bool Copy(const Object& root, Object* result);
+
+  // Whether [raw] is shared with the copy rather than being copied.
+  static bool IsDeeplyImmutable(ObjectPtr raw);
+
+ private:
+  // Sets [to] to the copy of [from], allocating it and queuing it for its
+  // fields to be copied if [from] has not been reached before.
+  bool Forward(const Object& from, Object* to);
+  bool CopyFields(const Object& from, const Object& to);
+
+  intptr_t GetObjectId(ObjectPtr raw);
+  void SetObjectId(ObjectPtr raw, intptr_t id);
+
+  Zone* zone_;
+  Isolate* isolate_;
+  // Originals and their copies. The object with id i is at index i - 1.
+  GrowableArray<const Object*> from_;
+  GrowableArray<const Object*> to_;
+  GrowableArray<intptr_t> slot_offsets_;
+  Class& cls_;
+  Object& value_;
+  Object& copy_;
+
+  DISALLOW_COPY_AND_ASSIGN(ObjectGraphCopier);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_OBJECT_GRAPH_COPY_H_
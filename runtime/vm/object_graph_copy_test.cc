@@ -0,0 +1,78 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/object_graph_copy.h"
+#include "platform/assert.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+ISOLATE_UNIT_TEST_CASE(ObjectGraphCopy_SharesImmutableObjects) {
+  const String& str = String::Handle(String::New("message"));
+  const Integer& mint = Integer::Handle(Integer::New(kMaxInt64));
+  const Array& array = Array::Handle(Array::New(4));
+  array.SetAt(0, str);
+  array.SetAt(1, mint);
+  array.SetAt(2, Smi::Handle(Smi::New(42)));
+  array.SetAt(3, array);
+
+  Object& result = Object::Handle();
+  {
+    ObjectGraphCopier copier(thread);
+    EXPECT(copier.Copy(array, &result));
+  }
+  EXPECT(result.IsArray());
+  EXPECT(result.raw() != array.raw());
+  const Array& copy = Array::Cast(result);
+  EXPECT_EQ(4, copy.Length());
+  EXPECT_EQ(str.raw(), copy.At(0));
+  EXPECT_EQ(mint.raw(), copy.At(1));
+  EXPECT_EQ(42, Smi::Value(Smi::RawCast(copy.At(2))));
+  // Cycles refer to the copy.
+  EXPECT_EQ(copy.raw(), copy.At(3));
+}
+
+ISOLATE_UNIT_TEST_CASE(ObjectGraphCopy_CopiesMutableObjects) {
+  const GrowableObjectArray& list =
+      GrowableObjectArray::Handle(GrowableObjectArray::New());
+  const TypedData& bytes =
+      TypedData::Handle(TypedData::New(kTypedDataUint8ArrayCid, 3));
+  bytes.SetUint8(0, 1);
+  bytes.SetUint8(1, 2);
+  bytes.SetUint8(2, 3);
+  list.Add(bytes);
+  list.Add(bytes);
+
+  Object& result = Object::Handle();
+  {
+    ObjectGraphCopier copier(thread);
+    EXPECT(copier.Copy(list, &result));
+  }
+  EXPECT(result.IsGrowableObjectArray());
+  EXPECT(result.raw() != list.raw());
+  const GrowableObjectArray& copy = GrowableObjectArray::Cast(result);
+  EXPECT_EQ(2, copy.Length());
+  EXPECT(copy.data() != list.data());
+  const TypedData& copied_bytes = TypedData::Handle(TypedData::RawCast(
+      copy.At(0)));
+  EXPECT(copied_bytes.raw() != bytes.raw());
+  EXPECT_EQ(copied_bytes.raw(), copy.At(1));
+  EXPECT_EQ(3, copied_bytes.Length());
+  EXPECT_EQ(3, copied_bytes.GetUint8(2));
+
+  // The copy does not alias the original.
+  bytes.SetUint8(2, 4);
+  EXPECT_EQ(3, copied_bytes.GetUint8(2));
+}
+
+ISOLATE_UNIT_TEST_CASE(ObjectGraphCopy_RejectsUnsupportedObjects) {
+  const Array& array = Array::Handle(Array::New(1));
+  array.SetAt(0, Object::Handle(ExternalTypedData::New(
+                     kExternalTypedDataUint8ArrayCid, nullptr, 0)));
+  Object& result = Object::Handle();
+  ObjectGraphCopier copier(thread);
+  EXPECT(!copier.Copy(array, &result));
+}
+
+}  // namespace dart
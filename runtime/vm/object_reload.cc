@@ -39,7 +39,12 @@ void CallSiteResetter::ZeroEdgeCounters(const Function& function) {
 }
 
 CallSiteResetter::CallSiteResetter(Zone* zone)
+    : CallSiteResetter(zone, nullptr) {}
+
+CallSiteResetter::CallSiteResetter(Zone* zone,
+                                   IsolateReloadContext* reload_context)
     : zone_(zone),
+      reload_context_(reload_context),
       instrs_(Instructions::Handle(zone)),
       pool_(ObjectPool::Handle(zone)),
       object_(Object::Handle(zone)),
@@ -888,6 +893,12 @@ void Library::CheckReload(const Library& replacement,
 }
 
 void CallSiteResetter::Reset(const ICData& ic) {
+  // Megamorphic call sites have their receivers in the megamorphic cache
+  // rather than in the entries, so they are always reset.
+  if ((reload_context_ != nullptr) && !ic.is_megamorphic() &&
+      !reload_context_->MayCallDirtyCode(ic)) {
+    return;
+  }
   ICData::RebindRule rule = ic.rebind_rule();
   if (rule == ICData::kInstance) {
     const intptr_t num_args = ic.NumArgsTested();
@@ -74,9 +74,8 @@ ErrorPtr IsolateObjectStore::PreallocateObjects() {
   Zone* zone = thread->zone();
   ASSERT(isolate != NULL && isolate->isolate_object_store() == this);
   ASSERT(preallocated_stack_trace() == StackTrace::null());
-  resume_capabilities_ = GrowableObjectArray::New();
-  exit_listeners_ = GrowableObjectArray::New();
-  error_listeners_ = GrowableObjectArray::New();
+  // The lists of resume capabilities and of exit and error listeners are
+  // only allocated when they are first added to.
 
   // Allocate pre-allocated unhandled exception object initialized with the
   // pre-allocated OutOfMemoryError.
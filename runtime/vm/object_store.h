@@ -231,12 +231,15 @@ class ObjectPointerVisitor;
   RW(Code, slow_tts_stub)                                                      \
   RW(Array, dispatch_table_code_entries)                                       \
   RW(GrowableObjectArray, code_order_tables)                                   \
+  RW(GrowableObjectArray, code_order_table_indices)                            \
   RW(Array, obfuscation_map)                                                   \
   RW(GrowableObjectArray, ffi_callback_functions)                              \
   RW(Class, ffi_pointer_class)                                                 \
   RW(Class, ffi_native_type_class)                                             \
   RW(Class, ffi_struct_class)                                                  \
   RW(Object, ffi_as_function_internal)                                         \
+  RW(GrowableObjectArray, regexp_bytecode_cache)                               \
+  RW(Array, code_coverage_map)                                                 \
   // Please remember the last entry must be referred in the 'to' function below.
 
 #define OBJECT_STORE_STUB_CODE_LIST(DO)                                        \
@@ -304,9 +307,10 @@ class ObjectPointerVisitor;
   RW(StackTrace, preallocated_stack_trace)                                     \
   RW(Array, dart_args_1)                                                       \
   RW(Array, dart_args_2)                                                       \
-  R_(GrowableObjectArray, resume_capabilities)                                 \
-  R_(GrowableObjectArray, exit_listeners)                                      \
-  R_(GrowableObjectArray, error_listeners)
+  RW(GrowableObjectArray, resume_capabilities)                                 \
+  RW(GrowableObjectArray, exit_listeners)                                      \
+  RW(GrowableObjectArray, error_listeners)                                     \
+  RW(GrowableObjectArray, osr_code_cache)
 // Please remember the last entry must be referred in the 'to' function below.
 
 class IsolateObjectStore {
@@ -363,7 +367,7 @@ class IsolateObjectStore {
   ISOLATE_OBJECT_STORE_FIELD_LIST(DECLARE_OBJECT_STORE_FIELD,
                                   DECLARE_OBJECT_STORE_FIELD)
 #undef DECLARE_OBJECT_STORE_FIELD
-  ObjectPtr* to() { return reinterpret_cast<ObjectPtr*>(&error_listeners_); }
+  ObjectPtr* to() { return reinterpret_cast<ObjectPtr*>(&osr_code_cache_); }
 
   ObjectStore* object_store_;
 
@@ -477,7 +481,7 @@ class ObjectStore {
                           DECLARE_OBJECT_STORE_FIELD)
 #undef DECLARE_OBJECT_STORE_FIELD
   ObjectPtr* to() {
-    return reinterpret_cast<ObjectPtr*>(&ffi_as_function_internal_);
+    return reinterpret_cast<ObjectPtr*>(&code_coverage_map_);
   }
   ObjectPtr* to_snapshot(Snapshot::Kind kind) {
     switch (kind) {
@@ -15,10 +15,12 @@
 #include "vm/code_descriptors.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/compiler_state.h"
+#include "vm/compiler/jit/compiler.h"
 #include "vm/dart_api_impl.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
 #include "vm/debugger_api_impl_test.h"
+#include "vm/double_conversion.h"
 #include "vm/isolate.h"
 #include "vm/malloc_hooks.h"
 #include "vm/object.h"
@@ -639,6 +641,65 @@ ISOLATE_UNIT_TEST_CASE(Double) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(Double_ParseAndPrint) {
+  // Inputs on both sides of the limits of the exact fast path in
+  // CStringToDouble, checked against the C library.
+  const char* kInputs[] = {
+      "0",
+      "-0",
+      "+1",
+      "1.5",
+      "-123.456",
+      "0.1",
+      "0.3",
+      "1e22",
+      "1e23",
+      "1e-22",
+      "1.7976931348623157e308",
+      "5e-324",
+      "9007199254740992",
+      "9007199254740993",
+      "123456789012345678901234567890",
+      "0.000000000000000000000000001",
+      "3.14159265358979323846",
+      "2.2250738585072014E-308",
+      "12345678.9e-5",
+      "1e+5",
+  };
+  for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(kInputs)); i++) {
+    double parsed = 0.0;
+    EXPECT(CStringToDouble(kInputs[i], strlen(kInputs[i]), &parsed));
+    const double expected = strtod(kInputs[i], nullptr);
+    EXPECT_EQ(bit_cast<uint64_t>(expected), bit_cast<uint64_t>(parsed));
+  }
+  const char* kInvalid[] = {"", "-", "1e", "1e+", "1.5x", "--1", "1 "};
+  for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(kInvalid)); i++) {
+    double parsed = 0.0;
+    EXPECT(!CStringToDouble(kInvalid[i], strlen(kInvalid[i]), &parsed));
+  }
+
+  // Double::ToString takes a shortcut for integral values, which must agree
+  // with the general printer.
+  const double kValues[] = {
+      0.0, -0.0, 1.0, -42.0, 1e15, 9007199254740992.0, 9007199254740994.0,
+      1e21, 0.1, -1.5e-7, 1.0 / 3.0, 9.2e18, NAN, INFINITY, -INFINITY,
+  };
+  Double& number = Double::Handle();
+  String& string = String::Handle();
+  for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(kValues)); i++) {
+    number = Double::New(kValues[i]);
+    string = number.ToString(Heap::kNew);
+    EXPECT(string.IsOneByteString());
+    EXPECT_STREQ(number.ToCString(), string.ToCString());
+  }
+  number = Double::New(-0.0);
+  string = number.ToString(Heap::kNew);
+  EXPECT_STREQ("-0.0", string.ToCString());
+  number = Double::New(123.0);
+  string = number.ToString(Heap::kNew);
+  EXPECT_STREQ("123.0", string.ToCString());
+}
+
 ISOLATE_UNIT_TEST_CASE(Integer) {
   Integer& i = Integer::Handle();
   i = Integer::NewCanonical(String::Handle(String::New("12")));
@@ -2292,6 +2353,50 @@ ISOLATE_UNIT_TEST_CASE(InternalTypedData) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(TypedData_ClampedCopy) {
+  const intptr_t kLength = 40;
+  const TypedData& src =
+      TypedData::Handle(TypedData::New(kTypedDataInt8ArrayCid, kLength));
+  const TypedData& dst = TypedData::Handle(
+      TypedData::New(kTypedDataUint8ClampedArrayCid, kLength));
+  for (intptr_t i = 0; i < kLength; i++) {
+    src.SetInt8(i, static_cast<int8_t>((i * 37) - 128));
+  }
+  // Cover the unrolled loop and the tail at all alignments.
+  for (intptr_t offset = 0; offset < 8; offset++) {
+    for (intptr_t length = 0; length <= kLength - offset; length++) {
+      for (intptr_t i = 0; i < kLength; i++) {
+        dst.SetUint8(i, 0xAA);
+      }
+      TypedData::ClampedCopy<TypedData, TypedData>(dst, 0, src, offset,
+                                                   length);
+      for (intptr_t i = 0; i < length; i++) {
+        const int8_t value = src.GetInt8(offset + i);
+        EXPECT_EQ(value < 0 ? 0 : value, dst.GetUint8(i));
+      }
+      for (intptr_t i = length; i < kLength; i++) {
+        EXPECT_EQ(0xAA, dst.GetUint8(i));
+      }
+    }
+  }
+
+  // Overlapping ranges in one buffer behave as if copied through a
+  // temporary, in both directions.
+  for (intptr_t shift = -9; shift <= 9; shift++) {
+    for (intptr_t i = 0; i < kLength; i++) {
+      dst.SetInt8(i, static_cast<int8_t>((i * 37) - 128));
+    }
+    const intptr_t from = shift < 0 ? -shift : 0;
+    const intptr_t to = shift < 0 ? 0 : shift;
+    const intptr_t length = kLength - Utils::Abs(shift);
+    TypedData::ClampedCopy<TypedData, TypedData>(dst, to, dst, from, length);
+    for (intptr_t i = 0; i < length; i++) {
+      const int8_t value = src.GetInt8(from + i);
+      EXPECT_EQ(value < 0 ? 0 : value, dst.GetUint8(to + i));
+    }
+  }
+}
+
 ISOLATE_UNIT_TEST_CASE(ExternalTypedData) {
   uint8_t data[] = {253, 254, 255, 0, 1, 2, 3, 4};
   intptr_t data_length = ARRAY_SIZE(data);
@@ -4249,6 +4354,56 @@ TEST_CASE(FunctionWithBreakpointNotInlined) {
   }
 }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+TEST_CASE(BreakpointKeepsUnrelatedCodeOptimized) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  a() {\n"
+      "  }\n"
+      "  b() {\n"
+      "    a();\n"  // This is line 5.
+      "  }\n"
+      "}\n"
+      "unrelated(int x) => x + 1;\n"
+      "test() {\n"
+      "  new A().b();\n"
+      "  return unrelated(1);\n"
+      "}";
+  const int kBreakpointLine = 5;
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  EXPECT_VALID(Dart_Invoke(lib, NewString("test"), 0, NULL));
+
+  {
+    TransitionNativeToVM transition(thread);
+    const String& name = String::Handle(String::New(TestCase::url()));
+    const Library& vmlib =
+        Library::Handle(Library::LookupLibrary(thread, name));
+    EXPECT(!vmlib.IsNull());
+    const Function& unrelated = Function::Handle(vmlib.LookupLocalFunction(
+        String::Handle(Symbols::New(thread, "unrelated"))));
+    const Object& result = Object::Handle(
+        Compiler::CompileOptimizedFunction(thread, unrelated));
+    EXPECT(!result.IsError());
+    EXPECT(unrelated.HasOptimizedCode());
+  }
+
+  EXPECT_VALID(Dart_SetBreakpoint(NewString(TestCase::url()), kBreakpointLine));
+
+  // Only code containing A.b is deoptimized for the breakpoint.
+  {
+    TransitionNativeToVM transition(thread);
+    const String& name = String::Handle(String::New(TestCase::url()));
+    const Library& vmlib =
+        Library::Handle(Library::LookupLibrary(thread, name));
+    EXPECT(!vmlib.IsNull());
+    const Function& unrelated = Function::Handle(vmlib.LookupLocalFunction(
+        String::Handle(Symbols::New(thread, "unrelated"))));
+    EXPECT(unrelated.HasOptimizedCode());
+  }
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 ISOLATE_UNIT_TEST_CASE(SpecialClassesHaveEmptyArrays) {
   ObjectStore* object_store = Isolate::Current()->object_store();
   Class& cls = Class::Handle();
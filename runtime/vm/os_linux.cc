@@ -46,6 +46,12 @@ DEFINE_FLAG(bool,
             "Generate jitdump file to use with perf-inject (disables dual code "
             "mapping)");
 
+DEFINE_FLAG(bool,
+            perf_jitdump_source_lines,
+            true,
+            "Attribute code in the jitdump file to Dart source lines instead "
+            "of code comments, where a code object has source positions");
+
 DECLARE_FLAG(bool, write_protect_code);
 DECLARE_FLAG(bool, write_protect_vm_isolate);
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -90,7 +96,8 @@ class PerfCodeObserver : public CodeObserver {
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) {
+                      const CodeComments* comments,
+                      const CodeSourcePositions* positions) {
     Dart_FileWriteCallback file_write = Dart::file_write_callback();
     if ((file_write == NULL) || (out_file_ == NULL)) {
       return;
@@ -121,6 +128,11 @@ class PerfCodeObserver : public CodeObserver {
 //   $ perf inject -j -i perf.data -o perf.data.jitted
 //   $ perf report -i perf.data.jitted
 //
+// With --perf_jitdump_source_lines, code with source positions is attributed
+// to the line of the innermost function inlined at each instruction, so
+// perf-report --sort srcline and perf-annotate show Dart source. Other code
+// is attributed to its code comments as before.
+//
 // [1] see linux/tools/perf/Documentation/jitdump-specification.txt for
 //     JITDUMP binary format.
 class JitDumpCodeObserver : public CodeObserver {
@@ -196,14 +208,25 @@ class JitDumpCodeObserver : public CodeObserver {
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) {
+                      const CodeComments* comments,
+                      const CodeSourcePositions* positions) {
+    // Reading the positions may allocate, so it must not happen while
+    // holding the lock.
+    const bool use_positions = FLAG_perf_jitdump_source_lines &&
+                               (positions != nullptr) &&
+                               (positions->Length() > 0);
+
     MutexLocker ml(CodeObservers::mutex());
 
     const char* marker = optimized ? "*" : "";
     char* buffer = OS::SCreate(Thread::Current()->zone(), "%s%s", marker, name);
     const size_t name_length = strlen(buffer);
 
-    WriteDebugInfo(base, comments);
+    if (use_positions) {
+      WriteSourcePositions(base, positions);
+    } else {
+      WriteDebugInfo(base, comments);
+    }
 
     CodeLoadEvent ev;
     ev.event = BaseEvent::kLoad;
@@ -359,6 +382,36 @@ class JitDumpCodeObserver : public CodeObserver {
     free(comments_file_name);
   }
 
+  void WriteSourcePositions(uword base, const CodeSourcePositions* positions) {
+    const intptr_t entry_count = positions->Length();
+
+    DebugInfoEvent info;
+    info.event = BaseEvent::kDebugInfo;
+    info.time_stamp = OS::GetCurrentMonotonicTicks();
+    info.address = base;
+    info.entry_count = entry_count;
+    info.size = sizeof(info);
+    for (intptr_t i = 0; i < entry_count; i++) {
+      info.size += sizeof(DebugInfoEntry) + strlen(positions->FileAt(i)) + 1;
+    }
+    const int32_t padding = Utils::RoundUp(info.size, 8) - info.size;
+    info.size += padding;
+
+    WriteFully(&info, sizeof(info));
+    for (intptr_t i = 0; i < entry_count; i++) {
+      DebugInfoEntry entry;
+      entry.address = base + positions->PCOffsetAt(i) + kElfHeaderSize;
+      entry.line_number = positions->LineAt(i);
+      entry.column = positions->ColumnAt(i);
+      WriteFully(&entry, sizeof(entry));
+      const char* file = positions->FileAt(i);
+      WriteFully(file, strlen(file) + 1);
+    }
+
+    const char padding_bytes[8] = {0};
+    WriteFully(padding_bytes, padding);
+  }
+
   void WriteHeader() {
     Header header;
     header.elf_mach_target = GetElfMachineArchitecture();
@@ -38,6 +38,7 @@ OSThread::OSThread()
       timeline_block_(NULL),
       thread_list_next_(NULL),
       thread_interrupt_disabled_(1),  // Thread interrupts disabled by default.
+      sample_block_(0),
       log_(new class Log()),
       stack_base_(0),
       stack_limit_(0),
@@ -77,6 +78,11 @@ OSThread::~OSThread() {
     FATAL("Thread exited without calling Dart_ExitIsolate");
   }
   RemoveThreadFromList(this);
+#if !defined(PRODUCT)
+  if (has_interrupt_timer_) {
+    ThreadInterrupter::DeleteThreadTimer(this);
+  }
+#endif
   delete log_;
   log_ = NULL;
 #if defined(SUPPORT_TIMELINE)
@@ -112,7 +118,10 @@ uword OSThread::GetCurrentStackPointer() {
 
 void OSThread::DisableThreadInterrupts() {
   ASSERT(OSThread::Current() == this);
-  thread_interrupt_disabled_.fetch_add(1u);
+  uintptr_t old = thread_interrupt_disabled_.fetch_add(1u);
+  if (FLAG_profiler && (old == 0)) {
+    ThreadInterrupter::StopThreadTimer(this);
+  }
 }
 
 void OSThread::EnableThreadInterrupts() {
@@ -120,7 +129,9 @@ void OSThread::EnableThreadInterrupts() {
   uintptr_t old = thread_interrupt_disabled_.fetch_sub(1u);
   if (FLAG_profiler && (old == 1)) {
     // We just decremented from 1 to 0.
-    // Make sure the thread interrupter is awake.
+    // Start sampling this thread, with its own timer if it has one, or else
+    // by making sure the thread interrupter is awake.
+    ThreadInterrupter::StartThreadTimer(this);
     ThreadInterrupter::WakeUp();
   }
   if (old == 0) {
@@ -127,6 +127,10 @@ class OSThread : public BaseThread {
     timeline_block_ = block;
   }
 
+  // Block of sample buffer slots claimed by this thread. Only used by
+  // SampleBuffer::ReserveSampleSlot.
+  RelaxedAtomic<uint64_t>* sample_block() { return &sample_block_; }
+
   Log* log() const { return log_; }
 
   uword stack_base() const { return stack_base_; }
@@ -290,6 +294,12 @@ class OSThread : public BaseThread {
   OSThread* thread_list_next_;
 
   RelaxedAtomic<uintptr_t> thread_interrupt_disabled_;
+  // A timer of this thread's own that signals it for profiling while its
+  // interrupts are enabled, see ThreadInterrupter::StartThreadTimer. The
+  // interrupter thread does not signal threads that have one.
+  RelaxedAtomic<bool> has_interrupt_timer_ = {false};
+  uword interrupt_timer_ = 0;
+  RelaxedAtomic<uint64_t> sample_block_;
   Log* log_;
   uword stack_base_;
   uword stack_limit_;
@@ -315,6 +325,7 @@ class OSThread : public BaseThread {
 
   friend class IsolateGroup;  // to access set_thread(Thread*).
   friend class OSThreadIterator;
+  friend class ThreadInterrupter;  // to access the interrupt timer.
   friend class ThreadInterrupterWin;
   friend class ThreadInterrupterFuchsia;
   friend class ThreadPool;  // to access owning_thread_pool_worker_
@@ -17,7 +17,7 @@
 namespace dart {
 
 Mutex* PortMap::mutex_ = NULL;
-PortSet<PortMap::Entry>* PortMap::ports_ = NULL;
+PortMap::Shard* PortMap::shards_ = nullptr;
 MessageHandler* PortMap::deleted_entry_ = reinterpret_cast<MessageHandler*>(1);
 Random* PortMap::prng_ = NULL;
 
@@ -59,18 +59,24 @@ Dart_Port PortMap::AllocatePort() {
     }
 
     ASSERT(!static_cast<ObjectPtr>(static_cast<uword>(result))->IsWellFormed());
-  } while (ports_->Contains(result));
+    // Ports are only inserted while holding [mutex_], so the port is still
+    // unused when the caller inserts it.
+    Shard* shard = ShardFor(result);
+    MutexLocker ml(&shard->mutex);
+    if (!shard->ports.Contains(result)) break;
+  } while (true);
 
   ASSERT(result != 0);
-  ASSERT(!ports_->Contains(result));
   return result;
 }
 
 void PortMap::SetPortState(Dart_Port port, PortState state) {
   MutexLocker ml(mutex_);
+  Shard* shard = ShardFor(port);
+  MutexLocker shard_locker(&shard->mutex);
 
-  auto it = ports_->TryLookup(port);
-  ASSERT(it != ports_->end());
+  auto it = shard->ports.TryLookup(port);
+  ASSERT(it != shard->ports.end());
 
   Entry& entry = *it;
   PortState old_state = entry.state;
@@ -109,7 +115,11 @@ Dart_Port PortMap::CreatePort(MessageHandler* handler) {
   entry.port = port;
   entry.handler = handler;
   entry.state = kNewPort;
-  ports_->Insert(entry);
+  {
+    Shard* shard = ShardFor(port);
+    MutexLocker shard_locker(&shard->mutex);
+    shard->ports.Insert(entry);
+  }
 
   if (FLAG_trace_isolates) {
     OS::PrintErr(
@@ -126,8 +136,10 @@ bool PortMap::ClosePort(Dart_Port port) {
   MessageHandler* handler = NULL;
   {
     MutexLocker ml(mutex_);
-    auto it = ports_->TryLookup(port);
-    if (it == ports_->end()) {
+    Shard* shard = ShardFor(port);
+    MutexLocker shard_locker(&shard->mutex);
+    auto it = shard->ports.TryLookup(port);
+    if (it == shard->ports.end()) {
       return false;
     }
     Entry entry = *it;
@@ -145,7 +157,7 @@ bool PortMap::ClosePort(Dart_Port port) {
     // Delete the port entry before releasing the lock to avoid holding the lock
     // while flushing the messages below.
     it.Delete();
-    ports_->Rebalance();
+    shard->ports.Rebalance();
 
     // The MessageHandler::ports_ is only accessed by [PortMap], it is guarded
     // by the [PortMap::mutex_] we already hold.
@@ -169,8 +181,10 @@ void PortMap::ClosePorts(MessageHandler* handler) {
     // by the [PortMap::mutex_] we already hold.
     for (auto isolate_it = handler->ports_.begin();
          isolate_it != handler->ports_.end(); ++isolate_it) {
-      auto it = ports_->TryLookup((*isolate_it).port);
-      ASSERT(it != ports_->end());
+      Shard* shard = ShardFor((*isolate_it).port);
+      MutexLocker shard_locker(&shard->mutex);
+      auto it = shard->ports.TryLookup((*isolate_it).port);
+      ASSERT(it != shard->ports.end());
       Entry entry = *it;
       ASSERT(entry.port == (*isolate_it).port);
       ASSERT(entry.handler == handler);
@@ -178,19 +192,22 @@ void PortMap::ClosePorts(MessageHandler* handler) {
         handler->decrement_live_ports();
       }
       it.Delete();
+      shard->ports.Rebalance();
       isolate_it.Delete();
     }
     ASSERT(handler->ports_.IsEmpty());
-    ports_->Rebalance();
   }
   handler->CloseAllPorts();
 }
 
 bool PortMap::PostMessage(std::unique_ptr<Message> message,
                           bool before_events) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(message->dest_port());
-  if (it == ports_->end()) {
+  // The shard lock keeps the handler from being deleted while posting. See
+  // [ClosePort].
+  Shard* shard = ShardFor(message->dest_port());
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(message->dest_port());
+  if (it == shard->ports.end()) {
     // Ownership of external data remains with the poster.
     message->DropFinalizers();
     return false;
@@ -202,9 +219,10 @@ bool PortMap::PostMessage(std::unique_ptr<Message> message,
 }
 
 bool PortMap::IsLocalPort(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(id);
-  if (it == ports_->end()) {
+  Shard* shard = ShardFor(id);
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(id);
+  if (it == shard->ports.end()) {
     // Port does not exist.
     return false;
   }
@@ -215,9 +233,10 @@ bool PortMap::IsLocalPort(Dart_Port id) {
 }
 
 bool PortMap::IsLivePort(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(id);
-  if (it == ports_->end()) {
+  Shard* shard = ShardFor(id);
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(id);
+  if (it == shard->ports.end()) {
     // Port does not exist.
     return false;
   }
@@ -227,9 +246,10 @@ bool PortMap::IsLivePort(Dart_Port id) {
 }
 
 Isolate* PortMap::GetIsolate(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(id);
-  if (it == ports_->end()) {
+  Shard* shard = ShardFor(id);
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(id);
+  if (it == shard->ports.end()) {
     // Port does not exist.
     return nullptr;
   }
@@ -240,10 +260,13 @@ Isolate* PortMap::GetIsolate(Dart_Port id) {
 
 bool PortMap::IsReceiverInThisIsolateGroup(Dart_Port receiver,
                                            IsolateGroup* group) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(receiver);
-  if (it == ports_->end()) return false;
-  return (*it).handler->isolate()->group() == group;
+  Shard* shard = ShardFor(receiver);
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(receiver);
+  if (it == shard->ports.end()) return false;
+  // Native ports are not owned by an isolate.
+  Isolate* isolate = (*it).handler->isolate();
+  return (isolate != nullptr) && (isolate->group() == group);
 }
 
 void PortMap::Init() {
@@ -255,30 +278,33 @@ void PortMap::Init() {
   if (prng_ == nullptr) {
     prng_ = new Random();
   }
-  if (ports_ == nullptr) {
-    ports_ = new PortSet<Entry>();
+  if (shards_ == nullptr) {
+    shards_ = new Shard[kNumShards];
   }
 }
 
 void PortMap::Cleanup() {
-  ASSERT(ports_ != nullptr);
+  ASSERT(shards_ != nullptr);
   ASSERT(prng_ != NULL);
-  for (auto it = ports_->begin(); it != ports_->end(); ++it) {
-    const auto& entry = *it;
-    ASSERT(entry.handler != nullptr);
-    if (entry.state == kLivePort) {
-      entry.handler->decrement_live_ports();
+  for (intptr_t i = 0; i < kNumShards; i++) {
+    PortSet<Entry>* ports = &shards_[i].ports;
+    for (auto it = ports->begin(); it != ports->end(); ++it) {
+      const auto& entry = *it;
+      ASSERT(entry.handler != nullptr);
+      if (entry.state == kLivePort) {
+        entry.handler->decrement_live_ports();
+      }
+      delete entry.handler;
+      it.Delete();
     }
-    delete entry.handler;
-    it.Delete();
+    ports->Rebalance();
   }
-  ports_->Rebalance();
 
   delete prng_;
   prng_ = NULL;
   // TODO(bkonyi): find out why deleting map_ sometimes causes crashes.
-  // delete ports_;
-  // ports_ = nullptr;
+  // delete[] shards_;
+  // shards_ = nullptr;
 }
 
 void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
@@ -286,18 +312,22 @@ void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
 #ifndef PRODUCT
   JSONObject jsobj(stream);
   jsobj.AddProperty("type", "_Ports");
+  handler->PrintMessageMetricsJSON(&jsobj);
   Object& msg_handler = Object::Handle();
   {
     JSONArray ports(&jsobj, "ports");
     SafepointMutexLocker ml(mutex_);
-    for (auto& entry : *ports_) {
-      if (entry.handler == handler) {
-        if (entry.state == kLivePort) {
-          JSONObject port(&ports);
-          port.AddProperty("type", "_Port");
-          port.AddPropertyF("name", "Isolate Port (%" Pd64 ")", entry.port);
-          msg_handler = DartLibraryCalls::LookupHandler(entry.port);
-          port.AddProperty("handler", msg_handler);
+    for (intptr_t i = 0; i < kNumShards; i++) {
+      SafepointMutexLocker shard_locker(&shards_[i].mutex);
+      for (auto& entry : shards_[i].ports) {
+        if (entry.handler == handler) {
+          if (entry.state == kLivePort) {
+            JSONObject port(&ports);
+            port.AddProperty("type", "_Port");
+            port.AddPropertyF("name", "Isolate Port (%" Pd64 ")", entry.port);
+            msg_handler = DartLibraryCalls::LookupHandler(entry.port);
+            port.AddProperty("handler", msg_handler);
+          }
         }
       }
     }
@@ -308,12 +338,15 @@ void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
 void PortMap::DebugDumpForMessageHandler(MessageHandler* handler) {
   SafepointMutexLocker ml(mutex_);
   Object& msg_handler = Object::Handle();
-  for (auto& entry : *ports_) {
-    if (entry.handler == handler) {
-      if (entry.state == kLivePort) {
-        OS::PrintErr("Live Port = %" Pd64 "\n", entry.port);
-        msg_handler = DartLibraryCalls::LookupHandler(entry.port);
-        OS::PrintErr("Handler = %s\n", msg_handler.ToCString());
+  for (intptr_t i = 0; i < kNumShards; i++) {
+    SafepointMutexLocker shard_locker(&shards_[i].mutex);
+    for (auto& entry : shards_[i].ports) {
+      if (entry.handler == handler) {
+        if (entry.state == kLivePort) {
+          OS::PrintErr("Live Port = %" Pd64 "\n", entry.port);
+          msg_handler = DartLibraryCalls::LookupHandler(entry.port);
+          OS::PrintErr("Handler = %s\n", msg_handler.ToCString());
+        }
       }
     }
   }
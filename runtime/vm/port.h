@@ -11,6 +11,7 @@
 #include "vm/allocation.h"
 #include "vm/globals.h"
 #include "vm/json_stream.h"
+#include "vm/os_thread.h"
 #include "vm/port_set.h"
 #include "vm/random.h"
 
@@ -19,7 +20,6 @@ namespace dart {
 class Isolate;
 class Message;
 class MessageHandler;
-class Mutex;
 class PortMapTestPeer;
 
 class PortMap : public AllStatic {
@@ -84,15 +84,30 @@ class PortMap : public AllStatic {
     PortState state;
   };
 
+  // The ports are spread over a fixed number of shards, each with its own
+  // lock, so that posting messages to unrelated ports does not contend.
+  struct Shard {
+    Mutex mutex;
+    PortSet<Entry> ports;
+  };
+  static constexpr intptr_t kNumShards = 16;
+
   static const char* PortStateString(PortState state);
 
   // Allocate a new unique port.
   static Dart_Port AllocatePort();
 
-  // Lock protecting access to the port map.
+  static Shard* ShardFor(Dart_Port port) {
+    // The low two bits of every port are set, see [AllocatePort].
+    return &shards_[(static_cast<uint64_t>(port) >> 2) % kNumShards];
+  }
+
+  // Lock serializing the creation and closing of ports. It protects the
+  // MessageHandler::ports_ sets and live port counts. When both are taken,
+  // it is acquired before the lock of a shard.
   static Mutex* mutex_;
 
-  static PortSet<Entry>* ports_;
+  static Shard* shards_;
   static MessageHandler* deleted_entry_;
 
   static Random* prng_;
@@ -185,6 +185,7 @@ SampleBuffer::SampleBuffer(intptr_t capacity) {
   samples_ = reinterpret_cast<Sample*>(memory_->address());
   capacity_ = capacity;
   cursor_ = 0;
+  use_thread_blocks_ = capacity >= (64 * kThreadBlockSize);
 
   if (FLAG_trace_profiler) {
     OS::PrintErr("Profiler holds %" Pd " samples\n", capacity);
@@ -225,12 +226,51 @@ Sample* SampleBuffer::At(intptr_t idx) const {
 
 intptr_t SampleBuffer::ReserveSampleSlot() {
   ASSERT(samples_ != NULL);
+  if (use_thread_blocks_) {
+    OSThread* os_thread = OSThread::TryCurrent();
+    if (os_thread != NULL) {
+      return ReserveThreadSlot(os_thread);
+    }
+  }
   uintptr_t cursor = cursor_.fetch_add(1u);
   // Map back into sample buffer range.
   cursor = cursor % capacity_;
   return cursor;
 }
 
+// The block is packed as (start << 8) | remaining so that it can be updated
+// with a single compare-and-swap: the same thread may reserve a sample from
+// within the profiling signal handler while it is reserving one itself (e.g.
+// for an allocation sample), and on some platforms the thread interrupter
+// samples on behalf of other threads.
+intptr_t SampleBuffer::ReserveThreadSlot(OSThread* os_thread) {
+  COMPILE_ASSERT(kThreadBlockSize < (1 << 8));
+  RelaxedAtomic<uint64_t>* block = os_thread->sample_block();
+  uint64_t current = block->load();
+  while (true) {
+    const uintptr_t start = static_cast<uintptr_t>(current >> 8);
+    const intptr_t remaining = static_cast<intptr_t>(current & 0xff);
+    // Once the ring has wrapped past the block its slots may have been handed
+    // out again, so a thread that samples rarely must not keep using it.
+    const bool stale = (cursor_.load() - start) >
+                       static_cast<uintptr_t>(capacity_ - kThreadBlockSize);
+    if ((remaining > 0) && !stale) {
+      if (block->compare_exchange_weak(current, current - 1)) {
+        return (start + (kThreadBlockSize - remaining)) % capacity_;
+      }
+      continue;
+    }
+    const uintptr_t fresh = cursor_.fetch_add(kThreadBlockSize);
+    const uint64_t claimed =
+        (static_cast<uint64_t>(fresh) << 8) | (kThreadBlockSize - 1);
+    if (block->compare_exchange_weak(current, claimed)) {
+      return fresh % capacity_;
+    }
+    // Lost a race with a nested reservation; the slots of the block we just
+    // claimed keep whatever samples they held.
+  }
+}
+
 Sample* SampleBuffer::ReserveSample() {
   return At(ReserveSampleSlot());
 }
@@ -671,6 +711,160 @@ class ProfilerDartStackWalker : public ProfilerStackWalker {
   uword* fp_;
 };
 
+// Executing AOT compiled Dart code, copy the frame pointer chain.
+//
+// Follows the same frames as ProfilerDartStackWalker, but collects the
+// return addresses into a buffer on the stack of the interrupted thread and
+// only then copies them into the sample and its continuations, a
+// kSampleSize block at a time. Per frame this costs the two loads, the
+// bounds check against the thread's stack and the entry stub check, with no
+// per-frame bookkeeping for the sample chain. Symbolizing the pcs is left to
+// profile processing, as for the other walkers.
+class ProfilerFramePointerWalker : public ValueObject {
+ public:
+  ProfilerFramePointerWalker(ProfilerCounters* counters,
+                             Thread* thread,
+                             Sample* sample,
+                             SampleBuffer* sample_buffer,
+                             uword stack_lower,
+                             uword stack_upper,
+                             uword pc,
+                             uword fp)
+      : counters_(counters),
+        thread_(thread),
+        sample_(sample),
+        sample_buffer_(sample_buffer),
+        stack_lower_(stack_lower),
+        stack_upper_(stack_upper),
+        pc_(pc),
+        fp_(fp) {}
+
+  void walk() {
+    RELEASE_ASSERT(StubCode::HasBeenInitialized());
+    const intptr_t max_frames =
+        Utils::Minimum<intptr_t>(FLAG_max_profile_depth, kMaxFrames);
+    uword pcs[kMaxFrames];
+    intptr_t length = 0;
+
+    uword pc = pc_;
+    uword fp = fp_;
+    const uword exit_fp = thread_->top_exit_frame_info();
+    const bool has_exit_frame = exit_fp != 0;
+    if (has_exit_frame) {
+      // Skip the exit frame.
+      fp = exit_fp;
+      if (!ValidFramePointer(fp)) {
+        counters_->incomplete_sample_fp_bounds.fetch_add(1);
+        sample_->set_ignore_sample(true);
+        return;
+      }
+      pc = CallerPC(fp);
+      fp = CallerFP(fp);
+    } else if (ValidFramePointer(fp) && (CallerPC(fp) == EntryMarker(fp))) {
+      // In a prologue, see ProfilerDartStackWalker::walk.
+      sample_->set_ignore_sample(true);
+      return;
+    }
+    sample_->set_exit_frame_sample(has_exit_frame);
+
+    bool truncated = false;
+    while (ValidFramePointer(fp)) {
+      if (StubCode::InInvocationStub(pc)) {
+        // Skip the entry frame and the exit frame before it.
+        fp = ExitLink(fp);
+        if (fp == 0) {
+          break;  // End of Dart stack.
+        }
+        if (!ValidFramePointer(fp)) {
+          counters_->incomplete_sample_fp_bounds.fetch_add(1);
+          break;
+        }
+        pc = CallerPC(fp);
+        fp = CallerFP(fp);
+        if (!ValidFramePointer(fp)) {
+          counters_->incomplete_sample_fp_bounds.fetch_add(1);
+          break;
+        }
+      }
+      if (length == max_frames) {
+        truncated = true;
+        break;
+      }
+      pcs[length++] = pc;
+      const uword caller_fp = CallerFP(fp);
+      if ((caller_fp != 0) && (caller_fp <= fp)) {
+        // Frame pointer did not move to a higher address.
+        counters_->incomplete_sample_fp_step.fetch_add(1);
+        break;
+      }
+      pc = CallerPC(fp);
+      fp = caller_fp;
+    }
+
+    Copy(pcs, length, truncated);
+  }
+
+ private:
+  static const intptr_t kMaxFrames = 256;
+
+  void Copy(const uword* pcs, intptr_t length, bool truncated) {
+    Sample* sample = sample_;
+    intptr_t i = 0;
+    while (i < length) {
+      if ((i > 0) && ((i % kSampleSize) == 0)) {
+        Sample* next = sample_buffer_->ReserveSampleAndLink(sample);
+        if (next == NULL) {
+          truncated = true;
+          break;
+        }
+        sample = next;
+      }
+      sample->SetAt(i % kSampleSize, pcs[i]);
+      i++;
+    }
+    if (truncated) {
+      sample->set_truncated_trace(true);
+    }
+  }
+
+  bool ValidFramePointer(uword fp) const {
+    // The saved caller pc and fp, and the entry marker above them, must lie
+    // within the stack.
+    return (fp >= stack_lower_) &&
+           ((fp + (kSavedCallerPcSlotFromFp + 2) * kWordSize) <= stack_upper_);
+  }
+
+  static uword LoadSlot(uword fp, intptr_t slot) {
+    uword* ptr = reinterpret_cast<uword*>(fp) + slot;
+    // MSan/ASan are unaware of frames initialized by generated code.
+    MSAN_UNPOISON(ptr, kWordSize);
+    ASAN_UNPOISON(ptr, kWordSize);
+    return *ptr;
+  }
+
+  static uword CallerPC(uword fp) {
+    return LoadSlot(fp, kSavedCallerPcSlotFromFp);
+  }
+  static uword CallerFP(uword fp) {
+    return LoadSlot(fp, kSavedCallerFpSlotFromFp);
+  }
+  static uword ExitLink(uword fp) {
+    return LoadSlot(fp, kExitLinkSlotFromEntryFp);
+  }
+  static uword EntryMarker(uword fp) {
+    return LoadSlot(fp, kSavedCallerPcSlotFromFp + 1);
+  }
+
+  ProfilerCounters* const counters_;
+  Thread* const thread_;
+  Sample* const sample_;
+  SampleBuffer* const sample_buffer_;
+  const uword stack_lower_;
+  const uword stack_upper_;
+  const uword pc_;
+  const uword fp_;
+};
+
 // If the VM is compiled without frame pointers (which is the default on
 // recent GCC versions with optimizing enabled) the stack walking code may
 // fail.
@@ -840,6 +1034,7 @@ static void CollectSample(Isolate* isolate,
                           Sample* sample,
                           ProfilerNativeStackWalker* native_stack_walker,
                           ProfilerDartStackWalker* dart_stack_walker,
+                          ProfilerFramePointerWalker* frame_pointer_walker,
                           uword pc,
                           uword fp,
                           uword sp,
@@ -860,6 +1055,11 @@ static void CollectSample(Isolate* isolate,
       // Always walk the native stack collecting both native and Dart frames.
       counters->stack_walker_native.fetch_add(1);
       native_stack_walker->walk();
+    } else if ((frame_pointer_walker != NULL) &&
+               StubCode::HasBeenInitialized() &&
+               (exited_dart_code || in_dart_code)) {
+      counters->stack_walker_frame_pointer.fetch_add(1);
+      frame_pointer_walker->walk();
     } else if (StubCode::HasBeenInitialized() && exited_dart_code) {
       counters->stack_walker_dart_exit.fetch_add(1);
       // We have a valid exit frame info, use the Dart stack walker.
@@ -1373,11 +1573,15 @@ void Profiler::SampleThread(Thread* thread,
   const bool exited_dart_code = thread->HasExitedDartCode();
   ProfilerDartStackWalker dart_stack_walker(thread, sample, sample_buffer, pc,
                                             fp, /* allocation_sample*/ false);
+  ProfilerFramePointerWalker frame_pointer_walker(
+      &counters_, thread, sample, sample_buffer, stack_lower, stack_upper, pc,
+      fp);
 
   // All memory access is done inside CollectSample.
   CollectSample(isolate, exited_dart_code, in_dart_code, sample,
-                &native_stack_walker, &dart_stack_walker, pc, fp, sp,
-                &counters_);
+                &native_stack_walker, &dart_stack_walker,
+                FLAG_precompiled_mode ? &frame_pointer_walker : NULL, pc, fp,
+                sp, &counters_);
 }
 
 CodeDescriptor::CodeDescriptor(const AbstractCode code) : code_(code) {}
@@ -42,6 +42,7 @@ class ProfileTrieNode;
   V(stack_walker_native)                                                       \
   V(stack_walker_dart_exit)                                                    \
   V(stack_walker_dart)                                                         \
+  V(stack_walker_frame_pointer)                                                \
   V(stack_walker_none)                                                         \
   V(incomplete_sample_fp_bounds)                                               \
   V(incomplete_sample_fp_step)                                                 \
@@ -619,6 +620,10 @@ class SampleBuffer {
   // Up to 1 minute @ 1000Hz, less if samples are deep.
   static const intptr_t kDefaultBufferCapacity = 60000;
 
+  // Threads claim slots from |cursor_| in blocks of this many so that
+  // concurrent samplers do not bounce the cursor's cache line on every sample.
+  static const intptr_t kThreadBlockSize = 16;
+
   explicit SampleBuffer(intptr_t capacity = kDefaultBufferCapacity);
   virtual ~SampleBuffer();
 
@@ -674,6 +679,11 @@ class SampleBuffer {
   RelaxedAtomic<uintptr_t> cursor_;
 
  private:
+  intptr_t ReserveThreadSlot(OSThread* os_thread);
+
+  // Small buffers (as used in tests) hand out slots strictly in order.
+  bool use_thread_blocks_;
+
   DISALLOW_COPY_AND_ASSIGN(SampleBuffer);
 };
 
@@ -1634,6 +1634,8 @@ void Profile::PrintHeaderJSON(JSONObject* obj) {
     counts.AddProperty64("stack_walker_dart_exit",
                          counters.stack_walker_dart_exit);
     counts.AddProperty64("stack_walker_dart", counters.stack_walker_dart);
+    counts.AddProperty64("stack_walker_frame_pointer",
+                         counters.stack_walker_frame_pointer);
     counts.AddProperty64("stack_walker_none", counters.stack_walker_none);
   }
 }
@@ -1642,6 +1644,18 @@ void Profile::ProcessSampleFrameJSON(JSONArray* stack,
                                      ProfileCodeInlinedFunctionsCache* cache_,
                                      ProcessedSample* sample,
                                      intptr_t frame_index) {
+  GrowableArray<ProfileFunction*> functions;
+  CollectSampleFrameFunctions(&functions, cache_, sample, frame_index);
+  for (intptr_t i = 0; i < functions.length(); i++) {
+    PrintFunctionFrameIndexJSON(stack, functions[i]);
+  }
+}
+
+void Profile::CollectSampleFrameFunctions(
+    GrowableArray<ProfileFunction*>* functions,
+    ProfileCodeInlinedFunctionsCache* cache_,
+    ProcessedSample* sample,
+    intptr_t frame_index) {
   const uword pc = sample->At(frame_index);
   ProfileCode* profile_code = GetCodeFromPC(pc, sample->timestamp());
   ASSERT(profile_code != NULL);
@@ -1675,7 +1689,7 @@ void Profile::ProcessSampleFrameJSON(JSONArray* stack,
 
   if (code.IsNull() || (inlined_functions == NULL) ||
       (inlined_functions->length() <= 1)) {
-    PrintFunctionFrameIndexJSON(stack, function);
+    functions->Add(function);
     return;
   }
 
@@ -1696,16 +1710,49 @@ void Profile::ProcessSampleFrameJSON(JSONArray* stack,
     const Function* inlined_function = (*inlined_functions)[i];
     ASSERT(inlined_function != NULL);
     ASSERT(!inlined_function->IsNull());
-    ProcessInlinedFunctionFrameJSON(stack, inlined_function);
+    ProfileFunction* inlined = functions_->LookupOrAdd(*inlined_function);
+    ASSERT(inlined != NULL);
+    functions->Add(inlined);
   }
 }
 
-void Profile::ProcessInlinedFunctionFrameJSON(
-    JSONArray* stack,
-    const Function* inlined_function) {
-  ProfileFunction* function = functions_->LookupOrAdd(*inlined_function);
-  ASSERT(function != NULL);
-  PrintFunctionFrameIndexJSON(stack, function);
+void Profile::PrintFoldedStacks(TextBuffer* buffer) {
+  // Samples with the same stack are merged into one line.
+  CStringMap<intptr_t> counts(zone_);
+  auto* cache = new ProfileCodeInlinedFunctionsCache();
+  GrowableArray<ProfileFunction*> functions;
+  TextBuffer stack(256);
+  for (intptr_t sample_index = 0; sample_index < samples_->length();
+       sample_index++) {
+    ProcessedSample* sample = samples_->At(sample_index);
+    functions.Clear();
+    for (intptr_t frame_index = 0; frame_index < sample->length();
+         frame_index++) {
+      ASSERT(sample->At(frame_index) != 0);
+      CollectSampleFrameFunctions(&functions, cache, sample, frame_index);
+    }
+    if (functions.is_empty()) {
+      continue;
+    }
+    // Folded stacks list the outermost frame first.
+    stack.Clear();
+    for (intptr_t i = functions.length() - 1; i >= 0; i--) {
+      stack.AddString(functions[i]->Name());
+      if (i > 0) {
+        stack.AddChar(';');
+      }
+    }
+    auto* pair = counts.Lookup(stack.buffer());
+    if (pair != NULL) {
+      pair->value++;
+    } else {
+      counts.Insert({zone_->MakeCopyOfString(stack.buffer()), 1});
+    }
+  }
+  auto it = counts.GetIterator();
+  for (auto* pair = it.Next(); pair != NULL; pair = it.Next()) {
+    buffer->Printf("%s %" Pd "\n", pair->key, pair->value);
+  }
 }
 
 void Profile::PrintFunctionFrameIndexJSON(JSONArray* stack,
@@ -1856,6 +1903,20 @@ void ProfilerService::PrintJSON(JSONStream* stream,
                 include_code_samples);
 }
 
+void ProfilerService::PrintFoldedStacks(TextBuffer* buffer,
+                                        int64_t time_origin_micros,
+                                        int64_t time_extent_micros) {
+  Thread* thread = Thread::Current();
+  Isolate* isolate = thread->isolate();
+  NoAllocationSampleFilter filter(isolate->main_port(), Thread::kMutatorTask,
+                                  time_origin_micros, time_extent_micros);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  Profile profile(isolate);
+  profile.Build(thread, &filter, Profiler::sample_buffer());
+  profile.PrintFoldedStacks(buffer);
+}
+
 class ClassAllocationSampleFilter : public SampleFilter {
  public:
   ClassAllocationSampleFilter(Dart_Port port,
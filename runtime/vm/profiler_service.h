@@ -384,6 +384,10 @@ class Profile : public ValueObject {
 
   void PrintProfileJSON(JSONStream* stream, bool include_code_samples);
 
+  // Writes one "outer;...;inner count" line per distinct stack, the folded
+  // stack format read by flame graph and pprof conversion tools.
+  void PrintFoldedStacks(TextBuffer* buffer);
+
   ProfileFunction* FindFunction(const Function& function);
 
  private:
@@ -392,8 +396,10 @@ class Profile : public ValueObject {
                               ProfileCodeInlinedFunctionsCache* cache,
                               ProcessedSample* sample,
                               intptr_t frame_index);
-  void ProcessInlinedFunctionFrameJSON(JSONArray* stack,
-                                       const Function* inlined_function);
+  void CollectSampleFrameFunctions(GrowableArray<ProfileFunction*>* functions,
+                                   ProfileCodeInlinedFunctionsCache* cache,
+                                   ProcessedSample* sample,
+                                   intptr_t frame_index);
   void PrintFunctionFrameIndexJSON(JSONArray* stack, ProfileFunction* function);
   void PrintCodeFrameIndexJSON(JSONArray* stack,
                                ProcessedSample* sample,
@@ -435,6 +441,12 @@ class ProfilerService : public AllStatic {
                                         int64_t time_extent_micros,
                                         bool include_code_samples);
 
+  // Writes the samples of the current isolate's mutator in the given time
+  // window as folded stacks. See Profile::PrintFoldedStacks.
+  static void PrintFoldedStacks(TextBuffer* buffer,
+                                int64_t time_origin_micros,
+                                int64_t time_extent_micros);
+
   static void ClearSamples();
 
  private:
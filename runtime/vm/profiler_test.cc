@@ -481,6 +481,51 @@ ISOLATE_UNIT_TEST_CASE(Profiler_TrivialRecordAllocation) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(Profiler_FoldedStacks) {
+  EnableProfiler();
+  DisableNativeProfileScope dnps;
+  DisableBackgroundCompilationScope dbcs;
+  const char* kScript =
+      "class A {\n"
+      "  var a;\n"
+      "  var b;\n"
+      "}\n"
+      "class B {\n"
+      "  static boo() {\n"
+      "    return new A();\n"
+      "  }\n"
+      "}\n"
+      "main() {\n"
+      "  for (var i = 0; i < 2; i++) {\n"
+      "    B.boo();\n"
+      "  }\n"
+      "}\n";
+
+  const Library& root_library = Library::Handle(LoadTestScript(kScript));
+
+  const Class& class_a = Class::Handle(GetClass(root_library, "A"));
+  EXPECT(!class_a.IsNull());
+  class_a.SetTraceAllocation(true);
+
+  Invoke(root_library, "main");
+
+  {
+    Thread* thread = Thread::Current();
+    Isolate* isolate = thread->isolate();
+    StackZone zone(thread);
+    HANDLESCOPE(thread);
+    Profile profile(isolate);
+    AllocationFilter filter(isolate->main_port(), class_a.id());
+    profile.Build(thread, &filter, Profiler::sample_buffer());
+    EXPECT_EQ(2, profile.sample_count());
+
+    // Both samples have the same stack, so they are folded into one line.
+    TextBuffer buffer(256);
+    profile.PrintFoldedStacks(&buffer);
+    EXPECT_STREQ("main;B.boo 2\n", buffer.buffer());
+  }
+}
+
 #if defined(DART_USE_TCMALLOC) && defined(HOST_OS_LINUX) && defined(DEBUG) &&  \
     defined(HOST_ARCH_X64)
 
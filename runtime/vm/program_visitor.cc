@@ -742,33 +742,28 @@ class PcDescriptorsKeyValueTrait {
   }
 };
 
-void ProgramVisitor::DedupPcDescriptors(Zone* zone, Isolate* isolate) {
-  class DedupPcDescriptorsVisitor
-      : public CodeVisitor,
-        public Dedupper<PcDescriptors, PcDescriptorsKeyValueTrait> {
-   public:
-    explicit DedupPcDescriptorsVisitor(Zone* zone)
-        : Dedupper(zone),
-          pc_descriptor_(PcDescriptors::Handle(zone)) {
-      if (Snapshot::IncludesCode(Dart::vm_snapshot_kind())) {
-        // Prefer existing objects in the VM isolate.
-        AddVMBaseObjects();
-      }
-    }
-
-    void VisitCode(const Code& code) {
-      pc_descriptor_ = code.pc_descriptors();
-      pc_descriptor_ = Dedup(pc_descriptor_);
-      code.set_pc_descriptors(pc_descriptor_);
+class DedupPcDescriptorsVisitor
+    : public CodeVisitor,
+      public Dedupper<PcDescriptors, PcDescriptorsKeyValueTrait> {
+ public:
+  explicit DedupPcDescriptorsVisitor(Zone* zone)
+      : Dedupper(zone),
+        pc_descriptor_(PcDescriptors::Handle(zone)) {
+    if (Snapshot::IncludesCode(Dart::vm_snapshot_kind())) {
+      // Prefer existing objects in the VM isolate.
+      AddVMBaseObjects();
     }
+  }
 
-   private:
-    PcDescriptors& pc_descriptor_;
-  };
+  void VisitCode(const Code& code) {
+    pc_descriptor_ = code.pc_descriptors();
+    pc_descriptor_ = Dedup(pc_descriptor_);
+    code.set_pc_descriptors(pc_descriptor_);
+  }
 
-  DedupPcDescriptorsVisitor visitor(zone);
-  WalkProgram(zone, isolate, &visitor);
-}
+ private:
+  PcDescriptors& pc_descriptor_;
+};
 
 class TypedDataKeyValueTrait {
  public:
@@ -796,67 +791,55 @@ class TypedDataDedupper : public Dedupper<TypedData, TypedDataKeyValueTrait> {
   bool IsCorrectType(const Object& obj) const { return obj.IsTypedData(); }
 };
 
-void ProgramVisitor::DedupDeoptEntries(Zone* zone, Isolate* isolate) {
-  class DedupDeoptEntriesVisitor : public CodeVisitor,
-                                   public TypedDataDedupper {
-   public:
-    explicit DedupDeoptEntriesVisitor(Zone* zone)
-        : TypedDataDedupper(zone),
-          deopt_table_(Array::Handle(zone)),
-          deopt_entry_(TypedData::Handle(zone)),
-          offset_(Smi::Handle(zone)),
-          reason_and_flags_(Smi::Handle(zone)) {}
+class DedupDeoptEntriesVisitor : public CodeVisitor,
+                                 public TypedDataDedupper {
+ public:
+  explicit DedupDeoptEntriesVisitor(Zone* zone)
+      : TypedDataDedupper(zone),
+        deopt_table_(Array::Handle(zone)),
+        deopt_entry_(TypedData::Handle(zone)),
+        offset_(Smi::Handle(zone)),
+        reason_and_flags_(Smi::Handle(zone)) {}
 
-    void VisitCode(const Code& code) {
-      deopt_table_ = code.deopt_info_array();
-      if (deopt_table_.IsNull()) return;
-      intptr_t length = DeoptTable::GetLength(deopt_table_);
-      for (intptr_t i = 0; i < length; i++) {
-        DeoptTable::GetEntry(deopt_table_, i, &offset_, &deopt_entry_,
-                             &reason_and_flags_);
-        ASSERT(!deopt_entry_.IsNull());
-        deopt_entry_ = Dedup(deopt_entry_);
-        ASSERT(!deopt_entry_.IsNull());
-        DeoptTable::SetEntry(deopt_table_, i, offset_, deopt_entry_,
-                             reason_and_flags_);
-      }
+  void VisitCode(const Code& code) {
+    deopt_table_ = code.deopt_info_array();
+    if (deopt_table_.IsNull()) return;
+    intptr_t length = DeoptTable::GetLength(deopt_table_);
+    for (intptr_t i = 0; i < length; i++) {
+      DeoptTable::GetEntry(deopt_table_, i, &offset_, &deopt_entry_,
+                           &reason_and_flags_);
+      ASSERT(!deopt_entry_.IsNull());
+      deopt_entry_ = Dedup(deopt_entry_);
+      ASSERT(!deopt_entry_.IsNull());
+      DeoptTable::SetEntry(deopt_table_, i, offset_, deopt_entry_,
+                           reason_and_flags_);
     }
+  }
 
-   private:
-    Array& deopt_table_;
-    TypedData& deopt_entry_;
-    Smi& offset_;
-    Smi& reason_and_flags_;
-  };
-
-  if (FLAG_precompiled_mode) return;
-  DedupDeoptEntriesVisitor visitor(zone);
-  WalkProgram(zone, isolate, &visitor);
-}
+ private:
+  Array& deopt_table_;
+  TypedData& deopt_entry_;
+  Smi& offset_;
+  Smi& reason_and_flags_;
+};
 
 #if defined(DART_PRECOMPILER)
-void ProgramVisitor::DedupCatchEntryMovesMaps(Zone* zone, Isolate* isolate) {
-  class DedupCatchEntryMovesMapsVisitor : public CodeVisitor,
-                                          public TypedDataDedupper {
-   public:
-    explicit DedupCatchEntryMovesMapsVisitor(Zone* zone)
-        : TypedDataDedupper(zone),
-          catch_entry_moves_maps_(TypedData::Handle(zone)) {}
-
-    void VisitCode(const Code& code) {
-      catch_entry_moves_maps_ = code.catch_entry_moves_maps();
-      catch_entry_moves_maps_ = Dedup(catch_entry_moves_maps_);
-      code.set_catch_entry_moves_maps(catch_entry_moves_maps_);
-    }
+class DedupCatchEntryMovesMapsVisitor : public CodeVisitor,
+                                        public TypedDataDedupper {
+ public:
+  explicit DedupCatchEntryMovesMapsVisitor(Zone* zone)
+      : TypedDataDedupper(zone),
+        catch_entry_moves_maps_(TypedData::Handle(zone)) {}
 
-   private:
-    TypedData& catch_entry_moves_maps_;
-  };
+  void VisitCode(const Code& code) {
+    catch_entry_moves_maps_ = code.catch_entry_moves_maps();
+    catch_entry_moves_maps_ = Dedup(catch_entry_moves_maps_);
+    code.set_catch_entry_moves_maps(catch_entry_moves_maps_);
+  }
 
-  if (!FLAG_precompiled_mode) return;
-  DedupCatchEntryMovesMapsVisitor visitor(zone);
-  WalkProgram(zone, isolate, &visitor);
-}
+ private:
+  TypedData& catch_entry_moves_maps_;
+};
 
 class UnlinkedCallKeyValueTrait {
  public:
@@ -954,31 +937,66 @@ class CodeSourceMapKeyValueTrait {
   }
 };
 
-void ProgramVisitor::DedupCodeSourceMaps(Zone* zone, Isolate* isolate) {
-  class DedupCodeSourceMapsVisitor
-      : public CodeVisitor,
-        public Dedupper<CodeSourceMap, CodeSourceMapKeyValueTrait> {
-   public:
-    explicit DedupCodeSourceMapsVisitor(Zone* zone)
-        : Dedupper(zone), code_source_map_(CodeSourceMap::Handle(zone)) {
-      if (Snapshot::IncludesCode(Dart::vm_snapshot_kind())) {
-        // Prefer existing objects in the VM isolate.
-        AddVMBaseObjects();
-      }
+class DedupCodeSourceMapsVisitor
+    : public CodeVisitor,
+      public Dedupper<CodeSourceMap, CodeSourceMapKeyValueTrait> {
+ public:
+  explicit DedupCodeSourceMapsVisitor(Zone* zone)
+      : Dedupper(zone), code_source_map_(CodeSourceMap::Handle(zone)) {
+    if (Snapshot::IncludesCode(Dart::vm_snapshot_kind())) {
+      // Prefer existing objects in the VM isolate.
+      AddVMBaseObjects();
     }
+  }
 
-    void VisitCode(const Code& code) {
-      code_source_map_ = code.code_source_map();
-      code_source_map_ = Dedup(code_source_map_);
-      code.set_code_source_map(code_source_map_);
+  void VisitCode(const Code& code) {
+    code_source_map_ = code.code_source_map();
+    code_source_map_ = Dedup(code_source_map_);
+    code.set_code_source_map(code_source_map_);
+  }
+
+ private:
+  CodeSourceMap& code_source_map_;
+};
+
+// Forwards each visited Code object to several CodeVisitors, so that passes
+// which only rewrite their own kind of per-Code metadata share one program
+// walk. Each visitor still sees the Code objects in walk order, so it picks
+// the same canonical objects as it would in a walk of its own.
+class CodeVisitorGroup : public CodeVisitor {
+ public:
+  explicit CodeVisitorGroup(Zone* zone) : visitors_(zone, 4) {}
+
+  void Add(CodeVisitor* visitor) { visitors_.Add(visitor); }
+  bool IsEmpty() const { return visitors_.is_empty(); }
+
+  void VisitCode(const Code& code) {
+    for (intptr_t i = 0; i < visitors_.length(); i++) {
+      visitors_[i]->VisitCode(code);
     }
+  }
 
-   private:
-    CodeSourceMap& code_source_map_;
-  };
+ private:
+  GrowableArray<CodeVisitor*> visitors_;
+};
 
-  DedupCodeSourceMapsVisitor visitor(zone);
-  WalkProgram(zone, isolate, &visitor);
+void ProgramVisitor::DedupCodeMetadata(Zone* zone, Isolate* isolate) {
+  CodeVisitorGroup group(zone);
+  DedupPcDescriptorsVisitor pc_descriptors(zone);
+  group.Add(&pc_descriptors);
+  DedupDeoptEntriesVisitor deopt_entries(zone);
+  if (!FLAG_precompiled_mode) {
+    group.Add(&deopt_entries);
+  }
+#if defined(DART_PRECOMPILER)
+  DedupCatchEntryMovesMapsVisitor catch_entry_moves_maps(zone);
+  if (FLAG_precompiled_mode) {
+    group.Add(&catch_entry_moves_maps);
+  }
+#endif
+  DedupCodeSourceMapsVisitor code_source_maps(zone);
+  group.Add(&code_source_maps);
+  WalkProgram(zone, isolate, &group);
 }
 
 class ArrayKeyValueTrait {
@@ -1276,13 +1294,10 @@ void ProgramVisitor::Dedup(Thread* thread) {
   BindStaticCalls(zone, isolate);
   ShareMegamorphicBuckets(zone, isolate);
   NormalizeAndDedupCompressedStackMaps(zone, isolate);
-  DedupPcDescriptors(zone, isolate);
-  DedupDeoptEntries(zone, isolate);
+  DedupCodeMetadata(zone, isolate);
 #if defined(DART_PRECOMPILER)
-  DedupCatchEntryMovesMaps(zone, isolate);
   DedupUnlinkedCalls(zone, isolate);
 #endif
-  DedupCodeSourceMaps(zone, isolate);
   DedupLists(zone, isolate);
 
   // Reduces binary size but obfuscates profiler results.
@@ -107,13 +107,12 @@ class ProgramVisitor : public AllStatic {
   static void ShareMegamorphicBuckets(Zone* zone, Isolate* isolate);
   static void NormalizeAndDedupCompressedStackMaps(Zone* zone,
                                                    Isolate* isolate);
-  static void DedupPcDescriptors(Zone* zone, Isolate* isolate);
-  static void DedupDeoptEntries(Zone* zone, Isolate* isolate);
+  // Deduplicates the PcDescriptors, deopt entries, catch entry moves maps
+  // and CodeSourceMaps of all Code objects in a single program walk.
+  static void DedupCodeMetadata(Zone* zone, Isolate* isolate);
 #if defined(DART_PRECOMPILER)
-  static void DedupCatchEntryMovesMaps(Zone* zone, Isolate* isolate);
   static void DedupUnlinkedCalls(Zone* zone, Isolate* isolate);
 #endif
-  static void DedupCodeSourceMaps(Zone* zone, Isolate* isolate);
   static void DedupLists(Zone* zone, Isolate* isolate);
   static void DedupInstructions(Zone* zone, Isolate* isolate);
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
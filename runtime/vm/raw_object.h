@@ -36,7 +36,11 @@
 
 namespace dart {
 
-// For now there are no compressed pointers.
+// The type of pointer fields in heap objects, as named in VISIT_FROM and
+// VISIT_TO. It is still a full pointer in every build.
+#if defined(DART_COMPRESSED_POINTERS)
+#error "Object layouts do not support compressed pointers yet."
+#endif
 typedef ObjectPtr RawCompressed;
 
 // Forward declarations.
@@ -695,6 +699,7 @@ class ObjectLayout {
   friend class Scavenger;
   template <bool>
   friend class ScavengerVisitorBase;
+  friend class SharedHeap;  // tags_
   friend class ImageReader;  // tags_ check
   friend class ImageWriter;
   friend class AssemblyImageWriter;
@@ -1240,6 +1245,10 @@ class FfiTrampolineDataLayout : public ObjectLayout {
   // Will be 0 for non-callbacks. Check 'callback_target_' to determine if this
   // is a callback or not.
   uint32_t callback_id_;
+
+  // Whether this is a leaf call: one that does not transition out of
+  // generated code, and therefore cannot call back into Dart or block.
+  bool is_leaf_;
 };
 
 class FieldLayout : public ObjectLayout {
@@ -2552,6 +2561,7 @@ class TypedDataLayout : public TypedDataBaseLayout {
   friend class ObjectPoolDeserializationCluster;
   friend class ObjectPoolSerializationCluster;
   friend class ObjectPoolLayout;
+  friend class ReversePc;
   friend class SnapshotReader;
 };
 
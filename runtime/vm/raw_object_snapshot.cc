@@ -22,6 +22,12 @@ DEFINE_FLAG(
     kMaxUint64,
     "Convert TypedData to ExternalTypedData when sending through a message"
     " port after it exceeds certain size in bytes.");
+DEFINE_FLAG(int,
+            out_of_line_typed_data_threshold,
+            256 * KB,
+            "Pass the contents of TypedData in a buffer of their own rather "
+            "than in the snapshot when sending it through a message port "
+            "after it exceeds certain size in bytes.");
 
 #define OFFSET_OF_FROM(obj)                                                    \
   obj.raw()->from() - reinterpret_cast<ObjectPtr*>(obj.raw()->ptr())
@@ -1334,8 +1340,17 @@ TypedDataPtr TypedData::ReadFrom(SnapshotReader* reader,
   intptr_t length_in_bytes = len * element_size;
   NoSafepointScope no_safepoint;
   uint8_t* data = reinterpret_cast<uint8_t*>(result.DataAddr(0));
-  reader->Align(Zone::kAlignment);
-  reader->ReadBytes(data, length_in_bytes);
+  if (reader->Read<bool>()) {
+    ASSERT(kind == Snapshot::kMessage);
+    const FinalizableData finalizable_data =
+        static_cast<MessageSnapshotReader*>(reader)->finalizable_data()->Take();
+    memmove(data, finalizable_data.data, length_in_bytes);
+    // Release the contents now rather than with the message.
+    finalizable_data.callback(nullptr, finalizable_data.peer);
+  } else {
+    reader->Align(Zone::kAlignment);
+    reader->ReadBytes(data, length_in_bytes);
+  }
 
   // If it is a canonical constant make it one.
   // When reading a full snapshot we don't need to canonicalize the object
@@ -1472,8 +1487,28 @@ void TypedDataLayout::WriteTo(SnapshotWriter* writer,
     writer->WriteTags(writer->GetObjectTags(this));
     writer->Write<ObjectPtr>(length_);
     uint8_t* data = reinterpret_cast<uint8_t*>(this->data());
-    writer->Align(Zone::kAlignment);
-    writer->WriteBytes(data, bytes);
+    // Large contents are passed in a buffer of their own, so that the
+    // snapshot buffer does not have to grow to their size and the receiver
+    // can release them as soon as they are read.
+    const bool out_of_line =
+        (kind == Snapshot::kMessage) &&
+        (bytes >= FLAG_out_of_line_typed_data_threshold);
+    writer->Write<bool>(out_of_line);
+    if (out_of_line) {
+      void* passed_data = malloc(bytes);
+      if (passed_data == nullptr) {
+        OUT_OF_MEMORY();
+      }
+      memmove(passed_data, data, bytes);
+      static_cast<MessageWriter*>(writer)->finalizable_data()->Put(
+          bytes,
+          passed_data,  // data
+          passed_data,  // peer,
+          IsolateMessageTypedDataFinalizer);
+    } else {
+      writer->Align(Zone::kAlignment);
+      writer->WriteBytes(data, bytes);
+    }
   }
 }
 
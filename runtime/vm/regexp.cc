@@ -2963,17 +2963,19 @@ void BoyerMooreLookahead::EmitSkipInstructions(RegExpMacroAssembler* masm) {
   }
 
   if (found_single_character) {
-    BlockLabel cont, again;
-    masm->BindBlock(&again);
-    masm->LoadCurrentCharacter(max_lookahead, &cont, true);
+    BlockLabel cont;
     if (max_char_ > kSize) {
+      BlockLabel again;
+      masm->BindBlock(&again);
+      masm->LoadCurrentCharacter(max_lookahead, &cont, true);
       masm->CheckCharacterAfterAnd(single_character,
                                    RegExpMacroAssembler::kTableMask, &cont);
+      masm->AdvanceCurrentPosition(lookahead_width);
+      masm->GoTo(&again);
     } else {
-      masm->CheckCharacter(single_character, &cont);
+      masm->SkipUntilCharacter(max_lookahead, single_character,
+                               lookahead_width, &cont);
     }
-    masm->AdvanceCurrentPosition(lookahead_width);
-    masm->GoTo(&again);
     masm->BindBlock(&cont);
     return;
   }
@@ -2985,14 +2987,9 @@ void BoyerMooreLookahead::EmitSkipInstructions(RegExpMacroAssembler* masm) {
       GetSkipTable(min_lookahead, max_lookahead, boolean_skip_table);
   ASSERT(skip_distance != 0);
 
-  BlockLabel cont, again;
-
-  masm->BindBlock(&again);
-  masm->CheckPreemption(/*is_backtrack=*/false);
-  masm->LoadCurrentCharacter(max_lookahead, &cont, true);
-  masm->CheckBitInTable(boolean_skip_table, &cont);
-  masm->AdvanceCurrentPosition(skip_distance);
-  masm->GoTo(&again);
+  BlockLabel cont;
+  masm->SkipUntilBitInTable(max_lookahead, boolean_skip_table, skip_distance,
+                            &cont);
   masm->BindBlock(&cont);
 
   return;
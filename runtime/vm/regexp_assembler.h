@@ -176,6 +176,36 @@ class RegExpMacroAssembler : public ZoneAllocated {
   // Checks for preemption and serves as an OSR entry.
   virtual void CheckPreemption(bool is_backtrack) {}
 
+  // Advances the current position by 'advance_by' until the character at
+  // 'cp_offset' from it is 'c' or lies outside the input, then jumps to
+  // 'on_done'. Used to quickly skip to the next possible match start.
+  virtual void SkipUntilCharacter(intptr_t cp_offset,
+                                  uint16_t c,
+                                  intptr_t advance_by,
+                                  BlockLabel* on_done) {
+    BlockLabel again;
+    BindBlock(&again);
+    LoadCurrentCharacter(cp_offset, on_done, true);
+    CheckCharacter(c, on_done);
+    AdvanceCurrentPosition(advance_by);
+    GoTo(&again);
+  }
+
+  // Like SkipUntilCharacter, but stops at a character (modulus the kTableSize)
+  // for which the byte in 'table' is non-zero.
+  virtual void SkipUntilBitInTable(intptr_t cp_offset,
+                                   const TypedData& table,
+                                   intptr_t advance_by,
+                                   BlockLabel* on_done) {
+    BlockLabel again;
+    BindBlock(&again);
+    CheckPreemption(/*is_backtrack=*/false);
+    LoadCurrentCharacter(cp_offset, on_done, true);
+    CheckBitInTable(table, on_done);
+    AdvanceCurrentPosition(advance_by);
+    GoTo(&again);
+  }
+
   // Checks whether the given offset from the current position is before
   // the end of the string.  May overwrite the current character.
   virtual void CheckPosition(intptr_t cp_offset, BlockLabel* on_outside_input) {
@@ -11,11 +11,24 @@
 #include "vm/regexp_assembler_bytecode_inl.h"
 #include "vm/regexp_bytecodes.h"
 #include "vm/regexp_interpreter.h"
+#include "vm/regexp_nfa.h"
 #include "vm/regexp_parser.h"
 #include "vm/timeline.h"
 
 namespace dart {
 
+DEFINE_FLAG(int,
+            regexp_bytecode_cache_size,
+            64,
+            "Maximum number of compiled regexps whose bytecode is shared "
+            "with other regexps of the same pattern in the isolate group.");
+DEFINE_FLAG(int,
+            regexp_backtracks_before_fallback,
+            0,
+            "If positive, a regexp match that backtracks more than this many "
+            "times is retried with the linear-time NFA matcher when the "
+            "pattern allows it.");
+
 BytecodeRegExpMacroAssembler::BytecodeRegExpMacroAssembler(
     ZoneGrowableArray<uint8_t>* buffer,
     Zone* zone)
@@ -326,6 +339,37 @@ void BytecodeRegExpMacroAssembler::CheckBitInTable(const TypedData& table,
                                                    BlockLabel* on_bit_set) {
   Emit(BC_CHECK_BIT_IN_TABLE, 0);
   EmitOrLink(on_bit_set);
+  EmitBitTable(table);
+}
+
+void BytecodeRegExpMacroAssembler::SkipUntilCharacter(intptr_t cp_offset,
+                                                      uint16_t c,
+                                                      intptr_t advance_by,
+                                                      BlockLabel* on_done) {
+  ASSERT(cp_offset >= kMinCPOffset);
+  ASSERT(cp_offset <= kMaxCPOffset);
+  ASSERT(Utils::IsUint(16, advance_by));
+  Emit(BC_SKIP_UNTIL_CHAR, cp_offset);
+  Emit16(c);
+  Emit16(advance_by);
+  EmitOrLink(on_done);
+}
+
+void BytecodeRegExpMacroAssembler::SkipUntilBitInTable(intptr_t cp_offset,
+                                                       const TypedData& table,
+                                                       intptr_t advance_by,
+                                                       BlockLabel* on_done) {
+  ASSERT(cp_offset >= kMinCPOffset);
+  ASSERT(cp_offset <= kMaxCPOffset);
+  ASSERT(Utils::IsUint(16, advance_by));
+  Emit(BC_SKIP_UNTIL_BIT_IN_TABLE, cp_offset);
+  Emit16(advance_by);
+  Emit16(0);  // Padding.
+  EmitOrLink(on_done);
+  EmitBitTable(table);
+}
+
+void BytecodeRegExpMacroAssembler::EmitBitTable(const TypedData& table) {
   for (int i = 0; i < kTableSize; i += kBitsPerByte) {
     int byte = 0;
     for (int j = 0; j < kBitsPerByte; j++) {
@@ -419,6 +463,85 @@ void BytecodeRegExpMacroAssembler::Expand() {
     buffer_->Add(0);
 }
 
+// Looks for a regexp with the same pattern and flags in the isolate group's
+// bytecode cache which was already compiled for the given specialization. If
+// found, shares its bytecode and compilation results with 'regexp'.
+static bool CopyCachedBytecode(const RegExp& regexp,
+                               bool is_one_byte,
+                               bool sticky,
+                               Zone* zone) {
+  if (FLAG_regexp_bytecode_cache_size <= 0) {
+    return false;
+  }
+  auto isolate_group = Thread::Current()->isolate_group();
+  SafepointMutexLocker ml(isolate_group->regexp_bytecode_cache_mutex());
+  const auto& cache = GrowableObjectArray::Handle(
+      zone, isolate_group->object_store()->regexp_bytecode_cache());
+  if (cache.IsNull()) {
+    return false;
+  }
+  const auto& pattern = String::Handle(zone, regexp.pattern());
+  auto& cached = RegExp::Handle(zone);
+  auto& cached_pattern = String::Handle(zone);
+  for (intptr_t i = 0; i < cache.Length(); i++) {
+    cached ^= cache.At(i);
+    if ((cached.flags() != regexp.flags()) ||
+        (cached.bytecode(is_one_byte, sticky) == TypedData::null())) {
+      continue;
+    }
+    cached_pattern = cached.pattern();
+    if (!cached_pattern.Equals(pattern)) {
+      continue;
+    }
+    regexp.set_num_bracket_expressions(
+        Smi::Value(cached.num_bracket_expressions()));
+    regexp.set_capture_name_map(
+        Array::Handle(zone, cached.capture_name_map()));
+    if (cached.is_simple()) {
+      regexp.set_is_simple();
+    } else {
+      regexp.set_is_complex();
+    }
+    regexp.set_num_registers(is_one_byte, cached.num_registers(is_one_byte));
+    regexp.set_bytecode(
+        is_one_byte, sticky,
+        TypedData::Handle(zone, cached.bytecode(is_one_byte, sticky)));
+    return true;
+  }
+  return false;
+}
+
+// Adds a freshly compiled regexp to the isolate group's bytecode cache,
+// evicting the oldest entry if the cache is full.
+static void AddToBytecodeCache(const RegExp& regexp, Zone* zone) {
+  if (FLAG_regexp_bytecode_cache_size <= 0) {
+    return;
+  }
+  auto isolate_group = Thread::Current()->isolate_group();
+  SafepointMutexLocker ml(isolate_group->regexp_bytecode_cache_mutex());
+  auto object_store = isolate_group->object_store();
+  auto& cache =
+      GrowableObjectArray::Handle(zone, object_store->regexp_bytecode_cache());
+  if (cache.IsNull()) {
+    cache = GrowableObjectArray::New(Heap::kOld);
+    object_store->set_regexp_bytecode_cache(cache);
+  }
+  for (intptr_t i = 0; i < cache.Length(); i++) {
+    if (cache.At(i) == regexp.raw()) {
+      return;
+    }
+  }
+  if (cache.Length() >= FLAG_regexp_bytecode_cache_size) {
+    auto& entry = Object::Handle(zone);
+    for (intptr_t i = 1; i < cache.Length(); i++) {
+      entry = cache.At(i);
+      cache.SetAt(i - 1, entry);
+    }
+    cache.SetLength(cache.Length() - 1);
+  }
+  cache.Add(regexp, Heap::kOld);
+}
+
 static intptr_t Prepare(const RegExp& regexp,
                         const String& subject,
                         bool sticky,
@@ -426,7 +549,8 @@ static intptr_t Prepare(const RegExp& regexp,
   bool is_one_byte =
       subject.IsOneByteString() || subject.IsExternalOneByteString();
 
-  if (regexp.bytecode(is_one_byte, sticky) == TypedData::null()) {
+  if (regexp.bytecode(is_one_byte, sticky) == TypedData::null() &&
+      !CopyCachedBytecode(regexp, is_one_byte, sticky, zone)) {
     const String& pattern = String::Handle(zone, regexp.pattern());
 #if defined(SUPPORT_TIMELINE)
     TimelineBeginEndScope tbes(Thread::Current(), Timeline::GetCompilerStream(),
@@ -460,6 +584,7 @@ static intptr_t Prepare(const RegExp& regexp,
            regexp.num_registers(is_one_byte) == result.num_registers);
     regexp.set_num_registers(is_one_byte, result.num_registers);
     regexp.set_bytecode(is_one_byte, sticky, *(result.bytecode));
+    AddToBytecodeCache(regexp, zone);
   }
 
   ASSERT(regexp.num_registers(is_one_byte) != -1);
@@ -496,8 +621,21 @@ static IrregexpInterpreter::IrregexpResult ExecRaw(const RegExp& regexp,
   const TypedData& bytecode =
       TypedData::Handle(zone, regexp.bytecode(is_one_byte, sticky));
   ASSERT(!bytecode.IsNull());
-  IrregexpInterpreter::IrregexpResult result =
-      IrregexpInterpreter::Match(bytecode, subject, raw_output, index, zone);
+  IrregexpInterpreter::IrregexpResult result = IrregexpInterpreter::Match(
+      bytecode, subject, raw_output, index,
+      FLAG_regexp_backtracks_before_fallback, zone);
+
+  if (result == IrregexpInterpreter::RE_BACKTRACK_LIMIT &&
+      !RegExpNfa::Match(regexp, subject, index, sticky, raw_output, zone,
+                        &result)) {
+    // The NFA cannot express this pattern, so keep backtracking without a
+    // limit.
+    for (int i = number_of_capture_registers - 1; i >= 0; i--) {
+      raw_output[i] = -1;
+    }
+    result = IrregexpInterpreter::Match(bytecode, subject, raw_output, index,
+                                        /*backtrack_limit=*/0, zone);
+  }
 
   if (result == IrregexpInterpreter::RE_SUCCESS) {
     // Copy capture results to the start of the registers array.
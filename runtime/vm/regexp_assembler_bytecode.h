@@ -78,6 +78,14 @@ class BytecodeRegExpMacroAssembler : public RegExpMacroAssembler {
                                         uint16_t to,
                                         BlockLabel* on_not_in_range);
   virtual void CheckBitInTable(const TypedData& table, BlockLabel* on_bit_set);
+  virtual void SkipUntilCharacter(intptr_t cp_offset,
+                                  uint16_t c,
+                                  intptr_t advance_by,
+                                  BlockLabel* on_done);
+  virtual void SkipUntilBitInTable(intptr_t cp_offset,
+                                   const TypedData& table,
+                                   intptr_t advance_by,
+                                   BlockLabel* on_done);
   virtual void CheckNotBackReference(intptr_t start_reg,
                                      bool read_backward,
                                      BlockLabel* on_no_match);
@@ -121,6 +129,8 @@ class BytecodeRegExpMacroAssembler : public RegExpMacroAssembler {
   inline void Emit16(uint32_t x);
   inline void Emit8(uint32_t x);
   inline void Emit(uint32_t bc, uint32_t arg);
+  // Emits the 128-bit bitmap of the given kTableSize byte table.
+  void EmitBitTable(const TypedData& table);
   // Bytecode buffer.
   intptr_t length();
 
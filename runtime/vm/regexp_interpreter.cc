@@ -170,12 +170,15 @@ class BacktrackStack {
 };
 
 template <typename Char>
-static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
-                                                    const String& subject,
-                                                    int32_t* registers,
-                                                    intptr_t current,
-                                                    uint32_t current_char,
-                                                    Zone* zone) {
+static IrregexpInterpreter::IrregexpResult RawMatch(
+    const uint8_t* code_base,
+    const String& subject,
+    const uint8_t* one_byte_data,
+    int32_t* registers,
+    intptr_t current,
+    uint32_t current_char,
+    intptr_t backtrack_limit,
+    Zone* zone) {
   const uint8_t* pc = code_base;
   // BacktrackStack ensures that the memory allocated for the backtracking stack
   // is returned to the system or cached if there is no stack being cached at
@@ -190,6 +193,7 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
   unibrow::Mapping<unibrow::Ecma262Canonicalize> canonicalize;
 
   intptr_t subject_length = subject.Length();
+  intptr_t backtrack_count = 0;
 
 #ifdef DEBUG
   if (FLAG_trace_regexp_bytecodes) {
@@ -258,6 +262,10 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
       pc += BC_POP_CP_LENGTH;
       break;
       BYTECODE(POP_BT)
+      if (UNLIKELY(backtrack_limit > 0) &&
+          ++backtrack_count > backtrack_limit) {
+        return IrregexpInterpreter::RE_BACKTRACK_LIMIT;
+      }
       backtrack_stack_space++;
       --backtrack_sp;
       pc = code_base + *backtrack_sp;
@@ -457,6 +465,51 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
         }
         break;
       }
+      BYTECODE(SKIP_UNTIL_CHAR) {
+        const intptr_t load_offset = insn >> BYTECODE_SHIFT;
+        const uint32_t c = Load16Aligned(pc + 4);
+        const intptr_t advance = Load16Aligned(pc + 6);
+        pc = code_base + Load32Aligned(pc + 8);
+        const intptr_t start = current + load_offset;
+        if (advance == 1 && one_byte_data != nullptr && c <= 0xff &&
+            start >= 0 && start < subject_length) {
+          const void* found =
+              memchr(one_byte_data + start, c, subject_length - start);
+          if (found != nullptr) {
+            current = static_cast<const uint8_t*>(found) - one_byte_data;
+            current -= load_offset;
+            current_char = c;
+          } else {
+            current = subject_length - load_offset;
+          }
+          break;
+        }
+        while (true) {
+          const intptr_t pos = current + load_offset;
+          if (pos < 0 || pos >= subject_length) break;
+          current_char = subject.CharAt(pos);
+          if (current_char == c) break;
+          current += advance;
+        }
+        break;
+      }
+      BYTECODE(SKIP_UNTIL_BIT_IN_TABLE) {
+        const intptr_t load_offset = insn >> BYTECODE_SHIFT;
+        const intptr_t advance = Load16Aligned(pc + 4);
+        const uint8_t* table = pc + 12;
+        const int mask = RegExpMacroAssembler::kTableMask;
+        pc = code_base + Load32Aligned(pc + 8);
+        while (true) {
+          const intptr_t pos = current + load_offset;
+          if (pos < 0 || pos >= subject_length) break;
+          current_char = subject.CharAt(pos);
+          const uint8_t b = table[(current_char & mask) >> kBitsPerByteLog2];
+          const int bit = (current_char & (kBitsPerByte - 1));
+          if ((b & (1 << bit)) != 0) break;
+          current += advance;
+        }
+        break;
+      }
       BYTECODE(CHECK_BIT_IN_TABLE) {
         int mask = RegExpMacroAssembler::kTableMask;
         uint8_t b = pc[8 + ((current_char & mask) >> kBitsPerByteLog2)];
@@ -654,6 +707,7 @@ IrregexpInterpreter::IrregexpResult IrregexpInterpreter::Match(
     const String& subject,
     int32_t* registers,
     intptr_t start_position,
+    intptr_t backtrack_limit,
     Zone* zone) {
   NoSafepointScope no_safepoint;
   const uint8_t* code_base = reinterpret_cast<uint8_t*>(bytecode.DataAddr(0));
@@ -663,12 +717,22 @@ IrregexpInterpreter::IrregexpResult IrregexpInterpreter::Match(
     previous_char = subject.CharAt(start_position - 1);
   }
 
-  if (subject.IsOneByteString() || subject.IsExternalOneByteString()) {
-    return RawMatch<uint8_t>(code_base, subject, registers, start_position,
-                             previous_char, zone);
+  // Direct access to the characters of one-byte subjects, used to skip ahead
+  // with memchr.
+  if (subject.IsOneByteString()) {
+    return RawMatch<uint8_t>(code_base, subject,
+                             OneByteString::DataStart(subject), registers,
+                             start_position, previous_char, backtrack_limit,
+                             zone);
+  } else if (subject.IsExternalOneByteString()) {
+    return RawMatch<uint8_t>(code_base, subject,
+                             ExternalOneByteString::DataStart(subject),
+                             registers, start_position, previous_char,
+                             backtrack_limit, zone);
   } else if (subject.IsTwoByteString() || subject.IsExternalTwoByteString()) {
-    return RawMatch<uint16_t>(code_base, subject, registers, start_position,
-                              previous_char, zone);
+    return RawMatch<uint16_t>(code_base, subject, /*one_byte_data=*/nullptr,
+                              registers, start_position, previous_char,
+                              backtrack_limit, zone);
   } else {
     UNREACHABLE();
     return IrregexpInterpreter::RE_FAILURE;
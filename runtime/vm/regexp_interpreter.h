@@ -15,12 +15,21 @@ namespace dart {
 
 class IrregexpInterpreter : public AllStatic {
  public:
-  enum IrregexpResult { RE_FAILURE = 0, RE_SUCCESS = 1, RE_EXCEPTION = -1 };
-
+  enum IrregexpResult {
+    RE_FAILURE = 0,
+    RE_SUCCESS = 1,
+    RE_EXCEPTION = -1,
+    // The match backtracked more than the given limit and was abandoned.
+    RE_BACKTRACK_LIMIT = -2,
+  };
+
+  // If [backtrack_limit] is positive, the match is abandoned with
+  // RE_BACKTRACK_LIMIT once it has backtracked that many times.
   static IrregexpResult Match(const TypedData& bytecode,
                               const String& subject,
                               int32_t* captures,
                               intptr_t start_position,
+                              intptr_t backtrack_limit,
                               Zone* zone);
 };
 
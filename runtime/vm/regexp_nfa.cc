@@ -0,0 +1,493 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/regexp_nfa.h"
+
+#include "platform/unicode.h"
+#include "vm/growable_array.h"
+#include "vm/regexp.h"
+#include "vm/regexp_ast.h"
+#include "vm/regexp_parser.h"
+
+namespace dart {
+
+// Patterns whose quantifiers unroll to more instructions than this are left
+// to the backtracking interpreter.
+static const intptr_t kMaxNfaProgramLength = 1 << 16;
+
+struct NfaInstruction {
+  enum Opcode {
+    // Consume one code unit in the range [from, to].
+    kConsumeRange,
+    // Continue only if the RegExpAssertion::AssertionType [payload] holds.
+    kAssertion,
+    // Continue at the next instruction and, with lower priority, at [target].
+    kFork,
+    kJump,
+    kSetRegisterToCp,
+    kClearRegister,
+    kFail,
+    kAccept,
+  };
+
+  Opcode opcode;
+  int32_t payload;
+  int32_t to;
+};
+
+static bool CanBeHandled(RegExpTree* tree) {
+  if (tree->IsLookaround() || tree->IsBackReference()) {
+    return false;
+  }
+  if (RegExpDisjunction* disjunction = tree->AsDisjunction()) {
+    ZoneGrowableArray<RegExpTree*>* alternatives = disjunction->alternatives();
+    for (intptr_t i = 0; i < alternatives->length(); i++) {
+      if (!CanBeHandled(alternatives->At(i))) return false;
+    }
+  } else if (RegExpAlternative* alternative = tree->AsAlternative()) {
+    ZoneGrowableArray<RegExpTree*>* nodes = alternative->nodes();
+    for (intptr_t i = 0; i < nodes->length(); i++) {
+      if (!CanBeHandled(nodes->At(i))) return false;
+    }
+  } else if (RegExpQuantifier* quantifier = tree->AsQuantifier()) {
+    return !quantifier->is_possessive() && CanBeHandled(quantifier->body());
+  } else if (RegExpCapture* capture = tree->AsCapture()) {
+    return CanBeHandled(capture->body());
+  }
+  return true;
+}
+
+// Translates a regexp tree into a program for the NfaInterpreter.
+class NfaCompiler : public RegExpVisitor {
+ public:
+  NfaCompiler() : code_(64) {}
+
+  // Returns false if the program would be too large.
+  bool Compile(RegExpTree* tree) {
+    Emit(NfaInstruction::kSetRegisterToCp, RegExpCapture::StartRegister(0));
+    tree->Accept(this, nullptr);
+    Emit(NfaInstruction::kSetRegisterToCp, RegExpCapture::EndRegister(0));
+    Emit(NfaInstruction::kAccept);
+    return code_.length() <= kMaxNfaProgramLength;
+  }
+
+  const GrowableArray<NfaInstruction>& code() const { return code_; }
+
+  virtual void* VisitDisjunction(RegExpDisjunction* node, void* data) {
+    ZoneGrowableArray<RegExpTree*>* alternatives = node->alternatives();
+    GrowableArray<intptr_t> jumps_to_end;
+    for (intptr_t i = 0; i < alternatives->length() - 1; i++) {
+      const intptr_t fork = Emit(NfaInstruction::kFork);
+      alternatives->At(i)->Accept(this, data);
+      jumps_to_end.Add(Emit(NfaInstruction::kJump));
+      Bind(fork);
+    }
+    alternatives->Last()->Accept(this, data);
+    for (intptr_t i = 0; i < jumps_to_end.length(); i++) {
+      Bind(jumps_to_end[i]);
+    }
+    return nullptr;
+  }
+
+  virtual void* VisitAlternative(RegExpAlternative* node, void* data) {
+    ZoneGrowableArray<RegExpTree*>* nodes = node->nodes();
+    for (intptr_t i = 0; i < nodes->length(); i++) {
+      nodes->At(i)->Accept(this, data);
+    }
+    return nullptr;
+  }
+
+  virtual void* VisitAssertion(RegExpAssertion* node, void* data) {
+    Emit(NfaInstruction::kAssertion, node->assertion_type());
+    return nullptr;
+  }
+
+  virtual void* VisitCharacterClass(RegExpCharacterClass* node, void* data) {
+    Zone* zone = Thread::Current()->zone();
+    ZoneGrowableArray<CharacterRange>* ranges = node->ranges();
+    auto copy = new (zone) ZoneGrowableArray<CharacterRange>(ranges->length());
+    for (intptr_t i = 0; i < ranges->length(); i++) {
+      copy->Add(ranges->At(i));
+    }
+    // None of the standard character classes is different in the case
+    // independent case.
+    if (node->flags().IgnoreCase() && !node->is_standard()) {
+      CharacterRange::AddCaseEquivalents(copy, /*is_one_byte=*/false, zone);
+    }
+    CharacterRange::Canonicalize(copy);
+    if (node->is_negated()) {
+      auto negated = new (zone) ZoneGrowableArray<CharacterRange>(
+          copy->length() + 1);
+      CharacterRange::Negate(copy, negated);
+      copy = negated;
+    }
+    EmitRanges(copy);
+    return nullptr;
+  }
+
+  virtual void* VisitAtom(RegExpAtom* node, void* data) {
+    Zone* zone = Thread::Current()->zone();
+    ZoneGrowableArray<uint16_t>* chars = node->data();
+    for (intptr_t i = 0; i < chars->length(); i++) {
+      const uint16_t c = chars->At(i);
+      if (node->ignore_case()) {
+        auto ranges =
+            CharacterRange::List(zone, CharacterRange::Singleton(c));
+        CharacterRange::AddCaseEquivalents(ranges, /*is_one_byte=*/false,
+                                           zone);
+        CharacterRange::Canonicalize(ranges);
+        EmitRanges(ranges);
+      } else {
+        Emit(NfaInstruction::kConsumeRange, c, c);
+      }
+    }
+    return nullptr;
+  }
+
+  virtual void* VisitText(RegExpText* node, void* data) {
+    GrowableArray<TextElement>* elements = node->elements();
+    for (intptr_t i = 0; i < elements->length(); i++) {
+      elements->At(i).tree()->Accept(this, data);
+    }
+    return nullptr;
+  }
+
+  virtual void* VisitQuantifier(RegExpQuantifier* node, void* data) {
+    RegExpTree* body = node->body();
+    const bool greedy = !node->is_non_greedy();
+    for (intptr_t i = 0; i < node->min(); i++) {
+      if (TooLarge()) return nullptr;
+      EmitIteration(body, data);
+    }
+    if (node->max() == RegExpTree::kInfinity) {
+      // An iteration matching the empty string revisits the loop head at the
+      // same position, which the interpreter treats as a dead thread.
+      const intptr_t loop_head = code_.length();
+      const intptr_t fork = Emit(NfaInstruction::kFork);
+      if (greedy) {
+        EmitIteration(body, data);
+        Emit(NfaInstruction::kJump, loop_head);
+        Bind(fork);
+      } else {
+        const intptr_t exit = Emit(NfaInstruction::kJump);
+        Bind(fork);
+        EmitIteration(body, data);
+        Emit(NfaInstruction::kJump, loop_head);
+        Bind(exit);
+      }
+      return nullptr;
+    }
+    GrowableArray<intptr_t> jumps_to_end;
+    for (intptr_t i = node->min(); i < node->max(); i++) {
+      if (TooLarge()) return nullptr;
+      const intptr_t fork = Emit(NfaInstruction::kFork);
+      if (greedy) {
+        jumps_to_end.Add(fork);
+      } else {
+        jumps_to_end.Add(Emit(NfaInstruction::kJump));
+        Bind(fork);
+      }
+      EmitIteration(body, data);
+    }
+    for (intptr_t i = 0; i < jumps_to_end.length(); i++) {
+      Bind(jumps_to_end[i]);
+    }
+    return nullptr;
+  }
+
+  virtual void* VisitCapture(RegExpCapture* node, void* data) {
+    Emit(NfaInstruction::kSetRegisterToCp,
+         RegExpCapture::StartRegister(node->index()));
+    node->body()->Accept(this, data);
+    Emit(NfaInstruction::kSetRegisterToCp,
+         RegExpCapture::EndRegister(node->index()));
+    return nullptr;
+  }
+
+  virtual void* VisitLookaround(RegExpLookaround* node, void* data) {
+    UNREACHABLE();
+    return nullptr;
+  }
+
+  virtual void* VisitBackReference(RegExpBackReference* node, void* data) {
+    UNREACHABLE();
+    return nullptr;
+  }
+
+  virtual void* VisitEmpty(RegExpEmpty* node, void* data) { return nullptr; }
+
+ private:
+  intptr_t Emit(NfaInstruction::Opcode opcode,
+                int32_t payload = 0,
+                int32_t to = 0) {
+    NfaInstruction instruction = {opcode, payload, to};
+    code_.Add(instruction);
+    return code_.length() - 1;
+  }
+
+  // Points the kFork or kJump at [index] to the next instruction.
+  void Bind(intptr_t index) { code_[index].payload = code_.length(); }
+
+  bool TooLarge() const { return code_.length() > kMaxNfaProgramLength; }
+
+  // Each iteration of a quantifier starts with its captures cleared.
+  void EmitIteration(RegExpTree* body, void* data) {
+    const Interval captures = body->CaptureRegisters();
+    if (!captures.is_empty()) {
+      for (intptr_t i = captures.from(); i <= captures.to(); i++) {
+        Emit(NfaInstruction::kClearRegister, i);
+      }
+    }
+    body->Accept(this, data);
+  }
+
+  // Emits a choice between the given canonical ranges, restricted to code
+  // units.
+  void EmitRanges(ZoneGrowableArray<CharacterRange>* ranges) {
+    intptr_t count = 0;
+    while (count < ranges->length() &&
+           ranges->At(count).from() <= Utf16::kMaxCodeUnit) {
+      count++;
+    }
+    if (count == 0) {
+      Emit(NfaInstruction::kFail);
+      return;
+    }
+    GrowableArray<intptr_t> jumps_to_end;
+    for (intptr_t i = 0; i < count; i++) {
+      const CharacterRange& range = ranges->At(i);
+      const bool is_last = i == count - 1;
+      const intptr_t fork = is_last ? -1 : Emit(NfaInstruction::kFork);
+      Emit(NfaInstruction::kConsumeRange, range.from(),
+           Utils::Minimum<int32_t>(range.to(), Utf16::kMaxCodeUnit));
+      if (!is_last) {
+        jumps_to_end.Add(Emit(NfaInstruction::kJump));
+        Bind(fork);
+      }
+    }
+    for (intptr_t i = 0; i < jumps_to_end.length(); i++) {
+      Bind(jumps_to_end[i]);
+    }
+  }
+
+  GrowableArray<NfaInstruction> code_;
+
+  DISALLOW_COPY_AND_ASSIGN(NfaCompiler);
+};
+
+// Runs all NFA threads in lockstep over the subject. Threads are kept in
+// priority order so that the first accepting thread gives the same match as
+// the backtracking interpreter would.
+class NfaInterpreter : public ValueObject {
+ public:
+  NfaInterpreter(const GrowableArray<NfaInstruction>& code,
+                 const String& subject,
+                 intptr_t register_count,
+                 Zone* zone)
+      : code_(code),
+        subject_(subject),
+        subject_length_(subject.Length()),
+        register_count_(register_count),
+        zone_(zone),
+        last_visited_(zone->Alloc<intptr_t>(code.length())) {
+    for (intptr_t i = 0; i < code.length(); i++) {
+      last_visited_[i] = -1;
+    }
+  }
+
+  bool Match(intptr_t start_position, bool sticky, int32_t* output) {
+    GrowableArray<NfaThread> current;
+    GrowableArray<NfaThread> next;
+    bool matched = false;
+    for (intptr_t position = start_position; position <= subject_length_;
+         position++) {
+      if (!matched && (!sticky || position == start_position)) {
+        // A fresh thread starting here has the lowest priority.
+        int32_t* registers = NewRegisters();
+        for (intptr_t i = 0; i < register_count_; i++) {
+          registers[i] = -1;
+        }
+        AddThread(&current, 0, registers, position);
+      }
+      if (current.is_empty()) {
+        if (matched || sticky) break;
+        continue;
+      }
+      const int32_t c =
+          position < subject_length_ ? subject_.CharAt(position) : -1;
+      for (intptr_t i = 0; i < current.length(); i++) {
+        const NfaThread& thread = current[i];
+        const NfaInstruction& instruction = code_[thread.pc];
+        if (instruction.opcode == NfaInstruction::kAccept) {
+          memmove(output, thread.registers, register_count_ * sizeof(int32_t));
+          matched = true;
+          // Threads of lower priority can no longer produce the match.
+          for (intptr_t j = i; j < current.length(); j++) {
+            free_registers_.Add(current[j].registers);
+          }
+          break;
+        }
+        ASSERT(instruction.opcode == NfaInstruction::kConsumeRange);
+        if (instruction.payload <= c && c <= instruction.to) {
+          AddThread(&next, thread.pc + 1, thread.registers, position + 1);
+        } else {
+          free_registers_.Add(thread.registers);
+        }
+      }
+      current.Clear();
+      for (intptr_t i = 0; i < next.length(); i++) {
+        current.Add(next[i]);
+      }
+      next.Clear();
+    }
+    return matched;
+  }
+
+ private:
+  struct NfaThread {
+    intptr_t pc;
+    int32_t* registers;
+  };
+
+  int32_t* NewRegisters() {
+    if (!free_registers_.is_empty()) {
+      return free_registers_.RemoveLast();
+    }
+    return zone_->Alloc<int32_t>(register_count_);
+  }
+
+  bool IsWordCharacter(intptr_t position) const {
+    if (position < 0 || position >= subject_length_) return false;
+    const uint16_t c = subject_.CharAt(position);
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+  }
+
+  bool IsLineTerminator(intptr_t position) const {
+    const uint16_t c = subject_.CharAt(position);
+    return c == '\n' || c == '\r' || c == 0x2028 || c == 0x2029;
+  }
+
+  bool AssertionHolds(intptr_t type, intptr_t position) const {
+    switch (type) {
+      case RegExpAssertion::START_OF_INPUT:
+        return position == 0;
+      case RegExpAssertion::END_OF_INPUT:
+        return position == subject_length_;
+      case RegExpAssertion::START_OF_LINE:
+        return position == 0 || IsLineTerminator(position - 1);
+      case RegExpAssertion::END_OF_LINE:
+        return position == subject_length_ || IsLineTerminator(position);
+      case RegExpAssertion::BOUNDARY:
+        return IsWordCharacter(position - 1) != IsWordCharacter(position);
+      case RegExpAssertion::NON_BOUNDARY:
+        return IsWordCharacter(position - 1) == IsWordCharacter(position);
+    }
+    UNREACHABLE();
+    return false;
+  }
+
+  // Follows the thread through all instructions that do not consume input
+  // and appends the resulting threads to [list] in priority order.
+  void AddThread(GrowableArray<NfaThread>* list,
+                 intptr_t pc,
+                 int32_t* registers,
+                 intptr_t position) {
+    NfaThread start = {pc, registers};
+    pending_.Add(start);
+    while (!pending_.is_empty()) {
+      NfaThread thread = pending_.RemoveLast();
+      bool alive = true;
+      while (alive) {
+        if (last_visited_[thread.pc] == position) {
+          // A thread of higher priority already got here.
+          alive = false;
+          break;
+        }
+        last_visited_[thread.pc] = position;
+        const NfaInstruction& instruction = code_[thread.pc];
+        switch (instruction.opcode) {
+          case NfaInstruction::kConsumeRange:
+          case NfaInstruction::kAccept:
+            list->Add(thread);
+            thread.registers = nullptr;
+            alive = false;
+            break;
+          case NfaInstruction::kAssertion:
+            alive = AssertionHolds(instruction.payload, position);
+            thread.pc++;
+            break;
+          case NfaInstruction::kFork: {
+            int32_t* copy = NewRegisters();
+            memmove(copy, thread.registers, register_count_ * sizeof(int32_t));
+            NfaThread forked = {instruction.payload, copy};
+            pending_.Add(forked);
+            thread.pc++;
+            break;
+          }
+          case NfaInstruction::kJump:
+            thread.pc = instruction.payload;
+            break;
+          case NfaInstruction::kSetRegisterToCp:
+            thread.registers[instruction.payload] = position;
+            thread.pc++;
+            break;
+          case NfaInstruction::kClearRegister:
+            thread.registers[instruction.payload] = -1;
+            thread.pc++;
+            break;
+          case NfaInstruction::kFail:
+            alive = false;
+            break;
+        }
+      }
+      if (thread.registers != nullptr) {
+        free_registers_.Add(thread.registers);
+      }
+    }
+  }
+
+  const GrowableArray<NfaInstruction>& code_;
+  const String& subject_;
+  const intptr_t subject_length_;
+  const intptr_t register_count_;
+  Zone* zone_;
+  // The position at which each instruction was last reached, so every
+  // instruction holds at most one thread per position.
+  intptr_t* last_visited_;
+  GrowableArray<NfaThread> pending_;
+  GrowableArray<int32_t*> free_registers_;
+
+  DISALLOW_COPY_AND_ASSIGN(NfaInterpreter);
+};
+
+bool RegExpNfa::Match(const RegExp& regexp,
+                      const String& subject,
+                      intptr_t start_position,
+                      bool sticky,
+                      int32_t* registers,
+                      Zone* zone,
+                      IrregexpInterpreter::IrregexpResult* result) {
+  if (regexp.flags().IsUnicode()) {
+    return false;
+  }
+  const String& pattern = String::Handle(zone, regexp.pattern());
+  RegExpCompileData* compile_data = new (zone) RegExpCompileData();
+  RegExpParser::ParseRegExp(pattern, regexp.flags(), compile_data);
+  if (!CanBeHandled(compile_data->tree)) {
+    return false;
+  }
+  NfaCompiler compiler;
+  if (!compiler.Compile(compile_data->tree)) {
+    return false;
+  }
+  NfaInterpreter interpreter(compiler.code(), subject,
+                             (compile_data->capture_count + 1) * 2, zone);
+  *result = interpreter.Match(start_position, sticky, registers)
+                ? IrregexpInterpreter::RE_SUCCESS
+                : IrregexpInterpreter::RE_FAILURE;
+  return true;
+}
+
+}  // namespace dart
@@ -0,0 +1,38 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// A linear-time regexp matcher simulating a Thompson NFA (a "Pike VM").
+
+#ifndef RUNTIME_VM_REGEXP_NFA_H_
+#define RUNTIME_VM_REGEXP_NFA_H_
+
+#include "vm/allocation.h"
+#include "vm/object.h"
+#include "vm/regexp_interpreter.h"
+#include "vm/zone.h"
+
+namespace dart {
+
+// Used as a fallback when the backtracking IrregexpInterpreter exceeds its
+// backtrack budget. The running time is bounded by the product of the
+// subject length and the pattern size, but only patterns without back
+// references, lookarounds and possessive quantifiers, and without the
+// unicode flag, are supported.
+class RegExpNfa : public AllStatic {
+ public:
+  // Returns false without touching [result] if [regexp] uses features the
+  // NFA does not support. Otherwise stores the outcome of the match in
+  // [result] and, on success, the capture positions in [registers].
+  static bool Match(const RegExp& regexp,
+                    const String& subject,
+                    intptr_t start_position,
+                    bool sticky,
+                    int32_t* registers,
+                    Zone* zone,
+                    IrregexpInterpreter::IrregexpResult* result);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_REGEXP_NFA_H_
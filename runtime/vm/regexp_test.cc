@@ -7,6 +7,7 @@
 #include "vm/isolate.h"
 #include "vm/object.h"
 #include "vm/regexp.h"
+#include "vm/regexp_assembler_bytecode.h"
 #include "vm/regexp_assembler_ir.h"
 #include "vm/unit_test.h"
 
@@ -108,4 +109,30 @@ ISOLATE_UNIT_TEST_CASE(RegExp_ExternalTwoByteString) {
   EXPECT_EQ(3, smi_2.Value());
 }
 
+ISOLATE_UNIT_TEST_CASE(RegExp_SharesCachedBytecode) {
+  Zone* zone = thread->zone();
+  const String& pat = String::Handle(String::New("b(c)"));
+  const String& str = String::Handle(String::New("abcba"));
+  const RegExp& first =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+  const RegExp& second =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+  const Smi& idx = Object::smi_zero();
+
+  const Array& res_1 = Array::Handle(Array::RawCast(
+      BytecodeRegExpMacroAssembler::Interpret(first, str, idx,
+                                              /*is_sticky=*/false, zone)));
+  EXPECT_EQ(4, res_1.Length());
+  const Array& res_2 = Array::Handle(Array::RawCast(
+      BytecodeRegExpMacroAssembler::Interpret(second, str, idx,
+                                              /*is_sticky=*/false, zone)));
+  EXPECT_EQ(4, res_2.Length());
+
+  // The second regexp reuses the bytecode compiled for the first one.
+  EXPECT(first.bytecode(/*is_one_byte=*/true, /*sticky=*/false) ==
+         second.bytecode(/*is_one_byte=*/true, /*sticky=*/false));
+  EXPECT_EQ(Smi::Value(first.num_bracket_expressions()),
+            Smi::Value(second.num_bracket_expressions()));
+}
+
 }  // namespace dart
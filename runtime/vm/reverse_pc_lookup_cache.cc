@@ -10,6 +10,51 @@
 
 namespace dart {
 
+#if defined(DART_PRECOMPILED_RUNTIME)
+TypedDataPtr ReversePc::BuildIndex(const Array& order_table, uword end) {
+  const intptr_t count = order_table.Length();
+  if (count == 0) {
+    return TypedData::null();
+  }
+  Code& code = Code::Handle();
+  code ^= order_table.At(0);
+  const uword base = code.PayloadStart();
+  ASSERT(end >= base);
+  const uword size = end - base;
+  RELEASE_ASSERT(size <= kMaxUint32);
+  const intptr_t num_pages =
+      Utils::RoundUp(size, static_cast<uword>(1) << kPageSizeLog2) >>
+      kPageSizeLog2;
+  const intptr_t first_start_entry = kFirstPageEntry + num_pages + 1;
+  const TypedData& index = TypedData::Handle(
+      TypedData::New(kTypedDataUint32ArrayCid, first_start_entry + count + 1,
+                     Heap::kOld));
+
+  index.SetUint32(kNumPagesEntry * sizeof(uint32_t), num_pages);
+  uword previous_start = base;
+  for (intptr_t i = 0; i < count; i++) {
+    code ^= order_table.At(i);
+    const uword start = code.PayloadStart();
+    ASSERT(start >= previous_start);
+    previous_start = start;
+    index.SetUint32((first_start_entry + i) * sizeof(uint32_t), start - base);
+  }
+  index.SetUint32((first_start_entry + count) * sizeof(uint32_t), size);
+
+  intptr_t i = 0;
+  for (intptr_t page = 0; page <= num_pages; page++) {
+    const uword page_start = static_cast<uword>(page) << kPageSizeLog2;
+    while ((i + 1 < count) &&
+           (index.GetUint32((first_start_entry + i + 1) * sizeof(uint32_t)) <=
+            page_start)) {
+      i++;
+    }
+    index.SetUint32((kFirstPageEntry + page) * sizeof(uint32_t), i);
+  }
+  return index.raw();
+}
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
 CodePtr ReversePc::Lookup(IsolateGroup* group,
                           uword pc,
                           bool is_return_address) {
@@ -25,42 +70,49 @@ CodePtr ReversePc::Lookup(IsolateGroup* group,
   // this changes, would could sort the table list during deserialization and
   // binary search for the table.
   GrowableObjectArrayPtr tables = group->object_store()->code_order_tables();
+  GrowableObjectArrayPtr indices =
+      group->object_store()->code_order_table_indices();
   intptr_t tables_length = Smi::Value(tables->ptr()->length_);
   for (intptr_t i = 0; i < tables_length; i++) {
     ArrayPtr table =
         static_cast<ArrayPtr>(tables->ptr()->data_->ptr()->data()[i]);
-    intptr_t lo = 0;
-    intptr_t hi = Smi::Value(table->ptr()->length_) - 1;
-
-    // Fast check if pc belongs to this table.
-    if (lo > hi) {
+    const intptr_t count = Smi::Value(table->ptr()->length_);
+    if (count == 0) {
       continue;
     }
-    CodePtr first = static_cast<CodePtr>(table->ptr()->data()[lo]);
-    if (pc < Code::PayloadStartOf(first)) {
+    CodePtr first = static_cast<CodePtr>(table->ptr()->data()[0]);
+    const uword base = Code::PayloadStartOf(first);
+    if (pc < base) {
       continue;
     }
-    CodePtr last = static_cast<CodePtr>(table->ptr()->data()[hi]);
-    if (pc >= (Code::PayloadStartOf(last) + Code::PayloadSizeOf(last))) {
+    const uword offset = pc - base;
+    TypedDataPtr index =
+        static_cast<TypedDataPtr>(indices->ptr()->data_->ptr()->data()[i]);
+    const uint32_t* entries =
+        reinterpret_cast<const uint32_t*>(index->ptr()->data());
+    const intptr_t num_pages = entries[kNumPagesEntry];
+    const uint32_t* starts = entries + kFirstPageEntry + num_pages + 1;
+    if (offset >= starts[count]) {
       continue;
     }
 
-    // Binary search within the table for the matching Code.
-    while (lo <= hi) {
-      intptr_t mid = (hi - lo + 1) / 2 + lo;
-      ASSERT(mid >= lo);
-      ASSERT(mid <= hi);
-      CodePtr code = static_cast<CodePtr>(table->ptr()->data()[mid]);
-      uword code_start = Code::PayloadStartOf(code);
-      uword code_end = code_start + Code::PayloadSizeOf(code);
-      if (pc < code_start) {
-        hi = mid - 1;
-      } else if (pc >= code_end) {
-        lo = mid + 1;
+    // Binary search for the last Code starting at or before the pc, among
+    // the ones overlapping its page.
+    const intptr_t page = offset >> kPageSizeLog2;
+    intptr_t lo = entries[kFirstPageEntry + page];
+    intptr_t hi = entries[kFirstPageEntry + page + 1];
+    while (lo < hi) {
+      const intptr_t mid = (hi - lo + 1) / 2 + lo;
+      if (starts[mid] <= offset) {
+        lo = mid;
       } else {
-        return code;
+        hi = mid - 1;
       }
     }
+    CodePtr code = static_cast<CodePtr>(table->ptr()->data()[lo]);
+    ASSERT(pc >= Code::PayloadStartOf(code));
+    ASSERT(pc < Code::PayloadStartOf(code) + Code::PayloadSizeOf(code));
+    return code;
   }
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 
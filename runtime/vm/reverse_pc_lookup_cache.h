@@ -11,6 +11,7 @@
 
 namespace dart {
 
+class Array;
 class IsolateGroup;
 
 class ReversePc : public AllStatic {
@@ -18,6 +19,24 @@ class ReversePc : public AllStatic {
   static CodePtr Lookup(IsolateGroup* group,
                         uword pc,
                         bool is_return_address = false);
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+  // Builds the index used by Lookup for [order_table], which lists Code
+  // objects in the order of their contiguous instructions ending at [end].
+  //
+  // The index is a Uint32List of offsets from the start of the first
+  // instructions: the number of pages, then for each page and the end of
+  // the last page the position in [order_table] of the Code containing its
+  // start, then the start of every Code and finally [end]. A lookup only
+  // binary searches the few starts within the page of the pc, without
+  // touching any Code objects but the one it returns.
+  static TypedDataPtr BuildIndex(const Array& order_table, uword end);
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+ private:
+  static constexpr intptr_t kPageSizeLog2 = 12;
+  static constexpr intptr_t kNumPagesEntry = 0;
+  static constexpr intptr_t kFirstPageEntry = 1;
 };
 
 }  // namespace dart
@@ -66,6 +66,11 @@ DECLARE_FLAG(bool, trace_optimizing_compiler);
 DECLARE_FLAG(int, max_polymorphic_checks);
 
 DEFINE_FLAG(bool, trace_osr, false, "Trace attempts at on-stack replacement.");
+DEFINE_FLAG(int,
+            osr_code_cache_size,
+            16,
+            "Number of OSR code objects kept for reuse by later OSR "
+            "requests from the same loop, 0 disables reuse.");
 
 DEFINE_FLAG(int, gc_every, 0, "Run major GC on every N stack overflow checks");
 DEFINE_FLAG(int,
@@ -237,6 +242,16 @@ static Heap::Space SpaceForRuntimeAllocation() {
   return FLAG_stress_write_barrier_elimination ? Heap::kOld : Heap::kNew;
 }
 
+// Instances of classes the scavenger keeps promoting go straight to old space.
+// The allocation stubs ensure such objects are remembered.
+static Heap::Space SpaceForInstanceAllocation(Thread* thread,
+                                              const Class& cls) {
+  if (thread->heap()->new_space()->ShouldPretenure(cls.id())) {
+    return Heap::kOld;
+  }
+  return SpaceForRuntimeAllocation();
+}
+
 // Allocation of a fixed length array of given element type.
 // This runtime entry is never called for allocating a List of a generic type,
 // because a prior run time call instantiates the element type if necessary.
@@ -331,8 +346,8 @@ DEFINE_RUNTIME_ENTRY(AllocateObject, 2) {
   const Error& error =
       Error::Handle(zone, cls.EnsureIsAllocateFinalized(thread));
   ThrowIfError(error);
-  const Instance& instance =
-      Instance::Handle(zone, Instance::New(cls, SpaceForRuntimeAllocation()));
+  const Instance& instance = Instance::Handle(
+      zone, Instance::New(cls, SpaceForInstanceAllocation(thread, cls)));
 
   arguments.SetReturn(instance);
   if (cls.NumTypeArguments() == 0) {
@@ -590,6 +605,18 @@ static void UpdateTypeTestCache(
     const Bool& result,
     const SubtypeTestCache& new_cache) {
   ASSERT(!new_cache.IsNull());
+  // Caches only grow, so a full cache can be detected without taking the
+  // lock. Type checks at sites that keep missing a full cache come here on
+  // every check, so avoid collecting the entry (and suspending other
+  // mutators on the lock) just to drop it. The length is checked again
+  // under the lock below.
+  if (new_cache.NumberOfChecks() >= FLAG_max_subtype_cache_entries) {
+    if (FLAG_trace_type_checks) {
+      OS::PrintErr("Not updating subtype test cache as its length reached %d\n",
+                   FLAG_max_subtype_cache_entries);
+    }
+    return;
+  }
   Class& instance_class = Class::Handle(zone);
   if (instance.IsSmi()) {
     instance_class = Smi::Class();
@@ -1824,7 +1851,11 @@ void PatchableCallHandler::DoICDataMissAOT(const ICData& ic_data,
     ReturnAOT(target_code, expected_cid);
   } else {
     ic_data.EnsureHasReceiverCheck(receiver().GetClassId(), target_function);
-    if (number_of_checks > FLAG_max_polymorphic_checks) {
+    // The ICData of a switchable call is private to the call site, so it
+    // serves as a small per-site polymorphic cache in front of the global
+    // megamorphic cache. Probing it is a short linear scan which is cheaper
+    // than hashing into the megamorphic cache for a handful of classes.
+    if (number_of_checks > FLAG_max_switchable_polymorphic_checks) {
       // Switch to megamorphic call.
       const MegamorphicCache& cache = MegamorphicCache::Handle(
           zone_, MegamorphicCacheTable::Lookup(thread_, name, descriptor));
@@ -2563,6 +2594,91 @@ static void HandleStackOverflowTestCases(Thread* thread) {
 #endif  // !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
+// The OSR code cache is a list of (unoptimized code, osr id, OSR code,
+// deoptimization counter) tuples, oldest first. Keying on the unoptimized
+// code rather than the function makes entries go stale on isolate reload
+// and when the function's unoptimized code is cleared by deoptimization.
+enum {
+  kOsrCacheUnoptimizedCode = 0,
+  kOsrCacheDeoptId,
+  kOsrCacheOsrCode,
+  kOsrCacheDeoptCounter,
+  kOsrCacheEntryLength,
+};
+
+// Returns previously compiled OSR code for the loop at [osr_id] of
+// [unoptimized_code] if it is still valid, or null otherwise. Code is only
+// reused if it was not disabled by a dependency (CHA, field guards, ...) and
+// the function has not deoptimized since it was compiled: a deoptimization
+// means some speculation failed and recompiling produces better code.
+static CodePtr LookupOsrCode(Thread* thread,
+                             const Function& function,
+                             const Code& unoptimized_code,
+                             intptr_t osr_id) {
+  if (FLAG_osr_code_cache_size <= 0) {
+    return Code::null();
+  }
+  Zone* zone = thread->zone();
+  const auto& cache = GrowableObjectArray::Handle(
+      zone, thread->isolate()->isolate_object_store()->osr_code_cache());
+  if (cache.IsNull()) {
+    return Code::null();
+  }
+  auto& code = Code::Handle(zone);
+  for (intptr_t i = 0; i < cache.Length(); i += kOsrCacheEntryLength) {
+    if ((cache.At(i + kOsrCacheUnoptimizedCode) != unoptimized_code.raw()) ||
+        (Smi::Value(Smi::RawCast(cache.At(i + kOsrCacheDeoptId))) != osr_id)) {
+      continue;
+    }
+    code ^= cache.At(i + kOsrCacheOsrCode);
+    if (!code.IsDisabled() &&
+        (Smi::Value(Smi::RawCast(cache.At(i + kOsrCacheDeoptCounter))) ==
+         function.deoptimization_counter())) {
+      return code.raw();
+    }
+    // Stale entry, drop it so it can be replaced by fresh code.
+    for (intptr_t j = i + kOsrCacheEntryLength; j < cache.Length(); j++) {
+      cache.SetAt(j - kOsrCacheEntryLength, Object::Handle(zone, cache.At(j)));
+    }
+    cache.SetLength(cache.Length() - kOsrCacheEntryLength);
+    return Code::null();
+  }
+  return Code::null();
+}
+
+static void InsertOsrCode(Thread* thread,
+                          const Function& function,
+                          const Code& unoptimized_code,
+                          intptr_t osr_id,
+                          const Code& osr_code) {
+  if (FLAG_osr_code_cache_size <= 0) {
+    return;
+  }
+  Zone* zone = thread->zone();
+  IsolateObjectStore* object_store = thread->isolate()->isolate_object_store();
+  auto& cache =
+      GrowableObjectArray::Handle(zone, object_store->osr_code_cache());
+  if (cache.IsNull()) {
+    cache = GrowableObjectArray::New(
+        FLAG_osr_code_cache_size * kOsrCacheEntryLength, Heap::kOld);
+    object_store->set_osr_code_cache(cache);
+  }
+  if (cache.Length() >= FLAG_osr_code_cache_size * kOsrCacheEntryLength) {
+    // Evict the oldest entry.
+    auto& value = Object::Handle(zone);
+    for (intptr_t j = kOsrCacheEntryLength; j < cache.Length(); j++) {
+      value = cache.At(j);
+      cache.SetAt(j - kOsrCacheEntryLength, value);
+    }
+    cache.SetLength(cache.Length() - kOsrCacheEntryLength);
+  }
+  cache.Add(unoptimized_code, Heap::kOld);
+  cache.Add(Smi::Handle(zone, Smi::New(osr_id)), Heap::kOld);
+  cache.Add(osr_code, Heap::kOld);
+  cache.Add(Smi::Handle(zone, Smi::New(function.deoptimization_counter())),
+            Heap::kOld);
+}
+
 static void HandleOSRRequest(Thread* thread) {
   Isolate* isolate = thread->isolate();
   ASSERT(isolate->use_osr());
@@ -2604,11 +2720,25 @@ static void HandleOSRRequest(Thread* thread) {
                  function.usage_counter());
   }
 
-  // Since the code is referenced from the frame and the ZoneHandle,
-  // it cannot have been removed from the function.
-  const Object& result = Object::Handle(
-      Compiler::CompileOptimizedFunction(thread, function, osr_id));
-  ThrowIfError(result);
+  // Loops that are entered repeatedly (e.g. a hot loop in a function that is
+  // called a few times before its optimized code is installed) would
+  // otherwise recompile the same OSR code on every entry.
+  Object& result =
+      Object::Handle(LookupOsrCode(thread, function, code, osr_id));
+  if (!result.IsNull()) {
+    if (FLAG_trace_osr) {
+      OS::PrintErr("Reusing OSR code for %s at id=%" Pd "\n",
+                   function.ToFullyQualifiedCString(), osr_id);
+    }
+  } else {
+    // Since the code is referenced from the frame and the ZoneHandle,
+    // it cannot have been removed from the function.
+    result = Compiler::CompileOptimizedFunction(thread, function, osr_id);
+    ThrowIfError(result);
+    if (!result.IsNull()) {
+      InsertOsrCode(thread, function, code, osr_id, Code::Cast(result));
+    }
+  }
 
   if (!result.IsNull()) {
     const Code& code = Code::Cast(result);
@@ -2740,12 +2870,15 @@ DEFINE_RUNTIME_ENTRY(OptimizeInvokedFunction, 1) {
           function.is_background_optimizable()) {
         // Ensure background compiler is running, if not start it.
         BackgroundCompiler::Start(isolate);
+        // Functions that went far past the threshold before the check fired,
+        // e.g. by counting in loops, are compiled first.
+        const intptr_t priority = function.usage_counter();
         // Reduce the chance of triggering a compilation while the function is
         // being compiled in the background. INT32_MIN should ensure that it
         // takes long time to trigger a compilation.
         // Note that the background compilation queue rejects duplicate entries.
         function.SetUsageCounter(INT32_MIN);
-        isolate->optimizing_background_compiler()->Compile(function);
+        isolate->optimizing_background_compiler()->Compile(function, priority);
         // Continue in the same code.
         arguments.SetReturn(function);
         return;
@@ -3356,14 +3489,16 @@ DEFINE_RAW_LEAF_RUNTIME_ENTRY(ExitSafepoint, 0, false, &DFLRT_ExitSafepoint);
 // Not registered as a runtime entry because we can't use Thread to look it up.
 static Thread* GetThreadForNativeCallback(uword callback_id,
                                           uword return_address) {
+  // This runs on every callback invocation, so the checks below are kept off
+  // the straight-line path.
   Thread* const thread = Thread::Current();
-  if (thread == nullptr) {
+  if (UNLIKELY(thread == nullptr)) {
     FATAL("Cannot invoke native callback outside an isolate.");
   }
-  if (thread->no_callback_scope_depth() != 0) {
+  if (UNLIKELY(thread->no_callback_scope_depth() != 0)) {
     FATAL("Cannot invoke native callback when API callbacks are prohibited.");
   }
-  if (!thread->IsMutatorThread()) {
+  if (UNLIKELY(!thread->IsMutatorThread())) {
     FATAL("Native callbacks must be invoked on the mutator thread.");
   }
 
@@ -4239,6 +4239,16 @@ static intptr_t GetProcessMemoryUsageHelper(JSONStream* js) {
       JSONArray(&semi, "children");
     }
 
+    {
+      JSONObject old(&vm_children);
+      old.AddProperty("name", "OldPage Cache");
+      old.AddProperty("description", "Cached heap regions");
+      intptr_t size = OldPage::CachedSize();
+      vm_size += size;
+      old.AddProperty64("size", size);
+      JSONArray(&old, "children");
+    }
+
     IsolateGroup::ForEach(
         [&vm_children, &vm_size](IsolateGroup* isolate_group) {
           // Note: new_space()->CapacityInWords() includes memory that hasn't
@@ -352,6 +352,9 @@ class RunServiceTask : public ThreadPool::Task {
     Dart_IsolateFlags api_flags;
     Isolate::FlagsInitialize(&api_flags);
     api_flags.is_system_isolate = true;
+    // Service requests are answered ahead of the messages of busy
+    // application isolates.
+    api_flags.is_latency_sensitive = true;
     isolate = reinterpret_cast<Isolate*>(
         create_group_callback(ServiceIsolate::kName, ServiceIsolate::kName,
                               NULL, NULL, &api_flags, NULL, &error));
@@ -774,7 +774,34 @@ char* SimulatorDebugger::ReadLine(const char* prompt) {
   return result;
 }
 
-void Simulator::Init() {}
+Simulator::DecodeFunction Simulator::main_op_decoders_[kMainOpCount];
+
+void Simulator::Init() {
+  COMPILE_ASSERT((DPImmediateMask | CompareBranchMask | LoadStoreMask |
+                  DPRegisterMask | DPSimd1Mask | DPSimd2Mask) ==
+                 ((kMainOpCount - 1) << kMainOpShift));
+  for (intptr_t i = 0; i < kMainOpCount; i++) {
+    const int32_t bits = static_cast<int32_t>(i << kMainOpShift);
+    Instr* instr = Instr::At(reinterpret_cast<uword>(&bits));
+    DecodeFunction decoder;
+    if (instr->IsDPImmediateOp()) {
+      decoder = &Simulator::DecodeDPImmediate;
+    } else if (instr->IsCompareBranchOp()) {
+      decoder = &Simulator::DecodeCompareBranch;
+    } else if (instr->IsLoadStoreOp()) {
+      decoder = &Simulator::DecodeLoadStore;
+    } else if (instr->IsDPRegisterOp()) {
+      decoder = &Simulator::DecodeDPRegister;
+    } else if (instr->IsDPSimd1Op()) {
+      decoder = &Simulator::DecodeDPSimd1;
+    } else if (instr->IsDPSimd2Op()) {
+      decoder = &Simulator::DecodeDPSimd2;
+    } else {
+      decoder = &Simulator::UnimplementedInstruction;
+    }
+    main_op_decoders_[i] = decoder;
+  }
+}
 
 Simulator::Simulator() : exclusive_access_addr_(0), exclusive_access_value_(0) {
   // Setup simulator support first. Some of this information is needed to
@@ -3036,8 +3063,13 @@ void Simulator::DecodeSIMDThreeSame(Instr* instr) {
           res = vn_val | vm_val;
         }
       } else if ((U == 1) && (opcode == 0x3)) {
-        // Format(instr, "veor 'vd, 'vn, 'vm");
-        res = vn_val ^ vm_val;
+        if (instr->Bit(23) != 0) {
+          UnimplementedInstruction(instr);
+          return;
+        }
+        // Format(instr, "vbsl 'vd, 'vn, 'vm");
+        const int64_t vd_val = get_vregisterd(vd, idx);
+        res = (vd_val & vn_val) | (~vd_val & vm_val);
       } else if ((U == 0) && (opcode == 0x10)) {
         // Format(instr, "vadd'vsz 'vd, 'vn, 'vm");
         res = vn_val + vm_val;
@@ -3186,6 +3218,23 @@ void Simulator::DecodeSIMDTwoReg(Instr* instr) {
   const VRegister vd = instr->VdField();
   const VRegister vn = instr->VnField();
 
+  if ((Q == 0) && (U == 0) && (sz == 1) && (op == 0x17)) {
+    // Format(instr, "vfcvtl 'vd, 'vn");
+    const float x = bit_cast<float, int32_t>(get_vregisters(vn, 0));
+    const float y = bit_cast<float, int32_t>(get_vregisters(vn, 1));
+    set_vregisterd(vd, 0, bit_cast<int64_t, double>(static_cast<double>(x)));
+    set_vregisterd(vd, 1, bit_cast<int64_t, double>(static_cast<double>(y)));
+    return;
+  } else if ((Q == 0) && (U == 0) && (sz == 1) && (op == 0x16)) {
+    // Format(instr, "vfcvtn 'vd, 'vn");
+    const double x = bit_cast<double, int64_t>(get_vregisterd(vn, 0));
+    const double y = bit_cast<double, int64_t>(get_vregisterd(vn, 1));
+    set_vregisters(vd, 0, bit_cast<int32_t, float>(static_cast<float>(x)));
+    set_vregisters(vd, 1, bit_cast<int32_t, float>(static_cast<float>(y)));
+    set_vregisterd(vd, 1, 0);
+    return;
+  }
+
   if (Q != 1) {
     UnimplementedInstruction(instr);
     return;
@@ -3544,21 +3593,8 @@ void Simulator::InstructionDecode(Instr* instr) {
     }
   }
 
-  if (instr->IsDPImmediateOp()) {
-    DecodeDPImmediate(instr);
-  } else if (instr->IsCompareBranchOp()) {
-    DecodeCompareBranch(instr);
-  } else if (instr->IsLoadStoreOp()) {
-    DecodeLoadStore(instr);
-  } else if (instr->IsDPRegisterOp()) {
-    DecodeDPRegister(instr);
-  } else if (instr->IsDPSimd1Op()) {
-    DecodeDPSimd1(instr);
-  } else if (instr->IsDPSimd2Op()) {
-    DecodeDPSimd2(instr);
-  } else {
-    UnimplementedInstruction(instr);
-  }
+  const intptr_t main_op = instr->Bits(kMainOpShift, 4);
+  (this->*main_op_decoders_[main_op])(instr);
 
   if (!pc_modified_) {
     set_pc(reinterpret_cast<int64_t>(instr) + Instr::kInstrSize);
@@ -236,6 +236,13 @@ class Simulator {
   APPLY_OP_LIST(DECODE_OP)
 #undef DECODE_OP
 
+  // The main instruction classes only depend on bits 28..25, so Init resolves
+  // the decoder for each of their 16 values up front.
+  typedef void (Simulator::*DecodeFunction)(Instr* instr);
+  static const intptr_t kMainOpShift = 25;
+  static const intptr_t kMainOpCount = 16;
+  static DecodeFunction main_op_decoders_[kMainOpCount];
+
   // Executes ARM64 instructions until the PC reaches kEndSimulatingPC.
   void Execute();
 
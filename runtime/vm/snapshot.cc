@@ -309,9 +309,14 @@ SnapshotReader::SnapshotReader(const uint8_t* buffer,
               : 0),
       backward_references_(backward_refs),
       types_to_postprocess_(GrowableObjectArray::Handle(zone_)),
-      objects_to_rehash_(GrowableObjectArray::Handle(zone_)) {}
+      objects_to_rehash_(GrowableObjectArray::Handle(zone_)),
+      bulk_allocator_(nullptr) {}
 
 ObjectPtr SnapshotReader::ReadObject() {
+  // The objects decoded from a message take up about as many bytes in new
+  // space as their encoding, or more; reserve room for them up front.
+  HeapBulkAllocator bulk_allocator(thread_, Heap::kNew, PendingBytes());
+  bulk_allocator_ = &bulk_allocator;
   // Setup for long jump in case there is an exception while reading.
   LongJumpScope jump;
   if (setjmp(*jump.Set()) == 0) {
@@ -329,6 +334,7 @@ ObjectPtr SnapshotReader::ReadObject() {
     } else {
       result = obj.raw();
     }
+    bulk_allocator_ = nullptr;
     RunDelayedTypePostprocessing();
     const Object& ok = Object::Handle(zone_, RunDelayedRehashingOfMaps());
     objects_to_rehash_ = GrowableObjectArray::null();
@@ -337,6 +343,7 @@ ObjectPtr SnapshotReader::ReadObject() {
     }
     return result.raw();
   } else {
+    bulk_allocator_ = nullptr;
     // An error occurred while reading, return the error object.
     return Thread::Current()->StealStickyError();
   }
@@ -623,7 +630,11 @@ ObjectPtr SnapshotReader::ReadInstance(intptr_t object_id,
     instance_size = cls_.host_instance_size();
     ASSERT(instance_size > 0);
     // Allocate the instance and read in all the fields for the object.
-    *result ^= Object::Allocate(cls_.id(), instance_size, Heap::kNew);
+    if (bulk_allocator_ != nullptr) {
+      *result ^= Object::Allocate(cls_.id(), instance_size, bulk_allocator_);
+    } else {
+      *result ^= Object::Allocate(cls_.id(), instance_size, Heap::kNew);
+    }
   } else {
     cls_ ^= ReadObjectImpl(kAsInlinedObject);
     ASSERT(!cls_.IsNull());
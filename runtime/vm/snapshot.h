@@ -32,6 +32,7 @@ class ExternalTypedData;
 class TypedDataBase;
 class GrowableObjectArray;
 class Heap;
+class HeapBulkAllocator;
 class Instance;
 class Instructions;
 class LanguageError;
@@ -376,6 +377,8 @@ class SnapshotReader : public BaseReader {
   ZoneGrowableArray<BackRefNode>* backward_references_;
   GrowableObjectArray& types_to_postprocess_;
   GrowableObjectArray& objects_to_rehash_;
+  // Reservation for the instances allocated while reading an object graph.
+  HeapBulkAllocator* bulk_allocator_;
 
   friend class ApiError;
   friend class Array;
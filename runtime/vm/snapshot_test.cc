@@ -22,6 +22,9 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, out_of_line_typed_data_threshold);
+DECLARE_FLAG(int, snapshot_fill_tasks);
+
 // Check if serialized and deserialized objects are equal.
 static bool Equals(const Object& expected, const Object& actual) {
   if (expected.IsNull()) {
@@ -596,6 +599,43 @@ ISOLATE_UNIT_TEST_CASE(SerializeByteArray) {
   CheckEncodeDecodeMessage(root);
 }
 
+ISOLATE_UNIT_TEST_CASE(SerializeOutOfLineByteArray) {
+  SetFlagScope<int> sfs(&FLAG_out_of_line_typed_data_threshold, 128);
+  const int kTypedDataLength = 256;
+  TypedData& typed_data = TypedData::Handle(
+      TypedData::New(kTypedDataUint8ArrayCid, kTypedDataLength));
+  for (int i = 0; i < kTypedDataLength; i++) {
+    typed_data.SetUint8(i, i);
+  }
+  MessageWriter writer(true);
+  std::unique_ptr<Message> message =
+      writer.WriteMessage(typed_data, ILLEGAL_PORT, Message::kNormalPriority);
+  // The contents are not part of the snapshot.
+  EXPECT(message->snapshot_length() < kTypedDataLength);
+
+  // Read object back from the snapshot into a C structure.
+  {
+    ApiNativeScope scope;
+    ApiMessageReader api_reader(message.get());
+    Dart_CObject* root = api_reader.ReadMessage();
+    EXPECT_EQ(Dart_CObject_kTypedData, root->type);
+    EXPECT_EQ(kTypedDataLength, root->value.as_typed_data.length);
+    for (int i = 0; i < kTypedDataLength; i++) {
+      EXPECT(root->value.as_typed_data.values[i] == i);
+    }
+  }
+
+  // Read object back from the snapshot.
+  MessageSnapshotReader reader(message.get(), thread);
+  TypedData& serialized_typed_data = TypedData::Handle();
+  serialized_typed_data ^= reader.ReadObject();
+  EXPECT(serialized_typed_data.IsTypedData());
+  EXPECT_EQ(kTypedDataLength, serialized_typed_data.Length());
+  for (int i = 0; i < kTypedDataLength; i++) {
+    EXPECT_EQ(i, serialized_typed_data.GetUint8(i));
+  }
+}
+
 #define TEST_TYPED_ARRAY(darttype, ctype)                                      \
   {                                                                            \
     StackZone zone(thread);                                                    \
@@ -778,6 +818,53 @@ VM_UNIT_TEST_CASE(FullSnapshot) {
   free(isolate_snapshot_data_buffer);
 }
 
+VM_UNIT_TEST_CASE(FullSnapshotConcurrentFill) {
+  const char* kScriptChars =
+      "String greeting(int i) => 'hello ' * i;\n"
+      "main() => greeting(2);\n";
+  uint8_t* isolate_snapshot_data_buffer;
+  {
+    TestIsolateScope __test_isolate__;
+    TestCase::LoadTestScript(kScriptChars, NULL);
+
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HandleScope scope(thread);
+
+    Dart_Handle result = Api::CheckAndFinalizePendingClasses(thread);
+    {
+      TransitionVMToNative to_native(thread);
+      EXPECT_VALID(result);
+    }
+
+    MallocWriteStream isolate_snapshot_data(FullSnapshotWriter::kInitialSize);
+    FullSnapshotWriter writer(
+        Snapshot::kFull, /*vm_snapshot_data=*/nullptr, &isolate_snapshot_data,
+        /*vm_image_writer=*/nullptr, /*iso_image_writer=*/nullptr);
+    writer.WriteFullSnapshot();
+    intptr_t unused;
+    isolate_snapshot_data_buffer = isolate_snapshot_data.Steal(&unused);
+  }
+
+  // The clusters of the core libraries are large enough to be filled by the
+  // helper threads.
+  SetFlagScope<int> sfs(&FLAG_snapshot_fill_tasks, 4);
+  TestCase::CreateTestIsolateFromSnapshot(isolate_snapshot_data_buffer);
+  {
+    Dart_EnterScope();
+    Dart_Handle result = Dart_Invoke(TestCase::lib(), NewString("main"), 0,
+                                     NULL);
+    EXPECT_VALID(result);
+    const char* value;
+    EXPECT_VALID(Dart_StringToCString(result, &value));
+    EXPECT_STREQ("hello hello ", value);
+    Dart_ExitScope();
+  }
+  Dart_ShutdownIsolate();
+  free(isolate_snapshot_data_buffer);
+}
+
 // Helper function to call a top level Dart function and serialize the result.
 static std::unique_ptr<Message> GetSerialized(Dart_Handle lib,
                                               const char* dart_function) {
@@ -393,19 +393,24 @@ bool StackFrame::FindExceptionHandler(Thread* thread,
   handlers = code.exception_handlers();
   descriptors = code.pc_descriptors();
   *is_optimized = code.is_optimized();
+  if (handlers.num_entries() == 0) {
+    return false;
+  }
+
+  // Both outcomes are cached, as a frame whose pc is outside all of its try
+  // blocks is otherwise searched for again on every throw that unwinds it.
   HandlerInfoCache* cache = thread->isolate()->handler_info_cache();
   ExceptionHandlerInfo* info = cache->Lookup(pc());
   if (info != NULL) {
+    if (info->handler_pc_offset == kNoHandlerPcOffset) {
+      return false;
+    }
     *handler_pc = start + info->handler_pc_offset;
     *needs_stacktrace = (info->needs_stacktrace != 0);
     *has_catch_all = (info->has_catch_all != 0);
     return true;
   }
 
-  if (handlers.num_entries() == 0) {
-    return false;
-  }
-
   intptr_t try_index = -1;
   uword pc_offset = pc() - code.PayloadStart();
   PcDescriptors::Iterator iter(descriptors, PcDescriptorsLayout::kAnyKind);
@@ -417,6 +422,9 @@ bool StackFrame::FindExceptionHandler(Thread* thread,
     }
   }
   if (try_index == -1) {
+    ExceptionHandlerInfo no_handler_info = {};
+    no_handler_info.handler_pc_offset = kNoHandlerPcOffset;
+    cache->Insert(pc(), no_handler_info);
     return false;
   }
   ExceptionHandlerInfo handler_info;
@@ -335,11 +335,11 @@ void StackTraceUtils::CollectFramesLazy(
       continue;
     }
 
-    function = frame->LookupDartFunction();
-
-    // Add the current synchronous frame.
+    // Add the current synchronous frame. In bare instructions mode every
+    // code lookup is a search of the instructions tables, so the function is
+    // taken from the code instead of being looked up separately.
     code = frame->LookupDartCode();
-    ASSERT(function.raw() == code.function());
+    function = code.function();
     code_array.Add(code);
     const intptr_t pc_offset = frame->pc() - code.PayloadStart();
     ASSERT(pc_offset > 0 && pc_offset <= code.Size());
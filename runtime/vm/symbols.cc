@@ -329,6 +329,16 @@ StringPtr Symbols::FromConcatAll(
   }
 }
 
+// Insertions into the symbol table stop all mutators of the group first
+// (see `Symbols::NewSymbol`), unless the inserting thread is the only mutator.
+// A mutator can therefore never observe a table which is being modified and
+// doesn't need to take the symbols lock to read it. This keeps many isolates
+// looking up symbols at the same time from contending on the lock.
+static bool CanReadSymbolTableWithoutLock(Thread* thread) {
+  return (FLAG_enable_isolate_groups || !USING_PRODUCT) &&
+         thread->IsMutatorThread();
+}
+
 // StringType can be StringSlice, ConcatString, or {Latin1,UTF16}Array.
 template <typename StringType>
 StringPtr Symbols::NewSymbol(Thread* thread, const StringType& str) {
@@ -377,12 +387,17 @@ StringPtr Symbols::NewSymbol(Thread* thread, const StringType& str) {
     } else {
       // Most common case: We are not at a safepoint and the symbol is available
       // in the symbol table: We require only read access.
-      {
-        SafepointReadRwLocker sl(thread, group->symbols_lock());
+      auto lookup = [&]() {
         data = object_store->symbol_table();
         CanonicalStringSet table(&key, &value, &data);
         symbol ^= table.GetOrNull(str);
         table.Release();
+      };
+      if (CanReadSymbolTableWithoutLock(thread)) {
+        lookup();
+      } else {
+        SafepointReadRwLocker sl(thread, group->symbols_lock());
+        lookup();
       }
       // Second common case: We are not at a safepoint and the symbol is not
       // available in the symbol table: We require only exclusive access.
@@ -451,11 +466,18 @@ StringPtr Symbols::Lookup(Thread* thread, const StringType& str) {
       symbol ^= table.GetOrNull(str);
       table.Release();
     } else {
-      SafepointReadRwLocker sl(thread, group->symbols_lock());
-      data = object_store->symbol_table();
-      CanonicalStringSet table(&key, &value, &data);
-      symbol ^= table.GetOrNull(str);
-      table.Release();
+      auto lookup = [&]() {
+        data = object_store->symbol_table();
+        CanonicalStringSet table(&key, &value, &data);
+        symbol ^= table.GetOrNull(str);
+        table.Release();
+      };
+      if (CanReadSymbolTableWithoutLock(thread)) {
+        lookup();
+      } else {
+        SafepointReadRwLocker sl(thread, group->symbols_lock());
+        lookup();
+      }
     }
   }
   ASSERT(symbol.IsNull() || symbol.IsSymbol());
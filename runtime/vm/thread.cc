@@ -574,7 +574,7 @@ void Thread::MarkingStackRelease() {
   MarkingStackBlock* block = marking_stack_block_;
   marking_stack_block_ = NULL;
   write_barrier_mask_ = ObjectLayout::kGenerationalBarrierMask;
-  isolate_group()->marking_stack()->PushBlock(block);
+  isolate_group()->marking_stack()->PushMutatorBlock(block);
 }
 
 void Thread::MarkingStackAcquire() {
@@ -586,7 +586,7 @@ void Thread::MarkingStackAcquire() {
 void Thread::DeferredMarkingStackRelease() {
   MarkingStackBlock* block = deferred_marking_stack_block_;
   deferred_marking_stack_block_ = NULL;
-  isolate_group()->deferred_marking_stack()->PushBlock(block);
+  isolate_group()->deferred_marking_stack()->PushMutatorBlock(block);
 }
 
 void Thread::DeferredMarkingStackAcquire() {
@@ -698,9 +698,14 @@ class RestoreWriteBarrierInvariantVisitor : public ObjectPointerVisitor {
       if (obj->IsSmiOrNewObject()) continue;
 
       // To avoid adding too much work into the remembered set, skip
-      // arrays. Write barrier elimination will not remove the barrier
-      // if we can trigger GC between array allocation and store.
-      if (obj->GetClassId() == kArrayCid) continue;
+      // all but small arrays. Write barrier elimination will not remove the
+      // barrier if we can trigger GC between the allocation of a larger
+      // array and a store into it.
+      if ((obj->GetClassId() == kArrayCid) &&
+          (Array::LengthOf(static_cast<ArrayPtr>(obj)) >
+           Array::kMaxLengthForWriteBarrierElimination)) {
+        continue;
+      }
 
       // Dart code won't store into VM-internal objects except Contexts and
       // UnhandledExceptions. This assumption is checked by an assertion in
@@ -740,7 +745,8 @@ class RestoreWriteBarrierInvariantVisitor : public ObjectPointerVisitor {
   Thread::RestoreWriteBarrierInvariantOp op_;
 };
 
-// Write barrier elimination assumes that all live temporaries will be
+// Write barrier elimination assumes that all live temporaries (except arrays
+// longer than Array::kMaxLengthForWriteBarrierElimination) will be
 // in the remembered set after a scavenge triggered by a non-Dart-call
 // instruction (see Instruction::CanCallDart()), and additionally they will be
 // in the deferred marking stack if concurrent marking started. Specifically,
@@ -1126,14 +1132,14 @@ void Thread::VerifyCallbackIsolate(int32_t callback_id, uword entry) {
   NoSafepointScope _;
 
   const GrowableObjectArrayPtr array = ffi_callback_code_;
-  if (array == GrowableObjectArray::null()) {
+  if (UNLIKELY(array == GrowableObjectArray::null())) {
     FATAL("Cannot invoke callback on incorrect isolate.");
   }
 
   const SmiPtr length_smi = GrowableObjectArray::NoSafepointLength(array);
   const intptr_t length = Smi::Value(length_smi);
 
-  if (callback_id < 0 || callback_id >= length) {
+  if (UNLIKELY(callback_id < 0 || callback_id >= length)) {
     FATAL("Cannot invoke callback on incorrect isolate.");
   }
 
@@ -522,6 +522,25 @@ class Thread : public ThreadState {
   static intptr_t top_offset() { return OFFSET_OF(Thread, top_); }
   static intptr_t end_offset() { return OFFSET_OF(Thread, end_); }
 
+  // Old-space bump region owned by this thread. See
+  // PageSpace::TryAllocateCached.
+  uword old_cache_top() const { return old_cache_top_; }
+  uword old_cache_end() const { return old_cache_end_; }
+  void set_old_cache(uword top, uword end) {
+    old_cache_top_ = top;
+    old_cache_end_ = end;
+  }
+
+  // Progress of the TLAB towards the next allocation sample. See HeapSampler.
+  uword heap_sample_base() const { return heap_sample_base_; }
+  void set_heap_sample_base(uword base) { heap_sample_base_ = base; }
+  intptr_t heap_sample_countdown() const { return heap_sample_countdown_; }
+  void set_heap_sample_countdown(intptr_t bytes) {
+    heap_sample_countdown_ = bytes;
+  }
+  bool heap_sample_pending() const { return heap_sample_pending_; }
+  void set_heap_sample_pending(bool pending) { heap_sample_pending_ = pending; }
+
   int32_t no_safepoint_scope_depth() const {
 #if defined(DEBUG)
     return no_safepoint_scope_depth_;
@@ -1000,6 +1019,14 @@ class Thread : public ThreadState {
   intptr_t ffi_marshalled_arguments_size_ = 0;
   uint64_t* ffi_marshalled_arguments_;
 
+  uword old_cache_top_ = 0;
+  uword old_cache_end_ = 0;
+
+  // See HeapSampler.
+  uword heap_sample_base_ = 0;
+  intptr_t heap_sample_countdown_ = -1;
+  bool heap_sample_pending_ = false;
+
   InstancePtr* field_table_values() const { return field_table_values_; }
 
 // Reusable handles support.
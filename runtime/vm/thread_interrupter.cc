@@ -33,6 +33,10 @@ namespace dart {
 //   * Allocating memory.
 //   * Taking a lock.
 //
+// On Linux, threads are instead signalled by timers of their own that measure
+// their CPU time (see StartThreadTimer), and the interrupter thread only
+// signals threads for which no such timer could be created.
+//
 // The ThreadInterrupter has a single monitor (monitor_). This monitor is used
 // to synchronize startup, shutdown, and waking up from a deep sleep.
 //
@@ -210,7 +214,8 @@ void ThreadInterrupter::ThreadMain(uword parameters) {
         OSThreadIterator it;
         while (it.HasNext()) {
           OSThread* thread = it.Next();
-          if (thread->ThreadInterruptsEnabled()) {
+          if (thread->ThreadInterruptsEnabled() &&
+              !thread->has_interrupt_timer_) {
             interrupted_thread_count++;
             InterruptThread(thread);
           }
@@ -247,6 +252,14 @@ void ThreadInterrupter::ThreadMain(uword parameters) {
   }
 }
 
+#if !defined(HOST_OS_LINUX)
+void ThreadInterrupter::StartThreadTimer(OSThread* thread) {}
+
+void ThreadInterrupter::StopThreadTimer(OSThread* thread) {}
+
+void ThreadInterrupter::DeleteThreadTimer(OSThread* thread) {}
+#endif  // !defined(HOST_OS_LINUX)
+
 #endif  // !PRODUCT
 
 }  // namespace dart
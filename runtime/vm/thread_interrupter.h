@@ -36,6 +36,15 @@ class ThreadInterrupter : public AllStatic {
   // Interrupt a thread.
   static void InterruptThread(OSThread* thread);
 
+  // Called on the current thread when its interrupts are enabled or disabled.
+  // Where the platform supports it, the thread is then sampled by a timer
+  // measuring its own CPU time rather than by the interrupter thread, so
+  // threads are sampled at the configured rate however many there are, and
+  // idle threads are not signalled at all.
+  static void StartThreadTimer(OSThread* thread);
+  static void StopThreadTimer(OSThread* thread);
+  static void DeleteThreadTimer(OSThread* thread);
+
   class SampleBufferWriterScope : public ValueObject {
    public:
     SampleBufferWriterScope() {
@@ -5,7 +5,9 @@
 #include "platform/globals.h"
 #if defined(HOST_OS_LINUX)
 
-#include <errno.h>  // NOLINT
+#include <errno.h>   // NOLINT
+#include <signal.h>  // NOLINT
+#include <time.h>    // NOLINT
 
 #include "vm/flags.h"
 #include "vm/os.h"
@@ -17,8 +19,18 @@ namespace dart {
 
 #ifndef PRODUCT
 
+DEFINE_FLAG(bool,
+            profiler_thread_timers,
+            true,
+            "Sample each thread from a timer measuring its own CPU time "
+            "instead of from the thread interrupter.");
 DECLARE_FLAG(bool, trace_thread_interrupter);
 
+// Older C libraries do not name the thread id member of sigevent.
+#if !defined(sigev_notify_thread_id)
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
 class ThreadInterrupterLinux : public AllStatic {
  public:
   static void ThreadInterruptSignalHandler(int signal,
@@ -61,6 +73,57 @@ void ThreadInterrupter::InterruptThread(OSThread* thread) {
   ASSERT((result == 0) || (result == ESRCH));
 }
 
+void ThreadInterrupter::StartThreadTimer(OSThread* thread) {
+  ASSERT(OSThread::Current() == thread);
+  // The SIGPROF handler is installed by the interrupter thread.
+  if (!FLAG_profiler_thread_timers || !thread_running_ || shutdown_) {
+    return;
+  }
+  timer_t timer;
+  if (thread->has_interrupt_timer_) {
+    timer = bit_cast<timer_t>(thread->interrupt_timer_);
+  } else {
+    struct sigevent event = {};
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_notify_thread_id = OSThread::GetCurrentThreadTraceId();
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &timer) != 0) {
+      // Leave this thread to the interrupter thread.
+      return;
+    }
+  }
+  struct itimerspec spec = {};
+  spec.it_interval.tv_sec = interrupt_period_ / kMicrosecondsPerSecond;
+  spec.it_interval.tv_nsec = (interrupt_period_ % kMicrosecondsPerSecond) *
+                             kNanosecondsPerMicrosecond;
+  spec.it_value = spec.it_interval;
+  int result = timer_settime(timer, 0, &spec, nullptr);
+  ASSERT(result == 0);
+  if (FLAG_trace_thread_interrupter) {
+    OS::PrintErr("ThreadInterrupter started timer for %p\n",
+                 reinterpret_cast<void*>(thread->id()));
+  }
+  thread->interrupt_timer_ = bit_cast<uword>(timer);
+  thread->has_interrupt_timer_ = true;
+}
+
+void ThreadInterrupter::StopThreadTimer(OSThread* thread) {
+  ASSERT(OSThread::Current() == thread);
+  if (!thread->has_interrupt_timer_) {
+    return;
+  }
+  struct itimerspec spec = {};
+  int result = timer_settime(bit_cast<timer_t>(thread->interrupt_timer_), 0,
+                             &spec, nullptr);
+  ASSERT(result == 0);
+}
+
+void ThreadInterrupter::DeleteThreadTimer(OSThread* thread) {
+  ASSERT(thread->has_interrupt_timer_);
+  timer_delete(bit_cast<timer_t>(thread->interrupt_timer_));
+  thread->has_interrupt_timer_ = false;
+}
+
 void ThreadInterrupter::InstallSignalHandler() {
   SignalHandler::Install<
       ThreadInterrupterLinux::ThreadInterruptSignalHandler>();
@@ -57,6 +57,18 @@ void ThreadPool::Shutdown() {
     }
   }
 
+  // Wake up the parked workers. They won't park again once they see the
+  // shutdown.
+  while (true) {
+    Worker* worker = nullptr;
+    {
+      MonitorLocker ml(&pool_monitor_);
+      if (parked_workers_.IsEmpty()) break;
+      worker = parked_workers_.RemoveLast();
+    }
+    worker->Wake();
+  }
+
   // Wait until all workers are dead. Any new death will notify the exit
   // monitor.
   {
@@ -81,14 +93,19 @@ void ThreadPool::Shutdown() {
   ASSERT(dead_workers_.IsEmpty());
 }
 
-bool ThreadPool::RunImpl(std::unique_ptr<Task> task) {
+bool ThreadPool::RunImpl(std::unique_ptr<Task> task, bool urgent) {
   Worker* new_worker = nullptr;
+  Worker* worker_to_wake = nullptr;
   {
     MonitorLocker ml(&pool_monitor_);
     if (shutting_down_) {
       return false;
     }
-    new_worker = ScheduleTaskLocked(&ml, std::move(task));
+    new_worker =
+        ScheduleTaskLocked(&ml, std::move(task), urgent, &worker_to_wake);
+  }
+  if (worker_to_wake != nullptr) {
+    worker_to_wake->Wake();
   }
   if (new_worker != nullptr) {
     new_worker->StartThread();
@@ -102,6 +119,11 @@ bool ThreadPool::CurrentThreadIsWorker() {
   return worker != nullptr && worker->pool_ == this;
 }
 
+bool ThreadPool::HasTasksWaitingToRun() {
+  MonitorLocker ml(&pool_monitor_);
+  return TasksWaitingToRunLocked();
+}
+
 void ThreadPool::MarkCurrentWorkerAsBlocked() {
   auto worker =
       static_cast<Worker*>(OSThread::Current()->owning_thread_pool_worker_);
@@ -180,7 +202,22 @@ void ThreadPool::WorkerLoop(Worker* worker) {
     const int64_t idle_start = OS::GetCurrentMonotonicMicros();
     bool done = false;
     while (!done) {
-      const auto result = ml.WaitMicros(ComputeTimeout(idle_start));
+      parked_workers_.Append(worker);
+      Monitor::WaitResult result;
+      {
+        MonitorLeaveScope mls(&ml);
+        result = worker->Park(ComputeTimeout(idle_start));
+      }
+      if (parked_workers_.IsInList(worker)) {
+        ASSERT(result == Monitor::kTimedOut);
+        parked_workers_.Remove(worker);
+      } else if (result == Monitor::kTimedOut) {
+        // Another thread removed us from the parked list just as we timed
+        // out. Let it finish waking us up, since it still accesses [worker].
+        MonitorLeaveScope mls(&ml);
+        worker->WaitForWakeup();
+        result = Monitor::kNotified;
+      }
 
       // We have to drain all pending tasks.
       if (!tasks_.IsEmpty()) break;
@@ -224,6 +261,7 @@ void ThreadPool::RunningToIdleLocked(Worker* worker) {
 
 void ThreadPool::IdleToDeadLocked(Worker* worker) {
   ASSERT(tasks_.IsEmpty());
+  ASSERT(!parked_workers_.IsInList(worker));
 
   ASSERT(idle_workers_.ContainsForDebugging(worker));
   idle_workers_.Remove(worker);
@@ -260,16 +298,22 @@ void ThreadPool::JoinDeadWorkersLocked(WorkerList* dead_workers_to_join) {
 }
 
 ThreadPool::Worker* ThreadPool::ScheduleTaskLocked(MonitorLocker* ml,
-                                                   std::unique_ptr<Task> task) {
+                                                   std::unique_ptr<Task> task,
+                                                   bool urgent,
+                                                   Worker** worker_to_wake) {
   // Enqueue the new task.
-  tasks_.Append(task.release());
+  if (urgent) {
+    tasks_.Prepend(task.release());
+  } else {
+    tasks_.Append(task.release());
+  }
   pending_tasks_++;
   ASSERT(pending_tasks_ >= 1);
 
   // Notify existing idle worker (if available).
   if (count_idle_ >= pending_tasks_) {
     ASSERT(!idle_workers_.IsEmpty());
-    ml->Notify();
+    NotifyIdleWorkerLocked(ml, worker_to_wake);
     return nullptr;
   }
 
@@ -277,7 +321,7 @@ ThreadPool::Worker* ThreadPool::ScheduleTaskLocked(MonitorLocker* ml,
   // new one.
   if (max_pool_size_ > 0 && (count_idle_ + count_running_) >= max_pool_size_) {
     if (!idle_workers_.IsEmpty()) {
-      ml->Notify();
+      NotifyIdleWorkerLocked(ml, worker_to_wake);
     }
     return nullptr;
   }
@@ -289,9 +333,51 @@ ThreadPool::Worker* ThreadPool::ScheduleTaskLocked(MonitorLocker* ml,
   return new_worker;
 }
 
+void ThreadPool::NotifyIdleWorkerLocked(MonitorLocker* ml,
+                                        Worker** worker_to_wake) {
+  // Idle workers that are not parked only wait on the pool monitor while
+  // running [OnEnterIdleLocked], which is done when no worker is running.
+  if (running_workers_.IsEmpty() || parked_workers_.IsEmpty()) {
+    ml->Notify();
+  }
+  // Prefer the most recently parked worker, so that the others can time out
+  // if the pool has more workers than it needs.
+  if (!parked_workers_.IsEmpty()) {
+    *worker_to_wake = parked_workers_.RemoveLast();
+  }
+}
+
 ThreadPool::Worker::Worker(ThreadPool* pool)
     : pool_(pool), join_id_(OSThread::kInvalidThreadJoinId) {}
 
+Monitor::WaitResult ThreadPool::Worker::Park(int64_t timeout_micros) {
+  MonitorLocker ml(&park_monitor_);
+  Monitor::WaitResult result = Monitor::kNotified;
+  while (!wakeup_pending_ && (result != Monitor::kTimedOut)) {
+    result = ml.WaitMicros(timeout_micros);
+  }
+  if (wakeup_pending_) {
+    wakeup_pending_ = false;
+    return Monitor::kNotified;
+  }
+  return result;
+}
+
+void ThreadPool::Worker::WaitForWakeup() {
+  MonitorLocker ml(&park_monitor_);
+  while (!wakeup_pending_) {
+    ml.Wait();
+  }
+  wakeup_pending_ = false;
+}
+
+void ThreadPool::Worker::Wake() {
+  MonitorLocker ml(&park_monitor_);
+  ASSERT(!wakeup_pending_);
+  wakeup_pending_ = true;
+  ml.Notify();
+}
+
 void ThreadPool::Worker::StartThread() {
   int result = OSThread::Start("DartWorker", &Worker::Main,
                                reinterpret_cast<uword>(this));
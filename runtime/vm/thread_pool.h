@@ -43,12 +43,23 @@ class ThreadPool {
   // Runs a task on the thread pool.
   template <typename T, typename... Args>
   bool Run(Args&&... args) {
-    return RunImpl(std::unique_ptr<Task>(new T(std::forward<Args>(args)...)));
+    return RunImpl(std::unique_ptr<Task>(new T(std::forward<Args>(args)...)),
+                   /*urgent=*/false);
+  }
+
+  // Runs a task on the thread pool ahead of all tasks waiting to run.
+  template <typename T, typename... Args>
+  bool RunUrgent(Args&&... args) {
+    return RunImpl(std::unique_ptr<Task>(new T(std::forward<Args>(args)...)),
+                   /*urgent=*/true);
   }
 
   // Returns `true` if the current thread is runing on the [this] thread pool.
   bool CurrentThreadIsWorker();
 
+  // Returns `true` if tasks are waiting for a worker to become available.
+  bool HasTasksWaitingToRun();
+
   // Mark the current thread as being blocked (e.g. in native code). This might
   // temporarily increase the max thread pool size.
   void MarkCurrentWorkerAsBlocked();
@@ -67,7 +78,10 @@ class ThreadPool {
   uint64_t workers_stopped() const { return count_dead_; }
 
  private:
-  class Worker : public IntrusiveDListEntry<Worker> {
+  // Workers are linked into one of the running, idle or dead lists. Idle
+  // workers waiting for a task are also linked into the parked list.
+  class Worker : public IntrusiveDListEntry<Worker>,
+                 public IntrusiveDListEntry<Worker, 2> {
    public:
     explicit Worker(ThreadPool* pool);
 
@@ -81,6 +95,23 @@ class ThreadPool {
     // The main entry point for new worker threads.
     static void Main(uword args);
 
+    // Waits until the worker is woken up by [Wake] or the timeout expires.
+    // Must not be called with the pool monitor held.
+    Monitor::WaitResult Park(int64_t timeout_micros);
+
+    // Waits for the [Wake] call of a thread that already removed this worker
+    // from the parked list.
+    void WaitForWakeup();
+
+    // Wakes up the worker, which must have been removed from the parked list
+    // by the caller. Must not be called with the pool monitor held.
+    void Wake();
+
+    // Each worker parks on its own monitor, so waking up a worker neither
+    // requires holding the pool monitor nor wakes up any other worker.
+    Monitor park_monitor_;
+    bool wakeup_pending_ = false;
+
     // Fields initialized during construction or in start of main function of
     // thread.
     ThreadPool* pool_;
@@ -107,11 +138,18 @@ class ThreadPool {
  private:
   using TaskList = IntrusiveDList<Task>;
   using WorkerList = IntrusiveDList<Worker>;
+  using ParkedWorkerList = IntrusiveDList<Worker, 2>;
 
-  bool RunImpl(std::unique_ptr<Task> task);
+  bool RunImpl(std::unique_ptr<Task> task, bool urgent);
   void WorkerLoop(Worker* worker);
 
-  Worker* ScheduleTaskLocked(MonitorLocker* ml, std::unique_ptr<Task> task);
+  // Returns a new worker to start, if any. [worker_to_wake] is set to a
+  // parked worker the caller has to wake up after releasing the pool monitor.
+  Worker* ScheduleTaskLocked(MonitorLocker* ml,
+                             std::unique_ptr<Task> task,
+                             bool urgent,
+                             Worker** worker_to_wake);
+  void NotifyIdleWorkerLocked(MonitorLocker* ml, Worker** worker_to_wake);
 
   void IdleToRunningLocked(Worker* worker);
   void RunningToIdleLocked(Worker* worker);
@@ -127,6 +165,7 @@ class ThreadPool {
   WorkerList running_workers_;
   WorkerList idle_workers_;
   WorkerList dead_workers_;
+  ParkedWorkerList parked_workers_;
   uint64_t pending_tasks_ = 0;
   TaskList tasks_;
 
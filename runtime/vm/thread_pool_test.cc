@@ -98,6 +98,55 @@ THREAD_POOL_UNIT_TEST_CASE(ThreadPool_RunMany) {
   }
 }
 
+class OrderTask : public ThreadPool::Task {
+ public:
+  OrderTask(Monitor* sync, int* order, int* count, int id)
+      : sync_(sync), order_(order), count_(count), id_(id) {}
+
+  virtual void Run() {
+    MonitorLocker ml(sync_);
+    order_[*count_] = id_;
+    *count_ = *count_ + 1;
+    ml.Notify();
+  }
+
+ private:
+  Monitor* sync_;
+  int* order_;
+  int* count_;
+  int id_;
+};
+
+THREAD_POOL_UNIT_TEST_CASE(ThreadPool_RunUrgent) {
+  ThreadPool thread_pool(/*max_pool_size=*/1);
+  Monitor blocker_sync;
+  bool blocker_done = true;
+  thread_pool.Run<TestTask>(&blocker_sync, &blocker_done);
+
+  // Both tasks wait for the only worker, the urgent one goes first.
+  Monitor sync;
+  int order[2] = {0, 0};
+  int count = 0;
+  thread_pool.Run<OrderTask>(&sync, order, &count, 1);
+  thread_pool.RunUrgent<OrderTask>(&sync, order, &count, 2);
+  {
+    MonitorLocker ml(&blocker_sync);
+    blocker_done = false;
+    ml.Notify();
+    while (!blocker_done) {
+      ml.Wait();
+    }
+  }
+  {
+    MonitorLocker ml(&sync);
+    while (count < 2) {
+      ml.Wait();
+    }
+  }
+  EXPECT_EQ(2, order[0]);
+  EXPECT_EQ(1, order[1]);
+}
+
 class SleepTask : public ThreadPool::Task {
  public:
   SleepTask(Monitor* sync, int* started_count, int* slept_count, int millis)
@@ -95,6 +95,15 @@ void ThreadRegistry::ReleaseMarkingStacks() {
   }
 }
 
+void ThreadRegistry::ResetOldSpaceCaches() {
+  MonitorLocker ml(threads_lock());
+  Thread* thread = active_list_;
+  while (thread != NULL) {
+    thread->set_old_cache(0, 0);
+    thread = thread->next_;
+  }
+}
+
 void ThreadRegistry::AddToActiveListLocked(Thread* thread) {
   ASSERT(thread != NULL);
   ASSERT(threads_lock()->IsOwnedByCurrentThread());
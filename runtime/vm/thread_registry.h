@@ -32,6 +32,9 @@ class ThreadRegistry {
   void ReleaseStoreBuffers();
   void AcquireMarkingStacks();
   void ReleaseMarkingStacks();
+  // Drops every thread's old-space allocation cache. Only valid at a
+  // safepoint, before the freelists are rebuilt by sweeping.
+  void ResetOldSpaceCaches();
 
 #ifndef PRODUCT
   void PrintJSON(JSONStream* stream) const;
@@ -791,6 +791,35 @@ ISOLATE_UNIT_TEST_CASE(SafepointTestVM2) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(SafepointLatencyMetrics) {
+  IsolateGroup* isolate_group = thread->isolate_group();
+  SafepointHandler* handler = isolate_group->safepoint_handler();
+  const int64_t count_before =
+      isolate_group->GetSafepointCountMetric()->value();
+  int64_t histogram_before = 0;
+  for (intptr_t i = 0; i < SafepointHandler::kNumLatencyBuckets; i++) {
+    histogram_before += handler->LatencyBucketCount(i);
+  }
+  {
+    SafepointOperationScope safepoint_scope(thread);
+    // Recursive operations do not stop the world again.
+    SafepointOperationScope recursive_scope(thread);
+  }
+  {
+    SafepointOperationScope safepoint_scope(thread);
+  }
+  EXPECT_EQ(count_before + 2,
+            isolate_group->GetSafepointCountMetric()->value());
+  int64_t histogram_after = 0;
+  for (intptr_t i = 0; i < SafepointHandler::kNumLatencyBuckets; i++) {
+    histogram_after += handler->LatencyBucketCount(i);
+  }
+  EXPECT_EQ(histogram_before + 2, histogram_after);
+  EXPECT(isolate_group->GetSafepointLatencyMetric()->value() >= 0);
+  EXPECT(isolate_group->GetSafepointLatencyMaxMetric()->value() >=
+         isolate_group->GetSafepointLatencyMetric()->value());
+}
+
 // Test recursive safepoint operation scopes with other threads trying
 // to also start a safepoint operation scope.
 ISOLATE_UNIT_TEST_CASE(RecursiveSafepointTest2) {
@@ -55,7 +55,8 @@ DEFINE_FLAG(charp,
             timeline_recorder,
             "ring",
             "Select the timeline recorder used. "
-            "Valid values: ring, endless, startup, and systrace.")
+            "Valid values: ring, endless, startup, systrace, and "
+            "perfettofile[:path].")
 
 // Implementation notes:
 //
@@ -99,6 +100,8 @@ DEFINE_FLAG(charp,
 //       |TimelineEventRecorder::lock_|
 //
 
+#define PERFETTO_FILE_RECORDER_FLAG "perfettofile"
+
 static TimelineEventRecorder* CreateTimelineRecorder() {
   // Some flags require that we use the endless recorder.
   const bool use_endless_recorder =
@@ -131,6 +134,20 @@ static TimelineEventRecorder* CreateTimelineRecorder() {
     }
   }
 
+  const intptr_t perfetto_length = strlen(PERFETTO_FILE_RECORDER_FLAG);
+  if ((flag != NULL) &&
+      (strncmp(PERFETTO_FILE_RECORDER_FLAG, flag, perfetto_length) == 0) &&
+      ((flag[perfetto_length] == '\0') || (flag[perfetto_length] == ':'))) {
+    const char* path = (flag[perfetto_length] == ':')
+                           ? &flag[perfetto_length + 1]
+                           : "dart.perfetto-trace";
+    if (FLAG_trace_timeline) {
+      THR_Print("Using the Perfetto timeline recorder, writing to %s.\n",
+                path);
+    }
+    return new TimelineEventPerfettoRecorder(path);
+  }
+
   if (use_endless_recorder || (flag != NULL)) {
     if (use_endless_recorder || (strcmp("endless", flag) == 0)) {
       if (FLAG_trace_timeline) {
@@ -1436,6 +1453,518 @@ void TimelineEventEndlessRecorder::Clear() {
   thread->set_timeline_block(NULL);
 }
 
+// Field numbers from the protos in perfetto/protos/perfetto/trace/.
+enum PerfettoField {
+  kTracePacketField = 1,  // Trace.packet
+
+  kTimestampField = 8,  // TracePacket.timestamp
+  kTrustedPacketSequenceIdField = 10,
+  kTrackEventField = 11,
+  kTrackDescriptorField = 60,
+
+  kTrackEventTypeField = 9,  // TrackEvent.type
+  kTrackEventTrackUuidField = 11,
+  kTrackEventCategoriesField = 22,
+  kTrackEventNameField = 23,
+  kTrackEventDebugAnnotationsField = 4,
+  kTrackEventFlowIdsField = 47,
+  kTrackEventTerminatingFlowIdsField = 48,
+
+  kDebugAnnotationNameField = 10,  // DebugAnnotation.name
+  kDebugAnnotationStringValueField = 6,
+  kDebugAnnotationLegacyJsonValueField = 9,
+
+  kTrackDescriptorUuidField = 1,  // TrackDescriptor.uuid
+  kTrackDescriptorNameField = 2,
+  kTrackDescriptorProcessField = 3,
+  kTrackDescriptorThreadField = 4,
+  kTrackDescriptorParentUuidField = 5,
+
+  kProcessDescriptorPidField = 1,  // ProcessDescriptor.pid
+
+  kThreadDescriptorPidField = 1,  // ThreadDescriptor.pid
+  kThreadDescriptorTidField = 2,
+  kThreadDescriptorThreadNameField = 5,
+};
+
+// TrackEvent.Type.
+enum PerfettoTrackEventType {
+  kPerfettoSliceBegin = 1,
+  kPerfettoSliceEnd = 2,
+  kPerfettoInstant = 3,
+};
+
+enum ProtoWireType {
+  kVarIntWireType = 0,
+  kFixed64WireType = 1,
+  kLengthDelimitedWireType = 2,
+};
+
+// All packets are written on one sequence and do not use interning, so any
+// nonzero id will do.
+static const uint64_t kPerfettoSequenceId = 1;
+
+// Async events and the process get their own tracks. Their uuids are kept
+// apart from the thread tracks, whose uuid is the thread id.
+static const uint64_t kAsyncTrackUuidBit = static_cast<uint64_t>(1) << 63;
+static const uint64_t kProcessTrackUuidBit = static_cast<uint64_t>(1) << 62;
+
+static void AppendVarInt(MallocGrowableArray<uint8_t>* buffer, uint64_t value) {
+  while (value >= 0x80) {
+    buffer->Add(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  buffer->Add(static_cast<uint8_t>(value));
+}
+
+static void AppendTag(MallocGrowableArray<uint8_t>* buffer,
+                      intptr_t field,
+                      ProtoWireType wire_type) {
+  AppendVarInt(buffer, (static_cast<uint64_t>(field) << 3) | wire_type);
+}
+
+static void AppendVarIntField(MallocGrowableArray<uint8_t>* buffer,
+                              intptr_t field,
+                              uint64_t value) {
+  AppendTag(buffer, field, kVarIntWireType);
+  AppendVarInt(buffer, value);
+}
+
+static void AppendFixed64Field(MallocGrowableArray<uint8_t>* buffer,
+                               intptr_t field,
+                               uint64_t value) {
+  AppendTag(buffer, field, kFixed64WireType);
+  for (intptr_t i = 0; i < 8; i++) {
+    buffer->Add(static_cast<uint8_t>(value >> (i * 8)));
+  }
+}
+
+static void AppendStringField(MallocGrowableArray<uint8_t>* buffer,
+                              intptr_t field,
+                              const char* value) {
+  const intptr_t length = strlen(value);
+  AppendTag(buffer, field, kLengthDelimitedWireType);
+  AppendVarInt(buffer, length);
+  for (intptr_t i = 0; i < length; i++) {
+    buffer->Add(static_cast<uint8_t>(value[i]));
+  }
+}
+
+// Nested messages get a four byte length, padded with continuation bits, so
+// that it can be filled in once the message ends without moving its contents.
+// That limits a message to 2^28 bytes, far more than an event needs.
+static intptr_t BeginMessage(MallocGrowableArray<uint8_t>* buffer,
+                             intptr_t field) {
+  AppendTag(buffer, field, kLengthDelimitedWireType);
+  const intptr_t position = buffer->length();
+  for (intptr_t i = 0; i < 4; i++) {
+    buffer->Add(0);
+  }
+  return position;
+}
+
+static void EndMessage(MallocGrowableArray<uint8_t>* buffer,
+                       intptr_t position) {
+  uintptr_t size = buffer->length() - position - 4;
+  ASSERT(size < (static_cast<uintptr_t>(1) << 28));
+  for (intptr_t i = 0; i < 3; i++) {
+    (*buffer)[position + i] = static_cast<uint8_t>((size & 0x7f) | 0x80);
+    size >>= 7;
+  }
+  (*buffer)[position + 3] = static_cast<uint8_t>(size);
+}
+
+static bool IsAsyncEvent(const TimelineEvent* event) {
+  switch (event->event_type()) {
+    case TimelineEvent::kAsyncBegin:
+    case TimelineEvent::kAsyncInstant:
+    case TimelineEvent::kAsyncEnd:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static uint64_t TrackUuidOf(const TimelineEvent* event) {
+  if (IsAsyncEvent(event)) {
+    return kAsyncTrackUuidBit | static_cast<uint64_t>(event->AsyncId());
+  }
+  return static_cast<uint64_t>(OSThread::ThreadIdToIntPtr(event->thread()));
+}
+
+TimelineEventPerfettoRecorder::TimelineEventPerfettoRecorder(const char* path)
+    : path_(Utils::StrDup(path)),
+      head_(nullptr),
+      tail_(nullptr),
+      free_list_(nullptr),
+      block_count_(0),
+      shutting_down_(false),
+      writer_thread_id_(OSThread::kInvalidThreadJoinId),
+      file_(nullptr),
+      file_failed_(false) {
+  MonitorLocker ml(&monitor_);
+  OSThread::Start("Dart Timeline Writer", ThreadMain,
+                  reinterpret_cast<uword>(this));
+  while (writer_thread_id_ == OSThread::kInvalidThreadJoinId) {
+    ml.Wait();
+  }
+}
+
+TimelineEventPerfettoRecorder::~TimelineEventPerfettoRecorder() {
+  {
+    MonitorLocker ml(&monitor_);
+    shutting_down_ = true;
+    ml.Notify();
+  }
+  OSThread::Join(writer_thread_id_);
+  writer_thread_id_ = OSThread::kInvalidThreadJoinId;
+
+  // Write out what the threads still have cached.
+  Timeline::ReclaimCachedBlocksFromThreads();
+  Drain();
+  if (file_ != nullptr) {
+    (*Dart::file_close_callback())(file_);
+    file_ = nullptr;
+  }
+
+  ASSERT(head_ == nullptr);
+  TimelineEventBlock* current = free_list_;
+  free_list_ = nullptr;
+  while (current != nullptr) {
+    TimelineEventBlock* next = current->next();
+    delete current;
+    current = next;
+  }
+  free(path_);
+}
+
+#ifndef PRODUCT
+void TimelineEventPerfettoRecorder::PrintJSON(JSONStream* js,
+                                              TimelineEventFilter* filter) {
+  JSONObject topLevel(js);
+  topLevel.AddProperty("type", "Timeline");
+  {
+    JSONArray events(&topLevel, "traceEvents");
+    PrintJSONMeta(&events);
+  }
+  topLevel.AddPropertyTimeMicros("timeOriginMicros", TimeOriginMicros());
+  topLevel.AddPropertyTimeMicros("timeExtentMicros", TimeExtentMicros());
+}
+
+void TimelineEventPerfettoRecorder::PrintTraceEvent(
+    JSONStream* js,
+    TimelineEventFilter* filter) {
+  JSONArray events(js);
+}
+#endif
+
+TimelineEventBlock* TimelineEventPerfettoRecorder::GetHeadBlockLocked() {
+  return head_;
+}
+
+TimelineEvent* TimelineEventPerfettoRecorder::StartEvent() {
+  return ThreadBlockStartEvent();
+}
+
+void TimelineEventPerfettoRecorder::CompleteEvent(TimelineEvent* event) {
+  if (event == NULL) {
+    return;
+  }
+  ThreadBlockCompleteEvent(event);
+}
+
+TimelineEventBlock* TimelineEventPerfettoRecorder::GetNewBlockLocked() {
+  TimelineEventBlock* block = free_list_;
+  if (block != nullptr) {
+    free_list_ = block->next();
+    block->set_next(nullptr);
+  } else {
+    block = new TimelineEventBlock(block_count_++);
+  }
+  block->Open();
+  if (head_ == nullptr) {
+    head_ = tail_ = block;
+  } else {
+    tail_->set_next(block);
+    tail_ = block;
+  }
+  return block;
+}
+
+void TimelineEventPerfettoRecorder::ThreadMain(uword parameter) {
+  TimelineEventPerfettoRecorder* recorder =
+      reinterpret_cast<TimelineEventPerfettoRecorder*>(parameter);
+  {
+    MonitorLocker ml(&recorder->monitor_);
+    recorder->writer_thread_id_ =
+        OSThread::GetCurrentThreadJoinId(OSThread::Current());
+    ml.Notify();
+  }
+  while (true) {
+    {
+      MonitorLocker ml(&recorder->monitor_);
+      if (!recorder->shutting_down_) {
+        ml.WaitMicros(kWritePeriodMicros);
+      }
+      if (recorder->shutting_down_) {
+        return;
+      }
+    }
+    recorder->Drain();
+  }
+}
+
+void TimelineEventPerfettoRecorder::Drain() {
+  // Take the finished blocks off the chain, keeping them in order. Open blocks
+  // stay where they are until their thread finishes them.
+  TimelineEventBlock* finished_head = nullptr;
+  TimelineEventBlock* finished_tail = nullptr;
+  {
+    MutexLocker ml(&lock_);
+    TimelineEventBlock* previous = nullptr;
+    TimelineEventBlock* current = head_;
+    while (current != nullptr) {
+      TimelineEventBlock* next = current->next();
+      if (current->in_use()) {
+        previous = current;
+      } else {
+        if (previous == nullptr) {
+          head_ = next;
+        } else {
+          previous->set_next(next);
+        }
+        if (tail_ == current) {
+          tail_ = previous;
+        }
+        current->set_next(nullptr);
+        if (finished_tail == nullptr) {
+          finished_head = finished_tail = current;
+        } else {
+          finished_tail->set_next(current);
+          finished_tail = current;
+        }
+      }
+      current = next;
+    }
+  }
+  if (finished_head == nullptr) {
+    return;
+  }
+
+  for (TimelineEventBlock* block = finished_head; block != nullptr;
+       block = block->next()) {
+    WriteBlock(block);
+    block->Reset();
+  }
+  Flush();
+
+  MutexLocker ml(&lock_);
+  finished_tail->set_next(free_list_);
+  free_list_ = finished_head;
+}
+
+void TimelineEventPerfettoRecorder::WriteBlock(TimelineEventBlock* block) {
+  if ((file_ == nullptr) && !file_failed_) {
+    Dart_FileOpenCallback file_open = Dart::file_open_callback();
+    if ((file_open == nullptr) || (Dart::file_write_callback() == nullptr) ||
+        (Dart::file_close_callback() == nullptr)) {
+      file_failed_ = true;
+    } else {
+      file_ = (*file_open)(path_, true);
+      file_failed_ = (file_ == nullptr);
+    }
+    if (file_failed_) {
+      OS::PrintErr("Failed to open timeline file: %s\n", path_);
+    } else {
+      const uint64_t pid = OS::ProcessId();
+      const intptr_t packet = BeginMessage(&buffer_, kTracePacketField);
+      AppendVarIntField(&buffer_, kTrustedPacketSequenceIdField,
+                        kPerfettoSequenceId);
+      const intptr_t descriptor =
+          BeginMessage(&buffer_, kTrackDescriptorField);
+      AppendVarIntField(&buffer_, kTrackDescriptorUuidField,
+                        kProcessTrackUuidBit | pid);
+      const intptr_t process =
+          BeginMessage(&buffer_, kTrackDescriptorProcessField);
+      AppendVarIntField(&buffer_, kProcessDescriptorPidField, pid);
+      EndMessage(&buffer_, process);
+      EndMessage(&buffer_, descriptor);
+      EndMessage(&buffer_, packet);
+    }
+  }
+  if (file_failed_) {
+    return;
+  }
+
+  for (intptr_t i = 0; i < block->length(); i++) {
+    const TimelineEvent* event = block->At(i);
+    if (!event->IsValid()) {
+      continue;
+    }
+    const uint64_t track_uuid = TrackUuidOf(event);
+    if (!tracks_.HasKey(track_uuid)) {
+      tracks_.Insert(track_uuid);
+      WriteTrackDescriptor(event, track_uuid);
+    }
+    EncodeEvent(event, track_uuid, &buffer_);
+  }
+  if (buffer_.length() >= 64 * KB) {
+    Flush();
+  }
+}
+
+void TimelineEventPerfettoRecorder::WriteTrackDescriptor(
+    const TimelineEvent* event,
+    uint64_t track_uuid) {
+  const uint64_t pid = OS::ProcessId();
+  const intptr_t packet = BeginMessage(&buffer_, kTracePacketField);
+  AppendVarIntField(&buffer_, kTrustedPacketSequenceIdField,
+                    kPerfettoSequenceId);
+  const intptr_t descriptor = BeginMessage(&buffer_, kTrackDescriptorField);
+  AppendVarIntField(&buffer_, kTrackDescriptorUuidField, track_uuid);
+  if (IsAsyncEvent(event)) {
+    AppendVarIntField(&buffer_, kTrackDescriptorParentUuidField,
+                      kProcessTrackUuidBit | pid);
+    if (event->label() != NULL) {
+      AppendStringField(&buffer_, kTrackDescriptorNameField, event->label());
+    }
+  } else {
+    const intptr_t thread = BeginMessage(&buffer_, kTrackDescriptorThreadField);
+    AppendVarIntField(&buffer_, kThreadDescriptorPidField, pid);
+    AppendVarIntField(&buffer_, kThreadDescriptorTidField, track_uuid);
+    OSThreadIterator it;
+    while (it.HasNext()) {
+      OSThread* os_thread = it.Next();
+      if ((OSThread::ThreadIdToIntPtr(os_thread->trace_id()) ==
+           static_cast<intptr_t>(track_uuid)) &&
+          (os_thread->name() != NULL)) {
+        AppendStringField(&buffer_, kThreadDescriptorThreadNameField,
+                          os_thread->name());
+        break;
+      }
+    }
+    EndMessage(&buffer_, thread);
+  }
+  EndMessage(&buffer_, descriptor);
+  EndMessage(&buffer_, packet);
+}
+
+void TimelineEventPerfettoRecorder::Flush() {
+  if ((file_ != nullptr) && !buffer_.is_empty()) {
+    (*Dart::file_write_callback())(buffer_.data(), buffer_.length(), file_);
+  }
+  buffer_.Clear();
+}
+
+// Only the slice begin written for a duration event carries its name,
+// category and arguments, so |with_details| is false for the matching end.
+static void AppendTrackEvent(const TimelineEvent* event,
+                             PerfettoTrackEventType type,
+                             int64_t micros,
+                             uint64_t track_uuid,
+                             const char* category,
+                             bool pre_serialized_args,
+                             bool with_details,
+                             MallocGrowableArray<uint8_t>* buffer) {
+  const intptr_t packet = BeginMessage(buffer, kTracePacketField);
+  AppendVarIntField(buffer, kTimestampField,
+                    static_cast<uint64_t>(micros) * kNanosecondsPerMicrosecond);
+  AppendVarIntField(buffer, kTrustedPacketSequenceIdField,
+                    kPerfettoSequenceId);
+  const intptr_t track_event = BeginMessage(buffer, kTrackEventField);
+  AppendVarIntField(buffer, kTrackEventTypeField, type);
+  AppendVarIntField(buffer, kTrackEventTrackUuidField, track_uuid);
+  if (!with_details) {
+    EndMessage(buffer, track_event);
+    EndMessage(buffer, packet);
+    return;
+  }
+  if (type != kPerfettoSliceEnd) {
+    if (category != NULL) {
+      AppendStringField(buffer, kTrackEventCategoriesField, category);
+    }
+    if (event->label() != NULL) {
+      AppendStringField(buffer, kTrackEventNameField, event->label());
+    }
+  }
+  for (intptr_t i = 0; i < event->arguments_length(); i++) {
+    const TimelineEventArgument& argument = event->arguments()[i];
+    const intptr_t annotation =
+        BeginMessage(buffer, kTrackEventDebugAnnotationsField);
+    if (pre_serialized_args) {
+      AppendStringField(buffer, kDebugAnnotationNameField, "args");
+      AppendStringField(buffer, kDebugAnnotationLegacyJsonValueField,
+                        argument.value);
+    } else {
+      AppendStringField(buffer, kDebugAnnotationNameField, argument.name);
+      AppendStringField(buffer, kDebugAnnotationStringValueField,
+                        argument.value);
+    }
+    EndMessage(buffer, annotation);
+  }
+  switch (event->event_type()) {
+    case TimelineEvent::kFlowBegin:
+    case TimelineEvent::kFlowStep:
+      AppendFixed64Field(buffer, kTrackEventFlowIdsField, event->AsyncId());
+      break;
+    case TimelineEvent::kFlowEnd:
+      AppendFixed64Field(buffer, kTrackEventTerminatingFlowIdsField,
+                         event->AsyncId());
+      break;
+    default:
+      break;
+  }
+  EndMessage(buffer, track_event);
+  EndMessage(buffer, packet);
+}
+
+intptr_t TimelineEventPerfettoRecorder::EncodeEvent(
+    const TimelineEvent* event,
+    uint64_t track_uuid,
+    MallocGrowableArray<uint8_t>* buffer) {
+  const char* category =
+      (event->stream_ != NULL) ? event->stream_->name() : NULL;
+  const bool pre_serialized_args = event->pre_serialized_args();
+  switch (event->event_type()) {
+    case TimelineEvent::kBegin:
+    case TimelineEvent::kAsyncBegin:
+      AppendTrackEvent(event, kPerfettoSliceBegin, event->TimeOrigin(),
+                       track_uuid, category, pre_serialized_args, true,
+                       buffer);
+      return 1;
+    case TimelineEvent::kEnd:
+    case TimelineEvent::kAsyncEnd:
+      AppendTrackEvent(event, kPerfettoSliceEnd, event->TimeOrigin(),
+                       track_uuid, category, pre_serialized_args, true,
+                       buffer);
+      return 1;
+    case TimelineEvent::kDuration:
+      if (event->IsFinishedDuration()) {
+        AppendTrackEvent(event, kPerfettoSliceBegin, event->TimeOrigin(),
+                         track_uuid, category, pre_serialized_args, true,
+                         buffer);
+        AppendTrackEvent(event, kPerfettoSliceEnd, event->TimeEnd(),
+                         track_uuid, category, pre_serialized_args, false,
+                         buffer);
+        return 2;
+      }
+      FALL_THROUGH;
+    case TimelineEvent::kInstant:
+    case TimelineEvent::kAsyncInstant:
+    case TimelineEvent::kCounter:
+    case TimelineEvent::kFlowBegin:
+    case TimelineEvent::kFlowStep:
+    case TimelineEvent::kFlowEnd:
+      AppendTrackEvent(event, kPerfettoInstant, event->TimeOrigin(),
+                       track_uuid, category, pre_serialized_args, true,
+                       buffer);
+      return 1;
+    default:
+      // Metadata events only name things, which the track descriptors do.
+      return 0;
+  }
+}
+
 TimelineEventBlock::TimelineEventBlock(intptr_t block_index)
     : next_(NULL),
       length_(0),
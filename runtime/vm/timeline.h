@@ -12,6 +12,7 @@
 #include "vm/bitfield.h"
 #include "vm/globals.h"
 #include "vm/growable_array.h"
+#include "vm/hash_map.h"
 #include "vm/os.h"
 #include "vm/os_thread.h"
 
@@ -51,6 +52,7 @@ class Zone;
 #define ENDLESS_RECORDER_NAME "Endless"
 #define FUCHSIA_RECORDER_NAME "Fuchsia"
 #define MACOS_RECORDER_NAME "Macos"
+#define PERFETTO_RECORDER_NAME "Perfetto"
 #define RING_RECORDER_NAME "Ring"
 #define STARTUP_RECORDER_NAME "Startup"
 #define SYSTRACE_RECORDER_NAME "Systrace"
@@ -481,6 +483,7 @@ class TimelineEvent {
   friend class TimelineEventPlatformRecorder;
   friend class TimelineEventFuchsiaRecorder;
   friend class TimelineEventMacosRecorder;
+  friend class TimelineEventPerfettoRecorder;
   friend class TimelineStream;
   friend class TimelineTestHelper;
   DISALLOW_COPY_AND_ASSIGN(TimelineEvent);
@@ -646,6 +649,7 @@ class TimelineEventBlock : public MallocAllocated {
   friend class TimelineEventRingRecorder;
   friend class TimelineEventStartupRecorder;
   friend class TimelineEventPlatformRecorder;
+  friend class TimelineEventPerfettoRecorder;
   friend class TimelineTestHelper;
   friend class JSONStream;
 
@@ -886,6 +890,90 @@ class TimelineEventEndlessRecorder : public TimelineEventRecorder {
   friend class TimelineTestHelper;
 };
 
+// A recorder that streams events to a file in Perfetto's protobuf trace
+// format (https://perfetto.dev/docs/reference/trace-packet-proto), which
+// ui.perfetto.dev and trace_processor open directly.
+//
+// Threads fill their cached blocks as with the endless recorder. A writer
+// thread periodically takes the finished blocks off the chain, encodes them
+// outside of |lock_| and puts them on a free list for reuse, so memory use is
+// bounded by how far the writer falls behind rather than by the length of the
+// trace.
+class TimelineEventPerfettoRecorder : public TimelineEventRecorder {
+ public:
+  explicit TimelineEventPerfettoRecorder(const char* path);
+  virtual ~TimelineEventPerfettoRecorder();
+
+#ifndef PRODUCT
+  void PrintJSON(JSONStream* js, TimelineEventFilter* filter);
+  void PrintTraceEvent(JSONStream* js, TimelineEventFilter* filter);
+#endif
+
+  const char* name() const { return PERFETTO_RECORDER_NAME; }
+  intptr_t Size() { return block_count_ * sizeof(TimelineEventBlock); }
+
+  // Appends the trace packets for |event| on the track |track_uuid| to
+  // |buffer| and returns how many were written. Exposed for testing.
+  static intptr_t EncodeEvent(const TimelineEvent* event,
+                              uint64_t track_uuid,
+                              MallocGrowableArray<uint8_t>* buffer);
+
+ protected:
+  TimelineEvent* StartEvent();
+  void CompleteEvent(TimelineEvent* event);
+  TimelineEventBlock* GetNewBlockLocked();
+  TimelineEventBlock* GetHeadBlockLocked();
+  // Events are written out as they are recorded, so there is nothing to clear.
+  void Clear() {}
+
+ private:
+  class TrackKeyValueTrait {
+   public:
+    typedef uint64_t Key;
+    typedef uint64_t Value;
+    typedef uint64_t Pair;
+
+    static Key KeyOf(Pair kv) { return kv; }
+    static Value ValueOf(Pair kv) { return kv; }
+    static inline intptr_t Hashcode(Key key) {
+      return static_cast<intptr_t>(key ^ (key >> 32));
+    }
+    static inline bool IsKeyEqual(Pair kv, Key key) { return kv == key; }
+  };
+
+  static const int64_t kWritePeriodMicros = 100 * kMicrosecondsPerMillisecond;
+
+  static void ThreadMain(uword parameter);
+
+  // Writes out the finished blocks and recycles them. Only called on the
+  // writer thread, or once it has been joined.
+  void Drain();
+  void WriteBlock(TimelineEventBlock* block);
+  void WriteTrackDescriptor(const TimelineEvent* event, uint64_t track_uuid);
+  void Flush();
+
+  char* path_;
+
+  // Guarded by |lock_|.
+  TimelineEventBlock* head_;
+  TimelineEventBlock* tail_;
+  TimelineEventBlock* free_list_;
+  intptr_t block_count_;
+
+  // Guarded by |monitor_|.
+  Monitor monitor_;
+  bool shutting_down_;
+  ThreadJoinId writer_thread_id_;
+
+  // Only accessed by the writer thread.
+  void* file_;
+  bool file_failed_;
+  MallocGrowableArray<uint8_t> buffer_;
+  MallocDirectChainedHashMap<TrackKeyValueTrait> tracks_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimelineEventPerfettoRecorder);
+};
+
 // An iterator for blocks.
 class TimelineEventBlockIterator {
  public:
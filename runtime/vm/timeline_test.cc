@@ -206,6 +206,58 @@ TEST_CASE(TimelineEventPrintSystrace) {
 }
 #endif  // defined(HOST_OS_ANDROID) || defined(HOST_OS_LINUX)
 
+static bool ContainsBytes(const MallocGrowableArray<uint8_t>& buffer,
+                          const char* bytes) {
+  const intptr_t length = strlen(bytes);
+  for (intptr_t i = 0; i + length <= buffer.length(); i++) {
+    if (memcmp(&buffer[i], bytes, length) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST_CASE(TimelineEventEncodePerfetto) {
+  // Create a test stream.
+  TimelineStream stream("testStream", "testStream", true);
+
+  // Create a test event.
+  TimelineEvent event;
+  TimelineTestHelper::SetStream(&event, &stream);
+
+  // An instant is one packet with its name, category and arguments.
+  MallocGrowableArray<uint8_t> buffer;
+  event.Instant("apple", 1);
+  event.SetNumArguments(1);
+  event.CopyArgument(0, "color", "green");
+  EXPECT_EQ(1, TimelineEventPerfettoRecorder::EncodeEvent(&event, 7, &buffer));
+  // Trace.packet, a length-delimited field 1.
+  EXPECT_EQ(0x0a, buffer[0]);
+  // TrackEvent.name, field 23.
+  EXPECT(ContainsBytes(buffer, "\xba\x01\x05" "apple"));
+  // TrackEvent.categories, field 22.
+  EXPECT(ContainsBytes(buffer, "\xb2\x01\x0a" "testStream"));
+  // TrackEvent.type INSTANT and track_uuid 7.
+  EXPECT(ContainsBytes(buffer, "\x48\x03\x58\x07"));
+  EXPECT(ContainsBytes(buffer, "color"));
+  EXPECT(ContainsBytes(buffer, "green"));
+
+  // A duration becomes a slice begin and end.
+  buffer.Clear();
+  event.Duration("banana", 1, 2);
+  EXPECT_EQ(2, TimelineEventPerfettoRecorder::EncodeEvent(&event, 7, &buffer));
+  EXPECT(ContainsBytes(buffer, "\x48\x01\x58\x07"));
+  EXPECT(ContainsBytes(buffer, "\x48\x02\x58\x07"));
+  // The end is at 2 microseconds, TracePacket.timestamp in nanoseconds.
+  EXPECT(ContainsBytes(buffer, "\x40\xd0\x0f"));
+
+  // Metadata is not written.
+  buffer.Clear();
+  event.Metadata("cherry", 1);
+  EXPECT_EQ(0, TimelineEventPerfettoRecorder::EncodeEvent(&event, 7, &buffer));
+  EXPECT_EQ(0, buffer.length());
+}
+
 TEST_CASE(TimelineEventArguments) {
   // Create a test stream.
   TimelineStream stream("testStream", "testStream", true);
@@ -0,0 +1,114 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/transferable_buffer_pool.h"
+
+#include "platform/utils.h"
+#include "vm/flags.h"
+#include "vm/lockers.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+DEFINE_FLAG(int,
+            transferable_buffer_pool_min_size,
+            64 * KB,
+            "Size in bytes from which freed TransferableTypedData buffers are "
+            "kept for reuse.");
+DEFINE_FLAG(int,
+            transferable_buffer_pool_capacity,
+            32 * MB,
+            "Maximum number of bytes in cached TransferableTypedData buffers.");
+
+// Each buffer starts with a header holding its capacity. The header keeps the
+// data at the alignment of malloc.
+static constexpr intptr_t kHeaderSize = 16;
+// Pooled buffers are allocated in multiples of the granularity, so buffers of
+// slightly different lengths can share them.
+static constexpr intptr_t kGranularity = 64 * KB;
+static constexpr intptr_t kPoolCapacity = 16;
+
+static Mutex* pool_mutex = nullptr;
+static uint8_t* pool[kPoolCapacity] = {nullptr};
+static intptr_t pool_size = 0;
+static intptr_t pool_bytes = 0;
+
+static intptr_t& CapacityOf(uint8_t* buffer) {
+  return *reinterpret_cast<intptr_t*>(buffer);
+}
+
+void TransferableBufferPool::Init() {
+  ASSERT(pool_mutex == nullptr);
+  pool_mutex = new Mutex(NOT_IN_PRODUCT("transferable_buffer_pool_mutex"));
+}
+
+void TransferableBufferPool::Cleanup() {
+  {
+    MutexLocker ml(pool_mutex);
+    while (pool_size > 0) {
+      free(pool[--pool_size]);
+    }
+    pool_bytes = 0;
+  }
+  delete pool_mutex;
+  pool_mutex = nullptr;
+}
+
+intptr_t TransferableBufferPool::CachedSize() {
+  MutexLocker ml(pool_mutex);
+  return pool_bytes;
+}
+
+uint8_t* TransferableBufferPool::Allocate(intptr_t length) {
+  ASSERT(length >= 0);
+  const bool poolable = length >= FLAG_transferable_buffer_pool_min_size;
+  if (poolable) {
+    MutexLocker ml(pool_mutex);
+    // Take the smallest pooled buffer that fits, unless it would waste more
+    // than half of its memory.
+    intptr_t best = -1;
+    for (intptr_t i = 0; i < pool_size; i++) {
+      const intptr_t capacity = CapacityOf(pool[i]);
+      if ((capacity >= length) && (capacity / 2 <= length) &&
+          ((best == -1) || (capacity < CapacityOf(pool[best])))) {
+        best = i;
+      }
+    }
+    if (best != -1) {
+      uint8_t* buffer = pool[best];
+      pool[best] = pool[--pool_size];
+      pool_bytes -= CapacityOf(buffer);
+      return buffer + kHeaderSize;
+    }
+  }
+
+  const intptr_t capacity =
+      poolable ? Utils::RoundUp(length, kGranularity) : length;
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(kHeaderSize + capacity));
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  CapacityOf(buffer) = capacity;
+  return buffer + kHeaderSize;
+}
+
+void TransferableBufferPool::Free(uint8_t* data) {
+  if (data == nullptr) {
+    return;
+  }
+  uint8_t* buffer = data - kHeaderSize;
+  const intptr_t capacity = CapacityOf(buffer);
+  if (capacity >= FLAG_transferable_buffer_pool_min_size) {
+    MutexLocker ml(pool_mutex);
+    if ((pool_size < kPoolCapacity) &&
+        (pool_bytes + capacity <= FLAG_transferable_buffer_pool_capacity)) {
+      pool[pool_size++] = buffer;
+      pool_bytes += capacity;
+      return;
+    }
+  }
+  free(buffer);
+}
+
+}  // namespace dart
@@ -0,0 +1,38 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_TRANSFERABLE_BUFFER_POOL_H_
+#define RUNTIME_VM_TRANSFERABLE_BUFFER_POOL_H_
+
+#include "vm/allocation.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+// Backing stores of TransferableTypedData objects and of the external typed
+// data they are materialized into.
+//
+// The buffers move between isolates together with their ownership and are
+// freed by whichever isolate drops them last. Large buffers are kept in a
+// process-wide pool when they are freed, so programs that keep transferring
+// buffers of similar sizes reuse the same (already faulted in) memory instead
+// of going through malloc and mmap for every transfer.
+class TransferableBufferPool : public AllStatic {
+ public:
+  static void Init();
+  static void Cleanup();
+
+  // Returns a buffer of at least [length] bytes or nullptr if out of memory.
+  static uint8_t* Allocate(intptr_t length);
+
+  // Frees a buffer returned by [Allocate]. Accepts nullptr.
+  static void Free(uint8_t* data);
+
+  // The number of bytes in pooled buffers.
+  static intptr_t CachedSize();
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_TRANSFERABLE_BUFFER_POOL_H_
@@ -0,0 +1,42 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/transferable_buffer_pool.h"
+#include "platform/assert.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+VM_UNIT_TEST_CASE(TransferableBufferPool_ReusesLargeBuffers) {
+  const intptr_t cached_size = TransferableBufferPool::CachedSize();
+  uint8_t* data = TransferableBufferPool::Allocate(1 * MB);
+  EXPECT(data != nullptr);
+  data[0] = 1;
+  data[1 * MB - 1] = 2;
+  TransferableBufferPool::Free(data);
+  EXPECT_LT(cached_size, TransferableBufferPool::CachedSize());
+
+  // A buffer of a similar size is taken from the pool.
+  uint8_t* reused = TransferableBufferPool::Allocate(1 * MB - 100);
+  EXPECT_EQ(data, reused);
+  EXPECT_EQ(cached_size, TransferableBufferPool::CachedSize());
+
+  // A much smaller one would waste most of the pooled memory.
+  TransferableBufferPool::Free(reused);
+  uint8_t* smaller = TransferableBufferPool::Allocate(128 * KB);
+  EXPECT(smaller != reused);
+  TransferableBufferPool::Free(smaller);
+}
+
+VM_UNIT_TEST_CASE(TransferableBufferPool_SmallBuffersAreNotPooled) {
+  const intptr_t cached_size = TransferableBufferPool::CachedSize();
+  uint8_t* data = TransferableBufferPool::Allocate(16);
+  EXPECT(data != nullptr);
+  memset(data, 0xff, 16);
+  TransferableBufferPool::Free(data);
+  EXPECT_EQ(cached_size, TransferableBufferPool::CachedSize());
+  TransferableBufferPool::Free(nullptr);
+}
+
+}  // namespace dart
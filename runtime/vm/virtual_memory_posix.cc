@@ -41,8 +41,32 @@ DECLARE_FLAG(bool, generate_perf_events_symbols);
 DECLARE_FLAG(bool, generate_perf_jitdump);
 #endif
 
+#if defined(HOST_OS_LINUX)
+DEFINE_FLAG(bool,
+            heap_huge_pages,
+            false,
+            "Carve heap pages out of 2MB-aligned regions that are advised to "
+            "use transparent huge pages.");
+DEFINE_FLAG(bool,
+            heap_numa_local,
+            false,
+            "Prefer the NUMA node of the allocating thread for heap pages.");
+#endif
+
 uword VirtualMemory::page_size_ = 0;
 
+#if defined(HOST_OS_LINUX)
+static constexpr intptr_t kHugePageSize = 2 * MB;
+static constexpr intptr_t kMaxNumaNodes = 8;
+
+// Heap pages are smaller than a huge page, so they are handed out from a
+// shared 2MB-aligned region per NUMA node. Freeing a page unmaps only that
+// page; the kernel splits the huge page as needed.
+static Mutex* huge_region_mutex_ = nullptr;
+static uword huge_region_top_[kMaxNumaNodes + 1] = {};
+static uword huge_region_end_[kMaxNumaNodes + 1] = {};
+#endif
+
 intptr_t VirtualMemory::CalculatePageSize() {
   const intptr_t page_size = getpagesize();
   ASSERT(page_size != 0);
@@ -58,6 +82,12 @@ void VirtualMemory::Init() {
 
   page_size_ = CalculatePageSize();
 
+#if defined(HOST_OS_LINUX)
+  if (huge_region_mutex_ == nullptr) {
+    huge_region_mutex_ = new Mutex();
+  }
+#endif
+
 #if defined(DUAL_MAPPING_SUPPORTED)
 // Perf is Linux-specific and the flags aren't defined in Product.
 #if defined(TARGET_OS_LINUX) && !defined(PRODUCT)
@@ -135,6 +165,93 @@ static void unmap(uword start, uword end) {
   }
 }
 
+#if defined(HOST_OS_LINUX)
+// Returns the NUMA node of the CPU the calling thread is running on, or -1.
+static intptr_t CurrentNumaNode() {
+#if defined(__NR_getcpu)
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(__NR_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return -1;
+}
+
+static void PreferNumaNode(void* address, intptr_t size, intptr_t node) {
+#if defined(__NR_mbind)
+  if ((node < 0) || (node >= kBitsPerWord)) {
+    return;
+  }
+  const int kMpolPreferred = 1;
+  const uword node_mask = static_cast<uword>(1) << node;
+  // The kernel reads one bit less than maxnode.
+  if (syscall(__NR_mbind, address, size, kMpolPreferred, &node_mask,
+              kBitsPerWord + 1, 0) != 0) {
+    LOG_INFO("mbind(%p, 0x%" Px ", node %" Pd ") failed: %d\n", address, size,
+             node, errno);
+  }
+#endif
+}
+
+// Maps an anonymous region aligned to a huge page and advises the kernel to
+// back it with huge pages. Returns NULL on failure.
+static void* MapHugeRegion(intptr_t size, intptr_t alignment, intptr_t node) {
+  ASSERT(Utils::IsAligned(alignment, kHugePageSize));
+  const intptr_t allocated_size = size + alignment;
+  void* address = mmap(NULL, allocated_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  LOG_INFO("mmap(NULL, 0x%" Px ", ...): %p\n", allocated_size, address);
+  if (address == MAP_FAILED) {
+    return NULL;
+  }
+  const uword base = reinterpret_cast<uword>(address);
+  const uword aligned_base = Utils::RoundUp(base, alignment);
+  unmap(base, aligned_base);
+  unmap(aligned_base + size, base + allocated_size);
+
+  address = reinterpret_cast<void*>(aligned_base);
+#if defined(MADV_HUGEPAGE)
+  if (madvise(address, size, MADV_HUGEPAGE) != 0) {
+    LOG_INFO("madvise(%p, 0x%" Px ", MADV_HUGEPAGE) failed: %d\n", address,
+             size, errno);
+  }
+#endif
+  if (FLAG_heap_numa_local) {
+    PreferNumaNode(address, size, node);
+  }
+  return address;
+}
+
+static void* AllocateFromHugeRegion(intptr_t size, intptr_t alignment) {
+  const intptr_t node = FLAG_heap_numa_local ? CurrentNumaNode() : -1;
+  if ((size >= kHugePageSize) || (alignment > kHugePageSize)) {
+    return MapHugeRegion(size, Utils::Maximum(alignment, kHugePageSize), node);
+  }
+
+  const intptr_t index =
+      ((node >= 0) && (node < kMaxNumaNodes)) ? node : kMaxNumaNodes;
+  MutexLocker ml(huge_region_mutex_);
+  uword top = huge_region_top_[index];
+  uword start = Utils::RoundUp(top, alignment);
+  if ((top == 0) || (start + size > huge_region_end_[index])) {
+    // Give back what is left of the current region and start a new one.
+    unmap(top, huge_region_end_[index]);
+    void* region = MapHugeRegion(kHugePageSize, kHugePageSize, node);
+    if (region == NULL) {
+      huge_region_top_[index] = huge_region_end_[index] = 0;
+      return NULL;
+    }
+    top = reinterpret_cast<uword>(region);
+    huge_region_end_[index] = top + kHugePageSize;
+    start = Utils::RoundUp(top, alignment);
+  }
+  unmap(top, start);
+  huge_region_top_[index] = start + size;
+  return reinterpret_cast<void*>(start);
+}
+#endif  // defined(HOST_OS_LINUX)
+
 #if defined(DUAL_MAPPING_SUPPORTED)
 // Do not leak file descriptors to child processes.
 #if !defined(MFD_CLOEXEC)
@@ -200,6 +317,18 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   ASSERT(Utils::IsAligned(alignment, PageSize()));
   ASSERT(name != nullptr);
   const intptr_t allocated_size = size + alignment - PageSize();
+#if defined(HOST_OS_LINUX)
+  // Heap pages are the only page-size aligned, non-executable reservations.
+  const bool is_heap = !is_executable && (alignment >= kOldPageSize);
+  if (is_heap && FLAG_heap_huge_pages) {
+    void* address = AllocateFromHugeRegion(size, alignment);
+    if (address == NULL) {
+      return NULL;
+    }
+    MemoryRegion region(address, size);
+    return new VirtualMemory(region, region);
+  }
+#endif
 #if defined(DUAL_MAPPING_SUPPORTED)
   const bool dual_mapping =
       is_executable && FLAG_write_protect_code && FLAG_dual_map_code;
@@ -261,6 +390,11 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
     if (region_ptr == NULL) {
       return NULL;
     }
+#if defined(HOST_OS_LINUX)
+    if (is_heap && FLAG_heap_numa_local) {
+      PreferNumaNode(region_ptr, size, CurrentNumaNode());
+    }
+#endif
     MemoryRegion region(region_ptr, size);
     return new VirtualMemory(region, region);
   }
@@ -285,6 +419,12 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   unmap(base, aligned_base);
   unmap(aligned_base + size, base + allocated_size);
 
+#if defined(HOST_OS_LINUX)
+  if (is_heap && FLAG_heap_numa_local) {
+    PreferNumaNode(reinterpret_cast<void*>(aligned_base), size,
+                   CurrentNumaNode());
+  }
+#endif
   MemoryRegion region(reinterpret_cast<void*>(aligned_base), size);
   return new VirtualMemory(region, region);
 }
@@ -9,6 +9,10 @@
 
 namespace dart {
 
+#if defined(HOST_OS_LINUX)
+DECLARE_FLAG(bool, heap_huge_pages);
+#endif
+
 bool IsZero(char* begin, char* end) {
   for (char* current = begin; current < end; ++current) {
     if (*current != 0) {
@@ -64,6 +68,48 @@ VM_UNIT_TEST_CASE(AllocateAlignedVirtualMemory) {
   }
 }
 
+#if defined(HOST_OS_LINUX)
+VM_UNIT_TEST_CASE(AllocateHugePageBackedVirtualMemory) {
+  const bool saved_huge_pages = FLAG_heap_huge_pages;
+  FLAG_heap_huge_pages = true;
+
+  // Heap pages are carved out of shared 2MB-aligned regions.
+  const intptr_t kPagesPerRegion = 2 * MB / kOldPageSize;
+  VirtualMemory* pages[kPagesPerRegion];
+  uword region_start = 0;
+  for (intptr_t i = 0; i < kPagesPerRegion; i++) {
+    pages[i] = VirtualMemory::AllocateAligned(kOldPageSize, kOldPageSize,
+                                              false, "test");
+    EXPECT(pages[i] != NULL);
+    EXPECT(Utils::IsAligned(pages[i]->start(), kOldPageSize));
+    EXPECT_EQ(kOldPageSize, pages[i]->size());
+    char* buf = reinterpret_cast<char*>(pages[i]->address());
+    EXPECT(IsZero(buf, buf + pages[i]->size()));
+    buf[0] = 'a';
+    if (Utils::IsAligned(pages[i]->start(), 2 * MB)) {
+      region_start = pages[i]->start();
+    }
+  }
+  EXPECT(region_start != 0);
+
+  // Freeing one page leaves its neighbors usable.
+  delete pages[0];
+  for (intptr_t i = 1; i < kPagesPerRegion; i++) {
+    EXPECT_EQ('a', *reinterpret_cast<char*>(pages[i]->address()));
+    delete pages[i];
+  }
+
+  // Larger reservations get huge-page-aligned regions of their own.
+  VirtualMemory* big =
+      VirtualMemory::AllocateAligned(4 * MB, kOldPageSize, false, "test");
+  EXPECT(big != NULL);
+  EXPECT(Utils::IsAligned(big->start(), 2 * MB));
+  delete big;
+
+  FLAG_heap_huge_pages = saved_huge_pages;
+}
+#endif  // defined(HOST_OS_LINUX)
+
 VM_UNIT_TEST_CASE(FreeVirtualMemory) {
   // Reservations should always be handed back to OS upon destruction.
   const intptr_t kVirtualMemoryBlockSize = 10 * MB;
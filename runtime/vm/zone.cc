@@ -56,6 +56,9 @@ static constexpr intptr_t kSegmentCacheCapacity = 16;  // 1 MB of Segments
 static Mutex* segment_cache_mutex = nullptr;
 static VirtualMemory* segment_cache[kSegmentCacheCapacity] = {nullptr};
 static intptr_t segment_cache_size = 0;
+// The smallest size of the cache since it was last trimmed. Segments below
+// this mark were not needed in the meantime.
+static intptr_t segment_cache_low_water_mark = 0;
 
 void Zone::Init() {
   ASSERT(segment_cache_mutex == nullptr);
@@ -70,11 +73,36 @@ void Zone::Cleanup() {
     while (segment_cache_size > 0) {
       delete segment_cache[--segment_cache_size];
     }
+    segment_cache_low_water_mark = 0;
   }
   delete segment_cache_mutex;
   segment_cache_mutex = nullptr;
 }
 
+void Zone::TrimSegmentCache(bool release_all) {
+  if (segment_cache_mutex == nullptr) return;
+  MutexLocker ml(segment_cache_mutex);
+  ASSERT(segment_cache_low_water_mark <= segment_cache_size);
+  intptr_t num_to_release =
+      release_all ? segment_cache_size : segment_cache_low_water_mark;
+  // Release the least recently cached segments, which are the least likely
+  // to still have warm pages.
+  for (intptr_t i = 0; i < num_to_release; i++) {
+    total_size_.fetch_sub(segment_cache[i]->size());
+    delete segment_cache[i];
+  }
+  segment_cache_size -= num_to_release;
+  for (intptr_t i = 0; i < segment_cache_size; i++) {
+    segment_cache[i] = segment_cache[i + num_to_release];
+  }
+  segment_cache_low_water_mark = segment_cache_size;
+}
+
+intptr_t Zone::CachedSegmentsSize() {
+  MutexLocker ml(segment_cache_mutex);
+  return segment_cache_size * kSegmentSize;
+}
+
 Zone::Segment* Zone::Segment::New(intptr_t size, Zone::Segment* next) {
   size = Utils::RoundUp(size, VirtualMemory::PageSize());
   VirtualMemory* memory = nullptr;
@@ -84,6 +112,8 @@ Zone::Segment* Zone::Segment::New(intptr_t size, Zone::Segment* next) {
     ASSERT(segment_cache_size <= kSegmentCacheCapacity);
     if (segment_cache_size > 0) {
       memory = segment_cache[--segment_cache_size];
+      segment_cache_low_water_mark =
+          Utils::Minimum(segment_cache_low_water_mark, segment_cache_size);
     }
   }
   if (memory == nullptr) {
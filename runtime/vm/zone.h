@@ -90,6 +90,15 @@ class Zone {
 
   static intptr_t Size() { return total_size_; }
 
+  // Returns cached segments to the OS. Unless [release_all] is set, only the
+  // segments that stayed in the cache since the previous trim are released,
+  // so a cache that is in steady use keeps its segments.
+  static void TrimSegmentCache(bool release_all = false);
+
+  // The size of the segments cached for reuse by new zones, which is
+  // included in Size().
+  static intptr_t CachedSegmentsSize();
+
  private:
   Zone();
   ~Zone();  // Delete all memory associated with the zone.
@@ -279,6 +288,20 @@ inline ElementType* Zone::Realloc(ElementType* old_data,
   return new_data;
 }
 
+inline uword VMHandles::AllocateHandle(Zone* zone) {
+#if defined(DEBUG)
+  VerifyAllocateHandle(zone);
+#endif
+  return zone->handles()->AllocateScopedHandle();
+}
+
+inline uword VMHandles::AllocateZoneHandle(Zone* zone) {
+#if defined(DEBUG)
+  VerifyAllocateZoneHandle(zone);
+#endif
+  return zone->handles()->AllocateHandleInZone();
+}
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_ZONE_H_
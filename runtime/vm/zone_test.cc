@@ -223,6 +223,31 @@ TEST_CASE(StressMallocDirectly) {
 #endif  // !defined(PRODUCT)
 }
 
+ISOLATE_UNIT_TEST_CASE(ZoneSegmentCacheTrim) {
+  const intptr_t kSegmentSize = 64 * KB;
+  Zone::TrimSegmentCache(/*release_all=*/true);
+  EXPECT_EQ(0, Zone::CachedSegmentsSize());
+
+  {
+    StackZone stack_zone(Thread::Current());
+    Zone* zone = stack_zone.GetZone();
+    for (intptr_t i = 0; i < 8; i++) {
+      zone->Alloc<uint8_t>(kSegmentSize / 2);
+    }
+  }
+  // The segments of the deleted zone are kept for reuse.
+  EXPECT_LE(4 * kSegmentSize, Zone::CachedSegmentsSize());
+
+  // The cache was empty at some point since the previous trim, so every
+  // cached segment was needed in the meantime...
+  Zone::TrimSegmentCache();
+  EXPECT_LE(4 * kSegmentSize, Zone::CachedSegmentsSize());
+
+  // ...but nothing used the cache before this trim.
+  Zone::TrimSegmentCache();
+  EXPECT_EQ(0, Zone::CachedSegmentsSize());
+}
+
 ISOLATE_UNIT_TEST_CASE(StressMallocThroughZones) {
 #if !defined(PRODUCT)
   int64_t start_rss = Service::CurrentRSS();
@@ -648,6 +648,7 @@ class _HttpParser extends Stream<_HttpIncoming> {
               throw HttpException("Invalid header field name, with $byte");
             }
             _addWithValidation(_headerField, _toLowerCaseByte(byte));
+            _addHeaderFieldRun();
           }
           break;
 
@@ -659,6 +660,7 @@ class _HttpParser extends Stream<_HttpIncoming> {
           } else if (byte != _CharCode.SP && byte != _CharCode.HT) {
             // Start of new header value.
             _addWithValidation(_headerValue, byte);
+            _addHeaderValueRun();
             _state = _State.HEADER_VALUE;
           }
           break;
@@ -670,6 +672,7 @@ class _HttpParser extends Stream<_HttpIncoming> {
             _state = _State.HEADER_VALUE_FOLD_OR_END;
           } else {
             _addWithValidation(_headerValue, byte);
+            _addHeaderValueRun();
           }
           break;
 
@@ -1045,6 +1048,41 @@ class _HttpParser extends Stream<_HttpIncoming> {
     }
   }
 
+  // Consumes the token characters following the current one in the buffer
+  // into the header field, so that a field name costs one trip around the
+  // parser loop rather than one per byte.
+  void _addHeaderFieldRun() {
+    final buffer = _buffer!;
+    int index = _index;
+    while (index < buffer.length) {
+      int byte = buffer[index];
+      if (!_isTokenChar(byte)) break;
+      _addWithValidation(_headerField, _toLowerCaseByte(byte));
+      index++;
+    }
+    _index = index;
+  }
+
+  // Consumes the bytes up to the next CR or LF in the buffer into the header
+  // value, copying them in one go.
+  void _addHeaderValueRun() {
+    final buffer = _buffer!;
+    final int start = _index;
+    int index = start;
+    while (index < buffer.length) {
+      int byte = buffer[index];
+      if (byte == _CharCode.CR || byte == _CharCode.LF) break;
+      index++;
+    }
+    if (index == start) return;
+    _headersReceivedSize += index - start;
+    if (_headersReceivedSize >= _headerTotalSizeLimit) {
+      _reportSizeLimitError();
+    }
+    _headerValue.addAll(Uint8List.sublistView(buffer, start, index));
+    _index = index;
+  }
+
   void _reportSizeLimitError() {
     String method = "";
     switch (_state) {
@@ -8,36 +8,52 @@ class _IOServicePorts {
   // We limit the number of IO Service ports per isolate so that we don't
   // spawn too many threads all at once, which can crash the VM on Windows.
   static const int maxPorts = 32;
-  List<SendPort> _ports = <SendPort>[];
-  List<SendPort> _freePorts = <SendPort>[];
-  Map<int, SendPort> _usedPorts = new HashMap<int, SendPort>();
+  // Host lookups can block for seconds, so they get a smaller pool of their
+  // own rather than queueing file and directory requests behind them.
+  static const int maxLookupPorts = 8;
 
-  _IOServicePorts();
+  final int _maxPorts;
+  final List<SendPort> _ports = <SendPort>[];
+  // The number of requests in flight on each port in [_ports].
+  final List<int> _pending = <int>[];
+  // Indices of the ports with no requests in flight.
+  final List<int> _freePorts = <int>[];
+  // Maps each request in flight to the index of its port.
+  final Map<int, int> _usedPorts = new HashMap<int, int>();
+
+  _IOServicePorts(this._maxPorts);
 
   SendPort _getPort(int forRequestId) {
-    if (_freePorts.isEmpty && _usedPorts.length < maxPorts) {
-      final SendPort port = _newServicePort();
-      _ports.add(port);
-      _freePorts.add(port);
-    }
-    if (!_freePorts.isEmpty) {
-      final SendPort port = _freePorts.removeLast();
-      assert(!_usedPorts.containsKey(forRequestId));
-      _usedPorts[forRequestId] = port;
-      return port;
+    assert(!_usedPorts.containsKey(forRequestId));
+    int index;
+    if (_freePorts.isNotEmpty) {
+      index = _freePorts.removeLast();
+    } else if (_ports.length < _maxPorts) {
+      index = _ports.length;
+      _ports.add(_newServicePort());
+      _pending.add(0);
+    } else {
+      // We have already allocated the max number of ports. Re-use the one
+      // with the fewest requests in flight, so a slow request delays as few
+      // others as possible.
+      index = 0;
+      for (int i = 1; i < _pending.length; i++) {
+        if (_pending[i] < _pending[index]) index = i;
+      }
     }
-    // We have already allocated the max number of ports. Re-use an
-    // existing one.
-    final SendPort port = _ports[forRequestId % maxPorts];
-    _usedPorts[forRequestId] = port;
-    return port;
+    _pending[index]++;
+    _usedPorts[forRequestId] = index;
+    return _ports[index];
   }
 
-  void _returnPort(int forRequestId) {
-    final SendPort port = _usedPorts.remove(forRequestId)!;
-    if (!_usedPorts.values.contains(port)) {
-      _freePorts.add(port);
+  // Returns false if the request was not dispatched through these ports.
+  bool _returnPort(int forRequestId) {
+    final int? index = _usedPorts.remove(forRequestId);
+    if (index == null) return false;
+    if (--_pending[index] == 0) {
+      _freePorts.add(index);
     }
+    return true;
   }
 
   static SendPort _newServicePort() native "IOService_NewServicePort";
@@ -45,7 +61,10 @@ class _IOServicePorts {
 
 @patch
 class _IOService {
-  static _IOServicePorts _servicePorts = new _IOServicePorts();
+  static _IOServicePorts _servicePorts =
+      new _IOServicePorts(_IOServicePorts.maxPorts);
+  static _IOServicePorts _lookupPorts =
+      new _IOServicePorts(_IOServicePorts.maxLookupPorts);
   static RawReceivePort? _receivePort;
   static late SendPort _replyToPort;
   static HashMap<int, Completer> _messageMap = new HashMap<int, Completer>();
@@ -57,7 +76,8 @@ class _IOService {
     do {
       id = _getNextId();
     } while (_messageMap.containsKey(id));
-    final SendPort servicePort = _servicePorts._getPort(id);
+    final _IOServicePorts ports = _portsFor(request);
+    final SendPort servicePort = ports._getPort(id);
     _ensureInitialize();
     final Completer completer = new Completer();
     _messageMap[id] = completer;
@@ -65,6 +85,7 @@ class _IOService {
       servicePort.send(<dynamic>[id, _replyToPort, request, data]);
     } catch (error) {
       _messageMap.remove(id)!.complete(error);
+      ports._returnPort(id);
       if (_messageMap.length == 0) {
         _finalize();
       }
@@ -72,6 +93,17 @@ class _IOService {
     return completer.future;
   }
 
+  static _IOServicePorts _portsFor(int request) {
+    switch (request) {
+      case _IOService.socketLookup:
+      case _IOService.socketListInterfaces:
+      case _IOService.socketReverseLookup:
+        return _lookupPorts;
+      default:
+        return _servicePorts;
+    }
+  }
+
   static void _ensureInitialize() {
     if (_receivePort == null) {
       _receivePort = new RawReceivePort(null, 'IO Service');
@@ -79,7 +111,9 @@ class _IOService {
       _receivePort!.handler = (data) {
         assert(data is List && data.length == 2);
         _messageMap.remove(data[0])!.complete(data[1]);
-        _servicePorts._returnPort(data[0]);
+        if (!_lookupPorts._returnPort(data[0])) {
+          _servicePorts._returnPort(data[0]);
+        }
         if (_messageMap.length == 0) {
           _finalize();
         }
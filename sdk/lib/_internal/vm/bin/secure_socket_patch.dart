@@ -68,12 +68,14 @@ class _SecureSocket extends _Socket implements SecureSocket {
 class _SecureFilterImpl extends NativeFieldWrapperClass1
     implements _SecureFilter {
   // Performance is improved if a full buffer of plaintext fits
-  // in the encrypted buffer, when encrypted.
+  // in the encrypted buffer, when encrypted. SIZE is the largest TLS record
+  // payload, so each write produces one full record, and ENCRYPTED_SIZE
+  // holds such a record with its overhead.
   // SIZE and ENCRYPTED_SIZE are referenced from C++.
   @pragma("vm:entry-point")
-  static final int SIZE = 8 * 1024;
+  static final int SIZE = 16 * 1024;
   @pragma("vm:entry-point")
-  static final int ENCRYPTED_SIZE = 10 * 1024;
+  static final int ENCRYPTED_SIZE = 17 * 1024;
 
   _SecureFilterImpl._() {
     buffers = <_ExternalBuffer>[
@@ -111,6 +113,12 @@ class _SecureFilterImpl extends NativeFieldWrapperClass1
 
     ReceivePort rpEvaluateResponse = ReceivePort();
     rpEvaluateResponse.listen((data) {
+      if (data == null) {
+        // A private key operation finished on the thread pool.
+        evaluatorCompleter.complete(true);
+        rpEvaluateResponse.close();
+        return;
+      }
       List list = data as List;
       // incoming messages (bool isTrusted, int certificatePtr) is
       // sent by TrustEvaluator native port after system evaluates
@@ -138,6 +146,7 @@ class _SecureFilterImpl extends NativeFieldWrapperClass1
     });
 
     const int kSslErrorWantCertificateVerify = 16; // ssl.h:558
+    const int kSslErrorWantPrivateKeyOperation = 13; // ssl.h
     int handshakeResult;
     try {
       handshakeResult = _handshake(rpEvaluateResponse.sendPort);
@@ -145,7 +154,8 @@ class _SecureFilterImpl extends NativeFieldWrapperClass1
       rpEvaluateResponse.close();
       rethrow;
     }
-    if (handshakeResult == kSslErrorWantCertificateVerify) {
+    if (handshakeResult == kSslErrorWantCertificateVerify ||
+        handshakeResult == kSslErrorWantPrivateKeyOperation) {
       return evaluatorCompleter.future;
     } else {
       // Response is ready, no need for evaluate response receive port
@@ -440,6 +440,10 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   static const int normalTokenBatchSize = 8;
   static const int listeningTokenBatchSize = 2;
 
+  // The maximum number of connections accepted by one call to acceptBatch.
+  static const int acceptBatchSize = 16;
+  static List<int>? _acceptedFds;
+
   static const Duration _retryDuration = const Duration(milliseconds: 250);
   static const Duration _retryDurationLoopback =
       const Duration(milliseconds: 25);
@@ -877,6 +881,23 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   String get _serviceTypePath => throw new UnimplementedError();
   String get _serviceTypeName => throw new UnimplementedError();
 
+  // Reads of up to this many bytes go through a shared scratch buffer and are
+  // copied into a right-sized list, instead of allocating an external list
+  // with a finalizer per read.
+  static const int _readBufferSize = 64 * 1024;
+  static Uint8List? _readBuffer;
+
+  static Uint8List get _scratchReadBuffer =>
+      _readBuffer ??= new Uint8List(_readBufferSize);
+
+  Uint8List? _readList(int count) {
+    if (count > _readBufferSize) return nativeRead(count);
+    final buffer = _scratchReadBuffer;
+    final bytesRead = nativeReadInto(buffer, 0, count);
+    if (bytesRead == 0) return null;
+    return buffer.sublist(0, bytesRead);
+  }
+
   Uint8List? read(int? count) {
     if (count != null && count <= 0) {
       throw ArgumentError("Illegal length $count");
@@ -885,20 +906,22 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     try {
       Uint8List? list;
       if (count != null) {
-        list = nativeRead(count);
+        list = _readList(count);
         available = nativeAvailable();
       } else {
         // If count is null, read as many bytes as possible.
         // Loop here to ensure bytes that arrived while this read was
         // issued are also read.
         BytesBuilder builder = BytesBuilder();
+        final buffer = _scratchReadBuffer;
         do {
           assert(available > 0);
-          list = nativeRead(available);
-          if (list == null) {
+          final bytesRead = nativeReadInto(
+              buffer, 0, available < buffer.length ? available : buffer.length);
+          if (bytesRead == 0) {
             break;
           }
-          builder.add(list);
+          builder.add(new Uint8List.view(buffer.buffer, 0, bytesRead));
           available = nativeAvailable();
         } while (available > 0);
         if (builder.isEmpty) {
@@ -979,6 +1002,74 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     }
   }
 
+  // The maximum number of buffers passed to a single writeVector call. Must
+  // match SocketBase::kMaxWriteChunks.
+  static const int maxWriteVectorLength = 16;
+
+  // Writes as much as possible of [buffers], starting at [offset] in the
+  // first buffer, with a single system call. Returns the number of bytes
+  // written, which may end in the middle of any of the buffers.
+  int writeVector(List<List<int>> buffers, int offset) {
+    assert(buffers.isNotEmpty && buffers.length <= maxWriteVectorLength);
+    if (isClosing || isClosed) return 0;
+    try {
+      final chunks = <List<int>>[];
+      final starts = <int>[];
+      final ends = <int>[];
+      int bytes = 0;
+      for (int i = 0; i < buffers.length; i++) {
+        final buffer = buffers[i];
+        final start = (i == 0) ? offset : 0;
+        final length = buffer.length - start;
+        if (length == 0) continue;
+        _BufferAndStart bufferAndStart =
+            _ensureFastAndSerializableByteData(buffer, start, buffer.length);
+        chunks.add(bufferAndStart.buffer);
+        starts.add(bufferAndStart.start);
+        ends.add(bufferAndStart.start + length);
+        bytes += length;
+      }
+      if (bytes == 0) return 0;
+      if (!const bool.fromEnvironment("dart.vm.product")) {
+        _SocketProfile.collectStatistic(
+            nativeGetSocketId(), _SocketProfileType.writeBytes, bytes);
+      }
+      int result = nativeWriteVector(chunks, starts, ends);
+      // As for write, a negative result is a forced short write.
+      if (result >= 0 && result < bytes) {
+        writeAvailable = false;
+      }
+      if (result < 0) result = -result;
+      return result;
+    } catch (e) {
+      StackTrace st = StackTrace.current;
+      scheduleMicrotask(() => reportError(e, st, "Write failed"));
+      return 0;
+    }
+  }
+
+  // Sends up to [bytes] bytes of [file], starting at [offset], without
+  // copying them through Dart. Returns the number of bytes sent, which is 0
+  // if the socket is not writable.
+  int sendFile(_RandomAccessFile file, int offset, int bytes) {
+    if (isClosing || isClosed) return 0;
+    try {
+      int result = nativeSendFile(file._pointer(), offset, bytes);
+      if (result < bytes) {
+        writeAvailable = false;
+      }
+      if (!const bool.fromEnvironment("dart.vm.product")) {
+        _SocketProfile.collectStatistic(
+            nativeGetSocketId(), _SocketProfileType.writeBytes, result);
+      }
+      return result;
+    } catch (e) {
+      StackTrace st = StackTrace.current;
+      scheduleMicrotask(() => reportError(e, st, "Write failed"));
+      return 0;
+    }
+  }
+
   int send(List<int> buffer, int offset, int bytes, InternetAddress address,
       int port) {
     _throwOnBadPort(port);
@@ -1002,17 +1093,27 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     }
   }
 
-  _NativeSocket? accept() {
+  // Accepts the connections pending on a listening socket, up to
+  // [acceptBatchSize], in a single native call. All read events received so
+  // far are consumed, as one call can accept the connections of several.
+  List<_NativeSocket> acceptBatch() {
     // Don't issue accept if we're closing.
-    if (isClosing || isClosed) return null;
-    assert(connections > 0);
-    connections--;
-    tokens++;
-    returnTokens(listeningTokenBatchSize);
-    var socket = new _NativeSocket.normal(address);
-    if (nativeAccept(socket) != true) return null;
-    socket.localPort = localPort;
-    return socket;
+    if (isClosing || isClosed) return const <_NativeSocket>[];
+    while (connections > 0) {
+      connections--;
+      tokens++;
+      returnTokens(listeningTokenBatchSize);
+    }
+    var fds = _acceptedFds ??= new List<int>.filled(acceptBatchSize, 0);
+    int count = nativeAcceptBatch(fds);
+    var sockets = <_NativeSocket>[];
+    for (int i = 0; i < count; i++) {
+      var socket = new _NativeSocket.normal(address);
+      socket.nativeSetSocketId(fds[i], socket.typeFlags);
+      socket.localPort = localPort;
+      sockets.add(socket);
+    }
+    return sockets;
   }
 
   int get port {
@@ -1382,9 +1483,15 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   int nativeAvailable() native "Socket_Available";
   bool nativeAvailableDatagram() native "Socket_AvailableDatagram";
   Uint8List? nativeRead(int len) native "Socket_Read";
+  int nativeReadInto(Uint8List buffer, int offset, int len)
+      native "Socket_ReadInto";
   Datagram? nativeRecvFrom() native "Socket_RecvFrom";
   int nativeWrite(List<int> buffer, int offset, int bytes)
       native "Socket_WriteList";
+  int nativeWriteVector(List<List<int>> buffers, List<int> starts,
+      List<int> ends) native "Socket_WriteVector";
+  int nativeSendFile(int filePointer, int offset, int bytes)
+      native "Socket_SendFile";
   int nativeSendTo(List<int> buffer, int offset, int bytes, Uint8List address,
       int port) native "Socket_SendTo";
   nativeCreateConnect(Uint8List addr, int port, int scope_id)
@@ -1402,7 +1509,7 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
       _Namespace namespace) native "ServerSocket_CreateUnixDomainBindListen";
   nativeCreateBindDatagram(Uint8List addr, int port, bool reuseAddress,
       bool reusePort, int ttl) native "Socket_CreateBindDatagram";
-  bool nativeAccept(_NativeSocket socket) native "ServerSocket_Accept";
+  int nativeAcceptBatch(List<int> fds) native "ServerSocket_AcceptBatch";
   int nativeGetPort() native "Socket_GetPort";
   List nativeGetRemotePeer() native "Socket_GetRemotePeer";
   int nativeGetSocketId() native "Socket_GetSocketId";
@@ -1449,15 +1556,14 @@ class _RawServerSocket extends Stream<RawSocket> implements RawServerSocket {
         onResume: _onPauseStateChange);
     _socket.setHandlers(
         read: zone.bindCallbackGuarded(() {
-          while (_socket.connections > 0) {
-            var socket = _socket.accept();
-            if (socket == null) return;
+          if (_socket.connections == 0) return;
+          // Sockets accepted after a pause are buffered by the controller.
+          for (var socket in _socket.acceptBatch()) {
             if (!const bool.fromEnvironment("dart.vm.product")) {
               _SocketProfile.collectNewSocket(socket.nativeGetSocketId(),
                   _tcpSocket, socket.address, socket.port);
             }
             controller.add(_RawSocket(socket));
-            if (controller.isPaused) return;
           }
         }),
         error: zone.bindBinaryCallbackGuarded((Object e, StackTrace? st) {
@@ -1616,6 +1722,12 @@ class _RawSocket extends Stream<RawSocketEvent> implements RawSocket {
   int write(List<int> buffer, [int offset = 0, int? count]) =>
       _socket.write(buffer, offset, count);
 
+  int _writeVector(List<List<int>> buffers, int offset) =>
+      _socket.writeVector(buffers, offset);
+
+  int _sendFile(_RandomAccessFile file, int offset, int bytes) =>
+      _socket.sendFile(file, offset, bytes);
+
   Future<RawSocket> close() => _socket.close().then<RawSocket>((_) {
         if (!const bool.fromEnvironment("dart.vm.product")) {
           _SocketProfile.collectStatistic(
@@ -1752,9 +1864,19 @@ class Socket {
 class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   StreamSubscription? subscription;
   final _Socket socket;
-  int? offset;
-  List<int>? buffer;
+  // Buffers not yet completely written, and the offset into the first one.
+  // While waiting for the socket to become writable further buffers are
+  // queued, up to maxWriteVectorLength, so they can go out in one write.
+  final buffers = <List<int>>[];
+  int offset = 0;
   bool paused = false;
+  // Whether the stream is done but queued buffers are still being written.
+  bool doneWhenWritten = false;
+  // A file being sent with sendfile instead of listening to its stream, and
+  // the range of it still to send.
+  _RandomAccessFile? file;
+  int filePosition = 0;
+  int fileEnd = 0;
   Completer<Socket>? streamCompleter;
 
   _SocketStreamConsumer(this.socket);
@@ -1762,12 +1884,21 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   Future<Socket> addStream(Stream<List<int>> stream) {
     socket._ensureRawSocketSubscription();
     final completer = streamCompleter = new Completer<Socket>();
-    if (socket._raw != null) {
+    if (socket._raw is _RawSocket &&
+        stream is _FileStream &&
+        stream._path != null &&
+        buffers.isEmpty &&
+        (Platform.isLinux || Platform.isAndroid || Platform.isMacOS)) {
+      _sendFile(stream);
+    } else if (socket._raw != null) {
       subscription = stream.listen((data) {
         assert(!paused);
-        assert(buffer == null);
-        buffer = data;
-        offset = 0;
+        buffers.add(data);
+        if (buffers.length > 1) {
+          // Already waiting for a write event.
+          _pauseIfFull();
+          return;
+        }
         try {
           write();
         } catch (e) {
@@ -1779,7 +1910,11 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
         socket.destroy();
         done(error, stackTrace);
       }, onDone: () {
-        done();
+        if (buffers.isEmpty) {
+          done();
+        } else {
+          doneWhenWritten = true;
+        }
       }, cancelOnError: true);
     }
     return completer.future;
@@ -1790,28 +1925,91 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
     return new Future.value(socket);
   }
 
+  // Sends the file of [stream] straight from the file to the socket,
+  // without reading it into Dart.
+  void _sendFile(_FileStream stream) {
+    new File(stream._path!).open().then((opened) {
+      final openedFile = opened as _RandomAccessFile;
+      return openedFile.length().then((length) {
+        if (streamCompleter == null) {
+          // Stopped while opening the file.
+          openedFile.close();
+          return;
+        }
+        final end = stream._end;
+        file = openedFile;
+        filePosition = stream._position;
+        fileEnd = (end == null || end > length) ? length : end;
+        write();
+      });
+    }).catchError((error, stackTrace) {
+      done(error, stackTrace);
+    });
+  }
+
+  void _writeFile() {
+    final sendingFile = file!;
+    while (filePosition < fileEnd) {
+      final sent =
+          socket._sendFile(sendingFile, filePosition, fileEnd - filePosition);
+      if (sent == 0) {
+        // Nothing is sent both when the socket is full and when the file was
+        // truncated after it was opened.
+        if (sendingFile.lengthSync() <= filePosition) break;
+        socket._enableWriteEvent();
+        return;
+      }
+      filePosition += sent;
+    }
+    done();
+  }
+
   void write() {
+    if (file != null) {
+      _writeFile();
+      return;
+    }
     final sub = subscription;
     if (sub == null) return;
+    if (buffers.isEmpty) return;
     // Write as much as possible.
-    offset =
-        offset! + socket._write(buffer!, offset!, buffer!.length - offset!);
-    if (offset! < buffer!.length) {
-      if (!paused) {
-        paused = true;
-        sub.pause();
-      }
+    offset += socket._writeVector(buffers, offset);
+    while (buffers.isNotEmpty && offset >= buffers.first.length) {
+      offset -= buffers.first.length;
+      buffers.removeAt(0);
+    }
+    if (buffers.isNotEmpty) {
+      _pauseIfFull();
       socket._enableWriteEvent();
     } else {
-      buffer = null;
       if (paused) {
         paused = false;
         sub.resume();
       }
+      if (doneWhenWritten) {
+        doneWhenWritten = false;
+        done();
+      }
+    }
+  }
+
+  void _pauseIfFull() {
+    if (!paused && buffers.length >= _NativeSocket.maxWriteVectorLength) {
+      paused = true;
+      subscription!.pause();
+    }
+  }
+
+  void _closeFile() {
+    final sendingFile = file;
+    if (sendingFile != null) {
+      file = null;
+      sendingFile.close();
     }
   }
 
   void done([error, stackTrace]) {
+    _closeFile();
     final completer = streamCompleter;
     if (completer != null) {
       if (error != null) {
@@ -1824,6 +2022,7 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   }
 
   void stop() {
+    _closeFile();
     final sub = subscription;
     if (sub == null) return;
     sub.cancel();
@@ -1965,7 +2164,7 @@ class _Socket extends Stream<Uint8List> implements Socket {
     _detachReady = new Completer();
     _sink.close();
     return _detachReady.future.then((_) {
-      assert(_consumer.buffer == null);
+      assert(_consumer.buffers.isEmpty);
       var raw = _raw;
       _raw = null;
       return [raw, _subscription];
@@ -2044,14 +2243,28 @@ class _Socket extends Stream<Uint8List> implements Socket {
     _consumer.done(error, stackTrace);
   }
 
-  int _write(List<int> data, int offset, int length) {
+  int _sendFile(_RandomAccessFile file, int offset, int bytes) {
     final raw = _raw;
-    if (raw != null) {
-      return raw.write(data, offset, length);
-    }
+    if (raw is _RawSocket) return raw._sendFile(file, offset, bytes);
     return 0;
   }
 
+  int _writeVector(List<List<int>> buffers, int offset) {
+    final raw = _raw;
+    if (raw == null) return 0;
+    if (raw is _RawSocket) return raw._writeVector(buffers, offset);
+    // Other raw sockets, e.g. secure sockets, write one buffer at a time.
+    int written = 0;
+    for (final buffer in buffers) {
+      final length = buffer.length - offset;
+      final result = raw.write(buffer, offset, length);
+      written += result;
+      if (result < length) break;
+      offset = 0;
+    }
+    return written;
+  }
+
   void _enableWriteEvent() {
     _raw?.writeEventsEnabled = true;
   }
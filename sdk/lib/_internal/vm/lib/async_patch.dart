@@ -55,15 +55,22 @@ dynamic Function(Object, StackTrace) _asyncErrorWrapperHelper(
 ///
 /// If [object] is not a future, then it is wrapped into one.
 ///
-/// Returns the result of registering with `.then`.
-Future _awaitHelper(var object, dynamic Function(dynamic) thenCallback,
+/// Returns the result of registering with `.then`, or null if [object] is not
+/// a future.
+Future? _awaitHelper(var object, dynamic Function(dynamic) thenCallback,
     dynamic Function(dynamic, StackTrace) errorCallback, Function awaiter) {
-  late _Future future;
   if (object is! Future) {
-    future = new _Future().._setValue(object);
-  } else if (object is _Future) {
-    future = object;
-  } else {
+    // Awaiting a value only has to resume the continuation in a later
+    // microtask. Scheduling it directly avoids allocating a completed
+    // `_Future` for the value, its listener and the listener's result future,
+    // while the zone sees the same `scheduleMicrotask` and `runUnary` calls.
+    final zone = Zone._current;
+    zone.scheduleMicrotask(() {
+      zone.runUnary(thenCallback, object);
+    });
+    return null;
+  }
+  if (object is! _Future) {
     return object.then(thenCallback, onError: errorCallback);
   }
   // `object` is a `_Future`.
@@ -74,7 +81,7 @@ Future _awaitHelper(var object, dynamic Function(dynamic) thenCallback,
   //
   // We can only do this for our internal futures (the default implementation of
   // all futures that are constructed by the `dart:async` library).
-  return future._thenAwait<dynamic>(thenCallback, errorCallback);
+  return object._thenAwait<dynamic>(thenCallback, errorCallback);
 }
 
 @pragma("vm:entry-point", "call")
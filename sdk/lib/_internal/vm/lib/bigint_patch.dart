@@ -106,6 +106,14 @@ class _BigIntImpl implements BigInt {
   static final bool _isIntrinsified =
       new bool.fromEnvironment('dart.vm.not.a.compile.time.constant');
 
+  /// Products of operands that both have at least this many digits are
+  /// computed by [_mulLarge], which is sub-quadratic.
+  static const int _karatsubaThreshold = 64;
+
+  /// Decimal strings longer than this are parsed by splitting them in halves,
+  /// which makes parsing as fast as multiplying the halves.
+  static const int _parseDecimalThreshold = 2000;
+
   // Result cache for last _divRem call.
   static Uint32List? _lastDividendDigits;
   static int? _lastDividendUsed;
@@ -177,6 +185,36 @@ class _BigIntImpl implements BigInt {
   ///
   /// The [source] must not contain leading or trailing whitespace.
   static _BigIntImpl _parseDecimal(String source, bool isNegative) {
+    final result = _parseDecimalRange(source, 0, source.length);
+    if (isNegative) return -result;
+    return result;
+  }
+
+  /// `_decimalPowers[k]` is `10^(9 * 2^k)`.
+  static final List<_BigIntImpl> _decimalPowers = <_BigIntImpl>[_oneBillion];
+
+  /// Parses the decimal digits of [source] from [start] to [end].
+  ///
+  /// Long ranges are split so that the low part has `9 * 2^k` digits, and
+  /// the high part is multiplied by the cached `10^(9 * 2^k)`. With
+  /// sub-quadratic multiplication, this is faster than adding in one
+  /// 9-digit part at a time, which takes quadratic time.
+  static _BigIntImpl _parseDecimalRange(String source, int start, int end) {
+    final length = end - start;
+    if (length > _parseDecimalThreshold) {
+      var k = 0;
+      while (9 << (k + 1) < length) {
+        k++;
+      }
+      while (_decimalPowers.length <= k) {
+        final power = _decimalPowers[_decimalPowers.length - 1];
+        _decimalPowers.add(power * power);
+      }
+      final split = end - (9 << k);
+      return _parseDecimalRange(source, start, split) * _decimalPowers[k] +
+          _parseDecimalRange(source, split, end);
+    }
+
     const _0 = 48;
 
     int part = 0;
@@ -184,9 +222,9 @@ class _BigIntImpl implements BigInt {
     // Read in the source 9 digits at a time.
     // The first part may have a few leading virtual '0's to make the remaining
     // parts all have exactly 9 digits.
-    int digitInPartCount = 9 - unsafeCast<int>(source.length.remainder(9));
+    int digitInPartCount = 9 - unsafeCast<int>(length.remainder(9));
     if (digitInPartCount == 9) digitInPartCount = 0;
-    for (int i = 0; i < source.length; i++) {
+    for (int i = start; i < end; i++) {
       part = part * 10 + source.codeUnitAt(i) - _0;
       if (++digitInPartCount == 9) {
         result = result * _oneBillion + new _BigIntImpl._fromInt(part);
@@ -194,7 +232,6 @@ class _BigIntImpl implements BigInt {
         digitInPartCount = 0;
       }
     }
-    if (isNegative) return -result;
     return result;
   }
 
@@ -1227,9 +1264,13 @@ class _BigIntImpl implements BigInt {
     var digits = _digits;
     var otherDigits = other._digits;
     var resultDigits = _newDigits(resultUsed);
-    var i = 0;
-    while (i < otherUsed) {
-      i += _mulAdd(otherDigits, i, digits, 0, resultDigits, i, used);
+    if (used >= _karatsubaThreshold && otherUsed >= _karatsubaThreshold) {
+      _mulLarge(digits, used, otherDigits, otherUsed, resultDigits);
+    } else {
+      var i = 0;
+      while (i < otherUsed) {
+        i += _mulAdd(otherDigits, i, digits, 0, resultDigits, i, used);
+      }
     }
     return new _BigIntImpl._(
         _isNegative != other._isNegative, resultUsed, resultDigits);
@@ -1246,6 +1287,10 @@ class _BigIntImpl implements BigInt {
     while (--i >= 0) {
       resultDigits[i] = 0;
     }
+    if (xUsed >= _karatsubaThreshold && otherUsed >= _karatsubaThreshold) {
+      _mulLarge(xDigits, xUsed, otherDigits, otherUsed, resultDigits);
+      return resultUsed;
+    }
     i = 0;
     while (i < otherUsed) {
       i += _mulAdd(otherDigits, i, xDigits, 0, resultDigits, i, xUsed);
@@ -1259,6 +1304,10 @@ class _BigIntImpl implements BigInt {
       Uint32List xDigits, int xUsed, Uint32List resultDigits) {
     var resultUsed = 2 * xUsed;
     assert(resultDigits.length >= resultUsed);
+    if (xUsed >= _karatsubaThreshold) {
+      _mulLarge(xDigits, xUsed, xDigits, xUsed, resultDigits);
+      return resultUsed;
+    }
     // Since resultUsed is even, no need for a leading zero for
     // 64-bit processing.
     var i = resultUsed;
@@ -1276,6 +1325,13 @@ class _BigIntImpl implements BigInt {
     return resultUsed;
   }
 
+  /// `resultDigits[0..xUsed+yUsed-1] =
+  /// xDigits[0..xUsed-1] * yDigits[0..yUsed-1]`, by Karatsuba multiplication.
+  ///
+  /// The result digits must not be the digits of either operand.
+  static void _mulLarge(Uint32List xDigits, int xUsed, Uint32List yDigits,
+      int yUsed, Uint32List resultDigits) native "Bigint_mulLarge";
+
   // Indices of the arguments of _estimateQuotientDigit.
   // For 64-bit processing by intrinsics on 64-bit platforms, the top digit pair
   // of the divisor is provided in the args array, and a 64-bit estimated
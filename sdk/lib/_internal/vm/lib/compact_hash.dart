@@ -129,6 +129,18 @@ abstract class _HashBase implements _HashVMBase {
 
   static int _nextProbe(int i, int sizeMask) => (i + 1) & sizeMask;
 
+  // Returns the index size to use when compacting a table with index size
+  // [size] that holds [numEntries] live entries. The index is halved while
+  // the table would still have room for twice as many entries, so that a
+  // table which shrank after many removals stops paying for its old size on
+  // lookups and iteration.
+  static int _compactedIndexSize(int size, int numEntries) {
+    while (size > _INITIAL_INDEX_SIZE && (numEntries << 3) <= size) {
+      size >>= 1;
+    }
+    return size;
+  }
+
   // A self-loop is used to mark a deleted key or value.
   static bool _isDeleted(List data, Object? keyOrValue) =>
       identical(keyOrValue, data);
@@ -185,15 +197,20 @@ abstract class _LinkedHashMapMixin<K, V> implements _HashBase {
 
   void _rehash() {
     if ((_deletedKeys << 2) > _usedData) {
-      // TODO(koda): Consider shrinking.
       // TODO(koda): Consider in-place compaction and more costly CME check.
-      _init(_index.length, _hashMask, _data, _usedData);
+      _compact();
     } else {
       // TODO(koda): Support 32->64 bit transition (and adjust _hashMask).
       _init(_index.length << 1, _hashMask >> 1, _data, _usedData);
     }
   }
 
+  // Drops the deleted entries, shrinking the table if few entries are left.
+  void _compact() {
+    final int size = _HashBase._compactedIndexSize(_index.length, length);
+    _init(size, _HashBase._indexSizeToHashMask(size), _data, _usedData);
+  }
+
   void clear() {
     if (!isEmpty) {
       _init(_HashBase._INITIAL_INDEX_SIZE, _hashMask, null, 0);
@@ -327,6 +344,14 @@ abstract class _LinkedHashMapMixin<K, V> implements _HashBase {
             V value = _data[d + 1];
             _HashBase._setDeletedAt(_data, d + 1);
             ++_deletedKeys;
+            // Compact once most entries are deleted instead of waiting for
+            // _data to fill up, so the deleted pairs do not lengthen probes.
+            // Each compaction copies fewer entries than were removed since
+            // the previous one.
+            if ((_deletedKeys << 2) > _usedData &&
+                _index.length > _HashBase._INITIAL_INDEX_SIZE) {
+              _compact();
+            }
             return value;
           }
         }
@@ -513,12 +538,18 @@ class _CompactLinkedHashSet<E> extends _HashFieldBase
 
   void _rehash() {
     if ((_deletedKeys << 1) > _usedData) {
-      _init(_index.length, _hashMask, _data, _usedData);
+      _compact();
     } else {
       _init(_index.length << 1, _hashMask >> 1, _data, _usedData);
     }
   }
 
+  // Drops the deleted keys, shrinking the table if few keys are left.
+  void _compact() {
+    final int size = _HashBase._compactedIndexSize(_index.length, length);
+    _init(size, _HashBase._indexSizeToHashMask(size), _data, _usedData);
+  }
+
   void clear() {
     if (!isEmpty) {
       _init(_HashBase._INITIAL_INDEX_SIZE, _hashMask, null, 0);
@@ -621,6 +652,11 @@ class _CompactLinkedHashSet<E> extends _HashFieldBase
           _index[i] = _HashBase._DELETED_PAIR;
           _HashBase._setDeletedAt(_data, d);
           ++_deletedKeys;
+          // See _LinkedHashMapMixin.remove.
+          if ((_deletedKeys << 1) > _usedData &&
+              _index.length > _HashBase._INITIAL_INDEX_SIZE) {
+            _compact();
+          }
           return true;
         }
       }
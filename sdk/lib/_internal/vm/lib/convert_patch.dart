@@ -609,6 +609,57 @@ abstract class _ChunkedJsonParser<T> {
    */
   String getString(int start, int end, int bits);
 
+  /**
+   * Size of [keyCache]. Must be a power of two.
+   */
+  static const int KEY_CACHE_SIZE = 64;
+
+  /**
+   * Property names longer than this are not looked up in [keyCache].
+   */
+  static const int MAX_CACHED_KEY_LENGTH = 32;
+
+  /**
+   * Recently seen property names, indexed by a hash of their characters.
+   *
+   * The objects in a JSON text usually share a small set of property names.
+   * Reusing the string of a name seen before avoids allocating a new one per
+   * object, and its hash code is already computed when it is used as a map
+   * key.
+   */
+  final List<String?> keyCache = new List<String?>.filled(KEY_CACHE_SIZE, null);
+
+  /**
+   * Like [getString], but for a property name, which may be shared with
+   * earlier occurrences of the same name.
+   *
+   * Only ASCII names are cached, for which the characters of the chunk are
+   * the code units of the string.
+   */
+  String getKeyString(int start, int end, int bits) {
+    const int maxAsciiChar = 0x7f;
+    int length = end - start;
+    if (length > MAX_CACHED_KEY_LENGTH || bits > maxAsciiChar) {
+      return getString(start, end, bits);
+    }
+    int hash = length;
+    for (int i = start; i < end; i++) {
+      hash = (hash * 31 + getChar(i)) & 0x3FFFFFFF;
+    }
+    int index = (hash ^ (hash >> 6)) & (KEY_CACHE_SIZE - 1);
+    String? cached = keyCache[index];
+    if (cached != null && cached.length == length) {
+      int i = 0;
+      while (i < length && cached.codeUnitAt(i) == getChar(start + i)) {
+        i++;
+      }
+      if (i == length) return cached;
+    }
+    String key = getString(start, end, bits);
+    keyCache[index] = key;
+    return key;
+  }
+
   /**
    * Parse a slice of the current chunk as a number.
    *
@@ -855,8 +906,10 @@ abstract class _ChunkedJsonParser<T> {
           break;
         case QUOTE:
           if ((state & ALLOW_STRING_MASK) != 0) fail(position);
+          // Only property names are allowed where values are not.
+          bool isKey = (state & ALLOW_VALUE_MASK) != 0;
           state |= VALUE_READ_BITS;
-          position = parseString(position + 1);
+          position = parseString(position + 1, isKey);
           break;
         case LBRACKET:
           if ((state & ALLOW_VALUE_MASK) != 0) fail(position);
@@ -1017,8 +1070,9 @@ abstract class _ChunkedJsonParser<T> {
    *
    * Initial [position] is right after the initial quote.
    * Returned position right after the final quote.
+   * If [isKey], the string is a property name.
    */
-  int parseString(int position) {
+  int parseString(int position, bool isKey) {
     // Format: '"'([^\x00-\x1f\\\"]|'\\'[bfnrt/\\"])*'"'
     // Initial position is right after first '"'.
     int start = position;
@@ -1038,7 +1092,9 @@ abstract class _ChunkedJsonParser<T> {
         return parseStringToBuffer(sliceEnd);
       }
       if (char == QUOTE) {
-        listener.handleString(getString(start, position - 1, bits));
+        listener.handleString(isKey
+            ? getKeyString(start, position - 1, bits)
+            : getString(start, position - 1, bits));
         return position;
       }
       if (char < SPACE) {
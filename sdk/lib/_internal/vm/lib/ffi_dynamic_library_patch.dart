@@ -53,6 +53,7 @@ class DynamicLibrary {
 extension DynamicLibraryExtension on DynamicLibrary {
   @patch
   DS lookupFunction<NS extends Function, DS extends Function>(
-          String symbolName) =>
+          String symbolName,
+          {bool isLeaf: false}) =>
       throw UnsupportedError("The body is inlined in the frontend.");
 }
@@ -25,16 +25,22 @@ class Object {
   // bit). A new hashCode value is calculated using a random number generator.
   static final _hashCodeRnd = new Random();
 
+  // The fast path only reads the hash from the header (or the weak table),
+  // so it is inlined into identity-keyed maps and sets.
+  @pragma("vm:prefer-inline")
   static int _objectHashCode(obj) {
-    var result = _getHash(obj);
-    if (result == 0) {
-      // We want the hash to be a Smi value greater than 0.
+    final result = _getHash(obj);
+    return (result != 0) ? result : _newObjectHashCode(obj);
+  }
+
+  @pragma("vm:never-inline")
+  static int _newObjectHashCode(obj) {
+    // We want the hash to be a Smi value greater than 0.
+    int result;
+    do {
       result = _hashCodeRnd.nextInt(0x40000000);
-      do {
-        result = _hashCodeRnd.nextInt(0x40000000);
-      } while (result == 0);
-      _setHash(obj, result);
-    }
+    } while (result == 0);
+    _setHash(obj, result);
     return result;
   }
 
@@ -9,6 +9,7 @@ class StringBuffer {
   static const int _BUFFER_SIZE = 64;
   static const int _PARTS_TO_COMPACT = 128;
   static const int _PARTS_TO_COMPACT_SIZE_LIMIT = _PARTS_TO_COMPACT * 8;
+  static const int _WRITE_TO_BUFFER_LIMIT = 16;
 
   /**
    * When strings are written to the string buffer, we add them to a
@@ -62,7 +63,25 @@ class StringBuffer {
   @patch
   void write(Object? obj) {
     String str = obj.toString();
-    if (str.isEmpty) return;
+    int length = str.length;
+    if (length == 0) return;
+    if (_bufferPosition > 0 && length <= _WRITE_TO_BUFFER_LIMIT) {
+      // Short strings written between char codes are copied into the
+      // buffer, rather than splitting it into two more small parts.
+      final localBuffer = _buffer!;
+      int position = _bufferPosition;
+      if (position + length <= localBuffer.length) {
+        int magnitude = _bufferCodeUnitMagnitude;
+        for (int i = 0; i < length; i++) {
+          int codeUnit = str.codeUnitAt(i);
+          localBuffer[position++] = codeUnit;
+          magnitude |= codeUnit;
+        }
+        _bufferPosition = position;
+        _bufferCodeUnitMagnitude = magnitude;
+        return;
+      }
+    }
     _consumeBuffer();
     _addPart(str);
   }
@@ -123,8 +142,15 @@ class StringBuffer {
   /** Returns the contents of buffer as a string. */
   @patch
   String toString() {
+    var localParts = _parts;
+    if (_bufferPosition > 0 && localParts != null) {
+      // Copy the buffer straight into the result instead of making it a part
+      // that would be copied again.
+      return _concatPartsAndBuffer(localParts, _buffer!, _bufferPosition,
+          _bufferCodeUnitMagnitude <= 0xFF);
+    }
     _consumeBuffer();
-    final localParts = _parts;
+    localParts = _parts;
     return (_partsCodeUnits == 0 || localParts == null)
         ? ""
         : _StringBase._concatRange(localParts, 0, localParts.length);
@@ -199,4 +225,12 @@ class StringBuffer {
    */
   static String _create(Uint16List buffer, int length, bool isLatin1)
       native "StringBuffer_createStringFromUint16Array";
+
+  /**
+   * Create a [String] from the [parts] followed by the UTF-16 code units in
+   * buffer.
+   */
+  static String _concatPartsAndBuffer(
+      List<String> parts, Uint16List buffer, int length, bool isLatin1)
+      native "StringBuffer_concatPartsAndBuffer";
 }
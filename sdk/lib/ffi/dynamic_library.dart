@@ -45,6 +45,9 @@ class DynamicLibrary {
 /// Methods which cannot be invoked dynamically.
 extension DynamicLibraryExtension on DynamicLibrary {
   /// Helper that combines lookup and cast to a Dart function.
+  ///
+  /// See [NativeFunctionPointer.asFunction] for [isLeaf].
   external F lookupFunction<T extends Function, F extends Function>(
-      String symbolName);
+      String symbolName,
+      {bool isLeaf: false});
 }
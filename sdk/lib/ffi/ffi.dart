@@ -84,7 +84,18 @@ extension NativeFunctionPointer<NF extends Function>
     on Pointer<NativeFunction<NF>> {
   /// Convert to Dart function, automatically marshalling the arguments
   /// and return value.
-  external DF asFunction<@DartRepresentationOf("NF") DF extends Function>();
+  ///
+  /// [isLeaf] specifies whether the function is a leaf function. A leaf
+  /// function must not run Dart code or call back into the Dart VM, and
+  /// should not block. Leaf calls are faster than non-leaf calls, but cannot
+  /// have [Handle] arguments or return values. [isLeaf] must be a constant.
+  ///
+  /// Leaf calls can pass a typed data list, such as a `Uint8List`, where the
+  /// native signature takes a [Pointer] to the matching element type, such as
+  /// `Pointer<Uint8>`. The native function then gets the address of the list's
+  /// elements without a copy. The address is only valid during the call.
+  external DF asFunction<@DartRepresentationOf("NF") DF extends Function>(
+      {bool isLeaf: false});
 }
 
 //
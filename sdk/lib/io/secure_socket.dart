@@ -814,7 +814,8 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
     try {
       bool needRetryHandshake = await _secureFilter!.handshake();
       if (needRetryHandshake) {
-        // Some certificates have been evaluated, need to retry handshake.
+        // Some certificates have been evaluated, or a private key operation
+        // has finished, need to retry handshake.
         await _secureHandshake();
       } else {
         _filterStatus.writeEmpty = false;
@@ -0,0 +1,88 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Testing multiplication and parsing of Bigints large enough to use the
+// sub-quadratic algorithms, against results computed from small pieces.
+// VMOptions=--intrinsify --no-enable-asserts
+// VMOptions=--intrinsify --enable-asserts
+// VMOptions=--no-intrinsify --enable-asserts
+
+import "package:expect/expect.dart";
+
+final mask32 = (BigInt.one << 32) - BigInt.one;
+
+// A number of exactly the given bits with a reproducible mix of digits.
+BigInt makeNumber(int bits, int seed) {
+  var state = seed;
+  // The leading one becomes the top bit after the final shift.
+  var result = BigInt.one;
+  for (var i = 0; i < bits; i += 16) {
+    state = (state * 1103515245 + 12345) & 0x7fffffff;
+    result = (result << 16) | BigInt.from(state & 0xffff);
+  }
+  return result >> (result.bitLength - bits);
+}
+
+// Multiplies by one 32-bit digit of y at a time, which stays below the
+// threshold of the large multiplication.
+BigInt slowMultiply(BigInt x, BigInt y) {
+  var result = BigInt.zero;
+  var shift = 0;
+  while (y > BigInt.zero) {
+    result += (x * (y & mask32)) << shift;
+    y >>= 32;
+    shift += 32;
+  }
+  return result;
+}
+
+testMultiply() {
+  for (var xBits in [2048, 2049, 4096, 5000, 12345]) {
+    for (var yBits in [2048, 3000, 4096, 20000]) {
+      final x = makeNumber(xBits, xBits);
+      final y = makeNumber(yBits, yBits + 1);
+      final expected = slowMultiply(x, y);
+      Expect.equals(expected, x * y);
+      Expect.equals(-expected, -x * y);
+      Expect.equals(expected, -x * -y);
+      Expect.equals(x, (x * y) ~/ y);
+      Expect.equals(BigInt.zero, (x * y) % y);
+    }
+  }
+  // All digits set exercises every carry.
+  final ones = (BigInt.one << 8192) - BigInt.one;
+  Expect.equals(
+      (BigInt.one << 16384) - (BigInt.one << 8193) + BigInt.one, ones * ones);
+}
+
+testModPow() {
+  // Montgomery reduction squares and multiplies 4096-bit digit lists.
+  final modulus = makeNumber(4096, 7) | BigInt.one;
+  final base = makeNumber(4000, 8);
+  var expected = BigInt.one;
+  for (var i = 0; i < 5; i++) {
+    expected = slowMultiply(expected, base) % modulus;
+  }
+  Expect.equals(expected, base.modPow(BigInt.from(5), modulus));
+}
+
+testParse() {
+  for (var bits in [10000, 33333, 100000]) {
+    final x = makeNumber(bits, bits);
+    final decimal = x.toString();
+    Expect.equals(x, BigInt.parse(decimal));
+    Expect.equals(-x, BigInt.parse("-$decimal"));
+    final power = BigInt.from(10).pow(decimal.length);
+    Expect.equals(x * power + x, BigInt.parse("$decimal$decimal"));
+    // The low part of a split starts with zeros.
+    Expect.equals(power + BigInt.one,
+        BigInt.parse("1${"0" * (decimal.length - 1)}1"));
+  }
+}
+
+main() {
+  testMultiply();
+  testModPow();
+  testParse();
+}
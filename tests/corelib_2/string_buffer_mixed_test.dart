@@ -0,0 +1,41 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import "package:expect/expect.dart";
+
+// Interleaves char codes with short and long strings, so that the buffer and
+// the parts of a StringBuffer both hold content when it is flattened.
+
+void testMixed(String short, String long, int charCode) {
+  var buffer = new StringBuffer();
+  var expected = "";
+  for (int i = 0; i < 200; i++) {
+    buffer.writeCharCode(charCode);
+    buffer.write(short);
+    expected += new String.fromCharCode(charCode) + short;
+    if (i % 7 == 0) {
+      buffer.write(long);
+      expected += long;
+    }
+    if (i % 50 == 0) {
+      Expect.equals(expected, buffer.toString());
+      Expect.equals(expected.length, buffer.length);
+    }
+  }
+  Expect.equals(expected, buffer.toString());
+  // Flattening does not change the contents.
+  Expect.equals(expected, buffer.toString());
+  buffer.write("!");
+  Expect.equals(expected + "!", buffer.toString());
+}
+
+main() {
+  var long = "x" * 100;
+  testMixed("ab", long, 0x41);
+  testMixed("ab", long, 0xE9);
+  testMixed("ab", long, 0x1F600);
+  testMixed("€", long, 0x41);
+  testMixed("ab", "€" * 40, 0x41);
+  testMixed("", long, 0x41);
+}
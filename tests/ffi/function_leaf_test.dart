@@ -0,0 +1,120 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:ffi leaf calls.
+//
+// VMOptions=
+// VMOptions=--deterministic --optimization-counter-threshold=10
+// VMOptions=--use-slow-path
+// VMOptions=--use-slow-path --stacktrace-every=100
+// VMOptions=--write-protect-code --no-dual-map-code
+// SharedObjects=ffi_test_functions
+
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'dylib_utils.dart';
+
+import "package:expect/expect.dart";
+
+void main() {
+  for (int i = 0; i < 100; ++i) {
+    testLeafFunctionFromLookup();
+    testLeafFunctionFromAsFunction();
+    testLeafFunctionDoubles();
+    testLeafFunctionVoid();
+    testLeafFunctionTypedData();
+    testLeafFunctionTypedDataView();
+    testLeafFunctionFloat32List();
+  }
+}
+
+final ffiTestFunctions = dlopenPlatformSpecific("ffi_test_functions");
+
+typedef NativeBinaryOp = Int32 Function(Int32, Int32);
+typedef BinaryOp = int Function(int, int);
+
+final BinaryOp sumPlus42Leaf = ffiTestFunctions
+    .lookupFunction<NativeBinaryOp, BinaryOp>("SumPlus42", isLeaf: true);
+
+void testLeafFunctionFromLookup() {
+  Expect.equals(49, sumPlus42Leaf(3, 4));
+  Expect.equals(49, (sumPlus42Leaf as dynamic)(3, 4));
+}
+
+typedef NativeQuadOpSigned = Int64 Function(Int8, Int16, Int32, Int64);
+typedef QuadOp = int Function(int, int, int, int);
+
+void testLeafFunctionFromAsFunction() {
+  final QuadOp intComputation = ffiTestFunctions
+      .lookup<NativeFunction<NativeQuadOpSigned>>("IntComputation")
+      .asFunction(isLeaf: true);
+  Expect.equals(625, intComputation(125, 250, 500, 1000));
+  Expect.equals(
+      0x7FFFFFFFFFFFFFFF, intComputation(0, 0, 0, 0x7FFFFFFFFFFFFFFF));
+}
+
+typedef NativeDoubleUnaryOp = Double Function(Double);
+typedef DoubleUnaryOp = double Function(double);
+
+final DoubleUnaryOp times1_337DoubleLeaf =
+    ffiTestFunctions.lookupFunction<NativeDoubleUnaryOp, DoubleUnaryOp>(
+        "Times1_337Double",
+        isLeaf: true);
+
+void testLeafFunctionDoubles() {
+  Expect.approxEquals(2.0 * 1.337, times1_337DoubleLeaf(2.0));
+}
+
+typedef NativeSetGlobalVar = Void Function(Int32);
+typedef SetGlobalVar = void Function(int);
+typedef NativeGetGlobalVar = Int32 Function();
+typedef GetGlobalVar = int Function();
+
+final SetGlobalVar setGlobalVarLeaf = ffiTestFunctions
+    .lookupFunction<NativeSetGlobalVar, SetGlobalVar>("SetGlobalVar",
+        isLeaf: true);
+final GetGlobalVar getGlobalVarLeaf = ffiTestFunctions
+    .lookupFunction<NativeGetGlobalVar, GetGlobalVar>("GetGlobalVar",
+        isLeaf: true);
+
+void testLeafFunctionVoid() {
+  setGlobalVarLeaf(123);
+  Expect.equals(123, getGlobalVarLeaf());
+}
+
+typedef NativeAssign1337Index1 = Pointer<Int64> Function(Pointer<Int64>);
+typedef Assign1337Index1 = Pointer<Int64> Function(Int64List);
+
+final Assign1337Index1 assign1337Index1Leaf = ffiTestFunctions
+    .lookupFunction<NativeAssign1337Index1, Assign1337Index1>(
+        "Assign1337Index1",
+        isLeaf: true);
+
+void testLeafFunctionTypedData() {
+  final list = Int64List(3);
+  assign1337Index1Leaf(list);
+  Expect.equals(1337, list[1]);
+  Expect.equals(0, list[0]);
+  Expect.equals(0, list[2]);
+}
+
+void testLeafFunctionTypedDataView() {
+  final list = Int64List(4);
+  assign1337Index1Leaf(Int64List.sublistView(list, 2));
+  Expect.equals(1337, list[3]);
+  Expect.equals(0, list[1]);
+}
+
+typedef NativeIsRoughly1337 = Uint8 Function(Pointer<Float>);
+typedef IsRoughly1337 = int Function(Float32List);
+
+final IsRoughly1337 isRoughly1337Leaf = ffiTestFunctions
+    .lookupFunction<NativeIsRoughly1337, IsRoughly1337>("IsRoughly1337",
+        isLeaf: true);
+
+void testLeafFunctionFloat32List() {
+  Expect.equals(1, isRoughly1337Leaf(Float32List.fromList([1337.0])));
+  Expect.equals(0, isRoughly1337Leaf(Float32List.fromList([42.0])));
+}
@@ -7,6 +7,7 @@
 // SharedObjects=ffi_test_dynamic_library ffi_test_functions
 
 import 'dart:ffi';
+import 'dart:typed_data';
 
 import "package:ffi/ffi.dart";
 
@@ -51,6 +52,14 @@ void main() {
   testEmptyStructAsFunctionReturn();
   testEmptyStructFromFunctionArgument();
   testEmptyStructFromFunctionReturn();
+  testLookupFunctionIsLeafMustBeConst();
+  testAsFunctionIsLeafMustBeConst();
+  testLookupFunctionTakesHandle();
+  testAsFunctionTakesHandle();
+  testLookupFunctionReturnsHandle();
+  testAsFunctionReturnsHandle();
+  testLookupFunctionTypedDataNotLeaf();
+  testLookupFunctionTypedDataWrongElementType();
 }
 
 typedef Int8UnOp = Int8 Function(Int8);
@@ -526,3 +535,69 @@ void testEmptyStructFromFunctionReturn() {
   Pointer.fromFunction<EmptyStruct Function()>(//# 1105: compile-time error
       _returnEmptyStruct); //# 1105: compile-time error
 }
+
+void testLookupFunctionIsLeafMustBeConst() {
+  bool notAConst = false;
+  DynamicLibrary l = dlopenPlatformSpecific("ffi_test_dynamic_library");
+  l.lookupFunction< //# 1500: compile-time error
+          Int8 Function(Int64, Int64), //# 1500: compile-time error
+          int Function(int, int)>("SumPlus42", //# 1500: compile-time error
+      isLeaf: notAConst); //# 1500: compile-time error
+}
+
+void testAsFunctionIsLeafMustBeConst() {
+  bool notAConst = false;
+  Pointer<NativeFunction<Int8UnOp>> p = Pointer.fromAddress(1337);
+  IntUnOp f = p.asFunction(isLeaf: notAConst); //# 1501: compile-time error
+}
+
+typedef NativeTakesHandle = Void Function(Handle);
+typedef TakesHandle = void Function(Object);
+
+void testLookupFunctionTakesHandle() {
+  DynamicLibrary l = dlopenPlatformSpecific("ffi_test_dynamic_library");
+  l.lookupFunction< //# 1502: compile-time error
+          NativeTakesHandle, //# 1502: compile-time error
+          TakesHandle>("takesHandle", //# 1502: compile-time error
+      isLeaf: true); //# 1502: compile-time error
+}
+
+void testAsFunctionTakesHandle() {
+  Pointer<NativeFunction<NativeTakesHandle>> p = Pointer.fromAddress(1337); //# 1503: compile-time error
+  TakesHandle f = p.asFunction(isLeaf: true); //# 1503: compile-time error
+}
+
+typedef NativeReturnsHandle = Handle Function();
+typedef ReturnsHandle = Object Function();
+
+void testLookupFunctionReturnsHandle() {
+  DynamicLibrary l = dlopenPlatformSpecific("ffi_test_dynamic_library");
+  l.lookupFunction< //# 1504: compile-time error
+          NativeReturnsHandle, //# 1504: compile-time error
+          ReturnsHandle>("returnsHandle", //# 1504: compile-time error
+      isLeaf: true); //# 1504: compile-time error
+}
+
+void testAsFunctionReturnsHandle() {
+  Pointer<NativeFunction<NativeReturnsHandle>> p = Pointer.fromAddress(1337); //# 1505: compile-time error
+  ReturnsHandle f = p.asFunction(isLeaf: true); //# 1505: compile-time error
+}
+
+typedef NativeTakesInt64Pointer = Void Function(Pointer<Int64>);
+typedef TakesInt64List = void Function(Int64List);
+typedef TakesInt32List = void Function(Int32List);
+
+void testLookupFunctionTypedDataNotLeaf() {
+  DynamicLibrary l = dlopenPlatformSpecific("ffi_test_dynamic_library");
+  l.lookupFunction< //# 1506: compile-time error
+      NativeTakesInt64Pointer, //# 1506: compile-time error
+      TakesInt64List>("takesPointer"); //# 1506: compile-time error
+}
+
+void testLookupFunctionTypedDataWrongElementType() {
+  DynamicLibrary l = dlopenPlatformSpecific("ffi_test_dynamic_library");
+  l.lookupFunction< //# 1507: compile-time error
+          NativeTakesInt64Pointer, //# 1507: compile-time error
+          TakesInt32List>("takesPointer", //# 1507: compile-time error
+      isLeaf: true); //# 1507: compile-time error
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Awaiting a value that is not a future resumes in a later microtask, in the
+// same order as other microtasks, and inside the zone of the async function.
+
+import "dart:async";
+import "package:expect/expect.dart";
+import "package:async_helper/async_helper.dart";
+
+final log = <String>[];
+
+Future awaitValues(String name) async {
+  log.add("$name start");
+  var value = await 1;
+  log.add("$name $value");
+  value = await 2;
+  log.add("$name $value");
+}
+
+main() {
+  asyncStart();
+  final zoneKey = #awaitValueZone;
+  var scheduled = 0;
+  var ran = 0;
+  runZoned(() async {
+    scheduleMicrotask(() => log.add("microtask"));
+    final a = awaitValues("a");
+    final b = awaitValues("b");
+    log.add("sync end");
+    await Future.wait([a, b]);
+    Expect.equals("zone", Zone.current[zoneKey]);
+    Expect.listEquals([
+      "a start",
+      "b start",
+      "sync end",
+      "microtask",
+      "a 1",
+      "b 1",
+      "a 2",
+      "b 2",
+    ], log);
+    Expect.isTrue(scheduled >= 4);
+    Expect.isTrue(ran >= 4);
+    asyncEnd();
+  },
+      zoneValues: {zoneKey: "zone"},
+      zoneSpecification: ZoneSpecification(
+          scheduleMicrotask: (self, parent, zone, f) {
+        scheduled++;
+        parent.scheduleMicrotask(zone, f);
+      }, runUnary: <R, T>(self, parent, zone, R f(T arg), T arg) {
+        ran++;
+        return parent.runUnary(zone, f, arg);
+      }));
+}
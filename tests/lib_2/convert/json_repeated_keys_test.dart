@@ -0,0 +1,52 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import "dart:convert";
+
+import "package:expect/expect.dart";
+
+// Decodes many objects with repeated, colliding, long and non-ASCII property
+// names, from strings and from UTF-8 bytes.
+
+main() {
+  var names = <String>[
+    "a",
+    "b",
+    "ab",
+    "ba",
+    "id",
+    "name",
+    "x" * 32,
+    "x" * 33,
+    "café",
+    "€",
+    "",
+  ];
+  for (int i = 0; i < 200; i++) {
+    names.add("key$i");
+  }
+  var objects = <Map<String, Object>>[];
+  for (int i = 0; i < 50; i++) {
+    var object = <String, Object>{};
+    for (int j = 0; j < names.length; j += 1 + (i % 3)) {
+      object[names[j]] = i * j;
+    }
+    objects.add(object);
+  }
+  var text = json.encode(objects);
+  for (var decoded in [
+    json.decode(text),
+    utf8.decoder.fuse(json.decoder).convert(utf8.encode(text)),
+  ]) {
+    Expect.equals(objects.length, decoded.length);
+    for (int i = 0; i < objects.length; i++) {
+      Expect.mapEquals(objects[i], decoded[i]);
+    }
+  }
+  // Equal names that differ only in escaping decode to equal keys.
+  var escaped = json.decode('[{"ab": 1}, {"a\\u0062": 2}, {"ab": 3}]');
+  Expect.equals(1, escaped[0]["ab"]);
+  Expect.equals(2, escaped[1]["ab"]);
+  Expect.equals(3, escaped[2]["ab"]);
+}